@@ -43,12 +43,15 @@
 #include <sys/time.h>
 
 #include <signal.h>
+#include <stdint.h>
 #include <syslog.h>
+#include <time.h>
 
 #include <climits>
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include <devdctl/guid.h>
 #include <devdctl/event.h>
@@ -61,7 +64,7 @@
 #include "zfsd.h"
 #include "zfsd_exception.h"
 
-std::list<Callout *> Callout::s_activeCallouts;
+Callout::TimerQueue Callout::s_timerQueue;
 bool		     Callout::s_alarmFired(false);
 
 void
@@ -70,31 +73,64 @@ Callout::Init()
 	signal(SIGALRM,  Callout::AlarmSignalHandler);
 }
 
+uint64_t
+Callout::TimevalToUsec(const timeval &tv)
+{
+	return ((uint64_t)tv.tv_sec * 1000000 + tv.tv_usec);
+}
+
+uint64_t
+Callout::MonotonicUsec()
+{
+	timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000);
+}
+
+void
+Callout::RearmTimer()
+{
+	itimerval timerval = { {0, 0}, {0, 0} };
+
+	if (!s_timerQueue.empty()) {
+		uint64_t nowUsec;
+		uint64_t headUsec;
+		uint64_t delta;
+
+		nowUsec = MonotonicUsec();
+		headUsec = s_timerQueue.begin()->first;
+
+		/*
+		 * Guarantee a non-zero interval so that the interval
+		 * timer is always armed; overdue callouts fire on the
+		 * next alarm.
+		 */
+		delta = (headUsec > nowUsec) ? headUsec - nowUsec : 1;
+		timerval.it_value.tv_sec  = delta / 1000000;
+		timerval.it_value.tv_usec = delta % 1000000;
+	}
+	setitimer(ITIMER_REAL, &timerval, NULL);
+}
+
 bool
 Callout::Stop()
 {
+	bool wasHead;
+
 	if (!IsPending())
 		return (false);
 
-	for (std::list<Callout *>::iterator it(s_activeCallouts.begin());
-	     it != s_activeCallouts.end(); it++) {
-		if (*it != this)
-			continue;
-
-		it = s_activeCallouts.erase(it);
-		if (it != s_activeCallouts.end()) {
-
-			/*
-			 * Maintain correct interval for the
-			 * callouts that follow the just removed
-			 * entry.
-			 */
-			timeradd(&(*it)->m_interval, &m_interval,
-				 &(*it)->m_interval);
-		}
-		break;
-	}
+	wasHead = (m_queueEntry == s_timerQueue.begin());
+	s_timerQueue.erase(m_queueEntry);
 	m_pending = false;
+
+	/*
+	 * Removing the nearest callout changes the required interval
+	 * timer setting.
+	 */
+	if (wasHead)
+		RearmTimer();
 	return (true);
 }
 
@@ -108,38 +144,15 @@ Callout::Reset(const timeval &interval, CalloutFunc_t *func, void *arg)
 
 	cancelled = Stop();
 
-	m_interval = interval;
-	m_func     = func;
-	m_arg      = arg;
-	m_pending  = true;
-
-	std::list<Callout *>::iterator it(s_activeCallouts.begin());
-	for (; it != s_activeCallouts.end(); it++) {
-
-		if (timercmp(&(*it)->m_interval, &m_interval, <=)) {
-			/*
-			 * Decrease our interval by those that come
-			 * before us.
-			 */
-			timersub(&m_interval, &(*it)->m_interval, &m_interval);
-		} else {
-			/*
-			 * Account for the time between the newly
-			 * inserted event and those that follow.
-			 */
-			timersub(&(*it)->m_interval, &m_interval,
-				 &(*it)->m_interval);
-			break;
-		}
-	}
-	s_activeCallouts.insert(it, this);
-
+	m_expiration = MonotonicUsec() + TimevalToUsec(interval);
+	m_func       = func;
+	m_arg        = arg;
+	m_pending    = true;
 
-	if (s_activeCallouts.front() == this) {
-		itimerval timerval = { {0, 0}, m_interval };
-
-		setitimer(ITIMER_REAL, &timerval, NULL);
-	}
+	m_queueEntry = s_timerQueue.insert(
+	    TimerQueue::value_type(m_expiration, this));
+	if (m_queueEntry == s_timerQueue.begin())
+		RearmTimer();
 
 	return (cancelled);
 }
@@ -158,45 +171,35 @@ Callout::ExpireCallouts()
 		return;
 
 	s_alarmFired = false;
-	if (s_activeCallouts.empty()) {
+	if (s_timerQueue.empty()) {
 		/* Callout removal/SIGALRM race was lost. */
 		return;
 	}
 
+	uint64_t nowUsec(MonotonicUsec());
+
 	/*
-	 * Expire the first callout (the one we used to set the
-	 * interval timer) as well as any callouts following that
-	 * expire at the same time (have a zero interval from
-	 * the callout before it).
+	 * Expire every callout whose expiration time has passed,
+	 * starting with the nearest.
 	 */
-	do {
-		Callout *cur(s_activeCallouts.front());
-		s_activeCallouts.pop_front();
+	while (!s_timerQueue.empty()
+	    && s_timerQueue.begin()->first <= nowUsec) {
+		Callout *cur(s_timerQueue.begin()->second);
+
+		s_timerQueue.erase(s_timerQueue.begin());
 		cur->m_pending = false;
 		cur->m_func(cur->m_arg);
-	} while (!s_activeCallouts.empty()
-	      && timerisset(&s_activeCallouts.front()->m_interval) == 0);
-
-	if (!s_activeCallouts.empty()) {
-		Callout *next(s_activeCallouts.front());
-		itimerval timerval = { { 0, 0 }, next->m_interval };
-
-		setitimer(ITIMER_REAL, &timerval, NULL);
 	}
+
+	RearmTimer();
 }
 
 timeval
 Callout::TimeRemaining() const
 {
-	/*
-	 * Outline: Add the m_interval for each callout in s_activeCallouts
-	 * ahead of this, except for the first callout.  Add to that the result
-	 * of getitimer (That's because the first callout stores its original
-	 * interval setting while the timer is ticking).
-	 */
-	itimerval timervalToAlarm;
-	timeval timeToExpiry;
-	std::list<Callout *>::iterator it;
+	timeval  timeToExpiry;
+	uint64_t nowUsec;
+	uint64_t remaining;
 
 	if (!IsPending()) {
 		timeToExpiry.tv_sec = INT_MAX;
@@ -204,17 +207,9 @@ Callout::TimeRemaining() const
 		return (timeToExpiry);
 	}
 
-	timerclear(&timeToExpiry);
-	getitimer(ITIMER_REAL, &timervalToAlarm);
-	timeval& timeToAlarm = timervalToAlarm.it_value;
-	timeradd(&timeToExpiry, &timeToAlarm, &timeToExpiry);
-
-	it =s_activeCallouts.begin();
-	it++;	/*skip the first callout in the list*/
-	for (; it != s_activeCallouts.end(); it++) {
-		timeradd(&timeToExpiry, &(*it)->m_interval, &timeToExpiry);
-		if ((*it) == this)
-			break;
-	}
+	nowUsec = MonotonicUsec();
+	remaining = (m_expiration > nowUsec) ? m_expiration - nowUsec : 0;
+	timeToExpiry.tv_sec  = remaining / 1000000;
+	timeToExpiry.tv_usec = remaining % 1000000;
 	return (timeToExpiry);
 }
@@ -41,7 +41,9 @@
  *
  *     #include <sys/time.h>
  *
- *     #include <list>
+ *     #include <stdint.h>
+ *
+ *     #include <map>
  */
 
 #ifndef _CALLOUT_H_
@@ -79,8 +81,8 @@ public:
 	static void AlarmSignalHandler(int);
 
 	/**
-	 * Execute callbacks for all callouts that have the same
-	 * expiration time as the first callout in the list.
+	 * Execute callbacks for all callouts whose expiration time
+	 * has passed.
 	 */
 	static void ExpireCallouts();
 
@@ -134,10 +136,33 @@ public:
 
 private:
 	/**
-	 * All active callouts sorted by expiration time.  The callout
-	 * with the nearest expiration time is at the head of the list.
+	 * Map of active callouts ordered by absolute expiration time
+	 * in microseconds, providing O(log n) scheduling and
+	 * cancellation.  The callout with the nearest expiration time
+	 * is at the head of the map.
+	 */
+	typedef std::multimap<uint64_t, Callout *> TimerQueue;
+
+	/** Convert a timeval to microseconds. */
+	static uint64_t TimevalToUsec(const timeval &tv);
+
+	/**
+	 * Current value of the monotonic clock, in microseconds.
+	 *
+	 * Expiration times are kept on the monotonic clock so that
+	 * NTP steps or manual changes to the system date can neither
+	 * fire callouts early nor defer them.
 	 */
-	static std::list<Callout *> s_activeCallouts;
+	static uint64_t MonotonicUsec();
+
+	/**
+	 * Arm the interval timer for the callout at the head of the
+	 * timer queue, or disarm it if no callouts remain.
+	 */
+	static void RearmTimer();
+
+	/** All active callouts.  See TimerQueue. */
+	static TimerQueue           s_timerQueue;
 
 	/**
 	 * The interval timer has expired.  This variable is set from
@@ -147,10 +172,13 @@ private:
 	static bool                 s_alarmFired;
 
 	/**
-	 * Time, relative to others in the active list, until
-	 * this callout is fired.
+	 * Absolute time, in microseconds on the monotonic clock, at
+	 * which this callout fires.
 	 */
-	timeval                     m_interval;
+	uint64_t                    m_expiration;
+
+	/** Our entry in s_timerQueue while this callout is pending. */
+	TimerQueue::iterator        m_queueEntry;
 
 	/** Callback function argument. */
 	void                       *m_arg;
@@ -175,11 +203,11 @@ Callout::IsPending() const
 //- Callout public methods ----------------------------------------------------
 inline
 Callout::Callout()
- : m_arg(0),
+ : m_expiration(0),
+   m_arg(0),
    m_func(NULL),
    m_pending(false)
 {
-	timerclear(&m_interval);
 }
 
 #endif /* CALLOUT_H_ */
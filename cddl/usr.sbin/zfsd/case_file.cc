@@ -40,14 +40,17 @@
  */
 #include <sys/cdefs.h>
 #include <sys/byteorder.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 
 #include <sys/fs/zfs.h>
 
+#include <cstring>
 #include <dirent.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <iomanip>
-#include <fstream>
 #include <functional>
 #include <sstream>
 #include <syslog.h>
@@ -58,6 +61,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include <devdctl/guid.h>
 #include <devdctl/event.h>
@@ -78,7 +82,6 @@ __FBSDID("$FreeBSD$");
 
 /*============================ Namespace Control =============================*/
 using std::hex;
-using std::ifstream;
 using std::stringstream;
 using std::setfill;
 using std::setw;
@@ -93,6 +96,8 @@ using DevdCtl::ParseException;
 //- CaseFile Static Data -------------------------------------------------------
 
 CaseFileList  CaseFile::s_activeCases;
+CaseFileIndex CaseFile::s_caseIndex;
+pthread_mutex_t CaseFile::s_registryLock = PTHREAD_MUTEX_INITIALIZER;
 const string  CaseFile::s_caseFilePath = "/var/db/zfsd/cases";
 const timeval CaseFile::s_removeGracePeriod = { 60 /*sec*/, 0 /*usec*/};
 
@@ -100,18 +105,20 @@ const timeval CaseFile::s_removeGracePeriod = { 60 /*sec*/, 0 /*usec*/};
 CaseFile *
 CaseFile::Find(Guid poolGUID, Guid vdevGUID)
 {
-	for (CaseFileList::iterator curCase = s_activeCases.begin();
-	     curCase != s_activeCases.end(); curCase++) {
+	std::pair<CaseFileIndex::iterator, CaseFileIndex::iterator>
+	    range(s_caseIndex.equal_range(vdevGUID));
 
-		if (((*curCase)->PoolGUID() != poolGUID
-		  && Guid::InvalidGuid() != poolGUID)
-		 || (*curCase)->VdevGUID() != vdevGUID)
+	for (CaseFileIndex::iterator curCase = range.first;
+	     curCase != range.second; curCase++) {
+
+		if (curCase->second->PoolGUID() != poolGUID
+		 && Guid::InvalidGuid() != poolGUID)
 			continue;
 
 		/*
 		 * We only carry one active case per-vdev.
 		 */
-		return (*curCase);
+		return (curCase->second);
 	}
 	return (NULL);
 }
@@ -157,9 +164,17 @@ CaseFile::Create(Vdev &vdev)
 {
 	CaseFile *activeCase;
 
+	/*
+	 * The parallel pool scan in ZfsDaemon::BuildCaseFiles() calls
+	 * Create() from several worker threads; hold the registry lock
+	 * across the lookup and the constructor's registration so the
+	 * case list and index never see a concurrent update.
+	 */
+	pthread_mutex_lock(&s_registryLock);
 	activeCase = Find(vdev.PoolGUID(), vdev.GUID());
 	if (activeCase == NULL)
 		activeCase = new CaseFile(vdev);
+	pthread_mutex_unlock(&s_registryLock);
 
 	return (*activeCase);
 }
@@ -179,6 +194,12 @@ CaseFile::DeSerialize()
 		return;
 	}
 
+	/*
+	 * Presize the lookup index so the bulk insert below does not
+	 * trigger incremental rehashing.
+	 */
+	s_caseIndex.reserve(s_caseIndex.size() + numCaseFiles);
+
 	for (int i = 0; i < numCaseFiles; i++) {
 
 		DeSerializeFile(caseFiles[i]->d_name);
@@ -753,12 +774,31 @@ CaseFile::DeSerializeFile(const char *fileName)
 			caseFile = new CaseFile(Vdev(zpl.front(), vdevConf));
 		}
 
-		ifstream caseStream(fullName.c_str());
-		if (!caseStream)
+		/*
+		 * Map the case file rather than streaming it so that the
+		 * entire image is parsed from memory in a single pass.
+		 */
+		int fd(open(fullName.c_str(), O_RDONLY));
+		if (fd == -1)
 			throw ZfsdException("CaseFile::DeSerialize: Unable to "
 					    "read %s.\n", fileName);
 
-		caseFile->DeSerialize(caseStream);
+		struct stat caseStat;
+		if (fstat(fd, &caseStat) == -1 || caseStat.st_size == 0) {
+			close(fd);
+			return;
+		}
+
+		void *caseImage(mmap(NULL, caseStat.st_size, PROT_READ,
+				     MAP_PRIVATE, fd, 0));
+		close(fd);
+		if (caseImage == MAP_FAILED)
+			throw ZfsdException("CaseFile::DeSerialize: Unable to "
+					    "map %s.\n", fileName);
+
+		caseFile->DeSerialize(static_cast<const char *>(caseImage),
+				      caseStat.st_size);
+		munmap(caseImage, caseStat.st_size);
 	} catch (const ParseException &exp) {
 
 		exp.Log();
@@ -794,6 +834,7 @@ CaseFile::CaseFile(const Vdev &vdev)
 	m_poolGUIDString = guidString.str();
 
 	s_activeCases.push_back(this);
+	s_caseIndex.insert(CaseFileIndex::value_type(m_vdevGUID, this));
 
 	syslog(LOG_INFO, "Creating new CaseFile:\n");
 	Log();
@@ -805,6 +846,16 @@ CaseFile::~CaseFile()
 	PurgeTentativeEvents();
 	m_tentativeTimer.Stop();
 	s_activeCases.remove(this);
+
+	std::pair<CaseFileIndex::iterator, CaseFileIndex::iterator>
+	    range(s_caseIndex.equal_range(m_vdevGUID));
+	for (CaseFileIndex::iterator curCase = range.first;
+	     curCase != range.second; curCase++) {
+		if (curCase->second == this) {
+			s_caseIndex.erase(curCase);
+			break;
+		}
+	}
 }
 
 void
@@ -828,7 +879,7 @@ CaseFile::PurgeTentativeEvents()
 }
 
 void
-CaseFile::SerializeEvList(const EventList events, int fd,
+CaseFile::SerializeEvList(const EventList &events, string &buffer,
 		const char* prefix) const
 {
 	if (events.empty())
@@ -837,10 +888,9 @@ CaseFile::SerializeEvList(const EventList events, int fd,
 	     curEvent != events.end(); curEvent++) {
 		const string &eventString((*curEvent)->GetEventString());
 
-		// TODO: replace many write(2) calls with a single writev(2)
 		if (prefix)
-			write(fd, prefix, strlen(prefix));
-		write(fd, eventString.c_str(), eventString.length());
+			buffer.append(prefix);
+		buffer.append(eventString);
 	}
 }
 
@@ -866,8 +916,19 @@ CaseFile::Serialize()
 		       saveFile.str().c_str());
 		return;
 	}
-	SerializeEvList(m_events, fd);
-	SerializeEvList(m_tentativeEvents, fd, "tentative ");
+
+	/*
+	 * Accumulate the serialized image in memory and commit it with
+	 * a single write so the on-disk case is always a whole image.
+	 */
+	string buffer;
+	SerializeEvList(m_events, buffer);
+	SerializeEvList(m_tentativeEvents, buffer, "tentative ");
+	if (write(fd, buffer.c_str(), buffer.length())
+	    != (ssize_t)buffer.length()) {
+		syslog(LOG_ERR, "CaseFile::Serialize: Unable to write %s.\n",
+		       saveFile.str().c_str());
+	}
 	close(fd);
 }
 
@@ -877,13 +938,14 @@ CaseFile::Serialize()
  * serialization formats
  */
 void
-CaseFile::DeSerialize(ifstream &caseStream)
+CaseFile::DeSerialize(const char *buf, size_t len)
 {
-	string	      evString;
 	const EventFactory &factory(ZfsDaemon::Get().GetFactory());
+	const string tentFlag("tentative ");
+	const char *cur(buf);
+	const char *bufEnd(buf + len);
 
-	caseStream >> std::noskipws >> std::ws;
-	while (caseStream.good()) {
+	while (cur < bufEnd) {
 		/*
 		 * Outline:
 		 * read the beginning of a line and check it for
@@ -892,13 +954,18 @@ CaseFile::DeSerialize(ifstream &caseStream)
 		 * continue
 		 */
 		EventList* destEvents;
-		const string tentFlag("tentative ");
-		string line;
-		std::stringbuf lineBuf;
+		const char *eol(static_cast<const char *>(
+		    memchr(cur, '\n', bufEnd - cur)));
+		size_t lineLen((eol != NULL) ? (size_t)(eol - cur)
+					     : (size_t)(bufEnd - cur));
+		string line(cur, lineLen);
+
+		/* Skip the line and its newline terminator. */
+		cur += lineLen + 1;
+
+		if (line.empty())
+			continue;
 
-		caseStream.get(lineBuf);
-		caseStream.ignore();  /*discard the newline character*/
-		line = lineBuf.str();
 		if (line.compare(0, tentFlag.size(), tentFlag) == 0) {
 			/* Discard "tentative" */
 			line.erase(0, tentFlag.size());
@@ -40,7 +40,10 @@
  *
  * Header requirements:
  *
+ *    #include <pthread.h>
+ *
  *    #include <list>
+ *    #include <unordered_map>
  *
  *    #include "callout.h"
  *    #include "zfsd_event.h"
@@ -59,6 +62,16 @@ class Vdev;
  */
 typedef std::list< CaseFile *> CaseFileList;
 
+/*------------------------------- CaseFileIndex ------------------------------*/
+/**
+ * CaseFileIndex provides O(1) lookup of active cases by vdev GUID.
+ *
+ * Vdev GUIDs are unique within a pool but may, in principle, collide
+ * across pools, so the index is a multimap and lookups must still
+ * verify the pool GUID of each candidate.
+ */
+typedef std::unordered_multimap<uint64_t, CaseFile *> CaseFileIndex;
+
 /*--------------------------------- CaseFile ---------------------------------*/
 /**
  * A CaseFile object is instantiated anytime a vdev for an active pool
@@ -285,19 +298,23 @@ protected:
 	void Serialize();
 
 	/**
-	 * \brief Retrieve event data from a serialization stream.
+	 * \brief Retrieve event data from a memory mapped serialization
+	 *        image.
 	 *
-	 * \param caseStream  The serializtion stream to parse.
+	 * \param buf  The start of the serialized CaseFile data.
+	 * \param len  The length of the serialized CaseFile data.
 	 */
-	void DeSerialize(std::ifstream &caseStream);
+	void DeSerialize(const char *buf, size_t len);
 
 	/**
-	 * \brief Serializes the supplied event list and writes it to fd
+	 * \brief Append the supplied event list to a serialization buffer.
 	 *
+	 * \param events  The event list to serialize.
+	 * \param buffer  The buffer receiving the serialized events.
 	 * \param prefix  If not NULL, this prefix will be prepended to
-	 *                every event in the file.
+	 *                every event in the buffer.
 	 */
-	void SerializeEvList(const DevdCtl::EventList events, int fd,
+	void SerializeEvList(const DevdCtl::EventList &events, string &buffer,
 			     const char* prefix=NULL) const;
 
 	/**
@@ -354,6 +371,20 @@ protected:
 	 */
 	static CaseFileList  s_activeCases;
 
+	/**
+	 * \brief Index of active cases by vdev GUID, maintained by the
+	 *        CaseFile constructor and destructor so that Find() need
+	 *        not scan s_activeCases.
+	 */
+	static CaseFileIndex s_caseIndex;
+
+	/**
+	 * \brief Lock serializing Create() callers, and thereby all
+	 *        mutation of s_activeCases and s_caseIndex, while the
+	 *        pool scan runs one Create() per worker thread.
+	 */
+	static pthread_mutex_t s_registryLock;
+
 	/**
 	 * \brief The file system path to serialized CaseFile data.
 	 */
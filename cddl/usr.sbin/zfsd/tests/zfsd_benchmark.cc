@@ -0,0 +1,308 @@
+/*-
+ * Copyright (c) 2012, 2013, 2014 Spectra Logic Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions, and the following disclaimer,
+ *    without modification.
+ * 2. Redistributions in binary form must reproduce at minimum a disclaimer
+ *    substantially similar to the "NO WARRANTY" disclaimer below
+ *    ("Disclaimer") and any redistribution must be conditioned upon
+ *    including a substantially similar Disclaimer requirement for further
+ *    binary redistribution.
+ *
+ * NO WARRANTY
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTIBILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGES.
+ */
+
+/**
+ * \file zfsd_benchmark.cc
+ *
+ * Benchmark harness for zfsd's event hot path.  Replays a devd event
+ * log through EventFactory construction and CaseFile lookup and reports
+ * throughput and per-event latency percentiles.  Run it before and
+ * after changes to the event pipeline to catch regressions that only
+ * show up on hosts with very high event rates.
+ *
+ * The event log is one devd event string per line, as captured by
+ * zfsd's DD_DEBUG event dump or by reading /var/run/devd.seqpacket.pipe.
+ * With no log, a built-in corpus of representative ZFS events is used.
+ */
+#include <sys/cdefs.h>
+#include <sys/byteorder.h>
+#include <sys/time.h>
+
+#include <err.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <libnvpair.h>
+#include <libzfs.h>
+
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <devdctl/guid.h>
+#include <devdctl/event.h>
+#include <devdctl/event_factory.h>
+#include <devdctl/exception.h>
+#include <devdctl/consumer.h>
+
+#include <zfsd/callout.h>
+#include <zfsd/vdev_iterator.h>
+#include <zfsd/zfsd_event.h>
+#include <zfsd/case_file.h>
+#include <zfsd/vdev.h>
+#include <zfsd/zfsd.h>
+#include <zfsd/zfsd_exception.h>
+#include <zfsd/zpool_list.h>
+
+#include "libmocks.h"
+
+__FBSDID("$FreeBSD$");
+
+/*================================== Macros ==================================*/
+#define	NUM_ELEMENTS(x) (sizeof(x) / sizeof(*x))
+
+/*============================ Namespace Control =============================*/
+using std::string;
+using std::vector;
+
+using DevdCtl::Event;
+using DevdCtl::EventFactory;
+
+/*============================ Global Data ===================================*/
+/**
+ * Event builders to benchmark.  This must match the registry used by
+ * ZfsDaemon so that the harness constructs the same Event subclasses
+ * that zfsd would.
+ */
+static EventFactory::Record s_registryEntries[] =
+{
+	{ Event::NOTIFY, "GEOM",  &GeomEvent::Builder },
+	{ Event::NOTIFY, "ZFS",   &ZfsEvent::Builder }
+};
+
+/**
+ * Representative devd traffic used when no event log is supplied.  The
+ * mix is weighted towards I/O error reports, which dominate on a host
+ * with a failing disk and are the most expensive events to evaluate.
+ */
+static const char *s_defaultCorpus[] =
+{
+	"!system=ZFS "
+	"class=ereport.fs.zfs.io "
+	"ena=12091638756982918145 "
+	"parent_guid=13237004955564865395 "
+	"parent_type=raidz "
+	"pool=testpool.4415 "
+	"pool_context=0 "
+	"pool_failmode=wait "
+	"pool_guid=9756779504028057996 "
+	"subsystem=ZFS "
+	"timestamp=1348867914 "
+	"type=ereport.fs.zfs.io "
+	"vdev_guid=1631193447431603339 "
+	"vdev_path=/dev/da400 "
+	"vdev_type=disk "
+	"zio_blkid=622 "
+	"zio_err=1 "
+	"zio_level=-2 "
+	"zio_object=0 "
+	"zio_objset=37 "
+	"zio_offset=25598976 "
+	"zio_size=1024",
+
+	"!system=ZFS "
+	"class=ereport.fs.zfs.checksum "
+	"ena=12091638756982918145 "
+	"pool=testpool.4415 "
+	"pool_guid=9756779504028057996 "
+	"subsystem=ZFS "
+	"timestamp=1348867914 "
+	"type=ereport.fs.zfs.checksum "
+	"vdev_guid=1631193447431603339 "
+	"vdev_path=/dev/da400 "
+	"vdev_type=disk",
+
+	"!system=ZFS "
+	"subsystem=ZFS "
+	"type=misc.fs.zfs.config_sync "
+	"pool_name=testpool.4415 "
+	"pool_guid=9756779504028057996 "
+	"timestamp=1348871594",
+
+	"!system=GEOM "
+	"subsystem=DEV "
+	"type=CREATE "
+	"cdev=da400"
+};
+
+/*================================ Functions =================================*/
+static void
+usage()
+{
+	fprintf(stderr,
+	    "usage: zfsd_benchmark [-f event_log] [-n passes] [-r rate]\n"
+	    "\t-f event_log  Replay the given devd event log instead of the\n"
+	    "\t              built-in corpus.\n"
+	    "\t-n passes     Number of passes over the corpus (default 1000).\n"
+	    "\t-r rate       Throttle replay to rate events/sec (default\n"
+	    "\t              unthrottled).\n");
+	exit(1);
+}
+
+/**
+ * \brief Load a devd event log, one event string per line.
+ *
+ * Lines that do not begin with a devd message type character are
+ * skipped so that the output of zfsd's event dump can be used
+ * unedited.
+ */
+static void
+ReadCorpus(const char *path, vector<string> &corpus)
+{
+	std::ifstream log(path);
+	string line;
+
+	if (!log)
+		err(1, "unable to open %s", path);
+	while (std::getline(log, line)) {
+		if (line.empty())
+			continue;
+		if (line[0] != '!' && line[0] != '?'
+		 && line[0] != '+' && line[0] != '-')
+			continue;
+		corpus.push_back(line);
+	}
+	if (corpus.empty())
+		errx(1, "%s contains no devd events", path);
+}
+
+static inline uint64_t
+Nanotime()
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+static uint64_t
+Percentile(const vector<uint64_t> &sortedLatencies, u_int percent)
+{
+	size_t index((sortedLatencies.size() * percent) / 100);
+
+	if (index >= sortedLatencies.size())
+		index = sortedLatencies.size() - 1;
+	return (sortedLatencies[index]);
+}
+
+int
+main(int argc, char **argv)
+{
+	vector<string>   corpus;
+	vector<uint64_t> latencies;
+	EventFactory	 factory;
+	const char	*logPath(NULL);
+	u_long		 passes(1000);
+	u_long		 rate(0);
+	int		 ch;
+
+	while ((ch = getopt(argc, argv, "f:n:r:")) != -1) {
+		switch (ch) {
+		case 'f':
+			logPath = optarg;
+			break;
+		case 'n':
+			passes = strtoul(optarg, NULL, 10);
+			break;
+		case 'r':
+			rate = strtoul(optarg, NULL, 10);
+			break;
+		default:
+			usage();
+		}
+	}
+	if (passes == 0)
+		usage();
+
+	if (logPath != NULL) {
+		ReadCorpus(logPath, corpus);
+	} else {
+		for (u_int i = 0; i < NUM_ELEMENTS(s_defaultCorpus); i++)
+			corpus.push_back(s_defaultCorpus[i]);
+	}
+
+	factory.UpdateRegistry(s_registryEntries,
+			       NUM_ELEMENTS(s_registryEntries));
+	latencies.reserve(passes * corpus.size());
+
+	uint64_t periodNsec(rate != 0 ? 1000000000ULL / rate : 0);
+	uint64_t begin(Nanotime());
+	uint64_t nextDue(begin);
+
+	for (u_long pass = 0; pass < passes; pass++) {
+		for (vector<string>::const_iterator event(corpus.begin());
+		     event != corpus.end(); event++) {
+			if (periodNsec != 0) {
+				while (Nanotime() < nextDue)
+					;
+				nextDue += periodNsec;
+			}
+
+			uint64_t start(Nanotime());
+			Event *devdEvent(Event::CreateEvent(factory, *event));
+
+			if (devdEvent != NULL) {
+				ZfsEvent *zfsEvent =
+				    dynamic_cast<ZfsEvent *>(devdEvent);
+
+				if (zfsEvent != NULL)
+					CaseFile::Find(zfsEvent->PoolGUID(),
+						       zfsEvent->VdevGUID());
+				delete devdEvent;
+			}
+			latencies.push_back(Nanotime() - start);
+		}
+	}
+
+	uint64_t elapsed(Nanotime() - begin);
+	double   seconds((double)elapsed / 1e9);
+
+	std::sort(latencies.begin(), latencies.end());
+	printf("events:     %zu\n", latencies.size());
+	printf("elapsed:    %.3f s\n", seconds);
+	printf("throughput: %.0f events/sec\n", latencies.size() / seconds);
+	printf("latency:    min %juus p50 %juus p95 %juus p99 %juus "
+	    "max %juus\n",
+	    (uintmax_t)(latencies.front() / 1000),
+	    (uintmax_t)(Percentile(latencies, 50) / 1000),
+	    (uintmax_t)(Percentile(latencies, 95) / 1000),
+	    (uintmax_t)(Percentile(latencies, 99) / 1000),
+	    (uintmax_t)(latencies.back() / 1000));
+
+	return (0);
+}
@@ -42,6 +42,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
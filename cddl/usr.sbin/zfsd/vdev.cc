@@ -52,6 +52,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <sstream>
 
 #include <devdctl/guid.h>
@@ -47,6 +47,7 @@
 #include <libzfs.h>
 
 #include <list>
+#include <map>
 #include <string>
 
 #include <devdctl/exception.h>
@@ -62,13 +63,15 @@ using DevdCtl::Guid;
 /*=========================== Class Implementations ==========================*/
 /*------------------------------- VdevIterator -------------------------------*/
 VdevIterator::VdevIterator(zpool_handle_t *pool)
- : m_poolConfig(zpool_get_config(pool, NULL))
+ : m_poolConfig(zpool_get_config(pool, NULL)),
+   m_rootVdev(zpool_get_vdev_status(pool, 0))
 {
 	Reset();
 }
 
 VdevIterator::VdevIterator(nvlist_t *poolConfig)
- : m_poolConfig(poolConfig)
+ : m_poolConfig(poolConfig),
+   m_rootVdev(NULL)
 {
 	Reset();
 }
@@ -76,17 +79,20 @@ VdevIterator::VdevIterator(nvlist_t *poolConfig)
 void
 VdevIterator::Reset()
 {
-	nvlist_t  *rootVdev;
+	nvlist_t  *rootVdev(m_rootVdev);
 	nvlist	  **cache_child;
 	int	   result;
 	uint_t   cache_children;
 
-	result = nvlist_lookup_nvlist(m_poolConfig,
-				      ZPOOL_CONFIG_VDEV_TREE,
-				      &rootVdev);
-	if (result != 0)
-		throw ZfsdException(m_poolConfig, "Unable to extract "
-				    "ZPOOL_CONFIG_VDEV_TREE from pool.");
+	if (rootVdev == NULL) {
+		result = nvlist_lookup_nvlist(m_poolConfig,
+					      ZPOOL_CONFIG_VDEV_TREE,
+					      &rootVdev);
+		if (result != 0)
+			throw ZfsdException(m_poolConfig, "Unable to extract "
+					    "ZPOOL_CONFIG_VDEV_TREE from "
+					    "pool.");
+	}
 	m_vdevQueue.assign(1, rootVdev);
 	result = nvlist_lookup_nvlist_array(rootVdev,
 				      	    ZPOOL_CONFIG_L2CACHE,
@@ -150,14 +156,26 @@ VdevIterator::Each(VdevCallback_t *callBack, void *callBackArg)
 nvlist_t *
 VdevIterator::Find(Guid vdevGUID)
 {
-	nvlist_t *vdevConfig;
+	if (m_guidIndex.empty()) {
+		std::list<nvlist_t *> savedQueue(m_vdevQueue);
+		nvlist_t *vdevConfig;
 
-	Reset();
-	while ((vdevConfig = Next()) != NULL) {
-		Vdev vdev(m_poolConfig, vdevConfig);
+		/*
+		 * Index every leaf in a single traversal so that
+		 * repeated lookups against this configuration need not
+		 * rewalk the vdev tree.  The cursor is preserved across
+		 * the indexing pass.
+		 */
+		Reset();
+		while ((vdevConfig = Next()) != NULL) {
+			Vdev vdev(m_poolConfig, vdevConfig);
 
-		if (vdev.GUID() == vdevGUID)
-			return (vdevConfig);
+			m_guidIndex[vdev.GUID()] = vdevConfig;
+		}
+		m_vdevQueue = savedQueue;
 	}
-	return (NULL);
+
+	std::map<uint64_t, nvlist_t *>::const_iterator
+	    found(m_guidIndex.find(vdevGUID));
+	return ((found != m_guidIndex.end()) ? found->second : NULL);
 }
@@ -40,6 +40,7 @@
  * Header requirements:
  *
  *    #include <list>
+ *    #include <map>
  */
 #ifndef	_VDEV_ITERATOR_H_
 #define	_VDEV_ITERATOR_H_
@@ -101,8 +102,11 @@ public:
 	 * \return  A Vdev object for the matching vdev if found.  Otherwise
 	 *          NULL.
 	 *
-	 * Upon return, the VdevIterator's cursor points to the vdev just
-	 * past the returned vdev or end() if no matching vdev is found.
+	 * The first Find() on a VdevIterator walks the entire vdev tree
+	 * and memoizes the GUID of every leaf; subsequent Find() calls
+	 * on the same iterator are satisfied from the index without
+	 * another traversal.  Find() does not disturb this iterator's
+	 * cursor.
 	 */
 	nvlist_t *Find(DevdCtl::Guid vdevGUID);
 
@@ -117,7 +121,23 @@ public:
 
 private:
 	nvlist_t                *m_poolConfig;
+
+	/**
+	 * Root vdev tree obtained in bulk from libzfs when this iterator
+	 * was constructed from a pool handle, or NULL when iterating a
+	 * caller supplied configuration.  The tree embeds the status of
+	 * every leaf, so traversal never queries the kernel per vdev.
+	 */
+	nvlist_t                *m_rootVdev;
 	std::list<nvlist_t *>	 m_vdevQueue;
+
+	/**
+	 * Index of leaf vdev configuration data by vdev GUID, built
+	 * lazily by the first call to Find().  The index is valid for
+	 * the lifetime of this iterator because m_poolConfig is a
+	 * snapshot of the pool configuration.
+	 */
+	std::map<uint64_t, nvlist_t *> m_guidIndex;
 };
 
 #endif	/* _VDEV_ITERATOR_H_ */
@@ -58,6 +58,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include <devdctl/guid.h>
 #include <devdctl/event.h>
@@ -211,15 +212,24 @@ ZfsDaemon::VdevAddCaseFile(Vdev &vdev, void *cbArg)
 	return (/*break early*/false);
 }
 
+void
+ZfsDaemon::PoolAddCaseFiles(zpool_handle_t *pool, void *cbArg)
+{
+	VdevIterator(pool).Each(VdevAddCaseFile, cbArg);
+}
+
 void
 ZfsDaemon::BuildCaseFiles()
 {
 	ZpoolList zpl;
 	ZpoolList::iterator pool;
 
-	/* Add CaseFiles for vdevs with issues. */
-	for (pool = zpl.begin(); pool != zpl.end(); pool++)
-		VdevIterator(*pool).Each(VdevAddCaseFile, NULL);
+	/*
+	 * Add CaseFiles for vdevs with issues, scanning the pools in
+	 * parallel; CaseFile::Create() serializes registration of the
+	 * cases the workers find.
+	 */
+	zpl.ForEachParallel(PoolAddCaseFiles, NULL);
 
 	/* De-serialize any saved cases. */
 	CaseFile::DeSerialize();
@@ -325,6 +335,58 @@ ZfsDaemon::DetectMissedEvents()
 	RescanSystem();
 }
 
+void
+ZfsDaemon::ProcessBatchedEvents()
+{
+	std::map<string, EventList::iterator> latest;
+	EventList batch;
+	Event *event;
+
+	/*
+	 * Drain whatever devd has queued for us.  The batch size is
+	 * bounded so that a sustained event storm cannot keep us from
+	 * servicing callouts and signals.
+	 */
+	while (batch.size() < MAX_EVENT_BATCH
+	    && (event = NextEvent()) != NULL)
+		batch.push_back(event);
+
+	/*
+	 * Coalesce exact duplicates, keeping only the most recent
+	 * instance of each (system, subsystem, type, devname) tuple.
+	 * Events without a device name are never coalesced.
+	 */
+	for (EventList::iterator curEvent = batch.begin();
+	     curEvent != batch.end();) {
+		string devName;
+
+		if (!(*curEvent)->DevName(devName) || devName.empty()) {
+			curEvent++;
+			continue;
+		}
+
+		string key((*curEvent)->Value("system") + ';'
+			 + (*curEvent)->Value("subsystem") + ';'
+			 + (*curEvent)->Value("type") + ';'
+			 + devName);
+		std::map<string, EventList::iterator>::iterator
+		    prev(latest.find(key));
+		if (prev != latest.end()) {
+			delete *prev->second;
+			batch.erase(prev->second);
+		}
+		latest[key] = curEvent;
+		curEvent++;
+	}
+
+	for (EventList::iterator curEvent = batch.begin();
+	     curEvent != batch.end(); curEvent++) {
+		if ((*curEvent)->Process())
+			SaveEvent(**curEvent);
+		delete *curEvent;
+	}
+}
+
 void
 ZfsDaemon::EventLoop()
 {
@@ -360,7 +422,7 @@ ZfsDaemon::EventLoop()
 		}
 
 		if ((fds[0].revents & POLLIN) != 0)
-			ProcessEvents();
+			ProcessBatchedEvents();
 
 		if ((fds[1].revents & POLLIN) != 0) {
 			static char discardBuf[128];
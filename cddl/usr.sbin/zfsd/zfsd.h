@@ -105,11 +105,26 @@ public:
 	static void Run();
 
 private:
+	enum {
+		/**
+		 * Maximum number of events drained from devd in a single
+		 * batch.  Bounds both the latency added by coalescing and
+		 * the memory needed to hold a batch during an event storm.
+		 */
+		MAX_EVENT_BATCH = 1024
+	};
+
 	ZfsDaemon();
 	~ZfsDaemon();
 
 	static VdevCallback_t VdevAddCaseFile;
 
+	/**
+	 * ZpoolList::ForEachParallel() visitor: create CaseFiles for
+	 * the unhealthy vdevs of a single pool.
+	 */
+	static void PoolAddCaseFiles(zpool_handle_t *pool, void *cbArg);
+
 	/** Purge our cache of outstanding ZFS issues in the system. */
 	void PurgeCaseFiles();
 
@@ -134,6 +149,18 @@ private:
 	 */
 	void EventLoop();
 
+	/**
+	 * Drain the devd socket, coalesce duplicate events, and process
+	 * the surviving events in arrival order.
+	 *
+	 * During event storms (e.g. a controller reset), devd delivers
+	 * thousands of near-identical events.  Exact duplicates - events
+	 * matching on system, subsystem, type, and device name - trigger
+	 * identical case evaluations, so only the most recent instance
+	 * of each tuple in a batch is processed.
+	 */
+	void ProcessBatchedEvents();
+
 	/**
 	 * Signal handler for which our response is to
 	 * log the current state of the daemon.
@@ -53,6 +53,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include <devdctl/guid.h>
 #include <devdctl/event.h>
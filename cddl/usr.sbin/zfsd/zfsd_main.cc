@@ -46,6 +46,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include <devdctl/guid.h>
 #include <devdctl/event.h>
@@ -41,13 +41,16 @@
 #include <sys/byteorder.h>
 #include <sys/fs/zfs.h>
 
+#include <pthread.h>
 #include <stdint.h>
+#include <unistd.h>
 
 #include <libzfs.h>
 
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include <devdctl/guid.h>
 #include <devdctl/event.h>
@@ -113,6 +116,79 @@ ZpoolList::ZpoolList(PoolFilter_t *filter, void * filterArg)
 	zpool_iter(g_zfsHandle, LoadIterator, this);
 }
 
+void *
+ZpoolList::VisitorThread(void *arg)
+{
+	VisitorContext *ctx(static_cast<VisitorContext *>(arg));
+
+	for (;;) {
+		zpool_handle_t *pool;
+
+		pthread_mutex_lock(&ctx->lock);
+		if (ctx->next == ctx->list->end()) {
+			pthread_mutex_unlock(&ctx->lock);
+			break;
+		}
+		pool = *ctx->next;
+		ctx->next++;
+		pthread_mutex_unlock(&ctx->lock);
+
+		ctx->visitor(pool, ctx->visitorArg);
+	}
+	return (NULL);
+}
+
+void
+ZpoolList::ForEachParallel(PoolVisitor_t *visitor, void *visitorArg,
+			   u_int numThreads)
+{
+	VisitorContext ctx;
+	pthread_t *threads;
+	u_int i;
+
+	if (empty())
+		return;
+
+	if (numThreads == 0) {
+		long ncpu(sysconf(_SC_NPROCESSORS_ONLN));
+
+		numThreads = (ncpu > 0) ? (u_int)ncpu : 1;
+	}
+	if (numThreads > size())
+		numThreads = size();
+
+	if (numThreads == 1) {
+		/* Avoid thread creation overhead for the common case. */
+		for (iterator it(begin()); it != end(); it++)
+			visitor(*it, visitorArg);
+		return;
+	}
+
+	ctx.list = this;
+	ctx.next = begin();
+	ctx.visitor = visitor;
+	ctx.visitorArg = visitorArg;
+	pthread_mutex_init(&ctx.lock, NULL);
+
+	threads = new pthread_t[numThreads];
+	for (i = 0; i < numThreads; i++) {
+		if (pthread_create(&threads[i], NULL, VisitorThread,
+		    &ctx) != 0) {
+			/*
+			 * Fall back to running the remaining work on
+			 * whatever workers we managed to create, plus
+			 * this thread.
+			 */
+			break;
+		}
+	}
+	VisitorThread(&ctx);
+	while (i-- != 0)
+		pthread_join(threads[i], NULL);
+	delete[] threads;
+	pthread_mutex_destroy(&ctx.lock);
+}
+
 ZpoolList::~ZpoolList()
 {
 	for (iterator it(begin()); it != end(); it++)
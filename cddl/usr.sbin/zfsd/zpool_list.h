@@ -40,6 +40,8 @@
  *
  * Header requirements:
  *
+ *    #include <pthread.h>
+ *
  *    #include <list>
  *    #include <string>
  */
@@ -63,6 +65,7 @@ class Vdev;
 class ZpoolList;
 typedef bool PoolFilter_t(zpool_handle_t *pool, nvlist_t *poolConfig,
 			  void *filterArg);
+typedef void PoolVisitor_t(zpool_handle_t *pool, void *visitorArg);
 
 /**
  * \brief Container of imported ZFS pool data.
@@ -107,7 +110,46 @@ public:
 	ZpoolList(PoolFilter_t *filter = ZpoolAll, void *filterArg = NULL);
 	~ZpoolList();
 
+	/**
+	 * \brief Invoke a visitor on every pool in this list, fanning
+	 *        the per-pool work out to a pool of worker threads.
+	 *
+	 * Each pool is dispatched to exactly one worker, so per-pool
+	 * processing (e.g. CaseFile updates) remains serialized even
+	 * though distinct pools are visited concurrently.
+	 *
+	 * \param visitor     The function to invoke on each pool.
+	 * \param visitorArg  A single argument passed to the visitor with
+	 *                    each pool.  The visitor must perform its own
+	 *                    synchronization for any state shared across
+	 *                    pools.
+	 * \param numThreads  Maximum number of worker threads to use.  A
+	 *                    value of 0 (the default) sizes the worker
+	 *                    pool from the number of online CPUs.
+	 */
+	void ForEachParallel(PoolVisitor_t *visitor, void *visitorArg,
+			     u_int numThreads = 0);
+
 private:
+	/**
+	 * \brief Shared state handed to each ForEachParallel() worker.
+	 */
+	struct VisitorContext
+	{
+		ZpoolList	*list;
+		iterator	 next;
+		PoolVisitor_t	*visitor;
+		void		*visitorArg;
+		pthread_mutex_t	 lock;
+	};
+
+	/**
+	 * \brief Worker thread entry point for ForEachParallel().
+	 *
+	 * \param arg  The VisitorContext shared by all workers.
+	 */
+	static void *VisitorThread(void *arg);
+
 	/**
 	 * \brief Helper routine used to populate the internal
 	 *        data store of ZFS pool objects using libzfs's
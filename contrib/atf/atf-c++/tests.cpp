@@ -298,6 +298,13 @@ impl::tc::run(const std::string& resfile)
         throw_atf_error(err);
 }
 
+int
+impl::tc::run_noexit(const std::string& resfile)
+    const
+{
+    return atf_tc_run_noexit(&pimpl->m_tc, resfile.c_str());
+}
+
 void
 impl::tc::run_cleanup(void)
     const
@@ -553,6 +560,38 @@ run_tc(tc_vector& tcs, const std::string& tcarg, const atf::fs::path& resfile)
     return EXIT_SUCCESS;
 }
 
+static int
+run_tcs_same_process(tc_vector& tcs, char** names, const int count,
+                     const atf::fs::path& resfile)
+{
+    int errcode = EXIT_SUCCESS;
+
+    std::cerr << Program_Name << ": WARNING: Running several test cases in "
+        "the same process; no isolation is applied between them\n";
+
+    for (int i = 0; i < count; i++) {
+        const std::pair< std::string, tc_part > fields =
+            process_tcarg(names[i]);
+        if (fields.second != BODY)
+            throw usage_error("Cannot run the cleanup part of `%s' together "
+                              "with other test cases", names[i]);
+
+        impl::tc* tc = find_tc(tcs, fields.first);
+
+        // The results file protocol carries a single result, so each test
+        // case gets its own file unless the output goes to a console stream,
+        // in which case the results are simply emitted in sequence.
+        std::string tc_resfile = resfile.str();
+        if (tc_resfile != "/dev/stdout" && tc_resfile != "/dev/stderr")
+            tc_resfile += "." + fields.first;
+
+        if (tc->run_noexit(tc_resfile) != EXIT_SUCCESS)
+            errcode = EXIT_FAILURE;
+    }
+
+    return errcode;
+}
+
 static int
 safe_main(int argc, char** argv, void (*add_tcs)(tc_vector&))
 {
@@ -619,12 +658,17 @@ safe_main(int argc, char** argv, void (*add_tcs)(tc_vector&))
     } else {
         if (argc == 0)
             throw usage_error("Must provide a test case name");
-        else if (argc > 1)
-            throw usage_error("Cannot provide more than one test case name");
-        INV(argc == 1);
 
         init_tcs(add_tcs, tcs, vars);
-        errcode = run_tc(tcs, argv[0], resfile);
+        if (argc == 1)
+            errcode = run_tc(tcs, argv[0], resfile);
+        else {
+            // Several test case names waive the one-process-per-case
+            // isolation explicitly: all the bodies run in this process,
+            // back to back.  This is only appropriate for pure in-process
+            // unit tests, where the fork per case dwarfs the test body.
+            errcode = run_tcs_same_process(tcs, argv, argc, resfile);
+        }
     }
     for (tc_vector::iterator iter = tcs.begin(); iter != tcs.end(); iter++) {
         impl::tc* tc = *iter;
@@ -100,6 +100,7 @@ public:
     void set_md_var(const std::string&, const std::string&);
 
     void run(const std::string&) const;
+    int run_noexit(const std::string&) const;
     void run_cleanup(void) const;
 
     // To be called from the child process only.
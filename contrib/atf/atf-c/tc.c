@@ -31,6 +31,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <setjmp.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -64,6 +65,12 @@ struct context {
     const char *resfile;
     size_t fail_count;
 
+    /* If not NULL, terminal functions jump here with the would-be exit
+     * code stored in exitcode instead of exiting the process; see
+     * atf_tc_run_noexit(). */
+    jmp_buf *runjb;
+    int exitcode;
+
     enum expect_type expect;
     atf_dynstr_t expect_reason;
     size_t expect_previous_fail_count;
@@ -73,6 +80,8 @@ struct context {
 };
 
 static void context_init(struct context *, const atf_tc_t *, const char *);
+static void context_exit(struct context *, int) ATF_DEFS_ATTRIBUTE_NORETURN;
+static void conclude_tc(struct context *) ATF_DEFS_ATTRIBUTE_NORETURN;
 static void check_fatal_error(atf_error_t);
 static void report_fatal_error(const char *, ...)
     ATF_DEFS_ATTRIBUTE_NORETURN;
@@ -108,6 +117,8 @@ context_init(struct context *ctx, const atf_tc_t *tc, const char *resfile)
     ctx->tc = tc;
     ctx->resfile = resfile;
     ctx->fail_count = 0;
+    ctx->runjb = NULL;
+    ctx->exitcode = EXIT_FAILURE;
     ctx->expect = EXPECT_PASS;
     check_fatal_error(atf_dynstr_init(&ctx->expect_reason));
     ctx->expect_previous_fail_count = 0;
@@ -116,6 +127,23 @@ context_init(struct context *ctx, const atf_tc_t *tc, const char *resfile)
     ctx->expect_signo = 0;
 }
 
+/** Terminates the execution of a test case.
+ *
+ * In the default one-case-per-process mode this exits the process with the
+ * given code.  When the caller requested same-process execution through
+ * atf_tc_run_noexit(), this unwinds back into the runner instead so that
+ * further test cases can be executed by this process.
+ */
+static void
+context_exit(struct context *ctx, int exitcode)
+{
+    if (ctx->runjb != NULL) {
+        ctx->exitcode = exitcode;
+        longjmp(*ctx->runjb, 1);
+    }
+    exit(exitcode);
+}
+
 static void
 check_fatal_error(atf_error_t err)
 {
@@ -281,7 +309,7 @@ expected_failure(struct context *ctx, atf_dynstr_t *reason)
     check_fatal_error(atf_dynstr_prepend_fmt(reason, "%s: ",
         atf_dynstr_cstring(&ctx->expect_reason)));
     create_resfile(ctx->resfile, "expected_failure", -1, reason);
-    exit(EXIT_SUCCESS);
+    context_exit(ctx, EXIT_SUCCESS);
 }
 
 static void
@@ -291,7 +319,7 @@ fail_requirement(struct context *ctx, atf_dynstr_t *reason)
         expected_failure(ctx, reason);
     } else if (ctx->expect == EXPECT_PASS) {
         create_resfile(ctx->resfile, "failed", -1, reason);
-        exit(EXIT_FAILURE);
+        context_exit(ctx, EXIT_FAILURE);
     } else {
         error_in_expect(ctx, "Test case raised a failure but was not "
             "expecting one; reason was %s", atf_dynstr_cstring(reason));
@@ -326,7 +354,7 @@ pass(struct context *ctx)
             "a pass instead");
     } else if (ctx->expect == EXPECT_PASS) {
         create_resfile(ctx->resfile, "passed", -1, NULL);
-        exit(EXIT_SUCCESS);
+        context_exit(ctx, EXIT_SUCCESS);
     } else {
         error_in_expect(ctx, "Test case asked to explicitly pass but was "
             "not expecting such condition");
@@ -339,7 +367,7 @@ skip(struct context *ctx, atf_dynstr_t *reason)
 {
     if (ctx->expect == EXPECT_PASS) {
         create_resfile(ctx->resfile, "skipped", -1, reason);
-        exit(EXIT_SUCCESS);
+        context_exit(ctx, EXIT_SUCCESS);
     } else {
         error_in_expect(ctx, "Can only skip a test case when running in "
             "expect pass mode");
@@ -347,6 +375,30 @@ skip(struct context *ctx, atf_dynstr_t *reason)
     UNREACHABLE;
 }
 
+/** Reports the final result of a test case whose body has returned. */
+static void
+conclude_tc(struct context *ctx)
+{
+    validate_expect(ctx);
+
+    if (ctx->fail_count > 0) {
+        atf_dynstr_t reason;
+
+        format_reason_fmt(&reason, NULL, 0, "%d checks failed; see output for "
+            "more details", ctx->fail_count);
+        fail_requirement(ctx, &reason);
+    } else if (ctx->expect_fail_count > 0) {
+        atf_dynstr_t reason;
+
+        format_reason_fmt(&reason, NULL, 0, "%d checks failed as expected; "
+            "see output for more details", ctx->expect_fail_count);
+        expected_failure(ctx, &reason);
+    } else {
+        pass(ctx);
+    }
+    UNREACHABLE;
+}
+
 /** Formats a failure/skip reason message.
  *
  * The formatted reason is stored in out_reason.  out_reason is initialized
@@ -1007,25 +1059,40 @@ atf_tc_run(const atf_tc_t *tc, const char *resfile)
 
     tc->pimpl->m_body(tc);
 
-    validate_expect(&Current);
+    conclude_tc(&Current);
+    UNREACHABLE;
+    return atf_no_error();
+}
 
-    if (Current.fail_count > 0) {
-        atf_dynstr_t reason;
+/* Runs a test case body without ever exiting the process.
+ *
+ * This is the same-process variant of atf_tc_run(): all the isolation
+ * provided by running every test case in its own process is explicitly
+ * waived by the caller, in exchange for not paying a fork and exec per
+ * case.  Terminal conditions unwind back here via longjmp instead of
+ * exiting, so several test cases can be run by a single process.  Note
+ * that an abrupt termination of the body (abort, signal) still takes the
+ * whole process down, and that any state leaked by one body is visible
+ * to the next.
+ *
+ * Returns the exit code the one-case-per-process mode would have exited
+ * with, i.e. EXIT_SUCCESS for passed, skipped and expected failures.
+ */
+int
+atf_tc_run_noexit(const atf_tc_t *tc, const char *resfile)
+{
+    jmp_buf jb;
 
-        format_reason_fmt(&reason, NULL, 0, "%d checks failed; see output for "
-            "more details", Current.fail_count);
-        fail_requirement(&Current, &reason);
-    } else if (Current.expect_fail_count > 0) {
-        atf_dynstr_t reason;
+    context_init(&Current, tc, resfile);
+    Current.runjb = &jb;
+    if (setjmp(jb) != 0)
+        return Current.exitcode;
 
-        format_reason_fmt(&reason, NULL, 0, "%d checks failed as expected; "
-            "see output for more details", Current.expect_fail_count);
-        expected_failure(&Current, &reason);
-    } else {
-        pass(&Current);
-    }
+    tc->pimpl->m_body(tc);
+
+    conclude_tc(&Current);
     UNREACHABLE;
-    return atf_no_error();
+    return EXIT_FAILURE;
 }
 
 atf_error_t
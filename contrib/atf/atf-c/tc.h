@@ -96,6 +96,7 @@ atf_error_t atf_tc_set_md_var(atf_tc_t *, const char *, const char *, ...);
  * --------------------------------------------------------------------- */
 
 atf_error_t atf_tc_run(const atf_tc_t *, const char *);
+int atf_tc_run_noexit(const atf_tc_t *, const char *);
 atf_error_t atf_tc_cleanup(const atf_tc_t *);
 
 /* To be run from test case bodies only. */
@@ -20,6 +20,12 @@
 #include "jemalloc/internal/ticker.h"
 #include "jemalloc/internal/util.h"
 
+#ifdef __FreeBSD__
+#include <sys/cpuset.h>
+#include <sys/domainset.h>
+#include <sys/sysctl.h>
+#endif
+
 /******************************************************************************/
 /* Data. */
 
@@ -498,6 +504,52 @@ label_return:
 	return tdata;
 }
 
+#ifdef __FreeBSD__
+/*
+ * Number of memory domains, as reported by vm.ndomains; 0 until probed.
+ * A value of 1 disables the domain partitioning of automatic arenas.
+ */
+static unsigned numa_ndomains;
+
+/*
+ * FreeBSD-specific: partition the automatic arenas across memory domains,
+ * with arena i serving domain i % vm.ndomains.  When the calling thread's
+ * domainset policy allows exactly one domain (e.g. it was pinned with
+ * cpuset(1)), restrict its arena choice to that domain's arenas, so the
+ * arena's extents are faulted in and recycled domain-locally.  Threads
+ * without a single-domain policy keep the default round-robin behavior.
+ */
+static void
+arena_domain_partition(unsigned *astart, unsigned *astep) {
+	domainset_t mask;
+	int policy;
+
+	if (numa_ndomains == 0) {
+		unsigned ndom;
+		size_t sz = sizeof(ndom);
+
+		if (sysctlbyname("vm.ndomains", &ndom, &sz, NULL, 0) != 0 ||
+		    ndom < 1) {
+			ndom = 1;
+		}
+		numa_ndomains = ndom;
+	}
+	if (numa_ndomains < 2 || narenas_auto < numa_ndomains) {
+		return;
+	}
+	if (cpuset_getdomain(CPU_LEVEL_WHICH, CPU_WHICH_TID, -1,
+	    sizeof(mask), &mask, &policy) != 0) {
+		return;
+	}
+	if (policy == DOMAINSET_POLICY_INVALID ||
+	    DOMAINSET_COUNT(&mask) != 1) {
+		return;
+	}
+	*astart = (unsigned)(DOMAINSET_FFS(&mask) - 1) % numa_ndomains;
+	*astep = numa_ndomains;
+}
+#endif
+
 /* Slow path, called only by arena_choose(). */
 arena_t *
 arena_choose_hard(tsd_t *tsd, bool internal) {
@@ -515,6 +567,7 @@ arena_choose_hard(tsd_t *tsd, bool internal) {
 
 	if (narenas_auto > 1) {
 		unsigned i, j, choose[2], first_null;
+		unsigned astart, astep;
 		bool is_new_arena[2];
 
 		/*
@@ -523,7 +576,16 @@ arena_choose_hard(tsd_t *tsd, bool internal) {
 		 *
 		 *   choose[0]: For application allocation.
 		 *   choose[1]: For internal metadata allocation.
+		 *
+		 * The candidate arenas are normally all of the automatic
+		 * arenas; a domain-pinned thread only considers every
+		 * astep'th arena starting at astart.
 		 */
+		astart = 0;
+		astep = 1;
+#ifdef __FreeBSD__
+		arena_domain_partition(&astart, &astep);
+#endif
 
 		for (j = 0; j < 2; j++) {
 			choose[j] = 0;
@@ -533,7 +595,19 @@ arena_choose_hard(tsd_t *tsd, bool internal) {
 		first_null = narenas_auto;
 		malloc_mutex_lock(tsd_tsdn(tsd), &arenas_lock);
 		assert(arena_get(tsd_tsdn(tsd), 0, false) != NULL);
-		for (i = 1; i < narenas_auto; i++) {
+		if (arena_get(tsd_tsdn(tsd), astart, false) != NULL) {
+			for (j = 0; j < 2; j++) {
+				choose[j] = astart;
+			}
+		} else {
+			/*
+			 * The first arena of the partition is not
+			 * initialized yet; arena 0 stands in for the
+			 * load comparison below.
+			 */
+			first_null = astart;
+		}
+		for (i = astart + astep; i < narenas_auto; i += astep) {
 			if (arena_get(tsd_tsdn(tsd), i, false) != NULL) {
 				/*
 				 * Choose the first arena that has the lowest
@@ -563,8 +637,9 @@ arena_choose_hard(tsd_t *tsd, bool internal) {
 		}
 
 		for (j = 0; j < 2; j++) {
-			if (arena_nthreads_get(arena_get(tsd_tsdn(tsd),
-			    choose[j], false), !!j) == 0 || first_null ==
+			if ((arena_nthreads_get(arena_get(tsd_tsdn(tsd),
+			    choose[j], false), !!j) == 0 &&
+			    choose[j] % astep == astart) || first_null ==
 			    narenas_auto) {
 				/*
 				 * Use an unloaded arena, or the least loaded
@@ -39,6 +39,7 @@ extern "C" {
 #include <signal.h>
 }
 
+#include <deque>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -867,3 +868,125 @@ executor::executor_handle::check_interrupt(void) const
 {
     signals::check_interrupt();
 }
+
+
+/// Internal implementation for the job_queue.
+struct utils::process::executor::job_queue::impl : utils::noncopyable {
+    /// Executor on which jobs are spawned.
+    ///
+    /// This is a copy of the handle given at construction time, which is fine
+    /// because all copies of an executor_handle share their state.
+    executor_handle handle;
+
+    /// Maximum number of jobs to keep running concurrently.
+    const std::size_t slots;
+
+    /// Jobs not yet started, in dispatch order.
+    std::deque< std::shared_ptr< job > > pending;
+
+    /// Number of jobs started but not yet waited for.
+    std::size_t running;
+
+    /// Constructor.
+    ///
+    /// \param handle_ Executor on which to spawn the jobs.
+    /// \param slots_ Maximum number of concurrent jobs; must be positive.
+    impl(executor_handle& handle_, const std::size_t slots_) :
+        handle(handle_), slots(slots_), running(0)
+    {
+        PRE(slots > 0);
+    }
+
+    /// Starts pending jobs until all slots are busy or no jobs remain.
+    ///
+    /// This is the scheduling decision of the queue: any free slot is
+    /// immediately given to the oldest pending job, no matter which test
+    /// program it belongs to, so slots never sit idle while work remains.
+    void
+    fill(void)
+    {
+        while (running < slots && !pending.empty()) {
+            const std::shared_ptr< job > next_job = pending.front();
+            pending.pop_front();
+            next_job->spawn(handle);
+            ++running;
+        }
+    }
+};
+
+
+/// Constructor.
+///
+/// \param handle Executor on which to spawn the jobs.  The queue operates on
+///     a copy, so this need not outlive the queue; however, the executor state
+///     is shared and must not be cleaned up before the queue is drained.
+/// \param slots Maximum number of concurrent jobs; must be positive.
+executor::job_queue::job_queue(executor_handle& handle,
+                               const std::size_t slots) :
+    _pimpl(new impl(handle, slots))
+{
+}
+
+
+/// Destructor.
+executor::job_queue::~job_queue(void)
+{
+}
+
+
+/// Adds a job to the queue, starting it right away if a slot is free.
+///
+/// \param new_job The job to add.
+void
+executor::job_queue::push(const std::shared_ptr< job >& new_job)
+{
+    _pimpl->pending.push_back(new_job);
+    _pimpl->fill();
+}
+
+
+/// Queries the number of jobs not yet started.
+///
+/// \return Number of queued jobs.
+std::size_t
+executor::job_queue::pending(void) const
+{
+    return _pimpl->pending.size();
+}
+
+
+/// Queries the number of jobs started but not yet waited for.
+///
+/// \return Number of alive jobs.
+std::size_t
+executor::job_queue::running(void) const
+{
+    return _pimpl->running;
+}
+
+
+/// Checks whether the queue has been fully drained.
+///
+/// \return True if there are neither pending nor running jobs.
+bool
+executor::job_queue::empty(void) const
+{
+    return _pimpl->running == 0 && _pimpl->pending.empty();
+}
+
+
+/// Waits for completion of any running job and refills the freed slot.
+///
+/// \pre The queue is not empty().
+///
+/// \return A pointer to an object describing the waited-for subprocess.
+executor::exit_handle
+executor::job_queue::wait_any(void)
+{
+    PRE(!empty());
+    _pimpl->fill();
+    const exit_handle handle = _pimpl->handle.wait_any();
+    --_pimpl->running;
+    _pimpl->fill();
+    return handle;
+}
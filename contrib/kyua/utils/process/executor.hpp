@@ -223,6 +223,56 @@ public:
 executor_handle setup(void);
 
 
+/// Abstract unit of deferred work for a job_queue.
+///
+/// A job wraps whatever information is needed to spawn one subprocess (in
+/// practice, a single test case) so that the queue can defer the fork until an
+/// execution slot becomes free.
+class job {
+public:
+    virtual ~job(void) {}
+
+    /// Forks and starts the subprocess represented by this job.
+    ///
+    /// \param handle Executor on which to invoke spawn().
+    ///
+    /// \return The execution handle of the started subprocess.
+    virtual exec_handle spawn(executor_handle& handle) = 0;
+};
+
+
+/// Work-conserving dispatcher of jobs over a bounded number of slots.
+///
+/// The queue keeps at most a fixed number of subprocesses alive at any time
+/// and starts a pending job as soon as a slot frees up, regardless of which
+/// program the job came from.  Callers that enqueue individual test cases
+/// instead of whole test programs therefore get per-test-case dispatch: the
+/// remaining cases of a long-running program spread over all free slots at
+/// the tail of a run instead of draining serially in a single slot.
+///
+/// Jobs are started in the order they were pushed; only the completion order
+/// is arbitrary.  The caller must drain the queue with wait_any() until
+/// empty() is true before cleaning up the executor.
+class job_queue {
+    struct impl;
+
+    /// Pointer to internal implementation.
+    std::shared_ptr< impl > _pimpl;
+
+public:
+    job_queue(executor_handle&, const std::size_t);
+    ~job_queue(void);
+
+    void push(const std::shared_ptr< job >&);
+
+    std::size_t pending(void) const;
+    std::size_t running(void) const;
+    bool empty(void) const;
+
+    exit_handle wait_any(void);
+};
+
+
 }  // namespace executor
 }  // namespace process
 }  // namespace utils
@@ -40,6 +40,8 @@ namespace executor {
 class exec_handle;
 class executor_handle;
 class exit_handle;
+class job;
+class job_queue;
 
 
 }  // namespace executor
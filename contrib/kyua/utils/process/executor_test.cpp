@@ -41,6 +41,7 @@ extern "C" {
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <vector>
 
 #include <atf-c++.hpp>
@@ -324,6 +325,32 @@ do_spawn(executor::executor_handle& handle, Hook hook,
 }
 
 
+/// Job that runs a child_exit subprocess when dispatched by a job_queue.
+class exit_job : public executor::job {
+    /// Exit code the subprocess will return.
+    const int _exit_code;
+
+public:
+    /// Constructor.
+    ///
+    /// \param exit_code Exit code the subprocess will return.
+    exit_job(const int exit_code) : _exit_code(exit_code)
+    {
+    }
+
+    /// Forks and starts the subprocess represented by this job.
+    ///
+    /// \param handle Executor on which to invoke spawn().
+    ///
+    /// \return The execution handle of the started subprocess.
+    executor::exec_handle
+    spawn(executor::executor_handle& handle)
+    {
+        return handle.spawn(child_exit(_exit_code), infinite_timeout, none);
+    }
+};
+
+
 /// Checks for a specific exit status in the status of a exit_handle.
 ///
 /// \param exit_status The expected exit status.
@@ -446,6 +473,70 @@ ATF_TEST_CASE_BODY(integration__run_many)
 }
 
 
+ATF_TEST_CASE_WITHOUT_HEAD(integration__job_queue__run_many);
+ATF_TEST_CASE_BODY(integration__job_queue__run_many)
+{
+    static const std::size_t num_jobs = 20;
+    static const std::size_t num_slots = 4;
+
+    executor::executor_handle handle = executor::setup();
+    executor::job_queue queue(handle, num_slots);
+
+    for (std::size_t i = 0; i < num_jobs; ++i) {
+        queue.push(std::shared_ptr< executor::job >(new exit_job(i)));
+        ATF_REQUIRE(queue.running() <= num_slots);
+    }
+    ATF_REQUIRE_EQ(num_slots, queue.running());
+    ATF_REQUIRE_EQ(num_jobs - num_slots, queue.pending());
+
+    std::set< int > exit_statuses;
+    while (!queue.empty()) {
+        executor::exit_handle exit_handle = queue.wait_any();
+        ATF_REQUIRE(queue.running() <= num_slots);
+
+        ATF_REQUIRE(exit_handle.status());
+        ATF_REQUIRE(exit_handle.status().get().exited());
+        exit_statuses.insert(exit_handle.status().get().exitstatus());
+
+        exit_handle.cleanup();
+    }
+    ATF_REQUIRE_EQ(num_jobs, exit_statuses.size());
+    for (std::size_t i = 0; i < num_jobs; ++i) {
+        ATF_REQUIRE(exit_statuses.find(i) != exit_statuses.end());
+    }
+
+    handle.cleanup();
+}
+
+
+ATF_TEST_CASE_WITHOUT_HEAD(integration__job_queue__keeps_slots_busy);
+ATF_TEST_CASE_BODY(integration__job_queue__keeps_slots_busy)
+{
+    executor::executor_handle handle = executor::setup();
+    executor::job_queue queue(handle, 2);
+
+    // A single long job must not prevent the queued short jobs from being
+    // dispatched to the remaining slot as it frees up.
+    queue.push(std::shared_ptr< executor::job >(new exit_job(15)));
+    queue.push(std::shared_ptr< executor::job >(new exit_job(16)));
+    queue.push(std::shared_ptr< executor::job >(new exit_job(17)));
+    ATF_REQUIRE_EQ(2, queue.running());
+    ATF_REQUIRE_EQ(1, queue.pending());
+
+    executor::exit_handle exit_handle = queue.wait_any();
+    ATF_REQUIRE_EQ(2, queue.running());
+    ATF_REQUIRE_EQ(0, queue.pending());
+    exit_handle.cleanup();
+
+    while (!queue.empty()) {
+        executor::exit_handle next_handle = queue.wait_any();
+        next_handle.cleanup();
+    }
+
+    handle.cleanup();
+}
+
+
 ATF_TEST_CASE_WITHOUT_HEAD(integration__parameters_and_output);
 ATF_TEST_CASE_BODY(integration__parameters_and_output)
 {
@@ -921,6 +1012,8 @@ ATF_INIT_TEST_CASES(tcs)
 {
     ATF_ADD_TEST_CASE(tcs, integration__run_one);
     ATF_ADD_TEST_CASE(tcs, integration__run_many);
+    ATF_ADD_TEST_CASE(tcs, integration__job_queue__run_many);
+    ATF_ADD_TEST_CASE(tcs, integration__job_queue__keeps_slots_busy);
 
     ATF_ADD_TEST_CASE(tcs, integration__parameters_and_output);
     ATF_ADD_TEST_CASE(tcs, integration__custom_output_files);
@@ -392,6 +392,9 @@ int	 fdclose(FILE *, int *);
 char	*fgetln(FILE *, size_t *);
 const char *fmtcheck(const char *, const char *) __format_arg(2);
 int	 fpurge(FILE *);
+struct iovec;
+__ssize_t fwritev(FILE * __restrict, const struct iovec *, int);
+__ssize_t fwritev_unlocked(FILE * __restrict, const struct iovec *, int);
 void	 setbuffer(FILE *, char *, int);
 int	 setlinebuf(FILE *);
 int	 vasprintf(char **, const char *, __va_list)
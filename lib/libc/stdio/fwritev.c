@@ -0,0 +1,127 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+#include "namespace.h"
+#include <sys/uio.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "un-namespace.h"
+#include "local.h"
+#include "fvwrite.h"
+#include "libc_private.h"
+
+#define	FWRITEV_STACKIOV	16
+
+/*
+ * Write the memory regions described by the iovec array to the given
+ * file under a single lock acquisition, buffering through the FILE as
+ * usual.  Return the number of bytes written; on error the number of
+ * bytes written before the error is returned, or -1 if nothing was
+ * written, with the stream error indicator set.
+ */
+ssize_t
+fwritev_unlocked(FILE * __restrict fp, const struct iovec *iov, int iovcnt)
+{
+	struct __suio uio;
+	struct __siov siovs[FWRITEV_STACKIOV], *siov;
+	size_t n;
+	ssize_t ret;
+	int i;
+
+	if (iovcnt < 0 || iovcnt > IOV_MAX) {
+		errno = EINVAL;
+		fp->_flags |= __SERR;
+		return (-1);
+	}
+	if (iovcnt == 0)
+		return (0);
+
+	/*
+	 * __sfvwrite() consumes its iovec array in place, so build a
+	 * scratch copy; it also keeps the residual count in an int,
+	 * which bounds the total transfer size.
+	 */
+	if (iovcnt <= FWRITEV_STACKIOV)
+		siov = siovs;
+	else {
+		siov = malloc((size_t)iovcnt * sizeof(*siov));
+		if (siov == NULL) {
+			fp->_flags |= __SERR;
+			return (-1);
+		}
+	}
+	n = 0;
+	for (i = 0; i < iovcnt; i++) {
+		siov[i].iov_base = iov[i].iov_base;
+		siov[i].iov_len = iov[i].iov_len;
+		if (iov[i].iov_len > INT_MAX - n) {
+			errno = EINVAL;
+			fp->_flags |= __SERR;
+			ret = -1;
+			goto out;
+		}
+		n += iov[i].iov_len;
+	}
+	if (n == 0) {
+		ret = 0;
+		goto out;
+	}
+
+	uio.uio_iov = siov;
+	uio.uio_iovcnt = iovcnt;
+	uio.uio_resid = n;
+
+	ORIENT(fp, -1);
+	if (__sfvwrite(fp, &uio) == 0)
+		ret = n;
+	else {
+		ret = n - uio.uio_resid;
+		if (ret == 0)
+			ret = -1;
+	}
+out:
+	if (siov != siovs)
+		free(siov);
+	return (ret);
+}
+
+ssize_t
+fwritev(FILE * __restrict fp, const struct iovec *iov, int iovcnt)
+{
+	ssize_t ret;
+
+	FLOCKFILE_CANCELSAFE(fp);
+	ret = fwritev_unlocked(fp, iov, iovcnt);
+	FUNLOCKFILE_CANCELSAFE();
+	return (ret);
+}
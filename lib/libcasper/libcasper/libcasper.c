@@ -43,10 +43,12 @@ __FBSDID("$FreeBSD$");
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "libcasper.h"
 #include "libcasper_impl.h"
+#include "shring.h"
 
 #define	CASPER_VALID_FLAGS	(CASPER_NO_UNIQ)
 
@@ -66,6 +68,8 @@ struct cap_channel {
 	int	cch_pd;
 	/* Flags to communicate with casper. */
 	int	cch_flags;
+	/* Optional shared-memory exchange channel, see cap_ring_enable(). */
+	struct cap_shring *cch_ring;
 };
 
 static bool
@@ -144,6 +148,7 @@ cap_wrap(int sock, int flags)
 		chan->cch_sock = sock;
 		chan->cch_pd = -1;
 		chan->cch_flags = flags;
+		chan->cch_ring = NULL;
 		chan->cch_magic = CAP_CHANNEL_MAGIC;
 	}
 
@@ -161,6 +166,8 @@ cap_unwrap(cap_channel_t *chan, int *flags)
 	sock = chan->cch_sock;
 	if (chan->cch_pd != -1)
 		close(chan->cch_pd);
+	if (chan->cch_ring != NULL)
+		cap_shring_detach(chan->cch_ring);
 	if (flags != NULL)
 		*flags = chan->cch_flags;
 	chan->cch_magic = 0;
@@ -213,6 +220,8 @@ cap_close(cap_channel_t *chan)
 	chan->cch_magic = 0;
 	if (chan->cch_pd != -1)
 		close(chan->cch_pd);
+	if (chan->cch_ring != NULL)
+		cap_shring_detach(chan->cch_ring);
 	close(chan->cch_sock);
 	free(chan);
 }
@@ -297,6 +306,82 @@ cap_recv_nvlist(const cap_channel_t *chan)
 	    channel_nvlist_flags(chan)));
 }
 
+/*
+ * Exchange a request for a response through the shared-memory slot.
+ * The packed request is copied into the slot and the service's
+ * doorbell is rung; requests and responses too large for the slot
+ * travel over the socket, announced by CAP_SHRING_SOCKFALLBACK.
+ * As with nvlist_xfer(), the request nvlist is always consumed.
+ */
+static nvlist_t *
+cap_xfer_nvlist_ring(const cap_channel_t *chan, nvlist_t *nvl)
+{
+	const struct timespec utimeout = { .tv_sec = 1, .tv_nsec = 0 };
+	struct cap_shring *sr;
+	struct cap_shring_hdr *hdr;
+	nvlist_t *ret;
+	void *packed;
+	size_t size;
+	ssize_t n;
+	char peek;
+
+	sr = chan->cch_ring;
+	hdr = sr->sr_hdr;
+	assert(cap_shring_state(sr) == CAP_SHRING_IDLE);
+
+	packed = nvlist_pack(nvl, &size);
+	if (packed == NULL) {
+		nvlist_destroy(nvl);
+		return (NULL);
+	}
+	if (size <= CAP_SHRING_BUFSIZE) {
+		memcpy(sr->sr_buf, packed, size);
+		hdr->csh_size = size;
+		free(packed);
+		packed = NULL;
+	} else {
+		hdr->csh_size = CAP_SHRING_SOCKFALLBACK;
+	}
+	cap_shring_post(sr, CAP_SHRING_REQ);
+	if (packed != NULL) {
+		free(packed);
+		if (nvlist_send(chan->cch_sock, nvl) == -1) {
+			nvlist_destroy(nvl);
+			return (NULL);
+		}
+	}
+	nvlist_destroy(nvl);
+
+	for (;;) {
+		if (cap_shring_wait(sr, CAP_SHRING_REQ, &utimeout) == 0)
+			break;
+		if (errno != ETIMEDOUT)
+			return (NULL);
+		/*
+		 * The service did not respond within the timeout; find
+		 * out whether it is still there.  An EOF on the socket
+		 * means it exited.
+		 */
+		n = recv(chan->cch_sock, &peek, sizeof(peek),
+		    MSG_PEEK | MSG_DONTWAIT);
+		if (n == 0 || (n == -1 && errno != EAGAIN)) {
+			errno = ENOTCONN;
+			return (NULL);
+		}
+	}
+
+	if (hdr->csh_size == CAP_SHRING_SOCKFALLBACK) {
+		ret = nvlist_recv(chan->cch_sock,
+		    channel_nvlist_flags(chan));
+	} else {
+		ret = nvlist_unpack(sr->sr_buf, hdr->csh_size,
+		    channel_nvlist_flags(chan));
+	}
+	/* Return the slot to the client-owned state; no doorbell needed. */
+	cap_shring_post(sr, CAP_SHRING_IDLE);
+	return (ret);
+}
+
 nvlist_t *
 cap_xfer_nvlist(const cap_channel_t *chan, nvlist_t *nvl)
 {
@@ -304,10 +389,59 @@ cap_xfer_nvlist(const cap_channel_t *chan, nvlist_t *nvl)
 	assert(chan != NULL);
 	assert(chan->cch_magic == CAP_CHANNEL_MAGIC);
 
+	if (chan->cch_ring != NULL)
+		return (cap_xfer_nvlist_ring(chan, nvl));
 	return (nvlist_xfer(chan->cch_sock, nvl,
 	    channel_nvlist_flags(chan)));
 }
 
+int
+cap_ring_enable(cap_channel_t *chan)
+{
+	struct cap_shring *sr;
+	nvlist_t *nvl;
+	int error, fd, serrno;
+
+	assert(chan != NULL);
+	assert(chan->cch_magic == CAP_CHANNEL_MAGIC);
+
+	if (chan->cch_ring != NULL)
+		return (0);
+
+	fd = cap_shring_create();
+	if (fd == -1)
+		return (-1);
+	sr = cap_shring_attach(fd);
+	if (sr == NULL) {
+		serrno = errno;
+		close(fd);
+		errno = serrno;
+		return (-1);
+	}
+	sr->sr_hdr->csh_state = CAP_SHRING_IDLE;
+	sr->sr_hdr->csh_size = 0;
+
+	nvl = nvlist_create(channel_nvlist_flags(chan));
+	nvlist_add_string(nvl, "cmd", "ring_enable");
+	nvlist_move_descriptor(nvl, "ringfd", fd);
+	nvl = cap_xfer_nvlist(chan, nvl);
+	if (nvl == NULL) {
+		serrno = errno;
+		cap_shring_detach(sr);
+		errno = serrno;
+		return (-1);
+	}
+	error = (int)nvlist_get_number(nvl, "error");
+	nvlist_destroy(nvl);
+	if (error != 0) {
+		cap_shring_detach(sr);
+		errno = error;
+		return (-1);
+	}
+	chan->cch_ring = sr;
+	return (0);
+}
+
 cap_channel_t *
 cap_service_open(const cap_channel_t *chan, const char *name)
 {
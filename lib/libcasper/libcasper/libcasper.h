@@ -281,6 +281,18 @@ cap_xfer_nvlist(const cap_channel_t *chan, nvlist_t *nvl)
 }
 #endif
 
+/*
+ * The function switches the given capability to a shared-memory exchange
+ * channel, avoiding the socket syscalls and copies on every request.
+ * A channel in this mode cannot be cloned and must not be used with
+ * cap_send_nvlist()/cap_recv_nvlist() directly.
+ */
+#ifdef WITH_CASPER
+int	cap_ring_enable(cap_channel_t *chan);
+#else
+#define	cap_ring_enable(chan)	(0)
+#endif
+
 __END_DECLS
 
 #endif	/* !_LIBCASPER_H_ */
@@ -49,10 +49,12 @@ __FBSDID("$FreeBSD$");
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "libcasper.h"
 #include "libcasper_impl.h"
+#include "shring.h"
 
 /*
  * Currently there is only one service_connection per service.
@@ -74,6 +76,8 @@ struct service_connection {
 	int		 sc_magic;
 	cap_channel_t	*sc_chan;
 	nvlist_t	*sc_limits;
+	/* Shared-memory exchange channel, if the client enabled one. */
+	struct cap_shring *sc_ring;
 	TAILQ_ENTRY(service_connection) sc_next;
 };
 
@@ -156,6 +160,7 @@ service_connection_add(struct service *service, int sock,
 			return (NULL);
 		}
 	}
+	sconn->sc_ring = NULL;
 	sconn->sc_magic = SERVICE_CONNECTION_MAGIC;
 	TAILQ_INSERT_TAIL(&service->s_connections, sconn, sc_next);
 	return (sconn);
@@ -171,6 +176,8 @@ service_connection_remove(struct service *service,
 
 	TAILQ_REMOVE(&service->s_connections, sconn, sc_next);
 	sconn->sc_magic = 0;
+	if (sconn->sc_ring != NULL)
+		cap_shring_detach(sconn->sc_ring);
 	nvlist_destroy(sconn->sc_limits);
 	cap_close(sconn->sc_chan);
 	free(sconn);
@@ -262,10 +269,18 @@ service_connection_set_limits(struct service_connection *sconn,
 	sconn->sc_limits = limits;
 }
 
-void
-service_message(struct service *service, struct service_connection *sconn)
+/*
+ * Process a single request and prepare the response nvlist with the
+ * "error" field set.  Consumes nvlin.  The "clone" and "ring_enable"
+ * commands are refused on a shared-memory channel: the former because
+ * the ring loop can serve only a sole connection, the latter because
+ * the channel already has a ring.
+ */
+static nvlist_t *
+service_process_message(struct service *service,
+    struct service_connection *sconn, nvlist_t *nvlin, bool onring)
 {
-	nvlist_t *nvlin, *nvlout;
+	nvlist_t *nvlout;
 	const char *cmd;
 	int error, flags;
 
@@ -273,12 +288,6 @@ service_message(struct service *service, struct service_connection *sconn)
 	if ((service->s_flags & CASPER_SERVICE_NO_UNIQ_LIMITS) != 0)
 		flags = NV_FLAG_NO_UNIQUE;
 
-	nvlin = cap_recv_nvlist(service_connection_get_chan(sconn));
-	if (nvlin == NULL) {
-		service_connection_remove(service, sconn);
-		return;
-	}
-
 	error = EDOOFUS;
 	nvlout = nvlist_create(flags);
 
@@ -311,12 +320,33 @@ service_message(struct service *service, struct service_connection *sconn)
 	} else if (strcmp(cmd, "clone") == 0) {
 		int sock;
 
-		sock = service_connection_clone(service, sconn);
-		if (sock == -1) {
-			error = errno;
+		if (onring) {
+			error = EOPNOTSUPP;
+		} else {
+			sock = service_connection_clone(service, sconn);
+			if (sock == -1) {
+				error = errno;
+			} else {
+				nvlist_move_descriptor(nvlout, "sock", sock);
+				error = 0;
+			}
+		}
+	} else if (strcmp(cmd, "ring_enable") == 0) {
+		int fd;
+
+		if (onring || !nvlist_exists_descriptor(nvlin, "ringfd")) {
+			error = EINVAL;
+		} else if (sconn->sc_ring != NULL) {
+			error = EEXIST;
+		} else if (service_connection_first(service) != sconn ||
+		    service_connection_next(sconn) != NULL) {
+			/* Only a sole connection may switch to ring mode. */
+			error = EBUSY;
 		} else {
-			nvlist_move_descriptor(nvlout, "sock", sock);
-			error = 0;
+			fd = nvlist_take_descriptor(nvlin, "ringfd");
+			sconn->sc_ring = cap_shring_attach(fd);
+			error = sconn->sc_ring == NULL ? errno : 0;
+			close(fd);
 		}
 	} else {
 		error = service->s_command(cmd,
@@ -326,12 +356,109 @@ service_message(struct service *service, struct service_connection *sconn)
 	nvlist_destroy(nvlin);
 	nvlist_add_number(nvlout, "error", (uint64_t)error);
 
+	return (nvlout);
+}
+
+void
+service_message(struct service *service, struct service_connection *sconn)
+{
+	nvlist_t *nvlin, *nvlout;
+
+	nvlin = cap_recv_nvlist(service_connection_get_chan(sconn));
+	if (nvlin == NULL) {
+		service_connection_remove(service, sconn);
+		return;
+	}
+
+	nvlout = service_process_message(service, sconn, nvlin, false);
+
 	if (cap_send_nvlist(service_connection_get_chan(sconn), nvlout) == -1)
 		service_connection_remove(service, sconn);
 
 	nvlist_destroy(nvlout);
 }
 
+/*
+ * Serve the sole connection through its shared-memory channel: wait on
+ * the doorbell for a request, process it and post the response into
+ * the slot, falling back to the socket for oversized nvlists.  The
+ * socket is polled on every doorbell timeout so that a client exit is
+ * still noticed.  Returns after removing the connection.
+ */
+static void
+service_ring_serve(struct service *service, struct service_connection *sconn)
+{
+	const struct timespec utimeout = { .tv_sec = 1, .tv_nsec = 0 };
+	struct cap_shring *sr;
+	struct cap_shring_hdr *hdr;
+	nvlist_t *nvlin, *nvlout;
+	void *packed;
+	size_t size;
+	ssize_t n;
+	char peek;
+	bool fallback;
+	int flags, sock;
+
+	sr = sconn->sc_ring;
+	hdr = sr->sr_hdr;
+	sock = service_connection_get_sock(sconn);
+	flags = service_get_channel_flags(service);
+
+	for (;;) {
+		while (cap_shring_state(sr) != CAP_SHRING_REQ) {
+			if (cap_shring_wait(sr, cap_shring_state(sr),
+			    &utimeout) == 0)
+				continue;
+			if (errno != ETIMEDOUT)
+				goto drop;
+			n = recv(sock, &peek, sizeof(peek),
+			    MSG_PEEK | MSG_DONTWAIT);
+			if (n == 0 || (n == -1 && errno != EAGAIN))
+				goto drop;
+		}
+
+		if (hdr->csh_size == CAP_SHRING_SOCKFALLBACK) {
+			nvlin = nvlist_recv(sock, flags);
+		} else {
+			nvlin = nvlist_unpack(sr->sr_buf, hdr->csh_size,
+			    flags);
+		}
+		if (nvlin == NULL)
+			goto drop;
+
+		nvlout = service_process_message(service, sconn, nvlin, true);
+
+		packed = nvlist_pack(nvlout, &size);
+		if (packed == NULL) {
+			nvlist_destroy(nvlout);
+			goto drop;
+		}
+		fallback = size > CAP_SHRING_BUFSIZE;
+		if (fallback) {
+			/*
+			 * Queue the response on the socket before the
+			 * doorbell is rung, so the client never sees
+			 * the fallback announcement without data
+			 * behind it.
+			 */
+			hdr->csh_size = CAP_SHRING_SOCKFALLBACK;
+			if (nvlist_send(sock, nvlout) == -1) {
+				free(packed);
+				nvlist_destroy(nvlout);
+				goto drop;
+			}
+		} else {
+			memcpy(sr->sr_buf, packed, size);
+			hdr->csh_size = size;
+		}
+		free(packed);
+		nvlist_destroy(nvlout);
+		cap_shring_post(sr, CAP_SHRING_RESP);
+	}
+drop:
+	service_connection_remove(service, sconn);
+}
+
 static int
 fd_add(fd_set *fdsp, int maxfd, int fd)
 {
@@ -430,6 +557,20 @@ service_start(struct service *service, int sock, int procfd)
 		_exit(1);
 
 	for (;;) {
+		/*
+		 * A sole connection that switched to a shared-memory
+		 * channel is served by the doorbell loop; it returns
+		 * once the connection is gone.
+		 */
+		sconn = service_connection_first(service);
+		if (sconn != NULL && sconn->sc_ring != NULL &&
+		    service_connection_next(sconn) == NULL) {
+			service_ring_serve(service, sconn);
+			if (service_connection_first(service) == NULL)
+				break;
+			continue;
+		}
+
 		FD_ZERO(&fds);
 		maxfd = -1;
 		for (sconn = service_connection_first(service); sconn != NULL;
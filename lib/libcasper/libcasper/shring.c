@@ -0,0 +1,147 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/umtx.h>
+
+#include <machine/atomic.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "shring.h"
+
+/*
+ * How many times to re-read the state word before going to sleep in
+ * the kernel.  Under load the peer responds within the spin window and
+ * both the sleep and the wakeup syscalls are avoided.
+ */
+#define	CAP_SHRING_SPINS	1024
+
+int
+cap_shring_create(void)
+{
+	int fd, serrno;
+
+	fd = shm_open(SHM_ANON, O_RDWR, 0);
+	if (fd == -1)
+		return (-1);
+	if (ftruncate(fd, CAP_SHRING_MAPSIZE) == -1) {
+		serrno = errno;
+		close(fd);
+		errno = serrno;
+		return (-1);
+	}
+	return (fd);
+}
+
+struct cap_shring *
+cap_shring_attach(int fd)
+{
+	struct cap_shring *sr;
+	void *mem;
+	int serrno;
+
+	sr = malloc(sizeof(*sr));
+	if (sr == NULL)
+		return (NULL);
+	mem = mmap(NULL, CAP_SHRING_MAPSIZE, PROT_READ | PROT_WRITE,
+	    MAP_SHARED, fd, 0);
+	if (mem == MAP_FAILED) {
+		serrno = errno;
+		free(sr);
+		errno = serrno;
+		return (NULL);
+	}
+	sr->sr_hdr = mem;
+	sr->sr_buf = (uint8_t *)mem + sizeof(struct cap_shring_hdr);
+	return (sr);
+}
+
+void
+cap_shring_detach(struct cap_shring *sr)
+{
+
+	(void)munmap(sr->sr_hdr, CAP_SHRING_MAPSIZE);
+	free(sr);
+}
+
+uint32_t
+cap_shring_state(const struct cap_shring *sr)
+{
+
+	return (atomic_load_acq_32(&sr->sr_hdr->csh_state));
+}
+
+/*
+ * Publish the message in the slot by changing the state word and ring
+ * the peer's doorbell.
+ */
+void
+cap_shring_post(struct cap_shring *sr, uint32_t state)
+{
+
+	atomic_store_rel_32(&sr->sr_hdr->csh_state, state);
+	(void)_umtx_op(&sr->sr_hdr->csh_state, UMTX_OP_WAKE, 1, NULL, NULL);
+}
+
+/*
+ * Wait until the state word changes away from the given value.  Spin
+ * briefly first, then sleep on the word.  Returns 0 when the state
+ * changed and -1 with errno set to ETIMEDOUT when the (optional)
+ * timeout expired, so the caller can run its liveness checks.
+ */
+int
+cap_shring_wait(struct cap_shring *sr, uint32_t state,
+    const struct timespec *timeout)
+{
+	u_int i;
+
+	for (i = 0; i < CAP_SHRING_SPINS; i++) {
+		if (cap_shring_state(sr) != state)
+			return (0);
+	}
+	while (cap_shring_state(sr) == state) {
+		if (_umtx_op(&sr->sr_hdr->csh_state, UMTX_OP_WAIT_UINT,
+		    state, NULL, __DECONST(void *, timeout)) == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno == ETIMEDOUT &&
+			    cap_shring_state(sr) != state)
+				break;
+			return (-1);
+		}
+	}
+	return (0);
+}
@@ -0,0 +1,77 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $FreeBSD$
+ */
+
+#ifndef	_SHRING_H_
+#define	_SHRING_H_
+
+#include <stdint.h>
+
+/*
+ * Shared-memory exchange channel between a casper client and its
+ * service process.  The casper protocol is strictly request/response
+ * per channel, so a single message slot suffices: the packed nvlist is
+ * copied into the shared buffer and ownership is passed back and forth
+ * through the csh_state word, which doubles as a umtx doorbell.
+ * Messages that do not fit in the buffer travel over the channel
+ * socket instead, announced by a CAP_SHRING_SOCKFALLBACK size.
+ */
+
+#define	CAP_SHRING_MAPSIZE	(128 * 1024)
+#define	CAP_SHRING_BUFSIZE	\
+	(CAP_SHRING_MAPSIZE - sizeof(struct cap_shring_hdr))
+
+/* csh_state values. */
+#define	CAP_SHRING_IDLE		0	/* client owns the slot, no message */
+#define	CAP_SHRING_REQ		1	/* request ready, service owns slot */
+#define	CAP_SHRING_RESP		2	/* response ready, client owns slot */
+
+/* csh_size value announcing that the payload is on the socket. */
+#define	CAP_SHRING_SOCKFALLBACK	UINT32_MAX
+
+struct cap_shring_hdr {
+	uint32_t	csh_state;
+	uint32_t	csh_size;
+};
+
+struct cap_shring {
+	struct cap_shring_hdr	*sr_hdr;
+	uint8_t			*sr_buf;
+};
+
+struct timespec;
+
+int	 cap_shring_create(void);
+struct cap_shring	*cap_shring_attach(int fd);
+void	 cap_shring_detach(struct cap_shring *sr);
+uint32_t cap_shring_state(const struct cap_shring *sr);
+void	 cap_shring_post(struct cap_shring *sr, uint32_t state);
+int	 cap_shring_wait(struct cap_shring *sr, uint32_t state,
+	    const struct timespec *timeout);
+
+#endif	/* !_SHRING_H_ */
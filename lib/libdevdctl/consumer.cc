@@ -50,6 +50,8 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 #include "guid.h"
 #include "event.h"
@@ -68,6 +70,53 @@ using std::string;
 namespace DevdCtl
 {
 
+/*============================ Static Functions ==============================*/
+/**
+ * \brief Locate the value of a key within a raw devd notify record.
+ *
+ * \param buf     The raw event record.
+ * \param len     The length of the record in bytes.
+ * \param key     The key to search for, without the trailing '='.
+ * \param val     On success, set to the first byte of the value.
+ * \param valLen  On success, set to the length of the value.
+ *
+ * \return  True if the key was found.  Otherwise false.
+ */
+static bool
+FindEventValue(const char *buf, size_t len, const char *key,
+	       const char **val, size_t *valLen)
+{
+	size_t keyLen(strlen(key));
+	const char *cur(buf);
+	const char *end(buf + len);
+
+	/* Skip the message type character. */
+	if (cur != end)
+		cur++;
+	while (cur != end) {
+		/* Skip any leading whitespace. */
+		while (cur != end && (*cur == ' ' || *cur == '\t'))
+			cur++;
+		if (cur == end)
+			break;
+
+		const char *tokenEnd(cur);
+		while (tokenEnd != end && *tokenEnd != ' '
+		    && *tokenEnd != '\t' && *tokenEnd != '\n')
+			tokenEnd++;
+
+		if ((size_t)(tokenEnd - cur) > keyLen
+		 && memcmp(cur, key, keyLen) == 0
+		 && cur[keyLen] == '=') {
+			*val = cur + keyLen + 1;
+			*valLen = tokenEnd - *val;
+			return (true);
+		}
+		cur = tokenEnd;
+	}
+	return (false);
+}
+
 /*============================= Class Definitions ============================*/
 /*----------------------------- DevdCtl::Consumer ----------------------------*/
 //- Consumer Static Private Data -----------------------------------------------
@@ -79,7 +128,9 @@ Consumer::Consumer(Event::BuildMethod *defBuilder,
 		   size_t numEntries)
  : m_devdSockFD(-1),
    m_eventFactory(defBuilder),
-   m_replayingEvents(false)
+   m_replayingEvents(false),
+   m_eventRingHead(0),
+   m_eventRingValid(0)
 {
 	m_eventFactory.UpdateRegistry(regEntries, numEntries);
 }
@@ -132,21 +183,120 @@ Consumer::DisconnectFromDevd()
 		close(m_devdSockFD);
 	}
 	m_devdSockFD = -1;
+
+	/* Drop any read-ahead records from the stale connection. */
+	m_eventRingHead = 0;
+	m_eventRingValid = 0;
+}
+
+size_t
+Consumer::FillEventRing()
+{
+	struct mmsghdr msgs[EVENT_RING_SIZE];
+	struct iovec iovs[EVENT_RING_SIZE];
+	int nread;
+
+	memset(msgs, 0, sizeof(msgs));
+	for (size_t i = 0; i < EVENT_RING_SIZE; i++) {
+		iovs[i].iov_base = m_eventRing[i];
+		iovs[i].iov_len  = MAX_EVENT_SIZE;
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	nread = ::recvmmsg(m_devdSockFD, msgs, EVENT_RING_SIZE,
+			   MSG_DONTWAIT, NULL);
+	if (nread <= 0)
+		return (0);
+
+	for (int i = 0; i < nread; i++) {
+		m_eventRingLen[i] = msgs[i].msg_len;
+
+		/* NULL-terminate the record */
+		m_eventRing[i][m_eventRingLen[i]] = '\0';
+	}
+	m_eventRingHead = 0;
+	m_eventRingValid = nread;
+	return (nread);
+}
+
+void
+Consumer::AddEventFilter(const string &system, const string &subsystem)
+{
+	m_eventFilters.insert(std::make_pair(system, subsystem));
+}
+
+void
+Consumer::ClearEventFilters()
+{
+	m_eventFilters.clear();
+}
+
+bool
+Consumer::EventPassesFilters(const char *buf, size_t len) const
+{
+	const char *system;
+	const char *subsystem(NULL);
+	size_t	    systemLen;
+	size_t	    subsystemLen(0);
+	bool	    haveSubsystem(false);
+
+	if (m_eventFilters.empty())
+		return (true);
+
+	/*
+	 * Only notify events carry system and subsystem keys.  Pass
+	 * anything else so that filters never hide attach, detach, or
+	 * nomatch traffic.
+	 */
+	if (len == 0 || buf[0] != Event::NOTIFY)
+		return (true);
+	if (!FindEventValue(buf, len, "system", &system, &systemLen))
+		return (true);
+
+	for (std::multimap<string, string>::const_iterator
+	     filter(m_eventFilters.begin());
+	     filter != m_eventFilters.end(); filter++) {
+		if (filter->first.length() != systemLen
+		 || memcmp(filter->first.data(), system, systemLen) != 0)
+			continue;
+		if (filter->second.empty())
+			return (true);
+		if (!haveSubsystem) {
+			haveSubsystem = true;
+			if (!FindEventValue(buf, len, "subsystem",
+					    &subsystem, &subsystemLen))
+				subsystem = NULL;
+		}
+		if (subsystem != NULL
+		 && filter->second.length() == subsystemLen
+		 && memcmp(filter->second.data(), subsystem,
+			   subsystemLen) == 0)
+			return (true);
+	}
+	return (false);
 }
 
 std::string
 Consumer::ReadEvent()
 {
-	char buf[MAX_EVENT_SIZE + 1];
-	ssize_t len;
-
-	len = ::recv(m_devdSockFD, buf, MAX_EVENT_SIZE, MSG_WAITALL);
-	if (len == -1)
-		return (std::string(""));
-	else {
-		/* NULL-terminate the result */
-		buf[len] = '\0';
-		return (std::string(buf));
+	/*
+	 * Serve read-ahead records first, refilling the ring with a
+	 * single multi-record read whenever it runs dry.  Records
+	 * rejected by the event filters are skipped in place, without
+	 * ever being copied out of the ring.
+	 */
+	for (;;) {
+		if (m_eventRingValid == 0 && FillEventRing() == 0)
+			return (std::string(""));
+
+		size_t slot(m_eventRingHead);
+		m_eventRingHead++;
+		m_eventRingValid--;
+		if (EventPassesFilters(m_eventRing[slot],
+				       m_eventRingLen[slot]))
+			return (std::string(m_eventRing[slot],
+					    m_eventRingLen[slot]));
 	}
 }
 
@@ -232,6 +382,9 @@ Consumer::EventsPending()
 	struct pollfd fds[1];
 	int	      result;
 
+	if (m_eventRingValid != 0)
+		return (true);
+
 	do {
 		fds->fd      = m_devdSockFD;
 		fds->events  = POLLIN;
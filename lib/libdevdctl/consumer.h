@@ -110,6 +110,29 @@ public:
 	 */
 	void DisconnectFromDevd();
 
+	/**
+	 * \brief Restrict the events returned by NextEvent() to those
+	 *        matching the given system and subsystem.
+	 *
+	 * \param system     The value of the system key to accept.
+	 * \param subsystem  The value of the subsystem key to accept.
+	 *                   An empty string accepts any subsystem of
+	 *                   the given system.
+	 *
+	 * Filters accumulate: an event is passed if it matches any
+	 * registered filter.  With no filters registered, all events
+	 * are passed.  Filtering is applied to the raw record before
+	 * an Event object is constructed, so uninteresting traffic is
+	 * dropped without any allocation or key/value parsing.  Only
+	 * notify events carry system and subsystem keys; attach,
+	 * detach, and nomatch events always pass.
+	 */
+	void AddEventFilter(const std::string &system,
+			    const std::string &subsystem = "");
+
+	/** Remove all event filters installed by AddEventFilter(). */
+	void ClearEventFilters();
+
 	EventFactory GetFactory();
 
 protected:
@@ -122,11 +145,40 @@ protected:
 	 */
 	std::string ReadEvent();
 
+	/**
+	 * \brief Refill m_eventRing with a single recvmmsg(2) call.
+	 *
+	 * Drains up to EVENT_RING_SIZE records from the non-blocking
+	 * devd socket in one system call, amortizing syscall overhead
+	 * across an entire burst of events.
+	 *
+	 * \return  The number of records read.  Zero if no data was
+	 *          pending.
+	 */
+	size_t FillEventRing();
+
+	/**
+	 * \brief Test a raw event record against the installed filters.
+	 *
+	 * \param buf  The raw devd event record.
+	 * \param len  The length of the record in bytes.
+	 *
+	 * \return  True if the record should be surfaced to the client.
+	 *          Otherwise false.
+	 */
+	bool EventPassesFilters(const char *buf, size_t len) const;
+
 	enum {
 		/*
 		 * The maximum event size supported by libdevdctl.
 		 */
 		MAX_EVENT_SIZE = 8192,
+
+		/*
+		 * The number of event records that can be read from
+		 * the devd socket with a single system call.
+		 */
+		EVENT_RING_SIZE = 16,
 	};
 
 	static const char  s_devdSockPath[];
@@ -142,6 +194,29 @@ protected:
 	/** Queued events for replay. */
 	EventList	   m_unconsumedEvents;
 
+	/**
+	 * Ring of event records read ahead from the devd socket but
+	 * not yet returned by ReadEvent().  The backing buffers are
+	 * allocated once and reused for every refill.
+	 */
+	char		   m_eventRing[EVENT_RING_SIZE][MAX_EVENT_SIZE + 1];
+
+	/** Lengths of the records currently held in m_eventRing. */
+	size_t		   m_eventRingLen[EVENT_RING_SIZE];
+
+	/** Index of the next unconsumed record in m_eventRing. */
+	size_t		   m_eventRingHead;
+
+	/** Number of unconsumed records in m_eventRing. */
+	size_t		   m_eventRingValid;
+
+	/**
+	 * Accepted (system, subsystem) pairs installed via
+	 * AddEventFilter().  An empty subsystem matches any subsystem.
+	 * When empty, all events are accepted.
+	 */
+	std::multimap<std::string, std::string> m_eventFilters;
+
 	/**                                                             
 	 * Flag controlling whether events can be queued.  This boolean
 	 * is set during event replay to ensure that previosuly deferred
@@ -57,6 +57,9 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <tuple>
+#include <utility>
 
 #include "guid.h"
 #include "event.h"
@@ -361,7 +364,7 @@ Event::ParseEventString(Event::Type type,
 			throw ParseException(ParseException::INVALID_FORMAT,
 					     eventString, start);
 
-		nvpairs["device-name"] = eventString.substr(start, end - start);
+		nvpairs["device-name"].assign(eventString, start, end - start);
 
 		start = eventString.find(" on ", end);
 		if (end == string::npos)
@@ -369,7 +372,7 @@ Event::ParseEventString(Event::Type type,
 					     eventString, start);
 		start += 4;
 		end = eventString.find_first_of(" \t\n", start);
-		nvpairs["parent"] = eventString.substr(start, end);
+		nvpairs["parent"].assign(eventString, start, end);
 		break;
 	case NOTIFY:
 		break;
@@ -381,41 +384,50 @@ Event::ParseEventString(Event::Type type,
 				     eventString);
 	}
 
-	/* Process common "key=value" format. */
+	/*
+	 * Process common "key=value" format.
+	 *
+	 * The event string is tokenized in a single forward pass and the
+	 * key and value strings are constructed in place within the map,
+	 * avoiding the temporary copies and backwards rescans of the
+	 * previous implementation.  At storm rates the per-pair
+	 * allocations dominate event intake, so this path is kept free
+	 * of intermediate strings.
+	 */
 	for (start = 1; start < eventString.length(); start = end + 1) {
+		size_t eq;
 
-		/* Find the '=' in the middle of the key/value pair. */
-		end = eventString.find('=', start);
-		if (end == string::npos)
-			break;
-
-		/*
-		 * Find the start of the key by backing up until
-		 * we hit whitespace or '!' (event type "notice").
-		 * Due to the devdctl format, all key/value pair must
-		 * start with one of these two characters.
-		 */
-		start = eventString.find_last_of("! \t\n", end);
+		/* Find the bounds of the next whitespace separated token. */
+		start = eventString.find_first_not_of(" \t\n", start);
 		if (start == string::npos)
-			throw ParseException(ParseException::INVALID_FORMAT,
-					     eventString, end);
-		start++;
-		string key(eventString.substr(start, end - start));
+			break;
+		end = eventString.find_first_of(" \t\n", start);
+		if (end == string::npos)
+			end = eventString.length();
 
 		/*
-		 * Walk forward from the '=' until either we exhaust
-		 * the buffer or we hit whitespace.
+		 * Tokens without an '=' (e.g. the "at" and "on" markers
+		 * in attach/detach events) carry no key/value data.
 		 */
-		start = end + 1;
-		if (start >= eventString.length())
+		eq = eventString.find('=', start);
+		if (eq == string::npos)
+			break;
+		if (eq >= end)
+			continue;
+		if (eq + 1 >= eventString.length())
 			throw ParseException(ParseException::INVALID_FORMAT,
-					     eventString, end);
-		end = eventString.find_first_of(" \t\n", start);
-		if (end == string::npos)
-			end = eventString.length() - 1;
-		string value(eventString.substr(start, end - start));
-
-		nvpairs[key] = value;
+					     eventString, eq);
+
+		std::pair<NVPairMap::iterator, bool> inserted(
+		    nvpairs.emplace(std::piecewise_construct,
+			std::forward_as_tuple(eventString, start, eq - start),
+			std::forward_as_tuple(eventString, eq + 1,
+			    end - eq - 1)));
+		if (!inserted.second) {
+			/* Duplicate keys retain their last value. */
+			inserted.first->second.assign(eventString, eq + 1,
+			    end - eq - 1);
+		}
 	}
 }
 
@@ -39,6 +39,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include "guid.h"
 #include "event.h"
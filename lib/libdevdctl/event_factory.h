@@ -57,8 +57,18 @@ public:
 	 */
 	typedef std::pair<Event::Type, std::string> Key;
 
+	/** Hash functor for Registry keys. */
+	struct KeyHash
+	{
+		size_t operator()(const Key &key) const
+		{
+			return (std::hash<std::string>()(key.second)
+			      ^ (static_cast<size_t>(key.first) * 0x9e3779b9U));
+		}
+	};
+
 	/** Map type for Factory method lookups. */
-	typedef std::map<Key, Event::BuildMethod *> Registry;
+	typedef std::unordered_map<Key, Event::BuildMethod *, KeyHash> Registry;
 
 	/** Table record of factory methods to add to our registry. */
 	struct Record
@@ -78,7 +88,7 @@ public:
 
 
 protected:
-	/** Registry of event factory methods providing O(log(n)) lookup. */
+	/** Registry of event factory methods providing O(1) lookup. */
 	Registry	    m_registry;
 
 	Event::BuildMethod *m_defaultBuildMethod;
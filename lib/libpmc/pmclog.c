@@ -306,18 +306,36 @@ pmclog_get_event(void *cookie, char **data, ssize_t *len,
 			/ sizeof(uintfptr_t);				\
 	} while (0);
 
+#define	PMCLOG_GET_CALLCHAIN_AGG_SIZE(SZ,E) do {			\
+		(SZ) = ((E) - offsetof(struct pmclog_callchain_agg,	\
+			pl_pc)) / sizeof(uintfptr_t);			\
+	} while (0);
+
 	switch (ev->pl_type = PMCLOG_HEADER_TO_TYPE(h)) {
 	case PMCLOG_TYPE_CALLCHAIN:
 		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_pid);
 		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_tid);
 		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_pmcid);
 		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_cpuflags);
+		ev->pl_u.pl_cc.pl_count = 1;
 		PMCLOG_GET_CALLCHAIN_SIZE(ev->pl_u.pl_cc.pl_npc,evlen);
 		for (npc = 0; npc < ev->pl_u.pl_cc.pl_npc; npc++)
 			PMCLOG_READADDR(le,ev->pl_u.pl_cc.pl_pc[npc]);
 		for (;npc < PMC_CALLCHAIN_DEPTH_MAX; npc++)
 			ev->pl_u.pl_cc.pl_pc[npc] = (uintfptr_t) 0;
 		break;
+	case PMCLOG_TYPE_CALLCHAIN_AGG:
+		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_pid);
+		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_tid);
+		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_pmcid);
+		PMCLOG_READ32(le,ev->pl_u.pl_cc.pl_cpuflags);
+		PMCLOG_READ64(le,ev->pl_u.pl_cc.pl_count);
+		PMCLOG_GET_CALLCHAIN_AGG_SIZE(ev->pl_u.pl_cc.pl_npc,evlen);
+		for (npc = 0; npc < ev->pl_u.pl_cc.pl_npc; npc++)
+			PMCLOG_READADDR(le,ev->pl_u.pl_cc.pl_pc[npc]);
+		for (;npc < PMC_CALLCHAIN_DEPTH_MAX; npc++)
+			ev->pl_u.pl_cc.pl_pc[npc] = (uintfptr_t) 0;
+		break;
 	case PMCLOG_TYPE_CLOSELOG:
 		ev->pl_state = PMCLOG_EOF;
 		return (-1);
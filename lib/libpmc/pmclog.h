@@ -52,6 +52,7 @@ struct pmclog_ev_callchain {
 	uint32_t	pl_cpuflags;
 	uint32_t	pl_cpuflags2;
 	uint32_t	pl_npc;
+	uint64_t	pl_count;	/* samples folded in, 1 if unaggregated */
 	uintfptr_t	pl_pc[PMC_CALLCHAIN_DEPTH_MAX];
 };
 
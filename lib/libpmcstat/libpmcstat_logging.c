@@ -195,6 +195,7 @@ pmcstat_analyze_log(struct pmcstat_args *args,
     int *ps_samples_period)
 {
 	uint32_t cpu, cpuflags;
+	uint64_t nfold;
 	pid_t pid;
 	struct pmcstat_image *image;
 	struct pmcstat_process *pp, *ppnew;
@@ -268,20 +269,27 @@ pmcstat_analyze_log(struct pmcstat_args *args,
 			break;
 
 		case PMCLOG_TYPE_CALLCHAIN:
-			pmcstat_stats->ps_samples_total++;
-			*ps_samples_period += 1;
+		case PMCLOG_TYPE_CALLCHAIN_AGG:
+			/*
+			 * The parser sets pl_count to 1 for plain call
+			 * chain records, so both record flavours weight
+			 * their samples the same way here.
+			 */
+			nfold = ev.pl_u.pl_cc.pl_count;
+			pmcstat_stats->ps_samples_total += nfold;
+			*ps_samples_period += nfold;
 
 			cpuflags = ev.pl_u.pl_cc.pl_cpuflags;
 			cpu = PMC_CALLCHAIN_CPUFLAGS_TO_CPU(cpuflags);
 
 			if ((args->pa_flags & FLAG_FILTER_THREAD_ID) &&
 				args->pa_tid != ev.pl_u.pl_cc.pl_tid) {
-				pmcstat_stats->ps_samples_skipped++;
+				pmcstat_stats->ps_samples_skipped += nfold;
 				break;
 			}
 			/* Filter on the CPU id. */
 			if (!CPU_ISSET(cpu, &(args->pa_cpumask))) {
-				pmcstat_stats->ps_samples_skipped++;
+				pmcstat_stats->ps_samples_skipped += nfold;
 				break;
 			}
 
@@ -291,25 +299,29 @@ pmcstat_analyze_log(struct pmcstat_args *args,
 			/* Get PMC record. */
 			pmcr = pmcstat_lookup_pmcid(ev.pl_u.pl_cc.pl_pmcid, pmcstat_mergepmc);
 			assert(pmcr != NULL);
-			pmcr->pr_samples++;
+			pmcr->pr_samples += nfold;
 
 			/*
-			 * Call the plugins processing
+			 * Call the plugins processing, once per folded
+			 * sample.  Folded counts are bounded by the
+			 * kernel's aggregation flush interval.
 			 */
 
-			if (plugins[args->pa_pplugin].pl_process != NULL)
-				plugins[args->pa_pplugin].pl_process(
+			for (; nfold > 0; nfold--) {
+				if (plugins[args->pa_pplugin].pl_process != NULL)
+					plugins[args->pa_pplugin].pl_process(
+					    pp, pmcr,
+					    ev.pl_u.pl_cc.pl_npc,
+					    ev.pl_u.pl_cc.pl_pc,
+					    PMC_CALLCHAIN_CPUFLAGS_TO_USERMODE(cpuflags),
+					    cpu);
+				plugins[args->pa_plugin].pl_process(
 				    pp, pmcr,
 				    ev.pl_u.pl_cc.pl_npc,
 				    ev.pl_u.pl_cc.pl_pc,
 				    PMC_CALLCHAIN_CPUFLAGS_TO_USERMODE(cpuflags),
 				    cpu);
-			plugins[args->pa_plugin].pl_process(
-			    pp, pmcr,
-			    ev.pl_u.pl_cc.pl_npc,
-			    ev.pl_u.pl_cc.pl_pc,
-			    PMC_CALLCHAIN_CPUFLAGS_TO_USERMODE(cpuflags),
-			    cpu);
+			}
 			break;
 
 		case PMCLOG_TYPE_PMCALLOCATE:
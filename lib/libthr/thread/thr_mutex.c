@@ -244,6 +244,7 @@ mutex_init_body(struct pthread_mutex *pmutex,
 	pmutex->m_flags = attr->m_type;
 	pmutex->m_count = 0;
 	pmutex->m_spinloops = 0;
+	pmutex->m_spincount = 0;
 	pmutex->m_yieldloops = 0;
 	mutex_init_link(pmutex);
 	switch (attr->m_protocol) {
@@ -649,7 +650,7 @@ mutex_lock_sleep(struct pthread *curthread, struct pthread_mutex *m,
     const struct timespec *abstime)
 {
 	uint32_t id, owner;
-	int count, ret;
+	int count, limit, ret;
 
 	id = TID(curthread);
 	if (PMUTEX_OWNER_ID(m) == id)
@@ -668,18 +669,32 @@ mutex_lock_sleep(struct pthread *curthread, struct pthread_mutex *m,
 	if (!_thr_is_smp)
 		goto yield_loop;
 
-	count = m->m_spinloops;
-	while (count--) {
+	/*
+	 * The spin window is derived from the number of iterations
+	 * previous acquisitions of this mutex needed, so that spinning
+	 * roughly tracks the observed hold time instead of always
+	 * burning the full m_spinloops budget.  The window may grow
+	 * geometrically, so mutexes held longer than the current
+	 * estimate are probed again; m_spinloops remains the ceiling.
+	 * Updates of the estimate are racy, which is harmless since it
+	 * is only a heuristic.
+	 */
+	limit = m->m_spincount * 2 + 10;
+	if (limit > m->m_spinloops)
+		limit = m->m_spinloops;
+	for (count = 0; count < limit; count++) {
 		owner = m->m_lock.m_owner;
 		if ((owner & ~UMUTEX_CONTESTED) == 0) {
 			if (atomic_cmpset_acq_32(&m->m_lock.m_owner, owner,
 			    id | owner)) {
+				m->m_spincount += (count - m->m_spincount) / 8;
 				ret = 0;
 				goto done;
 			}
 		}
 		CPU_SPINWAIT;
 	}
+	m->m_spincount += (limit - m->m_spincount) / 8;
 
 yield_loop:
 	count = m->m_yieldloops;
@@ -1110,8 +1125,11 @@ __pthread_mutex_setspinloops_np(pthread_mutex_t *mutex, int count)
 	int ret;
 
 	ret = check_and_init_mutex(mutex, &m);
-	if (ret == 0)
+	if (ret == 0) {
 		m->m_spinloops = count;
+		if (m->m_spincount > count)
+			m->m_spincount = count;
+	}
 	return (ret);
 }
 
@@ -171,6 +171,7 @@ struct pthread_mutex {
 	int				m_flags;
 	int				m_count;
 	int				m_spinloops;
+	int				m_spincount;
 	int				m_yieldloops;
 	int				m_ps;	/* pshared init stage */
 	/*
@@ -142,6 +142,7 @@ static int parse_integer(const char *);
 static void *path_enumerate(const char *, path_enum_proc, const char *, void *);
 static void print_usage(const char *argv0);
 static void release_object(Obj_Entry *);
+static void preload_reloc_pages(Obj_Entry *obj);
 static int relocate_object_dag(Obj_Entry *root, bool bind_now,
     Obj_Entry *rtldobj, int flags, RtldLockState *lockstate);
 static int relocate_object(Obj_Entry *obj, bool bind_now, Obj_Entry *rtldobj,
@@ -2953,6 +2954,10 @@ relocate_object_dag(Obj_Entry *root, bool bind_now, Obj_Entry *rtldobj,
 	Objlist_Entry *elm;
 	int error;
 
+	STAILQ_FOREACH(elm, &root->dagmembers, link) {
+		if (!elm->obj->relocated)
+			preload_reloc_pages(elm->obj);
+	}
 	error = 0;
 	STAILQ_FOREACH(elm, &root->dagmembers, link) {
 		error = relocate_object(elm->obj, bind_now, rtldobj, flags,
@@ -3053,6 +3058,30 @@ relocate_object(Obj_Entry *obj, bool bind_now, Obj_Entry *rtldobj,
 	return (0);
 }
 
+/*
+ * Hint the kernel to read ahead the pages the relocation pass is about
+ * to dirty, i.e. the writable segments holding the GOT, the jump slots
+ * and the patched data.  The faults are then serviced asynchronously
+ * while earlier objects are relocated, instead of one synchronous
+ * page-in per first touch, which dominates cold starts of programs
+ * with many shared objects.  Failure is harmless, so it is ignored.
+ */
+static void
+preload_reloc_pages(Obj_Entry *obj)
+{
+	const Elf_Phdr *ph;
+	size_t l;
+
+	for (l = obj->phsize / sizeof(*ph), ph = obj->phdr; l > 0;
+	    l--, ph++) {
+		if (ph->p_type != PT_LOAD || (ph->p_flags & PF_W) == 0)
+			continue;
+		madvise(obj->relocbase + trunc_page(ph->p_vaddr),
+		    round_page(ph->p_vaddr + ph->p_filesz) -
+		    trunc_page(ph->p_vaddr), MADV_WILLNEED);
+	}
+}
+
 /*
  * Relocate newly-loaded shared objects.  The argument is a pointer to
  * the Obj_Entry for the first such object.  All objects from the first
@@ -3066,6 +3095,11 @@ relocate_objects(Obj_Entry *first, bool bind_now, Obj_Entry *rtldobj,
 	Obj_Entry *obj;
 	int error;
 
+	for (obj = first; obj != NULL; obj = TAILQ_NEXT(obj, next)) {
+		if (obj->marker || obj->relocated)
+			continue;
+		preload_reloc_pages(obj);
+	}
 	for (error = 0, obj = first;  obj != NULL;
 	    obj = TAILQ_NEXT(obj, next)) {
 		if (obj->marker)
@@ -885,11 +885,11 @@ pfctl_print_rule_counters(struct pf_rule *rule, int opts)
 	if (opts & PF_OPT_VERBOSE) {
 		printf("  [ Evaluations: %-8llu  Packets: %-8llu  "
 			    "Bytes: %-10llu  States: %-6ju]\n",
-			    (unsigned long long)rule->evaluations,
-			    (unsigned long long)(rule->packets[0] +
-			    rule->packets[1]),
-			    (unsigned long long)(rule->bytes[0] +
-			    rule->bytes[1]), (uintmax_t)rule->u_states_cur);
+			    (unsigned long long)rule->u_evaluations,
+			    (unsigned long long)(rule->u_packets[0] +
+			    rule->u_packets[1]),
+			    (unsigned long long)(rule->u_bytes[0] +
+			    rule->u_bytes[1]), (uintmax_t)rule->u_states_cur);
 		if (!(opts & PF_OPT_DEBUG))
 			printf("  [ Inserted: uid %u pid %u "
 			    "State Creations: %-6ju]\n",
@@ -998,15 +998,15 @@ pfctl_show_rules(int dev, char *path, int opts, enum pfctl_show format,
 				printf("%s %llu %llu %llu %llu"
 				    " %llu %llu %llu %ju\n",
 				    pr.rule.label,
-				    (unsigned long long)pr.rule.evaluations,
-				    (unsigned long long)(pr.rule.packets[0] +
-				    pr.rule.packets[1]),
-				    (unsigned long long)(pr.rule.bytes[0] +
-				    pr.rule.bytes[1]),
-				    (unsigned long long)pr.rule.packets[0],
-				    (unsigned long long)pr.rule.bytes[0],
-				    (unsigned long long)pr.rule.packets[1],
-				    (unsigned long long)pr.rule.bytes[1],
+				    (unsigned long long)pr.rule.u_evaluations,
+				    (unsigned long long)(pr.rule.u_packets[0] +
+				    pr.rule.u_packets[1]),
+				    (unsigned long long)(pr.rule.u_bytes[0] +
+				    pr.rule.u_bytes[1]),
+				    (unsigned long long)pr.rule.u_packets[0],
+				    (unsigned long long)pr.rule.u_bytes[0],
+				    (unsigned long long)pr.rule.u_packets[1],
+				    (unsigned long long)pr.rule.u_bytes[1],
 				    (uintmax_t)pr.rule.u_states_tot);
 			}
 			break;
@@ -0,0 +1,572 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (C) 2002-2003 NetGroup, Politecnico di Torino (Italy)
+ * Copyright (C) 2005-2017 Jung-uk Kim <jkim@FreeBSD.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Politecnico di Torino nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+#ifdef _KERNEL
+#include "opt_bpf.h"
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/kernel.h>
+#include <sys/malloc.h>
+#include <sys/mbuf.h>
+#include <sys/socket.h>
+
+#include <net/if.h>
+
+#include <machine/cpufunc.h>
+#else
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#endif
+
+#include <sys/types.h>
+
+#include <net/bpf.h>
+#include <net/bpf_jitter.h>
+
+#include <arm64/arm64/bpf_jit_machdep.h>
+
+/*
+ * Emit routine to update the jump table.
+ */
+static void
+emit_length(bpf_bin_stream *stream, __unused u_int value, u_int len)
+{
+
+	if (stream->refs != NULL)
+		(stream->refs)[stream->bpf_pc] += len;
+	stream->cur_ip += len;
+}
+
+/*
+ * Emit routine to output the actual binary code.
+ */
+static void
+emit_code(bpf_bin_stream *stream, u_int value, __unused u_int len)
+{
+
+	/* A64 instructions are all exactly four bytes long. */
+	*((u_int *)(void *)(stream->ibuf + stream->cur_ip)) = value;
+	stream->cur_ip += 4;
+}
+
+/*
+ * Scan the filter program and find possible optimization.
+ */
+static int
+bpf_jit_optimize(struct bpf_insn *prog, u_int nins)
+{
+	int flags;
+	u_int i;
+
+	/* Do we return immediately? */
+	if (BPF_CLASS(prog[0].code) == BPF_RET)
+		return (BPF_JIT_FRET);
+
+	for (flags = 0, i = 0; i < nins; i++) {
+		switch (prog[i].code) {
+		case BPF_LD|BPF_W|BPF_ABS:
+		case BPF_LD|BPF_H|BPF_ABS:
+		case BPF_LD|BPF_B|BPF_ABS:
+		case BPF_LD|BPF_W|BPF_IND:
+		case BPF_LD|BPF_H|BPF_IND:
+		case BPF_LD|BPF_B|BPF_IND:
+		case BPF_LDX|BPF_MSH|BPF_B:
+			flags |= BPF_JIT_FPKT;
+			break;
+		case BPF_LD|BPF_MEM:
+		case BPF_LDX|BPF_MEM:
+		case BPF_ST:
+		case BPF_STX:
+			flags |= BPF_JIT_FMEM;
+			break;
+		case BPF_LD|BPF_W|BPF_LEN:
+		case BPF_LDX|BPF_W|BPF_LEN:
+			flags |= BPF_JIT_FLEN;
+			break;
+		case BPF_JMP|BPF_JA:
+		case BPF_JMP|BPF_JGT|BPF_K:
+		case BPF_JMP|BPF_JGE|BPF_K:
+		case BPF_JMP|BPF_JEQ|BPF_K:
+		case BPF_JMP|BPF_JSET|BPF_K:
+		case BPF_JMP|BPF_JGT|BPF_X:
+		case BPF_JMP|BPF_JGE|BPF_X:
+		case BPF_JMP|BPF_JEQ|BPF_X:
+		case BPF_JMP|BPF_JSET|BPF_X:
+			flags |= BPF_JIT_FJMP;
+			break;
+		}
+		if (flags == BPF_JIT_FLAG_ALL)
+			break;
+	}
+
+	return (flags);
+}
+
+/*
+ * Function that does the real stuff.
+ */
+bpf_filter_func
+bpf_jit_compile(struct bpf_insn *prog, u_int nins, size_t *size)
+{
+	bpf_bin_stream stream;
+	struct bpf_insn *ins;
+	int flags, fret, fpkt, fmem, fjmp, flen;
+	u_int i, pass;
+
+	/*
+	 * NOTE: Do not modify the name of this variable, as it's used by
+	 * the macros to emit code.
+	 */
+	emit_func emitm;
+
+	flags = bpf_jit_optimize(prog, nins);
+	fret = (flags & BPF_JIT_FRET) != 0;
+	fpkt = (flags & BPF_JIT_FPKT) != 0;
+	fmem = (flags & BPF_JIT_FMEM) != 0;
+	fjmp = (flags & BPF_JIT_FJMP) != 0;
+	flen = (flags & BPF_JIT_FLEN) != 0;
+
+	if (fret)
+		nins = 1;
+
+	memset(&stream, 0, sizeof(stream));
+
+	/* Allocate the reference table for the jumps. */
+	if (fjmp) {
+#ifdef _KERNEL
+		stream.refs = malloc((nins + 1) * sizeof(u_int), M_BPFJIT,
+		    M_NOWAIT | M_ZERO);
+#else
+		stream.refs = calloc(nins + 1, sizeof(u_int));
+#endif
+		if (stream.refs == NULL)
+			return (NULL);
+	}
+
+	/*
+	 * The first pass will emit the lengths of the instructions
+	 * to create the reference table.
+	 */
+	emitm = emit_length;
+
+	for (pass = 0; pass < 2; pass++) {
+		ins = prog;
+
+		/* Create the procedure header. */
+		if (fmem)
+			SUBSPi(BPF_JIT_MEMSIZE);
+		if (flen)
+			MOVrw(1, REG_WIRELEN);
+		if (fpkt) {
+			MOVrx(0, REG_PKT);
+			MOVrw(2, REG_BUFLEN);
+		}
+
+		for (i = 0; i < nins; i++) {
+			stream.bpf_pc++;
+
+			switch (ins->code) {
+			default:
+#ifdef _KERNEL
+				return (NULL);
+#else
+				abort();
+#endif
+
+			case BPF_RET|BPF_K:
+				MOVi(ins->k, REG_RET);
+				EPILOGUE();
+				break;
+
+			case BPF_RET|BPF_A:
+				MOVrw(REG_A, REG_RET);
+				EPILOGUE();
+				break;
+
+			case BPF_LD|BPF_W|BPF_ABS:
+				MOVi(ins->k, REG_TMP);
+				SUBSrrr(REG_TMP, REG_BUFLEN, REG_TMP2);
+				BRCOND(COND_LO, 3);
+				CMPi(sizeof(int32_t), REG_TMP2);
+				BRCOND(COND_HS, 1 + RET0LEN);
+				RET0();
+				LDRwro(REG_TMP, REG_PKT, REG_A);
+				REVw(REG_A);
+				break;
+
+			case BPF_LD|BPF_H|BPF_ABS:
+				MOVi(ins->k, REG_TMP);
+				SUBSrrr(REG_TMP, REG_BUFLEN, REG_TMP2);
+				BRCOND(COND_LO, 3);
+				CMPi(sizeof(int16_t), REG_TMP2);
+				BRCOND(COND_HS, 1 + RET0LEN);
+				RET0();
+				LDRHwro(REG_TMP, REG_PKT, REG_A);
+				REV16w(REG_A);
+				break;
+
+			case BPF_LD|BPF_B|BPF_ABS:
+				MOVi(ins->k, REG_TMP);
+				CMPrr(REG_BUFLEN, REG_TMP);
+				BRCOND(COND_LO, 1 + RET0LEN);
+				RET0();
+				LDRBwro(REG_TMP, REG_PKT, REG_A);
+				break;
+
+			case BPF_LD|BPF_W|BPF_LEN:
+				MOVrw(REG_WIRELEN, REG_A);
+				break;
+
+			case BPF_LDX|BPF_W|BPF_LEN:
+				MOVrw(REG_WIRELEN, REG_X);
+				break;
+
+			case BPF_LD|BPF_W|BPF_IND:
+				MOVi(ins->k, REG_TMP);
+				CMPrr(REG_BUFLEN, REG_X);
+				BRCOND(COND_HI, 8);
+				SUBrrr(REG_X, REG_BUFLEN, REG_TMP2);
+				CMPrr(REG_TMP, REG_TMP2);
+				BRCOND(COND_LO, 5);
+				ADDrrr(REG_X, REG_TMP, REG_TMP);
+				SUBrrr(REG_TMP, REG_BUFLEN, REG_TMP2);
+				CMPi(sizeof(int32_t), REG_TMP2);
+				BRCOND(COND_HS, 1 + RET0LEN);
+				RET0();
+				LDRwro(REG_TMP, REG_PKT, REG_A);
+				REVw(REG_A);
+				break;
+
+			case BPF_LD|BPF_H|BPF_IND:
+				MOVi(ins->k, REG_TMP);
+				CMPrr(REG_BUFLEN, REG_X);
+				BRCOND(COND_HI, 8);
+				SUBrrr(REG_X, REG_BUFLEN, REG_TMP2);
+				CMPrr(REG_TMP, REG_TMP2);
+				BRCOND(COND_LO, 5);
+				ADDrrr(REG_X, REG_TMP, REG_TMP);
+				SUBrrr(REG_TMP, REG_BUFLEN, REG_TMP2);
+				CMPi(sizeof(int16_t), REG_TMP2);
+				BRCOND(COND_HS, 1 + RET0LEN);
+				RET0();
+				LDRHwro(REG_TMP, REG_PKT, REG_A);
+				REV16w(REG_A);
+				break;
+
+			case BPF_LD|BPF_B|BPF_IND:
+				MOVi(ins->k, REG_TMP);
+				CMPrr(REG_BUFLEN, REG_X);
+				BRCOND(COND_HS, 4);
+				SUBrrr(REG_X, REG_BUFLEN, REG_TMP2);
+				CMPrr(REG_TMP, REG_TMP2);
+				BRCOND(COND_HI, 1 + RET0LEN);
+				RET0();
+				ADDrrr(REG_X, REG_TMP, REG_TMP);
+				LDRBwro(REG_TMP, REG_PKT, REG_A);
+				break;
+
+			case BPF_LDX|BPF_MSH|BPF_B:
+				MOVi(ins->k, REG_TMP);
+				CMPrr(REG_BUFLEN, REG_TMP);
+				BRCOND(COND_LO, 1 + RET0LEN);
+				RET0();
+				LDRBwro(REG_TMP, REG_PKT, REG_X);
+				MOVi(0x0f, REG_TMP);
+				ANDrrr(REG_TMP, REG_X, REG_X);
+				MOVi(2, REG_TMP);
+				LSLVrrr(REG_TMP, REG_X, REG_X);
+				break;
+
+			case BPF_LD|BPF_IMM:
+				MOVi(ins->k, REG_A);
+				break;
+
+			case BPF_LDX|BPF_IMM:
+				MOVi(ins->k, REG_X);
+				break;
+
+			case BPF_LD|BPF_MEM:
+				LDRspi(ins->k, REG_A);
+				break;
+
+			case BPF_LDX|BPF_MEM:
+				LDRspi(ins->k, REG_X);
+				break;
+
+			case BPF_ST:
+				STRspi(ins->k, REG_A);
+				break;
+
+			case BPF_STX:
+				STRspi(ins->k, REG_X);
+				break;
+
+			case BPF_JMP|BPF_JA:
+				JUMP(ins->k);
+				break;
+
+			case BPF_JMP|BPF_JGT|BPF_K:
+			case BPF_JMP|BPF_JGE|BPF_K:
+			case BPF_JMP|BPF_JEQ|BPF_K:
+			case BPF_JMP|BPF_JSET|BPF_K:
+			case BPF_JMP|BPF_JGT|BPF_X:
+			case BPF_JMP|BPF_JGE|BPF_X:
+			case BPF_JMP|BPF_JEQ|BPF_X:
+			case BPF_JMP|BPF_JSET|BPF_X:
+				if (ins->jt == ins->jf) {
+					JUMP(ins->jt);
+					break;
+				}
+				switch (ins->code) {
+				case BPF_JMP|BPF_JGT|BPF_K:
+					MOVi(ins->k, REG_TMP);
+					CMPrr(REG_TMP, REG_A);
+					JCC(COND_HI, COND_LS);
+					break;
+
+				case BPF_JMP|BPF_JGE|BPF_K:
+					MOVi(ins->k, REG_TMP);
+					CMPrr(REG_TMP, REG_A);
+					JCC(COND_HS, COND_LO);
+					break;
+
+				case BPF_JMP|BPF_JEQ|BPF_K:
+					MOVi(ins->k, REG_TMP);
+					CMPrr(REG_TMP, REG_A);
+					JCC(COND_EQ, COND_NE);
+					break;
+
+				case BPF_JMP|BPF_JSET|BPF_K:
+					MOVi(ins->k, REG_TMP);
+					TSTrr(REG_TMP, REG_A);
+					JCC(COND_NE, COND_EQ);
+					break;
+
+				case BPF_JMP|BPF_JGT|BPF_X:
+					CMPrr(REG_X, REG_A);
+					JCC(COND_HI, COND_LS);
+					break;
+
+				case BPF_JMP|BPF_JGE|BPF_X:
+					CMPrr(REG_X, REG_A);
+					JCC(COND_HS, COND_LO);
+					break;
+
+				case BPF_JMP|BPF_JEQ|BPF_X:
+					CMPrr(REG_X, REG_A);
+					JCC(COND_EQ, COND_NE);
+					break;
+
+				case BPF_JMP|BPF_JSET|BPF_X:
+					TSTrr(REG_X, REG_A);
+					JCC(COND_NE, COND_EQ);
+					break;
+				}
+				break;
+
+			case BPF_ALU|BPF_ADD|BPF_X:
+				ADDrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_SUB|BPF_X:
+				SUBrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_MUL|BPF_X:
+				MULrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_DIV|BPF_X:
+			case BPF_ALU|BPF_MOD|BPF_X:
+				CBNZw(REG_X, 1 + RET0LEN);
+				RET0();
+				if (BPF_OP(ins->code) == BPF_DIV)
+					UDIVrrr(REG_X, REG_A, REG_A);
+				else {
+					UDIVrrr(REG_X, REG_A, REG_TMP);
+					MSUBrrrr(REG_X, REG_A, REG_TMP, REG_A);
+				}
+				break;
+
+			case BPF_ALU|BPF_AND|BPF_X:
+				ANDrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_OR|BPF_X:
+				ORRrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_XOR|BPF_X:
+				EORrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_LSH|BPF_X:
+				LSLVrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_RSH|BPF_X:
+				LSRVrrr(REG_X, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_ADD|BPF_K:
+				MOVi(ins->k, REG_TMP);
+				ADDrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_SUB|BPF_K:
+				MOVi(ins->k, REG_TMP);
+				SUBrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_MUL|BPF_K:
+				MOVi(ins->k, REG_TMP);
+				MULrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_DIV|BPF_K:
+			case BPF_ALU|BPF_MOD|BPF_K:
+				MOVi(ins->k, REG_TMP);
+				if (BPF_OP(ins->code) == BPF_DIV)
+					UDIVrrr(REG_TMP, REG_A, REG_A);
+				else {
+					UDIVrrr(REG_TMP, REG_A, REG_TMP2);
+					MSUBrrrr(REG_TMP, REG_A, REG_TMP2,
+					    REG_A);
+				}
+				break;
+
+			case BPF_ALU|BPF_AND|BPF_K:
+				MOVi(ins->k, REG_TMP);
+				ANDrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_OR|BPF_K:
+				MOVi(ins->k, REG_TMP);
+				ORRrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_XOR|BPF_K:
+				MOVi(ins->k, REG_TMP);
+				EORrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_LSH|BPF_K:
+				MOVi(ins->k & 0x1f, REG_TMP);
+				LSLVrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_RSH|BPF_K:
+				MOVi(ins->k & 0x1f, REG_TMP);
+				LSRVrrr(REG_TMP, REG_A, REG_A);
+				break;
+
+			case BPF_ALU|BPF_NEG:
+				NEGr(REG_A);
+				break;
+
+			case BPF_MISC|BPF_TAX:
+				MOVrw(REG_A, REG_X);
+				break;
+
+			case BPF_MISC|BPF_TXA:
+				MOVrw(REG_X, REG_A);
+				break;
+			}
+			ins++;
+		}
+
+		if (pass > 0)
+			continue;
+
+		*size = stream.cur_ip;
+#ifdef _KERNEL
+		stream.ibuf = malloc(*size, M_BPFJIT, M_EXEC | M_NOWAIT);
+		if (stream.ibuf == NULL)
+			break;
+#else
+		stream.ibuf = mmap(NULL, *size, PROT_READ | PROT_WRITE,
+		    MAP_ANON, -1, 0);
+		if (stream.ibuf == MAP_FAILED) {
+			stream.ibuf = NULL;
+			break;
+		}
+#endif
+
+		/*
+		 * Modify the reference table to contain the offsets and
+		 * not the lengths of the instructions.
+		 */
+		if (fjmp)
+			for (i = 1; i < nins + 1; i++)
+				stream.refs[i] += stream.refs[i - 1];
+
+		/* Reset the counters. */
+		stream.cur_ip = 0;
+		stream.bpf_pc = 0;
+
+		/* The second pass creates the actual code. */
+		emitm = emit_code;
+	}
+
+	/*
+	 * The reference table is needed only during compilation,
+	 * now we can free it.
+	 */
+	if (fjmp)
+#ifdef _KERNEL
+		free(stream.refs, M_BPFJIT);
+#else
+		free(stream.refs);
+#endif
+
+	/* Make the freshly written instructions visible to instruction fetch. */
+#ifdef _KERNEL
+	if (stream.ibuf != NULL)
+		cpu_icache_sync_range((vm_offset_t)stream.ibuf, *size);
+#else
+	if (stream.ibuf != NULL) {
+		__builtin___clear_cache(stream.ibuf, stream.ibuf + *size);
+		if (mprotect(stream.ibuf, *size, PROT_READ | PROT_EXEC) != 0) {
+			munmap(stream.ibuf, *size);
+			stream.ibuf = NULL;
+		}
+	}
+#endif
+
+	return ((bpf_filter_func)(void *)stream.ibuf);
+}
@@ -0,0 +1,227 @@
+/*-
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright (C) 2002-2003 NetGroup, Politecnico di Torino (Italy)
+ * Copyright (C) 2005-2017 Jung-uk Kim <jkim@FreeBSD.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Politecnico di Torino nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $FreeBSD$
+ */
+
+#ifndef _BPF_JIT_MACHDEP_H_
+#define _BPF_JIT_MACHDEP_H_
+
+/*
+ * Register assignment.
+ *
+ * The generated code follows the AAPCS64 calling convention for
+ * bpf_filter_func: the packet pointer arrives in x0, wirelen in w1 and
+ * buflen in w2, and the result is returned in w0.  All working
+ * registers are caller-saved temporaries, so no prologue spills are
+ * needed.
+ */
+#define	REG_RET		0	/* w0, return value */
+#define	REG_A		8	/* w8, BPF accumulator */
+#define	REG_X		9	/* w9, BPF index register */
+#define	REG_PKT		10	/* x10, packet pointer */
+#define	REG_BUFLEN	11	/* w11, buflen */
+#define	REG_WIRELEN	12	/* w12, wirelen */
+#define	REG_TMP		13	/* w13, scratch */
+#define	REG_TMP2	14	/* w14, scratch */
+#define	REG_ZERO	31	/* wzr/xzr */
+
+/* Condition codes for B.cond. */
+#define	COND_EQ		0x0
+#define	COND_NE		0x1
+#define	COND_HS		0x2
+#define	COND_LO		0x3
+#define	COND_HI		0x8
+#define	COND_LS		0x9
+
+/* Scratch memory frame size; BPF_MEMWORDS words kept 16-byte aligned. */
+#define	BPF_JIT_MEMSIZE	roundup(BPF_MEMWORDS * sizeof(uint32_t), 16)
+
+/* Optimization flags */
+#define	BPF_JIT_FRET	0x01
+#define	BPF_JIT_FPKT	0x02
+#define	BPF_JIT_FMEM	0x04
+#define	BPF_JIT_FJMP	0x08
+#define	BPF_JIT_FLEN	0x10
+
+#define	BPF_JIT_FLAG_ALL	\
+    (BPF_JIT_FPKT | BPF_JIT_FMEM | BPF_JIT_FJMP | BPF_JIT_FLEN)
+
+/* A stream of native binary code */
+typedef struct bpf_bin_stream {
+	/* Current native instruction pointer. */
+	int		cur_ip;
+
+	/*
+	 * Current BPF instruction pointer, i.e. position in
+	 * the BPF program reached by the jitter.
+	 */
+	int		bpf_pc;
+
+	/* Instruction buffer, contains the generated native code. */
+	char		*ibuf;
+
+	/* Jumps reference table. */
+	u_int		*refs;
+} bpf_bin_stream;
+
+/*
+ * Prototype of the emit functions.
+ *
+ * Different emit functions are used to create the reference table and
+ * to generate the actual filtering code.  Unlike on x86, every A64
+ * instruction is four bytes, so the length argument is always 4.
+ */
+typedef void (*emit_func)(bpf_bin_stream *stream, u_int value, u_int n);
+
+/*
+ * Native instruction macros.  All operands are register numbers; the
+ * W (32-bit) form of a register is used unless noted otherwise.
+ */
+
+#define	EMIT(insn)	emitm(&stream, (insn), 4)
+
+/* MOVZ/MOVK, move 16-bit immediate with optional 16-bit left shift. */
+#define	MOVZ(v, hw, rd)	\
+    EMIT(0x52800000 | ((hw) << 21) | (((v) & 0xffff) << 5) | (rd))
+#define	MOVK(v, hw, rd)	\
+    EMIT(0x72800000 | ((hw) << 21) | (((v) & 0xffff) << 5) | (rd))
+
+/* Load a 32-bit immediate; one or two instructions depending on value. */
+#define	MOVi(v, rd) do {						\
+	MOVZ((v) & 0xffff, 0, rd);					\
+	if ((((u_int)(v)) >> 16) != 0)					\
+		MOVK(((u_int)(v)) >> 16, 1, rd);			\
+} while (0)
+
+/* MOV (register), 32- and 64-bit forms (ORR with the zero register). */
+#define	MOVrw(rm, rd)	EMIT(0x2a0003e0 | ((rm) << 16) | (rd))
+#define	MOVrx(rm, rd)	EMIT(0xaa0003e0 | ((rm) << 16) | (rd))
+
+/* Data processing, shifted register: rd = rn op rm. */
+#define	ADDrrr(rm, rn, rd)	\
+    EMIT(0x0b000000 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	SUBrrr(rm, rn, rd)	\
+    EMIT(0x4b000000 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	SUBSrrr(rm, rn, rd)	\
+    EMIT(0x6b000000 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	ANDrrr(rm, rn, rd)	\
+    EMIT(0x0a000000 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	ORRrrr(rm, rn, rd)	\
+    EMIT(0x2a000000 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	EORrrr(rm, rn, rd)	\
+    EMIT(0x4a000000 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	MULrrr(rm, rn, rd)	\
+    EMIT(0x1b007c00 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	UDIVrrr(rm, rn, rd)	\
+    EMIT(0x1ac00800 | ((rm) << 16) | ((rn) << 5) | (rd))
+/* rd = ra - rn * rm */
+#define	MSUBrrrr(rm, ra, rn, rd)	\
+    EMIT(0x1b008000 | ((rm) << 16) | ((ra) << 10) | ((rn) << 5) | (rd))
+#define	LSLVrrr(rm, rn, rd)	\
+    EMIT(0x1ac02000 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	LSRVrrr(rm, rn, rd)	\
+    EMIT(0x1ac02400 | ((rm) << 16) | ((rn) << 5) | (rd))
+#define	NEGr(rd)	SUBrrr(rd, REG_ZERO, rd)
+
+/* Compare and test: flags = rn - rm, flags = rn & rm. */
+#define	CMPrr(rm, rn)	EMIT(0x6b00001f | ((rm) << 16) | ((rn) << 5))
+#define	CMPi(v, rn)	EMIT(0x7100001f | (((v) & 0xfff) << 10) | ((rn) << 5))
+#define	TSTrr(rm, rn)	EMIT(0x6a00001f | ((rm) << 16) | ((rn) << 5))
+
+/* Stack frame adjustment (64-bit immediate add/sub on SP). */
+#define	SUBSPi(v)	EMIT(0xd1000000 | (((v) & 0xfff) << 10) | (31 << 5) | 31)
+#define	ADDSPi(v)	EMIT(0x91000000 | (((v) & 0xfff) << 10) | (31 << 5) | 31)
+
+/* Loads with a 32-bit (UXTW) register offset off the packet pointer. */
+#define	LDRwro(rm, rn, rt)	\
+    EMIT(0xb8604800 | ((rm) << 16) | ((rn) << 5) | (rt))
+#define	LDRHwro(rm, rn, rt)	\
+    EMIT(0x78604800 | ((rm) << 16) | ((rn) << 5) | (rt))
+#define	LDRBwro(rm, rn, rt)	\
+    EMIT(0x38604800 | ((rm) << 16) | ((rn) << 5) | (rt))
+
+/* Scratch memory access, word-scaled unsigned offset off SP. */
+#define	LDRspi(w, rt)	\
+    EMIT(0xb9400000 | (((w) & 0xfff) << 10) | (31 << 5) | (rt))
+#define	STRspi(w, rt)	\
+    EMIT(0xb9000000 | (((w) & 0xfff) << 10) | (31 << 5) | (rt))
+
+/* Byte swaps, in place. */
+#define	REVw(rd)	EMIT(0x5ac00800 | ((rd) << 5) | (rd))
+#define	REV16w(rd)	EMIT(0x5ac00400 | ((rd) << 5) | (rd))
+
+#define	RETURN()	EMIT(0xd65f03c0)
+
+/* Forward branches local to one BPF instruction, in A64 instructions. */
+#define	BRCOND(cond, n)	EMIT(0x54000000 | (((n) & 0x7ffff) << 5) | (cond))
+#define	CBNZw(rt, n)	EMIT(0x35000000 | (((n) & 0x7ffff) << 5) | (rt))
+
+/* Branches to other BPF instructions, through the reference table. */
+#define	JUMP(k)	EMIT(0x14000000 |					\
+    (((stream.refs[stream.bpf_pc + (k)] - stream.cur_ip) >> 2) &	\
+    0x03ffffff))
+#define	BCONDbpf(cond, k)	EMIT(0x54000000 |			\
+    ((((stream.refs[stream.bpf_pc + (k)] - stream.cur_ip) >> 2) &	\
+    0x7ffff) << 5) | (cond))
+
+/*
+ * Emit the true and/or false branch of a conditional BPF jump,
+ * whichever is not a fall-through.
+ */
+#define	JCC(cond, negcond) do {						\
+	if (ins->jt != 0 && ins->jf != 0) {				\
+		BCONDbpf(cond, ins->jt);				\
+		JUMP(ins->jf);						\
+	} else if (ins->jt != 0)					\
+		BCONDbpf(cond, ins->jt);				\
+	else								\
+		BCONDbpf(negcond, ins->jf);				\
+} while (0)
+
+/* Function epilogue; pairs with the scratch memory frame allocation. */
+#define	EPILOGUE() do {							\
+	if (fmem)							\
+		ADDSPi(BPF_JIT_MEMSIZE);				\
+	RETURN();							\
+} while (0)
+
+/* Return zero to the caller; used for failed bounds checks. */
+#define	RET0() do {							\
+	MOVZ(0, 0, REG_RET);						\
+	EPILOGUE();							\
+} while (0)
+
+/* Number of instructions RET0() emits, for local branch distances. */
+#define	RET0LEN		(fmem ? 3 : 2)
+
+#endif	/* _BPF_JIT_MACHDEP_H_ */
@@ -359,6 +359,8 @@ struct ccb_hdr {
 	struct timeval	softtimeout;	/* Soft timeout value in sec + usec */
 };
 
+STAILQ_HEAD(ccb_hdr_stailq, ccb_hdr);
+
 /* Get Device Information CCB */
 struct ccb_getdev {
 	struct	  ccb_hdr ccb_h;
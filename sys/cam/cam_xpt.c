@@ -4632,6 +4632,68 @@ xpt_done(union ccb *done_ccb)
 		wakeup(&queue->cam_doneq);
 }
 
+/*
+ * Queue a batch of completed ccbs, linked through sim_links.stqe, for
+ * processing by the completion threads.  A run of consecutive ccbs that
+ * hash to the same done queue is inserted under a single acquisition of
+ * that queue's lock, so SIMs draining a hardware completion ring can
+ * hand over everything they reaped in one call instead of paying a lock
+ * round trip per ccb in xpt_done().  The batch list is empty on return.
+ */
+void
+xpt_done_batch(struct ccb_hdr_stailq *batch)
+{
+	struct cam_doneq *queue;
+	struct ccb_hdr *ccb_h;
+	int run, hash, prev_hash;
+
+	queue = NULL;
+	run = 0;
+	prev_hash = -1;
+	while ((ccb_h = STAILQ_FIRST(batch)) != NULL) {
+		STAILQ_REMOVE_HEAD(batch, sim_links.stqe);
+
+#if defined(BUF_TRACKING) || defined(FULL_BUF_TRACKING)
+		if (ccb_h->func_code == XPT_SCSI_IO &&
+		    ((union ccb *)ccb_h)->csio.bio != NULL)
+			biotrack(((union ccb *)ccb_h)->csio.bio, __func__);
+#endif
+
+		CAM_DEBUG(ccb_h->path, CAM_DEBUG_TRACE,
+		    ("xpt_done_batch: func= %#x %s status %#x\n",
+			ccb_h->func_code,
+			xpt_action_name(ccb_h->func_code),
+			ccb_h->status));
+		if ((ccb_h->func_code & XPT_FC_QUEUED) == 0)
+			continue;
+
+		/* Store the time the ccb was in the sim */
+		ccb_h->qos.periph_data =
+		    cam_iosched_delta_t(ccb_h->qos.periph_data);
+		hash = (ccb_h->path_id + ccb_h->target_id +
+		    ccb_h->target_lun) % cam_num_doneqs;
+		if (hash != prev_hash) {
+			if (queue != NULL) {
+				mtx_unlock(&queue->cam_doneq_mtx);
+				if (run)
+					wakeup(&queue->cam_doneq);
+			}
+			queue = &cam_doneqs[hash];
+			mtx_lock(&queue->cam_doneq_mtx);
+			run = (queue->cam_doneq_sleep &&
+			    STAILQ_EMPTY(&queue->cam_doneq));
+			prev_hash = hash;
+		}
+		STAILQ_INSERT_TAIL(&queue->cam_doneq, ccb_h, sim_links.stqe);
+		ccb_h->pinfo.index = CAM_DONEQ_INDEX;
+	}
+	if (queue != NULL) {
+		mtx_unlock(&queue->cam_doneq_mtx);
+		if (run)
+			wakeup(&queue->cam_doneq);
+	}
+}
+
 void
 xpt_done_direct(union ccb *done_ccb)
 {
@@ -48,6 +48,7 @@ u_int32_t	xpt_freeze_devq(struct cam_path *path, u_int count);
 void		xpt_release_devq(struct cam_path *path,
 		    u_int count, int run_queue);
 void		xpt_done(union ccb *done_ccb);
+void		xpt_done_batch(struct ccb_hdr_stailq *batch);
 void		xpt_done_direct(union ccb *done_ccb);
 #endif
 
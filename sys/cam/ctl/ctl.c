@@ -13338,6 +13338,7 @@ ctl_work_thread(void *arg)
 {
 	struct ctl_thread *thr = (struct ctl_thread *)arg;
 	struct ctl_softc *softc = thr->ctl_softc;
+	STAILQ_HEAD(, ctl_io_hdr) queue = STAILQ_HEAD_INITIALIZER(queue);
 	union ctl_io *io;
 	int retval;
 
@@ -13354,33 +13355,47 @@ ctl_work_thread(void *arg)
 		 * - incoming queue
 		 * - RtR queue
 		 *
-		 * If those queues are empty, we break out of the loop and
-		 * go to sleep.
+		 * Each queue is drained wholesale under a single lock
+		 * acquisition and its contents processed unlocked, so that
+		 * frontend ports enqueueing new requests do not convoy on
+		 * the queue lock behind per-request consumer acquisitions.
+		 * RtR I/Os are still executed one at a time, since they can
+		 * run long and the other queues should be serviced between
+		 * them.  If all queues are empty, we go to sleep.
 		 */
 		mtx_lock(&thr->queue_lock);
-		io = (union ctl_io *)STAILQ_FIRST(&thr->isc_queue);
-		if (io != NULL) {
-			STAILQ_REMOVE_HEAD(&thr->isc_queue, links);
+		if (!STAILQ_EMPTY(&thr->isc_queue)) {
+			STAILQ_SWAP(&thr->isc_queue, &queue, ctl_io_hdr);
 			mtx_unlock(&thr->queue_lock);
-			ctl_handle_isc(io);
+			while ((io = (union ctl_io *)STAILQ_FIRST(&queue)) !=
+			    NULL) {
+				STAILQ_REMOVE_HEAD(&queue, links);
+				ctl_handle_isc(io);
+			}
 			continue;
 		}
-		io = (union ctl_io *)STAILQ_FIRST(&thr->done_queue);
-		if (io != NULL) {
-			STAILQ_REMOVE_HEAD(&thr->done_queue, links);
-			/* clear any blocked commands, call fe_done */
+		if (!STAILQ_EMPTY(&thr->done_queue)) {
+			STAILQ_SWAP(&thr->done_queue, &queue, ctl_io_hdr);
 			mtx_unlock(&thr->queue_lock);
-			ctl_process_done(io);
+			while ((io = (union ctl_io *)STAILQ_FIRST(&queue)) !=
+			    NULL) {
+				STAILQ_REMOVE_HEAD(&queue, links);
+				/* clear any blocked commands, call fe_done */
+				ctl_process_done(io);
+			}
 			continue;
 		}
-		io = (union ctl_io *)STAILQ_FIRST(&thr->incoming_queue);
-		if (io != NULL) {
-			STAILQ_REMOVE_HEAD(&thr->incoming_queue, links);
+		if (!STAILQ_EMPTY(&thr->incoming_queue)) {
+			STAILQ_SWAP(&thr->incoming_queue, &queue, ctl_io_hdr);
 			mtx_unlock(&thr->queue_lock);
-			if (io->io_hdr.io_type == CTL_IO_TASK)
-				ctl_run_task(io);
-			else
-				ctl_scsiio_precheck(softc, &io->scsiio);
+			while ((io = (union ctl_io *)STAILQ_FIRST(&queue)) !=
+			    NULL) {
+				STAILQ_REMOVE_HEAD(&queue, links);
+				if (io->io_hdr.io_type == CTL_IO_TASK)
+					ctl_run_task(io);
+				else
+					ctl_scsiio_precheck(softc, &io->scsiio);
+			}
 			continue;
 		}
 		io = (union ctl_io *)STAILQ_FIRST(&thr->rtr_queue);
@@ -13394,6 +13409,7 @@ ctl_work_thread(void *arg)
 		}
 
 		/* Sleep until we have something to do. */
+		thr->sleeping = true;
 		mtx_sleep(thr, &thr->queue_lock, PDROP, "-", 0);
 	}
 	thr->thread = NULL;
@@ -13519,8 +13535,11 @@ ctl_enqueue_incoming(union ctl_io *io)
 	thr = &softc->threads[idx];
 	mtx_lock(&thr->queue_lock);
 	STAILQ_INSERT_TAIL(&thr->incoming_queue, &io->io_hdr, links);
+	if (thr->sleeping) {
+		thr->sleeping = false;
+		wakeup(thr);
+	}
 	mtx_unlock(&thr->queue_lock);
-	wakeup(thr);
 }
 
 static void
@@ -13532,8 +13551,11 @@ ctl_enqueue_rtr(union ctl_io *io)
 	thr = &softc->threads[io->io_hdr.nexus.targ_mapped_lun % worker_threads];
 	mtx_lock(&thr->queue_lock);
 	STAILQ_INSERT_TAIL(&thr->rtr_queue, &io->io_hdr, links);
+	if (thr->sleeping) {
+		thr->sleeping = false;
+		wakeup(thr);
+	}
 	mtx_unlock(&thr->queue_lock);
-	wakeup(thr);
 }
 
 static void
@@ -13545,8 +13567,11 @@ ctl_enqueue_done(union ctl_io *io)
 	thr = &softc->threads[io->io_hdr.nexus.targ_mapped_lun % worker_threads];
 	mtx_lock(&thr->queue_lock);
 	STAILQ_INSERT_TAIL(&thr->done_queue, &io->io_hdr, links);
+	if (thr->sleeping) {
+		thr->sleeping = false;
+		wakeup(thr);
+	}
 	mtx_unlock(&thr->queue_lock);
-	wakeup(thr);
 }
 
 static void
@@ -13558,8 +13583,11 @@ ctl_enqueue_isc(union ctl_io *io)
 	thr = &softc->threads[io->io_hdr.nexus.targ_mapped_lun % worker_threads];
 	mtx_lock(&thr->queue_lock);
 	STAILQ_INSERT_TAIL(&thr->isc_queue, &io->io_hdr, links);
+	if (thr->sleeping) {
+		thr->sleeping = false;
+		wakeup(thr);
+	}
 	mtx_unlock(&thr->queue_lock);
-	wakeup(thr);
 }
 
 /*
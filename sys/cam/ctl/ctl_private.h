@@ -428,6 +428,7 @@ struct ctl_thread {
 	struct mtx_padalign queue_lock;
 	struct ctl_softc	*ctl_softc;
 	struct thread		*thread;
+	bool			sleeping;	/* P: queue_lock */
 	STAILQ_HEAD(, ctl_io_hdr) incoming_queue;
 	STAILQ_HEAD(, ctl_io_hdr) rtr_queue;
 	STAILQ_HEAD(, ctl_io_hdr) done_queue;
@@ -448,7 +448,13 @@ typedef struct dtrace_buffer {
 #endif
 	uint64_t dtb_switched;			/* time of last switch */
 	uint64_t dtb_interval;			/* observed switch interval */
+#ifndef illumos
+	volatile uint32_t dtb_consumer;		/* snapshot consumer claim */
+	uint32_t dtb_pad3;
+	uint64_t dtb_pad2[5];			/* pad to avoid false sharing */
+#else
 	uint64_t dtb_pad2[6];			/* pad to avoid false sharing */
+#endif
 } dtrace_buffer_t;
 
 /*
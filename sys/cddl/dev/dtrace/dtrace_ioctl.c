@@ -306,13 +306,28 @@ dtrace_ioctl(struct cdev *dev, u_long cmd, caddr_t addr,
 			return (ENOENT);
 		}
 
+		/*
+		 * For "switch" policy buffers the handoff to the consumer is
+		 * lock-free:  claim the buffer, then drop dtrace_lock so that
+		 * neither the cross call nor the copyout of the (potentially
+		 * large) inactive buffer holds the global lock.  The claim
+		 * serializes concurrent consumers of the same per-CPU buffer;
+		 * the switch itself is serialized against probe context by
+		 * the cross call's disabling of interrupts.
+		 */
+		if (atomic_cmpset_acq_32(&buf->dtb_consumer, 0, 1) == 0) {
+			mutex_exit(&dtrace_lock);
+			return (EBUSY);
+		}
+		mutex_exit(&dtrace_lock);
+
 		cached = buf->dtb_tomax;
 		ASSERT(!(buf->dtb_flags & DTRACEBUF_NOSWITCH));
 
 		dtrace_xcall(desc.dtbd_cpu,
 		    (dtrace_xcall_t)dtrace_buffer_switch, buf);
 
-		state->dts_errors += buf->dtb_xamot_errors;
+		atomic_add_64(&state->dts_errors, buf->dtb_xamot_errors);
 
 		/*
 		 * If the buffers did not actually switch, then the cross call
@@ -322,7 +337,7 @@ dtrace_ioctl(struct cdev *dev, u_long cmd, caddr_t addr,
 		 */
 		if (buf->dtb_tomax == cached) {
 			ASSERT(buf->dtb_xamot != cached);
-			mutex_exit(&dtrace_lock);
+			atomic_store_rel_32(&buf->dtb_consumer, 0);
 			return (ENOENT);
 		}
 
@@ -335,7 +350,7 @@ dtrace_ioctl(struct cdev *dev, u_long cmd, caddr_t addr,
 		 */
 		if (copyout(buf->dtb_xamot, desc.dtbd_data,
 		    buf->dtb_xamot_offset) != 0) {
-			mutex_exit(&dtrace_lock);
+			atomic_store_rel_32(&buf->dtb_consumer, 0);
 			return (EFAULT);
 		}
 
@@ -345,7 +360,7 @@ dtrace_ioctl(struct cdev *dev, u_long cmd, caddr_t addr,
 		desc.dtbd_oldest = 0;
 		desc.dtbd_timestamp = buf->dtb_switched;
 
-		mutex_exit(&dtrace_lock);
+		atomic_store_rel_32(&buf->dtb_consumer, 0);
 
 		DTRACE_IOCTL_PRINTF("%s(%d): copyout buffer desc: size %zd drops %lu errors %lu\n",__func__,__LINE__,(size_t) desc.dtbd_size,(u_long) desc.dtbd_drops,(u_long) desc.dtbd_errors);
 
@@ -2048,6 +2048,10 @@ freebsd32_do_sendfile(struct thread *td,
 	if (offset < 0)
 		return (EINVAL);
 
+	/* Completion kevents are not yet supported for 32-bit binaries. */
+	if (uap->flags & SF_KQUEUE)
+		return (EOPNOTSUPP);
+
 	hdr_uio = trl_uio = NULL;
 
 	if (uap->hdtr != NULL) {
@@ -2095,7 +2099,7 @@ freebsd32_do_sendfile(struct thread *td,
 		goto out;
 
 	error = fo_sendfile(fp, uap->s, hdr_uio, trl_uio, offset,
-	    uap->nbytes, &sbytes, uap->flags, td);
+	    uap->nbytes, &sbytes, uap->flags, NULL, td);
 	fdrop(fp, td);
 
 	if (uap->sbytes != NULL)
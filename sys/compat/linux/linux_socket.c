@@ -1649,7 +1649,7 @@ linux_sendfile_common(struct thread *td, l_int out, l_int in,
 	}
 
 	error = fo_sendfile(fp, out, NULL, NULL, current_offset, count,
-	    &bytes_read, 0, td);
+	    &bytes_read, 0, NULL, td);
 	if (error != 0)
 		goto drop;
 	current_offset += bytes_read;
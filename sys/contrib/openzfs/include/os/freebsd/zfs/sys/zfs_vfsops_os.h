@@ -93,6 +93,12 @@ struct zfsvfs {
 	uint64_t	z_projectobjquota_obj;
 	uint64_t	z_replay_eof;	/* New end of file - replay only */
 	sa_attr_type_t	*z_attr_table;	/* SA attr mapping->id */
+	kmutex_t	z_rl_lock;	/* rate limit token bucket lock */
+	uint64_t	z_rl_bw_limit;	/* max bytes per second, 0 = none */
+	uint64_t	z_rl_iops_limit; /* max operations per second, 0 = none */
+	int64_t		z_rl_bytes;	/* (z_rl_lock) byte tokens */
+	int64_t		z_rl_ops;	/* (z_rl_lock) operation tokens */
+	hrtime_t	z_rl_last;	/* (z_rl_lock) last token refill */
 #define	ZFS_OBJ_MTX_SZ	64
 	kmutex_t	z_hold_mtx[ZFS_OBJ_MTX_SZ];	/* znode hold locks */
 	struct task	z_unlinked_drain_task;
@@ -165,6 +171,7 @@ extern int zfsvfs_create_impl(zfsvfs_t **zfvp, zfsvfs_t *zfsvfs, objset_t *os);
 extern void zfsvfs_free(zfsvfs_t *zfsvfs);
 extern int zfs_check_global_label(const char *dsname, const char *hexsl);
 extern boolean_t zfs_is_readonly(zfsvfs_t *zfsvfs);
+extern void zfs_ratelimit(zfsvfs_t *zfsvfs, ssize_t bytes);
 extern int zfs_get_temporary_prop(struct dsl_dataset *ds, zfs_prop_t zfs_prop,
     uint64_t *val, char *setpoint);
 extern int zfs_busy(void);
@@ -27,10 +27,16 @@ extern "C" {
 
 typedef struct bqueue {
 	list_t bq_list;
+	uint64_t bq_size;
+	/* Private to the consumer; drained without taking bq_lock. */
+	list_t bq_dequeuing_list;
+	uint64_t bq_dequeuing_size;
+	/* Private to the producer; filled without taking bq_lock. */
+	list_t bq_enqueuing_list;
+	uint64_t bq_enqueuing_size;
 	kmutex_t bq_lock;
 	kcondvar_t bq_add_cv;
 	kcondvar_t bq_pop_cv;
-	uint64_t bq_size;
 	uint64_t bq_maxsize;
 	uint64_t bq_fill_fraction;
 	size_t bq_node_offset;
@@ -178,6 +178,15 @@ void *zfs_btree_get(zfs_btree_t *, zfs_btree_index_t *);
  */
 void zfs_btree_add(zfs_btree_t *, const void *);
 
+/*
+ * Fill an empty tree from an array of values sorted by the tree's comparator.
+ * The values must be sorted and must not compare equal to each other. This
+ * keeps the tree in bulk-insert mode for the whole load, so nodes are built
+ * bottom-up and packed full rather than split half empty. The values are
+ * copied out, as with zfs_btree_add().
+ */
+void zfs_btree_bulk_load(zfs_btree_t *, const void *, uint64_t);
+
 /*
  * Remove a single value from the tree.  The value must be in the tree. The
  * pointer passed in may be a pointer into a tree-controlled buffer, but it
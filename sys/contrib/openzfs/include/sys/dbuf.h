@@ -301,12 +301,22 @@ typedef struct dmu_buf_impl {
 } dmu_buf_impl_t;
 
 /* Note: the dbuf hash table is exposed only for the mdb module */
-#define	DBUF_MUTEXES 8192
-#define	DBUF_HASH_MUTEX(h, idx) (&(h)->hash_mutexes[(idx) & (DBUF_MUTEXES-1)])
+#define	DBUF_HASH_MUTEX(h, idx) \
+	(&(h)->hash_mutexes[(idx) & (h)->hash_mutex_mask].dbhm_mtx)
+
+/*
+ * Give each hash mutex its own cache line so that lookups of unrelated
+ * buffers do not bounce the same line between cores.
+ */
+typedef struct dbuf_hash_mutex {
+	kmutex_t dbhm_mtx;
+} ____cacheline_aligned dbuf_hash_mutex_t;
+
 typedef struct dbuf_hash_table {
 	uint64_t hash_table_mask;
+	uint64_t hash_mutex_mask;
 	dmu_buf_impl_t **hash_table;
-	kmutex_t hash_mutexes[DBUF_MUTEXES];
+	dbuf_hash_mutex_t *hash_mutexes;
 } dbuf_hash_table_t;
 
 uint64_t dbuf_whichblock(const struct dnode *di, const int64_t level,
@@ -138,6 +138,9 @@ struct ddt {
 	kmutex_t	ddt_lock;
 	avl_tree_t	ddt_tree;
 	avl_tree_t	ddt_repair_tree;
+	avl_tree_t	ddt_lookup_cache;
+	list_t		ddt_lookup_lru;
+	uint64_t	ddt_lookup_cache_count;
 	enum zio_checksum ddt_checksum;
 	spa_t		*ddt_spa;
 	objset_t	*ddt_os;
@@ -150,6 +150,9 @@ struct vdev_queue {
 	uint64_t	vq_last_offset;
 	hrtime_t	vq_io_complete_ts; /* time last i/o completed */
 	hrtime_t	vq_io_delta_ts;
+	hrtime_t	vq_lat_ewma;	/* smoothed device service time */
+	hrtime_t	vq_last_adjust;	/* last adaptive limit adjustment */
+	uint32_t	vq_max_active;	/* adaptive aggregate active limit */
 	zio_t		vq_io_search; /* used as local for stack reduction */
 	kmutex_t	vq_lock;
 };
@@ -272,6 +272,44 @@ zpool_get_state_str(zpool_handle_t *zhp)
 	return (str);
 }
 
+/*
+ * Return the vdev tree rooted at the top-level vdev with the given guid,
+ * taken from the pool's cached configuration.  The returned tree embeds a
+ * vdev_stat_t (ZPOOL_CONFIG_VDEV_STATS) for every child, so a caller can
+ * evaluate the status of all leaves beneath a top-level vdev from a single
+ * query instead of issuing an ioctl per vdev.  A guid of zero returns the
+ * entire root vdev tree.  The returned nvlist belongs to the handle's
+ * cached configuration: the caller must not free it, and it is only valid
+ * until the configuration is next refreshed.  Returns NULL if no top-level
+ * vdev with the given guid exists.
+ */
+nvlist_t *
+zpool_get_vdev_status(zpool_handle_t *zhp, uint64_t top_guid)
+{
+	nvlist_t *nvroot, **child;
+	uint_t children;
+	uint64_t guid;
+
+	verify(nvlist_lookup_nvlist(zpool_get_config(zhp, NULL),
+	    ZPOOL_CONFIG_VDEV_TREE, &nvroot) == 0);
+
+	if (top_guid == 0)
+		return (nvroot);
+
+	if (nvlist_lookup_nvlist_array(nvroot, ZPOOL_CONFIG_CHILDREN,
+	    &child, &children) != 0)
+		return (NULL);
+
+	for (uint_t c = 0; c < children; c++) {
+		verify(nvlist_lookup_uint64(child[c], ZPOOL_CONFIG_GUID,
+		    &guid) == 0);
+		if (guid == top_guid)
+			return (child[c]);
+	}
+
+	return (NULL);
+}
+
 /*
  * Get a zpool property value for 'prop' and return the value in
  * a pre-allocated buffer.
@@ -465,10 +465,26 @@ abd_iter_map(struct abd_iter *aiter)
 		paddr = ABD_LINEAR_BUF(aiter->iter_abd);
 	} else {
 		size_t index = abd_iter_scatter_chunk_index(aiter);
+		size_t remain = aiter->iter_abd->abd_size - aiter->iter_pos;
 		offset = abd_iter_scatter_chunk_offset(aiter);
-		aiter->iter_mapsize = MIN(zfs_abd_chunk_size - offset,
-		    aiter->iter_abd->abd_size - aiter->iter_pos);
+		aiter->iter_mapsize = MIN(zfs_abd_chunk_size - offset, remain);
 		paddr = ABD_SCATTER(aiter->iter_abd).abd_chunks[index];
+
+		/*
+		 * Chunks that happen to be virtually contiguous with
+		 * this one are presented as a single span, so callers
+		 * such as the fletcher and raidz SIMD kernels run their
+		 * vector loops across chunk boundaries instead of being
+		 * called back once per chunk.
+		 */
+		while (aiter->iter_mapsize < remain &&
+		    ABD_SCATTER(aiter->iter_abd).abd_chunks[index + 1] ==
+		    (char *)ABD_SCATTER(aiter->iter_abd).abd_chunks[index] +
+		    zfs_abd_chunk_size) {
+			index++;
+			aiter->iter_mapsize = MIN(aiter->iter_mapsize +
+			    zfs_abd_chunk_size, remain);
+		}
 	}
 	aiter->iter_mapaddr = (char *)paddr + offset;
 }
@@ -383,6 +383,67 @@ zfs_is_readonly(zfsvfs_t *zfsvfs)
 	return (!!(zfsvfs->z_vfs->vfs_flag & VFS_RDONLY));
 }
 
+/*
+ * Charge one file system operation of the given size against the
+ * dataset's token buckets, sleeping until enough tokens have been
+ * replenished when a bucket has run dry.  The buckets refill at the
+ * configured per-second rates and hold at most one second's worth of
+ * tokens, so an idle dataset can burst for about a second before being
+ * held to its rate.  An operation larger than the bucket is charged as
+ * debt: it proceeds immediately and subsequent operations wait it out.
+ */
+void
+zfs_ratelimit(zfsvfs_t *zfsvfs, ssize_t bytes)
+{
+	uint64_t bw = zfsvfs->z_rl_bw_limit;
+	uint64_t iops = zfsvfs->z_rl_iops_limit;
+	hrtime_t now, wait;
+
+	if ((bw == 0 && iops == 0) || zfsvfs->z_replay)
+		return;
+
+	mutex_enter(&zfsvfs->z_rl_lock);
+	for (;;) {
+		now = gethrtime();
+		if (zfsvfs->z_rl_last != 0) {
+			hrtime_t elapsed;
+
+			elapsed = MIN(now - zfsvfs->z_rl_last, NANOSEC);
+			if (bw != 0) {
+				zfsvfs->z_rl_bytes = MIN(zfsvfs->z_rl_bytes +
+				    (int64_t)(bw * elapsed / NANOSEC),
+				    (int64_t)bw);
+			}
+			if (iops != 0) {
+				zfsvfs->z_rl_ops = MIN(zfsvfs->z_rl_ops +
+				    (int64_t)(iops * elapsed / NANOSEC),
+				    (int64_t)iops);
+			}
+		}
+		zfsvfs->z_rl_last = now;
+
+		if ((bw == 0 || zfsvfs->z_rl_bytes >= 0) &&
+		    (iops == 0 || zfsvfs->z_rl_ops >= 0))
+			break;
+
+		wait = 0;
+		if (bw != 0 && zfsvfs->z_rl_bytes < 0)
+			wait = -zfsvfs->z_rl_bytes * NANOSEC / bw;
+		if (iops != 0 && zfsvfs->z_rl_ops < 0)
+			wait = MAX(wait, -zfsvfs->z_rl_ops * NANOSEC / iops);
+
+		mutex_exit(&zfsvfs->z_rl_lock);
+		delay(MAX(1, (int)NSEC_TO_TICK(wait)));
+		mutex_enter(&zfsvfs->z_rl_lock);
+	}
+
+	if (bw != 0)
+		zfsvfs->z_rl_bytes -= bytes;
+	if (iops != 0)
+		zfsvfs->z_rl_ops -= 1;
+	mutex_exit(&zfsvfs->z_rl_lock);
+}
+
 /*ARGSUSED*/
 static int
 zfs_sync(vfs_t *vfsp, int waitfor)
@@ -966,6 +1027,7 @@ zfsvfs_create_impl(zfsvfs_t **zfvp, zfsvfs_t *zfsvfs, objset_t *os)
 
 	mutex_init(&zfsvfs->z_znodes_lock, NULL, MUTEX_DEFAULT, NULL);
 	mutex_init(&zfsvfs->z_lock, NULL, MUTEX_DEFAULT, NULL);
+	mutex_init(&zfsvfs->z_rl_lock, NULL, MUTEX_DEFAULT, NULL);
 	list_create(&zfsvfs->z_all_znodes, sizeof (znode_t),
 	    offsetof(znode_t, z_link_node));
 	TASK_INIT(&zfsvfs->z_unlinked_drain_task, 0,
@@ -1123,6 +1185,7 @@ zfsvfs_free(zfsvfs_t *zfsvfs)
 
 	mutex_destroy(&zfsvfs->z_znodes_lock);
 	mutex_destroy(&zfsvfs->z_lock);
+	mutex_destroy(&zfsvfs->z_rl_lock);
 	ASSERT(zfsvfs->z_nr_znodes == 0);
 	list_destroy(&zfsvfs->z_all_znodes);
 	rrm_destroy(&zfsvfs->z_teardown_lock);
@@ -1286,6 +1349,23 @@ getpoolname(const char *osname, char *poolname)
 	return (0);
 }
 
+/*
+ * Apply the "bwlimit" (bytes per second) and "iopslimit" (operations
+ * per second) mount options to the dataset's token buckets.  A value of
+ * 0, or an absent option, leaves the corresponding rate unlimited.
+ */
+static void
+zfs_parse_rate_limits(vfs_t *vfsp)
+{
+	zfsvfs_t *zfsvfs = vfsp->vfs_data;
+	uintmax_t val;
+
+	if (vfs_scanopt(vfsp->mnt_optnew, "bwlimit", "%ju", &val) == 1)
+		zfsvfs->z_rl_bw_limit = val;
+	if (vfs_scanopt(vfsp->mnt_optnew, "iopslimit", "%ju", &val) == 1)
+		zfsvfs->z_rl_iops_limit = val;
+}
+
 /*ARGSUSED*/
 static int
 zfs_mount(vfs_t *vfsp)
@@ -1376,6 +1456,8 @@ zfs_mount(vfs_t *vfsp)
 		rrm_enter(&zfsvfs->z_teardown_lock, RW_WRITER, FTAG);
 		zfs_unregister_callbacks(zfsvfs);
 		error = zfs_register_callbacks(vfsp);
+		if (error == 0)
+			zfs_parse_rate_limits(vfsp);
 		rrm_exit(&zfsvfs->z_teardown_lock, FTAG);
 		goto out;
 	}
@@ -1394,6 +1476,8 @@ zfs_mount(vfs_t *vfsp)
 	DROP_GIANT();
 	error = zfs_domount(vfsp, osname);
 	PICKUP_GIANT();
+	if (error == 0)
+		zfs_parse_rate_limits(vfsp);
 
 out:
 	return (error);
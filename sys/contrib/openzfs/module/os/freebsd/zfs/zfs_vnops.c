@@ -778,6 +778,8 @@ zfs_read(vnode_t *vp, uio_t *uio, int ioflag, cred_t *cr)
 		return (0);
 	}
 
+	zfs_ratelimit(zfsvfs, uio->uio_resid);
+
 	/*
 	 * If we're in FRSYNC mode, sync out this znode before reading it.
 	 */
@@ -916,6 +918,8 @@ zfs_write(vnode_t *vp, uio_t *uio, int ioflag, cred_t *cr)
 		return (SET_ERROR(EROFS));
 	}
 
+	zfs_ratelimit(zfsvfs, n);
+
 	/*
 	 * If immutable or not appending then return EPERM.
 	 * Intentionally allow ZFS_READONLY through here.
@@ -2399,6 +2403,17 @@ zfs_rmdir(znode_t *dzp, char *name, znode_t *cwd, cred_t *cr, int flags)
  * We use 0 for '.', and 1 for '..'.  If this is the root of the filesystem,
  * we use the offset 2 for the '.zfs' directory.
  */
+
+/*
+ * Number of directory entries past the ones just returned by readdir for
+ * which the dnodes are prefetched.  Sequential scans of wide directories
+ * (archivers, backup software) touch every file exactly once, so the
+ * per-dnode prefetch streams never warm up; reading ahead in the ZAP and
+ * starting the dnode reads early hides that latency.  Zero disables the
+ * read-ahead.
+ */
+static int zfs_readdir_dnode_prefetch_limit = 64;
+
 /* ARGSUSED */
 static int
 zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
@@ -2673,6 +2688,34 @@ zfs_readdir(vnode_t *vp, uio_t *uio, cred_t *cr, int *eofp,
 			KASSERT(ncooks >= 0, ("ncookies=%d", ncooks));
 		}
 	}
+
+	/*
+	 * Walk the ZAP a bounded distance past the entries we just
+	 * returned and start reads of the meta-dnode blocks holding the
+	 * dnodes of the upcoming entries.  By the time the caller comes
+	 * back to stat or open them, their dnodes are already in the ARC.
+	 * This is asynchronous and does not hold any dnodes, so it adds
+	 * no synchronous reads to the readdir itself.
+	 */
+	if (prefetch && *eofp == 0 && zfs_readdir_dnode_prefetch_limit > 0) {
+		zap_cursor_t pzc;
+		int ahead;
+
+		if (offset <= 3)
+			zap_cursor_init(&pzc, os, zp->z_id);
+		else
+			zap_cursor_init_serialized(&pzc, os, zp->z_id, offset);
+		for (ahead = 0; ahead < zfs_readdir_dnode_prefetch_limit &&
+		    zap_cursor_retrieve(&pzc, &zap) == 0; ahead++) {
+			if (zap.za_integer_length == 8 &&
+			    zap.za_num_integers == 1)
+				dmu_prefetch(os,
+				    ZFS_DIRENT_OBJ(zap.za_first_integer),
+				    0, 0, 0, ZIO_PRIORITY_ASYNC_READ);
+			zap_cursor_advance(&pzc);
+		}
+		zap_cursor_fini(&pzc);
+	}
 	zp->z_zn_prefetch = B_FALSE; /* a lookup will re-enable pre-fetching */
 
 	/* Subtract unused cookies */
@@ -6627,3 +6670,7 @@ struct vop_vector zfs_shareops = {
 	.vop_pathconf =		zfs_freebsd_pathconf,
 };
 VFS_VOP_VECTOR_REGISTER(zfs_shareops);
+
+ZFS_MODULE_PARAM(zfs, zfs_, readdir_dnode_prefetch_limit, INT, ZMOD_RW,
+	"Number of upcoming directory entries to prefetch dnodes for "
+	"during readdir");
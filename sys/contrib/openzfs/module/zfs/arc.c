@@ -361,6 +361,14 @@ int zfs_arc_eviction_pct = 200;
  */
 int zfs_arc_evict_batch_limit = 10;
 
+/*
+ * The number of taskq threads used to scan ARC state sublists in
+ * parallel during eviction.  With a value of 0 or 1 all scanning is
+ * done by the arc_evict thread itself.  The thread pool is sized when
+ * the module is loaded.
+ */
+int zfs_arc_evict_threads = 0;
+
 /* number of seconds before growing cache again */
 int arc_grow_retry = 5;
 
@@ -697,6 +705,7 @@ hrtime_t arc_growtime;
 list_t arc_prune_list;
 kmutex_t arc_prune_mtx;
 taskq_t *arc_prune_taskq;
+static taskq_t *arc_evict_taskq;
 
 #define	GHOST_STATE(state)	\
 	((state) == arc_mru_ghost || (state) == arc_mfu_ghost ||	\
@@ -4066,6 +4075,25 @@ arc_evict_state_impl(multilist_t *ml, int idx, arc_buf_hdr_t *marker,
 	return (bytes_evicted);
 }
 
+typedef struct evict_arg {
+	taskq_ent_t	eva_tqent;
+	multilist_t	*eva_ml;
+	arc_buf_hdr_t	*eva_marker;
+	int		eva_idx;
+	uint64_t	eva_spa;
+	int64_t		eva_bytes;
+	uint64_t	eva_evicted;
+} evict_arg_t;
+
+static void
+arc_evict_task(void *arg)
+{
+	evict_arg_t *eva = arg;
+
+	eva->eva_evicted = arc_evict_state_impl(eva->eva_ml, eva->eva_idx,
+	    eva->eva_marker, eva->eva_spa, eva->eva_bytes);
+}
+
 /*
  * Evict buffers from the given arc state, until we've removed the
  * specified number of bytes. Move the removed buffers to the
@@ -4087,10 +4115,15 @@ arc_evict_state(arc_state_t *state, uint64_t spa, int64_t bytes,
 	multilist_t *ml = state->arcs_list[type];
 	int num_sublists;
 	arc_buf_hdr_t **markers;
+	evict_arg_t *evarg = NULL;
+	boolean_t usetskq;
 
 	IMPLY(bytes < 0, bytes == ARC_EVICT_ALL);
 
 	num_sublists = multilist_get_num_sublists(ml);
+	usetskq = (arc_evict_taskq != NULL && num_sublists > 1);
+	if (usetskq)
+		evarg = kmem_zalloc(sizeof (*evarg) * num_sublists, KM_SLEEP);
 
 	/*
 	 * If we've tried to evict from each sublist, made some
@@ -4143,7 +4176,47 @@ arc_evict_state(arc_state_t *state, uint64_t spa, int64_t bytes,
 		 * sublists. Always starting at the same sublist
 		 * (e.g. index 0) would cause evictions to favor certain
 		 * sublists over others.
+		 *
+		 * When the eviction taskq is available, scan every
+		 * sublist concurrently, giving each task an even share
+		 * of the remaining byte target; otherwise walk the
+		 * sublists one at a time.
 		 */
+		if (usetskq) {
+			uint64_t bytes_remaining;
+
+			if (bytes == ARC_EVICT_ALL)
+				bytes_remaining = ARC_EVICT_ALL;
+			else
+				bytes_remaining = bytes - total_evicted;
+
+			for (int i = 0; i < num_sublists; i++) {
+				evarg[i].eva_ml = ml;
+				evarg[i].eva_idx = sublist_idx;
+				evarg[i].eva_marker = markers[sublist_idx];
+				evarg[i].eva_spa = spa;
+				evarg[i].eva_bytes =
+				    bytes == ARC_EVICT_ALL ? ARC_EVICT_ALL :
+				    MAX(bytes_remaining / num_sublists, 1);
+				evarg[i].eva_evicted = 0;
+				taskq_init_ent(&evarg[i].eva_tqent);
+				taskq_dispatch_ent(arc_evict_taskq,
+				    arc_evict_task, &evarg[i], 0,
+				    &evarg[i].eva_tqent);
+
+				/*
+				 * We've reached the end, wrap to the
+				 * beginning.
+				 */
+				if (++sublist_idx >= num_sublists)
+					sublist_idx = 0;
+			}
+			taskq_wait(arc_evict_taskq);
+			for (int i = 0; i < num_sublists; i++) {
+				scan_evicted += evarg[i].eva_evicted;
+				total_evicted += evarg[i].eva_evicted;
+			}
+		} else
 		for (int i = 0; i < num_sublists; i++) {
 			uint64_t bytes_remaining;
 			uint64_t bytes_evicted;
@@ -4198,6 +4271,8 @@ arc_evict_state(arc_state_t *state, uint64_t spa, int64_t bytes,
 		kmem_cache_free(hdr_full_cache, markers[i]);
 	}
 	kmem_free(markers, sizeof (*markers) * num_sublists);
+	if (evarg != NULL)
+		kmem_free(evarg, sizeof (*evarg) * num_sublists);
 
 	return (total_evicted);
 }
@@ -7500,6 +7575,13 @@ arc_init(void)
 	arc_prune_taskq = taskq_create("arc_prune", boot_ncpus, defclsyspri,
 	    boot_ncpus, INT_MAX, TASKQ_PREPOPULATE | TASKQ_DYNAMIC);
 
+	if (zfs_arc_evict_threads > 1) {
+		arc_evict_taskq = taskq_create("arc_evict",
+		    MIN(zfs_arc_evict_threads, boot_ncpus), defclsyspri,
+		    MIN(zfs_arc_evict_threads, boot_ncpus), INT_MAX,
+		    TASKQ_PREPOPULATE);
+	}
+
 	arc_ksp = kstat_create("zfs", 0, "arcstats", "misc", KSTAT_TYPE_NAMED,
 	    sizeof (arc_stats) / sizeof (kstat_named_t), KSTAT_FLAG_VIRTUAL);
 
@@ -7559,6 +7641,12 @@ arc_fini(void)
 		arc_ksp = NULL;
 	}
 
+	if (arc_evict_taskq != NULL) {
+		taskq_wait(arc_evict_taskq);
+		taskq_destroy(arc_evict_taskq);
+		arc_evict_taskq = NULL;
+	}
+
 	taskq_wait(arc_prune_taskq);
 	taskq_destroy(arc_prune_taskq);
 
@@ -10580,4 +10668,8 @@ ZFS_MODULE_PARAM(zfs_arc, zfs_arc_, dnode_reduce_percent, ULONG, ZMOD_RW,
 
 ZFS_MODULE_PARAM(zfs_arc, zfs_arc_, eviction_pct, INT, ZMOD_RW,
        "When full, ARC allocation waits for eviction of this % of alloc size");
+
+ZFS_MODULE_PARAM(zfs_arc, zfs_arc_, evict_threads, INT, ZMOD_RW,
+	"Threads used to scan state sublists in parallel during eviction "
+	"(0 or 1 disables, applied when the module is loaded)");
 /* END CSTYLED */
@@ -787,6 +787,7 @@ void
 dbuf_init(void)
 {
 	uint64_t hsize = 1ULL << 16;
+	uint64_t hmsize;
 	dbuf_hash_table_t *h = &dbuf_hash_table;
 	int i;
 
@@ -821,8 +822,25 @@ retry:
 	    sizeof (dmu_buf_impl_t),
 	    0, dbuf_cons, dbuf_dest, NULL, NULL, NULL, 0);
 
-	for (i = 0; i < DBUF_MUTEXES; i++)
-		mutex_init(&h->hash_mutexes[i], NULL, MUTEX_DEFAULT, NULL);
+	/*
+	 * The hash mutex array scales with the hash table so that lock
+	 * contention stays roughly constant as memory sizes grow: one
+	 * mutex per 128 buckets, between 8192 and 128K mutexes.  The
+	 * mutexes are cache-line aligned, so the array is allocated
+	 * along with the table rather than embedded in it.
+	 */
+	hmsize = MIN(MAX(hsize >> 7, 1ULL << 13), 1ULL << 17);
+	h->hash_mutex_mask = hmsize - 1;
+#if defined(_KERNEL)
+	h->hash_mutexes = vmem_zalloc(hmsize * sizeof (dbuf_hash_mutex_t),
+	    KM_SLEEP);
+#else
+	h->hash_mutexes = kmem_zalloc(hmsize * sizeof (dbuf_hash_mutex_t),
+	    KM_SLEEP);
+#endif
+	for (uint64_t m = 0; m < hmsize; m++)
+		mutex_init(&h->hash_mutexes[m].dbhm_mtx, NULL, MUTEX_DEFAULT,
+		    NULL);
 
 	dbuf_stats_init(h);
 
@@ -870,20 +888,23 @@ void
 dbuf_fini(void)
 {
 	dbuf_hash_table_t *h = &dbuf_hash_table;
-	int i;
 
 	dbuf_stats_destroy();
 
-	for (i = 0; i < DBUF_MUTEXES; i++)
-		mutex_destroy(&h->hash_mutexes[i]);
+	for (uint64_t m = 0; m <= h->hash_mutex_mask; m++)
+		mutex_destroy(&h->hash_mutexes[m].dbhm_mtx);
 #if defined(_KERNEL)
 	/*
 	 * Large allocations which do not require contiguous pages
 	 * should be using vmem_free() in the linux kernel
 	 */
 	vmem_free(h->hash_table, (h->hash_table_mask + 1) * sizeof (void *));
+	vmem_free(h->hash_mutexes,
+	    (h->hash_mutex_mask + 1) * sizeof (dbuf_hash_mutex_t));
 #else
 	kmem_free(h->hash_table, (h->hash_table_mask + 1) * sizeof (void *));
+	kmem_free(h->hash_mutexes,
+	    (h->hash_mutex_mask + 1) * sizeof (dbuf_hash_mutex_t));
 #endif
 	kmem_cache_destroy(dbuf_kmem_cache);
 	taskq_destroy(dbu_evict_taskq);
@@ -40,12 +40,39 @@
 
 static kmem_cache_t *ddt_cache;
 static kmem_cache_t *ddt_entry_cache;
+static kmem_cache_t *ddt_cache_entry_cache;
 
 /*
  * Enable/disable prefetching of dedup-ed blocks which are going to be freed.
  */
 int zfs_dedup_prefetch = 0;
 
+/*
+ * The lookup cache keeps a copy of each DDT entry as it is written out
+ * during sync, so that a later write of the same data does not pay a
+ * random read into the DDT ZAPs to load an entry this pool only just
+ * wrote.  The DDT objects are modified exclusively from syncing context,
+ * and the copy is refreshed (or dropped) every time the entry syncs, so
+ * a cached copy is always identical to the on-disk entry.  The cache is
+ * bounded by zfs_dedup_cache_max_bytes per pool and its memory is
+ * accounted against the ARC metadata limits; setting the tunable to 0
+ * disables it.
+ */
+unsigned long zfs_dedup_cache_max_bytes = 32 << 20;
+
+typedef struct ddt_cache_entry {
+	ddt_key_t	ddce_key;
+	ddt_phys_t	ddce_phys[DDT_PHYS_TYPES];
+	enum ddt_type	ddce_type;
+	enum ddt_class	ddce_class;
+	avl_node_t	ddce_node;
+	list_node_t	ddce_lru;
+} ddt_cache_entry_t;
+
+static ddt_cache_entry_t *ddt_cache_lookup(ddt_t *ddt, const ddt_key_t *ddk);
+static void ddt_cache_update(ddt_t *ddt, const ddt_entry_t *dde);
+static void ddt_cache_remove(ddt_t *ddt, const ddt_key_t *ddk);
+
 static const ddt_ops_t *ddt_ops[DDT_TYPES] = {
 	&ddt_zap_ops,
 };
@@ -619,11 +646,14 @@ ddt_init(void)
 	    sizeof (ddt_t), 0, NULL, NULL, NULL, NULL, NULL, 0);
 	ddt_entry_cache = kmem_cache_create("ddt_entry_cache",
 	    sizeof (ddt_entry_t), 0, NULL, NULL, NULL, NULL, NULL, 0);
+	ddt_cache_entry_cache = kmem_cache_create("ddt_cache_entry_cache",
+	    sizeof (ddt_cache_entry_t), 0, NULL, NULL, NULL, NULL, NULL, 0);
 }
 
 void
 ddt_fini(void)
 {
+	kmem_cache_destroy(ddt_cache_entry_cache);
 	kmem_cache_destroy(ddt_entry_cache);
 	kmem_cache_destroy(ddt_cache);
 }
@@ -693,6 +723,21 @@ ddt_lookup(ddt_t *ddt, const blkptr_t *bp, boolean_t add)
 	if (dde->dde_loaded)
 		return (dde);
 
+	/*
+	 * If a copy of this entry was kept when it was last synced, use
+	 * it instead of reading the entry back from the DDT objects.
+	 */
+	ddt_cache_entry_t *ddce = ddt_cache_lookup(ddt, &dde->dde_key);
+	if (ddce != NULL) {
+		bcopy(ddce->ddce_phys, dde->dde_phys,
+		    sizeof (dde->dde_phys));
+		dde->dde_type = ddce->ddce_type;
+		dde->dde_class = ddce->ddce_class;
+		dde->dde_loaded = B_TRUE;
+		ddt_stat_update(ddt, dde, -1ULL);
+		return (dde);
+	}
+
 	dde->dde_loading = B_TRUE;
 
 	ddt_exit(ddt);
@@ -780,6 +825,95 @@ ddt_entry_compare(const void *x1, const void *x2)
 	return (TREE_ISIGN(cmp));
 }
 
+static int
+ddt_cache_entry_compare(const void *x1, const void *x2)
+{
+	const ddt_cache_entry_t *e1 = x1;
+	const ddt_cache_entry_t *e2 = x2;
+	const ddt_key_cmp_t *k1 = (const ddt_key_cmp_t *)&e1->ddce_key;
+	const ddt_key_cmp_t *k2 = (const ddt_key_cmp_t *)&e2->ddce_key;
+	int32_t cmp = 0;
+
+	for (int i = 0; i < DDT_KEY_CMP_LEN; i++) {
+		cmp = (int32_t)k1->u16[i] - (int32_t)k2->u16[i];
+		if (likely(cmp))
+			break;
+	}
+
+	return (TREE_ISIGN(cmp));
+}
+
+static void
+ddt_cache_free_entry(ddt_t *ddt, ddt_cache_entry_t *ddce)
+{
+	avl_remove(&ddt->ddt_lookup_cache, ddce);
+	list_remove(&ddt->ddt_lookup_lru, ddce);
+	kmem_cache_free(ddt_cache_entry_cache, ddce);
+	arc_space_return(sizeof (ddt_cache_entry_t), ARC_SPACE_META);
+	ddt->ddt_lookup_cache_count--;
+}
+
+static ddt_cache_entry_t *
+ddt_cache_lookup(ddt_t *ddt, const ddt_key_t *ddk)
+{
+	ddt_cache_entry_t *ddce, srch;
+
+	ASSERT(MUTEX_HELD(&ddt->ddt_lock));
+
+	srch.ddce_key = *ddk;
+	ddce = avl_find(&ddt->ddt_lookup_cache, &srch, NULL);
+	if (ddce != NULL) {
+		list_remove(&ddt->ddt_lookup_lru, ddce);
+		list_insert_head(&ddt->ddt_lookup_lru, ddce);
+	}
+	return (ddce);
+}
+
+static void
+ddt_cache_update(ddt_t *ddt, const ddt_entry_t *dde)
+{
+	uint64_t limit = zfs_dedup_cache_max_bytes /
+	    sizeof (ddt_cache_entry_t);
+	ddt_cache_entry_t *ddce, srch;
+	avl_index_t where;
+
+	ASSERT(MUTEX_HELD(&ddt->ddt_lock));
+
+	srch.ddce_key = dde->dde_key;
+	ddce = avl_find(&ddt->ddt_lookup_cache, &srch, &where);
+	if (ddce == NULL) {
+		if (limit == 0)
+			return;
+		ddce = kmem_cache_alloc(ddt_cache_entry_cache, KM_SLEEP);
+		ddce->ddce_key = dde->dde_key;
+		avl_insert(&ddt->ddt_lookup_cache, ddce, where);
+		arc_space_consume(sizeof (ddt_cache_entry_t), ARC_SPACE_META);
+		ddt->ddt_lookup_cache_count++;
+	} else {
+		list_remove(&ddt->ddt_lookup_lru, ddce);
+	}
+	bcopy(dde->dde_phys, ddce->ddce_phys, sizeof (ddce->ddce_phys));
+	ddce->ddce_type = dde->dde_type;
+	ddce->ddce_class = dde->dde_class;
+	list_insert_head(&ddt->ddt_lookup_lru, ddce);
+
+	while (ddt->ddt_lookup_cache_count > limit)
+		ddt_cache_free_entry(ddt, list_tail(&ddt->ddt_lookup_lru));
+}
+
+static void
+ddt_cache_remove(ddt_t *ddt, const ddt_key_t *ddk)
+{
+	ddt_cache_entry_t *ddce, srch;
+
+	ASSERT(MUTEX_HELD(&ddt->ddt_lock));
+
+	srch.ddce_key = *ddk;
+	ddce = avl_find(&ddt->ddt_lookup_cache, &srch, NULL);
+	if (ddce != NULL)
+		ddt_cache_free_entry(ddt, ddce);
+}
+
 static ddt_t *
 ddt_table_alloc(spa_t *spa, enum zio_checksum c)
 {
@@ -793,6 +927,11 @@ ddt_table_alloc(spa_t *spa, enum zio_checksum c)
 	    sizeof (ddt_entry_t), offsetof(ddt_entry_t, dde_node));
 	avl_create(&ddt->ddt_repair_tree, ddt_entry_compare,
 	    sizeof (ddt_entry_t), offsetof(ddt_entry_t, dde_node));
+	avl_create(&ddt->ddt_lookup_cache, ddt_cache_entry_compare,
+	    sizeof (ddt_cache_entry_t), offsetof(ddt_cache_entry_t,
+	    ddce_node));
+	list_create(&ddt->ddt_lookup_lru, sizeof (ddt_cache_entry_t),
+	    offsetof(ddt_cache_entry_t, ddce_lru));
 	ddt->ddt_checksum = c;
 	ddt->ddt_spa = spa;
 	ddt->ddt_os = spa->spa_meta_objset;
@@ -803,10 +942,17 @@ ddt_table_alloc(spa_t *spa, enum zio_checksum c)
 static void
 ddt_table_free(ddt_t *ddt)
 {
+	ddt_cache_entry_t *ddce;
+
 	ASSERT(avl_numnodes(&ddt->ddt_tree) == 0);
 	ASSERT(avl_numnodes(&ddt->ddt_repair_tree) == 0);
+	while ((ddce = list_head(&ddt->ddt_lookup_lru)) != NULL)
+		ddt_cache_free_entry(ddt, ddce);
+	ASSERT0(ddt->ddt_lookup_cache_count);
 	avl_destroy(&ddt->ddt_tree);
 	avl_destroy(&ddt->ddt_repair_tree);
+	avl_destroy(&ddt->ddt_lookup_cache);
+	list_destroy(&ddt->ddt_lookup_lru);
 	mutex_destroy(&ddt->ddt_lock);
 	kmem_cache_free(ddt_cache, ddt);
 }
@@ -1068,6 +1214,18 @@ ddt_sync_entry(ddt_t *ddt, ddt_entry_t *dde, dmu_tx_t *tx, uint64_t txg)
 			    ddt->ddt_checksum, dde, tx);
 		}
 	}
+
+	/*
+	 * What we just wrote (or removed) is now the authoritative
+	 * on-disk state; refresh the lookup cache to match so future
+	 * lookups of this key can skip the DDT objects.
+	 */
+	ddt_enter(ddt);
+	if (total_refcnt != 0)
+		ddt_cache_update(ddt, dde);
+	else
+		ddt_cache_remove(ddt, ddk);
+	ddt_exit(ddt);
 }
 
 static void
@@ -1182,6 +1340,9 @@ ddt_walk(spa_t *spa, ddt_bookmark_t *ddb, ddt_entry_t *dde)
 }
 
 /* BEGIN CSTYLED */
+ZFS_MODULE_PARAM(zfs_dedup, zfs_dedup_, cache_max_bytes, ULONG, ZMOD_RW,
+	"Max memory per pool for caching recently synced DDT entries");
+
 ZFS_MODULE_PARAM(zfs_dedup, zfs_dedup_, prefetch, INT, ZMOD_RW,
 	"Enable prefetching dedup-ed blks");
 /* END CSTYLED */
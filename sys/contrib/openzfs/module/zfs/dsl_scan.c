@@ -151,6 +151,16 @@ int zfs_scan_issue_strategy = 0;
 int zfs_scan_legacy = B_FALSE; /* don't queue & sort zios, go direct */
 unsigned long zfs_scan_max_ext_gap = 2 << 20; /* in bytes */
 
+/*
+ * When emptying a queue in size order, an extent that begins within this
+ * many bytes of the end of the extent just issued is issued next, ahead
+ * of the best remaining extent by size.  Continuing the sweep costs at
+ * most a short seek and keeps the disk streaming, where seeking to the
+ * next-largest extent could be a full-stroke seek.  Set to 0 to always
+ * seek to the best extent by size.
+ */
+unsigned long zfs_scan_run_max_gap = 16 << 20; /* in bytes */
+
 /*
  * fill_weight is non-tunable at runtime, so we copy it at module init from
  * zfs_scan_fill_weight. Runtime adjustments to zfs_scan_fill_weight would
@@ -3001,6 +3011,31 @@ scan_io_queue_fetch_ext(dsl_scan_io_queue_t *queue)
 	}
 }
 
+/*
+ * Selects the next extent to issue, preferring to extend the run the
+ * queue is already sweeping: if an extent begins within
+ * zfs_scan_run_max_gap of the end of the last extent issued (run_end),
+ * it is returned instead of the best remaining extent by size.  This
+ * merges nearby extents into long sequential runs at issue time,
+ * instead of paying a seek per extent.
+ */
+static range_seg_t *
+scan_io_queue_next_ext(dsl_scan_io_queue_t *queue, uint64_t run_end)
+{
+	range_tree_t *rt = queue->q_exts_by_addr;
+	uint64_t start, size;
+
+	ASSERT(MUTEX_HELD(&queue->q_vd->vdev_scan_io_queue_lock));
+
+	if (zfs_scan_run_max_gap != 0 && run_end != 0 &&
+	    (queue->q_scn->scn_checkpointing || queue->q_scn->scn_clearing) &&
+	    range_tree_find_in(rt, run_end, zfs_scan_run_max_gap,
+	    &start, &size))
+		return (range_tree_find(rt, start, size));
+
+	return (scan_io_queue_fetch_ext(queue));
+}
+
 static void
 scan_io_queues_run_one(void *arg)
 {
@@ -3012,6 +3047,7 @@ scan_io_queues_run_one(void *arg)
 	list_t sio_list;
 	uint64_t bytes_per_leaf = zfs_scan_vdev_limit;
 	uint64_t nr_leaves = dsl_scan_count_leaves(queue->q_vd);
+	uint64_t run_end = 0;
 
 	ASSERT(queue->q_scn->scn_is_sorted);
 
@@ -3030,7 +3066,7 @@ scan_io_queues_run_one(void *arg)
 	queue->q_zios_this_txg = 0;
 
 	/* loop until we run out of time or sios */
-	while ((rs = scan_io_queue_fetch_ext(queue)) != NULL) {
+	while ((rs = scan_io_queue_next_ext(queue, run_end)) != NULL) {
 		uint64_t seg_start = 0, seg_end = 0;
 		boolean_t more_left = B_TRUE;
 
@@ -3070,6 +3106,7 @@ scan_io_queues_run_one(void *arg)
 
 		/* update statistics for debugging purposes */
 		scan_io_queues_update_seg_stats(queue, seg_start, seg_end);
+		run_end = seg_end;
 
 		if (suspended)
 			break;
@@ -4412,6 +4449,9 @@ ZFS_MODULE_PARAM(zfs, zfs_, scan_checkpoint_intval, INT, ZMOD_RW,
 ZFS_MODULE_PARAM(zfs, zfs_, scan_max_ext_gap, ULONG, ZMOD_RW,
 	"Max gap in bytes between sequential scrub / resilver I/Os");
 
+ZFS_MODULE_PARAM(zfs, zfs_, scan_run_max_gap, ULONG, ZMOD_RW,
+	"Max gap in bytes an issue run may skip to reach the next extent");
+
 ZFS_MODULE_PARAM(zfs, zfs_, scan_mem_lim_soft_fact, INT, ZMOD_RW,
 	"Fraction of hard limit used as soft limit");
 
@@ -9070,7 +9070,9 @@ spa_sync(spa_t *spa, uint64_t txg)
 
 	spa_sync_condense_indirect(spa, tx);
 
+	hrtime_t iterate_start = gethrtime();
 	spa_sync_iterate_to_convergence(spa, tx);
+	hrtime_t iterate_done = gethrtime();
 
 #ifdef ZFS_DEBUG
 	if (!list_is_empty(&spa->spa_config_dirty_list)) {
@@ -9095,6 +9097,7 @@ spa_sync(spa_t *spa, uint64_t txg)
 
 	spa_sync_rewrite_vdev_config(spa, tx);
 	dmu_tx_commit(tx);
+	hrtime_t config_done = gethrtime();
 
 	taskq_cancel_id(system_delay_taskq, spa->spa_deadman_tqid);
 	spa->spa_deadman_tqid = 0;
@@ -9159,6 +9162,15 @@ spa_sync(spa_t *spa, uint64_t txg)
 	spa->spa_ubsync = spa->spa_uberblock;
 	spa_config_exit(spa, SCL_CONFIG, FTAG);
 
+	/*
+	 * Break the syncing time down by phase so a slow txg can be
+	 * attributed to dirty-data convergence, the vdev config and label
+	 * rewrite, or the post-sync cleanup above.
+	 */
+	(void) spa_txg_history_set_sync_phases(spa, txg,
+	    iterate_done - iterate_start, config_done - iterate_done,
+	    gethrtime() - config_done);
+
 	spa_handle_ignored_writes(spa);
 
 	/*
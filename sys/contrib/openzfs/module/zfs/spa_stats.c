@@ -204,6 +204,9 @@ typedef struct spa_txg_history {
 	uint64_t	writes;		/* number of write operations */
 	uint64_t	ndirty;		/* number of dirty bytes */
 	hrtime_t	times[TXG_STATE_COMMITTED]; /* completion times */
+	hrtime_t	sync_iterate;	/* ns iterating to convergence */
+	hrtime_t	sync_config;	/* ns rewriting vdev config */
+	hrtime_t	sync_done;	/* ns in post-sync cleanup */
 	procfs_list_node_t	sth_node;
 } spa_txg_history_t;
 
@@ -211,9 +214,11 @@ static int
 spa_txg_history_show_header(struct seq_file *f)
 {
 	seq_printf(f, "%-8s %-16s %-5s %-12s %-12s %-12s "
-	    "%-8s %-8s %-12s %-12s %-12s %-12s\n", "txg", "birth", "state",
+	    "%-8s %-8s %-12s %-12s %-12s %-12s %-12s %-12s %-12s\n",
+	    "txg", "birth", "state",
 	    "ndirty", "nread", "nwritten", "reads", "writes",
-	    "otime", "qtime", "wtime", "stime");
+	    "otime", "qtime", "wtime", "stime",
+	    "itime", "vtime", "dtime");
 	return (0);
 }
 
@@ -251,13 +256,15 @@ spa_txg_history_show(struct seq_file *f, void *data)
 		    sth->times[TXG_STATE_WAIT_FOR_SYNC];
 
 	seq_printf(f, "%-8llu %-16llu %-5c %-12llu "
-	    "%-12llu %-12llu %-8llu %-8llu %-12llu %-12llu %-12llu %-12llu\n",
+	    "%-12llu %-12llu %-8llu %-8llu %-12llu %-12llu %-12llu %-12llu "
+	    "%-12llu %-12llu %-12llu\n",
 	    (longlong_t)sth->txg, sth->times[TXG_STATE_BIRTH], state,
 	    (u_longlong_t)sth->ndirty,
 	    (u_longlong_t)sth->nread, (u_longlong_t)sth->nwritten,
 	    (u_longlong_t)sth->reads, (u_longlong_t)sth->writes,
 	    (u_longlong_t)open, (u_longlong_t)quiesce, (u_longlong_t)wait,
-	    (u_longlong_t)sync);
+	    (u_longlong_t)sync, (u_longlong_t)sth->sync_iterate,
+	    (u_longlong_t)sth->sync_config, (u_longlong_t)sth->sync_done);
 
 	return (0);
 }
@@ -406,6 +413,39 @@ spa_txg_history_set_io(spa_t *spa, uint64_t txg, uint64_t nread,
 	return (error);
 }
 
+/*
+ * Record how the syncing time of a txg was spent inside spa_sync(): iterating
+ * dirty data to convergence, rewriting the vdev config and labels, and the
+ * post-sync cleanup. These break the "stime" column down so it is visible
+ * which phase a slow txg spent its time in.
+ */
+int
+spa_txg_history_set_sync_phases(spa_t *spa, uint64_t txg, hrtime_t iterate_ns,
+    hrtime_t config_ns, hrtime_t done_ns)
+{
+	spa_history_list_t *shl = &spa->spa_stats.txg_history;
+	spa_txg_history_t *sth;
+	int error = ENOENT;
+
+	if (zfs_txg_history == 0)
+		return (0);
+
+	mutex_enter(&shl->procfs_list.pl_lock);
+	for (sth = list_tail(&shl->procfs_list.pl_list); sth != NULL;
+	    sth = list_prev(&shl->procfs_list.pl_list, sth)) {
+		if (sth->txg == txg) {
+			sth->sync_iterate = iterate_ns;
+			sth->sync_config = config_ns;
+			sth->sync_done = done_ns;
+			error = 0;
+			break;
+		}
+	}
+	mutex_exit(&shl->procfs_list.pl_lock);
+
+	return (error);
+}
+
 txg_stat_t *
 spa_txg_history_init_io(spa_t *spa, uint64_t txg, dsl_pool_t *dp)
 {
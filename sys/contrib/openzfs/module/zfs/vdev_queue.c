@@ -126,6 +126,20 @@
  */
 uint32_t zfs_vdev_max_active = 1000;
 
+/*
+ * When zfs_vdev_latency_target_us is non-zero, each vdev floats its own
+ * aggregate active I/O limit between zfs_vdev_adaptive_min_active and
+ * zfs_vdev_max_active so that the smoothed device access time stays
+ * near the target: the limit is cut by 1/8 while the device is over
+ * target and grown by one while it is comfortably under it.  Every
+ * vdev adapts independently, so the slow and fast vdevs of a mixed
+ * pool settle at different queue depths while the per-class ratios
+ * below still apply within each vdev's limit.  Zero keeps the static
+ * limits.
+ */
+uint32_t zfs_vdev_latency_target_us = 0;
+uint32_t zfs_vdev_adaptive_min_active = 10;
+
 /*
  * Per-queue limits on the number of i/os active to each device.  If the
  * number of active i/os is < zfs_vdev_max_active, then the min_active comes
@@ -373,8 +387,12 @@ vdev_queue_class_to_issue(vdev_queue_t *vq)
 {
 	spa_t *spa = vq->vq_vdev->vdev_spa;
 	zio_priority_t p;
+	uint32_t max_active;
 
-	if (avl_numnodes(&vq->vq_active_tree) >= zfs_vdev_max_active)
+	max_active = zfs_vdev_max_active;
+	if (zfs_vdev_latency_target_us != 0 && vq->vq_max_active != 0)
+		max_active = MIN(max_active, vq->vq_max_active);
+	if (avl_numnodes(&vq->vq_active_tree) >= max_active)
 		return (ZIO_PRIORITY_NUM_QUEUEABLE);
 
 	/* find a queue that has not reached its minimum # outstanding i/os */
@@ -408,6 +426,9 @@ vdev_queue_init(vdev_t *vd)
 
 	mutex_init(&vq->vq_lock, NULL, MUTEX_DEFAULT, NULL);
 	vq->vq_vdev = vd;
+	vq->vq_max_active = zfs_vdev_max_active;
+	vq->vq_lat_ewma = 0;
+	vq->vq_last_adjust = 0;
 	taskq_init_ent(&vd->vdev_queue.vq_io_search.io_tqent);
 
 	avl_create(&vq->vq_active_tree, vdev_queue_offset_compare,
@@ -511,6 +532,44 @@ vdev_queue_pending_add(vdev_queue_t *vq, zio_t *zio)
 	}
 }
 
+/*
+ * Track the smoothed device access time of the vdev and steer its
+ * aggregate active I/O limit toward zfs_vdev_latency_target_us:
+ * multiplicative decrease while the device is over the target,
+ * additive increase while it is comfortably under it.  Called on each
+ * leaf I/O completion with the queue lock held; delay is the device
+ * access time of the completed I/O.
+ */
+static void
+vdev_queue_adapt(vdev_queue_t *vq, hrtime_t delay)
+{
+	hrtime_t target = (hrtime_t)zfs_vdev_latency_target_us * 1000;
+	uint32_t limit;
+
+	ASSERT(MUTEX_HELD(&vq->vq_lock));
+
+	vq->vq_lat_ewma += (delay - vq->vq_lat_ewma) / 8;
+
+	/*
+	 * Adjust at most once per 10ms so that several completions at
+	 * the new limit are observed before the next step.
+	 */
+	if (vq->vq_io_complete_ts - vq->vq_last_adjust < MSEC2NSEC(10))
+		return;
+	vq->vq_last_adjust = vq->vq_io_complete_ts;
+
+	limit = vq->vq_max_active;
+	if (limit == 0 || limit > zfs_vdev_max_active)
+		limit = zfs_vdev_max_active;
+	if (vq->vq_lat_ewma > target)
+		limit -= MAX(limit / 8, 1);
+	else if (vq->vq_lat_ewma < target - target / 4)
+		limit += 1;
+	limit = MAX(limit, zfs_vdev_adaptive_min_active);
+	limit = MIN(limit, zfs_vdev_max_active);
+	vq->vq_max_active = limit;
+}
+
 static void
 vdev_queue_pending_remove(vdev_queue_t *vq, zio_t *zio)
 {
@@ -903,6 +962,9 @@ vdev_queue_io_done(zio_t *zio)
 	vq->vq_io_complete_ts = gethrtime();
 	vq->vq_io_delta_ts = vq->vq_io_complete_ts - zio->io_timestamp;
 
+	if (zfs_vdev_latency_target_us != 0 && zio->io_delay != 0)
+		vdev_queue_adapt(vq, zio->io_delay);
+
 	while ((nio = vdev_queue_io_to_issue(vq)) != NULL) {
 		mutex_exit(&vq->vq_lock);
 		if (nio->io_done == vdev_queue_agg_io_done) {
@@ -1005,6 +1067,13 @@ ZFS_MODULE_PARAM(zfs_vdev, zfs_vdev_, write_gap_limit, INT, ZMOD_RW,
 ZFS_MODULE_PARAM(zfs_vdev, zfs_vdev_, max_active, INT, ZMOD_RW,
 	"Maximum number of active I/Os per vdev");
 
+ZFS_MODULE_PARAM(zfs_vdev, zfs_vdev_, latency_target_us, UINT, ZMOD_RW,
+	"Device access time target for the adaptive per-vdev active I/O "
+	"limit (us, 0 disables)");
+
+ZFS_MODULE_PARAM(zfs_vdev, zfs_vdev_, adaptive_min_active, UINT, ZMOD_RW,
+	"Floor of the adaptive per-vdev active I/O limit");
+
 ZFS_MODULE_PARAM(zfs_vdev, zfs_vdev_, async_write_active_max_dirty_percent, INT, ZMOD_RW,
 	"Async write concurrency max threshold");
 
@@ -2450,6 +2450,21 @@ zil_commit_writer(zilog_t *zilog, zil_commit_waiter_t *zcw)
 	ASSERT(!MUTEX_HELD(&zilog->zl_lock));
 	ASSERT(spa_writeable(zilog->zl_spa));
 
+	/*
+	 * If another thread already committed this waiter to an lwb, there
+	 * is no reason to contend for the issuer lock at all; the locked
+	 * check below would only bail out again. This unlocked read is
+	 * safe because a waiter is only linked to an lwb by a thread
+	 * holding the issuer lock, and reading a stale NULL merely sends
+	 * us through the lock to repeat the same check. This follows the
+	 * same pattern as the pre-lock check in zil_commit_waiter_timeout().
+	 * With many threads performing sync writes, most of them find
+	 * their itx was swept up by the current lock holder and skip the
+	 * convoy on the lock entirely.
+	 */
+	if (zcw->zcw_lwb != NULL || zcw->zcw_done)
+		return;
+
 	mutex_enter(&zilog->zl_issuer_lock);
 
 	if (zcw->zcw_lwb != NULL || zcw->zcw_done) {
@@ -1618,6 +1618,74 @@ zio_write_bp_init(zio_t *zio)
 	return (zio);
 }
 
+/*
+ * Adaptive zstd compression level governor.  When enabled (by setting
+ * zio_compress_adapt_target_us to the acceptable per-block compression
+ * cost), the time spent compressing each zstd block is folded into a
+ * moving average; when the average exceeds the target the effective
+ * level is stepped down from the dataset's configured level, and when
+ * the compressor is comfortably under budget the level is stepped back
+ * up toward the configured value.  The dataset's compress property acts
+ * as the ceiling and zio_compress_adapt_min_level as the floor, so the
+ * governor can only trade some compression ratio for CPU, never disable
+ * compression outright.
+ *
+ * The state is global and updated without locking: the governor is a
+ * heuristic, a lost update just delays an adjustment by one block.
+ */
+static uint_t zio_compress_adapt_target_us = 0;
+static uint_t zio_compress_adapt_min_level = ZIO_ZSTD_LEVEL_1;
+
+static hrtime_t zio_compress_adapt_ewma;
+static hrtime_t zio_compress_adapt_last;
+static uint_t zio_compress_adapt_bias;
+
+static uint8_t
+zio_compress_adapt_level(uint8_t level)
+{
+	uint_t bias = zio_compress_adapt_bias;
+	uint_t floor = MAX(zio_compress_adapt_min_level, ZIO_ZSTD_LEVEL_MIN);
+
+	if (level == ZIO_COMPLEVEL_INHERIT)
+		return (level);
+	if (level == ZIO_COMPLEVEL_DEFAULT)
+		level = ZIO_ZSTD_LEVEL_DEFAULT;
+	/* Leave the negative "fast" levels alone. */
+	if (level > ZIO_ZSTD_LEVEL_MAX)
+		return (level);
+	if (level < floor + bias)
+		return (MIN(level, (uint8_t)floor));
+	return (level - bias);
+}
+
+static void
+zio_compress_adapt_update(hrtime_t elapsed)
+{
+	hrtime_t target = (hrtime_t)zio_compress_adapt_target_us * 1000;
+	hrtime_t now;
+
+	zio_compress_adapt_ewma +=
+	    (elapsed - zio_compress_adapt_ewma) / 8;
+
+	/*
+	 * Move one level at a time, at most once every 10ms, so a burst
+	 * of expensive blocks doesn't slam the level to the floor.
+	 */
+	now = gethrtime();
+	if (now - zio_compress_adapt_last < MSEC2NSEC(10))
+		return;
+	zio_compress_adapt_last = now;
+
+	if (zio_compress_adapt_ewma > target) {
+		if (zio_compress_adapt_bias <
+		    ZIO_ZSTD_LEVEL_MAX - zio_compress_adapt_min_level)
+			zio_compress_adapt_bias++;
+	} else if (zio_compress_adapt_ewma < target - target / 4) {
+		if (zio_compress_adapt_bias > 0)
+			zio_compress_adapt_bias--;
+	}
+}
+
 static zio_t *
 zio_write_compress(zio_t *zio)
 {
@@ -1682,8 +1750,17 @@ zio_write_compress(zio_t *zio)
 	if (compress != ZIO_COMPRESS_OFF &&
 	    !(zio->io_flags & ZIO_FLAG_RAW_COMPRESS)) {
 		void *cbuf = zio_buf_alloc(lsize);
-		psize = zio_compress_data(compress, zio->io_abd, cbuf, lsize,
-		    zp->zp_complevel);
+		if (compress == ZIO_COMPRESS_ZSTD &&
+		    zio_compress_adapt_target_us != 0) {
+			hrtime_t start = gethrtime();
+
+			psize = zio_compress_data(compress, zio->io_abd, cbuf,
+			    lsize, zio_compress_adapt_level(zp->zp_complevel));
+			zio_compress_adapt_update(gethrtime() - start);
+		} else {
+			psize = zio_compress_data(compress, zio->io_abd, cbuf,
+			    lsize, zp->zp_complevel);
+		}
 		if (psize == 0 || psize >= lsize) {
 			compress = ZIO_COMPRESS_OFF;
 			zio_buf_free(cbuf, lsize);
@@ -2063,7 +2140,7 @@ zio_deadman(zio_t *pio, char *tag)
  * There's no locking on io_stage because there's no legitimate way
  * for multiple threads to be attempting to process the same I/O.
  */
-static zio_pipe_stage_t *zio_pipeline[];
+static zio_t *zio_pipeline_stage(zio_t *zio, enum zio_stage stage);
 
 /*
  * zio_execute() is a wrapper around the static function
@@ -2166,7 +2243,7 @@ __zio_execute(zio_t *zio)
 		 * (typically the same as this one), or NULL if we should
 		 * stop.
 		 */
-		zio = zio_pipeline[highbit64(stage) - 1](zio);
+		zio = zio_pipeline_stage(zio, stage);
 
 		if (zio == NULL)
 			return;
@@ -4783,33 +4860,71 @@ zio_done(zio_t *zio)
  * I/O pipeline definition
  * ==========================================================================
  */
-static zio_pipe_stage_t *zio_pipeline[] = {
-	NULL,
-	zio_read_bp_init,
-	zio_write_bp_init,
-	zio_free_bp_init,
-	zio_issue_async,
-	zio_write_compress,
-	zio_encrypt,
-	zio_checksum_generate,
-	zio_nop_write,
-	zio_ddt_read_start,
-	zio_ddt_read_done,
-	zio_ddt_write,
-	zio_ddt_free,
-	zio_gang_assemble,
-	zio_gang_issue,
-	zio_dva_throttle,
-	zio_dva_allocate,
-	zio_dva_free,
-	zio_dva_claim,
-	zio_ready,
-	zio_vdev_io_start,
-	zio_vdev_io_done,
-	zio_vdev_io_assess,
-	zio_checksum_verify,
-	zio_done
-};
+/*
+ * Dispatch a pipeline stage.  This used to be a table of function pointers
+ * indexed by stage number, but the indirect call per stage is measurable at
+ * high IOPS rates: it defeats branch prediction and prevents the compiler
+ * from inlining the cheap stages into the pipeline loop.  A switch on the
+ * stage bit compiles to direct calls, so the common read and write stage
+ * sequences (no raidz, no dedup, no encryption) run fused in __zio_execute()
+ * while the rare stages cost no more than before.
+ */
+static zio_t *
+zio_pipeline_stage(zio_t *zio, enum zio_stage stage)
+{
+	switch (stage) {
+	case ZIO_STAGE_READ_BP_INIT:
+		return (zio_read_bp_init(zio));
+	case ZIO_STAGE_WRITE_BP_INIT:
+		return (zio_write_bp_init(zio));
+	case ZIO_STAGE_FREE_BP_INIT:
+		return (zio_free_bp_init(zio));
+	case ZIO_STAGE_ISSUE_ASYNC:
+		return (zio_issue_async(zio));
+	case ZIO_STAGE_WRITE_COMPRESS:
+		return (zio_write_compress(zio));
+	case ZIO_STAGE_ENCRYPT:
+		return (zio_encrypt(zio));
+	case ZIO_STAGE_CHECKSUM_GENERATE:
+		return (zio_checksum_generate(zio));
+	case ZIO_STAGE_NOP_WRITE:
+		return (zio_nop_write(zio));
+	case ZIO_STAGE_DDT_READ_START:
+		return (zio_ddt_read_start(zio));
+	case ZIO_STAGE_DDT_READ_DONE:
+		return (zio_ddt_read_done(zio));
+	case ZIO_STAGE_DDT_WRITE:
+		return (zio_ddt_write(zio));
+	case ZIO_STAGE_DDT_FREE:
+		return (zio_ddt_free(zio));
+	case ZIO_STAGE_GANG_ASSEMBLE:
+		return (zio_gang_assemble(zio));
+	case ZIO_STAGE_GANG_ISSUE:
+		return (zio_gang_issue(zio));
+	case ZIO_STAGE_DVA_THROTTLE:
+		return (zio_dva_throttle(zio));
+	case ZIO_STAGE_DVA_ALLOCATE:
+		return (zio_dva_allocate(zio));
+	case ZIO_STAGE_DVA_FREE:
+		return (zio_dva_free(zio));
+	case ZIO_STAGE_DVA_CLAIM:
+		return (zio_dva_claim(zio));
+	case ZIO_STAGE_READY:
+		return (zio_ready(zio));
+	case ZIO_STAGE_VDEV_IO_START:
+		return (zio_vdev_io_start(zio));
+	case ZIO_STAGE_VDEV_IO_DONE:
+		return (zio_vdev_io_done(zio));
+	case ZIO_STAGE_VDEV_IO_ASSESS:
+		return (zio_vdev_io_assess(zio));
+	case ZIO_STAGE_CHECKSUM_VERIFY:
+		return (zio_checksum_verify(zio));
+	case ZIO_STAGE_DONE:
+		return (zio_done(zio));
+	default:
+		panic("invalid zio stage %u", stage);
+	}
+}
 
 
 
@@ -4966,4 +5081,10 @@ ZFS_MODULE_PARAM(zfs_zio, zio_, dva_throttle_enabled, INT, ZMOD_RW,
 
 ZFS_MODULE_PARAM(zfs_zio, zio_, deadman_log_all, INT, ZMOD_RW,
 	"Log all slow ZIOs, not just those with vdevs");
+
+ZFS_MODULE_PARAM(zfs_zio, zio_, compress_adapt_target_us, UINT, ZMOD_RW,
+	"Target zstd compression time per block (us), 0 disables adaptation");
+
+ZFS_MODULE_PARAM(zfs_zio, zio_, compress_adapt_min_level, UINT, ZMOD_RW,
+	"Lowest zstd level the adaptive compression governor may use");
 /* END CSTYLED */
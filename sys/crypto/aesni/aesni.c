@@ -66,8 +66,10 @@ __FBSDID("$FreeBSD$");
 #include <machine/fpu.h>
 #endif
 
+#ifdef __i386__
 static struct mtx_padalign *ctx_mtx;
 static struct fpu_kern_ctx **ctx_fpu;
+#endif
 
 struct aesni_softc {
 	int32_t cid;
@@ -75,6 +77,7 @@ struct aesni_softc {
 	bool	has_sha;
 };
 
+#ifdef __i386__
 #define ACQUIRE_CTX(i, ctx)					\
 	do {							\
 		(i) = PCPU_GET(cpuid);				\
@@ -87,6 +90,53 @@ struct aesni_softc {
 		(i) = -1;					\
 		(ctx) = NULL;					\
 	} while (0)
+#endif
+
+/*
+ * Bookkeeping for one FPU section.  On amd64, FPU_KERN_NOCTX is used
+ * instead of a per-CPU saved context, which makes entering a section
+ * cheap enough that the setup cost no longer dominates small (e.g.
+ * 200-byte IPsec packet) requests.  The price is that the section runs
+ * in a critical section, so callers must do all buffer allocation and
+ * wrapping before entering and must not sleep or acquire locks until
+ * the matching leave.
+ */
+struct aesni_fpu_save {
+#ifdef __i386__
+	struct fpu_kern_ctx *ctx;
+	int ctxidx;
+#endif
+	bool kt;
+};
+
+static void
+aesni_fpu_enter(struct aesni_fpu_save *fps)
+{
+
+	fps->kt = is_fpu_kern_thread(0);
+	if (fps->kt)
+		return;
+#ifdef __i386__
+	ACQUIRE_CTX(fps->ctxidx, fps->ctx);
+	fpu_kern_enter(curthread, fps->ctx, FPU_KERN_NORMAL | FPU_KERN_KTHR);
+#else
+	fpu_kern_enter(curthread, NULL, FPU_KERN_NOCTX);
+#endif
+}
+
+static void
+aesni_fpu_leave(struct aesni_fpu_save *fps)
+{
+
+	if (fps->kt)
+		return;
+#ifdef __i386__
+	fpu_kern_leave(curthread, fps->ctx);
+	RELEASE_CTX(fps->ctxidx, fps->ctx);
+#else
+	fpu_kern_leave(curthread, NULL);
+#endif
+}
 
 static int aesni_cipher_setup(struct aesni_session *ses,
     const struct crypto_session_params *csp);
@@ -139,6 +189,7 @@ aesni_probe(device_t dev)
 	return (0);
 }
 
+#ifdef __i386__
 static void
 aesni_cleanctx(void)
 {
@@ -157,12 +208,15 @@ aesni_cleanctx(void)
 	free(ctx_fpu, M_AESNI);
 	ctx_fpu = NULL;
 }
+#endif
 
 static int
 aesni_attach(device_t dev)
 {
 	struct aesni_softc *sc;
+#ifdef __i386__
 	int i;
+#endif
 
 	sc = device_get_softc(dev);
 
@@ -174,20 +228,17 @@ aesni_attach(device_t dev)
 		return (ENOMEM);
 	}
 
+#ifdef __i386__
 	ctx_mtx = malloc(sizeof *ctx_mtx * (mp_maxid + 1), M_AESNI,
 	    M_WAITOK|M_ZERO);
 	ctx_fpu = malloc(sizeof *ctx_fpu * (mp_maxid + 1), M_AESNI,
 	    M_WAITOK|M_ZERO);
 
 	CPU_FOREACH(i) {
-#ifdef __amd64__
-		ctx_fpu[i] = fpu_kern_alloc_ctx_domain(
-		    pcpu_find(i)->pc_domain, FPU_KERN_NORMAL);
-#else
 		ctx_fpu[i] = fpu_kern_alloc_ctx(FPU_KERN_NORMAL);
-#endif
 		mtx_init(&ctx_mtx[i], "anifpumtx", NULL, MTX_DEF|MTX_NEW);
 	}
+#endif
 
 	detect_cpu_features(&sc->has_aes, &sc->has_sha);
 	return (0);
@@ -202,7 +253,9 @@ aesni_detach(device_t dev)
 
 	crypto_unregister_all(sc->cid);
 
+#ifdef __i386__
 	aesni_cleanctx();
+#endif
 
 	return (0);
 }
@@ -560,8 +613,8 @@ static int
 aesni_cipher_setup(struct aesni_session *ses,
     const struct crypto_session_params *csp)
 {
-	struct fpu_kern_ctx *ctx;
-	int kt, ctxidx, error;
+	struct aesni_fpu_save fps;
+	int error;
 
 	switch (csp->csp_auth_alg) {
 	case CRYPTO_SHA1_HMAC:
@@ -608,32 +661,20 @@ aesni_cipher_setup(struct aesni_session *ses,
 	if (error != 0)
 		return (error);
 
-	kt = is_fpu_kern_thread(0) || (csp->csp_cipher_alg == 0);
-	if (!kt) {
-		ACQUIRE_CTX(ctxidx, ctx);
-		fpu_kern_enter(curthread, ctx,
-		    FPU_KERN_NORMAL | FPU_KERN_KTHR);
-	}
-
-	error = 0;
-	if (csp->csp_cipher_key != NULL)
+	if (csp->csp_cipher_key != NULL) {
+		aesni_fpu_enter(&fps);
 		aesni_cipher_setup_common(ses, csp, csp->csp_cipher_key,
 		    csp->csp_cipher_klen);
-
-	if (!kt) {
-		fpu_kern_leave(curthread, ctx);
-		RELEASE_CTX(ctxidx, ctx);
+		aesni_fpu_leave(&fps);
 	}
-	return (error);
+	return (0);
 }
 
 static int
 aesni_cipher_process(struct aesni_session *ses, struct cryptop *crp)
 {
 	const struct crypto_session_params *csp;
-	struct fpu_kern_ctx *ctx;
-	int error, ctxidx;
-	bool kt;
+	int error;
 
 	csp = crypto_get_params(crp->crp_session);
 	switch (csp->csp_cipher_alg) {
@@ -651,17 +692,11 @@ aesni_cipher_process(struct aesni_session *ses, struct cryptop *crp)
 		break;
 	}
 
-	ctx = NULL;
-	ctxidx = 0;
-	error = 0;
-	kt = is_fpu_kern_thread(0);
-	if (!kt) {
-		ACQUIRE_CTX(ctxidx, ctx);
-		fpu_kern_enter(curthread, ctx,
-		    FPU_KERN_NORMAL | FPU_KERN_KTHR);
-	}
-
-	/* Do work */
+	/*
+	 * Do work.  The FPU sections are entered by the individual
+	 * handlers once all buffer preparation is done, so that the
+	 * expensive part of small requests is just the SIMD pass.
+	 */
 	if (csp->csp_mode == CSP_MODE_ETA) {
 		if (CRYPTO_OP_IS_ENCRYPT(crp->crp_op)) {
 			error = aesni_cipher_crypt(ses, crp, csp);
@@ -677,10 +712,6 @@ aesni_cipher_process(struct aesni_session *ses, struct cryptop *crp)
 	else
 		error = aesni_cipher_crypt(ses, crp, csp);
 
-	if (!kt) {
-		fpu_kern_leave(curthread, ctx);
-		RELEASE_CTX(ctxidx, ctx);
-	}
 	return (error);
 }
 
@@ -688,6 +719,7 @@ static int
 aesni_cipher_crypt(struct aesni_session *ses, struct cryptop *crp,
     const struct crypto_session_params *csp)
 {
+	struct aesni_fpu_save fps;
 	uint8_t iv[AES_BLOCK_LEN], tag[GMAC_DIGEST_LEN];
 	uint8_t *authbuf, *buf, *outbuf;
 	int error;
@@ -739,12 +771,14 @@ aesni_cipher_crypt(struct aesni_session *ses, struct cryptop *crp,
 
 	error = 0;
 	encflag = CRYPTO_OP_IS_ENCRYPT(crp->crp_op);
+	crypto_read_iv(crp, iv);
+
+	aesni_fpu_enter(&fps);
+
 	if (crp->crp_cipher_key != NULL)
 		aesni_cipher_setup_common(ses, csp, crp->crp_cipher_key,
 		    csp->csp_cipher_klen);
 
-	crypto_read_iv(crp, iv);
-
 	switch (csp->csp_cipher_alg) {
 	case CRYPTO_AES_CBC:
 		if (encflag)
@@ -807,6 +841,9 @@ aesni_cipher_crypt(struct aesni_session *ses, struct cryptop *crp,
 		}
 		break;
 	}
+
+	aesni_fpu_leave(&fps);
+
 	if (outcopy && error == 0)
 		crypto_copyback(crp, CRYPTO_HAS_OUTPUT_BUFFER(crp) ?
 		    crp->crp_payload_output_start : crp->crp_payload_start,
@@ -832,6 +869,7 @@ aesni_cipher_mac(struct aesni_session *ses, struct cryptop *crp,
 		struct SHA256Context sha2 __aligned(16);
 		struct sha1_ctxt sha1 __aligned(16);
 	} sctx;
+	struct aesni_fpu_save fps;
 	uint32_t res[SHA2_256_HASH_LEN / sizeof(uint32_t)];
 	const uint8_t *key;
 	int i, keylen;
@@ -842,6 +880,8 @@ aesni_cipher_mac(struct aesni_session *ses, struct cryptop *crp,
 		key = csp->csp_auth_key;
 	keylen = csp->csp_auth_klen;
 
+	aesni_fpu_enter(&fps);
+
 	if (ses->hmac) {
 		uint8_t hmac_key[SHA1_BLOCK_LEN] __aligned(16);
 
@@ -903,6 +943,8 @@ aesni_cipher_mac(struct aesni_session *ses, struct cryptop *crp,
 		ses->hash_finalize(res, &sctx);
 	}
 
+	aesni_fpu_leave(&fps);
+
 	if (crp->crp_op & CRYPTO_OP_VERIFY_DIGEST) {
 		uint32_t res2[SHA2_256_HASH_LEN / sizeof(uint32_t)];
 
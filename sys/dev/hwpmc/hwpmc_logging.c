@@ -937,6 +937,31 @@ pmclog_process_callchain(struct pmc *pm, struct pmc_sample *ps)
 	PMCLOG_DESPATCH_SAFE(po);
 }
 
+void
+pmclog_process_callchain_agg(struct pmc *pm, struct pmc_aggent *pa)
+{
+	int n, recordlen;
+	uint32_t flags;
+	struct pmc_owner *po;
+
+	PMCDBG4(LOG,SAM,1,"pm=%p pid=%d n=%d count=%ju", pm, pa->pa_pid,
+	    pa->pa_nsamples, (uintmax_t) pa->pa_count);
+
+	recordlen = offsetof(struct pmclog_callchain_agg, pl_pc) +
+	    pa->pa_nsamples * sizeof(uintfptr_t);
+	po = pm->pm_owner;
+	flags = PMC_CALLCHAIN_TO_CPUFLAGS(pa->pa_cpu, pa->pa_flags);
+	PMCLOG_RESERVE_SAFE(po, CALLCHAIN_AGG, recordlen, pa->pa_tsc);
+	PMCLOG_EMIT32(pa->pa_pid);
+	PMCLOG_EMIT32(pa->pa_tid);
+	PMCLOG_EMIT32(pm->pm_id);
+	PMCLOG_EMIT32(flags);
+	PMCLOG_EMIT64(pa->pa_count);
+	for (n = 0; n < pa->pa_nsamples; n++)
+		PMCLOG_EMITADDR(pa->pa_pc[n]);
+	PMCLOG_DESPATCH_SAFE(po);
+}
+
 void
 pmclog_process_closelog(struct pmc_owner *po)
 {
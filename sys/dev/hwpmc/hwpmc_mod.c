@@ -205,6 +205,8 @@ static int	pmc_debugflags_parse(char *newstr, char *fence);
 
 static int	load(struct module *module, int cmd, void *arg);
 static int	pmc_add_sample(ring_type_t ring, struct pmc *pm, struct trapframe *tf);
+static void	pmc_agg_flush_pmc(struct pmc *pm);
+static void	pmc_aggregate_sample(int cpu, struct pmc_sample *ps);
 static void	pmc_add_thread_descriptors_from_proc(struct proc *p,
     struct pmc_process *pp);
 static int	pmc_attach_process(struct proc *p, struct pmc *pm);
@@ -339,6 +341,42 @@ SYSCTL_INT(_kern_hwpmc, OID_AUTO, nsamples, CTLFLAG_RDTUN,
 
 static uint64_t pmc_sample_mask = PMC_NSAMPLES-1;
 
+/*
+ * kern.hwpmc.aggentries --- number of entries in each CPU's call chain
+ * aggregation table; must be a power of two.
+ */
+
+static int pmc_aggentries = PMC_AGGENTRIES;
+SYSCTL_INT(_kern_hwpmc, OID_AUTO, aggentries, CTLFLAG_RDTUN,
+    &pmc_aggentries, 0, "callchain aggregation table entries per CPU");
+
+static uint32_t pmc_aggmask = PMC_AGGENTRIES-1;
+
+/*
+ * kern.hwpmc.aggflushinterval --- ticks between periodic flushes of the
+ * call chain aggregation tables; zero selects one flush per second.
+ */
+
+static int pmc_aggflushint = 0;
+SYSCTL_INT(_kern_hwpmc, OID_AUTO, aggflushinterval, CTLFLAG_RDTUN,
+    &pmc_aggflushint, 0, "ticks between callchain aggregation flushes");
+
+/*
+ * Per-CPU call chain aggregation tables for PMCs allocated with
+ * PMC_F_AGGREGATE.  Each table is a direct-mapped hash of call chains;
+ * a sample that collides with a different resident chain evicts the
+ * resident entry to the log, so no overflow chaining is needed.
+ */
+
+struct pmc_aggbuffer {
+	struct mtx		ab_mtx;		/* spin lock */
+	int			ab_lastflush;	/* ticks at last flush */
+	uintptr_t		*ab_callchains;	/* all saved call chains */
+	struct pmc_aggent	ab_entries[];	/* hash table of entries */
+};
+
+static struct pmc_aggbuffer **pmc_aggbufs;
+
 /*
  * kern.hwpmc.mtxpoolsize -- number of mutexes in the mutex pool.
  */
@@ -2895,6 +2933,15 @@ pmc_release_pmc_descriptor(struct pmc *pm)
 
 	}
 
+	/*
+	 * The PMC is now idle, so no new samples can be folded into
+	 * the aggregation tables.  Push out what the tables still hold
+	 * while the owner's log is reachable and before the tables'
+	 * references to this PMC go stale.
+	 */
+	if (pm->pm_flags & PMC_F_AGGREGATE)
+		pmc_agg_flush_pmc(pm);
+
 	/*
 	 * Release any MD resources
 	 */
@@ -3277,6 +3324,13 @@ pmc_stop(struct pmc *pm)
 
 	pm->pm_state = PMC_STATE_STOPPED;
 
+	/*
+	 * Aggregated samples stop accumulating once the state changes;
+	 * push out what the tables already hold.
+	 */
+	if (pm->pm_flags & PMC_F_AGGREGATE)
+		pmc_agg_flush_pmc(pm);
+
 	/*
 	 * If the PMC is a virtual mode one, changing the state to
 	 * non-RUNNING is enough to ensure that the PMC never gets
@@ -3891,7 +3945,7 @@ pmc_syscall_handler(struct thread *td, void *syscall_args)
 
 		if ((pa.pm_flags & ~(PMC_F_DESCENDANTS | PMC_F_LOG_PROCCSW |
 		    PMC_F_LOG_PROCEXIT | PMC_F_CALLCHAIN |
-		    PMC_F_USERCALLCHAIN)) != 0) {
+		    PMC_F_USERCALLCHAIN | PMC_F_AGGREGATE)) != 0) {
 			error = EINVAL;
 			break;
 		}
@@ -3910,6 +3964,13 @@ pmc_syscall_handler(struct thread *td, void *syscall_args)
 			break;
 		}
 
+		/* PMC_F_AGGREGATE is only valid for sampling mode */
+		if (pa.pm_flags & PMC_F_AGGREGATE &&
+			mode != PMC_MODE_TS && mode != PMC_MODE_SS) {
+			error = EINVAL;
+			break;
+		}
+
 		/* process logging options are not allowed for system PMCs */
 		if (PMC_IS_SYSTEM_MODE(mode) && (pa.pm_flags &
 		    (PMC_F_LOG_PROCCSW | PMC_F_LOG_PROCEXIT))) {
@@ -4906,6 +4967,106 @@ pmc_capture_user_callchain(int cpu, int ring, struct trapframe *tf)
 	DPCPU_SET(pmc_sampled, 1);
 }
 
+/*
+ * Flush one aggregation table entry to the log and mark it free.  The
+ * table's lock must be held.
+ */
+
+static void
+pmc_agg_flush_entry(struct pmc_aggent *pa)
+{
+
+	pmclog_process_callchain_agg(pa->pa_pmc, pa);
+	pa->pa_nsamples = 0;
+}
+
+/*
+ * Flush every aggregation table entry belonging to 'pm'.  Called
+ * while the PMC is still valid, before its descriptor can be
+ * reclaimed.
+ */
+
+static void
+pmc_agg_flush_pmc(struct pmc *pm)
+{
+	struct pmc_aggbuffer *ab;
+	struct pmc_aggent *pa;
+	int cpu, n;
+
+	for (cpu = 0; cpu < pmc_cpu_max(); cpu++) {
+		if ((ab = pmc_aggbufs[cpu]) == NULL)
+			continue;
+		mtx_lock_spin(&ab->ab_mtx);
+		for (n = 0; n < pmc_aggentries; n++) {
+			pa = &ab->ab_entries[n];
+			if (pa->pa_nsamples != 0 && pa->pa_pmc == pm)
+				pmc_agg_flush_entry(pa);
+		}
+		mtx_unlock_spin(&ab->ab_mtx);
+	}
+}
+
+/*
+ * Fold a PC sample into the current CPU's aggregation table.  Samples
+ * sharing a (PMC, process, call chain) key only bump a count; a sample
+ * whose chain hashes to a slot holding a different chain evicts the
+ * resident entry to the log.  The whole table is flushed periodically
+ * so that the log consumer sees a fresh histogram at least once per
+ * flush interval.
+ */
+
+static void
+pmc_aggregate_sample(int cpu, struct pmc_sample *ps)
+{
+	struct pmc_aggbuffer *ab;
+	struct pmc_aggent *pa;
+	uintptr_t h;
+	int n;
+
+	KASSERT(ps->ps_nsamples > 0,
+	    ("[pmc,%d] empty callchain", __LINE__));
+
+	ab = pmc_aggbufs[cpu];
+	h = (uintptr_t) ps->ps_pmc ^ ps->ps_pid;
+	for (n = 0; n < ps->ps_nsamples; n++)
+		h = (h << 5) ^ (h >> 27) ^ ps->ps_pc[n];
+	pa = &ab->ab_entries[h & pmc_aggmask];
+
+	mtx_lock_spin(&ab->ab_mtx);
+	if (pa->pa_nsamples != 0 &&
+	    (pa->pa_pmc != ps->ps_pmc || pa->pa_pid != ps->ps_pid ||
+	    pa->pa_flags != ps->ps_flags ||
+	    pa->pa_nsamples != ps->ps_nsamples ||
+	    bcmp(pa->pa_pc, ps->ps_pc,
+	    ps->ps_nsamples * sizeof(uintptr_t)) != 0))
+		pmc_agg_flush_entry(pa);
+
+	if (pa->pa_nsamples == 0) {
+		pa->pa_pmc = ps->ps_pmc;
+		pa->pa_pid = ps->ps_pid;
+		pa->pa_tid = ps->ps_tid;
+		pa->pa_cpu = ps->ps_cpu;
+		pa->pa_flags = ps->ps_flags;
+		pa->pa_nsamples = ps->ps_nsamples;
+		pa->pa_tsc = ps->ps_tsc;
+		pa->pa_count = 0;
+		memcpy(pa->pa_pc, ps->ps_pc,
+		    ps->ps_nsamples * sizeof(uintptr_t));
+	}
+	pa->pa_count++;
+
+	/* Time for the consumer's periodic histogram? */
+	if (ticks - ab->ab_lastflush >= pmc_aggflushint) {
+		for (n = 0; n < pmc_aggentries; n++) {
+			pa = &ab->ab_entries[n];
+			if (pa->pa_nsamples != 0)
+				pmc_agg_flush_entry(pa);
+		}
+		ab->ab_lastflush = ticks;
+	}
+	mtx_unlock_spin(&ab->ab_mtx);
+}
+
 /*
  * Process saved PC samples.
  */
@@ -4992,7 +5153,9 @@ pmc_process_samples(int cpu, ring_type_t ring)
 				td = FIRST_THREAD_IN_PROC(po->po_owner);
 				addupc_intr(td, ps->ps_pc[0], 1);
 			}
-		} else
+		} else if (pm->pm_flags & PMC_F_AGGREGATE)
+			pmc_aggregate_sample(cpu, ps);
+		else
 			pmclog_process_callchain(pm, ps);
 
 	entrydone:
@@ -5514,6 +5677,7 @@ pmc_initialize(void)
 	int c, cpu, error, n, ri;
 	unsigned int maxcpu, domain;
 	struct pcpu *pc;
+	struct pmc_aggbuffer *ab;
 	struct pmc_binding pb;
 	struct pmc_sample *ps;
 	struct pmc_classdep *pcd;
@@ -5580,6 +5744,17 @@ pmc_initialize(void)
 		pmc_callchaindepth = PMC_CALLCHAIN_DEPTH_MAX;
 	}
 
+	if (pmc_aggentries <= 0 || !powerof2(pmc_aggentries)) {
+		(void) printf("hwpmc: tunable \"aggentries\"=%d must be a "
+		    "power of two - using %d.\n", pmc_aggentries,
+		    PMC_AGGENTRIES);
+		pmc_aggentries = PMC_AGGENTRIES;
+	}
+	pmc_aggmask = pmc_aggentries - 1;
+
+	if (pmc_aggflushint <= 0)
+		pmc_aggflushint = hz;
+
 	md = pmc_md_initialize();
 	if (md == NULL) {
 		/* Default to generic CPU. */
@@ -5617,6 +5792,10 @@ pmc_initialize(void)
 	pmc_pcpu_saved = malloc(sizeof(pmc_value_t) * maxcpu * md->pmd_npmc,
 	    M_PMC, M_WAITOK);
 
+	/* allocate space for the per-cpu aggregation table array */
+	pmc_aggbufs = malloc(maxcpu * sizeof(struct pmc_aggbuffer *), M_PMC,
+	    M_WAITOK|M_ZERO);
+
 	/* Perform CPU-dependent initialization. */
 	pmc_save_cpu_binding(&pb);
 	error = 0;
@@ -5683,6 +5862,20 @@ pmc_initialize(void)
 			ps->ps_pc = sb->ps_callchains + n * pmc_callchaindepth;
 
 		pmc_pcpu[cpu]->pc_sb[PMC_UR] = sb;
+
+		ab = malloc_domainset(sizeof(struct pmc_aggbuffer) +
+		    pmc_aggentries * sizeof(struct pmc_aggent), M_PMC,
+		    DOMAINSET_PREF(domain), M_WAITOK | M_ZERO);
+		ab->ab_callchains = malloc_domainset(pmc_callchaindepth *
+		    pmc_aggentries * sizeof(uintptr_t), M_PMC,
+		    DOMAINSET_PREF(domain), M_WAITOK | M_ZERO);
+		for (n = 0; n < pmc_aggentries; n++)
+			ab->ab_entries[n].pa_pc = ab->ab_callchains +
+			    (n * pmc_callchaindepth);
+		mtx_init(&ab->ab_mtx, "pmc-agg", "pmc-leaf", MTX_SPIN);
+		ab->ab_lastflush = ticks;
+
+		pmc_aggbufs[cpu] = ab;
 	}
 
 	/* allocate space for the row disposition array */
@@ -5900,11 +6093,19 @@ pmc_cleanup(void)
 		free(pmc_pcpu[cpu]->pc_sb[PMC_UR]->ps_callchains, M_PMC);
 		free(pmc_pcpu[cpu]->pc_sb[PMC_UR], M_PMC);
 		free(pmc_pcpu[cpu], M_PMC);
+		if (pmc_aggbufs[cpu] != NULL) {
+			mtx_destroy(&pmc_aggbufs[cpu]->ab_mtx);
+			free(pmc_aggbufs[cpu]->ab_callchains, M_PMC);
+			free(pmc_aggbufs[cpu], M_PMC);
+		}
 	}
 
 	free(pmc_pcpu, M_PMC);
 	pmc_pcpu = NULL;
 
+	free(pmc_aggbufs, M_PMC);
+	pmc_aggbufs = NULL;
+
 	free(pmc_pcpu_saved, M_PMC);
 	pmc_pcpu_saved = NULL;
 
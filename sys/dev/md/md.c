@@ -1022,11 +1022,11 @@ unmapped_step:
 static int
 mdstart_swap(struct md_s *sc, struct bio *bp)
 {
-	vm_page_t m;
+	vm_page_t m, ma[16];
 	u_char *p;
 	vm_pindex_t i, lastp;
 	bus_dma_segment_t *vlist;
-	int rv, ma_offs, offs, len, lastend;
+	int j, n, rv, ma_offs, offs, len, lastend;
 
 	switch (bp->bio_cmd) {
 	case BIO_READ:
@@ -1054,6 +1054,45 @@ mdstart_swap(struct md_s *sc, struct bio *bp)
 	lastp = (bp->bio_offset + bp->bio_length - 1) / PAGE_SIZE;
 	lastend = (bp->bio_offset + bp->bio_length - 1) % PAGE_SIZE + 1;
 
+	/*
+	 * Page-aligned writes overwrite whole pages, so they never need
+	 * the pager and make up the bulk of buffer cache traffic on a
+	 * mounted md.  Grab runs of pages at once instead of doing one
+	 * object lookup per page.
+	 */
+	if (bp->bio_cmd == BIO_WRITE && offs == 0 && lastend == PAGE_SIZE) {
+		vm_object_pip_add(sc->object, 1);
+		for (i = bp->bio_offset / PAGE_SIZE; i <= lastp; i += n) {
+			n = MIN(lastp - i + 1, (vm_pindex_t)nitems(ma));
+			(void)vm_page_grab_pages_unlocked(sc->object, i,
+			    VM_ALLOC_SYSTEM, ma, n);
+			for (j = 0; j < n; j++) {
+				m = ma[j];
+				if ((bp->bio_flags & BIO_UNMAPPED) != 0) {
+					pmap_copy_pages(bp->bio_ma, ma_offs,
+					    &m, 0, PAGE_SIZE);
+				} else if ((bp->bio_flags & BIO_VLIST) != 0) {
+					physcopyin_vlist(vlist, ma_offs,
+					    VM_PAGE_TO_PHYS(m), PAGE_SIZE);
+				} else {
+					physcopyin(p, VM_PAGE_TO_PHYS(m),
+					    PAGE_SIZE);
+				}
+				vm_page_valid(m);
+				vm_page_set_dirty(m);
+				vm_page_xunbusy(m);
+				if (vm_page_active(m))
+					vm_page_reference(m);
+				else
+					vm_page_activate(m);
+				p += PAGE_SIZE;
+				ma_offs += PAGE_SIZE;
+			}
+		}
+		vm_object_pip_wakeup(sc->object);
+		return (0);
+	}
+
 	rv = VM_PAGER_OK;
 	vm_object_pip_add(sc->object, 1);
 	for (i = bp->bio_offset / PAGE_SIZE; i <= lastp; i++) {
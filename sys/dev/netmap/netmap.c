@@ -2798,6 +2798,12 @@ netmap_ioctl(struct netmap_priv_d *priv, u_long cmd, caddr_t data,
 			error = nm_bdg_polling(hdr);
 			break;
 		}
+
+		case NETMAP_REQ_VALE_BPF_SET:
+		case NETMAP_REQ_VALE_BPF_CLEAR: {
+			error = netmap_vale_bpf(hdr);
+			break;
+		}
 #endif  /* WITH_VALE */
 		case NETMAP_REQ_POOLS_INFO_GET: {
 			/* Get information from the memory allocator used for
@@ -2981,7 +2987,10 @@ nmreq_size_by_type(uint16_t nr_reqtype)
 	case NETMAP_REQ_VALE_DELIF:
 	case NETMAP_REQ_SYNC_KLOOP_STOP:
 	case NETMAP_REQ_CSB_ENABLE:
+	case NETMAP_REQ_VALE_BPF_CLEAR:
 		return 0;
+	case NETMAP_REQ_VALE_BPF_SET:
+		return sizeof(struct nmreq_vale_bpf);
 	case NETMAP_REQ_VALE_POLLING_ENABLE:
 	case NETMAP_REQ_VALE_POLLING_DISABLE:
 		return sizeof(struct nmreq_vale_polling);
@@ -240,6 +240,9 @@ netmap_bdg_free(struct nm_bridge *b)
 	}
 
 	nm_prdis("marking bridge %s as free", b->bdg_basename);
+#ifdef WITH_VALE
+	netmap_vale_bpf_bdg_free(b);
+#endif
 	nm_os_free(b->ht);
 	memset(&b->bdg_ops, 0, sizeof(b->bdg_ops));
 	memset(&b->bdg_saved_ops, 0, sizeof(b->bdg_saved_ops));
@@ -175,6 +175,9 @@ int netmap_get_bdg_na(struct nmreq_header *hdr, struct netmap_adapter **na,
 
 struct nm_bridge *nm_find_bridge(const char *name, int create, struct netmap_bdg_ops *ops);
 int netmap_bdg_free(struct nm_bridge *b);
+#ifdef WITH_VALE
+void netmap_vale_bpf_bdg_free(struct nm_bridge *b);
+#endif /* WITH_VALE */
 void netmap_bdg_detach_common(struct nm_bridge *b, int hw, int sw);
 int netmap_vp_bdg_ctl(struct nmreq_header *hdr, struct netmap_adapter *na);
 int netmap_bwrap_reg(struct netmap_adapter *, int onoff);
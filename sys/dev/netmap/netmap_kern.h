@@ -1103,6 +1103,7 @@ int nm_bdg_polling(struct nmreq_header *hdr);
 int netmap_vale_attach(struct nmreq_header *hdr, void *auth_token);
 int netmap_vale_detach(struct nmreq_header *hdr, void *auth_token);
 int netmap_vale_list(struct nmreq_header *hdr);
+int netmap_vale_bpf(struct nmreq_header *hdr);
 int netmap_vi_create(struct nmreq_header *hdr, int);
 int nm_vi_create(struct nmreq_header *);
 int nm_vi_destroy(const char *name);
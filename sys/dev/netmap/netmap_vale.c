@@ -31,6 +31,8 @@
 #include <sys/cdefs.h> /* prerequisite */
 __FBSDID("$FreeBSD$");
 
+#include "opt_bpf.h"
+
 #include <sys/types.h>
 #include <sys/errno.h>
 #include <sys/param.h>	/* defines used in kernel.h */
@@ -47,6 +49,9 @@ __FBSDID("$FreeBSD$");
 #include <net/if.h>
 #include <net/if_var.h>
 #include <net/bpf.h>		/* BIOCIMMEDIATE */
+#ifdef BPF_JITTER
+#include <net/bpf_jitter.h>
+#endif
 #include <machine/bus.h>	/* bus_dmamap_* */
 #include <sys/endian.h>
 #include <sys/refcount.h>
@@ -788,6 +793,163 @@ netmap_vale_learning(struct nm_bdg_fwd *ft, uint8_t *dst_ring,
 }
 
 
+/*
+ * Programmable lookup: a classic BPF program installed by userspace
+ * (NETMAP_REQ_VALE_BPF_SET) classifies frames in place of the learning
+ * bridge, steering flows between the attached ports (typically netmap
+ * pipes) without going through a userspace dispatcher process.
+ */
+struct nm_vale_bpf {
+	struct bpf_insn *insns;	/* validated program */
+	u_int n_insns;
+#ifdef BPF_JITTER
+	bpf_jit_filter *jit;	/* native code, if the JIT succeeded */
+#endif
+};
+
+/* Frames in userspace buffers (NS_INDIRECT) are classified on a bounded
+ * prefix copied into the kernel; loads beyond it make the program
+ * return 0, which drops the frame. */
+#define NM_VALE_BPF_SNAPLEN	256
+
+static void
+nm_vale_bpf_free(struct nm_vale_bpf *vb)
+{
+	if (vb == NULL)
+		return;
+#ifdef BPF_JITTER
+	if (vb->jit != NULL)
+		bpf_destroy_jit_filter(vb->jit);
+#endif
+	nm_os_free(vb->insns);
+	nm_os_free(vb);
+}
+
+/*
+ * Run the BPF program on the frame. The return value is used directly
+ * as the destination: an index selects a port, NM_BDG_BROADCAST
+ * forwards to all ports and anything larger drops the frame.
+ */
+static uint32_t
+netmap_vale_bpf_lookup(struct nm_bdg_fwd *ft, uint8_t *dst_ring,
+		struct netmap_vp_adapter *na, void *private_data)
+{
+	uint8_t *buf = ((uint8_t *)ft->ft_buf) + ft->ft_offset;
+	u_int buf_len = ft->ft_len - ft->ft_offset;
+	struct nm_vale_bpf *vb = private_data;
+	uint8_t indbuf[NM_VALE_BPF_SNAPLEN];
+
+	if (ft->ft_flags & NS_INDIRECT) {
+		if (buf_len > NM_VALE_BPF_SNAPLEN)
+			buf_len = NM_VALE_BPF_SNAPLEN;
+		if (copyin(buf, indbuf, buf_len)) {
+			return NM_BDG_NOPORT;
+		}
+		buf = indbuf;
+	}
+
+#ifdef BPF_JITTER
+	if (vb->jit != NULL)
+		return vb->jit->func(buf, buf_len, buf_len);
+#endif
+	return bpf_filter(vb->insns, buf, buf_len, buf_len);
+}
+
+/* Process NETMAP_REQ_VALE_BPF_SET and NETMAP_REQ_VALE_BPF_CLEAR.
+ * Called without NMG_LOCK held. */
+int
+netmap_vale_bpf(struct nmreq_header *hdr)
+{
+	struct nmreq_vale_bpf *req =
+		(struct nmreq_vale_bpf *)(uintptr_t)hdr->nr_body;
+	struct nm_vale_bpf *vb = NULL, *old = NULL;
+	struct nm_bridge *b;
+	int error = 0;
+
+	if (hdr->nr_reqtype == NETMAP_REQ_VALE_BPF_SET) {
+		size_t size;
+
+		if (req->nr_num_insns == 0 ||
+		    req->nr_num_insns > BPF_MAXINSNS) {
+			return EINVAL;
+		}
+		vb = nm_os_malloc(sizeof(*vb));
+		if (vb == NULL)
+			return ENOMEM;
+		size = req->nr_num_insns * sizeof(struct bpf_insn);
+		vb->insns = nm_os_malloc(size);
+		if (vb->insns == NULL) {
+			nm_os_free(vb);
+			return ENOMEM;
+		}
+		vb->n_insns = req->nr_num_insns;
+		error = copyin((void *)(uintptr_t)req->nr_prog, vb->insns,
+				size);
+		if (error) {
+			nm_vale_bpf_free(vb);
+			return error;
+		}
+		if (!bpf_validate(vb->insns, vb->n_insns)) {
+			nm_vale_bpf_free(vb);
+			return EINVAL;
+		}
+#ifdef BPF_JITTER
+		/* Fall back to the interpreter if the JIT fails. */
+		vb->jit = bpf_jitter(vb->insns, vb->n_insns);
+#endif
+	}
+
+	NMG_LOCK();
+	b = nm_find_bridge(hdr->nr_name, 0 /* don't create */, NULL);
+	if (b == NULL) {
+		error = ENXIO;
+		goto unlock_bpf;
+	}
+	if (!nm_bdg_valid_auth_token(b, NULL)) {
+		/* An external module owns this bridge. */
+		error = EACCES;
+		goto unlock_bpf;
+	}
+	if (b->bdg_ops.lookup != b->bdg_saved_ops.lookup &&
+	    b->bdg_ops.lookup != netmap_vale_bpf_lookup) {
+		/* A kernel module installed its own lookup function. */
+		error = EBUSY;
+		goto unlock_bpf;
+	}
+	BDG_WLOCK(b);
+	if (b->bdg_ops.lookup == netmap_vale_bpf_lookup)
+		old = b->private_data;
+	if (vb != NULL) {
+		b->bdg_ops.lookup = netmap_vale_bpf_lookup;
+		b->private_data = vb;
+		vb = NULL;
+	} else {
+		/* Restore the learning bridge over a clean table. */
+		bzero(b->ht, sizeof(struct nm_hash_ent) * NM_BDG_HASH);
+		b->bdg_ops.lookup = b->bdg_saved_ops.lookup;
+		b->private_data = b->ht;
+	}
+	BDG_WUNLOCK(b);
+
+unlock_bpf:
+	NMG_UNLOCK();
+	nm_vale_bpf_free(old);
+	nm_vale_bpf_free(vb);
+	return error;
+}
+
+/* Called by netmap_bdg_free() to dispose of an installed program when
+ * the bridge itself goes away. */
+void
+netmap_vale_bpf_bdg_free(struct nm_bridge *b)
+{
+	if (b->bdg_ops.lookup == netmap_vale_bpf_lookup) {
+		nm_vale_bpf_free(b->private_data);
+		b->private_data = NULL;
+	}
+}
+
+
 /*
  * Available space in the ring. Only used in VALE code
  * and only with is_rx = 1
@@ -125,6 +125,7 @@ nvme_ctrlr_construct_io_qpairs(struct nvme_controller *ctrlr)
 	uint16_t		mqes;
 	int			c, error, i, n;
 	int			num_entries, num_trackers, max_entries;
+	int			io_polling, lat_tracking;
 
 	/*
 	 * NVMe spec sets a hard limit of 64K max entries, but devices may
@@ -156,6 +157,17 @@ nvme_ctrlr_construct_io_qpairs(struct nvme_controller *ctrlr)
 	 */
 	num_trackers = min(num_trackers, (num_entries-1));
 
+	/*
+	 * Optionally reap I/O completions with per-queue polling threads
+	 *  instead of MSI-X interrupts.  Latency tracking is implied by
+	 *  polling so its effect can be validated, but may also be enabled
+	 *  on its own for an interrupt-driven baseline.
+	 */
+	io_polling = 0;
+	TUNABLE_INT_FETCH("hw.nvme.io_polling", &io_polling);
+	lat_tracking = io_polling;
+	TUNABLE_INT_FETCH("hw.nvme.latency_tracking", &lat_tracking);
+
 	/*
 	 * Our best estimate for the maximum number of I/Os that we should
 	 * normally have in flight at one time. This should be viewed as a hint,
@@ -187,6 +199,14 @@ nvme_ctrlr_construct_io_qpairs(struct nvme_controller *ctrlr)
 			qpair->domain = ctrlr->domain;
 		}
 
+		/*
+		 * Polled mode needs a per-queue vector assignment to make
+		 *  sense; fall back to interrupts when all queues share a
+		 *  single INTx vector.
+		 */
+		qpair->poll_enabled = io_polling != 0 && ctrlr->msix_enabled;
+		qpair->lat_tracking = lat_tracking != 0;
+
 		/*
 		 * For I/O queues, use the controller-wide max_xfer_size
 		 *  calculated in nvme_attach().
@@ -198,9 +218,10 @@ nvme_ctrlr_construct_io_qpairs(struct nvme_controller *ctrlr)
 
 		/*
 		 * Do not bother binding interrupts if we only have one I/O
-		 *  interrupt thread for this controller.
+		 *  interrupt thread for this controller, or none at all
+		 *  because the queue is polled.
 		 */
-		if (ctrlr->num_io_queues > 1)
+		if (ctrlr->num_io_queues > 1 && qpair->res != NULL)
 			bus_bind_intr(ctrlr->dev, qpair->res, qpair->cpu);
 	}
 
@@ -91,8 +91,14 @@ nvme_ctrlr_cmd_create_io_cq(struct nvme_controller *ctrlr,
 	 *  structure.
 	 */
 	cmd->cdw10 = htole32(((io_que->num_entries-1) << 16) | io_que->id);
-	/* 0x3 = interrupts enabled | physically contiguous */
-	cmd->cdw11 = htole32((io_que->vector << 16) | 0x3);
+	/*
+	 * 0x3 = interrupts enabled | physically contiguous.  Do not ask for
+	 *  an interrupt vector at all if the queue is polled.
+	 */
+	if (io_que->poll_enabled)
+		cmd->cdw11 = htole32(0x1);
+	else
+		cmd->cdw11 = htole32((io_que->vector << 16) | 0x3);
 	cmd->prp1 = htole64(io_que->cpl_bus_addr);
 
 	nvme_ctrlr_submit_admin_request(ctrlr, req);
@@ -105,6 +105,12 @@ MALLOC_DECLARE(M_NVME);
 /* Maximum log page size to fetch for AERs. */
 #define NVME_MAX_AER_LOG_SIZE		(4096)
 
+/*
+ * Completion latency histogram: one bucket per power-of-two microsecond
+ *  interval, topping out at ~8 seconds.
+ */
+#define NVME_LATENCY_BUCKETS		(24)
+
 /*
  * Define CACHE_LINE_SIZE here for older FreeBSD versions that do not define
  *  it.
@@ -162,6 +168,7 @@ struct nvme_tracker {
 	struct callout			timer;
 	bus_dmamap_t			payload_dma_map;
 	uint16_t			cid;
+	sbintime_t			submit_ts;
 
 	uint64_t			*prp;
 	bus_addr_t			prp_bus_addr;
@@ -192,6 +199,7 @@ struct nvme_qpair {
 	int64_t			num_intr_handler_calls;
 	int64_t			num_retries;
 	int64_t			num_failures;
+	int64_t			lat_hist[NVME_LATENCY_BUCKETS];
 
 	struct nvme_command	*cmd;
 	struct nvme_completion	*cpl;
@@ -211,6 +219,26 @@ struct nvme_qpair {
 
 	bool			is_enabled;
 
+	/*
+	 * In polled mode, completions for this queue are reaped by a
+	 *  dedicated kthread instead of an MSI-X interrupt.  poll_sleeping
+	 *  and poll_exit are protected by the qpair lock.
+	 */
+	bool			poll_enabled;
+	bool			poll_sleeping;
+	bool			poll_exit;
+	bool			lat_tracking;
+	struct thread		*poll_td;
+
+	/*
+	 * While batching is set, nvme_qpair_submit_tracker() records new
+	 *  submissions in db_pending instead of writing the submission queue
+	 *  doorbell, and nvme_qpair_batch_done() writes it once for the whole
+	 *  batch.  Both are protected by the qpair lock.
+	 */
+	bool			batching;
+	bool			db_pending;
+
 	struct mtx		lock __aligned(CACHE_LINE_SIZE);
 
 } __aligned(CACHE_LINE_SIZE);
@@ -33,7 +33,11 @@ __FBSDID("$FreeBSD$");
 #include <sys/bus.h>
 #include <sys/conf.h>
 #include <sys/domainset.h>
+#include <sys/kthread.h>
 #include <sys/proc.h>
+#include <sys/sched.h>
+
+#include <machine/cpu.h>
 
 #include <dev/pci/pcivar.h>
 
@@ -42,6 +46,14 @@ __FBSDID("$FreeBSD$");
 typedef enum error_print { ERROR_PRINT_NONE, ERROR_PRINT_NO_RETRY, ERROR_PRINT_ALL } error_print_t;
 #define DO_NOT_RETRY	1
 
+/*
+ * Number of consecutive empty polls before an idle polling thread goes to
+ *  sleep until the next submission.
+ */
+#define NVME_POLL_IDLE_SPINS	(1000)
+
+static struct proc	*nvme_poll_proc;
+
 static void	_nvme_qpair_submit_request(struct nvme_qpair *qpair,
 					   struct nvme_request *req);
 static void	nvme_qpair_destroy(struct nvme_qpair *qpair);
@@ -421,6 +433,14 @@ nvme_qpair_complete_tracker(struct nvme_tracker *tr,
 	struct nvme_qpair * qpair = tr->qpair;
 	struct nvme_request	*req;
 	bool			retry, error, retriable;
+	int			bucket;
+
+	if (qpair->lat_tracking && tr->submit_ts != 0) {
+		bucket = flsll(sbttous(getsbinuptime() - tr->submit_ts));
+		if (bucket >= NVME_LATENCY_BUCKETS)
+			bucket = NVME_LATENCY_BUCKETS - 1;
+		qpair->lat_hist[bucket]++;
+	}
 
 	req = tr->req;
 	error = nvme_completion_is_error(cpl);
@@ -529,12 +549,33 @@ nvme_qpair_manual_complete_request(struct nvme_qpair *qpair,
 	nvme_free_request(req);
 }
 
+/*
+ * End a batched submission sequence started by setting qpair->batching.
+ *  Any submission queue doorbell writes that were deferred while the
+ *  batch was open are collapsed into a single write here.
+ */
+static void
+nvme_qpair_batch_done(struct nvme_qpair *qpair)
+{
+
+	mtx_assert(&qpair->lock, MA_OWNED);
+
+	qpair->batching = false;
+	if (qpair->db_pending) {
+		bus_space_write_4(qpair->ctrlr->bus_tag,
+		    qpair->ctrlr->bus_handle, qpair->sq_tdbl_off,
+		    qpair->sq_tail);
+		qpair->db_pending = false;
+	}
+}
+
 bool
 nvme_qpair_process_completions(struct nvme_qpair *qpair)
 {
 	struct nvme_tracker	*tr;
 	struct nvme_completion	cpl;
 	int done = 0;
+	bool batched = false;
 	bool in_panic = dumping || SCHEDULER_STOPPED();
 
 	qpair->num_intr_handler_calls++;
@@ -594,6 +635,18 @@ nvme_qpair_process_completions(struct nvme_qpair *qpair)
 		tr = qpair->act_tr[cpl.cid];
 
 		if (tr != NULL) {
+			/*
+			 * Open a batch on the first completion, so that any
+			 *  retries or queued requests resubmitted while
+			 *  draining the completion queue ring the submission
+			 *  doorbell only once, after the loop.
+			 */
+			if (!batched && !in_panic) {
+				mtx_lock(&qpair->lock);
+				qpair->batching = true;
+				mtx_unlock(&qpair->lock);
+				batched = true;
+			}
 			nvme_qpair_complete_tracker(tr, &cpl, ERROR_PRINT_ALL);
 			qpair->sq_head = cpl.sqhd;
 			done++;
@@ -627,10 +680,19 @@ nvme_qpair_process_completions(struct nvme_qpair *qpair)
 			atomic_store_rel_int(&qpair->cq_head, 0);	/* 2 */
 			qpair->phase = !qpair->phase;			/* 3 */
 		}
+	}
 
+	if (done != 0) {
 		bus_space_write_4(qpair->ctrlr->bus_tag, qpair->ctrlr->bus_handle,
 		    qpair->cq_hdbl_off, qpair->cq_head);
 	}
+
+	if (batched) {
+		mtx_lock(&qpair->lock);
+		nvme_qpair_batch_done(qpair);
+		mtx_unlock(&qpair->lock);
+	}
+
 	return (done != 0);
 }
 
@@ -642,6 +704,61 @@ nvme_qpair_msix_handler(void *arg)
 	nvme_qpair_process_completions(qpair);
 }
 
+/*
+ * Dedicated completion reaper for a queue pair in polled mode.  Spins
+ *  while the queue is busy and falls back to sleeping until the next
+ *  submission once it has been idle for a while (hybrid polling), so an
+ *  idle queue does not burn its CPU.
+ */
+static void
+nvme_qpair_poll_thread(void *arg)
+{
+	struct nvme_qpair *qpair = arg;
+	int idle = 0;
+
+	/*
+	 * Keep completion processing on the CPU that submits to this queue,
+	 *  mirroring the interrupt binding in the MSI-X case.
+	 */
+	if (qpair->ctrlr->num_io_queues > 1) {
+		thread_lock(curthread);
+		sched_bind(curthread, qpair->cpu);
+		thread_unlock(curthread);
+	}
+
+	while (!qpair->poll_exit) {
+		if (nvme_qpair_process_completions(qpair))
+			idle = 0;
+		else
+			idle++;
+
+		if (idle <= NVME_POLL_IDLE_SPINS) {
+			cpu_spinwait();
+			continue;
+		}
+
+		mtx_lock(&qpair->lock);
+		if (!qpair->poll_exit) {
+			/*
+			 * The 1ms backstop bounds the damage if a wakeup
+			 *  from the submission path is ever missed.
+			 */
+			qpair->poll_sleeping = true;
+			msleep_sbt(qpair, &qpair->lock, 0, "nvmepoll",
+			    SBT_1MS, 0, 0);
+			qpair->poll_sleeping = false;
+		}
+		mtx_unlock(&qpair->lock);
+		idle = 0;
+	}
+
+	mtx_lock(&qpair->lock);
+	qpair->poll_td = NULL;
+	wakeup(&qpair->poll_td);
+	mtx_unlock(&qpair->lock);
+	kthread_exit();
+}
+
 int
 nvme_qpair_construct(struct nvme_qpair *qpair,
     uint32_t num_entries, uint32_t num_trackers,
@@ -658,7 +775,7 @@ nvme_qpair_construct(struct nvme_qpair *qpair,
 	qpair->num_trackers = num_trackers;
 	qpair->ctrlr = ctrlr;
 
-	if (ctrlr->msix_enabled) {
+	if (ctrlr->msix_enabled && !qpair->poll_enabled) {
 		/*
 		 * MSI-X vector resource IDs start at 1, so we add one to
 		 *  the queue's vector to get the corresponding rid to use.
@@ -796,6 +913,16 @@ nvme_qpair_construct(struct nvme_qpair *qpair,
 	qpair->act_tr = malloc_domainset(sizeof(struct nvme_tracker *) *
 	    qpair->num_entries, M_NVME, DOMAINSET_PREF(qpair->domain),
 	    M_ZERO | M_WAITOK);
+	if (qpair->poll_enabled) {
+		if (kproc_kthread_add(nvme_qpair_poll_thread, qpair,
+		    &nvme_poll_proc, &qpair->poll_td, 0, 0, "nvmepoll",
+		    "nvme%dq%d", device_get_unit(ctrlr->dev),
+		    qpair->id - 1) != 0) {
+			nvme_printf(ctrlr, "unable to create polling thread\n");
+			goto out;
+		}
+	}
+
 	return (0);
 
 out:
@@ -808,6 +935,16 @@ nvme_qpair_destroy(struct nvme_qpair *qpair)
 {
 	struct nvme_tracker	*tr;
 
+	if (qpair->poll_td != NULL) {
+		mtx_lock(&qpair->lock);
+		qpair->poll_exit = true;
+		wakeup(qpair);
+		while (qpair->poll_td != NULL)
+			msleep(&qpair->poll_td, &qpair->lock, 0, "nvmepollx",
+			    hz);
+		mtx_unlock(&qpair->lock);
+	}
+
 	if (qpair->tag) {
 		bus_teardown_intr(qpair->ctrlr->dev, qpair->res, qpair->tag);
 		qpair->tag = NULL;
@@ -960,6 +1097,9 @@ nvme_qpair_submit_tracker(struct nvme_qpair *qpair, struct nvme_tracker *tr)
 	qpair->act_tr[tr->cid] = tr;
 	ctrlr = qpair->ctrlr;
 
+	if (qpair->lat_tracking)
+		tr->submit_ts = getsbinuptime();
+
 	if (req->timeout) {
 		if (req->cb_fn == nvme_completion_poll_cb)
 			timeout = hz;
@@ -985,8 +1125,22 @@ nvme_qpair_submit_tracker(struct nvme_qpair *qpair, struct nvme_tracker *tr)
 	wmb();
 #endif
 
-	bus_space_write_4(qpair->ctrlr->bus_tag, qpair->ctrlr->bus_handle,
-	    qpair->sq_tdbl_off, qpair->sq_tail);
+	/*
+	 * While a batch is open, defer the doorbell write; it is coalesced
+	 *  into a single write by nvme_qpair_batch_done().  Never defer in a
+	 *  panic context, since the batch owner may never run again.
+	 */
+	if (!qpair->batching || dumping || SCHEDULER_STOPPED()) {
+		bus_space_write_4(qpair->ctrlr->bus_tag,
+		    qpair->ctrlr->bus_handle, qpair->sq_tdbl_off,
+		    qpair->sq_tail);
+	} else
+		qpair->db_pending = true;
+
+	if (qpair->poll_sleeping) {
+		qpair->poll_sleeping = false;
+		wakeup(qpair);
+	}
 	qpair->num_cmds++;
 }
 
@@ -1156,6 +1310,8 @@ nvme_qpair_reset(struct nvme_qpair *qpair)
 {
 
 	qpair->sq_head = qpair->sq_tail = qpair->cq_head = 0;
+	qpair->batching = false;
+	qpair->db_pending = false;
 
 	/*
 	 * First time through the completion queue, HW will set phase
@@ -1220,6 +1376,7 @@ nvme_io_qpair_enable(struct nvme_qpair *qpair)
 	STAILQ_INIT(&temp);
 	STAILQ_SWAP(&qpair->queued_req, &temp, nvme_request);
 
+	qpair->batching = true;
 	while (!STAILQ_EMPTY(&temp)) {
 		req = STAILQ_FIRST(&temp);
 		STAILQ_REMOVE_HEAD(&temp, stailq);
@@ -1227,6 +1384,7 @@ nvme_io_qpair_enable(struct nvme_qpair *qpair)
 		nvme_qpair_print_command(qpair, &req->cmd);
 		_nvme_qpair_submit_request(qpair, req);
 	}
+	nvme_qpair_batch_done(qpair);
 
 	mtx_unlock(&qpair->lock);
 }
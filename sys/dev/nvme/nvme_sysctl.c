@@ -33,6 +33,7 @@ __FBSDID("$FreeBSD$");
 
 #include <sys/param.h>
 #include <sys/bus.h>
+#include <sys/sbuf.h>
 #include <sys/sysctl.h>
 
 #include "nvme_private.h"
@@ -161,6 +162,23 @@ nvme_sysctl_timeout_period(SYSCTL_HANDLER_ARGS)
 	return (0);
 }
 
+static int
+nvme_sysctl_latency_histogram(SYSCTL_HANDLER_ARGS)
+{
+	struct nvme_qpair 	*qpair = arg1;
+	struct sbuf		sb;
+	int			error, i;
+
+	sbuf_new_for_sysctl(&sb, NULL, NVME_LATENCY_BUCKETS * 8, req);
+	for (i = 0; i < NVME_LATENCY_BUCKETS; i++)
+		sbuf_printf(&sb, "%s%jd", i == 0 ? "" : " ",
+		    (intmax_t)qpair->lat_hist[i]);
+	error = sbuf_finish(&sb);
+	sbuf_delete(&sb);
+
+	return (error);
+}
+
 static void
 nvme_qpair_reset_stats(struct nvme_qpair *qpair)
 {
@@ -169,6 +187,7 @@ nvme_qpair_reset_stats(struct nvme_qpair *qpair)
 	qpair->num_intr_handler_calls = 0;
 	qpair->num_retries = 0;
 	qpair->num_failures = 0;
+	memset(qpair->lat_hist, 0, sizeof(qpair->lat_hist));
 }
 
 static int
@@ -287,6 +306,14 @@ nvme_sysctl_initialize_queue(struct nvme_qpair *qpair,
 	    CTLFLAG_RD, &qpair->num_failures,
 	    "Number of commands ending in failure after all retries");
 
+	SYSCTL_ADD_BOOL(ctrlr_ctx, que_list, OID_AUTO, "poll_enabled",
+	    CTLFLAG_RD, &qpair->poll_enabled, 0,
+	    "Completions are reaped by a polling thread instead of MSI-X");
+	SYSCTL_ADD_PROC(ctrlr_ctx, que_list, OID_AUTO,
+	    "latency_histogram", CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE,
+	    qpair, 0, nvme_sysctl_latency_histogram, "A",
+	    "Completion counts per power-of-two microsecond latency bucket");
+
 	SYSCTL_ADD_PROC(ctrlr_ctx, que_list, OID_AUTO,
 	    "dump_debug", CTLTYPE_UINT | CTLFLAG_RW | CTLFLAG_NEEDGIANT,
 	    qpair, 0, nvme_sysctl_dump_debug, "IU", "Dump debug data");
@@ -68,8 +68,10 @@ __FBSDID("$FreeBSD$");
 #include <sys/systm.h>
 #include <sys/errno.h>
 #include <sys/param.h>
+#include <sys/capsicum.h>
 #include <sys/kernel.h>
 #include <sys/conf.h>
+#include <sys/file.h>
 #include <sys/uio.h>
 #include <sys/malloc.h>
 #include <sys/queue.h>
@@ -100,6 +102,7 @@ SDT_PROBE_DEFINE2(fusefs, , device, trace, "int", "char*");
 static struct cdev *fuse_dev;
 
 static d_kqfilter_t fuse_device_filter;
+static d_ioctl_t fuse_device_ioctl;
 static d_open_t fuse_device_open;
 static d_poll_t fuse_device_poll;
 static d_read_t fuse_device_read;
@@ -107,6 +110,7 @@ static d_write_t fuse_device_write;
 
 static struct cdevsw fuse_device_cdevsw = {
 	.d_kqfilter = fuse_device_filter,
+	.d_ioctl = fuse_device_ioctl,
 	.d_open = fuse_device_open,
 	.d_name = "fuse",
 	.d_poll = fuse_device_poll,
@@ -130,6 +134,53 @@ struct filterops fuse_device_rfiltops = {
  *
  ****************************/
 
+/*
+ * Tear down a cloned message channel.  Unsent messages still sitting on
+ * its queue are handed back to the session's primary queue, unless the
+ * session is already dead, in which case they are dropped like in
+ * fdata_dtor().
+ */
+static void
+fuse_channel_dtor(struct fuse_data *chan)
+{
+	struct fuse_data *master;
+	struct fuse_ticket *tick;
+	int i;
+
+	master = chan->master;
+
+	FUSE_LOCK();
+	fuse_lck_mtx_lock(master->ms_mtx);
+	for (i = 0; i < master->nchannels; i++) {
+		if (master->channels[i] == chan) {
+			master->nchannels--;
+			master->channels[i] =
+			    master->channels[master->nchannels];
+			master->channels[master->nchannels] = NULL;
+			break;
+		}
+	}
+	fuse_lck_mtx_lock(chan->ms_mtx);
+	selwakeuppri(&chan->ks_rsel, PZERO + 1);
+	if (chan->ms_count != 0 && !fdata_get_dead(master)) {
+		while ((tick = fuse_ms_pop(chan))) {
+			STAILQ_INSERT_TAIL(&master->ms_head, tick, tk_ms_link);
+			master->ms_count++;
+		}
+		wakeup_one(master);
+		selwakeuppri(&master->ks_rsel, PZERO + 1);
+		KNOTE_LOCKED(&master->ks_rsel.si_note, 0);
+	}
+	while ((tick = fuse_ms_pop(chan))) {
+		fuse_ticket_drop(tick);
+	}
+	fuse_lck_mtx_unlock(chan->ms_mtx);
+	fuse_lck_mtx_unlock(master->ms_mtx);
+	fdata_trydestroy(chan);
+	fdata_trydestroy(master);
+	FUSE_UNLOCK();
+}
+
 static void
 fdata_dtor(void *arg)
 {
@@ -140,6 +191,11 @@ fdata_dtor(void *arg)
 	if (fdata == NULL)
 		return;
 
+	if (fdata->master != NULL) {
+		fuse_channel_dtor(fdata);
+		return;
+	}
+
 	fdata_set_dead(fdata);
 
 	FUSE_LOCK();
@@ -273,6 +329,82 @@ fuse_device_poll(struct cdev *dev, int events, struct thread *td)
 	return (revents);
 }
 
+/*
+ * Attach a freshly opened /dev/fuse fd to an existing session as an
+ * additional message channel, so that several daemon reader threads can
+ * drain requests in parallel on their own locks.  The argument of
+ * FUSE_DEV_IOC_CLONE is the session's original fd.
+ */
+static int
+fuse_device_clone(struct fuse_data *data, uint32_t masterfd,
+    struct thread *td)
+{
+	struct fuse_data *master;
+	struct file *fp, *fptmp;
+	int err;
+
+	err = fget(td, masterfd, &cap_read_rights, &fp);
+	if (err != 0)
+		return (err);
+	fptmp = td->td_fpop;
+	td->td_fpop = fp;
+	err = devfs_get_cdevpriv((void **)&master);
+	td->td_fpop = fptmp;
+	fdrop(fp, td);
+	if (err != 0)
+		return (ENXIO);
+	if (master == NULL || master == data || master->master != NULL)
+		return (EINVAL);
+
+	FUSE_LOCK();
+	/* The fd being cloned onto must not be part of a session yet */
+	if (data->master != NULL || data->mp != NULL || data->nchannels != 0) {
+		FUSE_UNLOCK();
+		return (EBUSY);
+	}
+	if (fdata_get_dead(master)) {
+		FUSE_UNLOCK();
+		return (ENOTCONN);
+	}
+	fuse_lck_mtx_lock(master->ms_mtx);
+	if (master->nchannels >= FUSE_DEV_MAX_CHANNELS) {
+		fuse_lck_mtx_unlock(master->ms_mtx);
+		FUSE_UNLOCK();
+		return (EBUSY);
+	}
+	master->channels[master->nchannels] = data;
+	master->nchannels++;
+	data->master = master;
+	master->ref++;
+	fuse_lck_mtx_unlock(master->ms_mtx);
+	FUSE_UNLOCK();
+
+	SDT_PROBE2(fusefs, , device, trace, 1, "channel cloned");
+	return (0);
+}
+
+static int
+fuse_device_ioctl(struct cdev *dev, u_long cmd, caddr_t addr, int flags,
+    struct thread *td)
+{
+	struct fuse_data *data;
+	int err;
+
+	err = devfs_get_cdevpriv((void **)&data);
+	if (err != 0)
+		return (err);
+
+	switch (cmd) {
+	case FUSE_DEV_IOC_CLONE:
+		err = fuse_device_clone(data, *(uint32_t *)addr, td);
+		break;
+	default:
+		err = ENOTTY;
+		break;
+	}
+	return (err);
+}
+
 /*
  * fuse_device_read hangs on the queue of VFS messages.
  * When it's notified that there is a new one, it picks that and
@@ -440,6 +572,9 @@ fuse_device_write(struct cdev *dev, struct uio *uio, int ioflag)
 	err = devfs_get_cdevpriv((void **)&data);
 	if (err != 0)
 		return (err);
+	/* Answers written to a cloned channel belong to the session */
+	if (data->master != NULL)
+		data = data->master;
 	mp = data->mp;
 
 	if (uio->uio_resid < sizeof(struct fuse_out_header)) {
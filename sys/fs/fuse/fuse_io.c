@@ -845,6 +845,14 @@ again:
 	         * significant cache coherency problems with multiple clients,
 	         * especially if locking is implemented later on.
 	         *
+	         * In writeback cache mode we do merge them: the protocol
+	         * presumes this client owns the file's cache, the clean
+	         * bytes between the two ranges are valid courtesy of
+	         * B_CACHE, and the daemon is told via FUSE_WRITE_CACHE
+	         * that it is receiving cached data.  This keeps workloads
+	         * that dirty a block at scattered offsets from paying a
+	         * synchronous round trip to the daemon per range.
+	         *
 	         * as an optimization we could theoretically maintain
 	         * a linked list of discontinuous areas, but we would still
 	         * have to commit them separately so there isn't much
@@ -852,7 +860,9 @@ again:
 	         */
 
 		if (bp->b_dirtyend > 0 &&
-		    (on > bp->b_dirtyend || (on + n) < bp->b_dirtyoff)) {
+		    (on > bp->b_dirtyend || (on + n) < bp->b_dirtyoff) &&
+		    !(fsess_opt_writeback(vnode_mount(vp)) &&
+		    (bp->b_flags & B_CACHE) != 0)) {
 			/*
 	                 * Yes, we mean it. Write out everything to "storage"
 	                 * immediately, without hesitation. (Apart from other
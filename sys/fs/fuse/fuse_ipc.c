@@ -185,6 +185,28 @@ fuse_interrupt_callback(struct fuse_ticket *tick, struct uio *uio)
 	}
 }
 
+/*
+ * Remove otick from the given message queue, if it is there.  The queue's
+ * ms_mtx must be held.
+ */
+static bool
+fuse_ms_steal(struct fuse_data *queue, struct fuse_ticket *otick)
+{
+	struct fuse_ticket *tick, *xtick;
+
+	mtx_assert(&queue->ms_mtx, MA_OWNED);
+	STAILQ_FOREACH_SAFE(tick, &queue->ms_head, tk_ms_link, xtick) {
+		if (tick == otick) {
+			STAILQ_REMOVE(&queue->ms_head, tick, fuse_ticket,
+				tk_ms_link);
+			queue->ms_count--;
+			otick->tk_ms_link.stqe_next = NULL;
+			return (true);
+		}
+	}
+	return (false);
+}
+
 /* Interrupt the operation otick.  Return err as its error code */
 void
 fuse_interrupt_send(struct fuse_ticket *otick, int err)
@@ -193,38 +215,39 @@ fuse_interrupt_send(struct fuse_ticket *otick, int err)
 	struct fuse_interrupt_in *fii;
 	struct fuse_in_header *ftick_hdr;
 	struct fuse_data *data = otick->tk_data;
-	struct fuse_ticket *tick, *xtick;
+	struct fuse_data *queue;
 	struct ucred reused_creds;
 	gid_t reused_groups[1];
+	bool found;
+	int i;
 
 	if (otick->irq_unique == 0) {
-		/* 
+		/*
 		 * If the daemon hasn't yet received otick, then we can answer
-		 * it ourselves and return.
+		 * it ourselves and return.  The ticket may sit on the primary
+		 * message queue or on any cloned channel.
 		 */
 		fuse_lck_mtx_lock(data->ms_mtx);
-		STAILQ_FOREACH_SAFE(tick, &otick->tk_data->ms_head, tk_ms_link,
-			xtick) {
-			if (tick == otick) {
-				STAILQ_REMOVE(&otick->tk_data->ms_head, tick,
-					fuse_ticket, tk_ms_link);
-				otick->tk_data->ms_count--;
-				otick->tk_ms_link.stqe_next = NULL;
-				fuse_lck_mtx_unlock(data->ms_mtx);
-
-				fuse_lck_mtx_lock(otick->tk_aw_mtx);
-				if (!fticket_answered(otick)) {
-					fticket_set_answered(otick);
-					otick->tk_aw_errno = err;
-					wakeup(otick);
-				}
-				fuse_lck_mtx_unlock(otick->tk_aw_mtx);
-
-				fuse_ticket_drop(tick);
-				return;
-			}
+		found = fuse_ms_steal(data, otick);
+		for (i = 0; !found && i < data->nchannels; i++) {
+			queue = data->channels[i];
+			fuse_lck_mtx_lock(queue->ms_mtx);
+			found = fuse_ms_steal(queue, otick);
+			fuse_lck_mtx_unlock(queue->ms_mtx);
 		}
 		fuse_lck_mtx_unlock(data->ms_mtx);
+		if (found) {
+			fuse_lck_mtx_lock(otick->tk_aw_mtx);
+			if (!fticket_answered(otick)) {
+				fticket_set_answered(otick);
+				otick->tk_aw_errno = err;
+				wakeup(otick);
+			}
+			fuse_lck_mtx_unlock(otick->tk_aw_mtx);
+
+			fuse_ticket_drop(otick);
+			return;
+		}
 
 		/*
 		 * If the fuse daemon doesn't support interrupts, then there's
@@ -623,6 +646,9 @@ fdata_trydestroy(struct fuse_data *data)
 void
 fdata_set_dead(struct fuse_data *data)
 {
+	struct fuse_data *chan;
+	int i;
+
 	FUSE_LOCK();
 	if (fdata_get_dead(data)) {
 		FUSE_UNLOCK();
@@ -633,6 +659,15 @@ fdata_set_dead(struct fuse_data *data)
 	wakeup_one(data);
 	selwakeuppri(&data->ks_rsel, PZERO + 1);
 	wakeup(&data->ticketer);
+	/* Kick the readers of any cloned channels, too */
+	for (i = 0; i < data->nchannels; i++) {
+		chan = data->channels[i];
+		fuse_lck_mtx_lock(chan->ms_mtx);
+		chan->dataflags |= FSESS_DEAD;
+		wakeup_one(chan);
+		selwakeuppri(&chan->ks_rsel, PZERO + 1);
+		fuse_lck_mtx_unlock(chan->ms_mtx);
+	}
 	fuse_lck_mtx_unlock(data->ms_mtx);
 	FUSE_UNLOCK();
 }
@@ -693,23 +728,43 @@ fuse_insert_callback(struct fuse_ticket *ftick, fuse_handler_t * handler)
 void
 fuse_insert_message(struct fuse_ticket *ftick, bool urgent)
 {
+	struct fuse_data *data = ftick->tk_data;
+	struct fuse_data *queue;
+	int idx;
+
 	if (ftick->tk_flag & FT_DIRTY) {
 		panic("FUSE: ticket reused without being refreshed");
 	}
 	ftick->tk_flag |= FT_DIRTY;
 
-	if (fdata_get_dead(ftick->tk_data)) {
+	if (fdata_get_dead(data)) {
 		return;
 	}
-	fuse_lck_mtx_lock(ftick->tk_data->ms_mtx);
+	fuse_lck_mtx_lock(data->ms_mtx);
+	/*
+	 * Spread ordinary messages across the session's cloned channels so
+	 * that daemon reader threads contend on their own queue lock and
+	 * receive targeted wakeups.  Urgent messages stay on the primary
+	 * queue, which every session has a reader for.
+	 */
+	queue = data;
+	if (!urgent && data->nchannels != 0) {
+		idx = curcpu % (data->nchannels + 1);
+		if (idx != 0) {
+			queue = data->channels[idx - 1];
+			fuse_lck_mtx_lock(queue->ms_mtx);
+		}
+	}
 	if (urgent)
-		fuse_ms_push_head(ftick);
+		fuse_ms_push_head(queue, ftick);
 	else
-		fuse_ms_push(ftick);
-	wakeup_one(ftick->tk_data);
-	selwakeuppri(&ftick->tk_data->ks_rsel, PZERO + 1);
-	KNOTE_LOCKED(&ftick->tk_data->ks_rsel.si_note, 0);
-	fuse_lck_mtx_unlock(ftick->tk_data->ms_mtx);
+		fuse_ms_push(queue, ftick);
+	wakeup_one(queue);
+	selwakeuppri(&queue->ks_rsel, PZERO + 1);
+	KNOTE_LOCKED(&queue->ks_rsel.si_note, 0);
+	if (queue != data)
+		fuse_lck_mtx_unlock(queue->ms_mtx);
+	fuse_lck_mtx_unlock(data->ms_mtx);
 }
 
 static int
@@ -178,6 +178,9 @@ fticket_opcode(struct fuse_ticket *ftick)
 
 int fticket_pull(struct fuse_ticket *ftick, struct uio *uio);
 
+/* Limit on FUSE_DEV_IOC_CLONE message channels per session */
+#define	FUSE_DEV_MAX_CHANNELS	64
+
 /*
  * The data representing a FUSE session.
  */
@@ -193,6 +196,18 @@ struct fuse_data {
 	STAILQ_HEAD(, fuse_ticket)	ms_head;
 	int				ms_count;
 
+	/*
+	 * Cloned message channels.  A clone is a fuse_data that carries no
+	 * session state of its own; it is just an additional message queue
+	 * (ms_mtx/ms_head/ks_rsel) that one or more daemon reader threads
+	 * drain through their own /dev/fuse fd.  "master" points from a
+	 * clone back to the session; "channels" is only used on the master
+	 * and is protected by the master's ms_mtx.
+	 */
+	struct fuse_data		*master;
+	struct fuse_data		*channels[FUSE_DEV_MAX_CHANNELS];
+	int				nchannels;
+
 	struct mtx			aw_mtx;
 	TAILQ_HEAD(, fuse_ticket)	aw_head;
 
@@ -283,24 +298,24 @@ fsess_opt_writeback(struct mount *mp)
 	return (data->cache_mode == FUSE_CACHE_WB);
 }
 
-/* Insert a new upgoing message */
+/* Insert a new upgoing message on the given queue */
 static inline void
-fuse_ms_push(struct fuse_ticket *ftick)
+fuse_ms_push(struct fuse_data *queue, struct fuse_ticket *ftick)
 {
-	mtx_assert(&ftick->tk_data->ms_mtx, MA_OWNED);
+	mtx_assert(&queue->ms_mtx, MA_OWNED);
 	refcount_acquire(&ftick->tk_refcount);
-	STAILQ_INSERT_TAIL(&ftick->tk_data->ms_head, ftick, tk_ms_link);
-	ftick->tk_data->ms_count++;
+	STAILQ_INSERT_TAIL(&queue->ms_head, ftick, tk_ms_link);
+	queue->ms_count++;
 }
 
-/* Insert a new upgoing message to the front of the queue */
+/* Insert a new upgoing message to the front of the given queue */
 static inline void
-fuse_ms_push_head(struct fuse_ticket *ftick)
+fuse_ms_push_head(struct fuse_data *queue, struct fuse_ticket *ftick)
 {
-	mtx_assert(&ftick->tk_data->ms_mtx, MA_OWNED);
+	mtx_assert(&queue->ms_mtx, MA_OWNED);
 	refcount_acquire(&ftick->tk_refcount);
-	STAILQ_INSERT_HEAD(&ftick->tk_data->ms_head, ftick, tk_ms_link);
-	ftick->tk_data->ms_count++;
+	STAILQ_INSERT_HEAD(&queue->ms_head, ftick, tk_ms_link);
+	queue->ms_count++;
 }
 
 static inline struct fuse_ticket *
@@ -751,4 +751,12 @@ struct fuse_notify_retrieve_in {
 	uint64_t	dummy4;
 };
 
+/*
+ * Device ioctls.  The argument of FUSE_DEV_IOC_CLONE is the session's
+ * original /dev/fuse file descriptor; the ioctl is issued on a freshly
+ * opened /dev/fuse fd, which becomes an additional message channel of
+ * the session.  The numbering matches Linux for libfuse compatibility.
+ */
+#define	FUSE_DEV_IOC_CLONE	_IOW(229, 0, uint32_t)
+
 #endif /* _FUSE_FUSE_KERNEL_H */
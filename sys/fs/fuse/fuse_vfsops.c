@@ -394,6 +394,13 @@ fuse_vfsop_mount(struct mount *mp)
 		FUSE_UNLOCK();
 		goto out;
 	}
+	if (data->master != NULL) {
+		err = ENXIO;
+		SDT_PROBE4(fusefs, , vfsops, mount_err,
+			"cannot mount a cloned channel", data, mp, err);
+		FUSE_UNLOCK();
+		goto out;
+	}
 	/* Sanity + permission checks */
 	if (!data->daemoncred)
 		panic("fuse daemon found, but identity unknown");
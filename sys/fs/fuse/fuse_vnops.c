@@ -567,6 +567,19 @@ fuse_vnop_close(struct vop_close_args *ap)
 	if (fflag & IO_NDELAY)
 		return 0;
 
+	/*
+	 * In writeback cache mode the daemon may not have seen delayed
+	 * writes yet.  Push them before FUSE_FLUSH so that a daemon
+	 * implementing close-to-open consistency commits the file's data
+	 * when it handles the flush.
+	 */
+	if (fsess_opt_writeback(vnode_mount(vp)) &&
+	    vp->v_bufobj.bo_dirty.bv_cnt > 0) {
+		err = fuse_io_flushbuf(vp, MNT_WAIT, td);
+		if (err != 0)
+			return (err);
+	}
+
 	err = fuse_flush(vp, cred, pid, fflag);
 	/* TODO: close the file handle, if we're sure it's no longer used */
 	if ((VTOFUD(vp)->flag & FN_SIZECHANGE) != 0) {
@@ -136,6 +136,23 @@ struct fatcache {
 	(dep)->de_fc[(slot)].fc_frcn = (frcn); \
 	(dep)->de_fc[(slot)].fc_fsrcn = (fsrcn);
 
+/*
+ * The FAT extent cache.  As pcbmap() walks a file's cluster chain, runs
+ * of contiguous clusters are collapsed into extents and recorded here, so
+ * that later lookups within the already walked prefix of the file resolve
+ * in O(log(extents)) time without rereading FAT blocks.  The extent array
+ * is built lazily, never grows beyond FE_MAX entries and is purged along
+ * with the FAT cache above when the cluster chain is truncated.
+ */
+struct fatextent {
+	u_long fe_frcn;		/* first file relative cluster number */
+	u_long fe_fsrcn;	/* first filesystem relative cluster number */
+	u_long fe_len;		/* number of contiguous clusters */
+};
+
+#define	FE_INIT		8	/* initial size of the extent array */
+#define	FE_MAX		128	/* maximum size of the extent array */
+
 /*
  * This is the in memory variant of a dos directory entry.  It is usually
  * contained within a vnode.
@@ -161,6 +178,9 @@ struct denode {
 	u_long de_StartCluster; /* starting cluster of file */
 	u_long de_FileSize;	/* size of file in bytes */
 	struct fatcache de_fc[FC_SIZE];	/* FAT cache */
+	struct fatextent *de_fe; /* FAT extent cache */
+	int de_fecnt;		/* number of valid extents in de_fe */
+	int de_femax;		/* allocated size of de_fe */
 	u_quad_t de_modrev;	/* Revision level for lease. */
 	uint64_t de_inode;	/* Inode number (really byte offset of direntry) */
 };
@@ -103,6 +103,7 @@ int fatentry(int function, struct msdosfsmount *pmp, u_long cluster, u_long *old
 int freeclusterchain(struct msdosfsmount *pmp, u_long startchain);
 int extendfile(struct denode *dep, u_long count, struct buf **bpp, u_long *ncp, int flags);
 void fc_purge(struct denode *dep, u_int frcn);
+void fce_free(struct denode *dep);
 int markvoldirty_upgrade(struct msdosfsmount *pmp, bool dirty, bool rw_upgrade);
 
 static inline int
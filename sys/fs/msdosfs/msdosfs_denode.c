@@ -562,6 +562,7 @@ msdosfs_reclaim(struct vop_reclaim_args *ap)
 #if 0 /* XXX */
 	dep->de_flag = 0;
 #endif
+	fce_free(dep);
 	free(dep, M_MSDOSFSNODE);
 	vp->v_data = NULL;
 
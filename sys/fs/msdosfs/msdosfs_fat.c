@@ -53,6 +53,7 @@
 #include <sys/param.h>
 #include <sys/systm.h>
 #include <sys/buf.h>
+#include <sys/malloc.h>
 #include <sys/mount.h>
 #include <sys/vmmeter.h>
 #include <sys/vnode.h>
@@ -65,6 +66,9 @@
 
 #define	FULL_RUN	((u_int)0xffffffff)
 
+static MALLOC_DEFINE(M_MSDOSFSFATCACHE, "msdosfs_fatcache",
+    "MSDOSFS FAT extent cache");
+
 static int	chainalloc(struct msdosfsmount *pmp, u_long start,
 		    u_long count, u_long fillwith, u_long *retcluster,
 		    u_long *got);
@@ -76,6 +80,10 @@ static int	fatchain(struct msdosfsmount *pmp, u_long start, u_long count,
 		    u_long fillwith);
 static void	fc_lookup(struct denode *dep, u_long findcn, u_long *frcnp,
 		    u_long *fsrcnp);
+static void	fce_add(struct denode *dep, u_long frcn, u_long fsrcn);
+static void	fce_lookup(struct denode *dep, u_long findcn, u_long *frcnp,
+		    u_long *fsrcnp);
+static void	fce_purge(struct denode *dep, u_int frcn);
 static void	updatefats(struct msdosfsmount *pmp, struct buf *bp,
 		    u_long fatbn);
 static __inline void
@@ -185,6 +193,7 @@ pcbmap(struct denode *dep, u_long findcn, daddr_t *bnp, u_long *cnp, int *sp)
 	 */
 	i = 0;
 	fc_lookup(dep, findcn, &i, &cn);
+	fce_lookup(dep, findcn, &i, &cn);
 
 	/*
 	 * Handle all other files or directories the normal way.
@@ -195,6 +204,7 @@ pcbmap(struct denode *dep, u_long findcn, daddr_t *bnp, u_long *cnp, int *sp)
 		 */
 		if ((cn | ~pmp->pm_fatmask) >= CLUST_RSRVD)
 			goto hiteof;
+		fce_add(dep, i, cn);
 		byteoffset = FATOFS(pmp, cn);
 		fatblock(pmp, byteoffset, &bn, &bsize, &bo);
 		if (bn != bp_bn) {
@@ -237,6 +247,7 @@ pcbmap(struct denode *dep, u_long findcn, daddr_t *bnp, u_long *cnp, int *sp)
 			*bnp = cntobn(pmp, cn);
 		if (cnp)
 			*cnp = cn;
+		fce_add(dep, i, cn);
 		fc_setcache(dep, FC_LASTMAP, i, cn);
 		return (0);
 	}
@@ -294,6 +305,125 @@ fc_purge(struct denode *dep, u_int frcn)
 		if (fcp->fc_frcn >= frcn)
 			fcp->fc_frcn = FCE_EMPTY;
 	}
+	fce_purge(dep, frcn);
+}
+
+/*
+ * Record the mapping of file relative cluster frcn to filesystem relative
+ * cluster fsrcn in the extent cache, merging it into the last extent when
+ * both cluster numbers continue a contiguous run.  Mappings that are
+ * already covered by the cache, or that cannot be recorded because the
+ * array is full or cannot be grown, are silently ignored; the cache never
+ * has to be complete, only correct.
+ */
+static void
+fce_add(struct denode *dep, u_long frcn, u_long fsrcn)
+{
+	struct fatextent *fep;
+	int newmax;
+
+	ASSERT_VOP_LOCKED(DETOV(dep), "fce_add");
+
+	if (dep->de_fecnt > 0) {
+		fep = &dep->de_fe[dep->de_fecnt - 1];
+		if (frcn == fep->fe_frcn + fep->fe_len &&
+		    fsrcn == fep->fe_fsrcn + fep->fe_len) {
+			fep->fe_len++;
+			return;
+		}
+		if (frcn < fep->fe_frcn + fep->fe_len)
+			return;
+	}
+	if (dep->de_fecnt == dep->de_femax) {
+		if (dep->de_femax >= FE_MAX)
+			return;
+		newmax = dep->de_femax == 0 ? FE_INIT : 2 * dep->de_femax;
+		fep = realloc(dep->de_fe, newmax * sizeof(struct fatextent),
+		    M_MSDOSFSFATCACHE, M_NOWAIT);
+		if (fep == NULL)
+			return;
+		dep->de_fe = fep;
+		dep->de_femax = newmax;
+	}
+	fep = &dep->de_fe[dep->de_fecnt++];
+	fep->fe_frcn = frcn;
+	fep->fe_fsrcn = fsrcn;
+	fep->fe_len = 1;
+}
+
+/*
+ * Look for file relative cluster findcn in the extent cache.  If it is
+ * covered by an extent, return its mapping.  Otherwise, when the cache
+ * knows a mapping closer to findcn than the (*frcnp, *fsrcnp) starting
+ * point found by fc_lookup(), return that, so that the FAT walk resumes
+ * from the end of the cached prefix.
+ */
+static void
+fce_lookup(struct denode *dep, u_long findcn, u_long *frcnp, u_long *fsrcnp)
+{
+	struct fatextent *fep;
+	int hi, lo, mid;
+
+	ASSERT_VOP_LOCKED(DETOV(dep), "fce_lookup");
+
+	if (dep->de_fecnt == 0 || dep->de_fe[0].fe_frcn > findcn)
+		return;
+
+	/*
+	 * Binary search for the extent with the largest fe_frcn that is
+	 * not beyond findcn.
+	 */
+	lo = 0;
+	hi = dep->de_fecnt - 1;
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		if (dep->de_fe[mid].fe_frcn <= findcn)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	fep = &dep->de_fe[lo];
+	if (findcn < fep->fe_frcn + fep->fe_len) {
+		*frcnp = findcn;
+		*fsrcnp = fep->fe_fsrcn + (findcn - fep->fe_frcn);
+	} else if (fep->fe_frcn + fep->fe_len - 1 > *frcnp) {
+		*frcnp = fep->fe_frcn + fep->fe_len - 1;
+		*fsrcnp = fep->fe_fsrcn + fep->fe_len - 1;
+	}
+}
+
+/*
+ * Purge all extent cache entries for file relative cluster frcn and
+ * beyond, truncating an extent that straddles frcn.
+ */
+static void
+fce_purge(struct denode *dep, u_int frcn)
+{
+	struct fatextent *fep;
+	int i;
+
+	for (i = dep->de_fecnt - 1; i >= 0; i--) {
+		fep = &dep->de_fe[i];
+		if (fep->fe_frcn >= frcn)
+			dep->de_fecnt = i;
+		else if (fep->fe_frcn + fep->fe_len > frcn) {
+			fep->fe_len = frcn - fep->fe_frcn;
+			break;
+		} else
+			break;
+	}
+}
+
+/*
+ * Release the memory held by the extent cache, upon denode reclamation.
+ */
+void
+fce_free(struct denode *dep)
+{
+
+	free(dep->de_fe, M_MSDOSFSFATCACHE);
+	dep->de_fe = NULL;
+	dep->de_fecnt = dep->de_femax = 0;
 }
 
 /*
@@ -115,10 +115,14 @@ struct nfsrvcache {
 
 LIST_HEAD(nfsrvhashhead, nfsrvcache);
 
-/* The fine-grained locked cache hash table for TCP. */
+/*
+ * The fine-grained locked cache hash table for TCP.
+ * Buckets are padded out to a cache line so that concurrent nfsd
+ * threads acquiring different bucket mutexes do not false share.
+ */
 struct nfsrchash_bucket {
 	struct mtx		mtx;
 	struct nfsrvhashhead	tbl;
-};
+} __aligned(CACHE_LINE_SIZE);
 
 #endif	/* _NFS_NFSRVCACHE_H_ */
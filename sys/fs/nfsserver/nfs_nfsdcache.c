@@ -844,7 +844,15 @@ nfsrc_trimcache(u_int64_t sockref, uint32_t snd_una, int final)
 	static time_t udp_lasttrim = 0, tcp_lasttrim = 0;
 	static int onethread = 0, oneslot = 0;
 
-	if (sockref != 0) {
+	if (sockref != 0 && !LIST_EMPTY(&NFSRCAHASH(sockref)->tbl)) {
+		/*
+		 * The unlocked emptiness check above can race with a
+		 * concurrent insertion, but missing the new entry is
+		 * harmless, since rc_acked only accelerates trimming
+		 * and the entry will still go away via its timeout.
+		 * This upcall runs for every TCP ACK received, so the
+		 * common empty case should not bounce the bucket lock.
+		 */
 		hbp = NFSRCAHASH(sockref);
 		mtx_lock(&hbp->mtx);
 		LIST_FOREACH_SAFE(rp, &hbp->tbl, rc_ahash, nextrp) {
@@ -170,6 +170,10 @@ SYSCTL_INT(_vfs_nfsd, OID_AUTO, enable_stringtouid, CTLFLAG_RW,
 static int nfsrv_pnfsgetdsattr = 1;
 SYSCTL_INT(_vfs_nfsd, OID_AUTO, pnfsgetdsattr, CTLFLAG_RW,
     &nfsrv_pnfsgetdsattr, 0, "When set getattr gets DS attributes via RPC");
+static int nfsrv_doloanread = 1;
+SYSCTL_INT(_vfs_nfsd, OID_AUTO, enable_loanread, CTLFLAG_RW,
+    &nfsrv_doloanread, 0,
+    "Enable nfsd to loan file pages to ext_pgs READ replies");
 
 /*
  * nfsrv_dsdirsize can only be increased and only when the nfsd threads are
@@ -905,6 +909,118 @@ nfsrv_createiovec_extpgs(int len, int maxextsiz, struct mbuf **mpp,
 	return (i);
 }
 
+/*
+ * Free routine for ext_pgs mbufs built by nfsrv_loanread().  Runs when
+ * the last reference on the mbuf goes away, normally after the TCP
+ * stack no longer needs the data for retransmission.
+ */
+static void
+nfsrv_free_loanedpages(struct mbuf *m)
+{
+	vm_page_t pg;
+	int i;
+
+	M_ASSERTEXTPG(m);
+
+	for (i = 0; i < m->m_epg_npgs; i++) {
+		pg = PHYS_TO_VM_PAGE(m->m_epg_pa[i]);
+		vm_page_release(pg, 0);
+	}
+}
+
+/*
+ * Try to build an ext_pgs mbuf chain for a Read reply of "len" bytes at
+ * "off" by loaning wired references on the file's resident pages into
+ * the chain, in the same way kern_sendfile.c does, instead of copying
+ * the data out of the buffer cache.  Returns true with the chain in
+ * *mpp/*mpendp upon success.  Returns false when any page in the range
+ * is not resident and fully valid, in which case the caller must fall
+ * back to reading into freshly allocated pages.
+ * The pages are snapshots in the sendfile sense; a concurrent write
+ * can modify them while they are in flight, just as it can for
+ * sendfile(2).
+ */
+static bool
+nfsrv_loanread(struct vnode *vp, off_t off, int len, int maxextsiz,
+    struct mbuf **mpp, struct mbuf **mpendp)
+{
+	struct mbuf *m, *m2, *m3;
+	vm_object_t obj;
+	vm_page_t pg, *pgs;
+	vm_pindex_t pindex;
+	int base, i, left, maxpgs, npages, siz;
+
+	obj = vp->v_object;
+	if (obj == NULL || (obj->flags & OBJ_DEAD) != 0 ||
+	    obj->type != OBJT_VNODE)
+		return (false);
+
+	/*
+	 * Acquire a wired reference on each page backing the range,
+	 * without sleeping.  A page that is absent, busy or not valid
+	 * for the bytes needed from it aborts the loan.
+	 */
+	pindex = OFF_TO_IDX(off);
+	npages = howmany((off & PAGE_MASK) + len, PAGE_SIZE);
+	pgs = malloc(npages * sizeof(vm_page_t), M_TEMP, M_WAITOK);
+	base = off & PAGE_MASK;
+	left = len;
+	for (i = 0; i < npages; i++) {
+		pg = vm_page_grab_unlocked(obj, pindex + i,
+		    VM_ALLOC_NORMAL | VM_ALLOC_NOBUSY | VM_ALLOC_WIRED |
+		    VM_ALLOC_NOCREAT | VM_ALLOC_NOWAIT);
+		siz = min(PAGE_SIZE - base, left);
+		if (pg == NULL || !vm_page_is_valid(pg, base, siz)) {
+			if (pg != NULL)
+				vm_page_release(pg, 0);
+			while (i-- > 0)
+				vm_page_release(pgs[i], 0);
+			free(pgs, M_TEMP);
+			return (false);
+		}
+		pgs[i] = pg;
+		base = 0;
+		left -= siz;
+	}
+
+	/*
+	 * Now hang the pages off ext_pgs mbufs, at most maxextsiz bytes
+	 * per mbuf, so that KERN_TLS can send each mbuf as one TLS record.
+	 */
+	maxpgs = maxextsiz / PAGE_SIZE;
+	if (maxpgs > MBUF_PEXT_MAX_PGS)
+		maxpgs = MBUF_PEXT_MAX_PGS;
+	else if (maxpgs < 1)
+		maxpgs = 1;
+	m2 = m3 = NULL;
+	base = off & PAGE_MASK;
+	left = len;
+	for (i = 0; i < npages; i++) {
+		if (i % maxpgs == 0) {
+			m = mb_alloc_ext_pgs(M_WAITOK,
+			    nfsrv_free_loanedpages);
+			m->m_epg_1st_off = base;
+			if (m3 != NULL)
+				m2->m_next = m;
+			else
+				m3 = m;
+			m2 = m;
+		}
+		siz = min(PAGE_SIZE - base, left);
+		m2->m_epg_pa[m2->m_epg_npgs++] = VM_PAGE_TO_PHYS(pgs[i]);
+		m2->m_epg_last_len = siz;
+		m2->m_len += siz;
+		m2->m_ext.ext_size += PAGE_SIZE;
+		MBUF_EXT_PGS_ASSERT_SANITY(m2);
+		base = 0;
+		left -= siz;
+	}
+	free(pgs, M_TEMP);
+	*mpp = m3;
+	*mpendp = m2;
+	return (true);
+}
+
 /*
  * Read vnode op call into mbuf list.
  */
@@ -930,6 +1046,27 @@ nfsvno_read(struct vnode *vp, off_t off, int cnt, struct ucred *cred,
 		return (error);
 
 	len = NFSM_RNDUP(cnt);
+	/*
+	 * For an ext_pgs reply, first attempt to loan the file's resident
+	 * pages into the reply instead of copying them.  This only works
+	 * when no XDR padding is needed, since the loaned pages are
+	 * read-only and the pad bytes could not be zeroed.
+	 * Note that no read ahead is triggered for a loaned reply.  When
+	 * a client reads ahead of the cached data, the fallback VOP_READ()
+	 * below does the read ahead, so a sequential reader alternates
+	 * between the two paths with most replies loaned.
+	 */
+	if (maxextsiz > 0 && nfsrv_doloanread != 0 && len == cnt &&
+	    nfsrv_loanread(vp, off, len, maxextsiz, &m3, &m)) {
+		uiop->uio_offset = off;
+		uiop->uio_resid = len;
+		nh = nfsrv_sequential_heuristic(uiop, vp);
+		nh->nh_nextoff = off + len;
+		nfsstatsv1.srvbytes[NFSV4OP_READ] += len;
+		*mpp = m3;
+		*mpendp = m;
+		goto out;
+	}
 	if (maxextsiz > 0)
 		uiop->uio_iovcnt = nfsrv_createiovec_extpgs(len, maxextsiz,
 		    &m3, &m, &iv);
@@ -44,26 +44,36 @@
 #include <sys/malloc.h>
 #include <sys/mount.h>
 #include <sys/proc.h>
+#include <sys/smr.h>
 #include <sys/vnode.h>
 
 #include <fs/nullfs/null.h>
 
+#include <vm/uma.h>
+
 /*
  * Null layer cache:
  * Each cache entry holds a reference to the lower vnode
  * along with a pointer to the alias vnode.  When an
  * entry is added the lower vnode is VREF'd.  When the
  * alias is removed the lower vnode is vrele'd.
+ *
+ * Lookups run lock-free under vfs_smr; modifications are serialized by
+ * null_hash_lock.  The mount pointer is mixed into the bucket index so
+ * that many nullfs mounts stacked over the same lower file system do
+ * not chain their aliases of a given lower vnode into a single bucket.
  */
 
-#define	NULL_NHASH(vp) (&null_node_hashtbl[vfs_hash_index(vp) & null_hash_mask])
+#define	NULL_NHASH(mp, vp)						\
+	(&null_node_hashtbl[(vfs_hash_index(vp) +			\
+	    ((uintptr_t)(mp) >> 9)) & null_hash_mask])
 
-static LIST_HEAD(null_node_hashhead, null_node) *null_node_hashtbl;
+static CK_SLIST_HEAD(null_node_hashhead, null_node) *null_node_hashtbl;
 static struct rwlock null_hash_lock;
 static u_long null_hash_mask;
 
 static MALLOC_DEFINE(M_NULLFSHASH, "nullfs_hash", "NULLFS hash table");
-MALLOC_DEFINE(M_NULLFSNODE, "nullfs_node", "NULLFS vnode private part");
+uma_zone_t null_node_zone;
 
 static struct vnode * null_hashins(struct mount *, struct null_node *);
 
@@ -78,6 +88,10 @@ nullfs_init(vfsp)
 	null_node_hashtbl = hashinit(desiredvnodes, M_NULLFSHASH,
 	    &null_hash_mask);
 	rw_init(&null_hash_lock, "nullhs");
+	null_node_zone = uma_zcreate("nullfs_node",
+	    sizeof(struct null_node), NULL, NULL, NULL, NULL,
+	    UMA_ALIGN_PTR, 0);
+	VFS_SMR_ZONE_SET(null_node_zone);
 	return (0);
 }
 
@@ -86,6 +100,7 @@ nullfs_uninit(vfsp)
 	struct vfsconf *vfsp;
 {
 
+	uma_zdestroy(null_node_zone);
 	rw_destroy(&null_hash_lock);
 	hashdestroy(null_node_hashtbl, M_NULLFSHASH, null_hash_mask);
 	return (0);
@@ -103,6 +118,7 @@ null_hashget(mp, lowervp)
 	struct null_node_hashhead *hd;
 	struct null_node *a;
 	struct vnode *vp;
+	enum vgetstate vs;
 
 	ASSERT_VOP_LOCKED(lowervp, "null_hashget");
 
@@ -111,26 +127,32 @@ null_hashget(mp, lowervp)
 	 * list looking for a null_node structure which is referencing
 	 * the lower vnode.  If found, the increment the null_node
 	 * reference count (but NOT the lower vnode's VREF counter).
+	 *
+	 * The traversal runs lock-free under vfs_smr.  Since we have
+	 * the lower node locked the matching nullfs node can not be in
+	 * the process of recycling; its v_vnlock aliases the lower
+	 * lock and reclaim needs it exclusively.  If it had been
+	 * recycled before we grabed the lower lock it would not have
+	 * been found on the hash.  Unrelated nodes may be concurrently
+	 * unhashed, but removal keeps their forward pointers intact
+	 * and the SMR zone keeps the memory type-stable, so the walk
+	 * stays safe.
 	 */
-	hd = NULL_NHASH(lowervp);
-	if (LIST_EMPTY(hd))
+	hd = NULL_NHASH(mp, lowervp);
+	if (CK_SLIST_EMPTY(hd))
 		return (NULLVP);
-	rw_rlock(&null_hash_lock);
-	LIST_FOREACH(a, hd, null_hash) {
+	vfs_smr_enter();
+	CK_SLIST_FOREACH(a, hd, null_hash) {
 		if (a->null_lowervp == lowervp && NULLTOV(a)->v_mount == mp) {
-			/*
-			 * Since we have the lower node locked the nullfs
-			 * node can not be in the process of recycling.  If
-			 * it had been recycled before we grabed the lower
-			 * lock it would not have been found on the hash.
-			 */
 			vp = NULLTOV(a);
-			vref(vp);
-			rw_runlock(&null_hash_lock);
+			vs = vget_prep_smr(vp);
+			vfs_smr_exit();
+			VNPASS(vs != VGET_NONE, vp);
+			vget_finish_ref(vp, vs);
 			return (vp);
 		}
 	}
-	rw_runlock(&null_hash_lock);
+	vfs_smr_exit();
 	return (NULLVP);
 }
 
@@ -147,14 +169,15 @@ null_hashins(mp, xp)
 	struct null_node *oxp;
 	struct vnode *ovp;
 
-	hd = NULL_NHASH(xp->null_lowervp);
+	hd = NULL_NHASH(mp, xp->null_lowervp);
 	rw_wlock(&null_hash_lock);
-	LIST_FOREACH(oxp, hd, null_hash) {
+	CK_SLIST_FOREACH(oxp, hd, null_hash) {
 		if (oxp->null_lowervp == xp->null_lowervp &&
 		    NULLTOV(oxp)->v_mount == mp) {
 			/*
 			 * See null_hashget for a description of this
-			 * operation.
+			 * operation.  The found node can not be
+			 * unhashed while we hold the write lock.
 			 */
 			ovp = NULLTOV(oxp);
 			vref(ovp);
@@ -162,7 +185,7 @@ null_hashins(mp, xp)
 			return (ovp);
 		}
 	}
-	LIST_INSERT_HEAD(hd, xp, null_hash);
+	CK_SLIST_INSERT_HEAD(hd, xp, null_hash);
 	rw_wunlock(&null_hash_lock);
 	return (NULLVP);
 }
@@ -179,7 +202,7 @@ null_destroy_proto(struct vnode *vp, void *xp)
 	VI_UNLOCK(vp);
 	vgone(vp);
 	vput(vp);
-	free(xp, M_NULLFSNODE);
+	uma_zfree_smr(null_node_zone, xp);
 }
 
 static void
@@ -237,12 +260,12 @@ null_nodeget(mp, lowervp, vpp)
 	 * Note that duplicate can only appear in hash if the lowervp is
 	 * locked LK_SHARED.
 	 */
-	xp = malloc(sizeof(struct null_node), M_NULLFSNODE, M_WAITOK);
+	xp = uma_zalloc_smr(null_node_zone, M_WAITOK);
 
 	error = getnewvnode("nullfs", mp, &null_vnodeops, &vp);
 	if (error) {
 		vput(lowervp);
-		free(xp, M_NULLFSNODE);
+		uma_zfree_smr(null_node_zone, xp);
 		return (error);
 	}
 
@@ -301,9 +324,11 @@ void
 null_hashrem(xp)
 	struct null_node *xp;
 {
+	struct null_node_hashhead *hd;
 
+	hd = NULL_NHASH(NULLTOV(xp)->v_mount, xp->null_lowervp);
 	rw_wlock(&null_hash_lock);
-	LIST_REMOVE(xp, null_hash);
+	CK_SLIST_REMOVE(hd, xp, null_node, null_hash);
 	rw_wunlock(&null_hash_lock);
 }
 
@@ -73,6 +73,13 @@ SYSCTL_NODE(_vfs, OID_AUTO, tmpfs, CTLFLAG_RW | CTLFLAG_MPSAFE, 0,
 
 static long tmpfs_pages_reserved = TMPFS_PAGES_MINRESERVED;
 
+#if VM_NRESERVLEVEL > 0
+static u_long tmpfs_superpage_threshold = 2 * 1024 * 1024;
+SYSCTL_ULONG(_vfs_tmpfs, OID_AUTO, superpage_threshold, CTLFLAG_RWTUN,
+    &tmpfs_superpage_threshold, 0,
+    "File size above which pages are allocated from superpage reservations");
+#endif
+
 static uma_zone_t tmpfs_dirent_pool;
 static uma_zone_t tmpfs_node_pool;
 VFS_SMR_DECLARE;
@@ -1521,6 +1528,16 @@ retry:
 		if (newpages < oldpages)
 			vm_object_page_remove(uobj, newpages, 0, 0);
 	}
+#if VM_NRESERVLEVEL > 0
+	/*
+	 * Color large files at a superpage boundary so that their pages
+	 * are allocated from reservations and mappings of them can be
+	 * promoted to superpages, instead of taking whatever alignment
+	 * the first faulting mapping happens to dictate.
+	 */
+	if (newsize >= tmpfs_superpage_threshold && pagesizes[1] != 0)
+		vm_object_color(uobj, 0);
+#endif
 	uobj->size = newpages;
 	VM_OBJECT_WUNLOCK(uobj);
 
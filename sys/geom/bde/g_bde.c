@@ -86,6 +86,7 @@ g_bde_orphan(struct g_consumer *cp)
 	gp = cp->geom;
 	sc = gp->softc;
 	gp->flags |= G_GEOM_WITHER;
+	g_wither_enqueue(gp);
 	LIST_FOREACH(pp, &gp->provider, provider)
 		g_wither_provider(pp, ENXIO);
 	explicit_bzero(sc, sizeof(struct g_bde_softc));	/* destroy evidence */
@@ -33,6 +33,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/systm.h>
 #include <sys/kernel.h>
 #include <sys/module.h>
+#include <sys/eventhandler.h>
 #include <sys/lock.h>
 #include <sys/mutex.h>
 #include <sys/bio.h>
@@ -433,6 +434,39 @@ g_cache_go(void *arg)
 	callout_reset(&sc->sc_callout, g_cache_timeout * hz, g_cache_go, sc);
 }
 
+/*
+ * The page daemon is short on memory.  Give back every entry that is
+ * not referenced by an in-flight read instead of waiting for it to age
+ * out through the used list.
+ */
+static void
+g_cache_lowmem(void *arg, int howto __unused)
+{
+	struct g_cache_softc *sc = arg;
+	struct g_cache_desc *dp, *dp2;
+	int i;
+
+	mtx_lock(&sc->sc_mtx);
+	for (i = 0; i < G_CACHE_BUCKETS; i++) {
+		dp = LIST_FIRST(&sc->sc_desclist[i]);
+		while (dp != NULL) {
+			dp2 = LIST_NEXT(dp, d_next);
+			if (dp->d_biolist == NULL &&
+			    (dp->d_flags & D_FLAG_INVALID) == 0) {
+				if (dp->d_flags & D_FLAG_USED) {
+					TAILQ_REMOVE(&sc->sc_usedlist, dp,
+					    d_used);
+					sc->sc_nused--;
+				}
+				LIST_REMOVE(dp, d_next);
+				g_cache_free(sc, dp);
+			}
+			dp = dp2;
+		}
+	}
+	mtx_unlock(&sc->sc_mtx);
+}
+
 static int
 g_cache_access(struct g_provider *pp, int dr, int dw, int de)
 {
@@ -547,6 +581,8 @@ g_cache_create(struct g_class *mp, struct g_provider *pp,
 
 	g_error_provider(newpp, 0);
 	G_CACHE_DEBUG(0, "Device %s created.", gp->name);
+	sc->sc_lowmem_tag = EVENTHANDLER_REGISTER(vm_lowmem, g_cache_lowmem,
+	    sc, EVENTHANDLER_PRI_ANY);
 	callout_reset(&sc->sc_callout, g_cache_timeout * hz, g_cache_go, sc);
 	return (gp);
 }
@@ -576,6 +612,7 @@ g_cache_destroy(struct g_cache_softc *sc, boolean_t force)
 	} else {
 		G_CACHE_DEBUG(0, "Device %s removed.", gp->name);
 	}
+	EVENTHANDLER_DEREGISTER(vm_lowmem, sc->sc_lowmem_tag);
 	callout_drain(&sc->sc_callout);
 	mtx_lock(&sc->sc_mtx);
 	for (i = 0; i < G_CACHE_BUCKETS; i++) {
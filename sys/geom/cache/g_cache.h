@@ -57,6 +57,7 @@ struct g_cache_softc {
 	off_t		sc_tail;
 	struct mtx	sc_mtx;
 	struct callout	sc_callout;
+	eventhandler_tag sc_lowmem_tag;
 	LIST_HEAD(, g_cache_desc) sc_desclist[G_CACHE_BUCKETS];
 	TAILQ_HEAD(, g_cache_desc) sc_usedlist;
 	uma_zone_t	sc_zone;
@@ -89,6 +89,11 @@ SYSCTL_UINT(_kern_geom_eli, OID_AUTO, threads, CTLFLAG_RWTUN, &g_eli_threads, 0,
 u_int g_eli_batch = 0;
 SYSCTL_UINT(_kern_geom_eli, OID_AUTO, batch, CTLFLAG_RWTUN, &g_eli_batch, 0,
     "Use crypto operations batching");
+static u_int g_eli_worker_batch = 8;
+SYSCTL_UINT(_kern_geom_eli, OID_AUTO, worker_batch, CTLFLAG_RWTUN,
+    &g_eli_worker_batch, 0,
+    "Maximum number of bios a worker thread dequeues per queue lock "
+    "acquisition");
 
 /*
  * Passphrase cached during boot, in order to be more user-friendly if
@@ -265,6 +270,7 @@ g_eli_read_done(struct bio *bp)
 	}
 	mtx_lock(&sc->sc_queue_mtx);
 	bioq_insert_tail(&sc->sc_queue, pbp);
+	sc->sc_queue_count++;
 	mtx_unlock(&sc->sc_queue_mtx);
 	wakeup(sc);
 }
@@ -461,6 +467,7 @@ g_eli_start(struct bio *bp)
 	case BIO_WRITE:
 		mtx_lock(&sc->sc_queue_mtx);
 		bioq_insert_tail(&sc->sc_queue, bp);
+		sc->sc_queue_count++;
 		mtx_unlock(&sc->sc_queue_mtx);
 		wakeup(sc);
 		break;
@@ -577,6 +584,7 @@ g_eli_cancel(struct g_eli_softc *sc)
 	while ((bp = bioq_takefirst(&sc->sc_queue)) != NULL) {
 		KASSERT(bp->bio_pflags == G_ELI_NEW_BIO,
 		    ("Not new bio when canceling (bp=%p).", bp));
+		sc->sc_queue_count--;
 		g_io_deliver(bp, ENXIO);
 	}
 }
@@ -588,8 +596,12 @@ g_eli_takefirst(struct g_eli_softc *sc)
 
 	mtx_assert(&sc->sc_queue_mtx, MA_OWNED);
 
-	if (!(sc->sc_flags & G_ELI_FLAG_SUSPEND))
-		return (bioq_takefirst(&sc->sc_queue));
+	if (!(sc->sc_flags & G_ELI_FLAG_SUSPEND)) {
+		bp = bioq_takefirst(&sc->sc_queue);
+		if (bp != NULL)
+			sc->sc_queue_count--;
+		return (bp);
+	}
 	/*
 	 * Device suspended, so we skip new I/O requests.
 	 */
@@ -597,8 +609,10 @@ g_eli_takefirst(struct g_eli_softc *sc)
 		if (bp->bio_pflags != G_ELI_NEW_BIO)
 			break;
 	}
-	if (bp != NULL)
+	if (bp != NULL) {
 		bioq_remove(&sc->sc_queue, bp);
+		sc->sc_queue_count--;
+	}
 	return (bp);
 }
 
@@ -613,7 +627,9 @@ g_eli_worker(void *arg)
 {
 	struct g_eli_softc *sc;
 	struct g_eli_worker *wr;
+	struct bio_queue_head batch;
 	struct bio *bp;
+	u_int n;
 	int error;
 
 	wr = arg;
@@ -687,27 +703,43 @@ again:
 			msleep(sc, &sc->sc_queue_mtx, PDROP, "geli:w", 0);
 			continue;
 		}
-		if (bp->bio_pflags == G_ELI_NEW_BIO)
-			atomic_add_int(&sc->sc_inflight, 1);
+		/*
+		 * Drain a batch of requests while the queue mutex is held
+		 * and run the cryptography for all of them without it.
+		 * This keeps the worker threads of busy multi-volume
+		 * configurations from convoying on the queue mutex, at a
+		 * small cost in work distribution among the workers.
+		 */
+		bioq_init(&batch);
+		for (n = 1;; n++) {
+			if (bp->bio_pflags == G_ELI_NEW_BIO)
+				atomic_add_int(&sc->sc_inflight, 1);
+			bioq_insert_tail(&batch, bp);
+			if (n >= g_eli_worker_batch ||
+			    (bp = g_eli_takefirst(sc)) == NULL)
+				break;
+		}
 		mtx_unlock(&sc->sc_queue_mtx);
-		if (bp->bio_pflags == G_ELI_NEW_BIO) {
-			bp->bio_pflags = 0;
-			if (sc->sc_flags & G_ELI_FLAG_AUTH) {
-				if (bp->bio_cmd == BIO_READ)
-					g_eli_auth_read(sc, bp);
-				else
-					g_eli_auth_run(wr, bp);
+		while ((bp = bioq_takefirst(&batch)) != NULL) {
+			if (bp->bio_pflags == G_ELI_NEW_BIO) {
+				bp->bio_pflags = 0;
+				if (sc->sc_flags & G_ELI_FLAG_AUTH) {
+					if (bp->bio_cmd == BIO_READ)
+						g_eli_auth_read(sc, bp);
+					else
+						g_eli_auth_run(wr, bp);
+				} else {
+					if (bp->bio_cmd == BIO_READ)
+						g_eli_crypto_read(sc, bp, 1);
+					else
+						g_eli_crypto_run(wr, bp);
+				}
 			} else {
-				if (bp->bio_cmd == BIO_READ)
-					g_eli_crypto_read(sc, bp, 1);
+				if (sc->sc_flags & G_ELI_FLAG_AUTH)
+					g_eli_auth_run(wr, bp);
 				else
 					g_eli_crypto_run(wr, bp);
 			}
-		} else {
-			if (sc->sc_flags & G_ELI_FLAG_AUTH)
-				g_eli_auth_run(wr, bp);
-			else
-				g_eli_crypto_run(wr, bp);
 		}
 	}
 }
@@ -1344,6 +1376,8 @@ g_eli_dumpconf(struct sbuf *sb, const char *indent, struct g_geom *gp,
 	    (uintmax_t)sc->sc_ekeys_total);
 	sbuf_printf(sb, "%s<KeysAllocated>%ju</KeysAllocated>\n", indent,
 	    (uintmax_t)sc->sc_ekeys_allocated);
+	sbuf_printf(sb, "%s<QueueDepth>%u</QueueDepth>\n", indent,
+	    sc->sc_queue_count);
 	sbuf_printf(sb, "%s<Flags>", indent);
 	if (sc->sc_flags == 0)
 		sbuf_cat(sb, "NONE");
@@ -725,6 +725,130 @@ g_gate_modify(struct g_gate_softc *sc, struct g_gate_ctl_modify *ggio)
 	return (0);
 }
 
+/*
+ * Hand the next queued request over to userland.  Sleeps until a request
+ * is available unless the device is being destroyed or the wait is
+ * interrupted; those cases are reported through gctl_error.
+ */
+static int
+g_gate_ioctl_start(struct g_gate_softc *sc, struct g_gate_ctl_io *ggio)
+{
+	struct bio *bp;
+	int error;
+
+	error = 0;
+	for (;;) {
+		mtx_lock(&sc->sc_queue_mtx);
+		bp = bioq_first(&sc->sc_inqueue);
+		if (bp != NULL)
+			break;
+		if ((sc->sc_flags & G_GATE_FLAG_DESTROY) != 0) {
+			ggio->gctl_error = ECANCELED;
+			mtx_unlock(&sc->sc_queue_mtx);
+			return (0);
+		}
+		if (msleep(sc, &sc->sc_queue_mtx,
+		    PPAUSE | PDROP | PCATCH, "ggwait", 0) != 0) {
+			ggio->gctl_error = ECANCELED;
+			return (0);
+		}
+	}
+	ggio->gctl_cmd = bp->bio_cmd;
+	if (bp->bio_cmd == BIO_WRITE && bp->bio_length > ggio->gctl_length) {
+		mtx_unlock(&sc->sc_queue_mtx);
+		ggio->gctl_length = bp->bio_length;
+		ggio->gctl_error = ENOMEM;
+		return (0);
+	}
+	bioq_remove(&sc->sc_inqueue, bp);
+	bioq_insert_tail(&sc->sc_outqueue, bp);
+	mtx_unlock(&sc->sc_queue_mtx);
+
+	ggio->gctl_seq = (uintptr_t)bp->bio_driver1;
+	ggio->gctl_offset = bp->bio_offset;
+	ggio->gctl_length = bp->bio_length;
+
+	switch (bp->bio_cmd) {
+	case BIO_READ:
+	case BIO_DELETE:
+	case BIO_FLUSH:
+	case BIO_SPEEDUP:
+		break;
+	case BIO_WRITE:
+		error = copyout(bp->bio_data, ggio->gctl_data,
+		    bp->bio_length);
+		if (error != 0) {
+			mtx_lock(&sc->sc_queue_mtx);
+			bioq_remove(&sc->sc_outqueue, bp);
+			bioq_insert_head(&sc->sc_inqueue, bp);
+			mtx_unlock(&sc->sc_queue_mtx);
+			return (error);
+		}
+		break;
+	}
+	return (error);
+}
+
+/*
+ * Complete the request identified by gctl_seq with the status userland
+ * reported.  Unknown sequence numbers are silently ignored, as the
+ * request may have been canceled in the meantime.
+ */
+static int
+g_gate_ioctl_done(struct g_gate_softc *sc, struct g_gate_ctl_io *ggio)
+{
+	struct bio *bp;
+	int error;
+
+	error = 0;
+	mtx_lock(&sc->sc_queue_mtx);
+	TAILQ_FOREACH(bp, &sc->sc_outqueue.queue, bio_queue) {
+		if (ggio->gctl_seq == (uintptr_t)bp->bio_driver1)
+			break;
+	}
+	if (bp != NULL) {
+		bioq_remove(&sc->sc_outqueue, bp);
+		sc->sc_queue_count--;
+	}
+	mtx_unlock(&sc->sc_queue_mtx);
+	if (bp == NULL) {
+		/*
+		 * Request was probably canceled.
+		 */
+		return (0);
+	}
+	if (ggio->gctl_error == EAGAIN) {
+		bp->bio_error = 0;
+		G_GATE_LOGREQ(1, bp, "Request desisted.");
+		mtx_lock(&sc->sc_queue_mtx);
+		sc->sc_queue_count++;
+		bioq_insert_head(&sc->sc_inqueue, bp);
+		wakeup(sc);
+		mtx_unlock(&sc->sc_queue_mtx);
+	} else {
+		bp->bio_error = ggio->gctl_error;
+		if (bp->bio_error == 0) {
+			bp->bio_completed = bp->bio_length;
+			switch (bp->bio_cmd) {
+			case BIO_READ:
+				error = copyin(ggio->gctl_data,
+				    bp->bio_data, bp->bio_length);
+				if (error != 0)
+					bp->bio_error = error;
+				break;
+			case BIO_DELETE:
+			case BIO_WRITE:
+			case BIO_FLUSH:
+			case BIO_SPEEDUP:
+				break;
+			}
+		}
+		G_GATE_LOGREQ(2, bp, "Request done.");
+		g_io_deliver(bp, bp->bio_error);
+	}
+	return (error);
+}
+
 #define	G_GATE_CHECK_VERSION(ggio)	do {				\
 	if ((ggio)->gctl_version != G_GATE_VERSION) {			\
 		printf("Version mismatch %d != %d.\n",			\
@@ -834,58 +958,7 @@ g_gate_ioctl(struct cdev *dev, u_long cmd, caddr_t addr, int flags, struct threa
 		sc = g_gate_hold(ggio->gctl_unit, NULL);
 		if (sc == NULL)
 			return (ENXIO);
-		error = 0;
-		for (;;) {
-			mtx_lock(&sc->sc_queue_mtx);
-			bp = bioq_first(&sc->sc_inqueue);
-			if (bp != NULL)
-				break;
-			if ((sc->sc_flags & G_GATE_FLAG_DESTROY) != 0) {
-				ggio->gctl_error = ECANCELED;
-				mtx_unlock(&sc->sc_queue_mtx);
-				goto start_end;
-			}
-			if (msleep(sc, &sc->sc_queue_mtx,
-			    PPAUSE | PDROP | PCATCH, "ggwait", 0) != 0) {
-				ggio->gctl_error = ECANCELED;
-				goto start_end;
-			}
-		}
-		ggio->gctl_cmd = bp->bio_cmd;
-		if (bp->bio_cmd == BIO_WRITE &&
-		    bp->bio_length > ggio->gctl_length) {
-			mtx_unlock(&sc->sc_queue_mtx);
-			ggio->gctl_length = bp->bio_length;
-			ggio->gctl_error = ENOMEM;
-			goto start_end;
-		}
-		bioq_remove(&sc->sc_inqueue, bp);
-		bioq_insert_tail(&sc->sc_outqueue, bp);
-		mtx_unlock(&sc->sc_queue_mtx);
-
-		ggio->gctl_seq = (uintptr_t)bp->bio_driver1;
-		ggio->gctl_offset = bp->bio_offset;
-		ggio->gctl_length = bp->bio_length;
-
-		switch (bp->bio_cmd) {
-		case BIO_READ:
-		case BIO_DELETE:
-		case BIO_FLUSH:
-		case BIO_SPEEDUP:
-			break;
-		case BIO_WRITE:
-			error = copyout(bp->bio_data, ggio->gctl_data,
-			    bp->bio_length);
-			if (error != 0) {
-				mtx_lock(&sc->sc_queue_mtx);
-				bioq_remove(&sc->sc_outqueue, bp);
-				bioq_insert_head(&sc->sc_inqueue, bp);
-				mtx_unlock(&sc->sc_queue_mtx);
-				goto start_end;
-			}
-			break;
-		}
-start_end:
+		error = g_gate_ioctl_start(sc, ggio);
 		g_gate_release(sc);
 		return (error);
 	    }
@@ -897,53 +970,31 @@ start_end:
 		sc = g_gate_hold(ggio->gctl_unit, NULL);
 		if (sc == NULL)
 			return (ENOENT);
-		error = 0;
-		mtx_lock(&sc->sc_queue_mtx);
-		TAILQ_FOREACH(bp, &sc->sc_outqueue.queue, bio_queue) {
-			if (ggio->gctl_seq == (uintptr_t)bp->bio_driver1)
-				break;
-		}
-		if (bp != NULL) {
-			bioq_remove(&sc->sc_outqueue, bp);
-			sc->sc_queue_count--;
-		}
-		mtx_unlock(&sc->sc_queue_mtx);
-		if (bp == NULL) {
-			/*
-			 * Request was probably canceled.
-			 */
-			goto done_end;
-		}
-		if (ggio->gctl_error == EAGAIN) {
-			bp->bio_error = 0;
-			G_GATE_LOGREQ(1, bp, "Request desisted.");
-			mtx_lock(&sc->sc_queue_mtx);
-			sc->sc_queue_count++;
-			bioq_insert_head(&sc->sc_inqueue, bp);
-			wakeup(sc);
-			mtx_unlock(&sc->sc_queue_mtx);
-		} else {
-			bp->bio_error = ggio->gctl_error;
-			if (bp->bio_error == 0) {
-				bp->bio_completed = bp->bio_length;
-				switch (bp->bio_cmd) {
-				case BIO_READ:
-					error = copyin(ggio->gctl_data,
-					    bp->bio_data, bp->bio_length);
-					if (error != 0)
-						bp->bio_error = error;
-					break;
-				case BIO_DELETE:
-				case BIO_WRITE:
-				case BIO_FLUSH:
-				case BIO_SPEEDUP:
-					break;
-				}
-			}
-			G_GATE_LOGREQ(2, bp, "Request done.");
-			g_io_deliver(bp, bp->bio_error);
+		error = g_gate_ioctl_done(sc, ggio);
+		g_gate_release(sc);
+		return (error);
+	    }
+	case G_GATE_CMD_DONE_START:
+	    {
+		struct g_gate_ctl_io *ggio = (void *)addr;
+
+		/*
+		 * Complete one request and collect the next in a single
+		 * round trip, halving the number of syscalls a userland
+		 * provider makes per I/O.  The caller passes the
+		 * completion status in gctl_error and the capacity of
+		 * gctl_data in gctl_length, just as with separate DONE
+		 * and START calls.
+		 */
+		G_GATE_CHECK_VERSION(ggio);
+		sc = g_gate_hold(ggio->gctl_unit, NULL);
+		if (sc == NULL)
+			return (ENOENT);
+		error = g_gate_ioctl_done(sc, ggio);
+		if (error == 0) {
+			ggio->gctl_error = 0;
+			error = g_gate_ioctl_start(sc, ggio);
 		}
-done_end:
 		g_gate_release(sc);
 		return (error);
 	    }
@@ -71,6 +71,13 @@
 #define G_GATE_CMD_CANCEL	_IOWR('m', 3, struct g_gate_ctl_cancel)
 #define G_GATE_CMD_START	_IOWR('m', 4, struct g_gate_ctl_io)
 #define G_GATE_CMD_DONE		_IOWR('m', 5, struct g_gate_ctl_io)
+/*
+ * Complete one request and fetch the next one in a single syscall.
+ * Takes the same arguments as G_GATE_CMD_DONE on entry and returns the
+ * same results as G_GATE_CMD_START; gctl_length must hold the capacity
+ * of the gctl_data buffer on entry.
+ */
+#define G_GATE_CMD_DONE_START	_IOWR('m', 6, struct g_gate_ctl_io)
 
 #define	G_GATE_INFOSIZE		2048
 
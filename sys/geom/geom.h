@@ -136,6 +136,7 @@ struct g_geom {
 	LIST_HEAD(,g_consumer)	consumer;
 	LIST_HEAD(,g_provider)	provider;
 	TAILQ_ENTRY(g_geom)	geoms;	/* XXX: better name */
+	LIST_ENTRY(g_geom)	withers;
 	int			rank;
 	g_start_t		*start;
 	g_spoiled_t		*spoiled;
@@ -154,6 +155,7 @@ struct g_geom {
 #define	G_GEOM_VOLATILE_BIO	0x02
 #define	G_GEOM_IN_ACCESS	0x04
 #define	G_GEOM_ACCESS_WAIT	0x08
+#define	G_GEOM_IN_WITHERQ	0x10
 };
 
 /*
@@ -301,6 +303,7 @@ void g_spoil(struct g_provider *pp, struct g_consumer *cp);
 int g_std_access(struct g_provider *pp, int dr, int dw, int de);
 void g_std_done(struct bio *bp);
 void g_std_spoiled(struct g_consumer *cp);
+void g_wither_enqueue(struct g_geom *gp);
 void g_wither_geom(struct g_geom *gp, int error);
 void g_wither_geom_close(struct g_geom *gp, int error);
 void g_wither_provider(struct g_provider *pp, int error);
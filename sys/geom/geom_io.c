@@ -47,6 +47,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/kernel.h>
 #include <sys/malloc.h>
 #include <sys/bio.h>
+#include <sys/counter.h>
 #include <sys/ktr.h>
 #include <sys/proc.h>
 #include <sys/sbuf.h>
@@ -87,6 +88,35 @@ static volatile u_int __read_mostly pace;
 
 static uma_zone_t __read_mostly biozone;
 
+/*
+ * Statistics on which path bios took through the stack: dispatched
+ * directly in the context of the caller, or queued to the g_down/g_up
+ * kernel threads.  Large queued counts on a chain whose classes are all
+ * direct-capable point at stack depth or unmapped I/O restrictions
+ * forcing the slow path.
+ */
+SYSCTL_DECL(_kern_geom);
+static SYSCTL_NODE(_kern_geom, OID_AUTO, dispatch,
+    CTLFLAG_RD | CTLFLAG_MPSAFE, 0,
+    "GEOM I/O dispatch path statistics");
+
+static COUNTER_U64_DEFINE_EARLY(g_stat_down_direct);
+SYSCTL_COUNTER_U64(_kern_geom_dispatch, OID_AUTO, down_direct, CTLFLAG_RD,
+    &g_stat_down_direct,
+    "Requests executed directly in the caller's context");
+static COUNTER_U64_DEFINE_EARLY(g_stat_down_queued);
+SYSCTL_COUNTER_U64(_kern_geom_dispatch, OID_AUTO, down_queued, CTLFLAG_RD,
+    &g_stat_down_queued,
+    "Requests queued to the g_down thread");
+static COUNTER_U64_DEFINE_EARLY(g_stat_up_direct);
+SYSCTL_COUNTER_U64(_kern_geom_dispatch, OID_AUTO, up_direct, CTLFLAG_RD,
+    &g_stat_up_direct,
+    "Completions executed directly in the provider's context");
+static COUNTER_U64_DEFINE_EARLY(g_stat_up_queued);
+SYSCTL_COUNTER_U64(_kern_geom_dispatch, OID_AUTO, up_queued, CTLFLAG_RD,
+    &g_stat_up_queued,
+    "Completions queued to the g_up thread");
+
 #include <machine/atomic.h>
 
 static void
@@ -578,6 +608,7 @@ g_io_request(struct bio *bp, struct g_consumer *cp)
 #endif
 
 	if (direct) {
+		counter_u64_add(g_stat_down_direct, 1);
 		error = g_io_check(bp);
 		if (error >= 0) {
 			CTR3(KTR_GEOM, "g_io_request g_io_check on bp %p "
@@ -588,6 +619,7 @@ g_io_request(struct bio *bp, struct g_consumer *cp)
 		}
 		bp->bio_to->geom->start(bp);
 	} else {
+		counter_u64_add(g_stat_down_queued, 1);
 		g_bioq_lock(&g_bio_run_down);
 		first = TAILQ_EMPTY(&g_bio_run_down.bio_queue);
 		TAILQ_INSERT_TAIL(&g_bio_run_down.bio_queue, bp, bio_queue);
@@ -692,8 +724,10 @@ g_io_deliver(struct bio *bp, int error)
 	if (error != ENOMEM) {
 		bp->bio_error = error;
 		if (direct) {
+			counter_u64_add(g_stat_up_direct, 1);
 			biodone(bp);
 		} else {
+			counter_u64_add(g_stat_up_queued, 1);
 			g_bioq_lock(&g_bio_run_up);
 			first = TAILQ_EMPTY(&g_bio_run_up.bio_queue);
 			TAILQ_INSERT_TAIL(&g_bio_run_up.bio_queue, bp, bio_queue);
@@ -718,8 +752,6 @@ g_io_deliver(struct bio *bp, int error)
 	return;
 }
 
-SYSCTL_DECL(_kern_geom);
-
 static long transient_maps;
 SYSCTL_LONG(_kern_geom, OID_AUTO, transient_maps, CTLFLAG_RD,
     &transient_maps, 0,
@@ -71,6 +71,8 @@ SDT_PROVIDER_DEFINE(geom);
 
 struct class_list_head g_classes = LIST_HEAD_INITIALIZER(g_classes);
 static struct g_tailq_head geoms = TAILQ_HEAD_INITIALIZER(geoms);
+static LIST_HEAD(, g_geom) g_wither_geoms =
+    LIST_HEAD_INITIALIZER(g_wither_geoms);
 char *g_wait_event, *g_wait_up, *g_wait_down, *g_wait_sim;
 
 struct g_hh00 {
@@ -424,10 +426,27 @@ g_destroy_geom(struct g_geom *gp)
 	g_cancel_event(gp);
 	LIST_REMOVE(gp, geom);
 	TAILQ_REMOVE(&geoms, gp, geoms);
+	if (gp->flags & G_GEOM_IN_WITHERQ)
+		LIST_REMOVE(gp, withers);
 	g_free(gp->name);
 	g_free(gp);
 }
 
+/*
+ * Put a geom on the list scanned by g_wither_washer(), so that withering
+ * work does not require walking every geom in the system.
+ */
+void
+g_wither_enqueue(struct g_geom *gp)
+{
+
+	g_topology_assert();
+	if ((gp->flags & G_GEOM_IN_WITHERQ) == 0) {
+		gp->flags |= G_GEOM_IN_WITHERQ;
+		LIST_INSERT_HEAD(&g_wither_geoms, gp, withers);
+	}
+}
+
 /*
  * This function is called (repeatedly) until the geom has withered away.
  */
@@ -445,6 +464,7 @@ g_wither_geom(struct g_geom *gp, int error)
 			if (!(pp->flags & G_PF_ORPHAN))
 				g_orphan_provider(pp, error);
 	}
+	g_wither_enqueue(gp);
 	g_do_wither();
 }
 
@@ -458,6 +478,7 @@ g_wither_provider(struct g_provider *pp, int error)
 	pp->flags |= G_PF_WITHER;
 	if (!(pp->flags & G_PF_ORPHAN))
 		g_orphan_provider(pp, error);
+	g_wither_enqueue(pp->geom);
 }
 
 /*
@@ -484,37 +505,46 @@ g_wither_geom_close(struct g_geom *gp, int error)
 void
 g_wither_washer()
 {
-	struct g_class *mp;
 	struct g_geom *gp, *gp2;
 	struct g_provider *pp, *pp2;
 	struct g_consumer *cp, *cp2;
 
 	g_topology_assert();
-	LIST_FOREACH(mp, &g_classes, class) {
-		LIST_FOREACH_SAFE(gp, &mp->geom, geom, gp2) {
-			LIST_FOREACH_SAFE(pp, &gp->provider, provider, pp2) {
-				if (!(pp->flags & G_PF_WITHER))
-					continue;
-				if (LIST_EMPTY(&pp->consumers))
-					g_destroy_provider(pp);
-			}
-			if (!(gp->flags & G_GEOM_WITHER))
+	LIST_FOREACH_SAFE(gp, &g_wither_geoms, withers, gp2) {
+		LIST_FOREACH_SAFE(pp, &gp->provider, provider, pp2) {
+			if (!(pp->flags & G_PF_WITHER))
 				continue;
-			LIST_FOREACH_SAFE(pp, &gp->provider, provider, pp2) {
-				if (LIST_EMPTY(&pp->consumers))
-					g_destroy_provider(pp);
-			}
-			LIST_FOREACH_SAFE(cp, &gp->consumer, consumer, cp2) {
-				if (cp->acr || cp->acw || cp->ace)
-					continue;
-				if (cp->provider != NULL)
-					g_detach(cp);
-				g_destroy_consumer(cp);
+			if (LIST_EMPTY(&pp->consumers))
+				g_destroy_provider(pp);
+		}
+		if (!(gp->flags & G_GEOM_WITHER)) {
+			/*
+			 * Only individual providers are withering; once
+			 * the last of them is gone the geom itself has no
+			 * more work pending.
+			 */
+			LIST_FOREACH(pp, &gp->provider, provider)
+				if (pp->flags & G_PF_WITHER)
+					break;
+			if (pp == NULL) {
+				gp->flags &= ~G_GEOM_IN_WITHERQ;
+				LIST_REMOVE(gp, withers);
 			}
-			if (LIST_EMPTY(&gp->provider) &&
-			    LIST_EMPTY(&gp->consumer))
-				g_destroy_geom(gp);
+			continue;
+		}
+		LIST_FOREACH_SAFE(pp, &gp->provider, provider, pp2) {
+			if (LIST_EMPTY(&pp->consumers))
+				g_destroy_provider(pp);
+		}
+		LIST_FOREACH_SAFE(cp, &gp->consumer, consumer, cp2) {
+			if (cp->acr || cp->acw || cp->ace)
+				continue;
+			if (cp->provider != NULL)
+				g_detach(cp);
+			g_destroy_consumer(cp);
 		}
+		if (LIST_EMPTY(&gp->provider) && LIST_EMPTY(&gp->consumer))
+			g_destroy_geom(gp);
 	}
 }
 
@@ -1185,8 +1215,10 @@ g_std_spoiled(struct g_consumer *cp)
 	g_destroy_consumer(cp);
 	if (LIST_EMPTY(&gp->provider) && LIST_EMPTY(&gp->consumer))
 		g_destroy_geom(gp);
-	else
+	else {
 		gp->flags |= G_GEOM_WITHER;
+		g_wither_enqueue(gp);
+	}
 }
 
 /*
@@ -970,6 +970,21 @@ g_mirror_regular_request(struct g_mirror_softc *sc, struct bio *bp)
 		g_topology_unlock();
 	}
 
+	/*
+	 * Feed the latency balance algorithm.  bio_t0 was stamped by
+	 * g_io_request() when the request was sent down.
+	 */
+	if (sc->sc_balance == G_MIRROR_BALANCE_LATENCY &&
+	    bp->bio_cmd == BIO_READ && bp->bio_error == 0 &&
+	    disk != NULL && bintime_isset(&bp->bio_t0)) {
+		struct bintime bt;
+
+		binuptime(&bt);
+		bintime_sub(&bt, &bp->bio_t0);
+		disk->d_lat_ewma = (sbttous(bttosbt(bt)) +
+		    (uint64_t)disk->d_lat_ewma * 7) / 8;
+	}
+
 	switch (bp->bio_cmd) {
 	case BIO_READ:
 		KFAIL_POINT_ERROR(DEBUG_FP, g_mirror_regular_request_read,
@@ -1598,6 +1613,63 @@ g_mirror_request_load(struct g_mirror_softc *sc, struct bio *bp)
 	g_io_request(cbp, cp);
 }
 
+/*
+ * Route the read to the member with the smallest expected completion
+ * time, estimated as the member's averaged per-request service time
+ * multiplied by the number of requests already queued to it.  A faster
+ * member thus receives proportionally more requests, until its queue
+ * grows long enough to even the estimates out.  A member only displaces
+ * the current best candidate when its estimate is better by more than
+ * 1/8, which keeps the choice from flapping between members with
+ * similar service times.
+ */
+static void
+g_mirror_request_latency(struct g_mirror_softc *sc, struct bio *bp)
+{
+	struct g_mirror_disk *disk, *dp;
+	struct g_consumer *cp;
+	struct bio *cbp;
+	uint64_t prio, best;
+
+	disk = NULL;
+	best = UINT64_MAX;
+	LIST_FOREACH(dp, &sc->sc_disks, d_next) {
+		if (dp->d_state != G_MIRROR_DISK_STATE_ACTIVE)
+			continue;
+		/*
+		 * Until a member has completed a read its service time
+		 * is unknown and the estimate degrades to plain queue
+		 * depth balancing.
+		 */
+		prio = (uint64_t)(dp->d_lat_ewma + 1) *
+		    (dp->d_consumer->index + 1);
+		if (disk == NULL || prio < best - best / 8) {
+			disk = dp;
+			best = prio;
+		}
+	}
+	KASSERT(disk != NULL, ("NULL disk for %s.", sc->sc_name));
+	cbp = g_clone_bio(bp);
+	if (cbp == NULL) {
+		if (bp->bio_error == 0)
+			bp->bio_error = ENOMEM;
+		g_io_deliver(bp, bp->bio_error);
+		return;
+	}
+	/*
+	 * Fill in the component buf structure.
+	 */
+	cp = disk->d_consumer;
+	cbp->bio_done = g_mirror_done;
+	cbp->bio_to = cp->provider;
+	G_MIRROR_LOGREQ(3, cbp, "Sending request.");
+	KASSERT(cp->acr >= 1 && cp->acw >= 1 && cp->ace >= 1,
+	    ("Consumer %s not opened (r%dw%de%d).", cp->provider->name, cp->acr,
+	    cp->acw, cp->ace));
+	cp->index++;
+	g_io_request(cbp, cp);
+}
+
 static void
 g_mirror_request_split(struct g_mirror_softc *sc, struct bio *bp)
 {
@@ -1691,6 +1763,9 @@ g_mirror_register_request(struct g_mirror_softc *sc, struct bio *bp)
 	switch (bp->bio_cmd) {
 	case BIO_READ:
 		switch (sc->sc_balance) {
+		case G_MIRROR_BALANCE_LATENCY:
+			g_mirror_request_latency(sc, bp);
+			break;
 		case G_MIRROR_BALANCE_LOAD:
 			g_mirror_request_load(sc, bp);
 			break;
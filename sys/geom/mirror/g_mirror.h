@@ -44,16 +44,18 @@
  * 2 - Added md_genid field to metadata.
  * 3 - Added md_provsize field to metadata.
  * 4 - Added 'no failure synchronization' flag.
+ * 5 - Added 'latency' balance algorithm.
  */
-#define	G_MIRROR_VERSION	4
+#define	G_MIRROR_VERSION	5
 
 #define	G_MIRROR_BALANCE_NONE		0
 #define	G_MIRROR_BALANCE_ROUND_ROBIN	1
 #define	G_MIRROR_BALANCE_LOAD		2
 #define	G_MIRROR_BALANCE_SPLIT		3
 #define	G_MIRROR_BALANCE_PREFER		4
+#define	G_MIRROR_BALANCE_LATENCY	5
 #define	G_MIRROR_BALANCE_MIN		G_MIRROR_BALANCE_NONE
-#define	G_MIRROR_BALANCE_MAX		G_MIRROR_BALANCE_PREFER
+#define	G_MIRROR_BALANCE_MAX		G_MIRROR_BALANCE_LATENCY
 
 #define	G_MIRROR_DISK_FLAG_DIRTY		0x0000000000000001ULL
 #define	G_MIRROR_DISK_FLAG_SYNCHRONIZING	0x0000000000000002ULL
@@ -131,6 +133,7 @@ struct g_mirror_disk {
 	int		 d_state;	/* Disk state. */
 	u_int		 d_priority;	/* Disk priority. */
 	u_int		 load;		/* Averaged queue length */
+	u_int		 d_lat_ewma;	/* Averaged read service time (us) */
 	off_t		 d_last_offset;	/* Last read offset */
 	uint64_t	 d_flags;	/* Additional flags. */
 	u_int		 d_genid;	/* Disk's generation ID. */
@@ -397,6 +400,8 @@ mirror_metadata_decode(const u_char *data, struct g_mirror_metadata *md)
 		break;
 	case 3:
 	case 4:
+	case 5:
+		/* Version 5 only extended the set of balance algorithms. */
 		error = mirror_metadata_decode_v3v4(data, md);
 		break;
 	default:
@@ -415,6 +420,7 @@ balance_name(u_int balance)
 		[G_MIRROR_BALANCE_LOAD] = "load",
 		[G_MIRROR_BALANCE_SPLIT] = "split",
 		[G_MIRROR_BALANCE_PREFER] = "prefer",
+		[G_MIRROR_BALANCE_LATENCY] = "latency",
 		[G_MIRROR_BALANCE_MAX + 1] = "unknown"
 	};
 
@@ -432,7 +438,8 @@ balance_id(const char *name)
 		[G_MIRROR_BALANCE_ROUND_ROBIN] = "round-robin",
 		[G_MIRROR_BALANCE_LOAD] = "load",
 		[G_MIRROR_BALANCE_SPLIT] = "split",
-		[G_MIRROR_BALANCE_PREFER] = "prefer"
+		[G_MIRROR_BALANCE_PREFER] = "prefer",
+		[G_MIRROR_BALANCE_LATENCY] = "latency"
 	};
 	int n;
 
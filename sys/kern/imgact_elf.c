@@ -49,6 +49,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/malloc.h>
 #include <sys/mount.h>
 #include <sys/mman.h>
+#include <sys/mutex.h>
 #include <sys/namei.h>
 #include <sys/proc.h>
 #include <sys/procfs.h>
@@ -99,6 +100,7 @@ static bool kfreebsd_trans_osrel(const Elf_Note *note, int32_t *osrel);
 static boolean_t __elfN(check_note)(struct image_params *imgp,
     Elf_Brandnote *checknote, int32_t *osrel, boolean_t *has_fctl0,
     uint32_t *fctl0);
+static void __elfN(brand_cache_purge)(Elf_Brandinfo *entry);
 static vm_prot_t __elfN(trans_prot)(Elf_Word);
 static Elf_Word __elfN(untrans_prot)(vm_prot_t);
 
@@ -283,6 +285,7 @@ __elfN(remove_brand_entry)(Elf_Brandinfo *entry)
 	}
 	if (i == MAX_BRANDS)
 		return (-1);
+	__elfN(brand_cache_purge)(entry);
 	return (0);
 }
 
@@ -304,6 +307,116 @@ __elfN(brand_inuse)(Elf_Brandinfo *entry)
 	return (rval);
 }
 
+/*
+ * Cache of brand identification results, keyed by the executable's
+ * vnode.  Identifying the brand of a binary walks its program headers
+ * and note segments, which may require reads beyond the first page; for
+ * workloads that exec the same binaries over and over, the result can
+ * be reused.  An entry is valid only while the file's identity
+ * (fsid/fileid/generation) and its size and timestamps are unchanged,
+ * so modifying or replacing a binary invalidates its entry.  The vnode
+ * pointer is used purely as a hash key and is never dereferenced.
+ */
+#define	ELF_BRAND_CACHE_SIZE	128	/* direct-mapped, power of 2 */
+#define	ELF_BRAND_CACHE_HASH(vp)					\
+	((((uintptr_t)(vp)) >> 8) & (ELF_BRAND_CACHE_SIZE - 1))
+
+struct elf_brand_cache_entry {
+	struct vnode	*vp;
+	dev_t		fsid;
+	ino_t		fileid;
+	u_long		gen;
+	u_quad_t	size;
+	struct timespec	mtime;
+	struct timespec	ctime;
+	Elf_Brandinfo	*brandinfo;
+	int		fallback;
+	int32_t		osrel;
+	uint32_t	fctl0;
+};
+
+static struct elf_brand_cache_entry __elfN(brand_cache)[ELF_BRAND_CACHE_SIZE];
+static struct mtx __elfN(brand_cache_lock);
+MTX_SYSINIT(__CONCAT(elf, __CONCAT(__ELF_WORD_SIZE, _brand_cache)),
+    &__elfN(brand_cache_lock), "elfbrcache", MTX_DEF);
+
+static int __elfN(brand_cache_enable) = 1;
+SYSCTL_INT(__CONCAT(_kern_elf, __ELF_WORD_SIZE), OID_AUTO,
+    brand_cache_enable, CTLFLAG_RWTUN, &__elfN(brand_cache_enable), 0,
+    "Cache ELF brand identification results per executable");
+
+static bool
+__elfN(brand_cache_match)(const struct elf_brand_cache_entry *bce,
+    const struct image_params *imgp)
+{
+	const struct vattr *attr;
+
+	attr = imgp->attr;
+	return (bce->vp == imgp->vp && bce->brandinfo != NULL &&
+	    bce->fallback == __elfN(fallback_brand) &&
+	    bce->fsid == attr->va_fsid && bce->fileid == attr->va_fileid &&
+	    bce->gen == attr->va_gen && bce->size == attr->va_size &&
+	    timespeccmp(&bce->mtime, &attr->va_mtime, ==) &&
+	    timespeccmp(&bce->ctime, &attr->va_ctime, ==));
+}
+
+static Elf_Brandinfo *
+__elfN(brand_cache_lookup)(struct image_params *imgp, int32_t *osrel,
+    uint32_t *fctl0)
+{
+	struct elf_brand_cache_entry *bce;
+	Elf_Brandinfo *bi;
+
+	bce = &__elfN(brand_cache)[ELF_BRAND_CACHE_HASH(imgp->vp)];
+	mtx_lock(&__elfN(brand_cache_lock));
+	if (!__elfN(brand_cache_match)(bce, imgp)) {
+		mtx_unlock(&__elfN(brand_cache_lock));
+		return (NULL);
+	}
+	bi = bce->brandinfo;
+	*osrel = bce->osrel;
+	*fctl0 = bce->fctl0;
+	mtx_unlock(&__elfN(brand_cache_lock));
+	return (bi);
+}
+
+static void
+__elfN(brand_cache_insert)(struct image_params *imgp, Elf_Brandinfo *bi,
+    int32_t osrel, uint32_t fctl0)
+{
+	struct elf_brand_cache_entry *bce;
+	const struct vattr *attr;
+
+	attr = imgp->attr;
+	bce = &__elfN(brand_cache)[ELF_BRAND_CACHE_HASH(imgp->vp)];
+	mtx_lock(&__elfN(brand_cache_lock));
+	bce->vp = imgp->vp;
+	bce->fsid = attr->va_fsid;
+	bce->fileid = attr->va_fileid;
+	bce->gen = attr->va_gen;
+	bce->size = attr->va_size;
+	bce->mtime = attr->va_mtime;
+	bce->ctime = attr->va_ctime;
+	bce->brandinfo = bi;
+	bce->fallback = __elfN(fallback_brand);
+	bce->osrel = osrel;
+	bce->fctl0 = fctl0;
+	mtx_unlock(&__elfN(brand_cache_lock));
+}
+
+static void
+__elfN(brand_cache_purge)(Elf_Brandinfo *entry)
+{
+	int i;
+
+	mtx_lock(&__elfN(brand_cache_lock));
+	for (i = 0; i < ELF_BRAND_CACHE_SIZE; i++) {
+		if (__elfN(brand_cache)[i].brandinfo == entry)
+			__elfN(brand_cache)[i].brandinfo = NULL;
+	}
+	mtx_unlock(&__elfN(brand_cache_lock));
+}
+
 static Elf_Brandinfo *
 __elfN(get_brandinfo)(struct image_params *imgp, const char *interp,
     int32_t *osrel, uint32_t *fctl0)
@@ -1160,7 +1273,16 @@ __CONCAT(exec_, __elfN(imgact))(struct image_params *imgp)
 		}
 	}
 
-	brand_info = __elfN(get_brandinfo)(imgp, interp, &osrel, &fctl0);
+	brand_info = NULL;
+	if (__elfN(brand_cache_enable))
+		brand_info = __elfN(brand_cache_lookup)(imgp, &osrel, &fctl0);
+	if (brand_info == NULL) {
+		brand_info = __elfN(get_brandinfo)(imgp, interp, &osrel,
+		    &fctl0);
+		if (brand_info != NULL && __elfN(brand_cache_enable))
+			__elfN(brand_cache_insert)(imgp, brand_info, osrel,
+			    fctl0);
+	}
 	if (brand_info == NULL) {
 		uprintf("ELF binary type \"%u\" not known.\n",
 		    hdr->e_ident[EI_OSABI]);
@@ -944,6 +944,23 @@ cpuset_testshadow(struct cpuset *set, const cpuset_t *mask,
 	return (0);
 }
 
+/*
+ * Decide whether a thread's existing anonymous set can simply be kept for
+ * a requested mask.  Affinity-managing daemons commonly re-apply an
+ * unchanged mask at a high rate; reusing the set keeps those calls off
+ * cpuset_lock entirely.  The current cs_mask is the flattened effective
+ * mask, so equality with the request also implies the parent subset check
+ * that shadowing would perform.
+ */
+static bool
+cpuset_shadow_reuse(struct cpuset *tdset, const cpuset_t *mask,
+    const struct domainset *domain)
+{
+
+	return (tdset->cs_id == CPUSET_INVALID && domain == NULL &&
+	    mask != NULL && CPU_CMP(&tdset->cs_mask, mask) == 0);
+}
+
 /*
  * Create an anonymous set with the provided mask in the space provided by
  * 'nset'.  If the passed in set is anonymous we use its parent otherwise
@@ -1015,6 +1032,10 @@ cpuset_setproc_maskthread(struct cpuset *tdset, cpuset_t *mask,
 {
 	struct cpuset *parent;
 
+	if (cpuset_shadow_reuse(tdset, mask, domain)) {
+		*nsetp = cpuset_ref(tdset);
+		return (0);
+	}
 	parent = cpuset_getbase(tdset);
 	if (mask == NULL)
 		mask = &tdset->cs_mask;
@@ -1351,10 +1372,15 @@ _cpuset_setthread(lwpid_t id, cpuset_t *mask, struct domainset *domain)
 		goto out;
 	set = NULL;
 	thread_lock(td);
-	error = cpuset_shadow(td->td_cpuset, &nset, mask, domain,
-	    &cpusets, &domainlist);
-	if (error == 0)
-		set = cpuset_update_thread(td, nset);
+	if (cpuset_shadow_reuse(td->td_cpuset, mask, domain)) {
+		/* The thread already runs with this mask; nothing to do. */
+		error = 0;
+	} else {
+		error = cpuset_shadow(td->td_cpuset, &nset, mask, domain,
+		    &cpusets, &domainlist);
+		if (error == 0)
+			set = cpuset_update_thread(td, nset);
+	}
 	thread_unlock(td);
 	PROC_UNLOCK(p);
 	if (set)
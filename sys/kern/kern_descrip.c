@@ -174,6 +174,7 @@ struct filedesc0 {
 	SLIST_HEAD(, freetable) fd_free;
 	struct	fdescenttbl0 fd_dfiles;
 	NDSLOTTYPE fd_dmap[NDSLOTS(NDFILE)];
+	NDSLOTTYPE fd_dfullmap[NDSLOTS(NDSLOTS(NDFILE))];
 };
 
 /*
@@ -193,7 +194,7 @@ fd_first_free(struct filedesc *fdp, int low, int size)
 {
 	NDSLOTTYPE *map = fdp->fd_map;
 	NDSLOTTYPE mask;
-	int off, maxoff;
+	int foff, fmaxoff, off, maxoff;
 
 	if (low >= size)
 		return (low);
@@ -205,9 +206,26 @@ fd_first_free(struct filedesc *fdp, int low, int size)
 			return (off * NDENTRIES + ffsl(mask) - 1);
 		++off;
 	}
-	for (maxoff = NDSLOTS(size); off < maxoff; ++off)
-		if (map[off] != ~0UL)
+	/*
+	 * Scan the summary bitmap, which has a bit set for every word of
+	 * fd_map with all of its descriptors in use, so that a large,
+	 * nearly full table is skipped NDENTRIES words at a time.
+	 */
+	maxoff = NDSLOTS(size);
+	mask = ~(NDSLOTTYPE)0 << (off % NDENTRIES);
+	for (foff = NDSLOT(off), fmaxoff = NDSLOT(maxoff - 1); foff <= fmaxoff;
+	    ++foff) {
+		mask &= ~fdp->fd_fullmap[foff];
+		if (mask != 0UL) {
+			off = foff * NDENTRIES + ffsl(mask) - 1;
+			if (off >= maxoff)
+				break;
+			KASSERT(map[off] != ~0UL,
+			    ("summary bit clear for full word %d", off));
 			return (off * NDENTRIES + ffsl(~map[off]) - 1);
+		}
+		mask = ~(NDSLOTTYPE)0;
+	}
 	return (size);
 }
 
@@ -258,6 +276,8 @@ fdused_init(struct filedesc *fdp, int fd)
 	KASSERT(!fdisused(fdp, fd), ("fd=%d is already used", fd));
 
 	fdp->fd_map[NDSLOT(fd)] |= NDBIT(fd);
+	if (fdp->fd_map[NDSLOT(fd)] == ~0UL)
+		fdp->fd_fullmap[NDSLOT(NDSLOT(fd))] |= NDBIT(NDSLOT(fd));
 }
 
 static void
@@ -285,6 +305,7 @@ fdunused(struct filedesc *fdp, int fd)
 	    ("fd=%d is still in use", fd));
 
 	fdp->fd_map[NDSLOT(fd)] &= ~NDBIT(fd);
+	fdp->fd_fullmap[NDSLOT(NDSLOT(fd))] &= ~NDBIT(NDSLOT(fd));
 	if (fd < fdp->fd_freefile)
 		fdp->fd_freefile = fd;
 }
@@ -1738,7 +1759,7 @@ fdgrowtable(struct filedesc *fdp, int nfd)
 	struct fdescenttbl *ntable;
 	struct fdescenttbl *otable;
 	int nnfiles, onfiles;
-	NDSLOTTYPE *nmap, *omap;
+	NDSLOTTYPE *nfullmap, *nmap, *ofullmap, *omap;
 
 	KASSERT(fdp->fd_nfiles > 0, ("zero-length file table"));
 
@@ -1782,6 +1803,21 @@ fdgrowtable(struct filedesc *fdp, int nfd)
 		fdp->fd_map = nmap;
 	}
 
+	/*
+	 * Likewise for the summary bitmap.  It is only accessed under the
+	 * table lock, so the old one can be freed right away.
+	 */
+	if (NDSLOTS(NDSLOTS(nnfiles)) > NDSLOTS(NDSLOTS(onfiles))) {
+		nfullmap = malloc(NDSLOTS(NDSLOTS(nnfiles)) * NDSLOTSIZE,
+		    M_FILEDESC, M_ZERO | M_WAITOK);
+		ofullmap = fdp->fd_fullmap;
+		memcpy(nfullmap, ofullmap,
+		    NDSLOTS(NDSLOTS(onfiles)) * sizeof(*ofullmap));
+		fdp->fd_fullmap = nfullmap;
+		if (NDSLOTS(NDSLOTS(onfiles)) > NDSLOTS(NDSLOTS(NDFILE)))
+			free(ofullmap, M_FILEDESC);
+	}
+
 	/*
 	 * Make sure that ntable is correctly initialized before we replace
 	 * fd_files poiner. Otherwise fget_unlocked() may see inconsistent
@@ -2044,6 +2080,7 @@ fdinit(struct filedesc *fdp, bool prepfiles, int *lastfile)
 	refcount_init(&newfdp->fd_holdcnt, 1);
 	newfdp->fd_cmask = CMASK;
 	newfdp->fd_map = newfdp0->fd_dmap;
+	newfdp->fd_fullmap = newfdp0->fd_dfullmap;
 	newfdp->fd_files = (struct fdescenttbl *)&newfdp0->fd_dfiles;
 	newfdp->fd_files->fdt_nfiles = NDFILE;
 
@@ -2341,6 +2378,8 @@ fdescfree_fds(struct thread *td, struct filedesc *fdp, bool needclose)
 
 	if (NDSLOTS(fdp->fd_nfiles) > NDSLOTS(NDFILE))
 		free(fdp->fd_map, M_FILEDESC);
+	if (NDSLOTS(NDSLOTS(fdp->fd_nfiles)) > NDSLOTS(NDSLOTS(NDFILE)))
+		free(fdp->fd_fullmap, M_FILEDESC);
 	if (fdp->fd_nfiles > NDFILE)
 		free(fdp->fd_files, M_FILEDESC);
 
@@ -4464,7 +4503,7 @@ badfo_chown(struct file *fp, uid_t uid, gid_t gid, struct ucred *active_cred,
 static int
 badfo_sendfile(struct file *fp, int sockfd, struct uio *hdr_uio,
     struct uio *trl_uio, off_t offset, size_t nbytes, off_t *sent, int flags,
-    struct thread *td)
+    struct sf_hdtr_kq *hdtr_kq, struct thread *td)
 {
 
 	return (EBADF);
@@ -4550,7 +4589,7 @@ invfo_chown(struct file *fp, uid_t uid, gid_t gid, struct ucred *active_cred,
 int
 invfo_sendfile(struct file *fp, int sockfd, struct uio *hdr_uio,
     struct uio *trl_uio, off_t offset, size_t nbytes, off_t *sent, int flags,
-    struct thread *td)
+    struct sf_hdtr_kq *hdtr_kq, struct thread *td)
 {
 
 	return (EINVAL);
@@ -104,6 +104,7 @@ static int	kevent_copyout(void *arg, struct kevent *kevp, int count);
 static int	kevent_copyin(void *arg, struct kevent *kevp, int count);
 static int	kqueue_register(struct kqueue *kq, struct kevent *kev,
 		    struct thread *td, int mflag);
+static int	kqueue_trigger_user(struct kqueue *kq, struct kevent *kev);
 static int	kqueue_acquire(struct file *fp, struct kqueue **kqp);
 static void	kqueue_release(struct kqueue *kq, int locked);
 static void	kqueue_destroy(struct kqueue *kq);
@@ -1210,6 +1211,38 @@ kern_kevent(struct thread *td, int fd, int nchanges, int nevents,
 	return (error);
 }
 
+/*
+ * Grow the fd knote table once to cover every EV_ADD in a changelist
+ * chunk.  Without this a large ascending registration burst reallocates
+ * and copies the table under kq_lock for change after change, which is
+ * quadratic in the number of descriptors.  Sizing errors are ignored
+ * here; kqueue_register() repeats the expansion and reports failures.
+ */
+static void
+kqueue_expand_batch(struct kqueue *kq, struct kevent *changes, int n)
+{
+	struct filterops *fops;
+	struct kevent *kevp;
+	uintptr_t maxfd;
+	int i;
+
+	maxfd = 0;
+	for (i = 0; i < n; i++) {
+		kevp = &changes[i];
+		if (kevp->filter == 0 || (kevp->flags & EV_ADD) == 0 ||
+		    kevp->ident > INT_MAX)
+			continue;
+		fops = kqueue_fo_find(kevp->filter);
+		if (fops == NULL)
+			continue;
+		if (fops->f_isfd && kevp->ident + 1 > maxfd)
+			maxfd = kevp->ident + 1;
+		kqueue_fo_release(kevp->filter);
+	}
+	if (maxfd != 0)
+		(void)kqueue_expand(kq, &file_filtops, maxfd - 1, M_WAITOK);
+}
+
 static int
 kqueue_kevent(struct kqueue *kq, struct thread *td, int nchanges, int nevents,
     struct kevent_copyops *k_ops, const struct timespec *timeout)
@@ -1225,6 +1258,8 @@ kqueue_kevent(struct kqueue *kq, struct thread *td, int nchanges, int nevents,
 		if (error)
 			return (error);
 		changes = keva;
+		if (n > 1)
+			kqueue_expand_batch(kq, changes, n);
 		for (i = 0; i < n; i++) {
 			kevp = &changes[i];
 			if (!kevp->filter)
@@ -1370,6 +1405,51 @@ kqueue_fo_release(int filt)
 	mtx_unlock(&filterops_lock);
 }
 
+/*
+ * Fast path for posting a bare NOTE_TRIGGER to an existing EVFILT_USER
+ * knote.  Userspace task schedulers post these as cross-thread doorbells
+ * at high rates, where the two lock acquisitions and the in-flux
+ * handshake of the full registration path dominate the cost.  A plain
+ * trigger needs none of that: the knote is looked up and activated under
+ * a single kq lock acquisition, and a trigger that is already pending
+ * coalesces into the queued event.  Returns ENOENT if the knote does not
+ * exist or is unstable, in which case the caller takes the full path.
+ */
+static int
+kqueue_trigger_user(struct kqueue *kq, struct kevent *kev)
+{
+	struct klist *list;
+	struct knote *kn;
+
+	kn = NULL;
+	KQ_LOCK(kq);
+	if (kq->kq_knhashmask != 0) {
+		list = &kq->kq_knhash[
+		    KN_HASH((u_long)kev->ident, kq->kq_knhashmask)];
+		SLIST_FOREACH(kn, list, kn_link)
+			if (kev->ident == kn->kn_id &&
+			    kn->kn_filter == EVFILT_USER)
+				break;
+	}
+	if (kn == NULL || kn_in_flux(kn)) {
+		KQ_UNLOCK(kq);
+		return (ENOENT);
+	}
+
+	/*
+	 * What filt_usertouch(EVENT_REGISTER) would do for this kevent;
+	 * the knote is stable since it is not in flux and we hold the
+	 * kq lock.
+	 */
+	kn->kn_hookid = 1;
+	kn->kn_sdata = kev->data;
+	kn->kn_kevent.udata = kev->udata;
+	if ((kn->kn_status & KN_DISABLED) == 0)
+		KNOTE_ACTIVATE(kn, 1);
+	KQ_UNLOCK(kq);
+	return (0);
+}
+
 /*
  * A ref to kq (obtained via kqueue_acquire) must be held.
  */
@@ -1387,6 +1467,16 @@ kqueue_register(struct kqueue *kq, struct kevent *kev, struct thread *td,
 	if ((kev->flags & (EV_ENABLE | EV_DISABLE)) == (EV_ENABLE | EV_DISABLE))
 		return (EINVAL);
 
+	/*
+	 * A trigger with no flags and no fflags update is the common way
+	 * to post a user event; it cannot create, delete or reconfigure
+	 * the knote, so try the short path first.
+	 */
+	if (kev->filter == EVFILT_USER && kev->flags == 0 &&
+	    kev->fflags == NOTE_TRIGGER &&
+	    kqueue_trigger_user(kq, kev) == 0)
+		return (0);
+
 	fp = NULL;
 	kn = NULL;
 	knl = NULL;
@@ -1707,8 +1797,10 @@ kqueue_expand(struct kqueue *kq, struct filterops *fops, uintptr_t ident,
 		fd = ident;
 		if (kq->kq_knlistsize <= fd) {
 			size = kq->kq_knlistsize;
+			if (size < KQEXTENT)
+				size = KQEXTENT;
 			while (size <= fd)
-				size += KQEXTENT;
+				size *= 2;
 			list = malloc(size * sizeof(*list), M_KQUEUE, mflag);
 			if (list == NULL)
 				return ENOMEM;
@@ -1826,6 +1918,18 @@ kqueue_scan(struct kqueue *kq, int maxevents, struct kevent_copyops *k_ops,
 			asbt = -1;
 	} else
 		asbt = 0;
+
+	/*
+	 * A non-blocking scan of an empty kqueue can complete without
+	 * taking kq_lock: a racing enqueue is indistinguishable from an
+	 * event arriving just after we return.  This keeps steady-state
+	 * polling of a shared kqueue by many threads from serializing on
+	 * the lock while no events are pending.
+	 */
+	if (asbt == -1 && atomic_load_int(&kq->kq_count) == 0) {
+		error = 0;
+		goto done_nl;
+	}
 	marker = knote_alloc(M_WAITOK);
 	marker->kn_status = KN_MARKER;
 	KQ_LOCK(kq);
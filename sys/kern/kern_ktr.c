@@ -40,8 +40,10 @@ __FBSDID("$FreeBSD$");
 #include <sys/param.h>
 #include <sys/queue.h>
 #include <sys/alq.h>
+#include <sys/conf.h>
 #include <sys/cons.h>
 #include <sys/cpuset.h>
+#include <sys/fcntl.h>
 #include <sys/kdb.h>
 #include <sys/kernel.h>
 #include <sys/ktr.h>
@@ -54,6 +56,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/sysctl.h>
 #include <sys/systm.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 
 #include <machine/cpu.h>
 
@@ -251,6 +254,57 @@ SYSCTL_PROC(_debug_ktr, OID_AUTO, entries,
     0, 0, sysctl_debug_ktr_entries, "I",
     "Number of entries in the KTR buffer");
 
+/*
+ * Optional per-CPU trace rings.  The global buffer serializes all CPUs
+ * on a single atomic index, so the cache line bouncing it causes can
+ * perturb exactly the hot paths being traced.  When debug.ktr.percpu is
+ * set at boot, each CPU instead claims entries from its own ring with an
+ * uncontended atomic_fetchadd() on a private sequence counter, and the
+ * rings are drained in binary form through /dev/ktr.  The global buffer
+ * (and the DDB reader) remain on the default path.
+ */
+struct ktr_pcpu_ring {
+	struct ktr_entry *kr_buf;
+	volatile u_long	kr_seq;		/* next entry to be claimed */
+	u_long		kr_rdseq;	/* /dev/ktr read cursor */
+} __aligned(CACHE_LINE_SIZE);
+
+static struct ktr_pcpu_ring *ktr_pcpu_rings;
+static int	ktr_pcpu = 0;
+static int	ktr_pcpu_entries = KTR_ENTRIES;
+
+SYSCTL_INT(_debug_ktr, OID_AUTO, percpu, CTLFLAG_RDTUN, &ktr_pcpu, 0,
+    "Trace into per-CPU rings drained via /dev/ktr");
+SYSCTL_INT(_debug_ktr, OID_AUTO, percpu_entries, CTLFLAG_RDTUN,
+    &ktr_pcpu_entries, 0, "Number of entries in each per-CPU KTR ring");
+
+static void
+ktr_pcpu_initializer(void *dummy __unused)
+{
+	struct ktr_pcpu_ring *rings;
+	int c;
+
+	if (ktr_pcpu == 0)
+		return;
+	if (ktr_pcpu_entries < KTR_BOOT_ENTRIES)
+		ktr_pcpu_entries = KTR_BOOT_ENTRIES;
+	if (ktr_pcpu_entries > KTR_ENTRIES_MAX)
+		ktr_pcpu_entries = KTR_ENTRIES_MAX;
+	rings = malloc(sizeof(*rings) * (mp_maxid + 1), M_KTR,
+	    M_WAITOK | M_ZERO);
+	for (c = 0; c <= mp_maxid; c++) {
+		if (CPU_ABSENT(c))
+			continue;
+		rings[c].kr_buf = malloc(sizeof(struct ktr_entry) *
+		    ktr_pcpu_entries, M_KTR, M_WAITOK | M_ZERO);
+	}
+	/* Publish only after the rings are fully constructed. */
+	atomic_store_rel_ptr((volatile uintptr_t *)&ktr_pcpu_rings,
+	    (uintptr_t)rings);
+}
+SYSINIT(ktr_pcpu_initializer, SI_SUB_SMP, SI_ORDER_ANY,
+    ktr_pcpu_initializer, NULL);
+
 #ifdef KTR_VERBOSE
 int	ktr_verbose = KTR_VERBOSE;
 TUNABLE_INT("debug.ktr.verbose", &ktr_verbose);
@@ -316,6 +370,123 @@ SYSCTL_PROC(_debug_ktr, OID_AUTO, alq_enable,
     "Enable KTR logging");
 #endif
 
+/*
+ * Streaming interface for the per-CPU rings.  A single reader drains
+ * all rings round-robin as a stream of struct ktr_io_ent records.  The
+ * reader never synchronizes with the tracepoints: an entry overwritten
+ * while it is being copied is detected by the lap check and discarded,
+ * but an entry claimed and not yet fully filled can be exported torn.
+ * The latter only affects the newest records and is inherent to the
+ * lock-free design; the DDB reader has the same property.
+ */
+static int	ktr_io_busy;
+
+static d_open_t		ktr_io_open;
+static d_close_t	ktr_io_close;
+static d_read_t		ktr_io_read;
+
+static struct cdevsw ktr_io_cdevsw = {
+	.d_version =	D_VERSION,
+	.d_open =	ktr_io_open,
+	.d_close =	ktr_io_close,
+	.d_read =	ktr_io_read,
+	.d_name =	"ktr",
+};
+
+static int
+ktr_io_open(struct cdev *dev, int oflags, int devtype, struct thread *td)
+{
+	struct ktr_pcpu_ring *kr;
+	int c;
+
+	if (atomic_cmpset_int(&ktr_io_busy, 0, 1) == 0)
+		return (EBUSY);
+	/* Start streaming from the present; older entries are history. */
+	CPU_FOREACH(c) {
+		kr = &ktr_pcpu_rings[c];
+		kr->kr_rdseq = kr->kr_seq;
+	}
+	return (0);
+}
+
+static int
+ktr_io_close(struct cdev *dev, int fflag, int devtype, struct thread *td)
+{
+
+	ktr_io_busy = 0;
+	return (0);
+}
+
+static int
+ktr_io_read(struct cdev *dev, struct uio *uio, int flag)
+{
+	struct ktr_io_ent kio;
+	struct ktr_pcpu_ring *kr;
+	u_long seq;
+	ssize_t resid;
+	int c, error, progress;
+
+	error = 0;
+	resid = uio->uio_resid;
+	while (uio->uio_resid >= sizeof(kio)) {
+		progress = 0;
+		CPU_FOREACH(c) {
+			if (uio->uio_resid < sizeof(kio))
+				break;
+			kr = &ktr_pcpu_rings[c];
+			seq = kr->kr_seq;
+			if (seq == kr->kr_rdseq)
+				continue;
+			kio.ktr_io_dropped = 0;
+			if (seq - kr->kr_rdseq > (u_long)ktr_pcpu_entries) {
+				kio.ktr_io_dropped = seq - kr->kr_rdseq -
+				    ktr_pcpu_entries;
+				kr->kr_rdseq = seq - ktr_pcpu_entries;
+			}
+			kio.ktr_io_seq = kr->kr_rdseq;
+			kio.ktr_io_cpu = c;
+			kio.ktr_io_ent =
+			    kr->kr_buf[kr->kr_rdseq % ktr_pcpu_entries];
+			/*
+			 * If the writers lapped us during the copy the
+			 * entry may be torn; drop it and let the next
+			 * pass resynchronize the cursor.
+			 */
+			if (kr->kr_seq - kr->kr_rdseq >
+			    (u_long)ktr_pcpu_entries)
+				continue;
+			kr->kr_rdseq++;
+			error = uiomove(&kio, sizeof(kio), uio);
+			if (error != 0)
+				return (error);
+			progress = 1;
+		}
+		if (progress)
+			continue;
+		/* All rings empty; return what we have or wait for more. */
+		if (uio->uio_resid != resid)
+			break;
+		if (flag & O_NONBLOCK)
+			return (EWOULDBLOCK);
+		error = pause_sig("ktrrd", hz / 10);
+		if (error != 0 && error != EWOULDBLOCK)
+			return (error);
+		error = 0;
+	}
+	return (error);
+}
+
+static void
+ktr_io_initializer(void *dummy __unused)
+{
+
+	if (ktr_pcpu_rings == NULL)
+		return;
+	make_dev(&ktr_io_cdevsw, 0, UID_ROOT, GID_WHEEL, 0400, "ktr");
+}
+SYSINIT(ktr_io_initializer, SI_SUB_DRIVERS, SI_ORDER_ANY,
+    ktr_io_initializer, NULL);
+
 void
 ktr_tracepoint(uint64_t mask, const char *file, int line, const char *format,
     u_long arg1, u_long arg2, u_long arg3, u_long arg4, u_long arg5,
@@ -362,7 +533,18 @@ ktr_tracepoint(uint64_t mask, const char *file, int line, const char *format,
 		}
 	} else
 #endif
-	{
+	if (ktr_pcpu_rings != NULL) {
+		struct ktr_pcpu_ring *kr;
+
+		/*
+		 * The fetchadd is uncontended unless a thread migrates
+		 * between reading its CPU id and claiming an entry, so
+		 * the claimed cache line stays local to this CPU.
+		 */
+		kr = &ktr_pcpu_rings[cpu];
+		entry = &kr->kr_buf[atomic_fetchadd_long(&kr->kr_seq, 1) %
+		    ktr_pcpu_entries];
+	} else {
 		do {
 			saveindex = ktr_idx;
 			newindex = (saveindex + 1) % ktr_entries;
@@ -124,8 +124,10 @@ static void	 lf_remove_outgoing(struct lockf_entry *);
 static void	 lf_remove_incoming(struct lockf_entry *);
 static int	 lf_add_outgoing(struct lockf *, struct lockf_entry *);
 static int	 lf_add_incoming(struct lockf *, struct lockf_entry *);
-static int	 lf_findoverlap(struct lockf_entry **, struct lockf_entry *,
-    int);
+static int	 lf_findoverlap(struct lockf *, struct lockf_entry **,
+    struct lockf_entry *, int);
+static struct lockf_entry *
+		 lf_first_overlap(struct lockf *, struct lockf_entry *);
 static struct lockf_entry *
 		 lf_getblock(struct lockf *, struct lockf_entry *);
 static int	 lf_getlock(struct lockf *, struct lockf_entry *, struct flock *);
@@ -173,6 +175,44 @@ static void	 lf_printlist(char *, struct lockf_entry *);
 static void	 lf_print_owner(struct lock_owner *);
 #endif
 
+/*
+ * Active locks are kept in an interval tree keyed by lf_start, with
+ * ties broken by the entry address so that shared locks from
+ * different owners starting at the same offset get a stable total
+ * order.  Each node carries the maximum lf_end of its subtree, which
+ * lets overlap searches prune whole subtrees.
+ */
+static int
+lf_entry_cmp(struct lockf_entry *a, struct lockf_entry *b)
+{
+
+	if (a->lf_start != b->lf_start)
+		return (a->lf_start < b->lf_start ? -1 : 1);
+	if ((uintptr_t)a != (uintptr_t)b)
+		return ((uintptr_t)a < (uintptr_t)b ? -1 : 1);
+	return (0);
+}
+
+static void
+lf_entry_augment(struct lockf_entry *lock)
+{
+	struct lockf_entry *child;
+	off_t max;
+
+	max = lock->lf_end;
+	child = RB_LEFT(lock, lf_tree);
+	if (child != NULL && child->lf_subtree_end > max)
+		max = child->lf_subtree_end;
+	child = RB_RIGHT(lock, lf_tree);
+	if (child != NULL && child->lf_subtree_end > max)
+		max = child->lf_subtree_end;
+	lock->lf_subtree_end = max;
+}
+
+#undef RB_AUGMENT
+#define	RB_AUGMENT(entry)	lf_entry_augment(entry)
+RB_GENERATE_STATIC(lockf_entry_tree, lockf_entry, lf_tree, lf_entry_cmp);
+
 /*
  * This structure is used to keep track of both local and remote lock
  * owners. The lf_owner field of the struct lockf_entry points back at
@@ -481,11 +521,23 @@ lf_advlockasync(struct vop_advlockasync_args *ap, struct lockf **statep,
 retry_setlock:
 
 	/*
-	 * Avoid the common case of unlocking when inode has no locks.
+	 * Avoid the common case of unlocking or testing when the
+	 * inode has no locks.  The vnode interlock only keeps *statep
+	 * stable; the emptiness checks are unlocked reads of fields
+	 * protected by ls_lock.  They can race a concurrent locker,
+	 * but a stale miss is indistinguishable from having run
+	 * before that locker took its lock, so no ordering promise
+	 * is broken.
 	 */
-	if (ap->a_op != F_SETLK && (*statep) == NULL) {
+	if (ap->a_op != F_SETLK &&
+	    ((*statep) == NULL ||
+	    ap->a_op == F_UNLCK || ap->a_op == F_GETLK)) {
 		VI_LOCK(vp);
-		if ((*statep) == NULL) {
+		state = *statep;
+		if (state == NULL ||
+		    ((ap->a_op == F_UNLCK || ap->a_op == F_GETLK) &&
+		    RB_EMPTY(&state->ls_active) &&
+		    LIST_EMPTY(&state->ls_pending))) {
 			fl->l_type = F_UNLCK;
 			VI_UNLOCK(vp);
 			return (0);
@@ -608,7 +660,7 @@ retry_setlock:
 
 		ls = malloc(sizeof(struct lockf), M_LOCKF, M_WAITOK|M_ZERO);
 		sx_init(&ls->ls_lock, "ls_lock");
-		LIST_INIT(&ls->ls_active);
+		RB_INIT(&ls->ls_active);
 		LIST_INIT(&ls->ls_pending);
 		ls->ls_threads = 1;
 
@@ -705,13 +757,13 @@ retry_setlock:
 	 * blocking locks. We also check the pending list for locks
 	 * which should be active (i.e. have no out-going edges).
 	 */
-	LIST_FOREACH(lock, &state->ls_active, lf_link) {
+	RB_FOREACH(lock, lockf_entry_tree, &state->ls_active) {
 		struct lockf_entry *lf;
-		if (LIST_NEXT(lock, lf_link))
-			KASSERT((lock->lf_start
-				<= LIST_NEXT(lock, lf_link)->lf_start),
+		lf = RB_NEXT(lockf_entry_tree, &state->ls_active, lock);
+		if (lf != NULL)
+			KASSERT((lock->lf_start <= lf->lf_start),
 			    ("locks disordered"));
-		LIST_FOREACH(lf, &state->ls_active, lf_link) {
+		RB_FOREACH(lf, lockf_entry_tree, &state->ls_active) {
 			if (lock == lf)
 				break;
 			KASSERT(!lf_blocks(lock, lf),
@@ -781,7 +833,7 @@ lf_purgelocks(struct vnode *vp, struct lockf **statep)
 		return;
 	}
 	*statep = NULL;
-	if (LIST_EMPTY(&state->ls_active) && state->ls_threads == 0) {
+	if (RB_EMPTY(&state->ls_active) && state->ls_threads == 0) {
 		KASSERT(LIST_EMPTY(&state->ls_pending),
 		    ("freeing state with pending locks"));
 		VI_UNLOCK(vp);
@@ -830,8 +882,8 @@ lf_purgelocks(struct vnode *vp, struct lockf **statep)
 	 */
 	KASSERT(LIST_EMPTY(&state->ls_pending),
 	    ("lock pending for %p", state));
-	LIST_FOREACH_SAFE(lock, &state->ls_active, lf_link, nlock) {
-		LIST_REMOVE(lock, lf_link);
+	RB_FOREACH_SAFE(lock, lockf_entry_tree, &state->ls_active, nlock) {
+		RB_REMOVE(lockf_entry_tree, &state->ls_active, lock);
 		lf_free_lock(lock);
 	}
 out_free:
@@ -988,10 +1040,10 @@ lf_add_outgoing(struct lockf *state, struct lockf_entry *lock)
 	struct lockf_entry *overlap;
 	int error;
 
-	LIST_FOREACH(overlap, &state->ls_active, lf_link) {
+	for (overlap = lf_first_overlap(state, lock); overlap != NULL;
+	    overlap = RB_NEXT(lockf_entry_tree, &state->ls_active, overlap)) {
 		/*
-		 * We may assume that the active list is sorted by
-		 * lf_start.
+		 * The tree is ordered by lf_start.
 		 */
 		if (overlap->lf_start > lock->lf_end)
 			break;
@@ -1087,28 +1139,16 @@ lf_add_incoming(struct lockf *state, struct lockf_entry *lock)
 }
 
 /*
- * Insert lock into the active list, keeping list entries ordered by
- * increasing values of lf_start.
+ * Insert lock into the active tree, which keeps its entries ordered
+ * by increasing values of lf_start.
  */
 static void
 lf_insert_lock(struct lockf *state, struct lockf_entry *lock)
 {
-	struct lockf_entry *lf, *lfprev;
-
-	if (LIST_EMPTY(&state->ls_active)) {
-		LIST_INSERT_HEAD(&state->ls_active, lock, lf_link);
-		return;
-	}
+	struct lockf_entry *old;
 
-	lfprev = NULL;
-	LIST_FOREACH(lf, &state->ls_active, lf_link) {
-		if (lf->lf_start > lock->lf_start) {
-			LIST_INSERT_BEFORE(lf, lock, lf_link);
-			return;
-		}
-		lfprev = lf;
-	}
-	LIST_INSERT_AFTER(lfprev, lock, lf_link);
+	old = RB_INSERT(lockf_entry_tree, &state->ls_active, lock);
+	KASSERT(old == NULL, ("duplicate active lock %p", old));
 }
 
 /*
@@ -1175,8 +1215,12 @@ lf_set_start(struct lockf *state, struct lockf_entry *lock, off_t new_start,
 {
 
 	KASSERT(new_start >= lock->lf_start, ("can't increase lock"));
+	/*
+	 * The tree is keyed on lf_start - take the lock out before
+	 * changing it.
+	 */
+	RB_REMOVE(lockf_entry_tree, &state->ls_active, lock);
 	lock->lf_start = new_start;
-	LIST_REMOVE(lock, lf_link);
 	lf_insert_lock(state, lock);
 	lf_update_dependancies(state, lock, FALSE, granted);
 }
@@ -1190,8 +1234,17 @@ lf_set_end(struct lockf *state, struct lockf_entry *lock, off_t new_end,
 	struct lockf_entry_list *granted)
 {
 
+	struct lockf_entry *lf;
+
 	KASSERT(new_end <= lock->lf_end, ("can't increase lock"));
 	lock->lf_end = new_end;
+	/*
+	 * Changing lf_end in place leaves the tree ordering intact
+	 * but invalidates the subtree maxima on the path to the root;
+	 * recompute them.
+	 */
+	for (lf = lock; lf != NULL; lf = RB_PARENT(lf, lf_tree))
+		lf_entry_augment(lf);
 	lf_update_dependancies(state, lock, FALSE, granted);
 }
 
@@ -1228,9 +1281,9 @@ lf_activate_lock(struct lockf *state, struct lockf_entry *lock)
 		 * Skip over locks owned by other processes.  Handle
 		 * any locks that overlap and are owned by ourselves.
 		 */
-		overlap = LIST_FIRST(&state->ls_active);
+		overlap = lf_first_overlap(state, lock);
 		for (;;) {
-			ovcase = lf_findoverlap(&overlap, lock, SELF);
+			ovcase = lf_findoverlap(state, &overlap, lock, SELF);
 
 #ifdef LOCKF_DEBUG
 			if (ovcase && (lockf_debug & 2)) {
@@ -1258,7 +1311,8 @@ lf_activate_lock(struct lockf *state, struct lockf_entry *lock)
 				 * into account a possible downgrade
 				 * or unlock. Remove the old lock.
 				 */
-				LIST_REMOVE(overlap, lf_link);
+				RB_REMOVE(lockf_entry_tree,
+				    &state->ls_active, overlap);
 				lf_update_dependancies(state, overlap, TRUE,
 					&granted);
 				lf_free_lock(overlap);
@@ -1274,10 +1328,12 @@ lf_activate_lock(struct lockf *state, struct lockf_entry *lock)
 			case 3: /* lock contains overlap */
 				/*
 				 * Delete the overlap and advance to
-				 * the next entry in the list.
+				 * the next entry in the tree.
 				 */
-				lf = LIST_NEXT(overlap, lf_link);
-				LIST_REMOVE(overlap, lf_link);
+				lf = RB_NEXT(lockf_entry_tree,
+				    &state->ls_active, overlap);
+				RB_REMOVE(lockf_entry_tree,
+				    &state->ls_active, overlap);
 				lf_update_dependancies(state, overlap, TRUE,
 					&granted);
 				lf_free_lock(overlap);
@@ -1291,7 +1347,8 @@ lf_activate_lock(struct lockf *state, struct lockf_entry *lock)
 				 */
 				lf_set_end(state, overlap, lock->lf_start - 1,
 				    &granted);
-				overlap = LIST_NEXT(overlap, lf_link);
+				overlap = RB_NEXT(lockf_entry_tree,
+				    &state->ls_active, overlap);
 				continue;
 
 			case 5: /* overlap ends after lock */
@@ -1549,11 +1606,8 @@ out:
 static int
 lf_clearlock(struct lockf *state, struct lockf_entry *unlock)
 {
-	struct lockf_entry *overlap;
 
-	overlap = LIST_FIRST(&state->ls_active);
-
-	if (overlap == NOLOCKF)
+	if (RB_EMPTY(&state->ls_active))
 		return (0);
 #ifdef LOCKF_DEBUG
 	if (unlock->lf_type != F_UNLCK)
@@ -1650,7 +1704,44 @@ lf_cancel(struct lockf *state, struct lockf_entry *lock, void *cookie)
 }
 
 /*
- * Walk the list of locks for an inode and
+ * Find the active lock with the lowest lf_start whose range overlaps
+ * the range of 'lock', or NULL if there is no overlap.  The subtree
+ * maxima let the search skip any subtree whose locks all end before
+ * the start of the range.
+ */
+static struct lockf_entry *
+lf_first_overlap(struct lockf *state, struct lockf_entry *lock)
+{
+	struct lockf_entry *lf, *left;
+
+	lf = RB_ROOT(&state->ls_active);
+	while (lf != NULL) {
+		left = RB_LEFT(lf, lf_tree);
+		if (left != NULL && left->lf_subtree_end >= lock->lf_start) {
+			/*
+			 * Some lock in the left subtree ends inside
+			 * or after the range; the leftmost overlap,
+			 * if any exists at all, is down there.
+			 */
+			lf = left;
+			continue;
+		}
+		if (lf->lf_start > lock->lf_end) {
+			/*
+			 * This lock and everything to the right
+			 * starts after the range ends.
+			 */
+			break;
+		}
+		if (lf->lf_end >= lock->lf_start)
+			return (lf);
+		lf = RB_RIGHT(lf, lf_tree);
+	}
+	return (NOLOCKF);
+}
+
+/*
+ * Walk the active locks for an inode and
  * return the first blocking lock.
  */
 static struct lockf_entry *
@@ -1658,10 +1749,10 @@ lf_getblock(struct lockf *state, struct lockf_entry *lock)
 {
 	struct lockf_entry *overlap;
 
-	LIST_FOREACH(overlap, &state->ls_active, lf_link) {
+	for (overlap = lf_first_overlap(state, lock); overlap != NULL;
+	    overlap = RB_NEXT(lockf_entry_tree, &state->ls_active, overlap)) {
 		/*
-		 * We may assume that the active list is sorted by
-		 * lf_start.
+		 * The tree is ordered by lf_start.
 		 */
 		if (overlap->lf_start > lock->lf_end)
 			break;
@@ -1673,11 +1764,11 @@ lf_getblock(struct lockf *state, struct lockf_entry *lock)
 }
 
 /*
- * Walk the list of locks for an inode to find an overlapping lock (if
+ * Walk the active locks for an inode to find an overlapping lock (if
  * any) and return a classification of that overlap.
  *
  * Arguments:
- *	*overlap	The place in the lock list to start looking
+ *	*overlap	The place in the active tree to start looking
  *	lock		The lock which is being tested
  *	type		Pass 'SELF' to test only locks with the same
  *			owner as lock, or 'OTHER' to test only locks
@@ -1698,7 +1789,8 @@ lf_getblock(struct lockf *state, struct lockf_entry *lock)
  *	 may be more than one.
  */
 static int
-lf_findoverlap(struct lockf_entry **overlap, struct lockf_entry *lock, int type)
+lf_findoverlap(struct lockf *state, struct lockf_entry **overlap,
+    struct lockf_entry *lock, int type)
 {
 	struct lockf_entry *lf;
 	off_t start, end;
@@ -1720,7 +1812,8 @@ lf_findoverlap(struct lockf_entry **overlap, struct lockf_entry *lock, int type)
 			break;
 		if (((type & SELF) && lf->lf_owner != lock->lf_owner) ||
 		    ((type & OTHERS) && lf->lf_owner == lock->lf_owner)) {
-			*overlap = LIST_NEXT(lf, lf_link);
+			*overlap = RB_NEXT(lockf_entry_tree,
+			    &state->ls_active, lf);
 			continue;
 		}
 #ifdef LOCKF_DEBUG
@@ -1744,7 +1837,8 @@ lf_findoverlap(struct lockf_entry **overlap, struct lockf_entry *lock, int type)
 			if (lockf_debug & 2)
 				printf("no overlap\n");
 #endif /* LOCKF_DEBUG */
-			*overlap = LIST_NEXT(lf, lf_link);
+			*overlap = RB_NEXT(lockf_entry_tree,
+			    &state->ls_active, lf);
 			continue;
 		}
 		if (lf->lf_start == start && lf->lf_end == end) {
@@ -1886,7 +1980,7 @@ lf_iteratelocks_sysid(int sysid, lf_iterator *fn, void *arg)
 	sx_xlock(&lf_lock_states_lock);
 	LIST_FOREACH(ls, &lf_lock_states, ls_link) {
 		sx_xlock(&ls->ls_lock);
-		LIST_FOREACH(lf, &ls->ls_active, lf_link) {
+		RB_FOREACH(lf, lockf_entry_tree, &ls->ls_active) {
 			if (lf->lf_owner->lo_sysid != sysid)
 				continue;
 
@@ -1956,7 +2050,7 @@ lf_iteratelocks_vnode(struct vnode *vp, lf_iterator *fn, void *arg)
 	VI_UNLOCK(vp);
 
 	sx_xlock(&ls->ls_lock);
-	LIST_FOREACH(lf, &ls->ls_active, lf_link) {
+	RB_FOREACH(lf, lockf_entry_tree, &ls->ls_active) {
 		ldesc = malloc(sizeof(struct lockdesc), M_LOCKF,
 		    M_WAITOK);
 		ldesc->vp = lf->lf_vnode;
@@ -2530,7 +2624,7 @@ lf_printlist(char *tag, struct lockf_entry *lock)
 	printf("%s: Lock list for ino %ju on dev <%s>:\n",
 	    tag, (uintmax_t)lock->lf_inode->i_number,
 	    devtoname(ITODEV(lock->lf_inode)));
-	LIST_FOREACH(lf, &lock->lf_vnode->v_lockf->ls_active, lf_link) {
+	RB_FOREACH(lf, lockf_entry_tree, &lock->lf_vnode->v_lockf->ls_active) {
 		printf("\tlock %p for ",(void *)lf);
 		lf_print_owner(lock->lf_owner);
 		printf(", %s, start %jd, end %jd",
@@ -820,6 +820,89 @@ free(void *addr, struct malloc_type *mtp)
 	malloc_type_freed(mtp, size);
 }
 
+/*
+ * Batch variant of malloc_type_freed(), recording "count" frees totalling
+ * "size" bytes with a single critical section.
+ */
+static void
+malloc_type_freed_batch(struct malloc_type *mtp, unsigned long size, int count)
+{
+	struct malloc_type_internal *mtip;
+	struct malloc_type_stats *mtsp;
+
+	critical_enter();
+	mtip = mtp->ks_handle;
+	mtsp = zpcpu_get(mtip->mti_stats);
+	mtsp->mts_memfreed += size;
+	mtsp->mts_numfrees += count;
+
+#ifdef KDTRACE_HOOKS
+	if (__predict_false(dtrace_malloc_enabled)) {
+		uint32_t probe_id = mtip->mti_probes[DTMALLOC_PROBE_FREE];
+		if (probe_id != 0)
+			(dtrace_malloc_probe)(probe_id,
+			    (uintptr_t) mtp, (uintptr_t) mtip,
+			    (uintptr_t) mtsp, size, 0);
+	}
+#endif
+
+	critical_exit();
+}
+
+/*
+ *	free_batch:
+ *
+ *	Free a batch of same-type blocks of memory allocated by malloc.
+ *	Mass teardown paths that release many allocations at once use this
+ *	to amortize the per-free statistics update; the blocks themselves
+ *	still go back through the owning zones' per-CPU buckets, which
+ *	provide the batching on the UMA side.  NULL entries are skipped.
+ *
+ *	This routine may not block.
+ */
+void
+free_batch(void **items, int count, struct malloc_type *mtp)
+{
+	uma_zone_t zone;
+	uma_slab_t slab;
+	void *addr;
+	u_long size;
+	int i, nfreed;
+
+	size = 0;
+	nfreed = 0;
+	for (i = 0; i < count; i++) {
+		addr = items[i];
+#ifdef MALLOC_DEBUG
+		if (free_dbg(&addr, mtp) != 0)
+			continue;
+#endif
+		/* free(NULL, ...) does nothing */
+		if (addr == NULL)
+			continue;
+
+		vtozoneslab((vm_offset_t)addr & (~UMA_SLAB_MASK), &zone,
+		    &slab);
+		if (slab == NULL)
+			panic("free: address %p(%p) has not been allocated.\n",
+			    addr, (void *)((u_long)addr & (~UMA_SLAB_MASK)));
+
+		if (__predict_true(!malloc_large_slab(slab))) {
+#ifdef INVARIANTS
+			free_save_type(addr, mtp, zone->uz_size);
+#endif
+			size += zone->uz_size;
+			uma_zfree_arg(zone, addr, slab);
+		} else {
+			size += malloc_large_size(slab);
+			free_large(addr, malloc_large_size(slab));
+		}
+		nfreed++;
+	}
+	if (nfreed != 0)
+		malloc_type_freed_batch(mtp, size, nfreed);
+}
+
 /*
  *	zfree:
  *
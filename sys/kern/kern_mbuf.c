@@ -48,6 +48,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/mutex.h>
 #include <sys/protosw.h>
 #include <sys/refcount.h>
+#include <sys/sbuf.h>
 #include <sys/sf_buf.h>
 #include <sys/smp.h>
 #include <sys/socket.h>
@@ -287,6 +288,48 @@ SYSCTL_PROC(_kern_ipc, OID_AUTO, nmbufs,
     &nmbufs, 0, sysctl_nmbufs, "IU",
     "Maximum number of mbufs allowed");
 
+static int
+sysctl_mb_domain_stats(SYSCTL_HANDLER_ARGS)
+{
+	struct sbuf sbuf;
+	uint32_t free_items, pages;
+	int domain, error, i;
+	static const struct {
+		const char *name;
+		uma_zone_t *zone;
+	} mbzones[] = {
+		{ "mbuf", &zone_mbuf },
+		{ "cluster", &zone_clust },
+		{ "jumbop", &zone_jumbop },
+		{ "jumbo9", &zone_jumbo9 },
+		{ "jumbo16", &zone_jumbo16 },
+	};
+
+	error = sysctl_wire_old_buffer(req, 0);
+	if (error != 0)
+		return (error);
+	sbuf_new_for_sysctl(&sbuf, NULL, 32 * vm_ndomains * nitems(mbzones),
+	    req);
+	for (i = 0; i < nitems(mbzones); i++) {
+		sbuf_printf(&sbuf, "%s:", mbzones[i].name);
+		for (domain = 0; domain < vm_ndomains; domain++) {
+			uma_zone_get_domain_stats(*mbzones[i].zone, domain,
+			    &pages, &free_items);
+			sbuf_printf(&sbuf, " domain%d %u pages %u free",
+			    domain, pages, free_items);
+		}
+		sbuf_printf(&sbuf, " %ju xdomain\n",
+		    (uintmax_t)uma_zone_get_xdomain(*mbzones[i].zone));
+	}
+	error = sbuf_finish(&sbuf);
+	sbuf_delete(&sbuf);
+	return (error);
+}
+SYSCTL_PROC(_kern_ipc, OID_AUTO, mb_domain_stats,
+    CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 0,
+    sysctl_mb_domain_stats, "A",
+    "Per-NUMA-domain mbuf zone backing store and cross-domain frees");
+
 /*
  * Zones from which we allocate.
  */
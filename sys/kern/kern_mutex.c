@@ -596,11 +596,13 @@ __mtx_lock_sleep(volatile uintptr_t *c, uintptr_t v)
 			    sched_tdname((struct thread *)tid),
 			    "spinning", "lockname:\"%s\"",
 			    m->lock_object.lo_name);
+			lda.waiters = lock_delay_spinner_enter(m);
 			do {
 				lock_delay(&lda);
 				v = MTX_READ_VALUE(m);
 				owner = lv_mtx_owner(v);
 			} while (v != MTX_UNOWNED && TD_IS_RUNNING(owner));
+			lock_delay_spinner_exit(m);
 			KTR_STATE0(KTR_SCHED, "thread",
 			    sched_tdname((struct thread *)tid),
 			    "running");
@@ -27,9 +27,11 @@ __FBSDID("$FreeBSD$");
 #include <sys/bio.h>
 #include <sys/buf.h>
 #include <sys/conf.h>
+#include <sys/kernel.h>
 #include <sys/malloc.h>
 #include <sys/proc.h>
 #include <sys/racct.h>
+#include <sys/sysctl.h>
 #include <sys/uio.h>
 #include <geom/geom.h>
 
@@ -38,6 +40,179 @@ __FBSDID("$FreeBSD$");
 #include <vm/vm_extern.h>
 #include <vm/vm_map.h>
 
+#define	PHYSIO_INFLIGHT_MAX	16
+
+static int physio_maxinflight = 1;
+SYSCTL_INT(_kern, OID_AUTO, physio_maxinflight, CTLFLAG_RWTUN,
+    &physio_maxinflight, 0,
+    "Maximum number of concurrently issued chunks of a split physio request");
+
+struct physio_seg {
+	struct bio	 *ps_bp;
+	struct vm_page	**ps_pages;
+	int		  ps_npages;
+};
+
+/*
+ * Process a request larger than the device's maximum I/O size by keeping
+ * several chunks in flight at once instead of waiting for each chunk in
+ * turn.  Chunks are retired strictly in issue order, so the uio is only
+ * advanced over the contiguous prefix that transferred in full; once a
+ * chunk comes back short or in error, the chunks issued after it are
+ * drained and their results discarded.
+ *
+ * This path is only usable when no pbuf KVA mapping is needed, i.e. for
+ * kernel buffers and for user buffers on devices accepting unmapped I/O,
+ * since a pbuf can map only one chunk at a time.
+ */
+static int
+physio_parallel(struct cdev *dev, struct uio *uio, int maxinflight)
+{
+	struct cdevsw *csw;
+	struct physio_seg *segs, *seg;
+	struct bio *bp;
+	struct iovec *iov;
+	caddr_t base;
+	off_t off;
+	size_t resid;
+	vm_prot_t prot;
+	u_int iolen, poff;
+	int error, i, inflight, maxpages, tail;
+	bool stop;
+
+	csw = dev->si_devsw;
+	if (maxinflight > PHYSIO_INFLIGHT_MAX)
+		maxinflight = PHYSIO_INFLIGHT_MAX;
+
+	maxpages = btoc(MAXPHYS) + 1;
+	segs = malloc(sizeof(*segs) * maxinflight, M_DEVBUF,
+	    M_WAITOK | M_ZERO);
+	for (i = 0; i < maxinflight; i++) {
+		segs[i].ps_bp = g_alloc_bio();
+		if (uio->uio_segflg == UIO_USERSPACE)
+			segs[i].ps_pages = malloc(sizeof(*segs[i].ps_pages) *
+			    maxpages, M_DEVBUF, M_WAITOK);
+	}
+	prot = VM_PROT_READ;
+	if (uio->uio_rw == UIO_READ)
+		prot |= VM_PROT_WRITE;	/* Less backwards than it looks */
+	error = 0;
+	stop = false;
+	for (i = 0; i < uio->uio_iovcnt && !stop; i++) {
+#ifdef RACCT
+		if (racct_enable) {
+			PROC_LOCK(curproc);
+			if (uio->uio_rw == UIO_READ) {
+				racct_add_force(curproc, RACCT_READBPS,
+				    uio->uio_iov[i].iov_len);
+				racct_add_force(curproc, RACCT_READIOPS, 1);
+			} else {
+				racct_add_force(curproc, RACCT_WRITEBPS,
+				    uio->uio_iov[i].iov_len);
+				racct_add_force(curproc, RACCT_WRITEIOPS, 1);
+			}
+			PROC_UNLOCK(curproc);
+		}
+#endif /* RACCT */
+
+		iov = &uio->uio_iov[i];
+		off = uio->uio_offset;
+		base = iov->iov_base;
+		resid = iov->iov_len;
+		tail = 0;
+		inflight = 0;
+		while (resid != 0 || inflight != 0) {
+			/*
+			 * Fill the window.
+			 */
+			while (!stop && resid != 0 && inflight < maxinflight) {
+				seg = &segs[(tail + inflight) % maxinflight];
+				bp = seg->ps_bp;
+				g_reset_bio(bp);
+				if (uio->uio_rw == UIO_READ) {
+					bp->bio_cmd = BIO_READ;
+					curthread->td_ru.ru_inblock++;
+				} else {
+					bp->bio_cmd = BIO_WRITE;
+					curthread->td_ru.ru_oublock++;
+				}
+				bp->bio_offset = off;
+				bp->bio_data = base;
+				bp->bio_length = resid;
+				if (bp->bio_length > dev->si_iosize_max)
+					bp->bio_length = dev->si_iosize_max;
+				if (bp->bio_length > MAXPHYS)
+					bp->bio_length = MAXPHYS;
+				bp->bio_bcount = bp->bio_length;
+				bp->bio_dev = dev;
+				if (seg->ps_pages != NULL) {
+					poff = (vm_offset_t)base & PAGE_MASK;
+					seg->ps_npages =
+					    vm_fault_quick_hold_pages(
+					    &curproc->p_vmspace->vm_map,
+					    (vm_offset_t)base, bp->bio_length,
+					    prot, seg->ps_pages, maxpages);
+					if (seg->ps_npages < 0) {
+						error = EFAULT;
+						stop = true;
+						break;
+					}
+					bp->bio_ma = seg->ps_pages;
+					bp->bio_ma_n = seg->ps_npages;
+					bp->bio_ma_offset = poff;
+					bp->bio_data = unmapped_buf;
+					bp->bio_flags |= BIO_UNMAPPED;
+				}
+				off += bp->bio_length;
+				base += bp->bio_length;
+				resid -= bp->bio_length;
+				csw->d_strategy(bp);
+				inflight++;
+			}
+			if (inflight == 0)
+				break;
+
+			/*
+			 * Retire the oldest chunk.
+			 */
+			seg = &segs[tail];
+			bp = seg->ps_bp;
+			if (uio->uio_rw == UIO_READ)
+				biowait(bp, "physrd");
+			else
+				biowait(bp, "physwr");
+			if (seg->ps_pages != NULL)
+				vm_page_unhold_pages(seg->ps_pages,
+				    seg->ps_npages);
+			tail = (tail + 1) % maxinflight;
+			inflight--;
+			if (stop)
+				continue;
+
+			iolen = bp->bio_length - bp->bio_resid;
+			if (iolen == 0 && !(bp->bio_flags & BIO_ERROR)) {
+				stop = true;	/* EOF */
+				continue;
+			}
+			iov->iov_len -= iolen;
+			iov->iov_base = (char *)iov->iov_base + iolen;
+			uio->uio_resid -= iolen;
+			uio->uio_offset += iolen;
+			if (bp->bio_flags & BIO_ERROR) {
+				error = bp->bio_error;
+				stop = true;
+			} else if (iolen < bp->bio_length)
+				stop = true;	/* Short transfer. */
+		}
+	}
+	for (i = 0; i < maxinflight; i++) {
+		g_destroy_bio(segs[i].ps_bp);
+		free(segs[i].ps_pages, M_DEVBUF);
+	}
+	free(segs, M_DEVBUF);
+	return (error);
+}
+
 int
 physio(struct cdev *dev, struct uio *uio, int ioflag)
 {
@@ -95,6 +270,19 @@ physio(struct cdev *dev, struct uio *uio, int ioflag)
 	 */
 	PHOLD(curproc);
 
+	/*
+	 * Requests that have to be split and do not need the pbuf KVA
+	 * mapping can keep several chunks in flight at once.
+	 */
+	if (physio_maxinflight > 1 && (dev->si_flags & SI_NOSPLIT) == 0 &&
+	    uio->uio_resid > MIN(dev->si_iosize_max, MAXPHYS) &&
+	    (uio->uio_segflg != UIO_USERSPACE ||
+	    ((dev->si_flags & SI_UNMAPPED) != 0 && unmapped_buf_allowed))) {
+		error = physio_parallel(dev, uio, physio_maxinflight);
+		PRELE(curproc);
+		return (error);
+	}
+
 	bp = g_alloc_bio();
 	if (uio->uio_segflg != UIO_USERSPACE) {
 		pbuf = NULL;
@@ -286,6 +286,29 @@ static int unprivileged_idprio;
 SYSCTL_INT(_security_bsd, OID_AUTO, unprivileged_idprio, CTLFLAG_RW,
     &unprivileged_idprio, 0, "Allow non-root users to set an idle priority");
 
+/*
+ * Rank the scheduling classes by urgency for comparing rtprio settings
+ * across threads.  RTP_PRIO_LOWLAT dispatches between realtime and
+ * timeshare despite its numeric class value.
+ */
+static int
+rtp_type_order(u_short type)
+{
+
+	switch (RTP_PRIO_BASE(type)) {
+	case RTP_PRIO_ITHD:
+		return (0);
+	case RTP_PRIO_REALTIME:
+		return (1);
+	case RTP_PRIO_LOWLAT:
+		return (2);
+	case RTP_PRIO_NORMAL:
+		return (3);
+	default:
+		return (4);
+	}
+}
+
 /*
  * Set realtime priority for LWP.
  */
@@ -352,6 +375,7 @@ sys_rtprio_thread(struct thread *td, struct rtprio_thread_args *uap)
 		 * only thing that makes it possible.
 		 */
 		if (RTP_PRIO_BASE(rtp.type) == RTP_PRIO_REALTIME ||
+		    RTP_PRIO_BASE(rtp.type) == RTP_PRIO_LOWLAT ||
 		    (RTP_PRIO_BASE(rtp.type) == RTP_PRIO_IDLE &&
 		    unprivileged_idprio == 0)) {
 			error = priv_check(td, PRIV_SCHED_RTPRIO);
@@ -422,8 +446,10 @@ sys_rtprio(struct thread *td, struct rtprio_args *uap)
 			rtp.prio = RTP_PRIO_MAX;
 			FOREACH_THREAD_IN_PROC(p, tdp) {
 				pri_to_rtp(tdp, &rtp2);
-				if (rtp2.type <  rtp.type ||
-				    (rtp2.type == rtp.type &&
+				if (rtp_type_order(rtp2.type) <
+				    rtp_type_order(rtp.type) ||
+				    (rtp_type_order(rtp2.type) ==
+				    rtp_type_order(rtp.type) &&
 				    rtp2.prio < rtp.prio)) {
 					rtp.type = rtp2.type;
 					rtp.prio = rtp2.prio;
@@ -442,6 +468,7 @@ sys_rtprio(struct thread *td, struct rtprio_args *uap)
 		 * threads holding a lock.
 		 */
 		if (RTP_PRIO_BASE(rtp.type) == RTP_PRIO_REALTIME ||
+		    RTP_PRIO_BASE(rtp.type) == RTP_PRIO_LOWLAT ||
 		    (RTP_PRIO_BASE(rtp.type) == RTP_PRIO_IDLE &&
 		    !unprivileged_idprio)) {
 			error = priv_check(td, PRIV_SCHED_RTPRIO);
@@ -483,6 +510,11 @@ rtp_to_pri(struct rtprio *rtp, struct thread *td)
 			return (EINVAL);
 		newpri = PRI_MIN_REALTIME + rtp->prio;
 		break;
+	case RTP_PRIO_LOWLAT:
+		if (rtp->prio > RTP_PRIO_MAX)
+			return (EINVAL);
+		newpri = PRI_MIN_TIMESHARE + rtp->prio;
+		break;
 	case RTP_PRIO_NORMAL:
 		if (rtp->prio > (PRI_MAX_TIMESHARE - PRI_MIN_TIMESHARE))
 			return (EINVAL);
@@ -524,6 +556,9 @@ pri_to_rtp(struct thread *td, struct rtprio *rtp)
 	case PRI_REALTIME:
 		rtp->prio = td->td_base_user_pri - PRI_MIN_REALTIME;
 		break;
+	case PRI_LOWLAT:
+		rtp->prio = td->td_base_user_pri - PRI_MIN_TIMESHARE;
+		break;
 	case PRI_TIMESHARE:
 		rtp->prio = td->td_base_user_pri - PRI_MIN_TIMESHARE;
 		break;
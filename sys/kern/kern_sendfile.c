@@ -35,6 +35,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/param.h>
 #include <sys/systm.h>
 #include <sys/capsicum.h>
+#include <sys/event.h>
 #include <sys/kernel.h>
 #include <sys/lock.h>
 #include <sys/ktls.h>
@@ -45,6 +46,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/mbuf.h>
 #include <sys/proc.h>
 #include <sys/protosw.h>
+#include <sys/refcount.h>
 #include <sys/rwlock.h>
 #include <sys/sf_buf.h>
 #include <sys/socket.h>
@@ -100,13 +102,25 @@ struct sf_io {
 };
 
 /*
- * Structure used to track requests with SF_SYNC flag.
+ * Structure used to track requests with SF_SYNC or SF_KQUEUE flags.
+ * In both modes 'count' covers every mbuf carrying file data or
+ * headers/trailers, and the request is complete once it drops to zero
+ * after the syscall has finished submitting.  SF_SYNC sleeps on the
+ * condition variable; SF_KQUEUE instead activates an EVFILT_SENDFILE
+ * knote and stays around until the knote is detached, which the
+ * refcount tracks.
  */
 struct sendfile_sync {
 	struct mtx	mtx;
 	struct cv	cv;
 	unsigned	count;
 	bool		waiting;
+	bool		kqueue;		/* kevent instead of cv_signal() */
+	bool		finished;
+	int		error;		/* result of the syscall */
+	off_t		sbytes;		/* bytes the syscall queued */
+	struct knlist	knl;		/* valid only if kqueue */
+	u_int		refs;		/* valid only if kqueue */
 };
 
 static void
@@ -114,23 +128,42 @@ sendfile_sync_destroy(struct sendfile_sync *sfs)
 {
 	KASSERT(sfs->count == 0, ("sendfile sync %p still busy", sfs));
 
+	if (sfs->kqueue)
+		knlist_destroy(&sfs->knl);
 	cv_destroy(&sfs->cv);
 	mtx_destroy(&sfs->mtx);
 	free(sfs, M_SENDFILE);
 }
 
+static void
+sendfile_sync_rele(struct sendfile_sync *sfs)
+{
+	KASSERT(sfs->kqueue, ("sendfile sync %p not kqueue mode", sfs));
+
+	if (refcount_release(&sfs->refs))
+		sendfile_sync_destroy(sfs);
+}
+
 static void
 sendfile_sync_signal(struct sendfile_sync *sfs)
 {
 	mtx_lock(&sfs->mtx);
 	KASSERT(sfs->count > 0, ("sendfile sync %p not busy", sfs));
 	if (--sfs->count == 0) {
-		if (!sfs->waiting) {
+		if (sfs->waiting) {
+			/* Syscall still submitting; it finishes the job. */
+			if (!sfs->kqueue)
+				cv_signal(&sfs->cv);
+		} else if (sfs->kqueue) {
+			sfs->finished = true;
+			KNOTE_LOCKED(&sfs->knl, 0);
+			mtx_unlock(&sfs->mtx);
+			sendfile_sync_rele(sfs);
+			return;
+		} else {
 			/* The sendfile() waiter was interrupted by a signal. */
 			sendfile_sync_destroy(sfs);
 			return;
-		} else {
-			cv_signal(&sfs->cv);
 		}
 	}
 	mtx_unlock(&sfs->mtx);
@@ -162,6 +195,75 @@ SYSCTL_PROC(_kern_ipc, OID_AUTO, sfstat,
     sfstat_sysctl, "I",
     "sendfile statistics");
 
+/* kqueue attach function */
+static int
+filt_sfsattach(struct knote *kn)
+{
+	struct sendfile_sync *sfs;
+
+	sfs = (struct sendfile_sync *)(uintptr_t)kn->kn_sdata;
+
+	/*
+	 * The sendfile_sync pointer must be validated before using it, so
+	 * registration is restricted to the kernel; the user cannot
+	 * set EV_FLAG1.
+	 */
+	if ((kn->kn_flags & EV_FLAG1) == 0)
+		return (EPERM);
+	kn->kn_ptr.p_v = sfs;
+	kn->kn_flags &= ~EV_FLAG1;
+
+	knlist_add(&sfs->knl, kn, 0);
+
+	return (0);
+}
+
+/* kqueue detach function */
+static void
+filt_sfsdetach(struct knote *kn)
+{
+	struct sendfile_sync *sfs;
+	struct knlist *knl;
+
+	sfs = kn->kn_ptr.p_v;
+	knl = &sfs->knl;
+	knl->kl_lock(knl->kl_lockarg);
+	if (!knlist_empty(knl))
+		knlist_remove(knl, kn, 1);
+	knl->kl_unlock(knl->kl_lockarg);
+	sendfile_sync_rele(sfs);
+}
+
+/* kqueue filter function */
+/*ARGSUSED*/
+static int
+filt_sendfile(struct knote *kn, long hint)
+{
+	struct sendfile_sync *sfs;
+
+	sfs = kn->kn_ptr.p_v;
+	if (!sfs->finished)
+		return (0);
+	kn->kn_data = sfs->sbytes;
+	kn->kn_fflags = sfs->error;
+	return (1);
+}
+
+static struct filterops sendfile_filtops = {
+	.f_isfd = 0,
+	.f_attach = filt_sfsattach,
+	.f_detach = filt_sfsdetach,
+	.f_event = filt_sendfile,
+};
+
+static void
+sendfile_filter_init(const void *unused)
+{
+
+	kqueue_add_filteropts(EVFILT_SENDFILE, &sendfile_filtops);
+}
+SYSINIT(sendfile_filt, SI_SUB_MBUF, SI_ORDER_ANY, sendfile_filter_init, NULL);
+
 static void
 sendfile_free_mext(struct mbuf *m)
 {
@@ -662,7 +764,7 @@ sendfile_getsock(struct thread *td, int s, struct file **sock_fp,
 int
 vn_sendfile(struct file *fp, int sockfd, struct uio *hdr_uio,
     struct uio *trl_uio, off_t offset, size_t nbytes, off_t *sent, int flags,
-    struct thread *td)
+    struct sf_hdtr_kq *hdtr_kq, struct thread *td)
 {
 	struct file *sock_fp;
 	struct vnode *vp;
@@ -712,11 +814,44 @@ vn_sendfile(struct file *fp, int sockfd, struct uio *hdr_uio,
 	SFSTAT_INC(sf_syscalls);
 	SFSTAT_ADD(sf_rhpages_requested, SF_READAHEAD(flags));
 
-	if (flags & SF_SYNC) {
+	if (flags & (SF_SYNC | SF_KQUEUE)) {
 		sfs = malloc(sizeof(*sfs), M_SENDFILE, M_WAITOK | M_ZERO);
 		mtx_init(&sfs->mtx, "sendfile", NULL, MTX_DEF);
 		cv_init(&sfs->cv, "sendfile");
 		sfs->waiting = true;
+		if (flags & SF_KQUEUE) {
+			struct kevent kev;
+
+			if (hdtr_kq == NULL) {
+				cv_destroy(&sfs->cv);
+				mtx_destroy(&sfs->mtx);
+				free(sfs, M_SENDFILE);
+				sfs = NULL;
+				error = EINVAL;
+				goto out;
+			}
+			sfs->kqueue = true;
+			knlist_init_mtx(&sfs->knl, &sfs->mtx);
+			/* One reference for us, one for the knote. */
+			refcount_init(&sfs->refs, 2);
+
+			memset(&kev, 0, sizeof(kev));
+			kev.ident = hdtr_kq->kq_ident;
+			kev.filter = EVFILT_SENDFILE;
+			kev.flags = EV_ADD | EV_ENABLE | EV_FLAG1;
+			kev.data = (intptr_t)sfs;
+			kev.udata = hdtr_kq->kq_udata;
+			error = kqfd_register(hdtr_kq->kq_fd, &kev, td,
+			    M_WAITOK);
+			if (error != 0) {
+				knlist_destroy(&sfs->knl);
+				cv_destroy(&sfs->cv);
+				mtx_destroy(&sfs->mtx);
+				free(sfs, M_SENDFILE);
+				sfs = NULL;
+				goto out;
+			}
+		}
 	}
 
 	rem = nbytes ? omin(nbytes, obj_size - offset) : obj_size - offset;
@@ -1207,13 +1342,33 @@ out:
 
 	if (sfs != NULL) {
 		mtx_lock(&sfs->mtx);
-		if (sfs->count != 0)
-			error = cv_wait_sig(&sfs->cv, &sfs->mtx);
-		if (sfs->count == 0) {
-			sendfile_sync_destroy(sfs);
-		} else {
+		if (sfs->kqueue) {
+			/*
+			 * Record the result for the completion event and
+			 * return without waiting; the EVFILT_SENDFILE
+			 * knote fires once the last mbuf carrying file
+			 * data has been freed, i.e. all queued data has
+			 * been sent and acknowledged.
+			 */
+			sfs->error = (error == ERESTART) ? EINTR : error;
+			sfs->sbytes = sbytes;
 			sfs->waiting = false;
-			mtx_unlock(&sfs->mtx);
+			if (sfs->count == 0) {
+				sfs->finished = true;
+				KNOTE_LOCKED(&sfs->knl, 0);
+				mtx_unlock(&sfs->mtx);
+				sendfile_sync_rele(sfs);
+			} else
+				mtx_unlock(&sfs->mtx);
+		} else {
+			if (sfs->count != 0)
+				error = cv_wait_sig(&sfs->cv, &sfs->mtx);
+			if (sfs->count == 0) {
+				sendfile_sync_destroy(sfs);
+			} else {
+				sfs->waiting = false;
+				mtx_unlock(&sfs->mtx);
+			}
 		}
 	}
 #ifdef KERN_TLS
@@ -1231,6 +1386,7 @@ static int
 sendfile(struct thread *td, struct sendfile_args *uap, int compat)
 {
 	struct sf_hdtr hdtr;
+	struct sf_hdtr_kq hdtr_kq;
 	struct uio *hdr_uio, *trl_uio;
 	struct file *fp;
 	off_t sbytes;
@@ -1243,11 +1399,22 @@ sendfile(struct thread *td, struct sendfile_args *uap, int compat)
 	if (uap->offset < 0)
 		return (EINVAL);
 
+	/*
+	 * SF_KQUEUE carries the completion kevent parameters in an
+	 * extended header/trailer structure.
+	 */
+	if ((uap->flags & SF_KQUEUE) && uap->hdtr == NULL)
+		return (EINVAL);
+
 	sbytes = 0;
 	hdr_uio = trl_uio = NULL;
 
 	if (uap->hdtr != NULL) {
-		error = copyin(uap->hdtr, &hdtr, sizeof(hdtr));
+		if (uap->flags & SF_KQUEUE) {
+			error = copyin(uap->hdtr, &hdtr_kq, sizeof(hdtr_kq));
+			hdtr = hdtr_kq.hdtr;
+		} else
+			error = copyin(uap->hdtr, &hdtr, sizeof(hdtr));
 		if (error != 0)
 			goto out;
 		if (hdtr.headers != NULL) {
@@ -1287,7 +1454,8 @@ sendfile(struct thread *td, struct sendfile_args *uap, int compat)
 		goto out;
 
 	error = fo_sendfile(fp, uap->s, hdr_uio, trl_uio, uap->offset,
-	    uap->nbytes, &sbytes, uap->flags, td);
+	    uap->nbytes, &sbytes, uap->flags,
+	    (uap->flags & SF_KQUEUE) ? &hdtr_kq : NULL, td);
 	fdrop(fp, td);
 
 	if (uap->sbytes != NULL)
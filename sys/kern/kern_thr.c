@@ -202,6 +202,7 @@ thread_create(struct thread *td, struct rtprio *rtp,
 		switch(rtp->type) {
 		case RTP_PRIO_REALTIME:
 		case RTP_PRIO_FIFO:
+		case RTP_PRIO_LOWLAT:
 			/* Only root can set scheduler policy */
 			if (priv_check(td, PRIV_SCHED_SETPOLICY) != 0)
 				return (EPERM);
@@ -97,6 +97,7 @@ static int	itimer_init(void *, int, int);
 static void	itimer_fini(void *, int);
 static void	itimer_enter(struct itimer *);
 static void	itimer_leave(struct itimer *);
+static void	itimer_overrun(struct itimer *);
 static struct itimer *itimer_find(struct proc *, int);
 static void	itimers_alloc(struct proc *);
 static void	itimers_event_hook_exec(void *arg, struct proc *p, struct image_params *imgp);
@@ -1591,9 +1592,9 @@ itimer_accept(struct proc *p, int timerid, ksiginfo_t *ksi)
 	PROC_LOCK_ASSERT(p, MA_OWNED);
 	it = itimer_find(p, timerid);
 	if (it != NULL) {
-		ksi->ksi_overrun = it->it_overrun;
-		it->it_overrun_last = it->it_overrun;
-		it->it_overrun = 0;
+		ksi->ksi_overrun = atomic_readandclear_int(
+		    (volatile u_int *)&it->it_overrun);
+		it->it_overrun_last = ksi->ksi_overrun;
 		ITIMER_UNLOCK(it);
 		return (0);
 	}
@@ -1629,10 +1630,7 @@ realtimer_expire(void *arg)
 				    &it->it_time.it_interval,
 				    &it->it_time.it_value);
 			while (timespeccmp(&cts, &it->it_time.it_value, >=)) {
-				if (it->it_overrun < INT_MAX)
-					it->it_overrun++;
-				else
-					it->it_ksi.ksi_errno = ERANGE;
+				itimer_overrun(it);
 				timespecadd(&it->it_time.it_value,
 					    &it->it_time.it_interval,
 					    &it->it_time.it_value);
@@ -1661,6 +1659,27 @@ realtimer_expire(void *arg)
 	}
 }
 
+/*
+ * Account an expiration of a timer whose previous signal is still
+ * pending.  The overrun counter is maintained with atomics so that
+ * callers need not hold the process lock; it is consumed and reset by
+ * itimer_accept() when the pending signal is finally delivered.
+ */
+static void
+itimer_overrun(struct itimer *it)
+{
+	int old;
+
+	do {
+		old = it->it_overrun;
+		if (old == INT_MAX) {
+			it->it_ksi.ksi_errno = ERANGE;
+			return;
+		}
+	} while (!atomic_cmpset_int((volatile u_int *)&it->it_overrun,
+	    old, old + 1));
+}
+
 void
 itimer_fire(struct itimer *it)
 {
@@ -1669,6 +1688,21 @@ itimer_fire(struct itimer *it)
 
 	if (it->it_sigev.sigev_notify == SIGEV_SIGNAL ||
 	    it->it_sigev.sigev_notify == SIGEV_THREAD_ID) {
+		/*
+		 * If the signal from a previous expiration is still
+		 * queued, this expiration can only bump the overrun
+		 * count, which needs no process lock.  A stale non-NULL
+		 * read of ksi_sigq merely coalesces an expiration that
+		 * raced with delivery into an overrun, which POSIX
+		 * permits for periodic timers; one-shot timers always
+		 * take the locked path so their single expiration
+		 * cannot be lost.
+		 */
+		if (KSI_ONQ(&it->it_ksi) &&
+		    timespecisset(&it->it_time.it_interval)) {
+			itimer_overrun(it);
+			return;
+		}
 		if (sigev_findtd(p, &it->it_sigev, &td) != 0) {
 			ITIMER_LOCK(it);
 			timespecclear(&it->it_time.it_value);
@@ -1681,12 +1715,8 @@ itimer_fire(struct itimer *it)
 			it->it_ksi.ksi_errno = 0;
 			ksiginfo_set_sigev(&it->it_ksi, &it->it_sigev);
 			tdsendsignal(p, td, it->it_ksi.ksi_signo, &it->it_ksi);
-		} else {
-			if (it->it_overrun < INT_MAX)
-				it->it_overrun++;
-			else
-				it->it_ksi.ksi_errno = ERANGE;
-		}
+		} else
+			itimer_overrun(it);
 		PROC_UNLOCK(p);
 	}
 }
@@ -52,6 +52,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/callout.h>
 #include <sys/domainset.h>
 #include <sys/file.h>
+#include <sys/counter.h>
 #include <sys/interrupt.h>
 #include <sys/kernel.h>
 #include <sys/ktr.h>
@@ -109,6 +110,16 @@ SYSCTL_INT(_debug, OID_AUTO, to_avg_mpcalls_dir, CTLFLAG_RD, &avg_mpcalls_dir,
     "Units = 1/1000");
 #endif
 
+#ifdef SMP
+static counter_u64_t xcpu_resched;
+SYSCTL_COUNTER_U64(_debug, OID_AUTO, to_xcpu_resched, CTLFLAG_RD,
+    &xcpu_resched, "Number of reschedules migrating a callout to another CPU");
+static counter_u64_t xdomain_resched;
+SYSCTL_COUNTER_U64(_debug, OID_AUTO, to_xdomain_resched, CTLFLAG_RD,
+    &xdomain_resched,
+    "Number of reschedules migrating a callout across NUMA domains");
+#endif
+
 static int ncallout;
 SYSCTL_INT(_kern, OID_AUTO, ncallout, CTLFLAG_RDTUN | CTLFLAG_NOFETCH, &ncallout, 0,
     "Number of entries in callwheel and size of timeout() preallocation");
@@ -310,6 +321,10 @@ callout_callwheel_init(void *dummy)
 		cc = CC_CPU(cpu);
 		callout_cpu_init(cc, cpu);
 	}
+#ifdef SMP
+	xcpu_resched = counter_u64_alloc(M_WAITOK);
+	xdomain_resched = counter_u64_alloc(M_WAITOK);
+#endif
 }
 SYSINIT(callwheel_init, SI_SUB_CPU, SI_ORDER_ANY, callout_callwheel_init, NULL);
 
@@ -1004,6 +1019,10 @@ callout_reset_sbt_on(struct callout *c, sbintime_t sbt, sbintime_t prec,
 	 * to a more appropriate moment.
 	 */
 	if (c->c_cpu != cpu) {
+		counter_u64_add(xcpu_resched, 1);
+		if (pcpu_find(c->c_cpu)->pc_domain !=
+		    pcpu_find(cpu)->pc_domain)
+			counter_u64_add(xdomain_resched, 1);
 		if (cc_exec_curr(cc, direct) == c) {
 			/* 
 			 * Pending will have been removed since we are
@@ -241,6 +241,11 @@ static int umtx_max_rb = 1000;
 SYSCTL_INT(_kern_ipc, OID_AUTO, umtx_max_robust, CTLFLAG_RWTUN,
     &umtx_max_rb, 0,
     "Maximum number of robust mutexes allowed for each thread");
+static int umtx_adaptive_spin = 0;
+SYSCTL_INT(_kern_ipc, OID_AUTO, umtx_adaptive_spin, CTLFLAG_RWTUN,
+    &umtx_adaptive_spin, 0,
+    "Number of spin iterations for a contested umutex whose owner is "
+    "running, before sleeping (0 disables)");
 
 static uma_zone_t		umtx_pi_zone;
 static struct umtxq_chain	umtxq_chains[2][UMTX_CHAINS];
@@ -720,6 +725,53 @@ umtxq_signal_queue(struct umtx_key *key, int n_wake, int q)
 	return (ret);
 }
 
+/*
+ * As umtxq_signal_queue(), but issue the wakeup calls with the chain
+ * lock dropped, in batches.  Waking a long queue of threads performs a
+ * scheduler operation per thread; doing that while holding the chain
+ * lock makes every other thread hashing to the chain wait for the whole
+ * convoy.  The woken threads cannot race us: wakeup() takes only the
+ * channel address, and a thread removed from the queue re-checks
+ * UQF_UMTXQ under the chain lock before returning from umtxq_sleep().
+ * Callers must not hold the chain lock; new waiters are excluded by
+ * busying the chain where the protocol requires it.
+ */
+#define	UMTX_WAKE_BATCH	64
+
+static int
+umtxq_signal_batched(struct umtx_key *key, int n_wake)
+{
+	struct umtx_q *batch[UMTX_WAKE_BATCH];
+	struct umtxq_queue *uh;
+	struct umtx_q *uq;
+	int cnt, i, ret;
+
+	ret = 0;
+	umtxq_lock(key);
+	for (;;) {
+		uh = umtxq_queue_lookup(key, UMTX_SHARED_QUEUE);
+		if (uh == NULL)
+			break;
+		cnt = 0;
+		while (cnt < UMTX_WAKE_BATCH && ret + cnt < n_wake &&
+		    (uq = TAILQ_FIRST(&uh->head)) != NULL) {
+			umtxq_remove_queue(uq, UMTX_SHARED_QUEUE);
+			batch[cnt++] = uq;
+		}
+		if (cnt == 0)
+			break;
+		ret += cnt;
+		umtxq_unlock(key);
+		for (i = 0; i < cnt; i++)
+			wakeup(batch[i]);
+		umtxq_lock(key);
+		if (ret >= n_wake)
+			break;
+	}
+	umtxq_unlock(key);
+	return (ret);
+}
+
 /*
  * Wake up specified thread.
  */
@@ -792,6 +844,26 @@ abs_timeout_gethz(struct abs_timeout *timo)
 	return (tstohz(&tts));
 }
 
+/*
+ * Check whether the thread owning a umutex is currently running.  The
+ * thread state is read without the thread lock; this is only a
+ * heuristic deciding whether spinning is worthwhile, as with the
+ * kernel's own adaptive mutexes.
+ */
+static bool
+umtx_owner_running(uint32_t owner)
+{
+	struct thread *otd;
+	bool running;
+
+	otd = tdfind(owner & ~UMUTEX_CONTESTED, curproc->p_pid);
+	if (otd == NULL)
+		return (false);
+	running = TD_IS_RUNNING(otd);
+	PROC_UNLOCK(otd->td_proc);
+	return (running);
+}
+
 static uint32_t
 umtx_unlock_val(uint32_t flags, bool rb)
 {
@@ -975,9 +1047,7 @@ kern_umtx_wake(struct thread *td, void *uaddr, int n_wake, int is_private)
 	if ((ret = umtx_key_get(uaddr, TYPE_SIMPLE_WAIT,
 	    is_private ? THREAD_SHARE : AUTO_SHARE, &key)) != 0)
 		return (ret);
-	umtxq_lock(&key);
-	umtxq_signal(&key, n_wake);
-	umtxq_unlock(&key);
+	umtxq_signal_batched(&key, n_wake);
 	umtx_key_release(&key);
 	return (0);
 }
@@ -992,7 +1062,7 @@ do_lock_normal(struct thread *td, struct umutex *m, uint32_t flags,
 	struct abs_timeout timo;
 	struct umtx_q *uq;
 	uint32_t owner, old, id;
-	int error, rv;
+	int error, rv, spins;
 
 	id = td->td_tid;
 	uq = td->td_umtxq;
@@ -1101,6 +1171,28 @@ do_lock_normal(struct thread *td, struct umutex *m, uint32_t flags,
 		if (error != 0)
 			return (error);
 
+		/*
+		 * Before paying for a sleep and two context switches,
+		 * briefly spin if the owner is running on another CPU, in
+		 * the manner of the kernel's adaptive mutexes.  The owning
+		 * thread can only be identified cheaply for process-private
+		 * mutexes.
+		 */
+		if (umtx_adaptive_spin > 0 && mp_ncpus > 1 &&
+		    (flags & USYNC_PROCESS_SHARED) == 0 &&
+		    umtx_owner_running(owner)) {
+			for (spins = umtx_adaptive_spin; spins > 0; spins--) {
+				cpu_spinwait();
+				rv = fueword32(&m->m_owner, &old);
+				if (rv == -1)
+					return (EFAULT);
+				if (old != owner)
+					break;
+			}
+			if (spins > 0)
+				continue;
+		}
+
 		if ((error = umtx_key_get(m, TYPE_NORMAL_UMUTEX,
 		    GET_SHARE(flags), &uq->uq_key)) != 0)
 			return (error);
@@ -2667,8 +2759,8 @@ do_cv_broadcast(struct thread *td, struct ucond *cv)
 
 	umtxq_lock(&key);
 	umtxq_busy(&key);
-	umtxq_signal(&key, INT_MAX);
 	umtxq_unlock(&key);
+	umtxq_signal_batched(&key, INT_MAX);
 
 	error = suword32(&cv->c_has_waiters, 0);
 	if (error == -1)
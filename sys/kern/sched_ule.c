@@ -249,6 +249,7 @@ struct tdq {
 	u_char		tdq_ridx;		/* Current removal index. */
 	int		tdq_id;			/* cpuid. */
 	struct runq	tdq_realtime;		/* real-time run queue. */
+	struct runq	tdq_lowlat;		/* low-latency run queue. */
 	struct runq	tdq_timeshare;		/* timeshare run queue. */
 	struct runq	tdq_idle;		/* Queue of IDLE threads. */
 	char		tdq_name[TDQ_NAME_LEN];
@@ -275,6 +276,7 @@ static int balance_interval = 128;	/* Default set in sched_initticks(). */
 static int __read_mostly affinity;
 static int __read_mostly steal_idle = 1;
 static int __read_mostly steal_thresh = 2;
+static int __read_mostly steal_batch = 4;
 static int __read_mostly always_steal = 0;
 static int __read_mostly trysteal_limit = 2;
 
@@ -286,6 +288,16 @@ static int balance_ticks;
 DPCPU_DEFINE_STATIC(struct tdq, tdq);
 DPCPU_DEFINE_STATIC(uint32_t, randomval);
 
+/*
+ * Per-CPU steal order: every other CPU sorted by increasing topological
+ * distance, tagged with the topology level ("tier") that first contains
+ * it, so that the idle steal loop need not walk the cpu_group tree on
+ * every idle transition.  Computed once from the topology at boot.
+ */
+DPCPU_DEFINE_STATIC(u_short, steal_order[MAXCPU]);
+DPCPU_DEFINE_STATIC(u_char, steal_tier[MAXCPU]);
+DPCPU_DEFINE_STATIC(int, steal_ncpus);
+
 #define	TDQ_SELF()	((struct tdq *)PCPU_GET(sched))
 #define	TDQ_CPU(x)	(DPCPU_ID_PTR((x), tdq))
 #define	TDQ_ID(x)	((x)->tdq_id)
@@ -412,6 +424,8 @@ tdq_print(int cpu)
 	printf("\tlowest priority:   %d\n", tdq->tdq_lowpri);
 	printf("\trealtime runq:\n");
 	runq_print(&tdq->tdq_realtime);
+	printf("\tlow-latency runq:\n");
+	runq_print(&tdq->tdq_lowlat);
 	printf("\ttimeshare runq:\n");
 	runq_print(&tdq->tdq_timeshare);
 	printf("\tidle runq:\n");
@@ -472,7 +486,16 @@ tdq_runq_add(struct tdq *tdq, struct thread *td, int flags)
 		tdq->tdq_transferable++;
 		ts->ts_flags |= TSF_XFERABLE;
 	}
-	if (pri < PRI_MIN_BATCH) {
+	if (PRI_BASE(td->td_pri_class) == PRI_LOWLAT &&
+	    pri >= PRI_MIN_TIMESHARE) {
+		/*
+		 * Low-latency threads keep their own queue so that their
+		 * dispatch latency is bounded by the realtime and
+		 * interactive load only, never by the timeshare calendar.
+		 * Borrowed kernel priorities still use the realtime queue.
+		 */
+		ts->ts_runq = &tdq->tdq_lowlat;
+	} else if (pri < PRI_MIN_BATCH) {
 		ts->ts_runq = &tdq->tdq_realtime;
 	} else if (pri <= PRI_MAX_BATCH) {
 		ts->ts_runq = &tdq->tdq_timeshare;
@@ -983,54 +1006,63 @@ tdq_move(struct tdq *from, struct tdq *to)
 static int
 tdq_idled(struct tdq *tdq)
 {
-	struct cpu_group *cg;
 	struct tdq *steal;
 	cpuset_t mask;
-	int cpu, switchcnt;
+	u_short *order;
+	u_char *stier;
+	int bestcpu, bestload, cpu, i, limit, moved, nsteal;
+	int switchcnt, tier;
 
 	if (smp_started == 0 || steal_idle == 0 || tdq->tdq_cg == NULL)
 		return (1);
+	order = DPCPU_ID_PTR(TDQ_ID(tdq), steal_order[0]);
+	stier = DPCPU_ID_PTR(TDQ_ID(tdq), steal_tier[0]);
+	nsteal = DPCPU_ID_GET(TDQ_ID(tdq), steal_ncpus);
 	CPU_FILL(&mask);
 	CPU_CLR(PCPU_GET(cpuid), &mask);
     restart:
 	switchcnt = tdq->tdq_switchcnt + tdq->tdq_oldswitchcnt;
-	for (cg = tdq->tdq_cg; ; ) {
-		cpu = sched_highest(cg, mask, steal_thresh);
+	for (i = 0; i < nsteal; ) {
+		/*
+		 * Scan one tier of the cached steal order and choose the
+		 * most loaded eligible CPU in it, nearest tiers first.
+		 */
+		tier = stier[i];
+		bestcpu = -1;
+		bestload = steal_thresh - 1;
+		for (; i < nsteal && stier[i] == tier; i++) {
+			cpu = order[i];
+			if (!CPU_ISSET(cpu, &mask))
+				continue;
+			steal = TDQ_CPU(cpu);
+			if (steal->tdq_transferable == 0)
+				continue;
+			if (steal->tdq_load > bestload) {
+				bestload = steal->tdq_load;
+				bestcpu = cpu;
+			}
+		}
 		/*
 		 * We were assigned a thread but not preempted.  Returning
 		 * 0 here will cause our caller to switch to it.
 		 */
 		if (tdq->tdq_load)
 			return (0);
-		if (cpu == -1) {
-			cg = cg->cg_parent;
-			if (cg == NULL)
-				return (1);
+		if (bestcpu == -1)
 			continue;
-		}
+		cpu = bestcpu;
 		steal = TDQ_CPU(cpu);
-		/*
-		 * The data returned by sched_highest() is stale and
-		 * the chosen CPU no longer has an eligible thread.
-		 *
-		 * Testing this ahead of tdq_lock_pair() only catches
-		 * this situation about 20% of the time on an 8 core
-		 * 16 thread Ryzen 7, but it still helps performance.
-		 */
-		if (steal->tdq_load < steal_thresh ||
-		    steal->tdq_transferable == 0)
-			goto restart;
 		tdq_lock_pair(tdq, steal);
 		/*
 		 * We were assigned a thread while waiting for the locks.
 		 * Switch to it now instead of stealing a thread.
 		 */
 		if (tdq->tdq_load)
-			break;
+			goto out;
 		/*
-		 * The data returned by sched_highest() is stale and
-		 * the chosen CPU no longer has an eligible thread, or
-		 * we were preempted and the CPU loading info may be out
+		 * The load observed during the scan is stale and the
+		 * chosen CPU no longer has an eligible thread, or we
+		 * were preempted and the CPU loading info may be out
 		 * of date.  The latter is rare.  In either case restart
 		 * the search.
 		 */
@@ -1041,10 +1073,22 @@ tdq_idled(struct tdq *tdq)
 			goto restart;
 		}
 		/*
-		 * Steal the thread and switch to it.
+		 * Steal threads proportional to the load imbalance, up
+		 * to steal_batch, so that a deep queue refills an idle
+		 * CPU in a single locked transaction instead of one
+		 * steal per idle transition.
 		 */
-		if (tdq_move(steal, tdq) != NULL)
-			break;
+		limit = imin(steal_batch,
+		    (steal->tdq_load - tdq->tdq_load + 1) / 2);
+		if (limit < 1)
+			limit = 1;
+		moved = 0;
+		while (tdq_move(steal, tdq) != NULL) {
+			if (++moved >= limit || steal->tdq_transferable == 0)
+				break;
+		}
+		if (moved != 0)
+			goto out;
 		/*
 		 * We failed to acquire a thread even though it looked
 		 * like one was available.  This could be due to affinity
@@ -1055,7 +1099,10 @@ tdq_idled(struct tdq *tdq)
 		 */
 		CPU_CLR(cpu, &mask);
 		tdq_unlock_pair(tdq, steal);
+		goto restart;
 	}
+	return (1);
+out:
 	TDQ_UNLOCK(steal);
 	mi_switch(SW_VOL | SWT_IDLE);
 	return (0);
@@ -1188,6 +1235,8 @@ tdq_steal(struct tdq *tdq, int cpu)
 	TDQ_LOCK_ASSERT(tdq, MA_OWNED);
 	if ((td = runq_steal(&tdq->tdq_realtime, cpu)) != NULL)
 		return (td);
+	if ((td = runq_steal(&tdq->tdq_lowlat, cpu)) != NULL)
+		return (td);
 	if ((td = runq_steal_from(&tdq->tdq_timeshare,
 	    cpu, tdq->tdq_ridx)) != NULL)
 		return (td);
@@ -1382,6 +1431,13 @@ tdq_choose(struct tdq *tdq)
 	td = runq_choose(&tdq->tdq_realtime);
 	if (td != NULL)
 		return (td);
+	td = runq_choose(&tdq->tdq_lowlat);
+	if (td != NULL) {
+		KASSERT(td->td_priority >= PRI_MIN_TIMESHARE,
+		    ("tdq_choose: Invalid priority on low-latency queue %d",
+		    td->td_priority));
+		return (td);
+	}
 	td = runq_choose_from(&tdq->tdq_timeshare, tdq->tdq_ridx);
 	if (td != NULL) {
 		KASSERT(td->td_priority >= PRI_MIN_BATCH,
@@ -1410,6 +1466,7 @@ tdq_setup(struct tdq *tdq, int id)
 	if (bootverbose)
 		printf("ULE: setup cpu %d\n", id);
 	runq_init(&tdq->tdq_realtime);
+	runq_init(&tdq->tdq_lowlat);
 	runq_init(&tdq->tdq_timeshare);
 	runq_init(&tdq->tdq_idle);
 	tdq->tdq_id = id;
@@ -1423,6 +1480,41 @@ tdq_setup(struct tdq *tdq, int id)
 }
 
 #ifdef SMP
+/*
+ * Build the per-CPU steal order vectors from the cpu_group topology.
+ */
+static void
+sched_steal_order_setup(void)
+{
+	struct cpu_group *cg;
+	cpuset_t seen;
+	u_short *order;
+	u_char *stier;
+	int cpu, i, n, tier;
+
+	CPU_FOREACH(cpu) {
+		order = DPCPU_ID_PTR(cpu, steal_order[0]);
+		stier = DPCPU_ID_PTR(cpu, steal_tier[0]);
+		CPU_ZERO(&seen);
+		CPU_SET(cpu, &seen);
+		n = 0;
+		tier = 0;
+		for (cg = TDQ_CPU(cpu)->tdq_cg; cg != NULL;
+		    cg = cg->cg_parent, tier++) {
+			CPU_FOREACH(i) {
+				if (!CPU_ISSET(i, &cg->cg_mask) ||
+				    CPU_ISSET(i, &seen))
+					continue;
+				order[n] = i;
+				stier[n] = tier;
+				n++;
+				CPU_SET(i, &seen);
+			}
+		}
+		DPCPU_ID_SET(cpu, steal_ncpus, n);
+	}
+}
+
 static void
 sched_setup_smp(void)
 {
@@ -1437,6 +1529,7 @@ sched_setup_smp(void)
 		if (tdq->tdq_cg == NULL)
 			panic("Can't find cpu group for %d\n", i);
 	}
+	sched_steal_order_setup();
 	PCPU_SET(sched, DPCPU_PTR(tdq));
 	balance_tdq = TDQ_SELF();
 }
@@ -3117,6 +3210,8 @@ SYSCTL_INT(_kern_sched, OID_AUTO, steal_idle, CTLFLAG_RW, &steal_idle, 0,
     "Attempts to steal work from other cores before idling");
 SYSCTL_INT(_kern_sched, OID_AUTO, steal_thresh, CTLFLAG_RW, &steal_thresh, 0,
     "Minimum load on remote CPU before we'll steal");
+SYSCTL_INT(_kern_sched, OID_AUTO, steal_batch, CTLFLAG_RW, &steal_batch, 0,
+    "Maximum number of threads to steal per idle steal");
 SYSCTL_INT(_kern_sched, OID_AUTO, trysteal_limit, CTLFLAG_RW, &trysteal_limit,
     0, "Topological distance limit for stealing threads in sched_switch()");
 SYSCTL_INT(_kern_sched, OID_AUTO, always_steal, CTLFLAG_RW, &always_steal, 0,
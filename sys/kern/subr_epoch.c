@@ -89,6 +89,9 @@ struct epoch {
 #define MAX_ADAPTIVE_SPIN 100
 #define MAX_EPOCHS 64
 
+/* Deferred callbacks are sorted and run in batches of this size. */
+#define EPOCH_CB_BATCH 64
+
 CTASSERT(sizeof(ck_epoch_entry_t) == sizeof(struct epoch_context));
 SYSCTL_NODE(_kern, OID_AUTO, epoch, CTLFLAG_RW | CTLFLAG_MPSAFE, 0,
     "epoch information");
@@ -121,6 +124,11 @@ static counter_u64_t epoch_call_task_count;
 SYSCTL_COUNTER_U64(_kern_epoch_stats, OID_AUTO, epoch_call_tasks, CTLFLAG_RW,
     &epoch_call_task_count, "# of times a callback task was run");
 
+static int __read_mostly epoch_reclaim_budget = 1024;
+SYSCTL_INT(_kern_epoch, OID_AUTO, reclaim_budget, CTLFLAG_RWTUN,
+    &epoch_reclaim_budget, 0,
+    "Maximum deferred callbacks run per callback task invocation");
+
 TAILQ_HEAD (threadlist, thread);
 
 CK_STACK_CONTAINER(struct ck_epoch_entry, stack_entry,
@@ -130,6 +138,26 @@ static struct epoch epoch_array[MAX_EPOCHS];
 
 DPCPU_DEFINE(struct grouptask, epoch_cb_task);
 DPCPU_DEFINE(int, epoch_cb_count);
+DPCPU_DEFINE_STATIC(ck_stack_t, epoch_cb_backlog);
+
+static int
+sysctl_epoch_cb_pending(SYSCTL_HANDLER_ARGS)
+{
+	int count, cpu, error;
+
+	error = 0;
+	CPU_FOREACH(cpu) {
+		count = DPCPU_ID_GET(cpu, epoch_cb_count);
+		error = SYSCTL_OUT(req, &count, sizeof(count));
+		if (error != 0)
+			break;
+	}
+	return (error);
+}
+SYSCTL_PROC(_kern_epoch_stats, OID_AUTO, pending_cbs,
+    CTLTYPE_OPAQUE | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 0,
+    sysctl_epoch_cb_pending, "I",
+    "Per-CPU count of deferred callbacks awaiting reclamation");
 
 static __read_mostly int inited;
 __read_mostly epoch_t global_epoch;
@@ -274,6 +302,7 @@ epoch_init(void *arg __unused)
 	    sizeof(struct epoch_record), NULL, NULL, NULL, NULL,
 	    UMA_ALIGN_PTR, UMA_ZONE_PCPU);
 	CPU_FOREACH(cpu) {
+		ck_stack_init(DPCPU_ID_PTR(cpu, epoch_cb_backlog));
 		GROUPTASK_INIT(DPCPU_ID_PTR(cpu, epoch_cb_task), 0,
 		    epoch_call_task, NULL);
 		taskqgroup_attach_cpu(qgroup_softirq,
@@ -738,16 +767,19 @@ boottime:
 static void
 epoch_call_task(void *arg __unused)
 {
-	ck_stack_entry_t *cursor, *head, *next;
+	struct ck_epoch_entry *batch[EPOCH_CB_BATCH], *entry;
+	ck_stack_entry_t *cursor;
 	ck_epoch_record_t *record;
 	epoch_record_t er;
 	epoch_t epoch;
 	ck_stack_t cb_stack;
-	int i, npending, total;
+	ck_stack_t *backlog;
+	int budget, i, j, n, npending, total;
 
 	ck_stack_init(&cb_stack);
 	critical_enter();
 	epoch_enter(global_epoch);
+	backlog = DPCPU_PTR(epoch_cb_backlog);
 	for (total = i = 0; i != MAX_EPOCHS; i++) {
 		epoch = epoch_array + i;
 		if (__predict_false(
@@ -761,20 +793,55 @@ epoch_call_task(void *arg __unused)
 		total += npending - record->n_pending;
 	}
 	epoch_exit(global_epoch);
-	*DPCPU_PTR(epoch_cb_count) -= total;
 	critical_exit();
 
 	counter_u64_add(epoch_call_count, total);
 	counter_u64_add(epoch_call_task_count, 1);
 
-	head = ck_stack_batch_pop_npsc(&cb_stack);
-	for (cursor = head; cursor != NULL; cursor = next) {
-		struct ck_epoch_entry *entry =
-		    ck_epoch_entry_container(cursor);
+	/*
+	 * Append the freshly polled callbacks to whatever a previous
+	 * budget-limited run left behind.  The callback task is bound to
+	 * this CPU, so the backlog stack has a single producer and a
+	 * single consumer and needs no further synchronization.
+	 */
+	while ((cursor = ck_stack_pop_npsc(&cb_stack)) != NULL)
+		ck_stack_push_spnc(backlog, cursor);
 
-		next = CK_STACK_NEXT(cursor);
-		entry->function(entry);
-	}
+	budget = epoch_reclaim_budget;
+	do {
+		/*
+		 * Drain in cache-sized batches, sorted by callback
+		 * function, so that runs of identical destructors execute
+		 * back to back with a warm instruction cache.
+		 */
+		for (n = 0; n < EPOCH_CB_BATCH; n++) {
+			cursor = ck_stack_pop_npsc(backlog);
+			if (cursor == NULL)
+				break;
+			batch[n] = ck_epoch_entry_container(cursor);
+		}
+		for (i = 1; i < n; i++) {
+			entry = batch[i];
+			for (j = i - 1; j >= 0 &&
+			    (uintptr_t)batch[j]->function >
+			    (uintptr_t)entry->function; j--)
+				batch[j + 1] = batch[j];
+			batch[j + 1] = entry;
+		}
+		for (i = 0; i < n; i++)
+			batch[i]->function(batch[i]);
+		critical_enter();
+		*DPCPU_PTR(epoch_cb_count) -= n;
+		critical_exit();
+		budget -= n;
+	} while (n == EPOCH_CB_BATCH && budget > 0);
+
+	/*
+	 * Hand the CPU back rather than running a large backlog to
+	 * completion; the remainder is picked up by the rescheduled task.
+	 */
+	if (!CK_STACK_ISEMPTY(backlog))
+		GROUPTASK_ENQUEUE(DPCPU_PTR(epoch_cb_task));
 }
 
 int
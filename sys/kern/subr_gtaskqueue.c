@@ -44,6 +44,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/epoch.h>
 #include <sys/sched.h>
 #include <sys/smp.h>
+#include <sys/sysctl.h>
 #include <sys/gtaskqueue.h>
 #include <sys/unistd.h>
 #include <machine/stdarg.h>
@@ -53,6 +54,17 @@ static void	gtaskqueue_thread_enqueue(void *);
 static void	gtaskqueue_thread_loop(void *arg);
 static int	task_is_running(struct gtaskqueue *queue, struct gtask *gtask);
 static void	gtaskqueue_drain_locked(struct gtaskqueue *queue, struct gtask *gtask);
+static bool	gtaskqueue_steal(struct gtaskqueue *queue);
+
+/*
+ * An idle grouptask queue thread may steal a single task from a sibling
+ * queue in its group whose backlog exceeds this depth.  Zero disables
+ * stealing and preserves strict per-CPU affinity.
+ */
+static int	gtaskqueue_steal_thresh = 0;
+SYSCTL_INT(_kern, OID_AUTO, gtaskqueue_steal_thresh, CTLFLAG_RWTUN,
+    &gtaskqueue_steal_thresh, 0,
+    "Steal group tasks from sibling queues deeper than this (0 disables)");
 
 TASKQGROUP_DEFINE(softirq, mp_ncpus, 1);
 
@@ -64,10 +76,15 @@ struct gtaskqueue_busy {
 
 typedef void (*gtaskqueue_enqueue_fn)(void *context);
 
+struct taskqgroup;
+
 struct gtaskqueue {
 	STAILQ_HEAD(, gtask)	tq_queue;
 	LIST_HEAD(, gtaskqueue_busy) tq_active;
 	u_int			tq_seq;
+	int			tq_qlen;
+	struct taskqgroup	*tq_group;
+	int			tq_qidx;
 	int			tq_callouts;
 	struct mtx_padalign	tq_mutex;
 	gtaskqueue_enqueue_fn	tq_enqueue;
@@ -242,6 +259,7 @@ grouptaskqueue_enqueue(struct gtaskqueue *queue, struct gtask *gtask)
 	}
 	STAILQ_INSERT_TAIL(&queue->tq_queue, gtask, ta_link);
 	gtask->ta_flags |= TASK_ENQUEUED;
+	queue->tq_qlen++;
 	TQ_UNLOCK(queue);
 	if ((queue->tq_flags & TQ_FLAGS_BLOCKED) == 0)
 		queue->tq_enqueue(queue->tq_context);
@@ -277,6 +295,7 @@ gtaskqueue_drain_tq_queue(struct gtaskqueue *queue)
 	GTASK_INIT(&t_barrier, 0, USHRT_MAX, gtaskqueue_task_nop_fn, &t_barrier);
 	STAILQ_INSERT_TAIL(&queue->tq_queue, &t_barrier, ta_link);
 	t_barrier.ta_flags |= TASK_ENQUEUED;
+	queue->tq_qlen++;
 
 	/*
 	 * Once the barrier has executed, all previously queued tasks
@@ -307,7 +326,7 @@ gtaskqueue_drain_tq_active(struct gtaskqueue *queue)
 	seq = queue->tq_seq;
 restart:
 	LIST_FOREACH(tb, &queue->tq_active, tb_link) {
-		if ((int)(tb->tb_seq - seq) <= 0) {
+		if (tb->tb_running != NULL && (int)(tb->tb_seq - seq) <= 0) {
 			TQ_SLEEP(queue, tb->tb_running, "gtq_adrain");
 			goto restart;
 		}
@@ -354,7 +373,16 @@ gtaskqueue_run_locked(struct gtaskqueue *queue)
 	in_net_epoch = false;
 
 	while ((gtask = STAILQ_FIRST(&queue->tq_queue)) != NULL) {
+		/*
+		 * A task stolen by a sibling queue may be re-enqueued here
+		 * before the thief has finished running it.  Defer it; the
+		 * thief wakes this queue up once it completes.
+		 */
+		if (__predict_false(gtaskqueue_steal_thresh > 0) &&
+		    task_is_running(queue, gtask))
+			break;
 		STAILQ_REMOVE_HEAD(&queue->tq_queue, ta_link);
+		queue->tq_qlen--;
 		gtask->ta_flags &= ~TASK_ENQUEUED;
 		tb.tb_running = gtask;
 		tb.tb_seq = ++queue->tq_seq;
@@ -372,6 +400,7 @@ gtaskqueue_run_locked(struct gtaskqueue *queue)
 
 		TQ_LOCK(queue);
 		wakeup(gtask);
+		tb.tb_running = NULL;
 	}
 	if (in_net_epoch)
 		NET_EPOCH_EXIT(et);
@@ -395,8 +424,10 @@ static int
 gtaskqueue_cancel_locked(struct gtaskqueue *queue, struct gtask *gtask)
 {
 
-	if (gtask->ta_flags & TASK_ENQUEUED)
+	if (gtask->ta_flags & TASK_ENQUEUED) {
 		STAILQ_REMOVE(&queue->tq_queue, gtask, gtask, ta_link);
+		queue->tq_qlen--;
+	}
 	gtask->ta_flags &= ~TASK_ENQUEUED;
 	return (task_is_running(queue, gtask) ? EBUSY : 0);
 }
@@ -537,6 +568,7 @@ static void
 gtaskqueue_thread_loop(void *arg)
 {
 	struct gtaskqueue **tqp, *tq;
+	bool stolen;
 
 	tqp = arg;
 	tq = *tqp;
@@ -552,6 +584,14 @@ gtaskqueue_thread_loop(void *arg)
 		 */
 		if ((tq->tq_flags & TQ_FLAGS_ACTIVE) == 0)
 			break;
+		if (__predict_false(gtaskqueue_steal_thresh > 0) &&
+		    tq->tq_group != NULL && STAILQ_EMPTY(&tq->tq_queue)) {
+			TQ_UNLOCK(tq);
+			stolen = gtaskqueue_steal(tq);
+			TQ_LOCK(tq);
+			if (stolen || !STAILQ_EMPTY(&tq->tq_queue))
+				continue;
+		}
 		TQ_SLEEP(tq, tq, "-");
 	}
 	gtaskqueue_run_locked(tq);
@@ -619,9 +659,92 @@ taskqgroup_cpu_create(struct taskqgroup *qgroup, int idx, int cpu)
 	    taskqueue_thread_enqueue, &qcpu->tgc_taskq);
 	gtaskqueue_start_threads(&qcpu->tgc_taskq, 1, PI_SOFT,
 	    "%s_%d", qgroup->tqg_name, idx);
+	qcpu->tgc_taskq->tq_group = qgroup;
+	qcpu->tgc_taskq->tq_qidx = idx;
 	qcpu->tgc_cpu = cpu;
 }
 
+/*
+ * Attempt to steal and run one task from a sibling queue in the same
+ * group whose backlog exceeds gtaskqueue_steal_thresh.  The stolen task
+ * is run with a busy entry registered in the victim queue's tq_active so
+ * that cancel, drain and block on the victim observe it as running;
+ * gtaskqueue_run_locked() defers a task that is re-enqueued while a
+ * thief still runs it, so a task never executes on two CPUs at once.
+ * Drain barriers and blocked tasks are never stolen.  Returns true if a
+ * task was run.
+ */
+static bool
+gtaskqueue_steal(struct gtaskqueue *queue)
+{
+	struct epoch_tracker et;
+	struct gtaskqueue_busy tb;
+	struct gtaskqueue *victim;
+	struct taskqgroup *qgroup;
+	struct gtask *gtask;
+	int cnt, i, idx;
+
+	TQ_ASSERT_UNLOCKED(queue);
+	qgroup = queue->tq_group;
+	/*
+	 * tqg_cnt is read unlocked; it only grows, and queues already
+	 * created are stable, so a stale value merely narrows the scan.
+	 */
+	cnt = qgroup->tqg_cnt;
+	for (i = 1; i < cnt; i++) {
+		idx = (queue->tq_qidx + i) % cnt;
+		victim = qgroup->tqg_queue[idx].tgc_taskq;
+		if (victim == NULL || victim == queue)
+			continue;
+		if (victim->tq_qlen < gtaskqueue_steal_thresh)
+			continue;
+		TQ_LOCK(victim);
+		if ((victim->tq_flags & TQ_FLAGS_BLOCKED) != 0 ||
+		    victim->tq_qlen < gtaskqueue_steal_thresh) {
+			TQ_UNLOCK(victim);
+			continue;
+		}
+		STAILQ_FOREACH(gtask, &victim->tq_queue, ta_link) {
+			if (gtask->ta_func != gtaskqueue_task_nop_fn &&
+			    (gtask->ta_flags & TASK_NOENQUEUE) == 0 &&
+			    !task_is_running(victim, gtask))
+				break;
+		}
+		if (gtask == NULL) {
+			TQ_UNLOCK(victim);
+			continue;
+		}
+		STAILQ_REMOVE(&victim->tq_queue, gtask, gtask, ta_link);
+		victim->tq_qlen--;
+		gtask->ta_flags &= ~TASK_ENQUEUED;
+		tb.tb_running = gtask;
+		tb.tb_seq = ++victim->tq_seq;
+		LIST_INSERT_HEAD(&victim->tq_active, &tb, tb_link);
+		TQ_UNLOCK(victim);
+
+		KASSERT(gtask->ta_func != NULL, ("task->ta_func is NULL"));
+		if (TASK_IS_NET(gtask)) {
+			NET_EPOCH_ENTER(et);
+			gtask->ta_func(gtask->ta_context);
+			NET_EPOCH_EXIT(et);
+		} else
+			gtask->ta_func(gtask->ta_context);
+
+		TQ_LOCK(victim);
+		LIST_REMOVE(&tb, tb_link);
+		wakeup(gtask);
+		/*
+		 * The victim thread may have deferred a re-enqueue of the
+		 * stolen task while we ran it; make sure it is picked up.
+		 */
+		if (!STAILQ_EMPTY(&victim->tq_queue))
+			wakeup_any(victim);
+		TQ_UNLOCK(victim);
+		return (true);
+	}
+	return (false);
+}
+
 /*
  * Find the taskq with least # of tasks that doesn't currently have any
  * other queues from the uniq identifier.
@@ -121,20 +121,63 @@ static u_int __read_mostly restrict_starvation = 0;
 SYSCTL_INT(_debug_lock_delay, OID_AUTO, restrict_starvation, CTLFLAG_RW,
     &restrict_starvation, 0, "");
 
+/*
+ * Threads spinning on a contended lock register themselves in a small
+ * hashed table so that lock_delay() can back off proportionally to the
+ * number of waiters instead of every spinner polling the lock cache
+ * line at the same rate.  Unrelated locks may collide in a bucket; that
+ * only overestimates the waiter count, which errs towards longer
+ * backoff.
+ */
+#define	LD_SPINNER_TABLESIZE	128
+#define	LD_SPINNER_HASH(l)						\
+	((((uintptr_t)(l)) >> 6) & (LD_SPINNER_TABLESIZE - 1))
+
+static struct ld_spinner {
+	volatile u_int	lds_count;
+} __aligned(CACHE_LINE_SIZE) ld_spinners[LD_SPINNER_TABLESIZE];
+
+u_int
+lock_delay_spinner_enter(const void *lock)
+{
+	struct ld_spinner *lds;
+
+	lds = &ld_spinners[LD_SPINNER_HASH(lock)];
+	return (atomic_fetchadd_int(&lds->lds_count, 1) + 1);
+}
+
+void
+lock_delay_spinner_exit(const void *lock)
+{
+	struct ld_spinner *lds;
+
+	lds = &ld_spinners[LD_SPINNER_HASH(lock)];
+	atomic_subtract_int(&lds->lds_count, 1);
+}
+
 void
 lock_delay(struct lock_delay_arg *la)
 {
 	struct lock_delay_config *lc = la->config;
-	u_short i;
+	u_int delay, i;
 
 	la->delay <<= 1;
 	if (__predict_false(la->delay > lc->max))
 		la->delay = lc->max;
 
-	for (i = la->delay; i > 0; i--)
+	/*
+	 * Scale the backoff by the number of observed waiters so that
+	 * the aggregate polling rate on the lock cache line stays
+	 * roughly constant as contention grows.
+	 */
+	delay = (u_int)la->delay * la->waiters;
+	if (__predict_false(delay > lc->max))
+		delay = lc->max;
+
+	for (i = delay; i > 0; i--)
 		cpu_spinwait();
 
-	la->spin_cnt += la->delay;
+	la->spin_cnt += delay;
 	if (__predict_false(la->spin_cnt > starvation_limit)) {
 		SDT_PROBE1(lock, , , starvation, la->delay);
 		if (restrict_starvation)
@@ -224,6 +267,13 @@ struct lock_profile_object {
 	u_int		lpo_contest_locking;
 };
 
+/*
+ * Log2 histogram of per-acquisition hold times.  Bucket 0 counts
+ * acquisitions held for less than a microsecond, bucket i those held
+ * for [2^(i-1), 2^i) microseconds and the final bucket any longer.
+ */
+#define	LPROF_HIST_BUCKETS	16
+
 /*
  * One lock_prof for each (file, line, lock object) triple.
  */
@@ -240,6 +290,7 @@ struct lock_prof {
 	uintmax_t	cnt_wait;
 	uintmax_t	cnt_cur;
 	uintmax_t	cnt_contest_locking;
+	uintmax_t	cnt_hist[LPROF_HIST_BUCKETS];
 };
 
 SLIST_HEAD(lphead, lock_prof);
@@ -382,11 +433,20 @@ lock_prof_reset(void)
 }
 
 static void
-lock_prof_output(struct lock_prof *lp, struct sbuf *sb)
+lock_prof_output(struct lock_prof *lp, struct sbuf *sb, int hist)
 {
 	const char *p;
+	int i;
 
 	for (p = lp->file; p != NULL && strncmp(p, "../", 3) == 0; p += 3);
+	if (hist) {
+		sbuf_printf(sb, "%s:%d (%s:%s)", p, lp->line,
+		    lp->class->lc_name, lp->name);
+		for (i = 0; i < LPROF_HIST_BUCKETS; i++)
+			sbuf_printf(sb, " %ju", lp->cnt_hist[i]);
+		sbuf_printf(sb, "\n");
+		return;
+	}
 	sbuf_printf(sb,
 	    "%8ju %9ju %11ju %11ju %11ju %6ju %6ju %2ju %6ju %s:%d (%s:%s)\n",
 	    lp->cnt_max / 1000, lp->cnt_wait_max / 1000, lp->cnt_tot / 1000,
@@ -407,6 +467,8 @@ lock_prof_sum(struct lock_prof *match, struct lock_prof *dst, int hash,
 	struct lock_prof *l;
 	int cpu;
 
+	int i;
+
 	dst->file = match->file;
 	dst->line = match->line;
 	dst->class = match->class;
@@ -429,13 +491,15 @@ lock_prof_sum(struct lock_prof *match, struct lock_prof *dst, int hash,
 			dst->cnt_wait += l->cnt_wait;
 			dst->cnt_cur += l->cnt_cur;
 			dst->cnt_contest_locking += l->cnt_contest_locking;
+			for (i = 0; i < LPROF_HIST_BUCKETS; i++)
+				dst->cnt_hist[i] += l->cnt_hist[i];
 		}
 	}
 }
 
 static void
 lock_prof_type_stats(struct lock_prof_type *type, struct sbuf *sb, int spin,
-    int t)
+    int t, int hist)
 {
 	struct lock_prof *l;
 	int i;
@@ -447,7 +511,7 @@ lock_prof_type_stats(struct lock_prof_type *type, struct sbuf *sb, int spin,
 			if (l->ticks == t)
 				continue;
 			lock_prof_sum(l, &lp, i, spin, t);
-			lock_prof_output(&lp, sb);
+			lock_prof_output(&lp, sb, hist);
 		}
 	}
 }
@@ -463,8 +527,12 @@ dump_lock_prof_stats(SYSCTL_HANDLER_ARGS)
 	if (error != 0)
 		return (error);
 	sb = sbuf_new_for_sysctl(NULL, NULL, LPROF_SBUF_SIZE, req);
-	sbuf_printf(sb, "\n%8s %9s %11s %11s %11s %6s %6s %2s %6s %s\n",
-	    "max", "wait_max", "total", "wait_total", "count", "avg", "wait_avg", "cnt_hold", "cnt_lock", "name");
+	if (arg2 != 0)
+		sbuf_printf(sb, "\nPer-site hold time histogram; "
+		    "power-of-two microsecond buckets, <1us first\n");
+	else
+		sbuf_printf(sb, "\n%8s %9s %11s %11s %11s %6s %6s %2s %6s %s\n",
+		    "max", "wait_max", "total", "wait_total", "count", "avg", "wait_avg", "cnt_hold", "cnt_lock", "name");
 	enabled = lock_prof_enable;
 	lock_prof_enable = 0;
 	/*
@@ -474,8 +542,10 @@ dump_lock_prof_stats(SYSCTL_HANDLER_ARGS)
 	quiesce_all_critical();
 	t = ticks;
 	CPU_FOREACH(cpu) {
-		lock_prof_type_stats(&LP_CPU(cpu)->lpc_types[0], sb, 0, t);
-		lock_prof_type_stats(&LP_CPU(cpu)->lpc_types[1], sb, 1, t);
+		lock_prof_type_stats(&LP_CPU(cpu)->lpc_types[0], sb, 0, t,
+		    arg2);
+		lock_prof_type_stats(&LP_CPU(cpu)->lpc_types[1], sb, 1, t,
+		    arg2);
 	}
 	atomic_thread_fence_rel();
 	lock_prof_enable = enabled;
@@ -669,7 +739,7 @@ lock_profile_release_lock(struct lock_object *lo)
 	struct lock_prof *lp;
 	uint64_t curtime, holdtime;
 	struct lpohead *head;
-	int spin;
+	int hbucket, spin;
 
 	if (SCHEDULER_STOPPED())
 		return;
@@ -714,6 +784,10 @@ lock_profile_release_lock(struct lock_object *lo)
 	lp->cnt_wait += l->lpo_waittime;
 	lp->cnt_contest_locking += l->lpo_contest_locking;
 	lp->cnt_cur += l->lpo_cnt;
+	hbucket = flsll(holdtime / 1000);
+	if (hbucket >= LPROF_HIST_BUCKETS)
+		hbucket = LPROF_HIST_BUCKETS - 1;
+	lp->cnt_hist[hbucket]++;
 release:
 	LIST_REMOVE(l, lpo_link);
 	type = &LP_CPU_SELF->lpc_types[spin];
@@ -739,6 +813,10 @@ SYSCTL_PROC(_debug_lock_prof, OID_AUTO, stats,
     CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 0,
     dump_lock_prof_stats, "A",
     "Lock profiling statistics");
+SYSCTL_PROC(_debug_lock_prof, OID_AUTO, hist,
+    CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 1,
+    dump_lock_prof_stats, "A",
+    "Lock profiling hold time histograms");
 SYSCTL_PROC(_debug_lock_prof, OID_AUTO, reset,
     CTLTYPE_INT | CTLFLAG_RW | CTLFLAG_NEEDGIANT, NULL, 0,
     reset_lock_prof_stats, "I",
@@ -0,0 +1,224 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2021 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/kernel.h>
+#include <sys/lock.h>
+#include <sys/malloc.h>
+#include <sys/mutex.h>
+#include <sys/smp.h>
+#include <sys/smr.h>
+#include <sys/smrhash.h>
+
+static MALLOC_DEFINE(M_SMRHASH, "smrhash", "SMR hash tables");
+
+#define	SMRHASH_MIN_BUCKETS	32
+#define	SMRHASH_MIN_LOCKS	4
+#define	SMRHASH_MAX_LOCKS	256
+
+#define	SMRHASH_LOCK_PTR(sh, hash)					\
+	(&(sh)->sh_locks[(hash) & ((sh)->sh_nlocks - 1)])
+#define	SMRHASH_BUCKET(t, hash)						\
+	(&(t)->sht_bucket[(hash) & (t)->sht_mask])
+
+/*
+ * The table is grown when the entry count exceeds this multiple of the
+ * bucket count.
+ */
+#define	SMRHASH_LOADFACTOR	2
+
+static struct smrhash_table *
+smrhash_table_alloc(u_long nbuckets, int mflag)
+{
+	struct smrhash_table *t;
+	u_long i;
+
+	KASSERT(powerof2(nbuckets), ("%s: bad size %lu", __func__, nbuckets));
+	t = malloc(sizeof(*t) + nbuckets * sizeof(t->sht_bucket[0]),
+	    M_SMRHASH, mflag);
+	if (t == NULL)
+		return (NULL);
+	t->sht_mask = nbuckets - 1;
+	for (i = 0; i < nbuckets; i++)
+		CK_SLIST_INIT(&t->sht_bucket[i]);
+	return (t);
+}
+
+void
+smrhash_init(struct smrhash *sh, const char *name, u_long nbuckets, smr_t smr)
+{
+	u_int i, nlocks;
+
+	if (nbuckets < SMRHASH_MIN_BUCKETS)
+		nbuckets = SMRHASH_MIN_BUCKETS;
+	if (!powerof2(nbuckets))
+		nbuckets = 1UL << flsl(nbuckets);
+	smr_unserialized_store(&sh->sh_table,
+	    smrhash_table_alloc(nbuckets, M_WAITOK), true);
+	for (nlocks = SMRHASH_MIN_LOCKS; nlocks < mp_ncpus &&
+	    nlocks < SMRHASH_MAX_LOCKS; nlocks <<= 1)
+		continue;
+	sh->sh_locks = malloc(nlocks * sizeof(struct mtx), M_SMRHASH,
+	    M_WAITOK);
+	for (i = 0; i < nlocks; i++)
+		mtx_init(&sh->sh_locks[i], name, NULL,
+		    MTX_DEF | MTX_DUPOK | MTX_NEW);
+	sh->sh_nlocks = nlocks;
+	sh->sh_smr = smr;
+	sh->sh_count = 0;
+	sh->sh_name = name;
+}
+
+/*
+ * The caller is responsible for ensuring that no readers or writers
+ * remain; the table itself is freed without waiting for the smr.
+ */
+void
+smrhash_destroy(struct smrhash *sh)
+{
+	struct smrhash_table *t;
+	u_int i;
+
+	KASSERT(sh->sh_count == 0,
+	    ("%s: %s has %lu entries", __func__, sh->sh_name, sh->sh_count));
+	t = smr_unserialized_load(&sh->sh_table, true);
+	smr_unserialized_store(&sh->sh_table, NULL, true);
+	free(t, M_SMRHASH);
+	for (i = 0; i < sh->sh_nlocks; i++)
+		mtx_destroy(&sh->sh_locks[i]);
+	free(sh->sh_locks, M_SMRHASH);
+	sh->sh_locks = NULL;
+}
+
+/*
+ * Lock every stripe so that the table pointer and all buckets are
+ * stable, then move the entries into a larger table.  Readers may be
+ * traversing the old buckets while entries are relinked; since links
+ * only move from the old table to the new one, such a walk still
+ * terminates, and smrhash_lookup() rereads the table pointer on a miss
+ * to cover entries it may have skipped.  The old table is freed only
+ * after all readers have left their sections.
+ */
+static void
+smrhash_resize(struct smrhash *sh)
+{
+	struct smrhash_table *t, *nt;
+	struct smrhash_link *lp;
+	u_long i;
+	u_int j;
+
+	for (j = 0; j < sh->sh_nlocks; j++)
+		mtx_lock(&sh->sh_locks[j]);
+	t = smr_serialized_load(&sh->sh_table,
+	    mtx_owned(&sh->sh_locks[0]));
+	if (sh->sh_count <= SMRHASH_LOADFACTOR * (t->sht_mask + 1))
+		goto out;
+	nt = smrhash_table_alloc((t->sht_mask + 1) * 2, M_NOWAIT);
+	if (nt == NULL)
+		goto out;
+	for (i = 0; i <= t->sht_mask; i++) {
+		while (!CK_SLIST_EMPTY(&t->sht_bucket[i])) {
+			lp = CK_SLIST_FIRST(&t->sht_bucket[i]);
+			CK_SLIST_REMOVE_HEAD(&t->sht_bucket[i], shl_entry);
+			CK_SLIST_INSERT_HEAD(SMRHASH_BUCKET(nt, lp->shl_hash),
+			    lp, shl_entry);
+		}
+	}
+	smr_serialized_store(&sh->sh_table, nt,
+	    mtx_owned(&sh->sh_locks[0]));
+	for (j = 0; j < sh->sh_nlocks; j++)
+		mtx_unlock(&sh->sh_locks[j]);
+	smr_synchronize(sh->sh_smr);
+	free(t, M_SMRHASH);
+	return;
+out:
+	for (j = 0; j < sh->sh_nlocks; j++)
+		mtx_unlock(&sh->sh_locks[j]);
+}
+
+void
+smrhash_insert(struct smrhash *sh, struct smrhash_link *lp, uintptr_t hash)
+{
+	struct smrhash_table *t;
+	struct mtx *lock;
+	bool grow;
+
+	lp->shl_hash = hash;
+	lock = SMRHASH_LOCK_PTR(sh, hash);
+	mtx_lock(lock);
+	t = smr_serialized_load(&sh->sh_table, mtx_owned(lock));
+	CK_SLIST_INSERT_HEAD(SMRHASH_BUCKET(t, hash), lp, shl_entry);
+	grow = atomic_fetchadd_long(&sh->sh_count, 1) + 1 >
+	    SMRHASH_LOADFACTOR * (t->sht_mask + 1);
+	mtx_unlock(lock);
+	if (__predict_false(grow))
+		smrhash_resize(sh);
+}
+
+void
+smrhash_remove(struct smrhash *sh, struct smrhash_link *lp)
+{
+	struct smrhash_table *t;
+	struct mtx *lock;
+
+	lock = SMRHASH_LOCK_PTR(sh, lp->shl_hash);
+	mtx_lock(lock);
+	t = smr_serialized_load(&sh->sh_table, mtx_owned(lock));
+	CK_SLIST_REMOVE(SMRHASH_BUCKET(t, lp->shl_hash), lp, smrhash_link,
+	    shl_entry);
+	atomic_subtract_long(&sh->sh_count, 1);
+	mtx_unlock(lock);
+}
+
+/*
+ * Wait-free in the common case; a lookup only restarts when it misses
+ * while a resize swapped the table out from under it.  The caller must
+ * be in a read section of the table's smr.
+ */
+struct smrhash_link *
+smrhash_lookup(struct smrhash *sh, uintptr_t hash,
+    bool (*match)(struct smrhash_link *, const void *), const void *key)
+{
+	struct smrhash_table *t;
+	struct smrhash_link *lp;
+
+	SMR_ASSERT_ENTERED(sh->sh_smr);
+	for (;;) {
+		t = smr_entered_load(&sh->sh_table, sh->sh_smr);
+		CK_SLIST_FOREACH(lp, SMRHASH_BUCKET(t, hash), shl_entry) {
+			if (lp->shl_hash == hash && match(lp, key))
+				return (lp);
+		}
+		if (__predict_true(smr_entered_load(&sh->sh_table,
+		    sh->sh_smr) == t))
+			return (NULL);
+	}
+}
@@ -56,6 +56,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/mutex.h>
 #include <sys/smp.h>
 #include <sys/condvar.h>
+#include <sys/sbuf.h>
 #include <sys/sysctl.h>
 #include <sys/taskqueue.h>
 #include <sys/vmem.h>
@@ -94,7 +95,7 @@ __FBSDID("$FreeBSD$");
 
 #define	BT_FLAGS	(M_NOWAIT | M_WAITOK | M_USE_RESERVE | M_NOVM)
 
-#define	QC_NAME_MAX	16
+#define	QC_NAME_MAX	32
 
 /*
  * Data structures private to vmem.
@@ -111,6 +112,8 @@ struct qcache {
 	uma_zone_t	qc_cache;
 	vmem_t 		*qc_vmem;
 	vmem_size_t	qc_size;
+	u_long		qc_imports;
+	u_long		qc_releases;
 	char		qc_name[QC_NAME_MAX];
 };
 typedef struct qcache qcache_t;
@@ -536,6 +539,8 @@ qc_import(void *arg, void **store, int cnt, int domain, int flags)
 			break;
 		store[i] = (void *)addr;
 	}
+	if (i != 0)
+		atomic_add_long(&qc->qc_imports, i);
 	return (i);
 }
 
@@ -549,6 +554,7 @@ qc_release(void *arg, void **store, int cnt)
 	int i;
 
 	qc = arg;
+	atomic_add_long(&qc->qc_releases, cnt);
 	for (i = 0; i < cnt; i++)
 		vmem_xfree(qc->qc_vmem, (vmem_addr_t)store[i], qc->qc_size);
 }
@@ -572,6 +578,8 @@ qc_init(vmem_t *vm, vmem_size_t qcache_max)
 		    vm->vm_name, size);
 		qc->qc_vmem = vm;
 		qc->qc_size = size;
+		qc->qc_imports = 0;
+		qc->qc_releases = 0;
 		qc->qc_cache = uma_zcache_create(qc->qc_name, size,
 		    NULL, NULL, NULL, NULL, qc_import, qc_release, qc, 0);
 		MPASS(qc->qc_cache);
@@ -600,6 +608,46 @@ qc_drain(vmem_t *vm)
 		uma_zone_reclaim(vm->vm_qcache[i].qc_cache, UMA_RECLAIM_DRAIN);
 }
 
+/*
+ * Report quantum cache activity for every arena.  An import is an
+ * allocation that missed the per-CPU caches and had to take the arena
+ * lock; comparing imports against the allocation count of the backing
+ * cache zone, as reported by vmstat -z, gives the cache hit rate.
+ */
+static int
+sysctl_vmem_qcache(SYSCTL_HANDLER_ARGS)
+{
+	struct sbuf sbuf;
+	qcache_t *qc;
+	vmem_t *vm;
+	int error, i, qcache_idx_max;
+
+	error = sysctl_wire_old_buffer(req, 0);
+	if (error != 0)
+		return (error);
+	sbuf_new_for_sysctl(&sbuf, NULL, 128, req);
+	sbuf_printf(&sbuf, "\n%-*s %10s %12s %12s\n", QC_NAME_MAX, "CACHE",
+	    "SIZE", "IMPORTS", "RELEASES");
+	mtx_lock(&vmem_list_lock);
+	LIST_FOREACH(vm, &vmem_list, vm_alllist) {
+		qcache_idx_max = vm->vm_qcache_max >> vm->vm_quantum_shift;
+		for (i = 0; i < qcache_idx_max; i++) {
+			qc = &vm->vm_qcache[i];
+			sbuf_printf(&sbuf, "%-*s %10ju %12lu %12lu\n",
+			    QC_NAME_MAX, qc->qc_name, (uintmax_t)qc->qc_size,
+			    qc->qc_imports, qc->qc_releases);
+		}
+	}
+	mtx_unlock(&vmem_list_lock);
+	error = sbuf_finish(&sbuf);
+	sbuf_delete(&sbuf);
+	return (error);
+}
+
+SYSCTL_PROC(_kern, OID_AUTO, vmem_qcache,
+    CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 0,
+    sysctl_vmem_qcache, "A", "vmem quantum cache statistics");
+
 #ifndef UMA_MD_SMALL_ALLOC
 
 static struct mtx_padalign __exclusive_cache_line vmem_bt_lock;
@@ -583,4 +583,5 @@ const char *syscallnames[] = {
 	"__realpathat",			/* 574 = __realpathat */
 	"close_range",			/* 575 = close_range */
 	"rpctls_syscall",			/* 576 = rpctls_syscall */
+	"getdirentriesplus",			/* 577 = getdirentriesplus */
 };
@@ -42,6 +42,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/proc.h>
 #include <sys/protosw.h>
 #include <sys/refcount.h>
+#include <sys/sbuf.h>
 #include <sys/smp.h>
 #include <sys/socket.h>
 #include <sys/socketvar.h>
@@ -81,6 +82,7 @@ struct ktls_wq {
 	STAILQ_HEAD(, mbuf) m_head;
 	STAILQ_HEAD(, socket) so_head;
 	bool		running;
+	u_int		depth;
 } __aligned(CACHE_LINE_SIZE);
 
 static struct ktls_wq *ktls_wq;
@@ -117,6 +119,27 @@ SYSCTL_INT(_kern_ipc_tls_stats, OID_AUTO, threads, CTLFLAG_RD,
     &ktls_number_threads, 0,
     "Number of TLS threads in thread-pool");
 
+static int
+sysctl_kern_ipc_tls_wq_depth(SYSCTL_HANDLER_ARGS)
+{
+	struct sbuf sb;
+	int error, i;
+
+	error = sysctl_wire_old_buffer(req, 0);
+	if (error != 0)
+		return (error);
+	sbuf_new_for_sysctl(&sb, NULL, 8 * ktls_number_threads + 1, req);
+	for (i = 0; i < ktls_number_threads; i++)
+		sbuf_printf(&sb, "%s%u", i == 0 ? "" : " ", ktls_wq[i].depth);
+	error = sbuf_finish(&sb);
+	sbuf_delete(&sb);
+	return (error);
+}
+SYSCTL_PROC(_kern_ipc_tls_stats, OID_AUTO, wq_depth,
+    CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 0,
+    sysctl_kern_ipc_tls_wq_depth, "A",
+    "Number of work items queued to each TLS worker thread");
+
 static bool ktls_offload_enable;
 SYSCTL_BOOL(_kern_ipc_tls, OID_AUTO, enable, CTLFLAG_RW,
     &ktls_offload_enable, 0,
@@ -1539,6 +1562,7 @@ ktls_check_rx(struct sockbuf *sb)
 	wq = &ktls_wq[so->so_rcv.sb_tls_info->wq_index];
 	mtx_lock(&wq->mtx);
 	STAILQ_INSERT_TAIL(&wq->so_head, so, so_ktls_rx_list);
+	wq->depth++;
 	running = wq->running;
 	mtx_unlock(&wq->mtx);
 	if (!running)
@@ -1836,6 +1860,7 @@ ktls_enqueue_to_free(struct mbuf *m)
 	wq = &ktls_wq[m->m_epg_tls->wq_index];
 	mtx_lock(&wq->mtx);
 	STAILQ_INSERT_TAIL(&wq->m_head, m, m_epg_stailq);
+	wq->depth++;
 	running = wq->running;
 	mtx_unlock(&wq->mtx);
 	if (!running)
@@ -1866,6 +1891,7 @@ ktls_enqueue(struct mbuf *m, struct socket *so, int page_count)
 	wq = &ktls_wq[m->m_epg_tls->wq_index];
 	mtx_lock(&wq->mtx);
 	STAILQ_INSERT_TAIL(&wq->m_head, m, m_epg_stailq);
+	wq->depth++;
 	running = wq->running;
 	mtx_unlock(&wq->mtx);
 	if (!running)
@@ -2042,6 +2068,7 @@ ktls_work_thread(void *ctx)
 		STAILQ_CONCAT(&local_m_head, &wq->m_head);
 		STAILQ_INIT(&local_so_head);
 		STAILQ_CONCAT(&local_so_head, &wq->so_head);
+		wq->depth = 0;
 		mtx_unlock(&wq->mtx);
 
 		STAILQ_FOREACH_SAFE(m, &local_m_head, m_epg_stailq, n) {
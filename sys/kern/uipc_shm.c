@@ -97,6 +97,7 @@ __FBSDID("$FreeBSD$");
 #include <vm/vm_page.h>
 #include <vm/vm_pageout.h>
 #include <vm/vm_pager.h>
+#include <vm/vm_reserv.h>
 #include <vm/swap_pager.h>
 
 struct shm_mapping {
@@ -116,6 +117,13 @@ static dev_t shm_dev_ino;
 
 #define	SHM_HASH(fnv)	(&shm_dictionary[(fnv) & shm_hash])
 
+#if VM_NRESERVLEVEL > 0
+static u_long shm_largepage_threshold = 2 * 1024 * 1024;
+SYSCTL_ULONG(_kern_ipc, OID_AUTO, shm_largepage_threshold, CTLFLAG_RWTUN,
+    &shm_largepage_threshold, 0,
+    "Size above which shared memory objects are aligned for superpages");
+#endif
+
 static void	shm_init(void *arg);
 static void	shm_insert(char *path, Fnv32_t fnv, struct shmfd *shmfd);
 static struct shmfd *shm_lookup(char *path, Fnv32_t fnv);
@@ -582,6 +590,15 @@ retry:
 		if (!swap_reserve_by_cred(delta, object->cred))
 			return (ENOMEM);
 		object->charge += delta;
+#if VM_NRESERVLEVEL > 0
+		/*
+		 * Color large objects at a superpage boundary so that
+		 * their pages are allocated from reservations that can
+		 * be promoted under suitably aligned mappings.
+		 */
+		if (length >= shm_largepage_threshold && pagesizes[1] != 0)
+			vm_object_color(object, 0);
+#endif
 	}
 	shmfd->shm_size = length;
 	mtx_lock(&shm_timestamp_lock);
@@ -1209,6 +1226,19 @@ shm_mmap(struct file *fp, vm_map_t map, vm_offset_t *addr, vm_size_t objsize,
 	mtx_unlock(&shm_timestamp_lock);
 	vm_object_reference(shmfd->shm_object);
 
+#if VM_NRESERVLEVEL > 0
+	/*
+	 * Prefer superpage alignment for mappings of large objects so
+	 * that fully populated reservations backing them can be
+	 * promoted.  An explicit alignment request or a fixed address
+	 * from the application is respected.
+	 */
+	if (shmfd->shm_size >= shm_largepage_threshold &&
+	    pagesizes[1] != 0 && foff == 0 &&
+	    (flags & (MAP_FIXED | MAP_ALIGNMENT_MASK)) == 0)
+		flags |= MAP_ALIGNED_SUPER;
+#endif
+
 	if (writecnt)
 		vm_pager_update_writecount(shmfd->shm_object, 0, objsize);
 	error = vm_mmap_object(map, addr, objsize, prot, maxprot, flags,
@@ -1396,6 +1426,10 @@ shm_fill_kinfo_locked(struct shmfd *shmfd, struct kinfo_file *kif, bool list)
 	kif->kf_type = KF_TYPE_SHM;
 	kif->kf_un.kf_file.kf_file_mode = S_IFREG | shmfd->shm_mode;
 	kif->kf_un.kf_file.kf_file_size = shmfd->shm_size;
+#if VM_NRESERVLEVEL > 0
+	kif->kf_un.kf_file.kf_file_nsuperpg =
+	    vm_reserv_object_fullpop(shmfd->shm_object);
+#endif
 	if (shmfd->shm_path != NULL) {
 		if (shmfd->shm_path != NULL) {
 			path = shmfd->shm_path;
@@ -997,6 +997,91 @@ sbappendstream(struct sockbuf *sb, struct mbuf *m, int flags)
 	SOCKBUF_UNLOCK(sb);
 }
 
+/*
+ * Append a chain of data mbufs with precomputed accounting to a stream
+ * socket buffer.  The caller supplies the last mbuf of the chain along
+ * with its total data length, mbuf count, cluster count and mbuf
+ * storage (MSIZE plus the external storage size for each mbuf), which
+ * lets us splice the chain at the cached tail and update the
+ * bookkeeping once instead of per mbuf.  The chain must be pure, ready
+ * data: MT_DATA mbufs without packet headers, tags or M_EOR marks; use
+ * m_demote() before calling if that is not already so.  No coalescing
+ * into the tail is attempted, so this is only a win for chains of
+ * reasonably full mbufs.  Cases that need the per-mbuf walk (TLS,
+ * not-ready data) fall back to sbappendstream_locked().
+ */
+void
+sbappendstream_batch_locked(struct sockbuf *sb, struct mbuf *m,
+    struct mbuf *mlast, u_int len, u_int cnt, u_int ccnt, u_int mbcnt,
+    int flags)
+{
+
+	SOCKBUF_LOCK_ASSERT(sb);
+
+	KASSERT(m->m_nextpkt == NULL, ("%s: chain has nextpkt", __func__));
+	KASSERT(mlast->m_next == NULL, ("%s: mlast is not the tail", __func__));
+
+	if (
+#ifdef KERN_TLS
+	    (sb->sb_flags & SB_TLS_RX) != 0 || sb->sb_tls_info != NULL ||
+#endif
+	    (flags & PRUS_NOTREADY) != 0 || sb->sb_fnrdy != NULL) {
+		sbappendstream_locked(sb, m, flags);
+		return;
+	}
+
+	KASSERT(sb->sb_mb == sb->sb_lastrecord, ("sbappendstream 1"));
+
+#ifdef INVARIANTS
+	{
+		struct mbuf *n;
+		u_int nccnt, ncnt, nlen, nmbcnt;
+
+		nlen = ncnt = nccnt = nmbcnt = 0;
+		for (n = m; n != NULL; n = n->m_next) {
+			KASSERT(n->m_type == MT_DATA,
+			    ("%s: type %d not MT_DATA", __func__, n->m_type));
+			KASSERT((n->m_flags &
+			    (M_PKTHDR | M_NOTREADY | M_EOR)) == 0,
+			    ("%s: mbuf %p flags %x", __func__, n, n->m_flags));
+			nlen += n->m_len;
+			ncnt++;
+			nmbcnt += MSIZE;
+			if (n->m_flags & M_EXT) {
+				nmbcnt += n->m_ext.ext_size;
+				nccnt++;
+			}
+			if (n->m_next == NULL)
+				KASSERT(n == mlast,
+				    ("%s: mlast %p is not the tail %p",
+				    __func__, mlast, n));
+		}
+		KASSERT(nlen == len, ("%s: len %u != %u", __func__, len, nlen));
+		KASSERT(ncnt == cnt,
+		    ("%s: cnt %u != %u", __func__, cnt, ncnt));
+		KASSERT(nccnt == ccnt,
+		    ("%s: ccnt %u != %u", __func__, ccnt, nccnt));
+		KASSERT(nmbcnt == mbcnt,
+		    ("%s: mbcnt %u != %u", __func__, mbcnt, nmbcnt));
+	}
+#endif
+
+	SBLASTMBUFCHK(sb);
+	if (sb->sb_mbtail != NULL)
+		sb->sb_mbtail->m_next = m;
+	else
+		sb->sb_mb = m;
+	sb->sb_mbtail = mlast;
+	sb->sb_acc += len;
+	sb->sb_ccc += len;
+	sb->sb_mcnt += cnt;
+	sb->sb_ccnt += ccnt;
+	sb->sb_mbcnt += mbcnt;
+	sb->sb_lastrecord = sb->sb_mb;
+	SBLASTMBUFCHK(sb);
+	SBLASTRECORDCHK(sb);
+}
+
 #ifdef SOCKBUF_DEBUG
 void
 sbcheck(struct sockbuf *sb, const char *file, int line)
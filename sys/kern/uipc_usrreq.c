@@ -389,6 +389,52 @@ unp_pcb_owned_lock2_slowpath(struct unpcb *unp, struct unpcb **unp2p,
 		unp_pcb_owned_lock2_slowpath((unp), &(unp2), &freed);	\
 } while (0)
 
+/*
+ * Exchange the lock on a connected pcb for the lock on its peer.  On
+ * return only the peer's lock is held; NULL is returned with no locks
+ * held if the socket is not connected or the connection was torn down
+ * while the locks were dropped.  Only usable on connection-oriented
+ * sockets, where the unp_conn linkage is symmetric; callers that must
+ * retain their own lock, or that run on SOCK_DGRAM sockets, should use
+ * unp_pcb_owned_lock2() instead.
+ */
+static struct unpcb *
+unp_pcb_lock_peer(struct unpcb *unp)
+{
+	struct unpcb *unp2;
+
+	UNP_PCB_LOCK_ASSERT(unp);
+	unp2 = unp->unp_conn;
+	if (__predict_false(unp2 == NULL)) {
+		UNP_PCB_UNLOCK(unp);
+		return (NULL);
+	}
+	MPASS(unp != unp2);
+	if (__predict_true(UNP_PCB_TRYLOCK(unp2))) {
+		UNP_PCB_UNLOCK(unp);
+		return (unp2);
+	}
+
+	/*
+	 * The peer's lock is contended.  Take a reference to keep the
+	 * pcb alive, drop our own lock to preserve the lock order and
+	 * block on the peer.  Unlike unp_pcb_owned_lock2(), there is no
+	 * need to reacquire our own lock afterwards; the connection is
+	 * revalidated through the peer's unp_conn back pointer instead,
+	 * which is stable under the peer's lock.
+	 */
+	unp_pcb_hold(unp2);
+	UNP_PCB_UNLOCK(unp);
+	UNP_PCB_LOCK(unp2);
+	if (unp_pcb_rele(unp2))
+		return (NULL);
+	if (__predict_false(unp2->unp_conn != unp)) {
+		UNP_PCB_UNLOCK(unp2);
+		return (NULL);
+	}
+	return (unp2);
+}
+
 /*
  * Definitions of protocols supported in the LOCAL domain.
  */
@@ -1149,7 +1195,7 @@ uipc_send(struct socket *so, int flags, struct mbuf *m, struct sockaddr *nam,
 			UNP_PCB_LOCK(unp);
 		}
 
-		if ((unp2 = unp->unp_conn) == NULL) {
+		if (unp->unp_conn == NULL) {
 			UNP_PCB_UNLOCK(unp);
 			error = ENOTCONN;
 			break;
@@ -1157,14 +1203,8 @@ uipc_send(struct socket *so, int flags, struct mbuf *m, struct sockaddr *nam,
 			UNP_PCB_UNLOCK(unp);
 			error = EPIPE;
 			break;
-		} else if ((unp2 = unp->unp_conn) == NULL) {
-			UNP_PCB_UNLOCK(unp);
-			error = ENOTCONN;
-			break;
 		}
-		unp_pcb_owned_lock2(unp, unp2, freed);
-		UNP_PCB_UNLOCK(unp);
-		if (__predict_false(freed)) {
+		if ((unp2 = unp_pcb_lock_peer(unp)) == NULL) {
 			error = ENOTCONN;
 			break;
 		}
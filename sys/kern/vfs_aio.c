@@ -267,6 +267,7 @@ struct kaioinfo {
 	struct	mtx kaio_mtx;		/* the lock to protect this struct */
 	int	kaio_flags;		/* (a) per process kaio flags */
 	int	kaio_active_count;	/* (c) number of currently used AIOs */
+	int	kaio_deferred_kicks;	/* (c) daemon kicks deferred by batch */
 	int	kaio_count;		/* (a) size of AIO queue */
 	int	kaio_buffer_count;	/* (a) number of bio buffers */
 	TAILQ_HEAD(,kaiocb) kaio_all;	/* (a) all AIOs in a process */
@@ -328,6 +329,7 @@ static void	aio_bio_done_notify(struct proc *userp, struct kaiocb *job);
 static bool	aio_clear_cancel_function_locked(struct kaiocb *job);
 static int	aio_kick(struct proc *userp);
 static void	aio_kick_nowait(struct proc *userp);
+static void	aio_kick_flush(struct proc *userp);
 static void	aio_kick_helper(void *context, int pending);
 static int	filt_aioattach(struct knote *kn);
 static void	filt_aiodetach(struct knote *kn);
@@ -441,6 +443,7 @@ aio_init_aioinfo(struct proc *p)
 	mtx_init(&ki->kaio_mtx, "aiomtx", NULL, MTX_DEF | MTX_NEW);
 	ki->kaio_flags = 0;
 	ki->kaio_active_count = 0;
+	ki->kaio_deferred_kicks = 0;
 	ki->kaio_count = 0;
 	ki->kaio_buffer_count = 0;
 	TAILQ_INIT(&ki->kaio_all);
@@ -1759,6 +1762,15 @@ aio_kick_nowait(struct proc *userp)
 	struct aioproc *aiop;
 
 	mtx_assert(&aio_job_mtx, MA_OWNED);
+	if ((curthread->td_pflags2 & TDP2_AIOBATCH) != 0) {
+		/*
+		 * lio_listio(2) is queueing a batch of requests.  Count
+		 * the kick instead of issuing it so that the daemons are
+		 * woken once, after the whole batch has been queued.
+		 */
+		ki->kaio_deferred_kicks++;
+		return;
+	}
 	if ((aiop = TAILQ_FIRST(&aio_freeproc)) != NULL) {
 		TAILQ_REMOVE(&aio_freeproc, aiop, list);
 		aiop->aioprocflags &= ~AIOP_FREE;
@@ -1811,6 +1823,28 @@ aio_kick_helper(void *context, int pending)
 	mtx_unlock(&aio_job_mtx);
 }
 
+/*
+ * Issue the daemon kicks that aio_kick_nowait() deferred while a batch
+ * of requests was being queued under TDP2_AIOBATCH.  Waking at most one
+ * daemon per queued job is only an upper bound; each daemon drains the
+ * job queue until it is empty, so extra daemons simply go back to sleep.
+ */
+static void
+aio_kick_flush(struct proc *userp)
+{
+	struct kaioinfo *ki = userp->p_aioinfo;
+	int pending;
+
+	mtx_lock(&aio_job_mtx);
+	pending = ki->kaio_deferred_kicks;
+	ki->kaio_deferred_kicks = 0;
+	while (--pending >= 0) {
+		if (aio_kick(userp))
+			break;
+	}
+	mtx_unlock(&aio_job_mtx);
+}
+
 /*
  * Support the aio_return system call, as a side-effect, kernel resources are
  * released.
@@ -2200,6 +2234,13 @@ kern_lio_listio(struct thread *td, int mode, struct aiocb * const *uacb_list,
 	 */
 	nagain = 0;
 	nerror = 0;
+	/*
+	 * Queue the whole batch before waking any AIO daemons.  A woken
+	 * daemon drains the job queue until it is empty, so a single
+	 * round of kicks at the end services the entire list and avoids
+	 * a wakeup (and the attendant context switch) per request.
+	 */
+	td->td_pflags2 |= TDP2_AIOBATCH;
 	for (i = 0; i < nent; i++) {
 		job = acb_list[i];
 		if (job != NULL) {
@@ -2210,6 +2251,8 @@ kern_lio_listio(struct thread *td, int mode, struct aiocb * const *uacb_list,
 				nerror++;
 		}
 	}
+	td->td_pflags2 &= ~TDP2_AIOBATCH;
+	aio_kick_flush(p);
 
 	error = 0;
 	AIO_LOCK(ki);
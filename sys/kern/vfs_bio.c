@@ -294,6 +294,16 @@ static counter_u64_t getnewbufrestarts;
 SYSCTL_COUNTER_U64(_vfs, OID_AUTO, getnewbufrestarts, CTLFLAG_RD,
     &getnewbufrestarts,
     "Number of times getnewbuf has had to restart a buffer acquisition");
+static counter_u64_t getnewbufremotedomain;
+SYSCTL_COUNTER_U64(_vfs, OID_AUTO, getnewbufremotedomain, CTLFLAG_RD,
+    &getnewbufremotedomain,
+    "Number of getnewbuf calls served by a buffer domain remote to the "
+    "calling CPU's memory domain");
+static counter_u64_t brelseremotedomain;
+SYSCTL_COUNTER_U64(_vfs, OID_AUTO, brelseremotedomain, CTLFLAG_RD,
+    &brelseremotedomain,
+    "Number of buffers released to a buffer domain remote to the "
+    "releasing CPU's memory domain");
 static counter_u64_t mappingrestarts;
 SYSCTL_COUNTER_U64(_vfs, OID_AUTO, mappingrestarts, CTLFLAG_RD,
     &mappingrestarts,
@@ -1278,6 +1288,8 @@ bufinit(void)
 	}
 	getnewbufcalls = counter_u64_alloc(M_WAITOK);
 	getnewbufrestarts = counter_u64_alloc(M_WAITOK);
+	getnewbufremotedomain = counter_u64_alloc(M_WAITOK);
+	brelseremotedomain = counter_u64_alloc(M_WAITOK);
 	mappingrestarts = counter_u64_alloc(M_WAITOK);
 	numbufallocfails = counter_u64_alloc(M_WAITOK);
 	notbufdflushes = counter_u64_alloc(M_WAITOK);
@@ -1537,6 +1549,8 @@ binsfree(struct buf *bp, int qindex)
 		BQ_UNLOCK(bq);
 	}
 	bd = bufdomain(bp);
+	if ((int)(BD_DOMAIN(bd) % vm_ndomains) != PCPU_GET(domain))
+		counter_u64_add(brelseremotedomain, 1);
 	if (qindex == QUEUE_CLEAN) {
 		if (bd->bd_lim != 0)
 			bq = &bd->bd_subq[PCPU_GET(cpuid)];
@@ -3258,12 +3272,19 @@ getnewbuf(struct vnode *vp, int slpflag, int slptimeo, int maxsize, int gbflags)
 		metadata = true;
 	else
 		metadata = false;
+	/*
+	 * With no vnode to carry an affinity, prefer the buffer domain
+	 * congruent to the calling CPU's memory domain rather than
+	 * concentrating all such allocations on domain 0.
+	 */
 	if (vp == NULL)
-		bd = &bdomain[0];
+		bd = &bdomain[PCPU_GET(domain) % buf_domains];
 	else
 		bd = &bdomain[vp->v_bufobj.bo_domain];
 
 	counter_u64_add(getnewbufcalls, 1);
+	if ((int)(BD_DOMAIN(bd) % vm_ndomains) != PCPU_GET(domain))
+		counter_u64_add(getnewbufremotedomain, 1);
 	reserved = false;
 	do {
 		if (reserved == false &&
@@ -4998,8 +5019,22 @@ bufobj_init(struct bufobj *bo, void *private)
 {
 	static volatile int bufobj_cleanq;
 
-        bo->bo_domain =
-            atomic_fetchadd_int(&bufobj_cleanq, 1) % buf_domains;
+	/*
+	 * Buffer domains are sized by buffer space, not memory topology.
+	 * When they divide evenly over the memory domains, pick a buffer
+	 * domain congruent to the allocating thread's memory domain,
+	 * round-robining among the buffer domains that map to it.  This
+	 * keeps a vnode's buffers on queues backed by memory local to
+	 * the threads using it.  Otherwise fall back to striping every
+	 * bufobj across all buffer domains.
+	 */
+	if (buf_domains % vm_ndomains == 0)
+		bo->bo_domain = PCPU_GET(domain) + vm_ndomains *
+		    (atomic_fetchadd_int(&bufobj_cleanq, 1) %
+		    (buf_domains / vm_ndomains));
+	else
+		bo->bo_domain =
+		    atomic_fetchadd_int(&bufobj_cleanq, 1) % buf_domains;
         rw_init(BO_LOCKPTR(bo), "bufobj interlock");
         bo->bo_private = private;
         TAILQ_INIT(&bo->bo_clean.bv_hd);
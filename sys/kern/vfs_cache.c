@@ -306,11 +306,17 @@ static bool __read_frequently cache_fast_revlookup = true;
 SYSCTL_BOOL(_vfs, OID_AUTO, cache_fast_revlookup, CTLFLAG_RW,
     &cache_fast_revlookup, 0, "");
 
+static u_int __read_mostly cache_fullpath_smr_retries = 3;
+SYSCTL_UINT(_vfs, OID_AUTO, cache_fullpath_smr_retries, CTLFLAG_RW,
+    &cache_fullpath_smr_retries, 0,
+    "Number of lockless reverse walk restarts before the locked fallback");
+
 static struct mtx __exclusive_cache_line	ncneg_shrink_lock;
 
 struct neglist {
 	struct mtx		nl_lock;
 	TAILQ_HEAD(, namecache) nl_list;
+	u_long			nl_count;
 } __aligned(CACHE_LINE_SIZE);
 
 static struct neglist __read_mostly	*neglists;
@@ -447,6 +453,10 @@ STATNODE_ULONG(numneg, "Number of negative cache entries");
 STATNODE_ULONG(numcache, "Number of cache entries");
 STATNODE_COUNTER(numcachehv, "Number of namecache entries with vnodes held");
 STATNODE_COUNTER(numdrops, "Number of dropped entries due to reaching the limit");
+STATNODE_COUNTER(numposdrops,
+    "Number of dropped positive entries due to reaching the limit");
+STATNODE_COUNTER(numnegdrops,
+    "Number of dropped negative entries due to reaching the limit");
 STATNODE_COUNTER(dothits, "Number of '.' hits");
 STATNODE_COUNTER(dotdothits, "Number of '..' hits");
 STATNODE_COUNTER(nummiss, "Number of cache misses");
@@ -823,6 +833,7 @@ cache_negative_hit(struct namecache *ncp)
 	if ((negstate->neg_flag & NEG_HOT) == 0) {
 		numhotneg++;
 		TAILQ_REMOVE(&neglist->nl_list, ncp, nc_dst);
+		neglist->nl_count--;
 		TAILQ_INSERT_TAIL(&ncneg_hot.nl_list, ncp, nc_dst);
 		negstate->neg_flag |= NEG_HOT;
 	}
@@ -840,6 +851,7 @@ cache_negative_insert(struct namecache *ncp)
 	neglist = NCP2NEGLIST(ncp);
 	mtx_lock(&neglist->nl_lock);
 	TAILQ_INSERT_TAIL(&neglist->nl_list, ncp, nc_dst);
+	neglist->nl_count++;
 	mtx_unlock(&neglist->nl_lock);
 	atomic_add_rel_long(&numneg, 1);
 }
@@ -882,6 +894,7 @@ cache_negative_remove(struct namecache *ncp)
 	} else {
 		mtx_assert(&neglist->nl_lock, MA_OWNED);
 		TAILQ_REMOVE(&neglist->nl_list, ncp, nc_dst);
+		neglist->nl_count--;
 	}
 	if (list_locked)
 		mtx_unlock(&neglist->nl_lock);
@@ -901,6 +914,31 @@ cache_negative_shrink_select(struct namecache **ncpp,
 
 	*ncpp = ncp = NULL;
 
+	/*
+	 * Evict from the longest cold list first, so that a bucket flooded
+	 * with negative entries ages independently of the others instead
+	 * of the round-robin cursor picking victims from sparsely
+	 * populated lists.  The counts are read unlocked; this is only a
+	 * heuristic for choosing a victim.
+	 */
+	neglist = NULL;
+	for (i = 0; i < numneglists; i++) {
+		if (neglists[i].nl_count > (neglist == NULL ?
+		    0 : neglist->nl_count))
+			neglist = &neglists[i];
+	}
+	if (neglist != NULL) {
+		mtx_lock(&neglist->nl_lock);
+		ncp = TAILQ_FIRST(&neglist->nl_list);
+		if (ncp != NULL) {
+			*neglistpp = neglist;
+			*ncpp = ncp;
+			cycle++;
+			return;
+		}
+		mtx_unlock(&neglist->nl_lock);
+	}
+
 	for (i = 0; i < numneglists; i++) {
 		neglist = &neglists[(cycle + i) % numneglists];
 		if (TAILQ_FIRST(&neglist->nl_list) == NULL)
@@ -917,7 +955,7 @@ cache_negative_shrink_select(struct namecache **ncpp,
 	cycle++;
 }
 
-static void
+static bool
 cache_negative_zap_one(void)
 {
 	struct namecache *ncp, *ncp2;
@@ -929,7 +967,7 @@ cache_negative_zap_one(void)
 	if (mtx_owner(&ncneg_shrink_lock) != NULL ||
 	    !mtx_trylock(&ncneg_shrink_lock)) {
 		counter_u64_add(shrinking_skipped, 1);
-		return;
+		return (false);
 	}
 
 	mtx_lock(&ncneg_hot.nl_lock);
@@ -941,6 +979,7 @@ cache_negative_zap_one(void)
 		MPASS((negstate->neg_flag & NEG_HOT) != 0);
 		TAILQ_REMOVE(&ncneg_hot.nl_list, ncp, nc_dst);
 		TAILQ_INSERT_TAIL(&neglist->nl_list, ncp, nc_dst);
+		neglist->nl_count++;
 		negstate->neg_flag &= ~NEG_HOT;
 		numhotneg--;
 		mtx_unlock(&neglist->nl_lock);
@@ -951,7 +990,7 @@ cache_negative_zap_one(void)
 
 	mtx_unlock(&ncneg_shrink_lock);
 	if (ncp == NULL)
-		return;
+		return (false);
 
 	MPASS(ncp->nc_flag & NCF_NEGATIVE);
 	dvlp = VP2VNODELOCK(ncp->nc_dvp);
@@ -981,6 +1020,7 @@ cache_negative_zap_one(void)
 	mtx_unlock(dvlp);
 	if (ncp != NULL)
 		cache_free(ncp);
+	return (ncp != NULL);
 }
 
 /*
@@ -1956,12 +1996,25 @@ cache_enter_time(struct vnode *dvp, struct vnode *vp, struct componentname *cnp,
 
 	/*
 	 * Avoid blowout in namecache entries.
+	 *
+	 * If the cache is at capacity, first try to make room by evicting
+	 * a cold negative entry.  Without this, a flood of negative
+	 * entries (e.g., from run-time linker path probing on a build
+	 * host) can pin the cache at the limit and cause new positive
+	 * entries to be dropped instead.
 	 */
 	lnumcache = atomic_fetchadd_long(&numcache, 1) + 1;
 	if (__predict_false(lnumcache >= ncsize)) {
-		atomic_add_long(&numcache, -1);
-		counter_u64_add(numdrops, 1);
-		return;
+		if (atomic_load_long(&numneg) == 0 ||
+		    !cache_negative_zap_one()) {
+			atomic_add_long(&numcache, -1);
+			counter_u64_add(numdrops, 1);
+			if (vp == NULL)
+				counter_u64_add(numnegdrops, 1);
+			else
+				counter_u64_add(numposdrops, 1);
+			return;
+		}
 	}
 
 	cache_celockstate_init(&cel);
@@ -2856,11 +2909,13 @@ vn_fullpath_any_smr(struct vnode *vp, struct vnode *rdir, char *buf,
 	struct vnode *startvp = vp;
 #endif
 	struct vnode *tvp;
+	struct vnode *origvp;
 	struct mount *mp;
 	struct namecache *ncp;
 	size_t orig_buflen;
 	int reason;
 	int error;
+	int tries;
 #ifdef KDTRACE_HOOKS
 	int i;
 #endif
@@ -2875,6 +2930,12 @@ vn_fullpath_any_smr(struct vnode *vp, struct vnode *rdir, char *buf,
 	}
 
 	orig_buflen = *buflen;
+	origvp = vp;
+	tries = cache_fullpath_smr_retries;
+
+restart:
+	vp = origvp;
+	*buflen = orig_buflen;
 
 	if (!slash_prefixed) {
 		MPASS(*buflen >= 2);
@@ -2898,7 +2959,7 @@ vn_fullpath_any_smr(struct vnode *vp, struct vnode *rdir, char *buf,
 	vp_seqc = vn_seqc_read_any(vp);
 	if (seqc_in_modify(vp_seqc)) {
 		cache_rev_failed(&reason);
-		goto out_abort;
+		goto out_retry;
 	}
 
 	for (;;) {
@@ -2915,11 +2976,11 @@ vn_fullpath_any_smr(struct vnode *vp, struct vnode *rdir, char *buf,
 			tvp_seqc = vn_seqc_read_any(tvp);
 			if (seqc_in_modify(tvp_seqc)) {
 				cache_rev_failed(&reason);
-				goto out_abort;
+				goto out_retry;
 			}
 			if (!vn_seqc_consistent(vp, vp_seqc)) {
 				cache_rev_failed(&reason);
-				goto out_abort;
+				goto out_retry;
 			}
 			vp = tvp;
 			vp_seqc = tvp_seqc;
@@ -2952,11 +3013,11 @@ vn_fullpath_any_smr(struct vnode *vp, struct vnode *rdir, char *buf,
 		tvp_seqc = vn_seqc_read_any(tvp);
 		if (seqc_in_modify(tvp_seqc)) {
 			cache_rev_failed(&reason);
-			goto out_abort;
+			goto out_retry;
 		}
 		if (!vn_seqc_consistent(vp, vp_seqc)) {
 			cache_rev_failed(&reason);
-			goto out_abort;
+			goto out_retry;
 		}
 		vp = tvp;
 		vp_seqc = tvp_seqc;
@@ -2970,6 +3031,15 @@ out_ok:
 	SDT_PROBE2(vfs, namecache, fullpath_smr, hit, startvp, *retbuf);
 	return (0);
 
+out_retry:
+	/*
+	 * The walk raced with a rename or a similar modification somewhere
+	 * on the path.  The tree itself is intact, so a restart is likely
+	 * to succeed; only fall back to the locked walk once the retry
+	 * budget is exhausted.
+	 */
+	if (tries-- > 0)
+		goto restart;
 out_abort:
 	*buflen = orig_buflen;
 	SDT_PROBE4(vfs, namecache, fullpath_smr, miss, startvp, ncp, reason, i);
@@ -3587,6 +3657,7 @@ cache_fplookup_negative_promote(struct cache_fpl *fpl, struct namecache *oncp,
 	if ((negstate->neg_flag & NEG_HOT) == 0) {
 		numhotneg++;
 		TAILQ_REMOVE(&neglist->nl_list, ncp, nc_dst);
+		neglist->nl_count--;
 		TAILQ_INSERT_TAIL(&ncneg_hot.nl_list, ncp, nc_dst);
 		negstate->neg_flag |= NEG_HOT;
 	}
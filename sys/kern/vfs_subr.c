@@ -1199,59 +1199,87 @@ SYSCTL_INT(_debug, OID_AUTO, max_vnlru_free, CTLFLAG_RW, &max_vnlru_free,
     0,
     "limit on vnode free requests per call to the vnlru_free routine");
 
+/*
+ * Number of vnodes claimed from the free list per vnode_list_mtx
+ * acquisition.  Claiming candidates in batches amortizes the lock over
+ * many reclamations instead of cycling it around every vtryrecycle()
+ * call, which is what lets reclamation keep pace with a high vnode
+ * churn without starving getnewvnode() callers of the lock.
+ */
+#define	VNLRU_FREE_BATCH	64
+
 /*
  * Attempt to reduce the free list by the requested amount.
  */
 static int
 vnlru_free_locked(int count, struct vfsops *mnt_op)
 {
+	struct vnode *batch[VNLRU_FREE_BATCH];
 	struct vnode *vp, *mvp;
 	struct mount *mp;
-	int ocount;
+	int ocount, nbatch, i;
 
 	mtx_assert(&vnode_list_mtx, MA_OWNED);
 	if (count > max_vnlru_free)
 		count = max_vnlru_free;
 	ocount = count;
 	mvp = vnode_list_free_marker;
-restart:
 	vp = mvp;
 	while (count > 0) {
-		vp = TAILQ_NEXT(vp, v_vnodelist);
-		if (__predict_false(vp == NULL)) {
-			TAILQ_REMOVE(&vnode_list, mvp, v_vnodelist);
-			TAILQ_INSERT_TAIL(&vnode_list, mvp, v_vnodelist);
-			break;
-		}
-		if (__predict_false(vp->v_type == VMARKER))
-			continue;
-
 		/*
-		 * Don't recycle if our vnode is from different type
-		 * of mount point.  Note that mp is type-safe, the
-		 * check does not reach unmapped address even if
-		 * vnode is reclaimed.
-		 * Don't recycle if we can't get the interlock without
-		 * blocking.
+		 * Claim a batch of candidate vnodes under a single hold
+		 * of the list lock.  Claimed vnodes are held, which keeps
+		 * them from being freed while they sit in the batch.
 		 */
-		if (vp->v_holdcnt > 0 || (mnt_op != NULL && (mp = vp->v_mount) != NULL &&
-		    mp->mnt_op != mnt_op) || !VI_TRYLOCK(vp)) {
-			continue;
-		}
-		TAILQ_REMOVE(&vnode_list, mvp, v_vnodelist);
-		TAILQ_INSERT_AFTER(&vnode_list, vp, mvp, v_vnodelist);
-		if (__predict_false(vp->v_type == VBAD || vp->v_type == VNON)) {
+		nbatch = 0;
+		while (count > nbatch && nbatch < VNLRU_FREE_BATCH) {
+			vp = TAILQ_NEXT(vp, v_vnodelist);
+			if (__predict_false(vp == NULL)) {
+				TAILQ_REMOVE(&vnode_list, mvp, v_vnodelist);
+				TAILQ_INSERT_TAIL(&vnode_list, mvp,
+				    v_vnodelist);
+				break;
+			}
+			if (__predict_false(vp->v_type == VMARKER))
+				continue;
+
+			/*
+			 * Don't recycle if our vnode is from different type
+			 * of mount point.  Note that mp is type-safe, the
+			 * check does not reach unmapped address even if
+			 * vnode is reclaimed.
+			 * Don't recycle if we can't get the interlock without
+			 * blocking.
+			 */
+			if (vp->v_holdcnt > 0 || (mnt_op != NULL &&
+			    (mp = vp->v_mount) != NULL &&
+			    mp->mnt_op != mnt_op) || !VI_TRYLOCK(vp)) {
+				continue;
+			}
+			TAILQ_REMOVE(&vnode_list, mvp, v_vnodelist);
+			TAILQ_INSERT_AFTER(&vnode_list, vp, mvp, v_vnodelist);
+			if (__predict_false(vp->v_type == VBAD ||
+			    vp->v_type == VNON)) {
+				VI_UNLOCK(vp);
+				vp = mvp;
+				continue;
+			}
+			vholdl(vp);
 			VI_UNLOCK(vp);
-			continue;
+			batch[nbatch++] = vp;
+			vp = mvp;
 		}
-		vholdl(vp);
-		count--;
+		if (nbatch == 0)
+			break;
+		count -= nbatch;
 		mtx_unlock(&vnode_list_mtx);
-		VI_UNLOCK(vp);
-		vtryrecycle(vp);
-		vdrop(vp);
+		for (i = 0; i < nbatch; i++) {
+			vp = batch[i];
+			vtryrecycle(vp);
+			vdrop(vp);
+		}
 		mtx_lock(&vnode_list_mtx);
-		goto restart;
+		vp = mvp;
 	}
 	return (ocount - count);
 }
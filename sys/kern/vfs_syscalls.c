@@ -4154,6 +4154,134 @@ fail:
 	return (error);
 }
 
+/*
+ * Read a block of directory entries together with the attributes of
+ * each entry, in the style of NFSv4 READDIRPLUS, saving a stat(2) and
+ * its pathname lookup per entry for directory tree scans.  The entries
+ * are returned as struct direntplus records.  The attributes of each
+ * entry are obtained by VFS_VGET() on its d_fileno; filesystems that do
+ * not support VFS_VGET(), or entries whose vnode cannot be obtained,
+ * have the per-entry dp_staterr set instead of failing the whole call.
+ */
+#ifndef _SYS_SYSPROTO_H_
+struct getdirentriesplus_args {
+	int fd;
+	void *buf;
+	size_t count;
+	off_t *basep;
+};
+#endif
+int
+sys_getdirentriesplus(struct thread *td, struct getdirentriesplus_args *uap)
+{
+	struct direntplus dplus;
+	struct dirent *dp;
+	struct file *fp;
+	struct mount *mp;
+	struct vnode *vp;
+	cap_rights_t rights;
+	char *dirbuf, *inp, *outp;
+	ssize_t resid;
+	size_t dircount, outcount, recsize;
+	off_t base;
+	u_int reclen;
+	int error, serror;
+
+	/*
+	 * Size the directory read so that the records, each entry
+	 * expanded by the attribute header, are guaranteed to fit in the
+	 * user buffer, avoiding any need to rewind the directory offset.
+	 */
+	dircount = uap->count / (1 +
+	    howmany(__offsetof(struct direntplus, dp_dirent),
+	    _GENERIC_DIRLEN(1)));
+	if (dircount < _GENERIC_DIRLEN(MAXNAMLEN))
+		return (EINVAL);
+	if (dircount > MAXPHYS)
+		dircount = MAXPHYS;
+
+	/*
+	 * As for fstatat(2), obtaining the attributes of the entries
+	 * requires search permission on the directory, checked once for
+	 * the whole batch, as well as CAP_FSTAT.
+	 */
+	error = getvnode(td, uap->fd,
+	    cap_rights_init(&rights, CAP_READ, CAP_FSTAT), &fp);
+	if (error != 0)
+		return (error);
+	vp = fp->f_vnode;
+	if (vp->v_type != VDIR) {
+		fdrop(fp, td);
+		return (EINVAL);
+	}
+	vn_lock(vp, LK_SHARED | LK_RETRY);
+	error = VOP_ACCESS(vp, VEXEC, td->td_ucred, td);
+	VOP_UNLOCK(vp);
+	if (error != 0) {
+		fdrop(fp, td);
+		return (error);
+	}
+
+	dirbuf = malloc(dircount, M_TEMP, M_WAITOK);
+	error = kern_getdirentries(td, uap->fd, dirbuf, dircount, &base,
+	    &resid, UIO_SYSSPACE);
+	if (error != 0)
+		goto out;
+
+	/*
+	 * Reread the vnode, since a union mount directory switches
+	 * f_vnode to the covered vnode once the upper layer is finished.
+	 */
+	mp = fp->f_vnode->v_mount;
+	inp = dirbuf;
+	outp = uap->buf;
+	outcount = 0;
+	for (resid = dircount - resid; resid > 0; resid -= reclen) {
+		dp = (struct dirent *)inp;
+		reclen = dp->d_reclen;
+		/*
+		 * A record longer than the maximal generic entry cannot
+		 * be valid and would overflow dp_dirent below; treat it
+		 * as a malformed record like the other checks.
+		 */
+		if (reclen == 0 || reclen > resid ||
+		    reclen > _GENERIC_DIRLEN(MAXNAMLEN)) {
+			error = EIO;
+			break;
+		}
+		if (dp->d_fileno != 0) {
+			serror = VFS_VGET(mp, dp->d_fileno, LK_SHARED, &vp);
+			if (serror == 0) {
+				serror = VOP_STAT(vp, &dplus.dp_stat,
+				    td->td_ucred, NOCRED, td);
+				vput(vp);
+			}
+		} else
+			serror = ENOENT;
+		if (serror != 0)
+			bzero(&dplus.dp_stat, sizeof(dplus.dp_stat));
+		dplus.dp_staterr = serror;
+		dplus.dp_pad0 = 0;
+		memcpy(&dplus.dp_dirent, dp, reclen);
+		recsize = __offsetof(struct direntplus, dp_dirent) + reclen;
+		error = copyout(&dplus, outp, recsize);
+		if (error != 0)
+			break;
+		outp += recsize;
+		outcount += recsize;
+		inp += reclen;
+	}
+	if (error == 0) {
+		td->td_retval[0] = outcount;
+		if (uap->basep != NULL)
+			error = copyout(&base, uap->basep, sizeof(off_t));
+	}
+out:
+	free(dirbuf, M_TEMP);
+	fdrop(fp, td);
+	return (error);
+}
+
 /*
  * Set the mode mask for creation of filesystem nodes.
  */
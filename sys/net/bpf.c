@@ -1391,6 +1391,8 @@ bpfioctl(struct cdev *dev, u_long cmd, caddr_t addr, int flags,
 		case BIOCGHDRCMPLT:
 		case BIOCSTSTAMP:
 		case BIOCFEEDBACK:
+		case BIOCGNOBLOCKTAP:
+		case BIOCSNOBLOCKTAP:
 		case FIONREAD:
 		case BIOCLOCK:
 		case BIOCSRTIMEOUT:
@@ -1788,6 +1790,26 @@ bpfioctl(struct cdev *dev, u_long cmd, caddr_t addr, int flags,
 		BPFD_UNLOCK(d);
 		break;
 
+	/*
+	 * Get "non-blocking tap" mode.
+	 */
+	case BIOCGNOBLOCKTAP:
+		BPFD_LOCK(d);
+		*(u_int *)addr = d->bd_nonblocktap;
+		BPFD_UNLOCK(d);
+		break;
+
+	/*
+	 * Set "non-blocking tap" mode.  When enabled, packets arriving
+	 * while the descriptor lock is contended are counted as dropped
+	 * instead of making the datapath wait for the lock.
+	 */
+	case BIOCSNOBLOCKTAP:
+		BPFD_LOCK(d);
+		d->bd_nonblocktap = *(u_int *)addr;
+		BPFD_UNLOCK(d);
+		break;
+
 	case BIOCLOCK:
 		BPFD_LOCK(d);
 		d->bd_locked = 1;
@@ -2226,6 +2248,29 @@ bpf_gettime(struct bintime *bt, int tstype, struct mbuf *m)
 	return (quality);
 }
 
+/*
+ * Acquire the descriptor lock on the tap path.  Descriptors in
+ * non-blocking tap mode (BIOCSNOBLOCKTAP) count the packet as dropped
+ * when the lock is contended instead of making the datapath wait,
+ * either for the reader rotating the buffers or for another CPU
+ * delivering to the same descriptor.  Returns zero if the packet
+ * should be skipped.
+ */
+static __inline int
+bpf_tap_lock(struct bpf_d *d)
+{
+
+	if (__predict_false(d->bd_nonblocktap != 0)) {
+		if (BPFD_TRYLOCK(d) == 0) {
+			counter_u64_add(d->bd_dcount, 1);
+			return (0);
+		}
+		return (1);
+	}
+	BPFD_LOCK(d);
+	return (1);
+}
+
 /*
  * Incoming linkage from device drivers.  Process the packet pkt, of length
  * pktlen, which is stored in a contiguous buffer.  The packet is parsed
@@ -2265,7 +2310,8 @@ bpf_tap(struct bpf_if *bp, u_char *pkt, u_int pktlen)
 			/*
 			 * Filter matches. Let's to acquire write lock.
 			 */
-			BPFD_LOCK(d);
+			if (!bpf_tap_lock(d))
+				continue;
 			counter_u64_add(d->bd_fcount, 1);
 			if (gottime < bpf_ts_quality(d->bd_tstamp))
 				gottime = bpf_gettime(&bt, d->bd_tstamp,
@@ -2325,7 +2371,8 @@ bpf_mtap(struct bpf_if *bp, struct mbuf *m)
 #endif
 		slen = bpf_filter(d->bd_rfilter, (u_char *)m, pktlen, 0);
 		if (slen != 0) {
-			BPFD_LOCK(d);
+			if (!bpf_tap_lock(d))
+				continue;
 
 			counter_u64_add(d->bd_fcount, 1);
 			if (gottime < bpf_ts_quality(d->bd_tstamp))
@@ -2382,7 +2429,8 @@ bpf_mtap2(struct bpf_if *bp, void *data, u_int dlen, struct mbuf *m)
 		counter_u64_add(d->bd_rcount, 1);
 		slen = bpf_filter(d->bd_rfilter, (u_char *)&mb, pktlen, 0);
 		if (slen != 0) {
-			BPFD_LOCK(d);
+			if (!bpf_tap_lock(d))
+				continue;
 
 			counter_u64_add(d->bd_fcount, 1);
 			if (gottime < bpf_ts_quality(d->bd_tstamp))
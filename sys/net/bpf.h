@@ -153,6 +153,8 @@ struct bpf_zbuf {
 #define	BIOCSETFNR	_IOW('B', 130, struct bpf_program)
 #define	BIOCGTSTAMP	_IOR('B', 131, u_int)
 #define	BIOCSTSTAMP	_IOW('B', 132, u_int)
+#define	BIOCGNOBLOCKTAP	_IOR('B', 133, u_int)
+#define	BIOCSNOBLOCKTAP	_IOW('B', 134, u_int)
 
 /* Obsolete */
 #define	BIOCGSEESENT	BIOCGDIRECTION
@@ -89,6 +89,8 @@ struct bpf_d {
 	int		bd_direction;	/* select packet direction */
 	int		bd_tstamp;	/* select time stamping function */
 	int		bd_feedback;	/* true to feed back sent packets */
+	int		bd_nonblocktap;	/* true to drop instead of waiting
+					 * for bd_lock on the tap path */
 	int		bd_async;	/* non-zero if packet reception should generate signal */
 	int		bd_sig;		/* signal to send upon packet reception */
 	struct sigio *	bd_sigio;	/* information for async I/O */
@@ -116,6 +118,7 @@ struct bpf_d {
 #define BPF_TIMED_OUT	2		/* read timeout has expired in select */
 
 #define BPFD_LOCK(bd)		mtx_lock(&(bd)->bd_lock)
+#define BPFD_TRYLOCK(bd)	mtx_trylock(&(bd)->bd_lock)
 #define BPFD_UNLOCK(bd)		mtx_unlock(&(bd)->bd_lock)
 #define BPFD_LOCK_ASSERT(bd)	mtx_assert(&(bd)->bd_lock, MA_OWNED)
 
@@ -887,8 +887,17 @@ lacp_select_tx_port(struct lagg_softc *sc, struct mbuf *m)
 	if ((sc->sc_opts & LAGG_OPT_USE_FLOWID) &&
 	    M_HASHTYPE_GET(m) != M_HASHTYPE_NONE)
 		hash = m->m_pkthdr.flowid >> sc->flowid_shift;
-	else
+	else {
 		hash = m_ether_tcpip_hash(sc->sc_flags, m, lsc->lsc_hashkey);
+		/*
+		 * Record the hash in the mbuf so that the member
+		 * port's driver and any stacked lagg select their
+		 * transmit queue from it instead of parsing the
+		 * headers again.
+		 */
+		m->m_pkthdr.flowid = hash;
+		M_HASHTYPE_SET(m, M_HASHTYPE_OPAQUE_HASH);
+	}
 
 	numa_domain = m->m_pkthdr.numa_domain;
 	return (lacp_select_tx_port_by_hash(sc, hash, numa_domain));
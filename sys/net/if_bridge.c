@@ -2738,8 +2738,21 @@ bridge_rtupdate(struct bridge_softc *sc, const uint8_t *dst, uint16_t vlan,
 		BRIDGE_UNLOCK(sc);
 	}
 
-	if ((flags & IFBAF_TYPEMASK) == IFBAF_DYNAMIC)
-		brt->brt_expire = time_uptime + sc->sc_brttimeout;
+	if ((flags & IFBAF_TYPEMASK) == IFBAF_DYNAMIC) {
+		unsigned long expire;
+
+		/*
+		 * The expiration time is refreshed for every packet
+		 * received from this source, possibly by every RSS
+		 * queue delivering into the bridge.  time_uptime has a
+		 * one second granularity, so skip stores that would
+		 * not change the value and keep the cache line shared
+		 * between the forwarding threads.
+		 */
+		expire = time_uptime + sc->sc_brttimeout;
+		if (brt->brt_expire != expire)
+			brt->brt_expire = expire;
+	}
 	if (setflags)
 		brt->brt_flags = flags;
 
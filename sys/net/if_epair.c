@@ -138,6 +138,19 @@ SYSCTL_PROC(_net_link_epair, OID_AUTO, netisr_maxqlen,
     sysctl_epair_netisr_maxqlen, "I",
     "Maximum if_epair(4) netisr \"hw\" queue length");
 
+/*
+ * By default all packets of an epair are processed by the single netisr
+ * CPU assigned at creation time.  With mq_enable set, packets carrying
+ * a flow hash are spread over all netisr CPUs instead, so traffic
+ * between jail-dense pairs scales with cores like a multiqueue NIC.
+ * In this mode a netisr queue overflow drops the packet, as a NIC ring
+ * overflow would, rather than engaging the single-CPU drain machinery.
+ */
+static int epair_mq_enable = 0;
+SYSCTL_INT(_net_link_epair, OID_AUTO, mq_enable, CTLFLAG_RWTUN,
+    &epair_mq_enable, 0,
+    "Spread if_epair(4) netisr processing by mbuf flow hash");
+
 struct epair_softc {
 	struct ifnet	*ifp;		/* This ifp. */
 	struct ifnet	*oifp;		/* other ifp of pair. */
@@ -251,6 +264,22 @@ cpuid_from_ifp(struct ifnet *ifp)
 	return (sc->cpuid);
 }
 
+/*
+ * Pick the netisr CPU for a packet: the flow hash when multiqueue mode
+ * is enabled and the sender provided one, the interface's static CPU
+ * otherwise.  This must be deterministic per mbuf as it is evaluated
+ * both on the transmit side and by the netisr m2cpuid callback.
+ */
+static u_int
+epair_m2cpuid(struct mbuf *m)
+{
+
+	if (epair_mq_enable != 0 &&
+	    M_HASHTYPE_GET(m) != M_HASHTYPE_NONE)
+		return (netisr_get_cpuid(m->m_pkthdr.flowid));
+	return (cpuid_from_ifp(m->m_pkthdr.rcvif));
+}
+
 /*
  * Netisr handler functions.
  */
@@ -274,7 +303,7 @@ static struct mbuf *
 epair_nh_m2cpuid(struct mbuf *m, uintptr_t source, u_int *cpuid)
 {
 
-	*cpuid = cpuid_from_ifp(m->m_pkthdr.rcvif);
+	*cpuid = epair_m2cpuid(m);
 
 	return (m);
 }
@@ -399,6 +428,7 @@ epair_start_locked(struct ifnet *ifp)
 	struct epair_softc *sc;
 	struct ifnet *oifp;
 	int error;
+	bool spread;
 
 	DPRINTF("ifp=%p\n", ifp);
 	sc = ifp->if_softc;
@@ -441,6 +471,8 @@ epair_start_locked(struct ifnet *ifp)
 		 */
 		EPAIR_REFCOUNT_AQUIRE(&sc->refcount);
 		m->m_pkthdr.rcvif = oifp;
+		spread = epair_mq_enable != 0 &&
+		    M_HASHTYPE_GET(m) != M_HASHTYPE_NONE;
 		CURVNET_SET_QUIET(oifp->if_vnet);
 		error = netisr_queue(NETISR_EPAIR, m);
 		CURVNET_RESTORE();
@@ -448,6 +480,18 @@ epair_start_locked(struct ifnet *ifp)
 			if_inc_counter(ifp, IFCOUNTER_OPACKETS, 1);
 			/* Someone else received the packet. */
 			if_inc_counter(oifp, IFCOUNTER_IPACKETS, 1);
+		} else if (spread) {
+			/*
+			 * The packet was freed already.  A hashed packet
+			 * may have gone to any netisr CPU, so the
+			 * single-CPU drain machinery cannot restart us;
+			 * account the drop like a NIC ring overflow.
+			 */
+			if_inc_counter(ifp, IFCOUNTER_OQDROPS, 1);
+			EPAIR_REFCOUNT_RELEASE(&sc->refcount);
+			EPAIR_REFCOUNT_ASSERT((int)sc->refcount >= 1,
+			    ("%s: ifp=%p sc->refcount not >= 1: %d",
+			    __func__, oifp, sc->refcount));
 		} else {
 			/* The packet was freed already. */
 			epair_dpcpu->epair_drv_flags |= IFF_DRV_OACTIVE;
@@ -481,6 +525,7 @@ epair_transmit_locked(struct ifnet *ifp, struct mbuf *m)
 	struct ifnet *oifp;
 	int error, len;
 	short mflags;
+	bool spread;
 
 	DPRINTF("ifp=%p m=%p\n", ifp, m);
 	sc = ifp->if_softc;
@@ -563,6 +608,8 @@ epair_transmit_locked(struct ifnet *ifp, struct mbuf *m)
 	 */
 	EPAIR_REFCOUNT_AQUIRE(&sc->refcount);
 	m->m_pkthdr.rcvif = oifp;
+	spread = epair_mq_enable != 0 &&
+	    M_HASHTYPE_GET(m) != M_HASHTYPE_NONE;
 	CURVNET_SET_QUIET(oifp->if_vnet);
 	error = netisr_queue(NETISR_EPAIR, m);
 	CURVNET_RESTORE();
@@ -578,6 +625,18 @@ epair_transmit_locked(struct ifnet *ifp, struct mbuf *m)
 			if_inc_counter(ifp, IFCOUNTER_OMCASTS, 1);
 		/* Someone else received the packet. */
 		if_inc_counter(oifp, IFCOUNTER_IPACKETS, 1);
+	} else if (spread) {
+		/*
+		 * The packet was freed already.  A hashed packet may
+		 * have gone to any netisr CPU, so the single-CPU drain
+		 * machinery cannot restart us; account the drop like a
+		 * NIC ring overflow.
+		 */
+		if_inc_counter(ifp, IFCOUNTER_OQDROPS, 1);
+		EPAIR_REFCOUNT_RELEASE(&sc->refcount);
+		EPAIR_REFCOUNT_ASSERT((int)sc->refcount >= 1,
+		    ("%s: ifp=%p sc->refcount not >= 1: %d",
+		    __func__, oifp, sc->refcount));
 	} else {
 		/* The packet was freed already. */
 		epair_dpcpu->epair_drv_flags |= IFF_DRV_OACTIVE;
@@ -813,6 +813,17 @@ ether_input(struct ifnet *ifp, struct mbuf *m)
 		mn = m->m_nextpkt;
 		m->m_nextpkt = NULL;
 
+		/*
+		 * The frame data of the next packet is cache-cold at this
+		 * point.  Start pulling in its header lines now, so that by
+		 * the time ether_demux() parses them the loads have
+		 * overlapped with the processing of the current packet.
+		 * Reading mn->m_data also touches the next mbuf header one
+		 * iteration early, with the same effect.
+		 */
+		if (mn != NULL)
+			__builtin_prefetch(mn->m_data);
+
 		/*
 		 * We will rely on rcvif being set properly in the deferred
 		 * context, so assert it is correct here.
@@ -2303,8 +2303,15 @@ lagg_lb_start(struct lagg_softc *sc, struct mbuf *m)
 	if ((sc->sc_opts & LAGG_OPT_USE_FLOWID) &&
 	    M_HASHTYPE_GET(m) != M_HASHTYPE_NONE)
 		p = m->m_pkthdr.flowid >> sc->flowid_shift;
-	else
+	else {
 		p = m_ether_tcpip_hash(sc->sc_flags, m, lb->lb_key);
+		/*
+		 * Let the member port reuse the hash, see
+		 * lacp_select_tx_port().
+		 */
+		m->m_pkthdr.flowid = p;
+		M_HASHTYPE_SET(m, M_HASHTYPE_OPAQUE_HASH);
+	}
 	p %= sc->sc_count;
 	lp = lb->lb_ports[p];
 
@@ -304,6 +304,13 @@ typedef struct iflib_sw_tx_desc_array {
 
 #define IFLIB_RESTART_BUDGET		8
 
+/* bounds for the occupancy-adapted rx budget */
+#define IFLIB_RX_BUDGET_MIN		16
+#define IFLIB_RX_BUDGET_MAX		256
+
+/* per-freelist cap on clusters recycled from tx completion */
+#define IFLIB_RECYCLE_MAX		256
+
 #define CSUM_OFFLOAD		(CSUM_IP_TSO|CSUM_IP6_TSO|CSUM_IP| \
 				 CSUM_IP_UDP|CSUM_IP_TCP|CSUM_IP_SCTP| \
 				 CSUM_IP6_UDP|CSUM_IP6_TCP|CSUM_IP6_SCTP)
@@ -388,6 +395,11 @@ struct iflib_fl {
 	uint8_t		ifl_id;
 	bus_dma_tag_t	ifl_buf_tag;
 	iflib_dma_info_t	ifl_ifdi;
+	/* clusters recycled from tx completion, pending rx reuse */
+	struct mtx	ifl_recycle_mtx;
+	caddr_t		*ifl_recycle;
+	uint16_t	ifl_recycle_cnt;
+	uint16_t	ifl_recycle_size;
 	uint64_t	ifl_bus_addrs[IFLIB_MAX_RX_REFRESH] __aligned(CACHE_LINE_SIZE);
 	qidx_t		ifl_rxd_idxs[IFLIB_MAX_RX_REFRESH];
 }  __aligned(CACHE_LINE_SIZE);
@@ -427,6 +439,7 @@ struct iflib_rxq {
 	 */
 	qidx_t		ifr_cq_cidx;
 	uint16_t	ifr_id;
+	uint16_t	ifr_budget;	/* adapted rx budget */
 	uint8_t		ifr_nfl;
 	uint8_t		ifr_ntxqirq;
 	uint8_t		ifr_txqid[IFLIB_MAX_TX_SHARED_INTR];
@@ -581,6 +594,12 @@ SYSCTL_INT(_net_iflib, OID_AUTO, min_tx_latency, CTLFLAG_RW,
 static int iflib_no_tx_batch = 0;
 SYSCTL_INT(_net_iflib, OID_AUTO, no_tx_batch, CTLFLAG_RW,
 		   &iflib_no_tx_batch, 0, "minimize transmit latency at the possible expense of throughput");
+static int iflib_rx_budget_adapt = 1;
+SYSCTL_INT(_net_iflib, OID_AUTO, rx_budget_adapt, CTLFLAG_RW,
+		   &iflib_rx_budget_adapt, 0, "scale the rx budget from measured queue occupancy when rx_budget is unset");
+static int iflib_rx_cl_recycle = 0;
+SYSCTL_INT(_net_iflib, OID_AUTO, rx_cl_recycle, CTLFLAG_RW,
+		   &iflib_rx_cl_recycle, 0, "recycle clusters freed by tx completion into the paired rx free lists");
 
 #if IFLIB_DEBUG_COUNTERS
 
@@ -1915,6 +1934,19 @@ iflib_rxsd_alloc(iflib_rxq_t rxq)
 				goto fail;
 			}
 		}
+
+		/* Allocate memory for the cluster recycle stack. */
+		fl->ifl_recycle_size = min(fl->ifl_size, IFLIB_RECYCLE_MAX);
+		if (!(fl->ifl_recycle =
+		      (caddr_t *) malloc(sizeof(caddr_t) *
+					 fl->ifl_recycle_size, M_IFLIB, M_NOWAIT | M_ZERO))) {
+			device_printf(dev,
+			    "Unable to allocate cluster recycle stack memory\n");
+			err = ENOMEM;
+			goto fail;
+		}
+		mtx_init(&fl->ifl_recycle_mtx, "iflib_fl_recycle", NULL,
+		    MTX_DEF);
 	}
 	return (0);
 
@@ -2007,7 +2039,16 @@ iflib_fl_refill(if_ctx_t ctx, iflib_fl_t fl, int count)
 			bit_ffc(fl->ifl_rx_bitmap, fl->ifl_size, &frag_idx);
 		MPASS(frag_idx >= 0);
 		if ((cl = sd_cl[frag_idx]) == NULL) {
-			cl = uma_zalloc(fl->ifl_zone, M_NOWAIT);
+			/* Prefer a recycled cluster over a UMA round trip. */
+			if (fl->ifl_recycle_cnt > 0) {
+				mtx_lock(&fl->ifl_recycle_mtx);
+				if (fl->ifl_recycle_cnt > 0)
+					cl = fl->ifl_recycle[
+					    --fl->ifl_recycle_cnt];
+				mtx_unlock(&fl->ifl_recycle_mtx);
+			}
+			if (cl == NULL)
+				cl = uma_zalloc(fl->ifl_zone, M_NOWAIT);
 			if (__predict_false(cl == NULL))
 				break;
 
@@ -2166,6 +2207,14 @@ iflib_fl_bufs_free(iflib_fl_t fl)
 		MPASS(fl->ifl_sds.ifsd_m[i] == NULL);
 	}
 #endif
+	/* Return recycled clusters; the zone may change on reinit. */
+	if (fl->ifl_recycle != NULL) {
+		mtx_lock(&fl->ifl_recycle_mtx);
+		while (fl->ifl_recycle_cnt > 0)
+			uma_zfree(fl->ifl_zone,
+			    fl->ifl_recycle[--fl->ifl_recycle_cnt]);
+		mtx_unlock(&fl->ifl_recycle_mtx);
+	}
 	/*
 	 * Reset free list values
 	 */
@@ -2268,6 +2317,12 @@ iflib_rx_sds_free(iflib_rxq_t rxq)
 			fl->ifl_sds.ifsd_cl = NULL;
 			fl->ifl_sds.ifsd_ba = NULL;
 			fl->ifl_sds.ifsd_map = NULL;
+			if (fl->ifl_recycle != NULL) {
+				MPASS(fl->ifl_recycle_cnt == 0);
+				mtx_destroy(&fl->ifl_recycle_mtx);
+				free(fl->ifl_recycle, M_IFLIB);
+				fl->ifl_recycle = NULL;
+			}
 		}
 		free(rxq->ifr_fl, M_IFLIB);
 		rxq->ifr_fl = NULL;
@@ -2942,10 +2997,15 @@ iflib_rxeof(iflib_rxq_t rxq, qidx_t budget)
 	if_inc_counter(ifp, IFCOUNTER_IPACKETS, rx_pkts);
 
 	/*
-	 * Flush any outstanding LRO work
+	 * Flush any outstanding LRO work.  If entries were held back
+	 * awaiting their flush deadline (net.inet.tcp.lro.hold_us),
+	 * request the empty-queue watchdog so another pass flushes them
+	 * even if the interrupt stream stops.
 	 */
 #if defined(INET6) || defined(INET)
 	tcp_lro_flush_all(&rxq->ifr_lc);
+	if (tcp_lro_needs_flush(&rxq->ifr_lc))
+		retval |= IFLIB_RXEOF_EMPTY;
 #endif
 	if (avail != 0 || iflib_rxd_avail(ctx, rxq, *cidxp, 1) != 0)
 		retval |= IFLIB_RXEOF_MORE;
@@ -3517,6 +3577,49 @@ defrag_failed:
 	return (ENOMEM);
 }
 
+/*
+ * Offer the clusters of a tx-completed mbuf chain to the paired rx
+ * queue's free lists so the next refill can skip the UMA round trip.
+ * Only sole-owner plain clusters whose type and size match a free list
+ * are taken; everything else is left on the chain for m_freem().
+ * Detaching with the embedded refcount at 1 is safe because no new
+ * reference can appear once the count has dropped to one.
+ */
+static void
+iflib_cl_recycle(iflib_txq_t txq, struct mbuf *m)
+{
+	if_ctx_t ctx = txq->ift_ctx;
+	iflib_rxq_t rxq;
+	iflib_fl_t fl;
+	struct mbuf *n;
+	int i;
+
+	if (txq->ift_id >= NRXQSETS(ctx))
+		return;
+	rxq = &ctx->ifc_rxqs[txq->ift_id];
+	for (n = m; n != NULL; n = n->m_next) {
+		if ((n->m_flags & M_EXT) == 0 ||
+		    n->m_ext.ext_flags != EXT_FLAG_EMBREF ||
+		    n->m_ext.ext_count != 1)
+			continue;
+		for (i = 0, fl = rxq->ifr_fl; i < rxq->ifr_nfl; i++, fl++) {
+			if (fl->ifl_recycle == NULL ||
+			    n->m_ext.ext_type != fl->ifl_cltype ||
+			    n->m_ext.ext_size != fl->ifl_buf_size)
+				continue;
+			mtx_lock(&fl->ifl_recycle_mtx);
+			if (fl->ifl_recycle_cnt < fl->ifl_recycle_size) {
+				fl->ifl_recycle[fl->ifl_recycle_cnt++] =
+				    n->m_ext.ext_buf;
+				/* m_free() now frees only the mbuf. */
+				n->m_flags &= ~M_EXT;
+			}
+			mtx_unlock(&fl->ifl_recycle_mtx);
+			break;
+		}
+	}
+}
+
 static void
 iflib_tx_desc_free(iflib_txq_t txq, int n)
 {
@@ -3553,6 +3656,8 @@ iflib_tx_desc_free(iflib_txq_t txq, int n)
 			}
 			/* XXX we don't support any drivers that batch packets yet */
 			MPASS(m->m_nextpkt == NULL);
+			if (iflib_rx_cl_recycle)
+				iflib_cl_recycle(txq, m);
 			m_freem(m);
 			ifsd_m[cidx] = NULL;
 #if MEMORY_LOGGING
@@ -3722,7 +3827,17 @@ iflib_txq_drain(struct ifmp_ring *r, uint32_t cidx, uint32_t pidx)
 		ETHER_BPF_MTAP(ifp, m);
 		if (__predict_false(!(ifp->if_drv_flags & IFF_DRV_RUNNING)))
 			break;
-		rang = iflib_txd_db_check(ctx, txq, false, in_use_prev);
+		/*
+		 * Defer the doorbell while more packets from this batch
+		 * remain to be encapsulated; the check after the loop
+		 * flushes whatever is still pending.  With a lightly
+		 * occupied descriptor ring the occupancy-scaled deferral
+		 * bound drops to zero and ringing here would cost one
+		 * MMIO write per packet, without any latency benefit
+		 * since the rest of the batch is already in hand.
+		 */
+		if (i + 1 == count)
+			rang = iflib_txd_db_check(ctx, txq, false, in_use_prev);
 	}
 
 	/* deliberate use of bitwise or to avoid gratuitous short-circuit */
@@ -3852,9 +3967,29 @@ _task_fn_rx(void *context)
 	}
 #endif
 	budget = ctx->ifc_sysctl_rx_budget;
-	if (budget == 0)
-		budget = 16;	/* XXX */
+	if (budget == 0) {
+		if (iflib_rx_budget_adapt) {
+			budget = rxq->ifr_budget;
+			if (budget < IFLIB_RX_BUDGET_MIN)
+				budget = IFLIB_RX_BUDGET_MIN;
+		} else
+			budget = 16;	/* XXX */
+	}
 	more = iflib_rxeof(rxq, budget);
+	if (iflib_rx_budget_adapt && ctx->ifc_sysctl_rx_budget == 0) {
+		/*
+		 * Adapt the next budget to the measured occupancy: an
+		 * exhausted budget means the ring is running ahead of
+		 * us, so grow multiplicatively to drain it in fewer
+		 * passes; otherwise decay back towards the floor so an
+		 * idle queue keeps its low per-pass latency.
+		 */
+		if (more & IFLIB_RXEOF_MORE)
+			budget = min(budget << 1, IFLIB_RX_BUDGET_MAX);
+		else
+			budget = max(budget >> 1, IFLIB_RX_BUDGET_MIN);
+		rxq->ifr_budget = budget;
+	}
 #ifdef DEV_NETMAP
 skip_rxeof:
 #endif
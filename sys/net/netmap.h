@@ -535,6 +535,12 @@ enum {
 	NETMAP_REQ_SYNC_KLOOP_STOP,
 	/* Enable CSB mode on a registered netmap control device. */
 	NETMAP_REQ_CSB_ENABLE,
+	/* Install a classic BPF program as the lookup function of a
+	 * VALE switch, replacing the default learning bridge. */
+	NETMAP_REQ_VALE_BPF_SET,
+	/* Remove the BPF lookup program from a VALE switch, restoring
+	 * the default learning bridge. */
+	NETMAP_REQ_VALE_BPF_CLEAR,
 };
 
 enum {
@@ -726,6 +732,22 @@ struct nmreq_vale_polling {
 	uint32_t	pad1;
 };
 
+/*
+ * nr_reqtype: NETMAP_REQ_VALE_BPF_SET
+ * Install a classic BPF program as the lookup function of the VALE
+ * switch named by hdr.nr_name.  The program runs on each frame in place
+ * of the learning bridge and its return value selects the destination:
+ * a port index, NETMAP_VALE_BPF_BROADCAST to forward to all ports, or
+ * any larger value to drop the frame.
+ */
+struct nmreq_vale_bpf {
+	uint64_t	nr_prog;	/* (in) ptr to array of struct bpf_insn */
+	uint32_t	nr_num_insns;	/* (in) program length, in instructions */
+	uint32_t	pad1;
+};
+#define NETMAP_VALE_BPF_BROADCAST	254	/* matches NM_BDG_BROADCAST */
+#define NETMAP_VALE_BPF_DROP		255	/* matches NM_BDG_NOPORT */
+
 /*
  * nr_reqtype: NETMAP_REQ_POOLS_INFO_GET
  * Get info about the pools of the memory allocator of the netmap
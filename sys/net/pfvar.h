@@ -512,9 +512,9 @@ struct pf_rule {
 	TAILQ_ENTRY(pf_rule)	 entries;
 	struct pf_pool		 rpool;
 
-	u_int64_t		 evaluations;
-	u_int64_t		 packets[2];
-	u_int64_t		 bytes[2];
+	counter_u64_t		 evaluations;
+	counter_u64_t		 packets[2];
+	counter_u64_t		 bytes[2];
 
 	struct pfi_kif		*kif;
 	struct pf_anchor	*anchor;
@@ -599,6 +599,9 @@ struct pf_rule {
 	uint64_t		 u_states_cur;
 	uint64_t		 u_states_tot;
 	uint64_t		 u_src_nodes;
+	uint64_t		 u_evaluations;
+	uint64_t		 u_packets[2];
+	uint64_t		 u_bytes[2];
 };
 
 /* rule flags */
@@ -1580,20 +1583,25 @@ struct pf_ifspeed_v1 {
 
 #ifdef _KERNEL
 LIST_HEAD(pf_src_node_list, pf_src_node);
+/*
+ * The hash rows are sized to a full cache line so that the row locks,
+ * which are taken for every packet, are never dragged around by
+ * updates of a neighbouring row.
+ */
 struct pf_srchash {
 	struct pf_src_node_list		nodes;
 	struct mtx			lock;
-};
+} __aligned(CACHE_LINE_SIZE);
 
 struct pf_keyhash {
 	LIST_HEAD(, pf_state_key)	keys;
 	struct mtx			lock;
-};
+} __aligned(CACHE_LINE_SIZE);
 
 struct pf_idhash {
 	LIST_HEAD(, pf_state)		states;
 	struct mtx			lock;
-};
+} __aligned(CACHE_LINE_SIZE);
 
 extern u_long		pf_hashmask;
 extern u_long		pf_srchashmask;
@@ -39,6 +39,7 @@ __FBSDID("$FreeBSD$");
 #endif
 
 #include <sys/param.h>
+#include <sys/counter.h>
 #include <sys/mbuf.h>
 #include <sys/socket.h>
 #include <sys/priv.h>
@@ -177,6 +178,13 @@ struct rss_table_entry {
 };
 static struct rss_table_entry	rss_table[RSS_TABLE_MAXLEN];
 
+/*
+ * Per-bucket packet counters, exported via net.inet.rss.bucket_packets.
+ * A userland daemon can watch these to spot overloaded buckets and move
+ * them to less busy CPUs through net.inet.rss.bucket_rebalance.
+ */
+static counter_u64_t	rss_bucket_pkts[RSS_TABLE_MAXLEN];
+
 static void
 rss_init(__unused void *arg)
 {
@@ -257,6 +265,9 @@ rss_init(__unused void *arg)
 		cpuid = CPU_NEXT(cpuid);
 	}
 
+	for (i = 0; i < RSS_TABLE_MAXLEN; i++)
+		rss_bucket_pkts[i] = counter_u64_alloc(M_WAITOK);
+
 	/*
 	 * Randomize rrs_key.
 	 *
@@ -357,6 +368,8 @@ u_int
 rss_hash2cpuid(uint32_t hash_val, uint32_t hash_type)
 {
 
+	u_int bucket;
+
 	switch (hash_type) {
 	case M_HASHTYPE_RSS_IPV4:
 	case M_HASHTYPE_RSS_TCP_IPV4:
@@ -364,7 +377,9 @@ rss_hash2cpuid(uint32_t hash_val, uint32_t hash_type)
 	case M_HASHTYPE_RSS_IPV6:
 	case M_HASHTYPE_RSS_TCP_IPV6:
 	case M_HASHTYPE_RSS_UDP_IPV6:
-		return (rss_getcpu(rss_getbucket(hash_val)));
+		bucket = rss_getbucket(hash_val);
+		counter_u64_add(rss_bucket_pkts[bucket], 1);
+		return (rss_getcpu(bucket));
 	default:
 		return (NETISR_CPUID_NONE);
 	}
@@ -552,3 +567,71 @@ sysctl_rss_bucket_mapping(SYSCTL_HANDLER_ARGS)
 SYSCTL_PROC(_net_inet_rss, OID_AUTO, bucket_mapping,
     CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 0,
     sysctl_rss_bucket_mapping, "", "RSS bucket -> CPU mapping");
+
+static int
+sysctl_rss_bucket_packets(SYSCTL_HANDLER_ARGS)
+{
+	struct sbuf *sb;
+	int error;
+	int i;
+
+	error = sysctl_wire_old_buffer(req, 0);
+	if (error != 0)
+		return (error);
+	sb = sbuf_new_for_sysctl(NULL, NULL, 32 * rss_buckets, req);
+	if (sb == NULL)
+		return (ENOMEM);
+	for (i = 0; i < rss_buckets; i++) {
+		sbuf_printf(sb, "%s%d:%ju", i == 0 ? "" : " ", i,
+		    (uintmax_t)counter_u64_fetch(rss_bucket_pkts[i]));
+	}
+	error = sbuf_finish(sb);
+	sbuf_delete(sb);
+
+	return (error);
+}
+SYSCTL_PROC(_net_inet_rss, OID_AUTO, bucket_packets,
+    CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE, NULL, 0,
+    sysctl_rss_bucket_packets, "", "RSS bucket packet counters");
+
+/*
+ * Rewrite indirection table entries at runtime.  The input is one or
+ * more space-separated "bucket:cpu" pairs, mirroring the format of the
+ * bucket_mapping sysctl.  Entry stores are single-byte and thus atomic
+ * with respect to concurrent rss_getcpu() calls; packets already queued
+ * to the old CPU's netisr are simply completed there.  Connection group
+ * membership is keyed by bucket, not CPU, so lookups are unaffected by
+ * a remap.
+ */
+static int
+sysctl_rss_bucket_rebalance(SYSCTL_HANDLER_ARGS)
+{
+	char buf[RSS_TABLE_MAXLEN * sizeof("128:256 ")];
+	char *s, *tok;
+	u_int bucket, cpuid;
+	int error;
+
+	buf[0] = '\0';
+	error = sysctl_handle_string(oidp, buf, sizeof(buf), req);
+	if (error != 0 || req->newptr == NULL)
+		return (error);
+	s = buf;
+	while ((tok = strsep(&s, " ,")) != NULL) {
+		if (*tok == '\0')
+			continue;
+		if (sscanf(tok, "%u:%u", &bucket, &cpuid) != 2)
+			return (EINVAL);
+		if (bucket >= rss_buckets)
+			return (EINVAL);
+		if (cpuid > mp_maxid || cpuid > UINT8_MAX ||
+		    CPU_ABSENT(cpuid))
+			return (EINVAL);
+		rss_table[bucket].rte_cpu = cpuid;
+	}
+
+	return (0);
+}
+SYSCTL_PROC(_net_inet_rss, OID_AUTO, bucket_rebalance,
+    CTLTYPE_STRING | CTLFLAG_WR | CTLFLAG_MPSAFE, NULL, 0,
+    sysctl_rss_bucket_rebalance, "",
+    "Remap RSS buckets to CPUs (\"bucket:cpu ...\")");
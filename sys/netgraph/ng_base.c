@@ -1963,20 +1963,25 @@ ng_dequeue(node_p node, int *rw)
 	 * the current state of the node.
 	 */
 	if (HEAD_IS_READER(ngq)) {
-		while (1) {
-			long t = ngq->q_flags;
-			if (t & WRITER_ACTIVE) {
-				/* There is writer, reader can't proceed. */
-				CTR4(KTR_NET, "%20s: node [%x] (%p) queued "
-				    "reader can't proceed; queue flags 0x%lx",
-				    __func__, node->nd_ID, node, t);
-				return (NULL);
-			}
-			if (atomic_cmpset_acq_int(&ngq->q_flags, t,
-			    t + READER_INCREMENT))
-				break;
-			cpu_spinwait();
+		long t;
+
+		/*
+		 * Optimistically take a reader reference with a single
+		 * atomic add; unlike a cmpset loop this cannot be
+		 * starved by readers arriving on other CPUs.  If a
+		 * writer turned out to be active, back the reference
+		 * out again.
+		 */
+		t = atomic_fetchadd_int(&ngq->q_flags, READER_INCREMENT);
+		if (t & WRITER_ACTIVE) {
+			atomic_subtract_int(&ngq->q_flags, READER_INCREMENT);
+			/* There is writer, reader can't proceed. */
+			CTR4(KTR_NET, "%20s: node [%x] (%p) queued "
+			    "reader can't proceed; queue flags 0x%lx",
+			    __func__, node->nd_ID, node, t);
+			return (NULL);
 		}
+		atomic_thread_fence_acq();
 		/* We have got reader lock for the node. */
 		*rw = NGQRW_R;
 	} else if (atomic_cmpset_acq_int(&ngq->q_flags, OP_PENDING,
@@ -2040,24 +2045,40 @@ ng_queue_rw(node_p node, item_p  item, int rw)
 static __inline item_p
 ng_acquire_read(node_p node, item_p item)
 {
+	long t;
+
 	KASSERT(node != &ng_deadnode,
 	    ("%s: working on deadnode", __func__));
 
-	/* Reader needs node without writer and pending items. */
-	for (;;) {
-		long t = node->nd_input_queue.q_flags;
-		if (t & NGQ_RMASK)
-			break; /* Node is not ready for reader. */
-		if (atomic_cmpset_acq_int(&node->nd_input_queue.q_flags, t,
-		    t + READER_INCREMENT)) {
-	    		/* Successfully grabbed node */
-			CTR4(KTR_NET, "%20s: node [%x] (%p) acquired item %p",
-			    __func__, node->nd_ID, node, item);
-			return (item);
-		}
-		cpu_spinwait();
+	/*
+	 * Reader needs node without writer and pending items.
+	 *
+	 * Optimistically take the reader reference with a single atomic
+	 * add.  Unlike a cmpset loop, this cannot be starved by other
+	 * readers arriving on other CPUs, which is what serializes data
+	 * forwarding through busy nodes at high pps.  A writer cannot
+	 * slip in underneath us: it requires the flag word to be
+	 * completely idle, and our increment is already visible.
+	 */
+	t = atomic_fetchadd_int(&node->nd_input_queue.q_flags,
+	    READER_INCREMENT);
+	if ((t & NGQ_RMASK) == 0) {
+		/* Successfully grabbed node */
+		atomic_thread_fence_acq();
+		CTR4(KTR_NET, "%20s: node [%x] (%p) acquired item %p",
+		    __func__, node->nd_ID, node, item);
+		return (item);
 	}
 
+	/*
+	 * Node is not ready for a reader.  Back our reference out
+	 * before queueing, so that the worklist check done under the
+	 * queue mutex by ng_queue_rw() does not see it and conclude
+	 * that a queued writer still cannot proceed.
+	 */
+	atomic_subtract_int(&node->nd_input_queue.q_flags,
+	    READER_INCREMENT);
+
 	/* Queue the request for later. */
 	ng_queue_rw(node, item, NGQRW_R);
 
@@ -490,6 +490,8 @@ __END_DECLS
 #define	MCAST_LEAVE_SOURCE_GROUP	83   /* leave a single source */
 #define	MCAST_BLOCK_SOURCE		84   /* block a source */
 #define	MCAST_UNBLOCK_SOURCE		85   /* unblock a source */
+#define	MCAST_JOIN_GROUPS		86   /* join an array of groups */
+#define	MCAST_LEAVE_GROUPS		87   /* leave an array of groups */
 
 /* Flow and RSS definitions */
 #define	IP_FLOWID		90   /* get flow id for the given socket/inp */
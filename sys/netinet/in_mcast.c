@@ -167,7 +167,12 @@ static void inm_release(struct in_multi *);
 static struct ip_moptions *
 		inp_findmoptions(struct inpcb *);
 static int	inp_get_source_filters(struct inpcb *, struct sockopt *);
+static int	inp_do_join_group(struct inpcb *, struct ifnet *,
+		    struct group_source_req *);
+static int	inp_do_leave_group(struct inpcb *, struct ifnet *,
+		    struct group_source_req *);
 static int	inp_join_group(struct inpcb *, struct sockopt *);
+static int	inp_join_leave_groups(struct inpcb *, struct sockopt *);
 static int	inp_leave_group(struct inpcb *, struct sockopt *);
 static struct ifnet *
 		inp_lookup_mcast_ifp(const struct inpcb *,
@@ -1962,14 +1967,9 @@ inp_join_group(struct inpcb *inp, struct sockopt *sopt)
 	struct group_source_req		 gsr;
 	sockunion_t			*gsa, *ssa;
 	struct ifnet			*ifp;
-	struct in_mfilter		*imf;
-	struct ip_moptions		*imo;
-	struct in_multi			*inm;
-	struct in_msource		*lims;
-	int				 error, is_new;
+	int				 error;
 
 	ifp = NULL;
-	lims = NULL;
 	error = 0;
 
 	memset(&gsr, 0, sizeof(struct group_source_req));
@@ -2075,6 +2075,30 @@ inp_join_group(struct inpcb *inp, struct sockopt *sopt)
 		break;
 	}
 
+	return (inp_do_join_group(inp, ifp, &gsr));
+}
+
+/*
+ * Inner part of inp_join_group(), run once the request has been parsed
+ * into a group_source_req and the interface resolved.  Shared with the
+ * vectored join path.
+ */
+static int
+inp_do_join_group(struct inpcb *inp, struct ifnet *ifp,
+    struct group_source_req *gsr)
+{
+	sockunion_t			*gsa, *ssa;
+	struct in_mfilter		*imf;
+	struct ip_moptions		*imo;
+	struct in_multi			*inm;
+	struct in_msource		*lims;
+	int				 error, is_new;
+
+	lims = NULL;
+	error = 0;
+	gsa = (sockunion_t *)&gsr->gsr_group;
+	ssa = (sockunion_t *)&gsr->gsr_source;
+
 	if (ifp == NULL || (ifp->if_flags & IFF_MULTICAST) == 0)
 		return (EADDRNOTAVAIL);
 
@@ -2279,16 +2303,10 @@ inp_leave_group(struct inpcb *inp, struct sockopt *sopt)
 	struct rm_priotracker		 in_ifa_tracker;
 	sockunion_t			*gsa, *ssa;
 	struct ifnet			*ifp;
-	struct in_mfilter		*imf;
-	struct ip_moptions		*imo;
-	struct in_msource		*ims;
-	struct in_multi			*inm;
 	int				 error;
-	bool				 is_final;
 
 	ifp = NULL;
 	error = 0;
-	is_final = true;
 
 	memset(&gsr, 0, sizeof(struct group_source_req));
 	gsa = (sockunion_t *)&gsr.gsr_group;
@@ -2385,6 +2403,31 @@ inp_leave_group(struct inpcb *inp, struct sockopt *sopt)
 		break;
 	}
 
+	return (inp_do_leave_group(inp, ifp, &gsr));
+}
+
+/*
+ * Inner part of inp_leave_group(), run once the request has been parsed
+ * into a group_source_req and the interface resolved.  Shared with the
+ * vectored leave path.
+ */
+static int
+inp_do_leave_group(struct inpcb *inp, struct ifnet *ifp,
+    struct group_source_req *gsr)
+{
+	sockunion_t			*gsa, *ssa;
+	struct in_mfilter		*imf;
+	struct ip_moptions		*imo;
+	struct in_msource		*ims;
+	struct in_multi			*inm;
+	int				 error;
+	bool				 is_final;
+
+	error = 0;
+	is_final = true;
+	gsa = (sockunion_t *)&gsr->gsr_group;
+	ssa = (sockunion_t *)&gsr->gsr_source;
+
 	if (!IN_MULTICAST(ntohl(gsa->sin.sin_addr.s_addr)))
 		return (EINVAL);
 
@@ -2483,6 +2526,91 @@ out_inp_locked:
 	return (error);
 }
 
+/*
+ * Join or leave an array of IPv4 multicast groups in a single
+ * operation.
+ *
+ * The option value is an array of struct group_req, as used by
+ * MCAST_JOIN_GROUP and MCAST_LEAVE_GROUP.  The whole request is copied
+ * in once and the memberships are processed without further round
+ * trips to userland, which matters to consumers subscribing to
+ * thousands of groups at start-up.  Processing stops at the first
+ * failure; memberships already established by the call are left in
+ * place, matching the state reached by issuing the same requests one
+ * setsockopt at a time.
+ */
+static int
+inp_join_leave_groups(struct inpcb *inp, struct sockopt *sopt)
+{
+	struct epoch_tracker	 et;
+	struct group_source_req	 gsr;
+	struct group_req	*greqs;
+	sockunion_t		*gsa;
+	struct ifnet		*ifp;
+	size_t			 count, i;
+	int			 error;
+
+	if (sopt->sopt_valsize == 0 ||
+	    sopt->sopt_valsize % sizeof(struct group_req) != 0)
+		return (EINVAL);
+	count = sopt->sopt_valsize / sizeof(struct group_req);
+	if (count > IP_MAX_MEMBERSHIPS)
+		return (EINVAL);
+
+	greqs = malloc(count * sizeof(struct group_req), M_TEMP, M_WAITOK);
+	error = sooptcopyin(sopt, greqs, count * sizeof(struct group_req),
+	    count * sizeof(struct group_req));
+	if (error)
+		goto out;
+
+	for (i = 0; i < count; i++) {
+		memset(&gsr, 0, sizeof(struct group_source_req));
+		memcpy(&gsr.gsr_group, &greqs[i].gr_group,
+		    sizeof(gsr.gsr_group));
+		gsr.gsr_source.ss_family = AF_UNSPEC;
+
+		gsa = (sockunion_t *)&gsr.gsr_group;
+		if (gsa->sin.sin_family != AF_INET ||
+		    gsa->sin.sin_len != sizeof(struct sockaddr_in)) {
+			error = EINVAL;
+			break;
+		}
+		/*
+		 * Overwrite the port field if present, as the sockaddr
+		 * being copied in may be matched with a binary comparison.
+		 */
+		gsa->sin.sin_port = 0;
+		if (!IN_MULTICAST(ntohl(gsa->sin.sin_addr.s_addr))) {
+			error = EINVAL;
+			break;
+		}
+
+		if (greqs[i].gr_interface == 0 ||
+		    V_if_index < greqs[i].gr_interface) {
+			error = EADDRNOTAVAIL;
+			break;
+		}
+		ifp = ifnet_byindex(greqs[i].gr_interface);
+		if (ifp == NULL) {
+			error = EADDRNOTAVAIL;
+			break;
+		}
+
+		if (sopt->sopt_name == MCAST_JOIN_GROUPS) {
+			NET_EPOCH_ENTER(et);
+			error = inp_do_join_group(inp, ifp, &gsr);
+			NET_EPOCH_EXIT(et);
+		} else
+			error = inp_do_leave_group(inp, ifp, &gsr);
+		if (error)
+			break;
+	}
+
+out:
+	free(greqs, M_TEMP);
+	return (error);
+}
+
 /*
  * Select the interface for transmitting IPv4 multicast datagrams.
  *
@@ -2859,6 +2987,11 @@ inp_setmoptions(struct inpcb *inp, struct sockopt *sopt)
 		error = inp_leave_group(inp, sopt);
 		break;
 
+	case MCAST_JOIN_GROUPS:
+	case MCAST_LEAVE_GROUPS:
+		error = inp_join_leave_groups(inp, sopt);
+		break;
+
 	case IP_BLOCK_SOURCE:
 	case IP_UNBLOCK_SOURCE:
 	case MCAST_BLOCK_SOURCE:
@@ -235,6 +235,40 @@ SYSCTL_COUNTER_U64(_net_inet_ip_rl, OID_AUTO, set_ok, CTLFLAG_RD,
    &rate_limit_set_ok, "Rate limited setting succeeded");
 #endif /* RATELIMIT */
 
+/*
+ * Statistics for the hashed connection lookup path.  Lookups run
+ * lock-free within the network epoch; these counters make the split
+ * between the fast paths (exact and lbgroup matches) and the slow
+ * wildcard scan visible.
+ */
+static counter_u64_t in_pcblookup_exact;
+static counter_u64_t in_pcblookup_lbgroup;
+static counter_u64_t in_pcblookup_wild;
+static counter_u64_t in_pcblookup_miss;
+
+static SYSCTL_NODE(_net_inet_ip, OID_AUTO, pcblookup,
+    CTLFLAG_RD | CTLFLAG_MPSAFE, 0, "PCB hash lookup statistics");
+SYSCTL_COUNTER_U64(_net_inet_ip_pcblookup, OID_AUTO, exact, CTLFLAG_RD,
+    &in_pcblookup_exact, "Lookups answered by an exact four-tuple match");
+SYSCTL_COUNTER_U64(_net_inet_ip_pcblookup, OID_AUTO, lbgroup, CTLFLAG_RD,
+    &in_pcblookup_lbgroup, "Lookups answered by a load-balance group");
+SYSCTL_COUNTER_U64(_net_inet_ip_pcblookup, OID_AUTO, wild, CTLFLAG_RD,
+    &in_pcblookup_wild, "Lookups answered by the wildcard scan");
+SYSCTL_COUNTER_U64(_net_inet_ip_pcblookup, OID_AUTO, miss, CTLFLAG_RD,
+    &in_pcblookup_miss, "Lookups that matched no PCB");
+
+static void
+in_pcblookup_stats_init(void *st __unused)
+{
+
+	in_pcblookup_exact = counter_u64_alloc(M_WAITOK);
+	in_pcblookup_lbgroup = counter_u64_alloc(M_WAITOK);
+	in_pcblookup_wild = counter_u64_alloc(M_WAITOK);
+	in_pcblookup_miss = counter_u64_alloc(M_WAITOK);
+}
+SYSINIT(in_pcblookup_stats, SI_SUB_PROTO_DOMAININIT, SI_ORDER_ANY,
+    in_pcblookup_stats_init, NULL);
+
 #endif /* INET */
 
 /*
@@ -2323,14 +2357,18 @@ in_pcblookup_hash_locked(struct inpcbinfo *pcbinfo, struct in_addr faddr,
 			 * the inp here, without any checks.
 			 * Well unless both bound with SO_REUSEPORT?
 			 */
-			if (prison_flag(inp->inp_cred, PR_IP4))
+			if (prison_flag(inp->inp_cred, PR_IP4)) {
+				counter_u64_add(in_pcblookup_exact, 1);
 				return (inp);
+			}
 			if (tmpinp == NULL)
 				tmpinp = inp;
 		}
 	}
-	if (tmpinp != NULL)
+	if (tmpinp != NULL) {
+		counter_u64_add(in_pcblookup_exact, 1);
 		return (tmpinp);
+	}
 
 	/*
 	 * Then look in lb group (for wildcard match).
@@ -2338,8 +2376,10 @@ in_pcblookup_hash_locked(struct inpcbinfo *pcbinfo, struct in_addr faddr,
 	if ((lookupflags & INPLOOKUP_WILDCARD) != 0) {
 		inp = in_pcblookup_lbgroup(pcbinfo, &laddr, lport, &faddr,
 		    fport, lookupflags);
-		if (inp != NULL)
+		if (inp != NULL) {
+			counter_u64_add(in_pcblookup_lbgroup, 1);
 			return (inp);
+		}
 	}
 
 	/*
@@ -2384,9 +2424,10 @@ in_pcblookup_hash_locked(struct inpcbinfo *pcbinfo, struct in_addr faddr,
 			}
 
 			if (inp->inp_laddr.s_addr == laddr.s_addr) {
-				if (injail)
+				if (injail) {
+					counter_u64_add(in_pcblookup_wild, 1);
 					return (inp);
-				else
+				} else
 					local_exact = inp;
 			} else if (inp->inp_laddr.s_addr == INADDR_ANY) {
 #ifdef INET6
@@ -2402,17 +2443,24 @@ in_pcblookup_hash_locked(struct inpcbinfo *pcbinfo, struct in_addr faddr,
 			}
 		} /* LIST_FOREACH */
 		if (jail_wild != NULL)
-			return (jail_wild);
-		if (local_exact != NULL)
-			return (local_exact);
-		if (local_wild != NULL)
-			return (local_wild);
+			inp = jail_wild;
+		else if (local_exact != NULL)
+			inp = local_exact;
+		else if (local_wild != NULL)
+			inp = local_wild;
 #ifdef INET6
-		if (local_wild_mapped != NULL)
-			return (local_wild_mapped);
+		else if (local_wild_mapped != NULL)
+			inp = local_wild_mapped;
 #endif
+		else
+			inp = NULL;
+		if (inp != NULL) {
+			counter_u64_add(in_pcblookup_wild, 1);
+			return (inp);
+		}
 	} /* if ((lookupflags & INPLOOKUP_WILDCARD) != 0) */
 
+	counter_u64_add(in_pcblookup_miss, 1);
 	return (NULL);
 }
 
@@ -2919,6 +2967,87 @@ so_sototcpcb(struct socket *so)
 	return (sototcpcb(so));
 }
 
+/*
+ * Batch size (in PCBs) of the incremental pcblist export.  This bounds
+ * both the wired copyout buffer and the work done in one epoch section.
+ */
+#define	INP_PCBLIST_BATCH	4096
+
+/*
+ * Incremental, epoch-protected variant of the pcblist export, shared by
+ * the protocol pcblist_batch sysctl handlers.  The consumer passes the
+ * inp_gencnt of the last PCB of the previous batch as the new value
+ * (zero to start from the beginning) and receives the next batch of
+ * exported PCBs; an empty reply marks the end of the list.
+ *
+ * PCBs are inserted at the head of ipi_listhead with a monotonically
+ * increasing generation count, so the list is ordered by descending
+ * inp_gencnt and the generation count is a stable cursor: PCBs created
+ * after a batch was taken sort in front of the cursor and are skipped,
+ * while PCBs freed in between simply disappear from the list.  Resuming
+ * is a read-only walk to the cursor position; no table-wide lock is
+ * taken at any point.
+ *
+ * The export callback runs in network epoch context; it is expected to
+ * read-lock the PCB, re-check the generation snapshot under the lock
+ * (the unlocked walk below may find a PCB already being torn down, and
+ * freeing bumps inp_gencnt under the write lock before the PCB leaves
+ * the list), hide it as appropriate (returning ENOENT to skip it),
+ * convert it, and SYSCTL_OUT the result.
+ */
+int
+in_pcblist_batch(struct inpcbinfo *pcbinfo, struct sysctl_req *req,
+    size_t xsize, int (*export)(struct inpcb *, inp_gen_t, struct sysctl_req *))
+{
+	struct epoch_tracker et;
+	struct inpcb *inp;
+	inp_gen_t cursor, gen;
+	u_int count;
+	int error;
+
+	if (req->newptr == NULL)
+		return (EINVAL);
+	error = SYSCTL_IN(req, &cursor, sizeof(cursor));
+	if (error)
+		return (error);
+
+	if (req->oldptr == NULL) {
+		req->oldidx = INP_PCBLIST_BATCH * xsize;
+		return (0);
+	}
+	if ((error = sysctl_wire_old_buffer(req, 0)) != 0)
+		return (error);
+
+	count = 0;
+	NET_EPOCH_ENTER(et);
+	gen = pcbinfo->ipi_gencnt;
+	CK_LIST_FOREACH(inp, pcbinfo->ipi_listhead, inp_list) {
+		/*
+		 * Skip PCBs created after the walk began, PCBs being
+		 * freed (their generation count is bumped on removal),
+		 * and PCBs already covered by previous batches.
+		 */
+		if (inp->inp_gencnt > gen)
+			continue;
+		if (cursor != 0 && inp->inp_gencnt >= cursor)
+			continue;
+		if (count >= INP_PCBLIST_BATCH ||
+		    req->oldlen - req->oldidx < xsize)
+			break;
+		error = (*export)(inp, gen, req);
+		if (error == ENOENT) {
+			error = 0;
+			continue;
+		}
+		if (error)
+			break;
+		count++;
+	}
+	NET_EPOCH_EXIT(et);
+
+	return (error);
+}
+
 /*
  * Create an external-format (``xinpcb'') structure using the information in
  * the kernel-format in_pcb structure pointed to by inp.  This is done to
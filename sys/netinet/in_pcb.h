@@ -863,6 +863,9 @@ int	in_pcbrele(struct inpcb *);
 int	in_pcbrele_rlocked(struct inpcb *);
 int	in_pcbrele_wlocked(struct inpcb *);
 void	in_pcblist_rele_rlocked(epoch_context_t ctx);
+struct sysctl_req;
+int	in_pcblist_batch(struct inpcbinfo *, struct sysctl_req *, size_t,
+	    int (*)(struct inpcb *, inp_gen_t, struct sysctl_req *));
 void	in_losing(struct inpcb *);
 void	in_pcbsetsolabel(struct socket *so);
 int	in_getpeeraddr(struct socket *so, struct sockaddr **nam);
@@ -146,6 +146,12 @@ struct carp_if {
 	struct mtx	cif_mtx;
 	uint32_t	cif_flags;
 #define	CIF_PROMISC	0x00000001
+	/*
+	 * vhid -> softc mapping for the unlocked lookup in carp_forus().
+	 * Entries are managed under carp_sx; a softc is removed from the
+	 * table and an epoch wait performed before it is freed.
+	 */
+	struct carp_softc *cif_vhids[CARP_MAXVHID + 1];
 };
 
 #define	CARP_INET	0
@@ -1239,21 +1245,21 @@ carp_forus(struct ifnet *ifp, u_char *dhost)
 	if (ena[0] || ena[1] || ena[2] != 0x5e || ena[3] || ena[4] != 1)
 		return (0);
 
-	CIF_LOCK(ifp->if_carp);
-	IFNET_FOREACH_CARP(ifp, sc) {
-		/*
-		 * CARP_LOCK() is not here, since would protect nothing, but
-		 * cause deadlock with if_bridge, calling this under its lock.
-		 */
-		if (sc->sc_state == MASTER && !bcmp(dhost, LLADDR(&sc->sc_addr),
-		    ETHER_ADDR_LEN)) {
-			CIF_UNLOCK(ifp->if_carp);
-			return (1);
-		}
-	}
-	CIF_UNLOCK(ifp->if_carp);
+	/*
+	 * The vhid is the last byte of the virtual MAC address, so the
+	 * softc can be found with a single table lookup rather than a
+	 * list walk under the interface mutex, which convoys on setups
+	 * with hundreds of vhids.  The unlocked read is safe for callers
+	 * running inside the network epoch: the table entry is cleared
+	 * and an epoch wait performed before a softc is freed.
+	 * CARP_LOCK() is not here, since would protect nothing, but
+	 * cause deadlock with if_bridge, calling this under its lock.
+	 */
+	sc = ifp->if_carp->cif_vhids[ena[5]];
+	if (sc == NULL || sc->sc_state != MASTER)
+		return (0);
 
-	return (0);
+	return (bcmp(dhost, LLADDR(&sc->sc_addr), ETHER_ADDR_LEN) == 0);
 }
 
 /* Master down timeout event, executed in callout context. */
@@ -1637,6 +1643,8 @@ carp_destroy(struct carp_softc *sc)
 
 	CIF_LOCK(cif);
 	TAILQ_REMOVE(&cif->cif_vrs, sc, sc_list);
+	if (sc->sc_vhid > 0 && cif->cif_vhids[sc->sc_vhid] == sc)
+		cif->cif_vhids[sc->sc_vhid] = NULL;
 	CIF_UNLOCK(cif);
 
 	mtx_lock(&carp_mtx);
@@ -1652,6 +1660,9 @@ carp_destroy(struct carp_softc *sc)
 #endif
 	CARP_LOCK_DESTROY(sc);
 
+	/* Wait for unlocked carp_forus() readers to drain. */
+	epoch_wait_preempt(net_epoch_preempt);
+
 	free(sc->sc_ifas, M_CARP);
 	free(sc, M_CARP);
 }
@@ -1776,6 +1787,7 @@ carp_ioctl(struct ifreq *ifr, u_long cmd, struct thread *td)
 			LLADDR(&sc->sc_addr)[3] = 0;
 			LLADDR(&sc->sc_addr)[4] = 1;
 			LLADDR(&sc->sc_addr)[5] = sc->sc_vhid;
+			ifp->if_carp->cif_vhids[sc->sc_vhid] = sc;
 		} else
 			CARP_LOCK(sc);
 		locked = 1;
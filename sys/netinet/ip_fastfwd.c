@@ -85,6 +85,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/kernel.h>
 #include <sys/malloc.h>
 #include <sys/mbuf.h>
+#include <sys/pcpu.h>
 #include <sys/protosw.h>
 #include <sys/sdt.h>
 #include <sys/socket.h>
@@ -97,6 +98,7 @@ __FBSDID("$FreeBSD$");
 #include <net/pfil.h>
 #include <net/route.h>
 #include <net/route/nhop.h>
+#include <net/route/route_var.h>
 #include <net/vnet.h>
 
 #include <netinet/in.h>
@@ -111,10 +113,69 @@ __FBSDID("$FreeBSD$");
 
 #include <machine/in_cksum.h>
 
+/*
+ * A small per-CPU cache in front of the fib lookup.  Edge traffic is
+ * typically concentrated on a few destinations, so remembering the
+ * last next hops avoids the full lookup for most packets.  Entries
+ * are validated against the routing table generation counter: any
+ * route change bumps it and implicitly invalidates the whole cache,
+ * which also guarantees that a cached next hop cannot be dereferenced
+ * after the routes referencing it have gone.  The rib_head pointer in
+ * the key distinguishes fibs across vnets.
+ */
+#define	IP_NHCACHE_SIZE		64	/* per-CPU entries, power of 2 */
+#define	IP_NHCACHE_HASH(dst, rnh)					\
+	((((dst) >> 24) ^ ((dst) >> 12) ^ (dst) ^			\
+	 (uint32_t)((uintptr_t)(rnh) >> 9)) & (IP_NHCACHE_SIZE - 1))
+
+struct ip_nhcache_entry {
+	in_addr_t	dst;
+	struct rib_head	*rnh;
+	uint32_t	gen;
+	struct nhop_object *nh;
+};
+
+DPCPU_DEFINE_STATIC(struct ip_nhcache_entry, ip_nhcache[IP_NHCACHE_SIZE]);
+
+VNET_DEFINE_STATIC(int, ip_nhcache_enable) = 1;
+#define	V_ip_nhcache_enable	VNET(ip_nhcache_enable)
+SYSCTL_INT(_net_inet_ip, OID_AUTO, fastforward_nhcache,
+    CTLFLAG_VNET | CTLFLAG_RWTUN, &VNET_NAME(ip_nhcache_enable), 0,
+    "Enable the per-CPU next-hop cache in the fast forwarding path");
+
 static int
 ip_findroute(struct nhop_object **pnh, struct in_addr dest, struct mbuf *m)
 {
+	struct ip_nhcache_entry *nce;
+	struct rib_head *rnh;
 	struct nhop_object *nh;
+	uint32_t gen;
+
+	rnh = NULL;
+	gen = 0;
+	if (V_ip_nhcache_enable)
+		rnh = rt_tables_get_rnh(M_GETFIB(m), AF_INET);
+	if (rnh != NULL) {
+		/*
+		 * Read the generation before the lookup, so that a
+		 * concurrent route change leaves the entry inserted
+		 * below stale instead of wrongly fresh.
+		 */
+		gen = rnh->rnh_gen;
+		critical_enter();
+		nce = DPCPU_PTR(ip_nhcache[0]) +
+		    IP_NHCACHE_HASH(dest.s_addr, rnh);
+		if (nce->dst == dest.s_addr && nce->rnh == rnh &&
+		    nce->gen == gen) {
+			nh = nce->nh;
+			critical_exit();
+			IPSTAT_INC(ips_nhcache_hit);
+			*pnh = nh;
+			return (0);
+		}
+		critical_exit();
+		IPSTAT_INC(ips_nhcache_miss);
+	}
 
 	nh = fib4_lookup(M_GETFIB(m), dest, 0, NHR_NONE,
 	    m->m_pkthdr.flowid);
@@ -139,6 +200,21 @@ ip_findroute(struct nhop_object **pnh, struct in_addr dest, struct mbuf *m)
 		return (EHOSTUNREACH);
 	}
 
+	if (rnh != NULL) {
+		/*
+		 * Remember the forwardable next hop.  The entry is
+		 * recomputed since the thread may have migrated.
+		 */
+		critical_enter();
+		nce = DPCPU_PTR(ip_nhcache[0]) +
+		    IP_NHCACHE_HASH(dest.s_addr, rnh);
+		nce->dst = dest.s_addr;
+		nce->rnh = rnh;
+		nce->gen = gen;
+		nce->nh = nh;
+		critical_exit();
+	}
+
 	*pnh = nh;
 
 	return (0);
@@ -130,6 +130,8 @@ struct	ipstat {
 	uint64_t ips_notmember;		/* multicasts for unregistered grps */
 	uint64_t ips_nogif;		/* no match gif found */
 	uint64_t ips_badaddr;		/* invalid address on header */
+	uint64_t ips_nhcache_hit;	/* fastfwd next-hop cache hits */
+	uint64_t ips_nhcache_miss;	/* fastfwd next-hop cache misses */
 };
 
 #ifdef _KERNEL
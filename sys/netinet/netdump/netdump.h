@@ -46,6 +46,7 @@
 #define	NETDUMP_VMCORE		DEBUGNET_DATA
 #define	NETDUMP_KDH		4	/* Contains kernel dump header. */
 #define	NETDUMP_EKCD_KEY	5	/* Contains kernel dump key. */
+#define	NETDUMP_KTR		6	/* Contains formatted KTR entries. */
 
 #define	NETDUMP_DATASIZE	4096	/* Arbitrary packet size limit. */
 
@@ -44,6 +44,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/jail.h>
 #include <sys/kernel.h>
 #include <sys/kerneldump.h>
+#include <sys/ktr.h>
 #include <sys/mbuf.h>
 #include <sys/module.h>
 #include <sys/priv.h>
@@ -159,6 +160,12 @@ SYSCTL_INT(_net_netdump, OID_AUTO, retries, CTLFLAG_RWTUN,
 SYSCTL_INT(_net_netdump, OID_AUTO, arp_retries, CTLFLAG_RWTUN,
     &debugnet_arp_nretries, 0,
     "Number of ARP attempts before giving up");
+#ifdef KTR
+static int nd_dump_ktr;
+SYSCTL_INT(_net_netdump, OID_AUTO, dump_ktr, CTLFLAG_RWTUN,
+    &nd_dump_ktr, 0,
+    "Stream the KTR trace buffer after the kernel core");
+#endif
 
 static bool nd_is_enabled;
 static bool
@@ -217,6 +224,60 @@ netdump_flush_buf(void)
 	return (error);
 }
 
+#ifdef KTR
+/*
+ * Stream the formatted contents of the global KTR ring over the
+ * established debugnet connection, oldest entry first.  This runs after
+ * the last core chunk has been acked and before DEBUGNET_FINISHED, in
+ * NETDUMP_KTR messages, so a server that does not understand the type
+ * can discard the extra data without affecting the core file.
+ */
+static void
+netdump_send_ktr(void)
+{
+	char line[256];
+	struct ktr_entry *e;
+	size_t len, linelen;
+	int i, idx;
+
+	if (ktr_buf == NULL)
+		return;
+
+	len = 0;
+	idx = ktr_idx;
+	for (i = 1; i <= ktr_entries; i++) {
+		e = &ktr_buf[(idx + i) % ktr_entries];
+		if (e->ktr_desc == NULL)
+			continue;
+		linelen = snprintf(line, sizeof(line), "%ju %d %s:%d ",
+		    (uintmax_t)e->ktr_timestamp, e->ktr_cpu,
+		    e->ktr_file == NULL ? "" : e->ktr_file, e->ktr_line);
+		if (linelen < sizeof(line))
+			linelen += snprintf(line + linelen,
+			    sizeof(line) - linelen, e->ktr_desc,
+			    e->ktr_parms[0], e->ktr_parms[1],
+			    e->ktr_parms[2], e->ktr_parms[3],
+			    e->ktr_parms[4], e->ktr_parms[5]);
+		if (linelen > sizeof(line) - 2)
+			linelen = sizeof(line) - 2;
+		line[linelen++] = '\n';
+		if (len + linelen > sizeof(nd_buf)) {
+			if (debugnet_send(nd_conf.nd_pcb, NETDUMP_KTR,
+			    nd_buf, len, NULL) != 0) {
+				printf("netdump: failed to send KTR data\n");
+				return;
+			}
+			len = 0;
+		}
+		memcpy(nd_buf + len, line, linelen);
+		len += linelen;
+	}
+	if (len != 0 && debugnet_send(nd_conf.nd_pcb, NETDUMP_KTR, nd_buf,
+	    len, NULL) != 0)
+		printf("netdump: failed to send KTR data\n");
+}
+#endif /* KTR */
+
 /*
  * Callback from dumpsys() to dump a chunk of memory.
  * Copies it out to our static buffer then sends it across the network.
@@ -247,6 +308,10 @@ netdump_dumper(void *priv __unused, void *virtual,
 		if (error != 0)
 			dump_failed = 1;
 
+#ifdef KTR
+		if (dump_failed == 0 && nd_dump_ktr != 0)
+			netdump_send_ktr();
+#endif
 		if (dump_failed != 0)
 			printf("failed to dump the kernel core\n");
 		else if (
@@ -357,8 +357,12 @@ struct tcp_info {
 	u_int32_t	tcpi_rcv_ooopack;	/* Out-of-order packets */
 	u_int32_t	tcpi_snd_zerowin;	/* Zero-sized windows sent */
 
+	/* Delivery rate estimation, for application-level pacing. */
+	u_int32_t	tcpi_delivery_rate;	/* Goodput estimate (kbit/s). */
+	u_int32_t	tcpi_min_rtt;		/* Smallest observed RTT (usec). */
+
 	/* Padding to grow without breaking ABI. */
-	u_int32_t	__tcpi_pad[26];		/* Padding. */
+	u_int32_t	__tcpi_pad[24];		/* Padding. */
 };
 
 /*
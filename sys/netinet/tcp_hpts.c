@@ -260,6 +260,11 @@ counter_u64_t wheel_wrap;
 SYSCTL_COUNTER_U64(_net_inet_tcp_hpts, OID_AUTO, wheel_wrap, CTLFLAG_RD,
     &wheel_wrap, "Number of times the wheel lagged enough to have an insert see wrap");
 
+counter_u64_t hpts_rehomed;
+
+SYSCTL_COUNTER_U64(_net_inet_tcp_hpts, OID_AUTO, rehomed, CTLFLAG_RD,
+    &hpts_rehomed, "Number of tcbs moved to an hpts in their new NUMA domain");
+
 static int32_t out_ts_percision = 0;
 
 SYSCTL_INT(_net_inet_tcp_hpts, OID_AUTO, out_tspercision, CTLFLAG_RW,
@@ -1149,7 +1154,19 @@ hpts_random_cpu(struct inpcb *inp){
 	}
 	/* Nothing set use a random number */
 	ran = arc4random();
-	cpuid = (ran & 0xffff) % mp_ncpus;
+#ifdef NUMA
+	/*
+	 * Even without a flowid, stay in the domain of the pcb so that
+	 * the pacer does not reach across sockets for its mbufs.
+	 */
+	if (tcp_bind_threads == 2 && inp->inp_numa_domain != M_NODOM) {
+		struct hpts_domain_info *di;
+
+		di = &hpts_domains[inp->inp_numa_domain];
+		cpuid = di->cpu[ran % di->count];
+	} else
+#endif
+		cpuid = (ran & 0xffff) % mp_ncpus;
 	return (cpuid);
 }
 
@@ -1202,6 +1219,22 @@ hpts_cpuid(struct inpcb *inp)
 #endif
 }
 
+#ifdef NUMA
+/*
+ * Returns true when the connection has migrated to a different NUMA
+ * domain than the hpts it was assigned to, i.e. its pacing timers now
+ * fire on a cpu that is remote from its PCB and mbufs.
+ */
+static bool
+hpts_wrong_domain(struct inpcb *inp, uint16_t cpuid)
+{
+
+	if (tcp_bind_threads != 2 || inp->inp_numa_domain == M_NODOM)
+		return (false);
+	return (pcpu_find(cpuid)->pc_domain != inp->inp_numa_domain);
+}
+#endif
+
 static void
 tcp_drop_in_pkts(struct tcpcb *tp)
 {
@@ -1789,6 +1822,23 @@ __tcp_set_hpts(struct inpcb *inp, int32_t line)
 		inp->inp_hpts_cpu = hpts_cpuid(inp);
 		inp->inp_hpts_cpu_set = 1;
 	}
+#ifdef NUMA
+	else if ((inp->inp_in_hpts == 0) &&
+	    (inp->inp_in_input == 0) &&
+	    hpts_wrong_domain(inp, inp->inp_hpts_cpu)) {
+		/*
+		 * The connection moved domains (e.g. its RSS bucket was
+		 * re-steered).  It is not on either wheel, so re-home it
+		 * to an hpts in its new domain; the input cpu follows
+		 * below since hpts_cpuid() keeps both on the same hpts.
+		 */
+		inp->inp_hpts_cpu_set = 0;
+		inp->inp_input_cpu_set = 0;
+		inp->inp_hpts_cpu = hpts_cpuid(inp);
+		inp->inp_hpts_cpu_set = 1;
+		counter_u64_add(hpts_rehomed, 1);
+	}
+#endif
 	mtx_unlock(&hpts->p_mtx);
 	hpts = tcp_input_lock(inp);
 	if ((inp->inp_input_cpu_set == 0) &&
@@ -1882,6 +1932,7 @@ tcp_init_hptsi(void *st)
 	back_tosleep = counter_u64_alloc(M_WAITOK);
 	combined_wheel_wrap = counter_u64_alloc(M_WAITOK);
 	wheel_wrap = counter_u64_alloc(M_WAITOK);
+	hpts_rehomed = counter_u64_alloc(M_WAITOK);
 	sz = (tcp_pace.rp_num_hptss * sizeof(struct tcp_hpts_entry *));
 	tcp_pace.rp_ent = malloc(sz, M_TCPHPTS, M_WAITOK | M_ZERO);
 	asz = sizeof(struct hptsh) * NUM_OF_HPTSI_SLOTS;
@@ -91,8 +91,15 @@ counter_u64_t tcp_inp_lro_compressed;
 counter_u64_t tcp_inp_lro_single_push;
 counter_u64_t tcp_inp_lro_locks_taken;
 counter_u64_t tcp_inp_lro_sack_wake;
+counter_u64_t tcp_lro_entry_flushes;
+counter_u64_t tcp_lro_entry_pkts;
+counter_u64_t tcp_lro_entry_held;
 
 static unsigned	tcp_lro_entries = TCP_LRO_ENTRIES;
+static int32_t tcp_lro_hold_us = 0;
+SYSCTL_INT(_net_inet_tcp_lro, OID_AUTO, hold_us, CTLFLAG_RW,
+    &tcp_lro_hold_us, 0,
+    "Microseconds an entry may be held across rx batches to improve aggregation");
 static int32_t hold_lock_over_compress = 0;
 SYSCTL_INT(_net_inet_tcp_lro, OID_AUTO, hold_lock, CTLFLAG_RW,
     &hold_lock_over_compress, 0,
@@ -112,6 +119,12 @@ SYSCTL_COUNTER_U64(_net_inet_tcp_lro, OID_AUTO, lockcnt, CTLFLAG_RD,
     &tcp_inp_lro_locks_taken, "Number of lro's inp_wlocks taken");
 SYSCTL_COUNTER_U64(_net_inet_tcp_lro, OID_AUTO, sackwakeups, CTLFLAG_RD,
     &tcp_inp_lro_sack_wake, "Number of wakeups caused by sack/fin");
+SYSCTL_COUNTER_U64(_net_inet_tcp_lro, OID_AUTO, entry_flushes, CTLFLAG_RD,
+    &tcp_lro_entry_flushes, "Number of lro entry flushes");
+SYSCTL_COUNTER_U64(_net_inet_tcp_lro, OID_AUTO, entry_pkts, CTLFLAG_RD,
+    &tcp_lro_entry_pkts, "Number of packets aggregated into flushed lro entries");
+SYSCTL_COUNTER_U64(_net_inet_tcp_lro, OID_AUTO, entry_held, CTLFLAG_RD,
+    &tcp_lro_entry_held, "Number of times an lro entry was held across an rx batch");
 
 void
 tcp_lro_reg_mbufq(void)
@@ -357,6 +370,48 @@ tcp_lro_rx_done(struct lro_ctrl *lc)
 	}
 }
 
+/*
+ * Flush entries whose hold deadline has passed and keep the rest active
+ * so the next rx batch can continue appending to them.  The deadline is
+ * measured from the entry's creation so a slow trickle of appends cannot
+ * postpone delivery indefinitely.  Callers that hold entries back must
+ * poll again via tcp_lro_needs_flush() to bound the added latency when
+ * the interrupt stream stops.
+ */
+static void
+tcp_lro_rx_done_hold(struct lro_ctrl *lc)
+{
+	struct lro_entry *le, *le_tmp;
+	struct timeval now, hold;
+
+	if (tcp_lro_hold_us <= 0) {
+		tcp_lro_rx_done(lc);
+		return;
+	}
+	microuptime(&now);
+	hold.tv_sec = tcp_lro_hold_us / 1000000;
+	hold.tv_usec = tcp_lro_hold_us % 1000000;
+	timevalsub(&now, &hold);
+	LIST_FOREACH_SAFE(le, &lc->lro_active, next, le_tmp) {
+		if (timevalcmp(&now, &le->ctime, >=)) {
+			tcp_lro_active_remove(le);
+			tcp_lro_flush(lc, le);
+		} else
+			counter_u64_add(tcp_lro_entry_held, 1);
+	}
+}
+
+/*
+ * Report whether held entries remain active, so drivers holding flushes
+ * back (net.inet.tcp.lro.hold_us) know to schedule another pass.
+ */
+int
+tcp_lro_needs_flush(struct lro_ctrl *lc)
+{
+
+	return (!LIST_EMPTY(&lc->lro_active));
+}
+
 void
 tcp_lro_flush_inactive(struct lro_ctrl *lc, const struct timeval *timeout)
 {
@@ -868,6 +923,10 @@ tcp_lro_flush(struct lro_ctrl *lc, struct lro_entry *le)
 {
 	struct tcpcb *tp = NULL;
 	int locked = 0;
+
+	/* Per-entry aggregation statistics. */
+	counter_u64_add(tcp_lro_entry_flushes, 1);
+	counter_u64_add(tcp_lro_entry_pkts, le->mbuf_cnt);
 #ifdef TCPHPTS
 	struct inpcb *inp = NULL;
 	int need_wakeup = 0, can_queue = 0;
@@ -1106,8 +1165,8 @@ tcp_lro_flush_all(struct lro_ctrl *lc)
 		if (seq != nseq) {
 			seq = nseq;
 
-			/* flush active streams */
-			tcp_lro_rx_done(lc);
+			/* flush active streams past their hold deadline */
+			tcp_lro_rx_done_hold(lc);
 		}
 
 		/* add packet to LRO engine */
@@ -1119,8 +1178,8 @@ tcp_lro_flush_all(struct lro_ctrl *lc)
 		}
 	}
 done:
-	/* flush active streams */
-	tcp_lro_rx_done(lc);
+	/* flush active streams past their hold deadline */
+	tcp_lro_rx_done_hold(lc);
 
 	lc->lro_mbuf_count = 0;
 }
@@ -1341,6 +1400,7 @@ tcp_lro_rx2(struct lro_ctrl *lc, struct mbuf *m, uint32_t csum, int use_hash)
 	LIST_REMOVE(le, next);
 	tcp_lro_active_insert(lc, bucket, le);
 	lro_set_mtime(&le->mtime, &arrv);
+	le->ctime = le->mtime;
 
 	/* Start filling in details. */
 	switch (eh_type) {
@@ -76,6 +76,7 @@ struct lro_entry {
 	uint16_t		mbuf_cnt;	/* Count of mbufs collected see note */
 	uint16_t		mbuf_appended;
 	struct timeval		mtime;
+	struct timeval		ctime;		/* Creation time, for hold deadline */
 };
 /*
  * Note: The mbuf_cnt field tracks our number of mbufs added to the m_next
@@ -126,6 +127,7 @@ int tcp_lro_init_args(struct lro_ctrl *, struct ifnet *, unsigned, unsigned);
 void tcp_lro_free(struct lro_ctrl *);
 void tcp_lro_flush_inactive(struct lro_ctrl *, const struct timeval *);
 void tcp_lro_flush(struct lro_ctrl *, struct lro_entry *);
+int tcp_lro_needs_flush(struct lro_ctrl *);
 void tcp_lro_flush_all(struct lro_ctrl *);
 int tcp_lro_rx(struct lro_ctrl *, struct mbuf *, uint32_t);
 void tcp_lro_queue_mbuf(struct lro_ctrl *, struct mbuf *);
@@ -292,6 +292,10 @@ SYSCTL_UINT(_net_inet_tcp_rl, OID_AUTO, alive, CTLFLAG_RW,
 SYSCTL_UINT(_net_inet_tcp_rl, OID_AUTO, dead, CTLFLAG_RW,
     &rs_number_dead, 0,
     "Number of interfaces departing from ratelimiting");
+static uint32_t rs_hw_burst_segs_max = 43;	/* MAX_MSS_SENT */
+SYSCTL_UINT(_net_inet_tcp_rl, OID_AUTO, hw_burst_segs_max, CTLFLAG_RW,
+    &rs_hw_burst_segs_max, 43,
+    "Maximum burst, in segments, handed to a hardware pacing queue at once");
 
 static void
 rl_add_syctl_entries(struct sysctl_oid *rl_sysctl_root, struct tcp_rate_set *rs)
@@ -1380,7 +1384,7 @@ tcp_get_pacing_burst_size (uint64_t bw, uint32_t segsiz, int can_use_1mss,
 	 * packet overhead (enet hdr, ip hdr and tcp hdr).
 	 */
 	uint64_t lentim, res, bytes;
-	uint32_t new_tso, min_tso_segs;
+	uint32_t hw_burst_max, new_tso, min_tso_segs;
 
 	bytes = bw / 1000;
 	if (bytes > (64 * 1000))
@@ -1430,12 +1434,19 @@ tcp_get_pacing_burst_size (uint64_t bw, uint32_t segsiz, int can_use_1mss,
 	 * Note we also double this value if the b/w is over
 	 * 100Mbps. If its over 500meg we just set you to the
 	 * max (43 segments).
+	 *
+	 * The administrator can shrink the burst the hardware
+	 * queue is handed at once below that max to trade a few
+	 * more doorbells for smaller microbursts on the wire.
 	 */
+	hw_burst_max = rs_hw_burst_segs_max;
+	if ((hw_burst_max == 0) || (hw_burst_max > MAX_MSS_SENT))
+		hw_burst_max = MAX_MSS_SENT;
 	if (te->rate > FIVE_HUNDRED_MBPS)
-		return (segsiz * MAX_MSS_SENT);
+		return (segsiz * hw_burst_max);
 	if (te->rate == bw) {
 		/* We are pacing at exactly the hdwr rate */
-		return (segsiz * MAX_MSS_SENT);
+		return (segsiz * hw_burst_max);
 	}
 	lentim = ETHERNET_SEGMENT_SIZE * USECS_IN_SECOND;
 	res = lentim / bw;
@@ -1448,11 +1459,14 @@ tcp_get_pacing_burst_size (uint64_t bw, uint32_t segsiz, int can_use_1mss,
 			segs *= 2;
 		if (segs < min_tso_segs)
 			segs = min_tso_segs;
-		if (segs > MAX_MSS_SENT)
-			segs = MAX_MSS_SENT;
+		if (segs > hw_burst_max)
+			segs = hw_burst_max;
 		segs *= segsiz;
 		if (err)
 			*err = 0;
+		/* The administrative cap wins over the software TSO size. */
+		if (new_tso > (hw_burst_max * segsiz))
+			new_tso = hw_burst_max * segsiz;
 		if (segs < new_tso) {
 			/* unexpected ? */
 			return(new_tso);
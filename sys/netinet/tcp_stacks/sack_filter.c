@@ -32,6 +32,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/queue.h>
 #include <sys/socket.h>
 #ifdef _KERNEL
+#include <sys/libkern.h>
 #include <sys/mbuf.h>
 #include <sys/sockopt.h>
 #endif
@@ -94,6 +95,18 @@ FILE *in = NULL;
 #define sack_blk_set(sf, i) ((1 << i) | sf->sf_bits)
 #define sack_blk_clr(sf, i) (~(1 << i) & sf->sf_bits)
 
+/*
+ * Walk only the occupied slots of the board by scanning the sf_bits
+ * occupancy bitmap a word at a time, rather than probing every index
+ * and testing it. The bits argument is clobbered as we go. Note that
+ * this visits a snapshot of the bitmap taken at loop entry; callers
+ * that clear entries mid-walk must re-test sack_blk_used() themselves.
+ */
+#define sack_foreach_blk(sf, bits, i)					\
+	for ((bits) = (sf)->sf_bits;					\
+	     (bits) != 0 && ((i) = ffs(bits) - 1, 1);			\
+	     (bits) &= (bits) - 1)
+
 #ifndef _KERNEL
 static
 #endif
@@ -114,22 +127,22 @@ static void
 sack_filter_prune(struct sack_filter *sf, tcp_seq th_ack)
 {
 	int32_t i;
+	uint16_t bits;
+
 	/* start with the oldest */
-	for (i = 0; i < SACK_FILTER_BLOCKS; i++) {
-		if (sack_blk_used(sf, i)) {
-			if (SEQ_GT(th_ack, sf->sf_blks[i].end)) {
-				/* This block is consumed */
-				sf->sf_bits = sack_blk_clr(sf, i);
-				sf->sf_used--;
-			} else if (SEQ_GT(th_ack, sf->sf_blks[i].start)) {
-				/* Some of it is acked */
-				sf->sf_blks[i].start = th_ack;
-				/* We could in theory break here, but
-				 * there are some broken implementations
-				 * that send multiple blocks. We want
-				 * to catch them all with similar seq's.
-				 */
-			}
+	sack_foreach_blk(sf, bits, i) {
+		if (SEQ_GT(th_ack, sf->sf_blks[i].end)) {
+			/* This block is consumed */
+			sf->sf_bits = sack_blk_clr(sf, i);
+			sf->sf_used--;
+		} else if (SEQ_GT(th_ack, sf->sf_blks[i].start)) {
+			/* Some of it is acked */
+			sf->sf_blks[i].start = th_ack;
+			/* We could in theory break here, but
+			 * there are some broken implementations
+			 * that send multiple blocks. We want
+			 * to catch them all with similar seq's.
+			 */
 		}
 	}
 	sf->sf_ack = th_ack;
@@ -286,19 +299,18 @@ sack_filter_old(struct sack_filter *sf, struct sackblk *in, int  numblks)
 static void
 sack_move_to_empty(struct sack_filter *sf, uint32_t idx)
 {
-	int32_t i, cnt;
+	int32_t i;
+	uint16_t avail, ahead;
 
-	i = (idx + 1) % SACK_FILTER_BLOCKS;
-	for (cnt=0; cnt <(SACK_FILTER_BLOCKS-1); cnt++) {
-		if (sack_blk_used(sf, i) == 0) {
-			memcpy(&sf->sf_blks[i], &sf->sf_blks[idx], sizeof(struct sackblk));
-			sf->sf_bits = sack_blk_clr(sf, idx);
-			sf->sf_bits = sack_blk_set(sf, i);
-			return;
-		}
-		i++;
-		i %= SACK_FILTER_BLOCKS;
-	}
+	avail = ~sf->sf_bits & ((1 << SACK_FILTER_BLOCKS) - 1);
+	if (avail == 0)
+		return;
+	/* Prefer the first free slot after idx, wrapping around. */
+	ahead = avail & ~((1 << ((idx + 1) % SACK_FILTER_BLOCKS)) - 1);
+	i = ffs(ahead != 0 ? ahead : avail) - 1;
+	memcpy(&sf->sf_blks[i], &sf->sf_blks[idx], sizeof(struct sackblk));
+	sf->sf_bits = sack_blk_clr(sf, idx);
+	sf->sf_bits = sack_blk_set(sf, i);
 }
 
 static int32_t
@@ -370,10 +382,9 @@ static int32_t
 sack_blocks_overlap_or_meet(struct sack_filter *sf, struct sackblk *sb, uint32_t skip)
 {
 	int32_t i;
+	uint16_t bits;
 
-	for(i=0; i<SACK_FILTER_BLOCKS; i++) {
-		if (sack_blk_used(sf, i) == 0)
-			continue;
+	sack_foreach_blk(sf, bits, i) {
 		if (i == skip)
 			continue;
 		if (SEQ_GEQ(sf->sf_blks[i].end, sb->start) &&
@@ -437,8 +448,10 @@ static void
 sack_board_collapse(struct sack_filter *sf)
 {
 	int32_t i, j, i_d, j_d;
+	uint16_t bits;
 
-	for(i=0; i<SACK_FILTER_BLOCKS; i++) {
+	sack_foreach_blk(sf, bits, i) {
+		/* A prior pass of the loop may have freed this block. */
 		if (sack_blk_used(sf, i) == 0)
 			continue;
 		/*
@@ -572,10 +585,9 @@ sack_filter_reject(struct sack_filter *sf, struct sackblk *in)
 	 * blocks in our filter.
 	 */
 	int i;
+	uint16_t bits;
 
-	for(i=0; i<SACK_FILTER_BLOCKS; i++) {
-		if (sack_blk_used(sf, i) == 0)
-			continue;
+	sack_foreach_blk(sf, bits, i) {
 		/*
 		 * Now given the sack-filter block does it touch
 		 * with one of the ends
@@ -1221,6 +1221,9 @@ tcp_init(void)
 	tcp_inp_lro_single_push = counter_u64_alloc(M_WAITOK);
 	tcp_inp_lro_locks_taken = counter_u64_alloc(M_WAITOK);
 	tcp_inp_lro_sack_wake = counter_u64_alloc(M_WAITOK);
+	tcp_lro_entry_flushes = counter_u64_alloc(M_WAITOK);
+	tcp_lro_entry_pkts = counter_u64_alloc(M_WAITOK);
+	tcp_lro_entry_held = counter_u64_alloc(M_WAITOK);
 #ifdef TCPPCAP
 	tcp_pcap_init();
 #endif
@@ -2327,6 +2330,55 @@ SYSCTL_PROC(_net_inet_tcp, TCPCTL_PCBLIST, pcblist,
     NULL, 0, tcp_pcblist, "S,xtcpcb",
     "List of active TCP connections");
 
+static int
+tcp_pcblist_batch_export(struct inpcb *inp, inp_gen_t gen,
+    struct sysctl_req *req)
+{
+	struct xtcpcb xt;
+	int error;
+
+	INP_RLOCK(inp);
+	/*
+	 * Re-check the generation snapshot now that the PCB is locked:
+	 * teardown bumps inp_gencnt under the write lock, so a PCB the
+	 * unlocked list walk raced with is caught here before its
+	 * tcpcb is dereferenced.
+	 */
+	if (inp->inp_gencnt > gen) {
+		INP_RUNLOCK(inp);
+		return (ENOENT);
+	}
+	if (inp->inp_flags & INP_TIMEWAIT) {
+		if (intotw(inp) != NULL)
+			error = cr_cansee(req->td->td_ucred,
+			    intotw(inp)->tw_cred);
+		else
+			error = EINVAL;	/* Skip this inp. */
+	} else
+		error = cr_canseeinpcb(req->td->td_ucred, inp);
+	if (error != 0) {
+		INP_RUNLOCK(inp);
+		return (ENOENT);
+	}
+	tcp_inptoxtp(inp, &xt);
+	INP_RUNLOCK(inp);
+	return (SYSCTL_OUT(req, &xt, sizeof(xt)));
+}
+
+static int
+tcp_pcblist_batch(SYSCTL_HANDLER_ARGS)
+{
+
+	return (in_pcblist_batch(&V_tcbinfo, req, sizeof(struct xtcpcb),
+	    tcp_pcblist_batch_export));
+}
+
+SYSCTL_PROC(_net_inet_tcp, OID_AUTO, pcblist_batch,
+    CTLTYPE_OPAQUE | CTLFLAG_RW | CTLFLAG_ANYBODY | CTLFLAG_MPSAFE,
+    NULL, 0, tcp_pcblist_batch, "S,xtcpcb",
+    "Next batch of TCP connections after the generation count "
+    "given as the new value");
+
 #ifdef INET
 static int
 tcp_getcred(SYSCTL_HANDLER_ARGS)
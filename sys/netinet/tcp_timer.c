@@ -191,51 +191,35 @@ SYSCTL_INT(_net_inet_tcp, OID_AUTO, v6pmtud_blackhole_mss,
     "Path MTU Discovery IPv6 Black Hole Detection lowered MSS");
 #endif
 
-#ifdef	RSS
 static int	per_cpu_timers = 1;
-#else
-static int	per_cpu_timers = 0;
-#endif
 SYSCTL_INT(_net_inet_tcp, OID_AUTO, per_cpu_timers, CTLFLAG_RW,
     &per_cpu_timers , 0, "run tcp timers on all cpus");
 
 /*
  * Map the given inp to a CPU id.
  *
- * This queries RSS if it's compiled in, else it defaults to the current
- * CPU ID.
+ * This queries RSS if it's compiled in, else it hashes the flowid to a
+ * stable CPU so a connection's timers always run on the same callout
+ * wheel.  Returning curcpu here would migrate the callouts on every
+ * reschedule from a different CPU, bouncing their cache lines across
+ * domains and serializing reschedulers on the wheel locks.
  */
 inline int
 inp_to_cpuid(struct inpcb *inp)
 {
 	u_int cpuid;
 
+	if (per_cpu_timers == 0)
+		return (0);
 #ifdef	RSS
-	if (per_cpu_timers) {
-		cpuid = rss_hash2cpuid(inp->inp_flowid, inp->inp_flowtype);
-		if (cpuid == NETISR_CPUID_NONE)
-			return (curcpu);	/* XXX */
-		else
-			return (cpuid);
-	}
-#else
-	/* Legacy, pre-RSS behaviour */
-	if (per_cpu_timers) {
-		/*
-		 * We don't have a flowid -> cpuid mapping, so cheat and
-		 * just map unknown cpuids to curcpu.  Not the best, but
-		 * apparently better than defaulting to swi 0.
-		 */
-		cpuid = inp->inp_flowid % (mp_maxid + 1);
-		if (! CPU_ABSENT(cpuid))
-			return (cpuid);
-		return (curcpu);
-	}
+	cpuid = rss_hash2cpuid(inp->inp_flowid, inp->inp_flowtype);
+	if (cpuid != NETISR_CPUID_NONE)
+		return (cpuid);
 #endif
-	/* Default for RSS and non-RSS - cpuid 0 */
-	else {
-		return (0);
-	}
+	cpuid = inp->inp_flowid % (mp_maxid + 1);
+	if (!CPU_ABSENT(cpuid))
+		return (cpuid);
+	return (0);
 }
 
 /*
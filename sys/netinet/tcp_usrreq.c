@@ -1695,6 +1695,15 @@ tcp_fill_info(struct tcpcb *tp, struct tcp_info *ti)
 	ti->tcpi_snd_rexmitpack = tp->t_sndrexmitpack;
 	ti->tcpi_rcv_ooopack = tp->t_rcvoopack;
 	ti->tcpi_snd_zerowin = tp->t_sndzerowin;
+	ti->tcpi_min_rtt = (u_int64_t)tp->t_rttlow * tick;
+#ifdef STATS
+	/*
+	 * The most recent sample taken by the goodput measurement
+	 * machinery, in the same units it is recorded with (kbit/s).
+	 */
+	if (tp->t_stats_gput_prev > 0)
+		ti->tcpi_delivery_rate = tp->t_stats_gput_prev;
+#endif
 #ifdef TCP_OFFLOAD
 	if (tp->t_flags & TF_TOE) {
 		ti->tcpi_options |= TCPI_OPT_TOE;
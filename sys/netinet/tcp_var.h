@@ -969,6 +969,9 @@ extern counter_u64_t tcp_inp_lro_compressed;
 extern counter_u64_t tcp_inp_lro_single_push;
 extern counter_u64_t tcp_inp_lro_locks_taken;
 extern counter_u64_t tcp_inp_lro_sack_wake;
+extern counter_u64_t tcp_lro_entry_flushes;
+extern counter_u64_t tcp_lro_entry_pkts;
+extern counter_u64_t tcp_lro_entry_held;
 
 #ifdef NETFLIX_EXP_DETECTION
 /* Various SACK attack thresholds */
@@ -921,6 +921,46 @@ SYSCTL_PROC(_net_inet_udp, UDPCTL_PCBLIST, pcblist,
     udp_pcblist, "S,xinpcb",
     "List of active UDP sockets");
 
+static int
+udp_pcblist_batch_export(struct inpcb *inp, inp_gen_t gen,
+    struct sysctl_req *req)
+{
+	struct xinpcb xi;
+
+	INP_RLOCK(inp);
+	/*
+	 * Re-check the generation snapshot now that the PCB is locked:
+	 * teardown bumps inp_gencnt under the write lock, so a PCB the
+	 * unlocked list walk raced with is caught here before its
+	 * detached socket is dereferenced.
+	 */
+	if (inp->inp_gencnt > gen) {
+		INP_RUNLOCK(inp);
+		return (ENOENT);
+	}
+	if (cr_canseeinpcb(req->td->td_ucred, inp) != 0) {
+		INP_RUNLOCK(inp);
+		return (ENOENT);
+	}
+	in_pcbtoxinpcb(inp, &xi);
+	INP_RUNLOCK(inp);
+	return (SYSCTL_OUT(req, &xi, sizeof(xi)));
+}
+
+static int
+udp_pcblist_batch(SYSCTL_HANDLER_ARGS)
+{
+
+	return (in_pcblist_batch(&V_udbinfo, req, sizeof(struct xinpcb),
+	    udp_pcblist_batch_export));
+}
+
+SYSCTL_PROC(_net_inet_udp, OID_AUTO, pcblist_batch,
+    CTLTYPE_OPAQUE | CTLFLAG_RW | CTLFLAG_ANYBODY | CTLFLAG_MPSAFE,
+    NULL, 0, udp_pcblist_batch, "S,xinpcb",
+    "Next batch of UDP sockets after the generation count "
+    "given as the new value");
+
 #ifdef INET
 static int
 udp_getcred(SYSCTL_HANDLER_ARGS)
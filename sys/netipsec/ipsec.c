@@ -1181,6 +1181,14 @@ ipsec_hdrsiz_inpcb(struct inpcb *inp)
  * beforehand).
  * 0 (zero) is returned if packet disallowed, 1 if packet permitted.
  *
+ * ipsec_chkreplay() may be called without the SA lock held; it only reads
+ * the replay state and serves as a best-effort filter to cheaply discard
+ * old or duplicated packets before the ICV is verified.  A racy read can
+ * let a stale packet through to ICV verification or drop a packet the
+ * locked check would also drop; the authoritative check is performed by
+ * ipsec_updatereplay() under the SA lock once the packet has been
+ * authenticated.
+ *
  * Based on RFC 6479. Blocks are 32 bits unsigned integers
  */
 
@@ -1324,6 +1332,35 @@ ok:
 	return (0);
 }
 
+/*
+ * Allocate the next output sequence number, without taking the SA lock.
+ * The counter is advanced with an atomic compare-and-swap so that
+ * concurrent senders on the same SA never emit duplicate sequence
+ * numbers.  If the counter would wrap and sequence number cycling was
+ * not requested, the counter is left saturated and an error is returned;
+ * the caller is expected to drop the packet.
+ * OUT:	0:	OK, *seqp holds the sequence number to use
+ *	1:	counter wrapped, no more packets may be sent
+ */
+int
+ipsec_replay_nextseq(struct secasvar *sav, uint32_t *seqp)
+{
+	struct secreplay *replay;
+	uint32_t next;
+
+	IPSEC_ASSERT(sav != NULL, ("Null SA"));
+	IPSEC_ASSERT(sav->replay != NULL, ("Null replay state"));
+
+	replay = sav->replay;
+	do {
+		next = replay->count;
+		if (next == ~0 && (sav->flags & SADB_X_EXT_CYCSEQ) == 0)
+			return (1);
+	} while (atomic_cmpset_32(&replay->count, next, next + 1) == 0);
+	*seqp = next + 1;
+	return (0);
+}
+
 int
 ipsec_updateid(struct secasvar *sav, crypto_session_t *new,
     crypto_session_t *old)
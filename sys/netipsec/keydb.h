@@ -198,11 +198,12 @@ struct secasvar {
 #define SAV_ISCTRORGCM(_sav)	(SAV_ISCTR((_sav)) || SAV_ISGCM((_sav)))
 
 /* Replay prevention, protected by SECASVAR_LOCK:
+ *  (a) atomically updated on output, locked by mtx on input
  *  (m) locked by mtx
  *  (c) read only except during creation / free
  */
 struct secreplay {
-	u_int32_t count;	/* (m) */
+	u_int32_t count;	/* (a) */
 	u_int wsize;		/* (c) window size, i.g. 4 bytes */
 	u_int32_t seq;		/* (m) used by sender */
 	u_int32_t lastseq;	/* (m) used by receiver */
@@ -554,11 +554,13 @@ ah_input(struct mbuf *m, struct secasvar *sav, int skip, int protoff)
 	}
 	ah = (struct newah *)(mtod(m, caddr_t) + skip);
 
-	/* Check replay window, if applicable. */
-	SECASVAR_LOCK(sav);
+	/*
+	 * Check replay window, if applicable.  This is a cheap, unlocked
+	 * pre-check; the authoritative replay check runs under the SA
+	 * lock in ah_input_cb() after the ICV has been verified.
+	 */
 	if (sav->replay != NULL && sav->replay->wsize != 0 &&
 	    ipsec_chkreplay(ntohl(ah->ah_seq), sav) == 0) {
-		SECASVAR_UNLOCK(sav);
 		AHSTAT_INC(ahs_replay);
 		DPRINTF(("%s: packet replay failure: %s\n", __func__,
 		    ipsec_sa2str(sav, buf, sizeof(buf))));
@@ -566,7 +568,6 @@ ah_input(struct mbuf *m, struct secasvar *sav, int skip, int protoff)
 		goto bad;
 	}
 	cryptoid = sav->tdb_cryptoid;
-	SECASVAR_UNLOCK(sav);
 
 	/* Verify AH header length. */
 	hl = sizeof(struct ah) + (ah->ah_len * sizeof (u_int32_t));
@@ -923,11 +924,16 @@ ah_output(struct mbuf *m, struct secpolicy *sp, struct secasvar *sav,
 	    ipseczeroes);
 
 	/* Insert packet replay counter, as requested.  */
-	SECASVAR_LOCK(sav);
 	if (sav->replay) {
-		if (sav->replay->count == ~0 &&
-		    (sav->flags & SADB_X_EXT_CYCSEQ) == 0) {
-			SECASVAR_UNLOCK(sav);
+		uint32_t seq;
+
+#ifdef REGRESSION
+		/* Emulate replay attack when ipsec_replay is TRUE. */
+		if (V_ipsec_replay)
+			seq = sav->replay->count;
+		else
+#endif
+		if (ipsec_replay_nextseq(sav, &seq) != 0) {
 			DPRINTF(("%s: replay counter wrapped for SA %s/%08lx\n",
 			    __func__, ipsec_address(&sav->sah->saidx.dst, buf,
 			    sizeof(buf)), (u_long) ntohl(sav->spi)));
@@ -935,15 +941,9 @@ ah_output(struct mbuf *m, struct secpolicy *sp, struct secasvar *sav,
 			error = EACCES;
 			goto bad;
 		}
-#ifdef REGRESSION
-		/* Emulate replay attack when ipsec_replay is TRUE. */
-		if (!V_ipsec_replay)
-#endif
-			sav->replay->count++;
-		ah->ah_seq = htonl(sav->replay->count);
+		ah->ah_seq = htonl(seq);
 	}
 	cryptoid = sav->tdb_cryptoid;
-	SECASVAR_UNLOCK(sav);
 
 	/* Get crypto descriptors. */
 	crp = crypto_getreq(cryptoid, M_NOWAIT);
@@ -316,12 +316,12 @@ esp_input(struct mbuf *m, struct secasvar *sav, int skip, int protoff)
 	}
 
 	/*
-	 * Check sequence number.
+	 * Check sequence number.  This is a cheap, unlocked pre-check;
+	 * the authoritative replay check runs under the SA lock in
+	 * esp_input_cb() after the ICV has been verified.
 	 */
-	SECASVAR_LOCK(sav);
 	if (esph != NULL && sav->replay != NULL && sav->replay->wsize != 0) {
 		if (ipsec_chkreplay(ntohl(esp->esp_seq), sav) == 0) {
-			SECASVAR_UNLOCK(sav);
 			DPRINTF(("%s: packet replay check for %s\n", __func__,
 			    ipsec_sa2str(sav, buf, sizeof(buf))));
 			ESPSTAT_INC(esps_replay);
@@ -330,7 +330,6 @@ esp_input(struct mbuf *m, struct secasvar *sav, int skip, int protoff)
 		}
 	}
 	cryptoid = sav->tdb_cryptoid;
-	SECASVAR_UNLOCK(sav);
 
 	/* Update the counters */
 	ESPSTAT_ADD(esps_ibytes, m->m_pkthdr.len - (skip + hlen + alen));
@@ -731,24 +730,34 @@ esp_output(struct mbuf *m, struct secpolicy *sp, struct secasvar *sav,
 	/* Initialize ESP header. */
 	bcopy((caddr_t) &sav->spi, mtod(mo, caddr_t) + roff,
 	    sizeof(uint32_t));
-	SECASVAR_LOCK(sav);
 	if (sav->replay) {
-		uint32_t replay;
+		uint32_t replay, seq;
 
 #ifdef REGRESSION
 		/* Emulate replay attack when ipsec_replay is TRUE. */
-		if (!V_ipsec_replay)
+		if (V_ipsec_replay)
+			seq = sav->replay->count;
+		else
 #endif
-			sav->replay->count++;
-		replay = htonl(sav->replay->count);
+		if (ipsec_replay_nextseq(sav, &seq) != 0) {
+			DPRINTF(("%s: replay counter wrapped for SA %s/%08lx\n",
+			    __func__, ipsec_address(&saidx->dst, buf,
+			    sizeof(buf)), (u_long) ntohl(sav->spi)));
+			ESPSTAT_INC(esps_wrap);
+			error = EACCES;
+			goto bad;
+		}
+		replay = htonl(seq);
 
 		bcopy((caddr_t) &replay, mtod(mo, caddr_t) + roff +
 		    sizeof(uint32_t), sizeof(uint32_t));
 	}
 	cryptoid = sav->tdb_cryptoid;
-	if (SAV_ISCTRORGCM(sav))
+	if (SAV_ISCTRORGCM(sav)) {
+		SECASVAR_LOCK(sav);
 		cntr = sav->cntr++;
-	SECASVAR_UNLOCK(sav);
+		SECASVAR_UNLOCK(sav);
+	}
 
 	/*
 	 * Add padding -- better to do it ourselves than use the crypto engine,
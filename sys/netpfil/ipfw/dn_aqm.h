@@ -36,6 +36,8 @@
 #ifndef _IP_DN_AQM_H
 #define _IP_DN_AQM_H
 
+#include <sys/counter.h>
+
 /* NOW is the current time in millisecond*/
 #define NOW ((dn_cfg.curr_time * tick) / 1000)
 
@@ -54,7 +56,7 @@ typedef int32_t aqm_stime_t;
 #define BOUND_VAR(x,l,h)  ((x) > (h)? (h) : ((x) > (l)? (x) : (l)))
 
 /* sysctl variable to count number of dropped packets */
-extern unsigned long io_pkt_drop; 
+extern counter_u64_t io_pkt_drop;
 
 /*
  * Structure for holding data and function pointers that together represent a
@@ -137,7 +139,7 @@ update_stats(struct dn_queue *q, int len, int drop)
 	if (drop) {
 			qni->drops++;
 			sni->drops++;
-			io_pkt_drop++;
+			counter_u64_add(io_pkt_drop, 1);
 	} else {
 		/*update queue stats */
 		qni->length += inc;
@@ -104,7 +104,7 @@ fq_update_stats(struct fq_codel_flow *q, struct fq_codel_si *si, int len,
 		si->main_q.ni.drops ++;
 		q->stats.drops ++;
 		si->_si.ni.drops ++;
-		io_pkt_drop ++;
+		counter_u64_add(io_pkt_drop, 1);
 	} 
 
 	if (!drop || (drop && len < 0)) {
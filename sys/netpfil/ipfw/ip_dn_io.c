@@ -46,6 +46,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/proc.h>
 #include <sys/rwlock.h>
 #include <sys/socket.h>
+#include <sys/counter.h>
 #include <sys/time.h>
 #include <sys/sysctl.h>
 
@@ -88,14 +89,9 @@ static long tick_lost;		/* Lost(coalesced) ticks number. */
 /* Adjusted vs non-adjusted curr_time difference (ticks). */
 static long tick_diff;
 
-static unsigned long	io_pkt;
-static unsigned long	io_pkt_fast;
-
-#ifdef NEW_AQM
-unsigned long	io_pkt_drop;
-#else
-static unsigned long	io_pkt_drop;
-#endif
+counter_u64_t	io_pkt;
+counter_u64_t	io_pkt_fast;
+counter_u64_t	io_pkt_drop;
 /*
  * We use a heap to store entities for which we have pending timer events.
  * The heap is checked at every tick and all entities with expired events
@@ -227,14 +223,14 @@ SYSCTL_INT(_net_inet_ip_dummynet, OID_AUTO, fsk_count,
     CTLFLAG_RD, DC(fsk_count), 0, "Number of flowsets");
 SYSCTL_INT(_net_inet_ip_dummynet, OID_AUTO, queue_count,
     CTLFLAG_RD, DC(queue_count), 0, "Number of queues");
-SYSCTL_ULONG(_net_inet_ip_dummynet, OID_AUTO, io_pkt,
-    CTLFLAG_RD, &io_pkt, 0,
+SYSCTL_COUNTER_U64(_net_inet_ip_dummynet, OID_AUTO, io_pkt,
+    CTLFLAG_RD, &io_pkt,
     "Number of packets passed to dummynet.");
-SYSCTL_ULONG(_net_inet_ip_dummynet, OID_AUTO, io_pkt_fast,
-    CTLFLAG_RD, &io_pkt_fast, 0,
+SYSCTL_COUNTER_U64(_net_inet_ip_dummynet, OID_AUTO, io_pkt_fast,
+    CTLFLAG_RD, &io_pkt_fast,
     "Number of packets bypassed dummynet scheduler.");
-SYSCTL_ULONG(_net_inet_ip_dummynet, OID_AUTO, io_pkt_drop,
-    CTLFLAG_RD, &io_pkt_drop, 0,
+SYSCTL_COUNTER_U64(_net_inet_ip_dummynet, OID_AUTO, io_pkt_drop,
+    CTLFLAG_RD, &io_pkt_drop,
     "Number of packets dropped by dummynet.");
 #undef DC
 SYSEND
@@ -540,7 +536,7 @@ dn_enqueue(struct dn_queue *q, struct mbuf* m, int drop)
 	return (0);
 
 drop:
-	io_pkt_drop++;
+	counter_u64_add(io_pkt_drop, 1);
 	q->ni.drops++;
 	ni->drops++;
 	FREE_PKT(m);
@@ -849,8 +845,7 @@ tag_mbuf(struct mbuf *m, int dir, struct ip_fw_args *fwa)
 	dt->rule.info &= IPFW_ONEPASS;	/* only keep this info */
 	dt->dn_dir = dir;
 	dt->ifp = fwa->flags & IPFW_ARGS_OUT ? fwa->ifp : NULL;
-	/* dt->output tame is updated as we move through */
-	dt->output_time = dn_cfg.curr_time;
+	/* dt->output_time is set by the caller under the dummynet lock */
 	dt->iphdr_off = (dir & PROTO_LAYER2) ? ETHER_HDR_LEN : 0;
 	return 0;
 }
@@ -881,11 +876,21 @@ dummynet_io(struct mbuf **m0, struct ip_fw_args *fwa)
 		dir |= PROTO_LAYER2;
 	else if (fwa->flags & IPFW_ARGS_IP6)
 		dir |= PROTO_IPV6;
+	/*
+	 * Tag the mbuf before taking the lock: the tag allocation is
+	 * the expensive part of the per-packet bookkeeping and needs
+	 * no dummynet state.  output_time is set under the lock below,
+	 * where curr_time can be read reliably.
+	 */
+	if (tag_mbuf(m, dir, fwa)) {
+		counter_u64_add(io_pkt_drop, 1);
+		FREE_PKT(m);
+		*m0 = NULL;
+		return (ENOBUFS);
+	}
+	counter_u64_add(io_pkt, 1);
 	DN_BH_WLOCK();
-	io_pkt++;
-	/* we could actually tag outside the lock, but who cares... */
-	if (tag_mbuf(m, dir, fwa))
-		goto dropit;
+	dn_tag_get(m)->output_time = dn_cfg.curr_time;
 	if (dn_cfg.busy) {
 		/* if the upper half is busy doing something expensive,
 		 * lets queue the packet and move forward
@@ -918,7 +923,7 @@ dummynet_io(struct mbuf **m0, struct ip_fw_args *fwa)
 		m = *m0 = NULL;
 
 		/* dn_enqueue already increases io_pkt_drop */
-		io_pkt_drop--;
+		counter_u64_add(io_pkt_drop, -1);
 
 		goto dropit;
 	}
@@ -956,7 +961,7 @@ dummynet_io(struct mbuf **m0, struct ip_fw_args *fwa)
 
 		tag->m_tag_cookie = MTAG_IPFW_RULE;
 		tag->m_tag_id = 0;
-		io_pkt_fast++;
+		counter_u64_add(io_pkt_fast, 1);
 		if (m->m_nextpkt != NULL) {
 			printf("dummynet: fast io: pkt chain detected!\n");
 			m->m_nextpkt = NULL;
@@ -972,7 +977,7 @@ done:
 	return 0;
 
 dropit:
-	io_pkt_drop++;
+	counter_u64_add(io_pkt_drop, 1);
 	DN_BH_WUNLOCK();
 	if (m)
 		FREE_PKT(m);
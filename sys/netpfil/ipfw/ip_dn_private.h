@@ -35,6 +35,8 @@
 #ifndef _IP_DN_PRIVATE_H
 #define _IP_DN_PRIVATE_H
 
+#include <sys/counter.h>
+
 /* debugging support
  * use ND() to remove debugging, D() to print a line,
  * DX(level, ...) to print above a certain level
@@ -404,6 +406,11 @@ extern struct dn_parms dn_cfg;
 //VNET_DECLARE(struct dn_parms, _base_dn_cfg);
 //#define dn_cfg	VNET(_base_dn_cfg)
 
+/* per-CPU io statistics, updated outside of the dummynet lock */
+extern counter_u64_t io_pkt;
+extern counter_u64_t io_pkt_fast;
+extern counter_u64_t io_pkt_drop;
+
 int dummynet_io(struct mbuf **, struct ip_fw_args *);
 void dummynet_task(void *context, int pending);
 void dn_reschedule(void);
@@ -2546,6 +2546,10 @@ ip_dn_init(void)
 	SLIST_INIT(&dn_cfg.fsu);
 	SLIST_INIT(&dn_cfg.schedlist);
 
+	io_pkt = counter_u64_alloc(M_WAITOK);
+	io_pkt_fast = counter_u64_alloc(M_WAITOK);
+	io_pkt_drop = counter_u64_alloc(M_WAITOK);
+
 	DN_LOCK_INIT();
 
 	NET_TASK_INIT(&dn_task, 0, dummynet_task, curvnet);
@@ -2585,6 +2589,10 @@ ip_dn_destroy(int last)
 	dn_ht_free(dn_cfg.fshash, 0);
 	heap_free(&dn_cfg.evheap);
 
+	counter_u64_free(io_pkt);
+	counter_u64_free(io_pkt_fast);
+	counter_u64_free(io_pkt_drop);
+
 	DN_LOCK_DESTROY();
 }
 
@@ -438,6 +438,49 @@ iface_match(struct ifnet *ifp, ipfw_insn_if *cmd, struct ip_fw_chain *chain,
 	return(0);	/* no match, fail ... */
 }
 
+/*
+ * Per-packet cache of table lookup results.
+ *
+ * Rulesets commonly consult the same table from many rules while
+ * classifying a single packet, e.g. an address table shared by a run
+ * of rules differing only in ports or actions.  Each consult repeats
+ * the full radix/hash walk even though neither the key nor the table
+ * contents can change for the duration of ipfw_chk(), which runs with
+ * the chain rlock held.  Remember the most recent (table, key) results
+ * on the stack and serve repeats from there.  A slot with keylen 0 is
+ * empty; valid keys here are 4 or 16 bytes.  Flow lookups (plen 0) and
+ * interface lookups bypass the cache.
+ */
+#define	TLOOKUP_CACHE_SLOTS	4
+struct tlookup_cache {
+	uint16_t	kidx;		/* table numeric index */
+	uint16_t	keylen;
+	int		match;
+	uint32_t	value;
+	struct in6_addr	key;
+};
+
+static __inline int
+ipfw_lookup_table_cached(struct ip_fw_chain *ch, struct tlookup_cache *tc,
+    uint16_t tbl, uint16_t plen, void *paddr, uint32_t *val)
+{
+	struct tlookup_cache *e;
+
+	e = &tc[tbl % TLOOKUP_CACHE_SLOTS];
+	if (e->keylen == plen && e->kidx == tbl &&
+	    memcmp(&e->key, paddr, plen) == 0) {
+		*val = e->value;
+		return (e->match);
+	}
+	e->kidx = tbl;
+	e->keylen = plen;
+	memcpy(&e->key, paddr, plen);
+	e->value = 0;
+	e->match = ipfw_lookup_table(ch, tbl, plen, paddr, &e->value);
+	*val = e->value;
+	return (e->match);
+}
+
 /*
  * The verify_path function checks if a route to the src exists and
  * if it is reachable via ifp (when provided).
@@ -1412,6 +1455,13 @@ ipfw_chk(struct ip_fw_args *args)
 	IPFW_RLOCK_TRACKER;
 	bool mem;
 
+	/*
+	 * Table lookups made while matching this packet are memoized
+	 * here, so rules consulting the same table with the same key
+	 * do not repeat the lookup walk.
+	 */
+	struct tlookup_cache tcache[TLOOKUP_CACHE_SLOTS] = { { 0 } };
+
 	if ((mem = (args->flags & IPFW_ARGS_LENMASK))) {
 		if (args->flags & IPFW_ARGS_ETHER) {
 			eh = (struct ether_header *)args->mem;
@@ -2073,8 +2123,9 @@ do {								\
 #endif /* !USERSPACE */
 					else
 						break;
-					match = ipfw_lookup_table(chain,
-					    cmd->arg1, keylen, pkey, &vidx);
+					match = ipfw_lookup_table_cached(chain,
+					    tcache, cmd->arg1, keylen, pkey,
+					    &vidx);
 					if (!match)
 						break;
 					tablearg = vidx;
@@ -2103,8 +2154,8 @@ do {								\
 						pkey = &args->f_id.src_ip6;
 				} else
 					break;
-				match = ipfw_lookup_table(chain, cmd->arg1,
-				    keylen, pkey, &vidx);
+				match = ipfw_lookup_table_cached(chain, tcache,
+				    cmd->arg1, keylen, pkey, &vidx);
 				if (!match)
 					break;
 				if (cmdlen == F_INSN_SIZE(ipfw_insn_u32)) {
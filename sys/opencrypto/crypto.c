@@ -152,6 +152,9 @@ static	struct mtx crypto_q_mtx;
 #define	CRYPTO_Q_LOCK()		mtx_lock(&crypto_q_mtx)
 #define	CRYPTO_Q_UNLOCK()	mtx_unlock(&crypto_q_mtx)
 
+/* Serializes completion wakeups for one-shot requests. */
+static	struct mtx crypto_oneshot_mtx;
+
 SYSCTL_NODE(_kern, OID_AUTO, crypto, CTLFLAG_RW, 0,
     "In-kernel cryptography");
 
@@ -326,6 +329,8 @@ crypto_init(void)
 	TAILQ_INIT(&crp_q);
 	TAILQ_INIT(&crp_kq);
 	mtx_init(&crypto_q_mtx, "crypto", "crypto op queues", MTX_DEF);
+	mtx_init(&crypto_oneshot_mtx, "crypto", "crypto one-shot requests",
+	    MTX_DEF);
 
 	cryptop_zone = uma_zcreate("cryptop",
 	    sizeof(struct cryptop), NULL, NULL, NULL, NULL,
@@ -490,6 +495,7 @@ crypto_destroy(void)
 	if (cryptop_zone != NULL)
 		uma_zdestroy(cryptop_zone);
 	mtx_destroy(&crypto_q_mtx);
+	mtx_destroy(&crypto_oneshot_mtx);
 	FOREACH_CRYPTO_RETW(ret_worker)
 		mtx_destroy(&ret_worker->crypto_ret_mtx);
 	free(crypto_ret_workers, M_CRYPTO_DATA);
@@ -1471,6 +1477,127 @@ crypto_batch_enqueue(struct cryptop *crp)
 	CRYPTO_Q_UNLOCK();
 }
 
+static int
+crypto_oneshot_done(struct cryptop *crp)
+{
+
+	mtx_lock(&crypto_oneshot_mtx);
+	wakeup(crp);
+	mtx_unlock(&crypto_oneshot_mtx);
+	return (0);
+}
+
+/*
+ * Perform a single synchronous symmetric operation without creating a
+ * session table entry or passing through the dispatch queues.  The
+ * caller provides the request, typically on its stack, prepared with
+ * crypto_initreq(crp, NULL) and the usual buffer and operation fields;
+ * no callback is required.  An ephemeral session is constructed around
+ * the supplied parameters, the driver is invoked directly, and the
+ * session is torn down before returning, with the function sleeping
+ * until the operation has completed.
+ *
+ * This is intended for one-shot uses such as key derivation or
+ * integrity checks of a few buffers, where the setup cost of a
+ * persistent session cannot be amortized; steady-state consumers
+ * should still create sessions.
+ */
+int
+crypto_oneshot(const struct crypto_session_params *csp, struct cryptop *crp,
+    int crid)
+{
+	struct crypto_session ses;
+	struct cryptocap *cap;
+	int error;
+
+	if (!check_csp(csp))
+		return (EINVAL);
+
+	CRYPTO_DRIVER_LOCK();
+	if ((crid & (CRYPTOCAP_F_HARDWARE | CRYPTOCAP_F_SOFTWARE)) == 0) {
+		/*
+		 * Use specified driver; verify it is capable.
+		 */
+		cap = crypto_checkdriver(crid);
+		if (cap != NULL && CRYPTODEV_PROBESESSION(cap->cc_dev, csp) > 0)
+			cap = NULL;
+	} else {
+		/*
+		 * No requested driver; select based on crid flags.
+		 */
+		cap = crypto_select_driver(csp, crid);
+	}
+	if (cap == NULL) {
+		CRYPTO_DRIVER_UNLOCK();
+		CRYPTDEB("no driver");
+		return (EOPNOTSUPP);
+	}
+	cap_ref(cap);
+	cap->cc_sessions++;
+	CRYPTO_DRIVER_UNLOCK();
+
+	memset(&ses, 0, sizeof(ses));
+	ses.cap = cap;
+	ses.csp = *csp;
+	ses.softc = malloc(cap->cc_session_size, M_CRYPTO_DATA,
+	    M_WAITOK | M_ZERO);
+
+	error = CRYPTODEV_NEWSESSION(cap->cc_dev, &ses, csp);
+	if (error != 0) {
+		CRYPTDEB("dev newsession failed: %d", error);
+		goto out;
+	}
+
+	crp->crp_session = &ses;
+	crp->crp_flags |= CRYPTO_F_CBIFSYNC;
+	crp->crp_callback = crypto_oneshot_done;
+	crp->crp_retw_id = ((uintptr_t)crp->crp_session) % crypto_workers_num;
+
+#ifdef INVARIANTS
+	crp_sanity(crp);
+#endif
+
+	CRYPTOSTAT_INC(cs_ops);
+
+	/*
+	 * Invoke the driver directly.  The session reference taken
+	 * above keeps the driver from completing an unregister
+	 * underneath us, so the migration dance crypto_invoke()
+	 * performs for queued requests is not needed.  A driver that
+	 * is temporarily out of resources is simply retried; the
+	 * synchronous software transforms this API is meant for never
+	 * return ERESTART.
+	 */
+	for (;;) {
+		error = CRYPTODEV_PROCESS(cap->cc_dev, crp, 0);
+		if (error != ERESTART)
+			break;
+		pause("crpone", hz / 10);
+	}
+
+	if (error == 0) {
+		mtx_lock(&crypto_oneshot_mtx);
+		while ((crp->crp_flags & CRYPTO_F_DONE) == 0)
+			msleep(crp, &crypto_oneshot_mtx, 0, "crpone", 0);
+		mtx_unlock(&crypto_oneshot_mtx);
+		error = crp->crp_etype;
+	}
+
+	/* Don't leave a dangling pointer to the ephemeral session. */
+	crp->crp_session = NULL;
+
+	CRYPTODEV_FREESESSION(cap->cc_dev, &ses);
+out:
+	zfree(ses.softc, M_CRYPTO_DATA);
+	CRYPTO_DRIVER_LOCK();
+	cap->cc_sessions--;
+	if (cap->cc_sessions == 0 && cap->cc_flags & CRYPTOCAP_F_CLEANUP)
+		wakeup(cap);
+	CRYPTO_DRIVER_UNLOCK();
+	cap_rele(cap);
+	return (error);
+}
+
 /*
  * Add an asymetric crypto request to a queue,
  * to be processed by the kernel thread.
@@ -656,6 +656,8 @@ extern	int crypto_getcaps(int hid);
 extern	int crypto_kregister(u_int32_t, int, u_int32_t);
 extern	int crypto_unregister_all(u_int32_t driverid);
 extern	int crypto_dispatch(struct cryptop *crp);
+extern	int crypto_oneshot(const struct crypto_session_params *csp,
+    struct cryptop *crp, int crid);
 extern	int crypto_kdispatch(struct cryptkop *);
 #define	CRYPTO_SYMQ	0x1
 #define	CRYPTO_ASYMQ	0x2
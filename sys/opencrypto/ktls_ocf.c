@@ -50,7 +50,7 @@ struct ocf_session {
 
 struct ocf_operation {
 	struct ocf_session *os;
-	bool done;
+	int done;
 };
 
 static MALLOC_DEFINE(M_KTLS_OCF, "ktls_ocf", "OCF KTLS");
@@ -94,7 +94,7 @@ ktls_ocf_callback(struct cryptop *crp)
 
 	oo = crp->crp_opaque;
 	mtx_lock(&oo->os->lock);
-	oo->done = true;
+	atomic_store_rel_int(&oo->done, 1);
 	mtx_unlock(&oo->os->lock);
 	wakeup(oo);
 	return (0);
@@ -107,7 +107,7 @@ ktls_ocf_dispatch(struct ocf_session *os, struct cryptop *crp)
 	int error;
 
 	oo.os = os;
-	oo.done = false;
+	oo.done = 0;
 
 	crp->crp_opaque = &oo;
 	crp->crp_callback = ktls_ocf_callback;
@@ -116,10 +116,17 @@ ktls_ocf_dispatch(struct ocf_session *os, struct cryptop *crp)
 		if (error)
 			break;
 
-		mtx_lock(&os->lock);
-		while (!oo.done)
-			mtx_sleep(&oo, &os->lock, 0, "ocfktls", 0);
-		mtx_unlock(&os->lock);
+		/*
+		 * Software backends run the request to completion
+		 * from crypto_dispatch() itself, so peek at the done
+		 * flag before paying for the lock and sleep.
+		 */
+		if (atomic_load_acq_int(&oo.done) == 0) {
+			mtx_lock(&os->lock);
+			while (!oo.done)
+				mtx_sleep(&oo, &os->lock, 0, "ocfktls", 0);
+			mtx_unlock(&os->lock);
+		}
 
 		if (crp->crp_etype != EAGAIN) {
 			error = crp->crp_etype;
@@ -128,7 +135,7 @@ ktls_ocf_dispatch(struct ocf_session *os, struct cryptop *crp)
 
 		crp->crp_etype = 0;
 		crp->crp_flags &= ~CRYPTO_F_DONE;
-		oo.done = false;
+		oo.done = 0;
 		counter_u64_add(ocf_retries, 1);
 	}
 	return (error);
@@ -237,7 +244,7 @@ ktls_ocf_tls12_gcm_decrypt(struct ktls_session *tls,
 	os = tls->cipher;
 
 	oo.os = os;
-	oo.done = false;
+	oo.done = 0;
 
 	crypto_initreq(&crp, os->sid);
 
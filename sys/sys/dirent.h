@@ -122,6 +122,22 @@ struct freebsd11_dirent {
 #define	_GENERIC_DIRLEN(namlen)					\
 	((__offsetof(struct dirent, d_name) + (namlen) + 1 + 7) & ~7)
 #define	_GENERIC_DIRSIZ(dp)	_GENERIC_DIRLEN((dp)->d_namlen)
+
+#include <sys/stat.h>
+
+/*
+ * Layout of the records returned by getdirentriesplus(2): the
+ * attributes of the entry, or the error encountered obtaining them,
+ * followed by the directory entry itself.  dp_dirent must be last,
+ * since its size varies.  Records are aligned to 8 byte boundaries and
+ * the next record follows dp_dirent.d_reclen bytes past dp_dirent.
+ */
+struct direntplus {
+	struct stat	dp_stat;	/* attributes of the entry */
+	int		dp_staterr;	/* errno obtaining dp_stat, or 0 */
+	int		dp_pad0;	/* reserved */
+	struct dirent	dp_dirent;	/* variable size */
+};
 #endif /* __BSD_VISIBLE */
 
 #ifdef _KERNEL
@@ -47,6 +47,7 @@
 #include <vm/vm.h>
 
 struct filedesc;
+struct sf_hdtr_kq;
 struct stat;
 struct thread;
 struct uio;
@@ -115,7 +116,8 @@ typedef	int fo_chown_t(struct file *fp, uid_t uid, gid_t gid,
 		    struct ucred *active_cred, struct thread *td);
 typedef int fo_sendfile_t(struct file *fp, int sockfd, struct uio *hdr_uio,
 		    struct uio *trl_uio, off_t offset, size_t nbytes,
-		    off_t *sent, int flags, struct thread *td);
+		    off_t *sent, int flags, struct sf_hdtr_kq *hdtr_kq,
+		    struct thread *td);
 typedef int fo_seek_t(struct file *fp, off_t offset, int whence,
 		    struct thread *td);
 typedef int fo_fill_kinfo_t(struct file *fp, struct kinfo_file *kif,
@@ -389,11 +391,11 @@ fo_chown(struct file *fp, uid_t uid, gid_t gid, struct ucred *active_cred,
 static __inline int
 fo_sendfile(struct file *fp, int sockfd, struct uio *hdr_uio,
     struct uio *trl_uio, off_t offset, size_t nbytes, off_t *sent, int flags,
-    struct thread *td)
+    struct sf_hdtr_kq *hdtr_kq, struct thread *td)
 {
 
 	return ((*fp->f_ops->fo_sendfile)(fp, sockfd, hdr_uio, trl_uio, offset,
-	    nbytes, sent, flags, td));
+	    nbytes, sent, flags, hdtr_kq, td));
 }
 
 static __inline int
@@ -96,6 +96,7 @@ struct filedesc {
 	struct	fdescenttbl *fd_files;	/* open files table */
 	smrpwd_t fd_pwd;		/* directories */
 	NDSLOTTYPE *fd_map;		/* bitmap of free fds */
+	NDSLOTTYPE *fd_fullmap;		/* bitmap of full fd_map words */
 	int	fd_freefile;		/* approx. next free file */
 	u_short	fd_cmask;		/* mask for file creation */
 	int	fd_refcnt;		/* thread reference count */
@@ -63,6 +63,19 @@ struct ktr_entry {
 	u_long	ktr_parms[KTR_PARMS];
 };
 
+/*
+ * Record layout exported by the /dev/ktr streaming interface when the
+ * per-CPU trace rings are enabled (debug.ktr.percpu).  The embedded
+ * entry uses the in-memory layout; its string pointers must be resolved
+ * against the running kernel, as ktrdump(8) does for the static buffer.
+ */
+struct ktr_io_ent {
+	u_int64_t ktr_io_seq;		/* per-CPU sequence number */
+	int	ktr_io_cpu;		/* CPU that logged the entry */
+	int	ktr_io_dropped;		/* entries lost just before this one */
+	struct	ktr_entry ktr_io_ent;
+};
+
 extern cpuset_t ktr_cpumask;
 extern uint64_t ktr_mask;
 extern int ktr_entries;
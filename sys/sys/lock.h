@@ -183,6 +183,7 @@ extern u_short locks_delay_loops;
 struct lock_delay_arg {
 	struct lock_delay_config *config;
 	u_short delay;
+	u_short waiters;
 	u_int spin_cnt;
 };
 
@@ -191,6 +192,7 @@ lock_delay_arg_init(struct lock_delay_arg *la, struct lock_delay_config *lc)
 {
 	la->config = lc;
 	la->delay = lc->base;
+	la->waiters = 1;
 	la->spin_cnt = 0;
 }
 
@@ -198,6 +200,7 @@ static inline void
 lock_delay_arg_init_noadapt(struct lock_delay_arg *la)
 {
 	la->delay = 0;
+	la->waiters = 1;
 	la->spin_cnt = 0;
 }
 
@@ -220,6 +223,8 @@ void	lock_init(struct lock_object *, struct lock_class *,
 void	lock_destroy(struct lock_object *);
 void	lock_delay(struct lock_delay_arg *);
 void	lock_delay_default_init(struct lock_delay_config *);
+u_int	lock_delay_spinner_enter(const void *);
+void	lock_delay_spinner_exit(const void *);
 void	spinlock_enter(void);
 void	spinlock_exit(void);
 void	witness_init(struct lock_object *, const char *);
@@ -39,6 +39,7 @@
 #define	_SYS_LOCKF_H_
 
 #include <sys/queue.h>
+#include <sys/tree.h>
 #include <sys/_lock.h>
 #include <sys/_sx.h>
 
@@ -49,8 +50,10 @@ struct vop_advlockasync_args;
 /*
  * The lockf_entry structure is a kernel structure which contains the
  * information associated with a byte range lock.  The lockf_entry
- * structures are linked into the inode structure. Locks are sorted by
- * the starting byte of the lock for efficiency.
+ * structures are linked into the inode structure.  Active locks are
+ * kept in an interval tree ordered by the starting byte of the lock,
+ * with each node carrying the maximum ending byte of its subtree so
+ * that overlap queries take time logarithmic in the lock count.
  *
  * Active and pending locks on a vnode are organised into a
  * graph. Each pending lock has an out-going edge to each active lock
@@ -79,12 +82,15 @@ struct lockf_entry {
 	struct	vnode *lf_vnode;    /* (c) File being locked (only valid for active lock) */
 	struct	inode *lf_inode;    /* (c) Back pointer to the inode */
 	struct	task *lf_async_task;/* (c) Async lock callback */
-	LIST_ENTRY(lockf_entry) lf_link;  /* (s) Linkage for lock lists */
+	LIST_ENTRY(lockf_entry) lf_link;  /* (s) Linkage for pending lists */
+	RB_ENTRY(lockf_entry) lf_tree;	  /* (s) Linkage for the active tree */
+	off_t	lf_subtree_end;	    /* (s) Max lf_end in this tree subtree */
 	struct lockf_edge_list lf_outedges; /* (s) list of out-edges */
 	struct lockf_edge_list lf_inedges; /* (s) list of in-edges */
 	int	lf_refs;	    /* (s) ref count */
 };
 LIST_HEAD(lockf_entry_list, lockf_entry);
+RB_HEAD(lockf_entry_tree, lockf_entry);
 
 /*
  * Extra lf_flags bits used by the implementation
@@ -96,9 +102,10 @@ LIST_HEAD(lockf_entry_list, lockf_entry);
  * pointer to a struct lockf_state. This pointer is used by the lock
  * manager to track the locking state for a file.
  *
- * The ls_active list contains the set of active locks on the file. It
- * is strictly ordered by the lock's lf_start value. Each active lock
- * will have in-coming edges to any pending lock which it blocks.
+ * The ls_active tree contains the set of active locks on the file,
+ * ordered by the lock's lf_start value and augmented with the maximum
+ * lf_end of each subtree. Each active lock will have in-coming edges
+ * to any pending lock which it blocks.
  *
  * Lock requests which are blocked by some other active lock are
  * listed in ls_pending with newer requests first in the list. Lock
@@ -116,7 +123,7 @@ LIST_HEAD(lockf_entry_list, lockf_entry);
 struct lockf {
 	LIST_ENTRY(lockf) ls_link;	/* (S) all active lockf states */
 	struct	sx	ls_lock;
-	struct	lockf_entry_list ls_active; /* (s) Active locks */
+	struct	lockf_entry_tree ls_active; /* (s) Active locks */
 	struct	lockf_entry_list ls_pending; /* (s) Pending locks */
 	int		ls_threads;	/* (i) Thread count */
 };
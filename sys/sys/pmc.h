@@ -376,6 +376,7 @@ enum pmc_ops {
 /* V2 API */
 #define	PMC_F_CALLCHAIN		0x00000080 /*OP ALLOCATE capture callchains */
 #define	PMC_F_USERCALLCHAIN	0x00000100 /*OP ALLOCATE use userspace stack */
+#define	PMC_F_AGGREGATE		0x00000200 /*OP ALLOCATE aggregate in kernel */
 
 /* internal flags */
 #define	PMC_F_ATTACHED_TO_OWNER	0x00010000 /*attached to owner*/
@@ -651,6 +652,7 @@ struct pmc_op_getdyneventinfo {
 #define	PMC_NLOGBUFFERS_PCPU			32
 #define	PMC_NSAMPLES				256
 #define	PMC_CALLCHAIN_DEPTH			128
+#define	PMC_AGGENTRIES				512
 #define	PMC_THREADLIST_MAX			128
 
 #define PMC_SYSCTL_NAME_PREFIX "kern." PMC_MODULE_NAME "."
@@ -959,6 +961,28 @@ struct pmc_samplebuffer {
 #define PMC_PROD_SAMPLE(psb)					\
 	(&(psb)->ps_samples[(psb)->ps_prodidx & pmc_sample_mask])
 
+/*
+ * struct pmc_aggent
+ *
+ * An entry in a CPU's call chain aggregation table.  Samples taken for
+ * PMCs allocated with PMC_F_AGGREGATE are folded into these entries and
+ * logged as aggregated call chain records when a table is flushed,
+ * instead of being logged one record per sample.
+ */
+
+struct pmc_aggent {
+	uint16_t		pa_nsamples;	/* callchain depth, 0 == free */
+	uint16_t		pa_cpu;		/* cpu number */
+	uint16_t		pa_flags;	/* sample flags */
+	uint16_t		pa_pad;
+	lwpid_t			pa_tid;		/* thread id of first sample */
+	pid_t			pa_pid;		/* process PID or -1 */
+	struct pmc		*pa_pmc;	/* sampling PMC */
+	uintptr_t		*pa_pc;		/* (const) callchain storage */
+	uint64_t		pa_count;	/* samples folded in */
+	uint64_t		pa_tsc;		/* tsc of first sample */
+};
+
 /*
  * struct pmc_cpustate
  *
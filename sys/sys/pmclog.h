@@ -73,7 +73,13 @@ enum pmclog_type {
 	 */
 	PMCLOG_TYPE_THR_CREATE = 18,
 	PMCLOG_TYPE_THR_EXIT = 19,
-	PMCLOG_TYPE_PROC_CREATE = 20
+	PMCLOG_TYPE_PROC_CREATE = 20,
+	/*
+	 * An aggregated variant of PMCLOG_TYPE_CALLCHAIN carrying the
+	 * number of samples folded into the call chain by in-kernel
+	 * aggregation.
+	 */
+	PMCLOG_TYPE_CALLCHAIN_AGG = 21
 };
 
 /*
@@ -122,6 +128,16 @@ struct pmclog_callchain {
 	uintptr_t		pl_pc[PMC_CALLCHAIN_DEPTH_MAX];
 } __packed;
 
+struct pmclog_callchain_agg {
+	PMCLOG_ENTRY_HEADER
+	uint32_t		pl_pid;
+	uint32_t		pl_tid;
+	uint32_t		pl_pmcid;
+	uint32_t		pl_cpuflags;
+	uint64_t		pl_count;	/* 8 byte aligned */
+	uintptr_t		pl_pc[PMC_CALLCHAIN_DEPTH_MAX];
+} __packed;
+
 #define	PMC_CALLCHAIN_CPUFLAGS_TO_CPU(CF)	(((CF) >> 16) & 0xFFFF)
 #define	PMC_CALLCHAIN_CPUFLAGS_TO_USERMODE(CF)	((CF) & PMC_CC_F_USERSPACE)
 #define	PMC_CALLCHAIN_TO_CPUFLAGS(CPU,FLAGS)	\
@@ -257,6 +273,7 @@ struct pmclog_pmcallocatedyn {
 
 union pmclog_entry {		/* only used to size scratch areas */
 	struct pmclog_callchain		pl_cc;
+	struct pmclog_callchain_agg	pl_cca;
 	struct pmclog_closelog		pl_cl;
 	struct pmclog_dropnotify	pl_dn;
 	struct pmclog_initialize	pl_i;
@@ -299,6 +316,7 @@ void	pmclog_initialize(void);
 int	pmclog_proc_create(struct thread *td, void **handlep);
 void	pmclog_proc_ignite(void *handle, struct pmc_owner *po);
 void	pmclog_process_callchain(struct pmc *_pm, struct pmc_sample *_ps);
+void	pmclog_process_callchain_agg(struct pmc *_pm, struct pmc_aggent *_pa);
 void	pmclog_process_closelog(struct pmc_owner *po);
 void	pmclog_process_dropnotify(struct pmc_owner *po);
 void	pmclog_process_map_in(struct pmc_owner *po, pid_t pid,
@@ -48,6 +48,7 @@
 #define	PRI_REALTIME		2	/* Real time process. */
 #define	PRI_TIMESHARE		3	/* Time sharing process. */
 #define	PRI_IDLE		4	/* Idle process. */
+#define	PRI_LOWLAT		5	/* Low-latency process. */
 
 /*
  * PRI_FIFO is POSIX.1B SCHED_FIFO.
@@ -516,6 +516,7 @@ do {									\
 #define	TDP_SIGFASTPENDING 0x80000000 /* Pending signal due to sigfastblock */
 
 #define	TDP2_SBPAGES	0x00000001 /* Owns sbusy on some pages */
+#define	TDP2_AIOBATCH	0x00000002 /* Defer AIO daemon wakeups */
 
 /*
  * Reasons that the current thread can not be run yet.
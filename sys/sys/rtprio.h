@@ -48,6 +48,7 @@
 #define RTP_PRIO_REALTIME	PRI_REALTIME	/* real time process */
 #define RTP_PRIO_NORMAL		PRI_TIMESHARE	/* time sharing process */
 #define RTP_PRIO_IDLE		PRI_IDLE	/* idle process */
+#define RTP_PRIO_LOWLAT		PRI_LOWLAT	/* low-latency process */
 
 /* RTP_PRIO_FIFO is POSIX.1B SCHED_FIFO.
  */
@@ -0,0 +1,107 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2021 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $FreeBSD$
+ */
+
+#ifndef _SYS_SMRHASH_H_
+#define	_SYS_SMRHASH_H_
+
+#include <sys/_smr.h>
+#include <sys/smr_types.h>
+#include <ck_queue.h>
+
+/*
+ * Generic SMR-protected resizable hash table.
+ *
+ * Lookups may run concurrently with insert, remove and resize and must
+ * be performed inside a read section of the smr passed to
+ * smrhash_init().  A link returned by smrhash_lookup() is guaranteed
+ * not to be reclaimed until the section is exited, but it may have been
+ * concurrently removed from the table; callers that need stability
+ * beyond the read section must revalidate under their own object lock
+ * or reference, just as with hand-rolled SMR lists.
+ *
+ * Writers are serialized per hash-lock stripe, so inserts and removes
+ * of entries hashing to different stripes proceed in parallel.  The
+ * table grows automatically; entries removed from the table must be
+ * freed by the caller through the smr (smr_synchronize(), smr_call() or
+ * an SMR UMA zone).
+ */
+
+struct smrhash_link {
+	CK_SLIST_ENTRY(smrhash_link) shl_entry;
+	uintptr_t	shl_hash;
+};
+
+CK_SLIST_HEAD(smrhash_head, smrhash_link);
+
+struct smrhash_table {
+	u_long		sht_mask;
+	struct smrhash_head sht_bucket[];
+};
+
+struct mtx;
+
+struct smrhash {
+	SMR_POINTER(struct smrhash_table *) sh_table;
+	smr_t		sh_smr;
+	struct mtx	*sh_locks;
+	u_int		sh_nlocks;
+	u_long		sh_count;
+	const char	*sh_name;
+};
+
+void	smrhash_init(struct smrhash *sh, const char *name, u_long nbuckets,
+	    smr_t smr);
+void	smrhash_destroy(struct smrhash *sh);
+void	smrhash_insert(struct smrhash *sh, struct smrhash_link *lp,
+	    uintptr_t hash);
+void	smrhash_remove(struct smrhash *sh, struct smrhash_link *lp);
+struct smrhash_link *smrhash_lookup(struct smrhash *sh, uintptr_t hash,
+	    bool (*match)(struct smrhash_link *, const void *),
+	    const void *key);
+
+/*
+ * Typed convenience wrappers.  SMRHASH_DEFINE_LOOKUP() generates a
+ * lookup function returning the containing object type, e.g.:
+ *
+ *	SMRHASH_DEFINE_LOOKUP(session_lookup, struct session, s_hashlink,
+ *	    session_match);
+ */
+#define	SMRHASH_OBJ(lp, type, field)					\
+	((lp) == NULL ? NULL : __containerof((lp), type, field))
+
+#define	SMRHASH_DEFINE_LOOKUP(name, type, field, matchfn)		\
+static inline type *							\
+name(struct smrhash *sh, uintptr_t hash, const void *key)		\
+{									\
+									\
+	return (SMRHASH_OBJ(smrhash_lookup(sh, hash, matchfn, key),	\
+	    type, field));						\
+}
+
+#endif /* !_SYS_SMRHASH_H_ */
@@ -630,6 +630,19 @@ struct sf_hdtr {
 	int trl_cnt;		/* number of trailer iovec's */
 };
 
+/*
+ * sendfile(2) header/trailer struct with kqueue(2) completion
+ * notification, used when SF_KQUEUE is set.  The EVFILT_SENDFILE event
+ * fires on 'kq_fd' once all data queued by the call has been sent and
+ * acknowledged; 'kq_ident' and 'kq_udata' are returned in the kevent.
+ */
+struct sf_hdtr_kq {
+	struct sf_hdtr hdtr;
+	int kq_fd;		/* kqueue to post completion on */
+	uintptr_t kq_ident;	/* ident for the completion kevent */
+	void *kq_udata;		/* opaque udata for the completion kevent */
+};
+
 /*
  * Sendfile-specific flag(s)
  */
@@ -638,6 +651,7 @@ struct sf_hdtr {
 #define	SF_SYNC		0x00000004
 #define	SF_USER_READAHEAD	0x00000008
 #define	SF_NOCACHE	0x00000010
+#define	SF_KQUEUE	0x00000020
 #define	SF_FLAGS(rh, flags)	(((rh) << 16) | (flags))
 
 #ifdef _KERNEL
@@ -512,4 +512,5 @@
 #define	SYS___realpathat	574
 #define	SYS_close_range	575
 #define	SYS_rpctls_syscall	576
-#define	SYS_MAXSYSCALL	577
+#define	SYS_getdirentriesplus	577
+#define	SYS_MAXSYSCALL	578
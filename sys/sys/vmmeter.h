@@ -140,6 +140,67 @@ struct vmmeter {
 };
 #endif /* _KERNEL || _WANT_VMMETER */
 
+/*
+ * Snapshot of the vm.stats statistics, exported in a single copy by the
+ * vm.stats.snapshot sysctl.  The leading fields mirror the counters of
+ * struct vmmeter in declaration order; keep the two in sync.
+ */
+struct vmstats_snap {
+	uint64_t v_swtch;
+	uint64_t v_trap;
+	uint64_t v_syscall;
+	uint64_t v_intr;
+	uint64_t v_soft;
+	uint64_t v_vm_faults;
+	uint64_t v_io_faults;
+	uint64_t v_cow_faults;
+	uint64_t v_cow_optim;
+	uint64_t v_zfod;
+	uint64_t v_ozfod;
+	uint64_t v_swapin;
+	uint64_t v_swapout;
+	uint64_t v_swappgsin;
+	uint64_t v_swappgsout;
+	uint64_t v_vnodein;
+	uint64_t v_vnodeout;
+	uint64_t v_vnodepgsin;
+	uint64_t v_vnodepgsout;
+	uint64_t v_intrans;
+	uint64_t v_reactivated;
+	uint64_t v_pdwakeups;
+	uint64_t v_pdpages;
+	uint64_t v_pdshortfalls;
+	uint64_t v_dfree;
+	uint64_t v_pfree;
+	uint64_t v_tfree;
+	uint64_t v_forks;
+	uint64_t v_vforks;
+	uint64_t v_rforks;
+	uint64_t v_kthreads;
+	uint64_t v_forkpages;
+	uint64_t v_vforkpages;
+	uint64_t v_rforkpages;
+	uint64_t v_kthreadpages;
+	uint64_t v_wire_count;
+	/*
+	 * Page counts and thresholds, widened for uniformity.
+	 */
+	uint64_t v_page_size;
+	uint64_t v_page_count;
+	uint64_t v_free_reserved;
+	uint64_t v_free_target;
+	uint64_t v_free_min;
+	uint64_t v_free_count;
+	uint64_t v_inactive_target;
+	uint64_t v_active_count;
+	uint64_t v_inactive_count;
+	uint64_t v_laundry_count;
+	uint64_t v_pageout_free_min;
+	uint64_t v_interrupt_free_min;
+	uint64_t v_free_severe;
+	uint64_t v_user_wire_count;
+};
+
 #ifdef _KERNEL
 
 #include <sys/domainset.h>
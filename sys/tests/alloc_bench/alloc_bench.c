@@ -0,0 +1,457 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+/*
+ * Microbenchmarks for the mbuf and UMA allocators.
+ *
+ * A run is started by writing a per-thread iteration count to the
+ * kern.allocbench.runbench sysctl, which blocks until the run is done.
+ * The kern.allocbench.nthreads and .op knobs select the number of
+ * worker threads (each bound to its own CPU) and the workload.  The
+ * local workloads allocate and free on the same CPU; the crossfree
+ * workloads pair each even-numbered producer thread with the next
+ * odd-numbered consumer thread through a lock-free ring, so items are
+ * always freed on a different CPU than they were allocated on, the way
+ * a forwarding or producer/consumer workload frees them.
+ *
+ * Every 64th operation is timed individually and folded into a log2
+ * latency histogram, exported together with the aggregate results
+ * under kern.allocbench.
+ */
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/buf_ring.h>
+#include <sys/kernel.h>
+#include <sys/kthread.h>
+#include <sys/lock.h>
+#include <sys/malloc.h>
+#include <sys/mbuf.h>
+#include <sys/module.h>
+#include <sys/mutex.h>
+#include <sys/proc.h>
+#include <sys/sbuf.h>
+#include <sys/sched.h>
+#include <sys/smp.h>
+#include <sys/sx.h>
+#include <sys/sysctl.h>
+#include <sys/time.h>
+
+#include <vm/uma.h>
+
+static MALLOC_DEFINE(M_ALLOCBENCH, "alloc_bench", "allocator benchmark state");
+
+/* Workloads that can be measured. */
+#define	AB_OP_MBUF		0	/* m_getcl/m_freem, same CPU */
+#define	AB_OP_UMA		1	/* uma_zalloc/uma_zfree, same CPU */
+#define	AB_OP_MBUF_CROSS	2	/* m_getcl, m_freem on another CPU */
+#define	AB_OP_UMA_CROSS		3	/* uma_zalloc, free on another CPU */
+#define	AB_OP_MAX		AB_OP_UMA_CROSS
+
+#define	AB_SAMPLE_PERIOD	64	/* time every Nth operation */
+#define	AB_RING_SIZE		1024	/* items in flight per thread pair */
+#define	AB_ITEM_SIZE		256	/* UMA test zone item size */
+#define	AB_NBUCKETS		40	/* log2 ns latency buckets */
+
+struct alloc_bench_worker {
+	int		abw_id;		/* worker index, selects CPU */
+	struct buf_ring	*abw_ring;	/* producer->consumer hand-off */
+	volatile int	abw_prod_done;	/* producer finished enqueueing */
+	struct thread	*abw_td;
+};
+
+static struct sx alloc_bench_sx;
+SX_SYSINIT(alloc_bench_sx, &alloc_bench_sx, "alloc bench");
+static struct mtx alloc_bench_mtx;
+MTX_SYSINIT(alloc_bench_mtx, &alloc_bench_mtx, "alloc bench state", MTX_DEF);
+
+static uma_zone_t alloc_bench_zone;
+static struct alloc_bench_worker alloc_bench_workers[MAXCPU];
+
+/* Configuration for the next run. */
+static int alloc_bench_nthreads = 1;
+static int alloc_bench_op = AB_OP_MBUF;
+
+/* State and results of the current/last run. */
+static int alloc_bench_running;
+static int alloc_bench_iterations;
+static uint64_t alloc_bench_ops;
+static uint64_t alloc_bench_failures;
+static uint64_t alloc_bench_nanosecs;
+static uint64_t alloc_bench_opspersec;
+static uint64_t alloc_bench_hist[AB_NBUCKETS];
+
+SYSCTL_NODE(_kern, OID_AUTO, allocbench, CTLFLAG_RW | CTLFLAG_MPSAFE, 0,
+    "mbuf/UMA allocator benchmarks");
+SYSCTL_INT(_kern_allocbench, OID_AUTO, nthreads, CTLFLAG_RW,
+    &alloc_bench_nthreads, 0, "worker threads for the next run");
+SYSCTL_INT(_kern_allocbench, OID_AUTO, op, CTLFLAG_RW,
+    &alloc_bench_op, 0, "workload (0=mbuf, 1=uma, 2=mbuf crossfree, "
+    "3=uma crossfree)");
+SYSCTL_U64(_kern_allocbench, OID_AUTO, ops, CTLFLAG_RD,
+    &alloc_bench_ops, 0, "operations completed in the last run");
+SYSCTL_U64(_kern_allocbench, OID_AUTO, failures, CTLFLAG_RD,
+    &alloc_bench_failures, 0, "failed allocations in the last run");
+SYSCTL_U64(_kern_allocbench, OID_AUTO, nanosecs, CTLFLAG_RD,
+    &alloc_bench_nanosecs, 0, "wall time of the last run");
+SYSCTL_U64(_kern_allocbench, OID_AUTO, opspersec, CTLFLAG_RD,
+    &alloc_bench_opspersec, 0, "operations per second in the last run");
+
+/*
+ * Fold one sampled operation latency into a thread-local log2
+ * histogram; buckets are merged into alloc_bench_hist when the worker
+ * finishes.
+ */
+static void
+alloc_bench_record(uint64_t *hist, sbintime_t delta)
+{
+	int bucket;
+
+	bucket = flsll(sbttons(delta));
+	if (bucket >= AB_NBUCKETS)
+		bucket = AB_NBUCKETS - 1;
+	hist[bucket]++;
+}
+
+/*
+ * Allocate one item for the current workload; returns NULL on
+ * allocation failure.
+ */
+static void *
+alloc_bench_alloc(int op)
+{
+
+	if (op == AB_OP_MBUF || op == AB_OP_MBUF_CROSS)
+		return (m_getcl(M_NOWAIT, MT_DATA, 0));
+	return (uma_zalloc(alloc_bench_zone, M_NOWAIT));
+}
+
+static void
+alloc_bench_free(int op, void *item)
+{
+
+	if (op == AB_OP_MBUF || op == AB_OP_MBUF_CROSS)
+		m_freem(item);
+	else
+		uma_zfree(alloc_bench_zone, item);
+}
+
+/*
+ * Same-CPU allocate/free pairs; one operation is one pair.
+ */
+static void
+alloc_bench_local(struct alloc_bench_worker *abw, uint64_t *hist,
+    uint64_t *opsp, uint64_t *failp)
+{
+	sbintime_t start;
+	void *item;
+	int i, op;
+
+	op = alloc_bench_op;
+	for (i = 0; i < alloc_bench_iterations; i++) {
+		if (i % AB_SAMPLE_PERIOD == 0) {
+			start = sbinuptime();
+			item = alloc_bench_alloc(op);
+			if (item == NULL) {
+				(*failp)++;
+				continue;
+			}
+			alloc_bench_free(op, item);
+			alloc_bench_record(hist, sbinuptime() - start);
+		} else {
+			item = alloc_bench_alloc(op);
+			if (item == NULL) {
+				(*failp)++;
+				continue;
+			}
+			alloc_bench_free(op, item);
+		}
+		(*opsp)++;
+	}
+}
+
+/*
+ * Even-numbered workers allocate and enqueue; the odd-numbered partner
+ * dequeues and frees on its own CPU.
+ */
+static void
+alloc_bench_produce(struct alloc_bench_worker *abw, uint64_t *hist,
+    uint64_t *opsp, uint64_t *failp)
+{
+	sbintime_t start;
+	void *item;
+	int i, op;
+
+	op = alloc_bench_op;
+	for (i = 0; i < alloc_bench_iterations; i++) {
+		if (i % AB_SAMPLE_PERIOD == 0) {
+			start = sbinuptime();
+			item = alloc_bench_alloc(op);
+			if (item != NULL)
+				alloc_bench_record(hist,
+				    sbinuptime() - start);
+		} else
+			item = alloc_bench_alloc(op);
+		if (item == NULL) {
+			(*failp)++;
+			continue;
+		}
+		while (buf_ring_enqueue(abw->abw_ring, item) == ENOBUFS)
+			cpu_spinwait();
+		(*opsp)++;
+	}
+	atomic_store_rel_int(&abw->abw_prod_done, 1);
+}
+
+static void
+alloc_bench_consume(struct alloc_bench_worker *abw, uint64_t *hist,
+    uint64_t *opsp)
+{
+	struct alloc_bench_worker *partner;
+	sbintime_t start;
+	void *item;
+	uint64_t n;
+	int op;
+
+	op = alloc_bench_op;
+	partner = &alloc_bench_workers[abw->abw_id - 1];
+	for (n = 0;; n++) {
+		item = buf_ring_dequeue_sc(partner->abw_ring);
+		if (item == NULL) {
+			if (atomic_load_acq_int(&partner->abw_prod_done) != 0 &&
+			    buf_ring_empty(partner->abw_ring))
+				break;
+			cpu_spinwait();
+			continue;
+		}
+		if (n % AB_SAMPLE_PERIOD == 0) {
+			start = sbinuptime();
+			alloc_bench_free(op, item);
+			alloc_bench_record(hist, sbinuptime() - start);
+		} else
+			alloc_bench_free(op, item);
+		(*opsp)++;
+	}
+}
+
+static void
+alloc_bench_worker(void *arg)
+{
+	struct alloc_bench_worker *abw;
+	struct thread *td;
+	uint64_t hist[AB_NBUCKETS], fails, ops;
+	int i, op;
+
+	abw = arg;
+	td = curthread;
+	thread_lock(td);
+	sched_bind(td, abw->abw_id % mp_ncpus);
+	thread_unlock(td);
+
+	memset(hist, 0, sizeof(hist));
+	ops = fails = 0;
+	op = alloc_bench_op;
+
+	if (op == AB_OP_MBUF || op == AB_OP_UMA)
+		alloc_bench_local(abw, hist, &ops, &fails);
+	else if ((abw->abw_id & 1) == 0)
+		alloc_bench_produce(abw, hist, &ops, &fails);
+	else
+		alloc_bench_consume(abw, hist, &ops);
+
+	thread_lock(td);
+	sched_unbind(td);
+	thread_unlock(td);
+
+	mtx_lock(&alloc_bench_mtx);
+	alloc_bench_ops += ops;
+	alloc_bench_failures += fails;
+	for (i = 0; i < AB_NBUCKETS; i++)
+		alloc_bench_hist[i] += hist[i];
+	if (--alloc_bench_running == 0)
+		wakeup(&alloc_bench_running);
+	mtx_unlock(&alloc_bench_mtx);
+	kthread_exit();
+}
+
+static int
+alloc_bench_execute(SYSCTL_HANDLER_ARGS)
+{
+	struct alloc_bench_worker *abw;
+	sbintime_t delta, start;
+	int error, i, nthreads, v;
+
+	v = 0;
+	error = sysctl_handle_int(oidp, &v, 0, req);
+	if (error != 0 || req->newptr == NULL)
+		return (error);
+	if (v <= 0 || alloc_bench_op < 0 || alloc_bench_op > AB_OP_MAX)
+		return (EINVAL);
+
+	sx_xlock(&alloc_bench_sx);
+	nthreads = alloc_bench_nthreads;
+	if (nthreads < 1)
+		nthreads = 1;
+	else if (nthreads > mp_ncpus)
+		nthreads = mp_ncpus;
+	/* Crossfree workloads run in producer/consumer pairs. */
+	if ((alloc_bench_op == AB_OP_MBUF_CROSS ||
+	    alloc_bench_op == AB_OP_UMA_CROSS) &&
+	    (nthreads & 1) != 0) {
+		if (nthreads == 1) {
+			sx_xunlock(&alloc_bench_sx);
+			return (EINVAL);
+		}
+		nthreads--;
+	}
+
+	alloc_bench_iterations = v;
+	alloc_bench_ops = 0;
+	alloc_bench_failures = 0;
+	memset(alloc_bench_hist, 0, sizeof(alloc_bench_hist));
+	alloc_bench_running = nthreads;
+
+	for (i = 0; i < nthreads; i++) {
+		abw = &alloc_bench_workers[i];
+		abw->abw_id = i;
+		abw->abw_prod_done = 0;
+		if (abw->abw_ring == NULL)
+			abw->abw_ring = buf_ring_alloc(AB_RING_SIZE,
+			    M_ALLOCBENCH, M_WAITOK, NULL);
+	}
+
+	start = sbinuptime();
+	for (i = 0; i < nthreads; i++) {
+		abw = &alloc_bench_workers[i];
+		error = kthread_add(alloc_bench_worker, abw, NULL,
+		    &abw->abw_td, 0, 0, "alloc_bench_%d", i);
+		if (error != 0) {
+			mtx_lock(&alloc_bench_mtx);
+			alloc_bench_running -= nthreads - i;
+			mtx_unlock(&alloc_bench_mtx);
+			break;
+		}
+	}
+
+	mtx_lock(&alloc_bench_mtx);
+	while (alloc_bench_running > 0)
+		msleep(&alloc_bench_running, &alloc_bench_mtx, 0,
+		    "abench", 0);
+	mtx_unlock(&alloc_bench_mtx);
+	delta = sbinuptime() - start;
+
+	alloc_bench_nanosecs = sbttons(delta);
+	if (alloc_bench_nanosecs != 0)
+		alloc_bench_opspersec = alloc_bench_ops * 1000000000ULL /
+		    alloc_bench_nanosecs;
+	else
+		alloc_bench_opspersec = 0;
+	sx_xunlock(&alloc_bench_sx);
+
+	return (error);
+}
+
+SYSCTL_PROC(_kern_allocbench, OID_AUTO, runbench,
+    CTLTYPE_INT | CTLFLAG_RW | CTLFLAG_MPSAFE,
+    0, 0, alloc_bench_execute, "I",
+    "run a benchmark with the given per-thread iteration count");
+
+/*
+ * Dump the sampled latency histogram of the last run, one
+ * "<bucket upper bound in ns> <count>" line per occupied bucket.
+ */
+static int
+alloc_bench_histogram(SYSCTL_HANDLER_ARGS)
+{
+	struct sbuf sb;
+	int error, i;
+
+	error = sysctl_wire_old_buffer(req, 0);
+	if (error != 0)
+		return (error);
+	sbuf_new_for_sysctl(&sb, NULL, 128, req);
+	sx_xlock(&alloc_bench_sx);
+	for (i = 0; i < AB_NBUCKETS; i++) {
+		if (alloc_bench_hist[i] == 0)
+			continue;
+		sbuf_printf(&sb, "%ju %ju\n", (uintmax_t)1 << i,
+		    (uintmax_t)alloc_bench_hist[i]);
+	}
+	sx_xunlock(&alloc_bench_sx);
+	error = sbuf_finish(&sb);
+	sbuf_delete(&sb);
+	return (error);
+}
+
+SYSCTL_PROC(_kern_allocbench, OID_AUTO, histogram,
+    CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_MPSAFE,
+    0, 0, alloc_bench_histogram, "A",
+    "sampled ns/op histogram of the last run (log2 buckets)");
+
+static int
+alloc_bench_module_event_handler(module_t mod, int what, void *arg __unused)
+{
+	int i;
+
+	switch (what) {
+	case MOD_LOAD:
+		alloc_bench_zone = uma_zcreate("alloc_bench", AB_ITEM_SIZE,
+		    NULL, NULL, NULL, NULL, UMA_ALIGN_CACHE, 0);
+		break;
+	case MOD_UNLOAD:
+		/* Fail the unload rather than wait out a running bench. */
+		if (sx_try_xlock(&alloc_bench_sx) == 0)
+			return (EBUSY);
+		for (i = 0; i < MAXCPU; i++) {
+			if (alloc_bench_workers[i].abw_ring != NULL) {
+				buf_ring_free(alloc_bench_workers[i].abw_ring,
+				    M_ALLOCBENCH);
+				alloc_bench_workers[i].abw_ring = NULL;
+			}
+		}
+		uma_zdestroy(alloc_bench_zone);
+		sx_xunlock(&alloc_bench_sx);
+		break;
+	default:
+		return (EOPNOTSUPP);
+	}
+
+	return (0);
+}
+
+static moduledata_t alloc_bench_moduledata = {
+	"alloc_bench",
+	alloc_bench_module_event_handler,
+	NULL
+};
+
+MODULE_VERSION(alloc_bench, 1);
+DECLARE_MODULE(alloc_bench, alloc_bench_moduledata, SI_SUB_PSEUDO,
+    SI_ORDER_ANY);
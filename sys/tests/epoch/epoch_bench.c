@@ -0,0 +1,356 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+/*
+ * Microbenchmarks for the epoch(9) and smr(9) reclamation primitives.
+ *
+ * A run is started by writing a per-thread iteration count to the
+ * kern.epochbench.runbench sysctl, which blocks until the run is done.
+ * The kern.epochbench.nthreads, .op and .writepct knobs select the
+ * number of worker threads (each bound to its own CPU, so sweeping
+ * nthreads from 1 to hw.ncpu sweeps contention), the primitive under
+ * test, and the percentage of iterations that exercise the write side
+ * (deferred reclamation) rather than a read section.  Aggregate results
+ * are exported under kern.epochbench for post-processing.
+ */
+
+#include <sys/param.h>
+#include <sys/systm.h>
+#include <sys/counter.h>
+#include <sys/epoch.h>
+#include <sys/kernel.h>
+#include <sys/kthread.h>
+#include <sys/lock.h>
+#include <sys/malloc.h>
+#include <sys/module.h>
+#include <sys/mutex.h>
+#include <sys/proc.h>
+#include <sys/sched.h>
+#include <sys/smp.h>
+#include <sys/smr.h>
+#include <sys/sx.h>
+#include <sys/sysctl.h>
+#include <sys/time.h>
+
+static MALLOC_DEFINE(M_EPOCHBENCH, "epoch_bench", "epoch benchmark records");
+
+/* Primitives that can be measured. */
+#define	EB_OP_EPOCH_PREEMPT	0	/* epoch_enter/exit_preempt */
+#define	EB_OP_EPOCH		1	/* epoch_enter/exit */
+#define	EB_OP_SMR		2	/* smr_enter/exit */
+#define	EB_OP_CALL_DRAIN	3	/* epoch_call + drain batches */
+#define	EB_OP_MAX		EB_OP_CALL_DRAIN
+
+#define	EB_CALL_BATCH		64	/* epoch_call records per drain */
+
+struct epoch_bench_worker {
+	int		ebw_id;		/* worker index, selects CPU */
+	struct thread	*ebw_td;
+};
+
+/*
+ * A deferred-free record; the epoch callback releases it, modelling the
+ * common "free after grace period" write-side pattern.
+ */
+struct epoch_bench_call {
+	struct epoch_context ebc_ctx;
+};
+
+static struct sx epoch_bench_sx;
+SX_SYSINIT(epoch_bench_sx, &epoch_bench_sx, "epoch bench");
+static struct mtx epoch_bench_mtx;
+MTX_SYSINIT(epoch_bench_mtx, &epoch_bench_mtx, "epoch bench state", MTX_DEF);
+
+static epoch_t epoch_bench_preempt;
+static epoch_t epoch_bench_crit;
+static smr_t epoch_bench_smr;
+
+static struct epoch_bench_worker epoch_bench_workers[MAXCPU];
+
+/* Configuration for the next run. */
+static int epoch_bench_nthreads = 1;
+static int epoch_bench_op = EB_OP_EPOCH_PREEMPT;
+static int epoch_bench_writepct = 0;
+
+/* State and results of the current/last run. */
+static int epoch_bench_running;
+static int epoch_bench_iterations;
+static uint64_t epoch_bench_reads;
+static uint64_t epoch_bench_writes;
+static volatile uint64_t epoch_bench_drained;
+static uint64_t epoch_bench_nanosecs;
+static uint64_t epoch_bench_opspersec;
+
+SYSCTL_NODE(_kern, OID_AUTO, epochbench, CTLFLAG_RW | CTLFLAG_MPSAFE, 0,
+    "Epoch/SMR benchmarks");
+SYSCTL_INT(_kern_epochbench, OID_AUTO, nthreads, CTLFLAG_RW,
+    &epoch_bench_nthreads, 0, "worker threads for the next run");
+SYSCTL_INT(_kern_epochbench, OID_AUTO, op, CTLFLAG_RW,
+    &epoch_bench_op, 0, "primitive to measure (0=epoch_preempt, 1=epoch, "
+    "2=smr, 3=epoch_call drain)");
+SYSCTL_INT(_kern_epochbench, OID_AUTO, writepct, CTLFLAG_RW,
+    &epoch_bench_writepct, 0, "percentage of iterations doing write-side work");
+SYSCTL_U64(_kern_epochbench, OID_AUTO, reads, CTLFLAG_RD,
+    &epoch_bench_reads, 0, "read sections completed in the last run");
+SYSCTL_U64(_kern_epochbench, OID_AUTO, writes, CTLFLAG_RD,
+    &epoch_bench_writes, 0, "write-side operations completed in the last run");
+SYSCTL_U64(_kern_epochbench, OID_AUTO, nanosecs, CTLFLAG_RD,
+    &epoch_bench_nanosecs, 0, "wall time of the last run");
+SYSCTL_U64(_kern_epochbench, OID_AUTO, opspersec, CTLFLAG_RD,
+    &epoch_bench_opspersec, 0, "operations per second in the last run");
+
+static void
+epoch_bench_cb(epoch_context_t ctx)
+{
+	struct epoch_bench_call *ebc;
+
+	ebc = __containerof(ctx, struct epoch_bench_call, ebc_ctx);
+	free(ebc, M_EPOCHBENCH);
+	atomic_add_64(&epoch_bench_drained, 1);
+}
+
+/*
+ * Enqueue one deferred-free record; returns false if allocation failed
+ * and the iteration should be counted as skipped.
+ */
+static bool
+epoch_bench_call_one(epoch_t epoch)
+{
+	struct epoch_bench_call *ebc;
+
+	ebc = malloc(sizeof(*ebc), M_EPOCHBENCH, M_NOWAIT | M_ZERO);
+	if (ebc == NULL)
+		return (false);
+	epoch_call(epoch, epoch_bench_cb, &ebc->ebc_ctx);
+	return (true);
+}
+
+static void
+epoch_bench_worker(void *arg)
+{
+	struct epoch_bench_worker *ebw;
+	struct epoch_tracker et;
+	struct thread *td;
+	uint64_t reads, writes;
+	int i, iterations, op, writepct;
+
+	ebw = arg;
+	td = curthread;
+	thread_lock(td);
+	sched_bind(td, ebw->ebw_id % mp_ncpus);
+	thread_unlock(td);
+
+	iterations = epoch_bench_iterations;
+	op = epoch_bench_op;
+	writepct = epoch_bench_writepct;
+	reads = writes = 0;
+
+	switch (op) {
+	case EB_OP_EPOCH_PREEMPT:
+		for (i = 0; i < iterations; i++) {
+			if (writepct != 0 && i % 100 < writepct) {
+				if (epoch_bench_call_one(epoch_bench_preempt))
+					writes++;
+			} else {
+				epoch_enter_preempt(epoch_bench_preempt, &et);
+				epoch_exit_preempt(epoch_bench_preempt, &et);
+				reads++;
+			}
+		}
+		break;
+	case EB_OP_EPOCH:
+		for (i = 0; i < iterations; i++) {
+			if (writepct != 0 && i % 100 < writepct) {
+				if (epoch_bench_call_one(epoch_bench_crit))
+					writes++;
+			} else {
+				epoch_enter(epoch_bench_crit);
+				epoch_exit(epoch_bench_crit);
+				reads++;
+			}
+		}
+		break;
+	case EB_OP_SMR:
+		for (i = 0; i < iterations; i++) {
+			if (writepct != 0 && i % 100 < writepct) {
+				(void) smr_advance(epoch_bench_smr);
+				writes++;
+			} else {
+				smr_enter(epoch_bench_smr);
+				smr_exit(epoch_bench_smr);
+				reads++;
+			}
+		}
+		break;
+	case EB_OP_CALL_DRAIN:
+		/*
+		 * Measure enqueue-and-drain throughput: fill a batch of
+		 * deferred calls, then force them through the grace
+		 * period machinery.
+		 */
+		for (i = 0; i < iterations; i++) {
+			if (epoch_bench_call_one(epoch_bench_preempt))
+				writes++;
+			if ((i + 1) % EB_CALL_BATCH == 0)
+				epoch_drain_callbacks(epoch_bench_preempt);
+		}
+		epoch_drain_callbacks(epoch_bench_preempt);
+		break;
+	}
+
+	thread_lock(td);
+	sched_unbind(td);
+	thread_unlock(td);
+
+	mtx_lock(&epoch_bench_mtx);
+	epoch_bench_reads += reads;
+	epoch_bench_writes += writes;
+	if (--epoch_bench_running == 0)
+		wakeup(&epoch_bench_running);
+	mtx_unlock(&epoch_bench_mtx);
+	kthread_exit();
+}
+
+static int
+epoch_bench_execute(SYSCTL_HANDLER_ARGS)
+{
+	struct epoch_bench_worker *ebw;
+	sbintime_t delta, start;
+	uint64_t total;
+	int error, i, nthreads, v;
+
+	v = 0;
+	error = sysctl_handle_int(oidp, &v, 0, req);
+	if (error != 0 || req->newptr == NULL)
+		return (error);
+	if (v <= 0 || epoch_bench_op < 0 || epoch_bench_op > EB_OP_MAX ||
+	    epoch_bench_writepct < 0 || epoch_bench_writepct > 100)
+		return (EINVAL);
+
+	sx_xlock(&epoch_bench_sx);
+	nthreads = epoch_bench_nthreads;
+	if (nthreads < 1)
+		nthreads = 1;
+	else if (nthreads > mp_ncpus)
+		nthreads = mp_ncpus;
+
+	epoch_bench_iterations = v;
+	epoch_bench_reads = 0;
+	epoch_bench_writes = 0;
+	epoch_bench_drained = 0;
+	epoch_bench_running = nthreads;
+
+	start = sbinuptime();
+	for (i = 0; i < nthreads; i++) {
+		ebw = &epoch_bench_workers[i];
+		ebw->ebw_id = i;
+		error = kthread_add(epoch_bench_worker, ebw, NULL,
+		    &ebw->ebw_td, 0, 0, "epoch_bench_%d", i);
+		if (error != 0) {
+			mtx_lock(&epoch_bench_mtx);
+			epoch_bench_running -= nthreads - i;
+			mtx_unlock(&epoch_bench_mtx);
+			break;
+		}
+	}
+
+	mtx_lock(&epoch_bench_mtx);
+	while (epoch_bench_running > 0)
+		msleep(&epoch_bench_running, &epoch_bench_mtx, 0,
+		    "ebench", 0);
+	mtx_unlock(&epoch_bench_mtx);
+	delta = sbinuptime() - start;
+
+	/*
+	 * Make sure every deferred-free record has been reclaimed
+	 * before reporting, so back-to-back runs do not overlap.
+	 */
+	if (epoch_bench_writes > 0 && epoch_bench_op != EB_OP_SMR) {
+		epoch_drain_callbacks(epoch_bench_op == EB_OP_EPOCH ?
+		    epoch_bench_crit : epoch_bench_preempt);
+		KASSERT(epoch_bench_drained == epoch_bench_writes,
+		    ("epoch_bench: %ju of %ju callbacks drained",
+		    (uintmax_t)epoch_bench_drained,
+		    (uintmax_t)epoch_bench_writes));
+	}
+
+	epoch_bench_nanosecs = sbttons(delta);
+	total = epoch_bench_reads + epoch_bench_writes;
+	if (epoch_bench_nanosecs != 0)
+		epoch_bench_opspersec = total * 1000000000ULL /
+		    epoch_bench_nanosecs;
+	else
+		epoch_bench_opspersec = 0;
+	sx_xunlock(&epoch_bench_sx);
+
+	return (error);
+}
+
+SYSCTL_PROC(_kern_epochbench, OID_AUTO, runbench,
+    CTLTYPE_INT | CTLFLAG_RW | CTLFLAG_MPSAFE,
+    0, 0, epoch_bench_execute, "I",
+    "run a benchmark with the given per-thread iteration count");
+
+static int
+epoch_bench_module_event_handler(module_t mod, int what, void *arg __unused)
+{
+
+	switch (what) {
+	case MOD_LOAD:
+		epoch_bench_preempt = epoch_alloc("epoch_bench_preempt",
+		    EPOCH_PREEMPT);
+		epoch_bench_crit = epoch_alloc("epoch_bench", 0);
+		epoch_bench_smr = smr_create("epoch_bench", 0, 0);
+		break;
+	case MOD_UNLOAD:
+		/* Fail the unload rather than wait out a running bench. */
+		if (sx_try_xlock(&epoch_bench_sx) == 0)
+			return (EBUSY);
+		smr_destroy(epoch_bench_smr);
+		epoch_free(epoch_bench_crit);
+		epoch_free(epoch_bench_preempt);
+		sx_xunlock(&epoch_bench_sx);
+		break;
+	default:
+		return (EOPNOTSUPP);
+	}
+
+	return (0);
+}
+
+static moduledata_t epoch_bench_moduledata = {
+	"epoch_bench",
+	epoch_bench_module_event_handler,
+	NULL
+};
+
+MODULE_VERSION(epoch_bench, 1);
+DECLARE_MODULE(epoch_bench, epoch_bench_moduledata, SI_SUB_PSEUDO,
+    SI_ORDER_ANY);
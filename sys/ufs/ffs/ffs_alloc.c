@@ -201,6 +201,17 @@ retry:
 	if (bno > 0) {
 		delta = btodb(size);
 		DIP_SET(ip, i_blocks, DIP(ip, i_blocks) + delta);
+		/*
+		 * Track the length of the contiguous run being laid
+		 * down.  The block preference for a sequential write is
+		 * the block following the previous allocation, so
+		 * getting it back means the run was extended.  The read
+		 * path uses this to size clusters to the actual layout.
+		 */
+		if (lbn > 0 && bno == bpref)
+			ip->i_clusterlen++;
+		else
+			ip->i_clusterlen = 1;
 		if (flags & IO_EXT)
 			UFS_INODE_SET_FLAG(ip, IN_CHANGE);
 		else
@@ -690,6 +701,8 @@ ffs_reallocblks_ufs1(ap)
 		goto fail;
 	}
 	ip->i_nextclustercg = -1;
+	if (len > ip->i_clusterlen)
+		ip->i_clusterlen = len;
 	/*
 	 * We have found a new contiguous block.
 	 *
@@ -955,6 +968,8 @@ ffs_reallocblks_ufs2(ap)
 		goto fail;
 	}
 	ip->i_nextclustercg = -1;
+	if (len > ip->i_clusterlen)
+		ip->i_clusterlen = len;
 	/*
 	 * We have found a new contiguous block.
 	 *
@@ -1285,6 +1285,7 @@ static struct callout softdep_callout;
 static int req_clear_inodedeps;	/* syncer process flush some inodedeps */
 static int req_clear_remove;	/* syncer process flush some freeblks */
 static int softdep_flushcache = 0; /* Should we do BIO_FLUSH? */
+static int softdep_groupcommit_usec = 500; /* Journal aggregation window */
 
 /*
  * runtime statistics
@@ -1305,6 +1306,7 @@ static int stat_jnewblk;	/* bufs redirtied as blk bitmap can not write */
 static int stat_journal_min;	/* Times hit journal min threshold */
 static int stat_journal_low;	/* Times hit journal low threshold */
 static int stat_journal_wait;	/* Times blocked in jwait(). */
+static int stat_journal_groupcommit; /* Group commit filled a journal block */
 static int stat_jwait_filepage;	/* Times blocked in jwait() for filepage. */
 static int stat_jwait_freeblks;	/* Times blocked in jwait() for freeblks. */
 static int stat_jwait_inode;	/* Times blocked in jwait() for inodes. */
@@ -1352,6 +1354,8 @@ SYSCTL_INT(_debug_softdep, OID_AUTO, journal_min,
     CTLFLAG_RW | CTLFLAG_STATS, &stat_journal_min, 0, "");
 SYSCTL_INT(_debug_softdep, OID_AUTO, journal_wait,
     CTLFLAG_RW | CTLFLAG_STATS, &stat_journal_wait, 0, "");
+SYSCTL_INT(_debug_softdep, OID_AUTO, journal_groupcommit,
+    CTLFLAG_RW | CTLFLAG_STATS, &stat_journal_groupcommit, 0, "");
 SYSCTL_INT(_debug_softdep, OID_AUTO, jwait_filepage,
     CTLFLAG_RW | CTLFLAG_STATS, &stat_jwait_filepage, 0, "");
 SYSCTL_INT(_debug_softdep, OID_AUTO, jwait_freeblks,
@@ -1373,6 +1377,8 @@ SYSCTL_INT(_debug_softdep, OID_AUTO, cleanup_failures,
 
 SYSCTL_INT(_debug_softdep, OID_AUTO, flushcache, CTLFLAG_RW,
     &softdep_flushcache, 0, "");
+SYSCTL_INT(_debug_softdep, OID_AUTO, groupcommit_usec, CTLFLAG_RW,
+    &softdep_groupcommit_usec, 0, "");
 SYSCTL_INT(_debug_softdep, OID_AUTO, emptyjblocks, CTLFLAG_RD,
     &stat_emptyjblocks, 0, "");
 
@@ -2897,6 +2903,8 @@ add_to_journal(wk)
 	struct worklist *wk;
 {
 	struct ufsmount *ump;
+	int devbsize;
+	int jrecmax;
 
 	ump = VFSTOUFS(wk->wk_mp);
 	LOCK_OWNED(ump);
@@ -2911,6 +2919,17 @@ add_to_journal(wk)
 		LIST_INSERT_AFTER(ump->softdep_journal_tail, wk, wk_list);
 	ump->softdep_journal_tail = wk;
 	ump->softdep_on_journal += 1;
+	/*
+	 * Wake any group commit waiter in softdep_process_journal() once
+	 * enough records have accumulated to fill its segment.
+	 */
+	if (__predict_false(ump->softdep_jgcwaiters != 0)) {
+		devbsize = ump->um_devvp->v_bufobj.bo_bsize;
+		jrecmax = (ump->um_fs->fs_bsize / devbsize) *
+		    ((devbsize / JREC_SIZE) - 1);
+		if (ump->softdep_on_journal >= jrecmax - 1)
+			wakeup(&ump->softdep_journal_pending);
+	}
 }
 
 /*
@@ -3426,6 +3445,33 @@ softdep_process_journal(mp, needwk, flags)
 	 */
 	jrecmin = (devbsize / JREC_SIZE) - 1; /* -1 for seg header */
 	jrecmax = (fs->fs_bsize / devbsize) * jrecmin;
+	/*
+	 * Group commit.  A caller waiting on a specific record would
+	 * otherwise force an immediate partial segment write, paying a
+	 * journal I/O per operation cluster.  If the pending records do
+	 * not yet fill a block, yield the lock for a bounded interval so
+	 * that concurrent operations can append their records and share
+	 * one contiguous write.  add_to_journal() wakes us early once a
+	 * full block has accumulated.  needwk is only compared by address
+	 * below, so this remains safe if another thread writes the
+	 * segment containing it while we sleep; the caller will loop if
+	 * the record it cares about was not written.
+	 */
+	if (needwk != NULL && flags == MNT_WAIT &&
+	    softdep_groupcommit_usec != 0 &&
+	    ump->softdep_on_journal < jrecmax - 1) {
+		ump->softdep_jgcwaiters++;
+		while (ump->softdep_on_journal < jrecmax - 1) {
+			if (msleep_sbt(&ump->softdep_journal_pending,
+			    LOCK_PTR(ump), PRIBIO, "sujgc",
+			    softdep_groupcommit_usec * SBT_1US, 0, 0) ==
+			    EWOULDBLOCK)
+				break;
+		}
+		ump->softdep_jgcwaiters--;
+		if (ump->softdep_on_journal >= jrecmax - 1)
+			stat_journal_groupcommit++;
+	}
 	segwritten = 0;
 	for (;;) {
 		cnt = ump->softdep_on_journal;
@@ -583,6 +583,15 @@ ffs_read(ap)
 	seqcount = ap->a_ioflag >> IO_SEQSHIFT;
 	ip = VTOI(vp);
 
+	/*
+	 * If the allocator recorded a contiguous run for this file, size
+	 * clusters to the layout instead of ramping the read-ahead window
+	 * up one block at a time.  Random access (seqcount == 0) keeps
+	 * its behavior; cluster_read() clamps against vfs.read_max.
+	 */
+	if (seqcount > 0 && ip->i_clusterlen > seqcount)
+		seqcount = ip->i_clusterlen;
+
 #ifdef INVARIANTS
 	if (uio->uio_rw != UIO_READ)
 		panic("ffs_read: mode");
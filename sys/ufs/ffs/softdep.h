@@ -1065,6 +1065,7 @@ struct mount_softdeps {
 	struct	indir_hashhead *sd_indirhash;	/* indir hash table */
 	u_long	sd_indirhashsize;		/* indir hash table size-1 */
 	int	sd_on_journal;			/* Items on the journal list */
+	int	sd_jgcwaiters;			/* Group commit waiters */
 	int	sd_on_worklist;			/* Items on the worklist */
 	int	sd_deps;			/* Total dependency count */
 	int	sd_accdeps;			/* accumulated dep count */
@@ -1111,6 +1112,7 @@ struct mount_softdeps {
 #define	indir_hashtbl			um_softdep->sd_indirhash
 #define	indir_hash_size			um_softdep->sd_indirhashsize
 #define	softdep_on_journal		um_softdep->sd_on_journal
+#define	softdep_jgcwaiters		um_softdep->sd_jgcwaiters
 #define	softdep_on_worklist		um_softdep->sd_on_worklist
 #define	softdep_deps			um_softdep->sd_deps
 #define	softdep_accdeps			um_softdep->sd_accdeps
@@ -96,6 +96,7 @@ struct inode {
 	doff_t	  i_offset;	/* Offset of free space in directory. */
 
 	int	i_nextclustercg; /* last cg searched for cluster */
+	int	i_clusterlen;	/* blocks in last contiguous run allocated */
 
 	/*
 	 * Data for extended attribute modification.
@@ -790,7 +790,7 @@ swp_pager_getswapspace(int *io_npages)
 {
 	daddr_t blk;
 	struct swdevt *sp;
-	int mpages, npages;
+	int maxpages, mpages, npages;
 
 	KASSERT(*io_npages >= 1,
 	    ("%s: npages not positive", __func__));
@@ -802,8 +802,21 @@ swp_pager_getswapspace(int *io_npages)
 	while (!TAILQ_EMPTY(&swtailq)) {
 		if (sp == NULL)
 			sp = TAILQ_FIRST(&swtailq);
-		if ((sp->sw_flags & SW_CLOSING) == 0)
-			blk = blist_alloc(sp->sw_blist, &npages, mpages);
+		if ((sp->sw_flags & SW_CLOSING) == 0) {
+			/*
+			 * Prefer allocations that are a multiple of the
+			 * device's optimal I/O size so that clustered writes
+			 * line up with it, unless rounding down would drop
+			 * below the required minimum.
+			 */
+			maxpages = mpages;
+			if (sp->sw_optpages > 1 && maxpages > sp->sw_optpages)
+				maxpages = rounddown(maxpages,
+				    sp->sw_optpages);
+			if (maxpages < npages)
+				maxpages = mpages;
+			blk = blist_alloc(sp->sw_blist, &npages, maxpages);
+		}
 		if (blk != SWAPBLK_NONE)
 			break;
 		sp = TAILQ_NEXT(sp, sw_list);
@@ -2364,7 +2377,8 @@ swapon_check_swzone(void)
 
 static void
 swaponsomething(struct vnode *vp, void *id, u_long nblks,
-    sw_strategy_t *strategy, sw_close_t *close, dev_t dev, int flags)
+    sw_strategy_t *strategy, sw_close_t *close, dev_t dev, int flags,
+    int optpages)
 {
 	struct swdevt *sp, *tsp;
 	daddr_t dvbase;
@@ -2385,6 +2399,7 @@ swaponsomething(struct vnode *vp, void *id, u_long nblks,
 	sp->sw_dev = dev;
 	sp->sw_nblks = nblks;
 	sp->sw_used = 0;
+	sp->sw_optpages = optpages;
 	sp->sw_strategy = strategy;
 	sp->sw_close = close;
 	sp->sw_flags = flags;
@@ -2755,31 +2770,45 @@ swapgeom_close_ev(void *arg, int flags)
 }
 
 /*
- * Add a reference to the g_consumer for an inflight transaction.
+ * Add a reference to the g_consumer for an inflight transaction.  Returns
+ * false, and takes no reference, if the consumer is already being closed.
+ * The caller must hold sw_dev_mtx so that the consumer cannot be destroyed
+ * while its reference count is sampled.
  */
-static void
+static bool
 swapgeom_acquire(struct g_consumer *cp)
 {
+	u_int old;
 
 	mtx_assert(&sw_dev_mtx, MA_OWNED);
-	cp->index++;
+	old = cp->index;
+	for (;;) {
+		if (old == 0)
+			return (false);
+		if (atomic_fcmpset_int((u_int *)&cp->index, &old, old + 1) != 0)
+			return (true);
+	}
 }
 
 /*
  * Remove a reference from the g_consumer.  Post a close event if all
  * references go away, since the function might be called from the
- * biodone context.
+ * biodone context.  The reference count is maintained with atomics and
+ * sw_dev_mtx is only taken on the final release, so that swap I/O
+ * completions on different CPUs do not serialize on the global lock.
  */
 static void
 swapgeom_release(struct g_consumer *cp, struct swdevt *sp)
 {
 
-	mtx_assert(&sw_dev_mtx, MA_OWNED);
-	cp->index--;
-	if (cp->index == 0) {
-		if (g_post_event(swapgeom_close_ev, cp, M_NOWAIT, NULL) == 0)
-			sp->sw_id = NULL;
-	}
+	atomic_thread_fence_rel();
+	if (atomic_fetchadd_int((u_int *)&cp->index, -1) != 1)
+		return;
+	atomic_thread_fence_acq();
+	mtx_lock(&sw_dev_mtx);
+	if (g_post_event(swapgeom_close_ev, cp, M_NOWAIT, NULL) == 0)
+		sp->sw_id = NULL;
+	mtx_unlock(&sw_dev_mtx);
 }
 
 static void
@@ -2799,9 +2828,7 @@ swapgeom_done(struct bio *bp2)
 	bp->b_caller1 = NULL;
 	bufdone(bp);
 	sp = bp2->bio_caller1;
-	mtx_lock(&sw_dev_mtx);
 	swapgeom_release(cp, sp);
-	mtx_unlock(&sw_dev_mtx);
 	g_destroy_bio(bp2);
 }
 
@@ -2813,23 +2840,20 @@ swapgeom_strategy(struct buf *bp, struct swdevt *sp)
 
 	mtx_lock(&sw_dev_mtx);
 	cp = sp->sw_id;
-	if (cp == NULL) {
+	if (cp == NULL || !swapgeom_acquire(cp)) {
 		mtx_unlock(&sw_dev_mtx);
 		bp->b_error = ENXIO;
 		bp->b_ioflags |= BIO_ERROR;
 		bufdone(bp);
 		return;
 	}
-	swapgeom_acquire(cp);
 	mtx_unlock(&sw_dev_mtx);
 	if (bp->b_iocmd == BIO_WRITE)
 		bio = g_new_bio();
 	else
 		bio = g_alloc_bio();
 	if (bio == NULL) {
-		mtx_lock(&sw_dev_mtx);
 		swapgeom_release(cp, sp);
-		mtx_unlock(&sw_dev_mtx);
 		bp->b_error = ENOMEM;
 		bp->b_ioflags |= BIO_ERROR;
 		printf("swap_pager: cannot allocate bio\n");
@@ -2862,7 +2886,6 @@ static void
 swapgeom_orphan(struct g_consumer *cp)
 {
 	struct swdevt *sp;
-	int destroy;
 
 	mtx_lock(&sw_dev_mtx);
 	TAILQ_FOREACH(sp, &swtailq, sw_list) {
@@ -2871,18 +2894,22 @@ swapgeom_orphan(struct g_consumer *cp)
 			break;
 		}
 	}
+	mtx_unlock(&sw_dev_mtx);
+
 	/*
-	 * Drop reference we were created with. Do directly since we're in a
-	 * special context where we don't have to queue the call to
+	 * Drop the reference we were created with.  Destroy the consumer
+	 * directly if that was the last reference, since we're in a special
+	 * context where we don't have to queue the call to
 	 * swapgeom_close_ev().
 	 */
-	cp->index--;
-	destroy = ((sp != NULL) && (cp->index == 0));
-	if (destroy)
+	atomic_thread_fence_rel();
+	if (atomic_fetchadd_int((u_int *)&cp->index, -1) == 1 && sp != NULL) {
+		atomic_thread_fence_acq();
+		mtx_lock(&sw_dev_mtx);
 		sp->sw_id = NULL;
-	mtx_unlock(&sw_dev_mtx);
-	if (destroy)
+		mtx_unlock(&sw_dev_mtx);
 		swapgeom_close_ev(cp, 0);
+	}
 }
 
 static void
@@ -2912,7 +2939,7 @@ swapongeom_locked(struct cdev *dev, struct vnode *vp)
 	static struct g_geom *gp;
 	struct swdevt *sp;
 	u_long nblks;
-	int error;
+	int error, optpages;
 
 	pp = g_dev_getprovider(dev);
 	if (pp == NULL)
@@ -2945,9 +2972,18 @@ swapongeom_locked(struct cdev *dev, struct vnode *vp)
 		return (error);
 	}
 	nblks = pp->mediasize / DEV_BSIZE;
+
+	/*
+	 * Use the provider's reported stripe size, if any, as the optimal
+	 * I/O size for clustered pageouts to this device.
+	 */
+	optpages = 0;
+	if (pp->stripesize > PAGE_SIZE && pp->stripesize % PAGE_SIZE == 0)
+		optpages = imin(pp->stripesize / PAGE_SIZE, nsw_cluster_max);
 	swaponsomething(vp, cp, nblks, swapgeom_strategy,
 	    swapgeom_close, dev2udev(dev),
-	    (pp->flags & G_PF_ACCEPT_UNMAPPED) != 0 ? SW_UNMAPPED : 0);
+	    (pp->flags & G_PF_ACCEPT_UNMAPPED) != 0 ? SW_UNMAPPED : 0,
+	    optpages);
 	return (0);
 }
 
@@ -3034,7 +3070,7 @@ swaponvp(struct thread *td, struct vnode *vp, u_long nblks)
 		return (error);
 
 	swaponsomething(vp, vp, nblks, swapdev_strategy, swapdev_close,
-	    NODEV, 0);
+	    NODEV, 0, 0);
 	return (0);
 }
 
@@ -54,6 +54,7 @@ struct swdevt {
 	int	sw_flags;
 	int	sw_nblks;
 	int     sw_used;
+	int	sw_optpages;	/* optimal I/O size, in pages, or 0 */
 	dev_t	sw_dev;
 	struct vnode *sw_vp;
 	void	*sw_id;
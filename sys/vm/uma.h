@@ -40,6 +40,7 @@
 
 #include <sys/param.h>		/* For NULL */
 #include <sys/malloc.h>		/* For M_* */
+#include <sys/_cpuset.h>	/* For cpuset_t */
 #include <sys/_smr.h>
 
 /* User visible parameters */
@@ -561,6 +562,31 @@ void uma_zone_set_maxaction(uma_zone_t zone, uma_maxaction_t);
  */
 int uma_zone_get_cur(uma_zone_t zone);
 
+/*
+ * Obtain the backing store a zone's keg holds in one NUMA domain.
+ *
+ * Arguments:
+ *	zone  The zone to examine; cache zones have no keg and report zero
+ *	domain  The domain of interest
+ *	pages  Filled with the page count backing the domain's slabs
+ *	free_items  Filled with the count of free items in those slabs
+ */
+void uma_zone_get_domain_stats(uma_zone_t zone, int domain, uint32_t *pages,
+    uint32_t *free_items);
+
+/*
+ * Obtain the number of frees of items allocated in a different NUMA
+ * domain than they were freed from, i.e. items returned to their home
+ * domain by the cross-domain free path.
+ *
+ * Arguments:
+ *	zone  The zone to obtain the cross-domain free count from
+ *
+ * Return:
+ *	uint64_t  The number of cross-domain frees
+ */
+uint64_t uma_zone_get_xdomain(uma_zone_t zone);
+
 /*
  * The following two routines (uma_zone_set_init/fini)
  * are used to set the backend init/fini pair which acts on an
@@ -647,6 +673,28 @@ smr_t uma_zone_get_smr(uma_zone_t zone);
  */
 void uma_prealloc(uma_zone_t zone, int itemcnt);
 
+/*
+ * Used to pre-fill the per-CPU bucket caches of a zone so that the
+ * first allocations on each CPU hit the fast path instead of paying
+ * for a trip to the keg.
+ *
+ * Arguments:
+ *	zone    The zone to fill
+ *	cpus    The set of CPUs whose caches should be filled, or
+ *	        NULL for all CPUs
+ *	itemcnt The number of items to cache per CPU; items beyond
+ *	        the capacity of the per-CPU buckets are banked in the
+ *	        CPU's domain bucket list
+ *
+ * Returns:
+ *	Nothing
+ *
+ * NOTE: This is blocking, binds the calling thread to each CPU in
+ * turn, and should only be done from a sleepable context such as
+ * service startup.
+ */
+void uma_zone_prefill(uma_zone_t zone, cpuset_t *cpus, int itemcnt);
+
 /*
  * Used to determine if a fixed-size zone is exhausted.
  *
@@ -895,8 +895,11 @@ cache_fetch_bucket(uma_zone_t zone, uma_cache_t cache, int domain)
 	 * Avoid the lock if possible.
 	 */
 	zdom = ZDOM_GET(zone, domain);
-	if (zdom->uzd_nitems == 0)
+	if (zdom->uzd_nitems == 0) {
+		/* Record the depletion for the periodic domain balancer. */
+		atomic_add_long(&zdom->uzd_empty, 1);
 		return (NULL);
+	}
 
 	if ((cache_uz_flags(cache) & UMA_ZONE_SMR) != 0 &&
 	    !smr_poll(zone->uz_smr, zdom->uzd_seq, false))
@@ -975,6 +978,70 @@ zone_domain_update_wss(uma_zone_domain_t zdom)
 	ZDOM_UNLOCK(zdom);
 }
 
+/*
+ * Rebalance cached full buckets across NUMA domains.  With first-touch
+ * allocation a domain whose consumers have gone idle can sit on full
+ * buckets while another domain misses to the keg on every fill.  Move
+ * surplus buckets, beyond the rich domain's working set estimate, to
+ * domains whose bucket caches were found empty during the last period.
+ * Migrated items remain backed by their origin domain's memory, but
+ * serving a remote item from the bucket cache is still far cheaper
+ * than filling from a depleted keg.
+ */
+static void
+zone_domain_balance(uma_zone_t zone)
+{
+	uma_zone_domain_t rich, zdom;
+	uma_bucket_t bucket;
+	long nmisses, surplus, best, moved, target;
+	int dst, i, richdom;
+
+	for (dst = 0; dst < vm_ndomains; dst++) {
+		zdom = ZDOM_GET(zone, dst);
+		nmisses = atomic_readandclear_long(&zdom->uzd_empty);
+		if (nmisses == 0)
+			continue;
+
+		/*
+		 * Find the domain with the largest idle surplus.
+		 * Unlocked reads are racy but only guide a heuristic.
+		 */
+		richdom = -1;
+		best = 0;
+		for (i = 0; i < vm_ndomains; i++) {
+			if (i == dst)
+				continue;
+			rich = ZDOM_GET(zone, i);
+			surplus = rich->uzd_nitems - rich->uzd_wss;
+			if (surplus > best) {
+				best = surplus;
+				richdom = i;
+			}
+		}
+		if (richdom == -1)
+			continue;
+
+		/*
+		 * Move enough buckets to cover the observed misses, but
+		 * never more than the surplus and never more than a few
+		 * buckets per period, to keep the timeout cheap.
+		 */
+		target = lmin(best, nmisses * zone->uz_bucket_size);
+		target = lmin(target, 4 * zone->uz_bucket_size);
+		moved = 0;
+		while (moved < target) {
+			rich = zone_domain_lock(zone, richdom);
+			bucket = zone_fetch_bucket(zone, rich, true);
+			if (bucket == NULL) {
+				ZDOM_UNLOCK(rich);
+				break;
+			}
+			moved += bucket->ub_cnt;
+			zone_put_bucket(zone, dst, bucket, NULL, false);
+		}
+	}
+}
+
 /*
  * Routine to perform timeout driven calculations.  This expands the
  * hashes and does per cpu statistics aggregation.
@@ -1037,6 +1104,13 @@ zone_timeout(uma_zone_t zone, void *unused)
 update_wss:
 	for (int i = 0; i < vm_ndomains; i++)
 		zone_domain_update_wss(ZDOM_GET(zone, i));
+
+	/*
+	 * Only first-touch zones accumulate per-domain imbalances; round
+	 * robin zones spread fills across domains by construction.
+	 */
+	if (vm_ndomains > 1 && (zone->uz_flags & UMA_ZONE_FIRSTTOUCH) != 0)
+		zone_domain_balance(zone);
 }
 
 /*
@@ -2319,13 +2393,22 @@ zone_kva_available(uma_zone_t zone, void *unused)
 static void
 zone_alloc_counters(uma_zone_t zone, void *unused)
 {
+	int i;
 
 	zone->uz_allocs = counter_u64_alloc(M_WAITOK);
 	zone->uz_frees = counter_u64_alloc(M_WAITOK);
 	zone->uz_fails = counter_u64_alloc(M_WAITOK);
 	zone->uz_xdomain = counter_u64_alloc(M_WAITOK);
+	for (i = 0; i < UMA_ZLAT_BUCKETS; i++)
+		zone->uz_slowlat[i] = counter_u64_alloc(M_WAITOK);
 }
 
+/* Upper bounds of the latency histogram buckets, as sysctl leaf names. */
+static const char *const zone_slowlat_names[UMA_ZLAT_BUCKETS] = {
+	"lt_2us", "lt_8us", "lt_32us", "lt_128us",
+	"lt_512us", "lt_2ms", "lt_8ms", "ge_8ms",
+};
+
 static void
 zone_alloc_sysctl(uma_zone_t zone, void *unused)
 {
@@ -2491,6 +2574,18 @@ zone_alloc_sysctl(uma_zone_t zone, void *unused)
 	SYSCTL_ADD_COUNTER_U64(NULL, SYSCTL_CHILDREN(oid), OID_AUTO,
 	    "xdomain", CTLFLAG_RD, &zone->uz_xdomain,
 	    "Free calls from the wrong domain");
+
+	/*
+	 * Slow-path allocation latency histogram.
+	 */
+	oid = SYSCTL_ADD_NODE(NULL, SYSCTL_CHILDREN(zone->uz_oid), OID_AUTO,
+	    "latency", CTLFLAG_RD | CTLFLAG_MPSAFE, NULL,
+	    "Slow-path allocation latency histogram");
+	for (i = 0; i < UMA_ZLAT_BUCKETS; i++) {
+		SYSCTL_ADD_COUNTER_U64(NULL, SYSCTL_CHILDREN(oid), OID_AUTO,
+		    zone_slowlat_names[i], CTLFLAG_RD, &zone->uz_slowlat[i],
+		    "Slow-path allocations in this latency range");
+	}
 }
 
 struct uma_zone_count {
@@ -2663,6 +2758,8 @@ out:
 		zone->uz_allocs = EARLY_COUNTER;
 		zone->uz_frees = EARLY_COUNTER;
 		zone->uz_fails = EARLY_COUNTER;
+		for (i = 0; i < UMA_ZLAT_BUCKETS; i++)
+			zone->uz_slowlat[i] = EARLY_COUNTER;
 	}
 
 	/* Caller requests a private SMR context. */
@@ -2759,6 +2856,8 @@ zone_dtor(void *arg, int size, void *udata)
 	counter_u64_free(zone->uz_frees);
 	counter_u64_free(zone->uz_fails);
 	counter_u64_free(zone->uz_xdomain);
+	for (i = 0; i < UMA_ZLAT_BUCKETS; i++)
+		counter_u64_free(zone->uz_slowlat[i]);
 	free(zone->uz_ctlname, M_UMA);
 	for (i = 0; i < vm_ndomains; i++)
 		ZDOM_LOCK_FINI(ZDOM_GET(zone, i));
@@ -3295,18 +3394,42 @@ cache_alloc_item(uma_zone_t zone, uma_cache_t cache, uma_cache_bucket_t bucket,
 	return (item_ctor(zone, uz_flags, size, udata, flags, item));
 }
 
+/*
+ * Record the duration of a slow-path allocation in the zone's latency
+ * histogram.  The buckets are quadrupling microsecond ranges, so a limit
+ * sleep lands several buckets above a keg fill and the two are easy to
+ * tell apart in the exported counters.
+ */
+static void
+zone_slowlat_record(uma_zone_t zone, sbintime_t delta)
+{
+	uint64_t us;
+	int i;
+
+	us = ((uint64_t)delta * 1000000) >> 32;
+	i = flsll(us) >> 1;
+	if (i >= UMA_ZLAT_BUCKETS)
+		i = UMA_ZLAT_BUCKETS - 1;
+	counter_u64_add(zone->uz_slowlat[i], 1);
+}
+
 static __noinline void *
 cache_alloc_retry(uma_zone_t zone, uma_cache_t cache, void *udata, int flags)
 {
 	uma_cache_bucket_t bucket;
+	sbintime_t start;
+	void *item;
 	int domain;
 
+	start = sbinuptime();
 	while (cache_alloc(zone, cache, udata, flags)) {
 		cache = &zone->uz_cpu[curcpu];
 		bucket = &cache->uc_allocbucket;
 		if (__predict_false(bucket->ucb_cnt == 0))
 			continue;
-		return (cache_alloc_item(zone, cache, bucket, udata, flags));
+		item = cache_alloc_item(zone, cache, bucket, udata, flags);
+		zone_slowlat_record(zone, sbinuptime() - start);
+		return (item);
 	}
 	critical_exit();
 
@@ -3317,7 +3440,9 @@ cache_alloc_retry(uma_zone_t zone, uma_cache_t cache, void *udata, int flags)
 		domain = PCPU_GET(domain);
 	else
 		domain = UMA_ANYDOMAIN;
-	return (zone_alloc_item(zone, udata, domain, flags));
+	item = zone_alloc_item(zone, udata, domain, flags);
+	zone_slowlat_record(zone, sbinuptime() - start);
+	return (item);
 }
 
 /* See uma.h */
@@ -4540,6 +4665,36 @@ uma_zone_get_cur(uma_zone_t zone)
 	return (nitems < 0 ? 0 : nitems);
 }
 
+/* See uma.h */
+void
+uma_zone_get_domain_stats(uma_zone_t zone, int domain, uint32_t *pages,
+    uint32_t *free_items)
+{
+	uma_domain_t dom;
+
+	KASSERT(domain >= 0 && domain < vm_ndomains,
+	    ("%s: invalid domain %d", __func__, domain));
+	if ((zone->uz_flags & UMA_ZFLAG_CACHE) != 0) {
+		*pages = 0;
+		*free_items = 0;
+		return;
+	}
+	/* Unlocked read; the caller only wants statistics. */
+	dom = &zone->uz_keg->uk_domain[domain];
+	*pages = dom->ud_pages;
+	*free_items = dom->ud_free_items;
+}
+
+/* See uma.h */
+uint64_t
+uma_zone_get_xdomain(uma_zone_t zone)
+{
+
+	if (zone->uz_xdomain == NULL)
+		return (0);
+	return (counter_u64_fetch(zone->uz_xdomain));
+}
+
 static uint64_t
 uma_zone_get_allocs(uma_zone_t zone)
 {
@@ -4760,6 +4915,69 @@ uma_prealloc(uma_zone_t zone, int items)
 	}
 }
 
+/* See uma.h */
+void
+uma_zone_prefill(uma_zone_t zone, cpuset_t *cpus, int itemcnt)
+{
+	uma_bucket_t bucket;
+	uma_cache_t cache;
+	int cpu, domain, filled;
+
+	WITNESS_WARN(WARN_GIANTOK | WARN_SLEEPOK, NULL,
+	    "uma_zone_prefill: zone \"%s\"", zone->uz_name);
+	KASSERT((zone->uz_flags & UMA_ZFLAG_INTERNAL) == 0,
+	    ("uma_zone_prefill: zone %s is an internal zone", zone->uz_name));
+
+	if (zone->uz_bucket_size == 0 || bucketdisable)
+		return;
+
+	/*
+	 * Per-CPU caches may only be manipulated while executing on the
+	 * owning CPU within a critical section, so visit each requested
+	 * CPU in turn as pcpu_cache_drain_safe() does.
+	 */
+	CPU_FOREACH(cpu) {
+		if (cpus != NULL && !CPU_ISSET(cpu, cpus))
+			continue;
+		thread_lock(curthread);
+		sched_bind(curthread, cpu);
+		thread_unlock(curthread);
+
+		filled = 0;
+		while (filled < itemcnt) {
+			domain = PCPU_GET(domain);
+			bucket = zone_alloc_bucket(zone, NULL, domain,
+			    M_WAITOK);
+			if (bucket == NULL)
+				break;
+			filled += bucket->ub_cnt;
+			critical_enter();
+			cache = &zone->uz_cpu[cpu];
+			if (cache->uc_allocbucket.ucb_bucket == NULL) {
+				cache_bucket_load_alloc(cache, bucket);
+				bucket = NULL;
+			} else if ((cache_uz_flags(cache) & UMA_ZONE_SMR) ==
+			    0 && cache->uc_freebucket.ucb_bucket == NULL) {
+				cache_bucket_load_free(cache, bucket);
+				bucket = NULL;
+			}
+			critical_exit();
+			if (bucket != NULL) {
+				/*
+				 * The cache buckets are full; bank the
+				 * remainder in this CPU's domain so that
+				 * refills stay a single bucket fetch.
+				 */
+				zone_put_bucket(zone, domain, bucket, NULL,
+				    true);
+			}
+		}
+	}
+	thread_lock(curthread);
+	sched_unbind(curthread);
+	thread_unlock(curthread);
+}
+
 /*
  * Returns a snapshot of memory consumption in bytes.
  */
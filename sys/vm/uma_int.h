@@ -449,12 +449,20 @@ struct uma_zone_domain {
 	long		uzd_imax;	/* maximum item count this period */
 	long		uzd_imin;	/* minimum item count this period */
 	long		uzd_wss;	/* working set size estimate */
+	long		uzd_empty;	/* empty-cache fills this period */
 	smr_seq_t	uzd_seq;	/* Lowest queued seq. */
 	struct mtx	uzd_lock;	/* Lock for the domain */
 } __aligned(CACHE_LINE_SIZE);
 
 typedef struct uma_zone_domain * uma_zone_domain_t;
 
+/*
+ * Number of buckets in the slow-path allocation latency histogram.
+ * Bucket i counts allocations that completed in less than 2^(2i+1)
+ * microseconds; the last bucket absorbs everything slower.
+ */
+#define	UMA_ZLAT_BUCKETS	8
+
 /*
  * Zone structure - per memory type.
  */
@@ -499,7 +507,10 @@ struct uma_zone {
 	struct timeval	uz_ratecheck;	/* Warnings rate-limiting */
 	struct task	uz_maxaction;	/* Task to run when at limit */
 
-	/* Offset 256. */
+	/* Offset 256, slow-path allocation latency histogram. */
+	counter_u64_t	uz_slowlat[UMA_ZLAT_BUCKETS];
+
+	/* Offset 320. */
 	struct mtx	uz_cross_lock;	/* Cross domain free lock */
 
 	/*
@@ -91,6 +91,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/resourcevar.h>
 #include <sys/rwlock.h>
 #include <sys/signalvar.h>
+#include <sys/smr.h>
 #include <sys/sysctl.h>
 #include <sys/sysent.h>
 #include <sys/vmmeter.h>
@@ -368,6 +369,155 @@ out:
 	return (rv);
 }
 
+/*
+ * Attempt to satisfy a read fault from a page resident below the
+ * top-level object without acquiring any object locks, using the
+ * lockless shadow chain walk.  Called with no object locks held.
+ * Unlocks fs->map on success.
+ */
+static int
+vm_fault_cow_fast(struct faultstate *fs)
+{
+	vm_page_t m;
+	int rv;
+
+	MPASS(fs->vp == NULL);
+	MPASS(!fs->wired);
+	MPASS((fs->fault_type & (VM_PROT_WRITE | VM_PROT_COPY)) == 0);
+
+	m = vm_object_shadow_page_unlocked(fs->first_object,
+	    fs->first_pindex);
+	if (m == NULL)
+		return (KERN_FAILURE);
+
+	/*
+	 * The page belongs to an object below fs->first_object, so the
+	 * mapping must deny write access in order to force a copy on a
+	 * later write fault.
+	 */
+	fs->prot &= ~VM_PROT_WRITE;
+
+	rv = pmap_enter(fs->map->pmap, fs->vaddr, m, fs->prot,
+	    fs->fault_type | PMAP_ENTER_NOSLEEP, 0);
+	if (rv != KERN_SUCCESS) {
+		vm_page_sunbusy(m);
+		return (rv);
+	}
+	if (fs->m_hold != NULL) {
+		(*fs->m_hold) = m;
+		vm_page_wire(m);
+	}
+	vm_page_sunbusy(m);
+	vm_map_lookup_done(fs->map, fs->entry);
+	curthread->td_ru.ru_minflt++;
+	return (KERN_SUCCESS);
+}
+
+/*
+ * Attempt to resolve an ordinary read or execute fault without taking
+ * the map lock, using an SMR-protected walk of the map's entry tree.
+ * The map's version is verified after the object read lock is acquired
+ * and again after the mapping is created; if the map was modified in
+ * the meantime, the new mapping is torn down and the locked path runs
+ * instead.  The mapping is always created without write permission so
+ * that no dirty tracking is required; a later write will fault again
+ * and be handled under the locks.
+ */
+static int
+vm_fault_lockless(struct faultstate *fs)
+{
+	vm_map_entry_t entry;
+	vm_object_t object;
+	vm_offset_t start;
+	vm_ooffset_t offset;
+	vm_page_t m;
+	vm_pindex_t pindex;
+	vm_prot_t prot;
+	vm_eflags_t eflags;
+	u_int version;
+	int wired;
+
+	MPASS(fs->vp == NULL);
+	MPASS(fs->m_hold == NULL);
+	MPASS(fs->fault_flags == 0);
+	MPASS((fs->fault_type & (VM_PROT_WRITE | VM_PROT_COPY)) == 0);
+	MPASS(!fs->map->system_map);
+
+	smr_enter(vm_map_smr);
+	if (!vm_map_lookup_entry_unlocked(fs->map, fs->vaddr, &entry,
+	    &version)) {
+		smr_exit(vm_map_smr);
+		return (KERN_FAILURE);
+	}
+
+	/*
+	 * Snapshot the fields needed to translate the address while the
+	 * SMR section keeps the entry from being freed.  The snapshot is
+	 * only trusted once the map's version is verified below.
+	 */
+	eflags = entry->eflags;
+	prot = entry->protection;
+	wired = entry->wired_count;
+	object = entry->object.vm_object;
+	offset = entry->offset;
+	start = entry->start;
+	smr_exit(vm_map_smr);
+
+	if ((eflags & (MAP_ENTRY_IS_SUB_MAP | MAP_ENTRY_GUARD |
+	    MAP_ENTRY_IN_TRANSITION | MAP_ENTRY_NOFAULT)) != 0 ||
+	    wired != 0 || object == NULL ||
+	    (fs->fault_type & prot) != fs->fault_type)
+		return (KERN_FAILURE);
+
+	/*
+	 * Never grant write permission here, even if the entry allows
+	 * it, to avoid replicating the dirty bookkeeping performed by
+	 * vm_fault_dirty(), and because the entry might need a copy.
+	 */
+	prot &= ~VM_PROT_WRITE;
+	pindex = OFF_TO_IDX((fs->vaddr - start) + offset);
+
+	if (!VM_OBJECT_TRYRLOCK(object))
+		return (KERN_FAILURE);
+
+	/*
+	 * The vm object zone is type stable, so the read lock acquisition
+	 * is safe even if the entry was concurrently deallocated.  If the
+	 * version is unchanged, then the entry, and thus its object
+	 * reference, is still in the map, and the read lock now keeps the
+	 * object's pages from being freed.
+	 */
+	if (!vm_map_version_verify(fs->map, version)) {
+		VM_OBJECT_RUNLOCK(object);
+		return (KERN_FAILURE);
+	}
+	m = vm_page_lookup(object, pindex);
+	/* A busy page can be mapped for read|execute access. */
+	if (m == NULL || !vm_page_all_valid(m)) {
+		VM_OBJECT_RUNLOCK(object);
+		return (KERN_FAILURE);
+	}
+	if (pmap_enter(fs->map->pmap, fs->vaddr, m, prot,
+	    fs->fault_type | PMAP_ENTER_NOSLEEP, 0) != KERN_SUCCESS) {
+		VM_OBJECT_RUNLOCK(object);
+		return (KERN_FAILURE);
+	}
+
+	/*
+	 * A concurrent munmap() may have removed the entry and cleaned
+	 * the pmap between the last check and pmap_enter().  Recheck,
+	 * and tear the mapping back down if so.
+	 */
+	if (!vm_map_version_verify(fs->map, version)) {
+		pmap_remove(fs->map->pmap, fs->vaddr, fs->vaddr + PAGE_SIZE);
+		VM_OBJECT_RUNLOCK(object);
+		return (KERN_FAILURE);
+	}
+	VM_OBJECT_RUNLOCK(object);
+	curthread->td_ru.ru_minflt++;
+	return (KERN_SUCCESS);
+}
+
 static void
 vm_fault_restore_map_lock(struct faultstate *fs)
 {
@@ -1082,6 +1232,34 @@ vm_fault_allocate(struct faultstate *fs)
 	return (KERN_NOT_RECEIVER);
 }
 
+/*
+ * Completion callback for pager reads started by an asynchronous fault.
+ * The fault transferred ownership of the busied page, its reference on
+ * the object, and its paging-in-progress count to the request.  The
+ * pager has already marked the pages valid on success; releasing the
+ * exclusive busy lock here wakes any thread that re-faulted on the page
+ * and slept on it in the meantime.
+ */
+static void
+vm_fault_async_iodone(void *arg, vm_page_t *ma, int count, int error)
+{
+	vm_object_t object;
+	int i;
+
+	object = arg;
+	if (error == 0) {
+		for (i = 0; i < count; i++)
+			vm_page_xunbusy(ma[i]);
+	} else {
+		VM_OBJECT_WLOCK(object);
+		for (i = 0; i < count; i++)
+			vm_page_free_invalid(ma[i]);
+		VM_OBJECT_WUNLOCK(object);
+	}
+	vm_object_pip_wakeup(object);
+	vm_object_deallocate(object);
+}
+
 /*
  * Call the pager to retrieve the page if there is a chance
  * that the pager has it, and potentially retrieve additional
@@ -1154,6 +1332,35 @@ vm_fault_getpages(struct faultstate *fs, int nera, int *behindp, int *aheadp)
 	}
 	*behindp = behind;
 	*aheadp = ahead;
+
+	/*
+	 * An asynchronous fault enqueues the pager request and returns
+	 * without sleeping for the I/O.  The completion callback assumes
+	 * this fault's object reference, paging-in-progress count, and
+	 * ownership of the busy page, so this is only attempted for
+	 * simple top-level faults where no other fault state needs to
+	 * survive the I/O.
+	 */
+	if ((fs->fault_flags & VM_FAULT_ASYNC) != 0 &&
+	    fs->object == fs->first_object &&
+	    fs->object->type == OBJT_VNODE &&
+	    (fs->fault_flags & (VM_FAULT_WIRE | VM_FAULT_DIRTY)) == 0 &&
+	    fs->m_hold == NULL) {
+		rv = vm_pager_get_pages_async(fs->object, &fs->m, 1, behindp,
+		    aheadp, vm_fault_async_iodone, fs->object);
+		if (rv == VM_PAGER_OK) {
+			fs->m = NULL;
+			unlock_vp(fs);
+			return (KERN_INPROGRESS);
+		}
+		if (rv == VM_PAGER_ERROR)
+			printf("vm_fault: async pager read error, pid %d "
+			    "(%s)\n", curproc->p_pid, curproc->p_comm);
+		if (rv == VM_PAGER_ERROR || rv == VM_PAGER_BAD)
+			return (KERN_OUT_OF_BOUNDS);
+		return (KERN_NOT_RECEIVER);
+	}
+
 	rv = vm_pager_get_pages(fs->object, &fs->m, 1, behindp, aheadp);
 	if (rv == VM_PAGER_OK)
 		return (KERN_SUCCESS);
@@ -1231,6 +1438,18 @@ vm_fault(vm_map_t map, vm_offset_t vaddr, vm_prot_t fault_type,
 	nera = -1;
 	hardfault = false;
 
+	/*
+	 * For a read or execute fault on an ordinary map entry whose page
+	 * is already resident and valid in the top-level object, try to
+	 * create the mapping without acquiring the map lock at all.
+	 */
+	if (!map->system_map && fault_flags == 0 && m_hold == NULL &&
+	    (fault_type & (VM_PROT_WRITE | VM_PROT_COPY)) == 0) {
+		fs.fault_type = fault_type;
+		if (vm_fault_lockless(&fs) == KERN_SUCCESS)
+			return (KERN_SUCCESS);
+	}
+
 RetryFault:
 	fs.fault_type = fault_type;
 
@@ -1258,7 +1477,20 @@ RetryFault:
 		rv = vm_fault_soft_fast(&fs);
 		if (rv == KERN_SUCCESS)
 			return (rv);
-		if (!VM_OBJECT_TRYUPGRADE(fs.first_object)) {
+		/*
+		 * The page is not resident in the top-level object.  If
+		 * this is a read fault on a shadow chain, try to find
+		 * and map the backing page without taking object locks.
+		 */
+		if (!fs.wired && (fs.fault_type & (VM_PROT_WRITE |
+		    VM_PROT_COPY)) == 0 &&
+		    fs.first_object->backing_object != NULL) {
+			VM_OBJECT_RUNLOCK(fs.first_object);
+			rv = vm_fault_cow_fast(&fs);
+			if (rv == KERN_SUCCESS)
+				return (rv);
+			VM_OBJECT_WLOCK(fs.first_object);
+		} else if (!VM_OBJECT_TRYUPGRADE(fs.first_object)) {
 			VM_OBJECT_RUNLOCK(fs.first_object);
 			VM_OBJECT_WLOCK(fs.first_object);
 		}
@@ -1391,6 +1623,17 @@ RetryFault:
 				hardfault = true;
 				break; /* break to PAGE HAS BEEN FOUND. */
 			}
+			if (rv == KERN_INPROGRESS) {
+				/*
+				 * The pager I/O was enqueued and the
+				 * completion callback owns the remaining
+				 * fault state.  The caller re-issues the
+				 * fault once the I/O completes; the retry
+				 * finds the page resident or sleeps on its
+				 * busy lock.
+				 */
+				return (rv);
+			}
 			if (rv == KERN_RESOURCE_SHORTAGE)
 				goto RetryFault;
 			VM_OBJECT_WLOCK(fs.object);
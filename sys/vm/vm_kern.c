@@ -130,6 +130,18 @@ SYSCTL_ULONG(_vm, OID_AUTO, max_kernel_address, CTLFLAG_RD,
 #define	KVA_QUANTUM		(1 << KVA_QUANTUM_SHIFT)
 #define	KVA_NUMA_IMPORT_QUANTUM	(KVA_QUANTUM * 128)
 
+/*
+ * The size limit, in bytes, below which allocations from the kernel
+ * arenas are served by per-CPU quantum caches instead of the arena free
+ * lists.  The caches keep the arena lock off the small-allocation fast
+ * path at the cost of some cached KVA; they are drained when an arena
+ * runs out of space.
+ */
+static u_long kva_qcache_max = 4 * PAGE_SIZE;
+SYSCTL_ULONG(_vm, OID_AUTO, kva_qcache_max, CTLFLAG_RDTUN,
+    &kva_qcache_max, 0,
+    "Largest KVA allocation size, in bytes, served by per-CPU caches");
+
 extern void     uma_startup2(void);
 
 /*
@@ -785,10 +797,14 @@ kmem_init(vm_offset_t start, vm_offset_t end)
 	else
 		quantum = KVA_QUANTUM;
 
+	/* The quantum cache limit must cover a whole number of pages. */
+	kva_qcache_max = rounddown(kva_qcache_max, PAGE_SIZE);
+
 	/*
 	 * Initialize the kernel_arena.  This can grow on demand.
 	 */
-	vmem_init(kernel_arena, "kernel arena", 0, 0, PAGE_SIZE, 0, 0);
+	vmem_init(kernel_arena, "kernel arena", 0, 0, PAGE_SIZE,
+	    kva_qcache_max, 0);
 	vmem_set_import(kernel_arena, kva_import, NULL, NULL, quantum);
 
 	for (domain = 0; domain < vm_ndomains; domain++) {
@@ -799,7 +815,8 @@ kmem_init(vm_offset_t start, vm_offset_t end)
 		 * maximizing the potential for superpage promotion.
 		 */
 		vm_dom[domain].vmd_kernel_arena = vmem_create(
-		    "kernel arena domain", 0, 0, PAGE_SIZE, 0, M_WAITOK);
+		    "kernel arena domain", 0, 0, PAGE_SIZE, kva_qcache_max,
+		    M_WAITOK);
 		vmem_set_import(vm_dom[domain].vmd_kernel_arena,
 		    kva_import_domain, NULL, kernel_arena, quantum);
 
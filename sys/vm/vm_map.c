@@ -81,6 +81,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/racct.h>
 #include <sys/resourcevar.h>
 #include <sys/rwlock.h>
+#include <sys/smr.h>
 #include <sys/file.h>
 #include <sys/sysctl.h>
 #include <sys/sysent.h>
@@ -129,6 +130,7 @@ static struct mtx map_sleep_mtx;
 static uma_zone_t mapentzone;
 static uma_zone_t kmapentzone;
 static uma_zone_t vmspace_zone;
+smr_t vm_map_smr;
 static int vmspace_zinit(void *mem, int size, int flags);
 static void _vm_map_init(vm_map_t map, pmap_t pmap, vm_offset_t min,
     vm_offset_t max);
@@ -137,8 +139,6 @@ static void vm_map_entry_dispose(vm_map_t map, vm_map_entry_t entry);
 static void vm_map_entry_unwire(vm_map_t map, vm_map_entry_t entry);
 static int vm_map_growstack(vm_map_t map, vm_offset_t addr,
     vm_map_entry_t gap_entry);
-static void vm_map_pmap_enter(vm_map_t map, vm_offset_t addr, vm_prot_t prot,
-    vm_object_t object, vm_pindex_t pindex, vm_size_t size, int flags);
 #ifdef INVARIANTS
 static void vmspace_zdtor(void *mem, int size, void *arg);
 #endif
@@ -199,7 +199,8 @@ vm_map_startup(void)
 	    NULL, NULL, NULL, NULL, UMA_ALIGN_PTR,
 	    UMA_ZONE_MTXCLASS | UMA_ZONE_VM);
 	mapentzone = uma_zcreate("MAP ENTRY", sizeof(struct vm_map_entry),
-	    NULL, NULL, NULL, NULL, UMA_ALIGN_PTR, 0);
+	    NULL, NULL, NULL, NULL, UMA_ALIGN_PTR, UMA_ZONE_SMR);
+	vm_map_smr = uma_zone_get_smr(mapentzone);
 	vmspace_zone = uma_zcreate("VMSPACE", sizeof(struct vmspace), NULL,
 #ifdef INVARIANTS
 	    vmspace_zdtor,
@@ -461,6 +462,39 @@ vmspace_switch_aio(struct vmspace *newvm)
 	vmspace_free(oldvm);
 }
 
+/*
+ * The map version is a modification clock for the benefit of unlocked
+ * lookups: it is odd while an exclusive lock holder may be mutating the
+ * map and even otherwise.  Unlike the timestamp, which increments once
+ * per write lock acquisition, the version only changes around sections
+ * that may actually modify the map, so a lockless reader that observes
+ * the same even value before and after a tree walk knows that the set
+ * of entries and their mappings did not change in between.  System maps
+ * are never looked up without the lock and are left alone.
+ *
+ * Both helpers are conditional on the current parity because a write
+ * lock may be transiently dropped and reacquired in the middle of a
+ * locked section, e.g. by vm_map_wait_busy().
+ */
+static void
+vm_map_version_enter(vm_map_t map)
+{
+
+	if (map->system_map || (map->version & 1) != 0)
+		return;
+	atomic_store_int(&map->version, map->version + 1);
+	atomic_thread_fence_rel();
+}
+
+static void
+vm_map_version_leave(vm_map_t map)
+{
+
+	if (map->system_map || (map->version & 1) == 0)
+		return;
+	atomic_store_rel_int(&map->version, map->version + 1);
+}
+
 void
 _vm_map_lock(vm_map_t map, const char *file, int line)
 {
@@ -469,6 +503,7 @@ _vm_map_lock(vm_map_t map, const char *file, int line)
 		mtx_lock_flags_(&map->system_mtx, 0, file, line);
 	else
 		sx_xlock_(&map->lock, file, line);
+	vm_map_version_enter(map);
 	map->timestamp++;
 }
 
@@ -630,6 +665,7 @@ _vm_map_unlock(vm_map_t map, const char *file, int line)
 {
 
 	VM_MAP_UNLOCK_CONSISTENT(map);
+	vm_map_version_leave(map);
 	if (map->system_map)
 		mtx_unlock_flags_(&map->system_mtx, 0, file, line);
 	else {
@@ -668,8 +704,10 @@ _vm_map_trylock(vm_map_t map, const char *file, int line)
 	error = map->system_map ?
 	    !mtx_trylock_flags_(&map->system_mtx, 0, file, line) :
 	    !sx_try_xlock_(&map->lock, file, line);
-	if (error == 0)
+	if (error == 0) {
+		vm_map_version_enter(map);
 		map->timestamp++;
+	}
 	return (error == 0);
 }
 
@@ -717,6 +755,7 @@ _vm_map_lock_upgrade(vm_map_t map, const char *file, int line)
 			}
 		}
 	}
+	vm_map_version_enter(map);
 	map->timestamp++;
 	return (0);
 }
@@ -729,6 +768,7 @@ _vm_map_lock_downgrade(vm_map_t map, const char *file, int line)
 		mtx_assert_(&map->system_mtx, MA_OWNED, file, line);
 	} else {
 		VM_MAP_UNLOCK_CONSISTENT(map);
+		vm_map_version_leave(map);
 		sx_downgrade_(&map->lock, file, line);
 	}
 }
@@ -768,6 +808,7 @@ _vm_map_unlock_and_wait(vm_map_t map, int timo, const char *file, int line)
 {
 
 	VM_MAP_UNLOCK_CONSISTENT(map);
+	vm_map_version_leave(map);
 	mtx_lock(&map_sleep_mtx);
 	if (map->system_map)
 		mtx_unlock_flags_(&map->system_mtx, 0, file, line);
@@ -829,6 +870,12 @@ vm_map_wait_busy(vm_map_t map)
 		else
 			sx_sleep(&map->busy, &map->lock, 0, "mbusy", 0);
 	}
+	/*
+	 * sx_sleep() dropped the write lock, so an intervening locker may
+	 * have flipped the version back to even; make it odd again before
+	 * the caller resumes modifying the map.
+	 */
+	vm_map_version_enter(map);
 	map->timestamp++;
 }
 
@@ -856,6 +903,7 @@ _vm_map_init(vm_map_t map, pmap_t pmap, vm_offset_t min, vm_offset_t max)
 	map->header.left = map->header.right = &map->header;
 	map->root = NULL;
 	map->timestamp = 0;
+	map->version = 0;
 	map->busy = 0;
 	map->anon_loc = 0;
 #ifdef DIAGNOSTIC
@@ -881,7 +929,10 @@ vm_map_init(vm_map_t map, pmap_t pmap, vm_offset_t min, vm_offset_t max)
 static void
 vm_map_entry_dispose(vm_map_t map, vm_map_entry_t entry)
 {
-	uma_zfree(map->system_map ? kmapentzone : mapentzone, entry);
+	if (map->system_map)
+		uma_zfree(kmapentzone, entry);
+	else
+		uma_zfree_smr(mapentzone, entry);
 }
 
 /*
@@ -898,7 +949,7 @@ vm_map_entry_create(vm_map_t map)
 	if (map->system_map)
 		new_entry = uma_zalloc(kmapentzone, M_NOWAIT);
 	else
-		new_entry = uma_zalloc(mapentzone, M_WAITOK);
+		new_entry = uma_zalloc_smr(mapentzone, M_WAITOK);
 	if (new_entry == NULL)
 		panic("vm_map_entry_create: kernel resources exhausted");
 	return (new_entry);
@@ -1534,6 +1585,79 @@ vm_map_lookup_entry(
 	return (FALSE);
 }
 
+/*
+ *	vm_map_version_verify:
+ *
+ *	Returns TRUE if the map's version is still equal to "version",
+ *	i.e., no modification of the map has begun since the version was
+ *	read.  Used to validate state derived from an unlocked lookup.
+ */
+boolean_t
+vm_map_version_verify(vm_map_t map, u_int version)
+{
+
+	atomic_thread_fence_acq();
+	return (atomic_load_int(&map->version) == version);
+}
+
+/*
+ *	vm_map_lookup_entry_unlocked:
+ *
+ *	Lockless variant of vm_map_lookup_entry() for user maps.  The
+ *	caller must have entered an SMR read section on vm_map_smr, which
+ *	keeps any entry found from being freed, and must revalidate with
+ *	vm_map_version_verify() after reading fields from the entry and
+ *	again after consuming them.
+ *
+ *	Concurrent splay operations may restructure the tree under us
+ *	without changing the map's version, since they do not change the
+ *	set of entries.  The walk is therefore bounded, and a walk led
+ *	astray simply fails.  A containing entry that is found while the
+ *	version remains even and unchanged was continuously mapped at the
+ *	given address.  Unlike the locked variant, no predecessor is
+ *	returned on failure.
+ */
+boolean_t
+vm_map_lookup_entry_unlocked(
+	vm_map_t map,
+	vm_offset_t address,
+	vm_map_entry_t *entry,	/* OUT */
+	u_int *version)		/* OUT */
+{
+	vm_map_entry_t cur, header, lbound, ubound;
+	int depth;
+
+	SMR_ASSERT_ENTERED(vm_map_smr);
+	KASSERT(!map->system_map,
+	    ("%s: called on system map %p", __func__, map));
+
+	*version = atomic_load_acq_int(&map->version);
+	if ((*version & 1) != 0)
+		return (FALSE);
+	header = &map->header;
+	lbound = ubound = header;
+	cur = atomic_load_ptr(&map->root);
+	for (depth = 0; cur != NULL && depth < 64; depth++) {
+		if (address < cur->start) {
+			ubound = cur;
+			cur = atomic_load_ptr(&cur->left);
+			if (cur == lbound)
+				break;
+		} else if (cur->end <= address) {
+			lbound = cur;
+			cur = atomic_load_ptr(&cur->right);
+			if (cur == ubound)
+				break;
+		} else {
+			if (!vm_map_version_verify(map, *version))
+				break;
+			*entry = cur;
+			return (TRUE);
+		}
+	}
+	return (FALSE);
+}
+
 /*
  *	vm_map_insert:
  *
@@ -2485,7 +2609,7 @@ vm_map_submap(
  *	counts as one page mapping.)  Otherwise, all resident pages within
  *	the specified address range are mapped.
  */
-static void
+void
 vm_map_pmap_enter(vm_map_t map, vm_offset_t addr, vm_prot_t prot,
     vm_object_t object, vm_pindex_t pindex, vm_size_t size, int flags)
 {
@@ -3596,7 +3720,10 @@ vm_map_entry_deallocate(vm_map_entry_t entry, boolean_t system_map)
 
 	if ((entry->eflags & MAP_ENTRY_IS_SUB_MAP) == 0)
 		vm_object_deallocate(entry->object.vm_object);
-	uma_zfree(system_map ? kmapentzone : mapentzone, entry);
+	if (system_map)
+		uma_zfree(kmapentzone, entry);
+	else
+		uma_zfree_smr(mapentzone, entry);
 }
 
 /*
@@ -3874,6 +4001,18 @@ vm_map_copy_swap_object(vm_map_entry_t src_entry, vm_map_entry_t dst_entry,
 	}
 }
 
+/*
+ * If set, skip the advisory pmap_copy() of the parent's page table
+ * entries at fork.  The child then populates its pmap entirely by
+ * demand faults, so fork cost scales with the number of map entries
+ * rather than with the parent's resident set size, at the price of
+ * soft faults in the child for each mapping it actually touches.
+ */
+static int fork_lazy_pmap = 0;
+SYSCTL_INT(_vm, OID_AUTO, fork_lazy_pmap, CTLFLAG_RWTUN,
+    &fork_lazy_pmap, 0,
+    "Defer page table population of forked children to demand faults");
+
 /*
  *	vm_map_copy_entry:
  *
@@ -3954,9 +4093,11 @@ vm_map_copy_entry(
 				curthread->td_map_def_user = fake_entry;
 			}
 
-			pmap_copy(dst_map->pmap, src_map->pmap,
-			    dst_entry->start, dst_entry->end - dst_entry->start,
-			    src_entry->start);
+			if (!fork_lazy_pmap)
+				pmap_copy(dst_map->pmap, src_map->pmap,
+				    dst_entry->start,
+				    dst_entry->end - dst_entry->start,
+				    src_entry->start);
 		} else {
 			dst_entry->object.vm_object = NULL;
 			dst_entry->offset = 0;
@@ -4162,10 +4303,11 @@ vmspace_fork(struct vmspace *vm1, vm_ooffset_t *fork_charge)
 			/*
 			 * Update the physical map
 			 */
-			pmap_copy(new_map->pmap, old_map->pmap,
-			    new_entry->start,
-			    (old_entry->end - old_entry->start),
-			    old_entry->start);
+			if (!fork_lazy_pmap)
+				pmap_copy(new_map->pmap, old_map->pmap,
+				    new_entry->start,
+				    (old_entry->end - old_entry->start),
+				    old_entry->start);
 			break;
 
 		case VM_INHERIT_COPY:
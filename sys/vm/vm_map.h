@@ -71,6 +71,7 @@
 #include <sys/lock.h>
 #include <sys/sx.h>
 #include <sys/_mutex.h>
+#include <sys/_smr.h>
 
 /*
  *	Types defined:
@@ -203,6 +204,7 @@ struct vm_map {
 	int nentries;			/* Number of entries */
 	vm_size_t size;			/* virtual size */
 	u_int timestamp;		/* Version number */
+	u_int version;			/* Odd while being modified */
 	u_char needs_wakeup;
 	u_char system_map;		/* (c) Am I a system map? */
 	vm_flags_t flags;		/* flags for this vm_map */
@@ -380,6 +382,11 @@ long vmspace_resident_count(struct vmspace *vmspace);
 #define	VM_FAULT_NORMAL	0		/* Nothing special */
 #define	VM_FAULT_WIRE	1		/* Wire the mapped page */
 #define	VM_FAULT_DIRTY	2		/* Dirty the page; use w/VM_PROT_COPY */
+#define	VM_FAULT_ASYNC	4		/* Start pager I/O without sleeping;
+					   vm_fault() may return
+					   KERN_INPROGRESS and the caller must
+					   re-issue the fault later.  Only for
+					   kernel callers. */
 
 /*
  * Initially, mappings are slightly sequential.  The maximum window size must
@@ -472,6 +479,11 @@ int vm_map_lookup_locked(vm_map_t *, vm_offset_t, vm_prot_t, vm_map_entry_t *, v
     vm_pindex_t *, vm_prot_t *, boolean_t *);
 void vm_map_lookup_done (vm_map_t, vm_map_entry_t);
 boolean_t vm_map_lookup_entry (vm_map_t, vm_offset_t, vm_map_entry_t *);
+boolean_t vm_map_lookup_entry_unlocked(vm_map_t, vm_offset_t,
+    vm_map_entry_t *, u_int *);
+boolean_t vm_map_version_verify(vm_map_t, u_int);
+
+extern smr_t vm_map_smr;
 
 static inline vm_map_entry_t
 vm_map_entry_first(vm_map_t map)
@@ -498,6 +510,8 @@ vm_map_entry_succ(vm_map_entry_t entry)
 	for ((it) = vm_map_entry_first(map);	\
 	    (it) != &(map)->header;		\
 	    (it) = vm_map_entry_succ(it))
+void vm_map_pmap_enter(vm_map_t map, vm_offset_t addr, vm_prot_t prot,
+    vm_object_t object, vm_pindex_t pindex, vm_size_t size, int flags);
 int vm_map_protect (vm_map_t, vm_offset_t, vm_offset_t, vm_prot_t, boolean_t);
 int vm_map_remove (vm_map_t, vm_offset_t, vm_offset_t);
 void vm_map_try_merge_entries(vm_map_t map, vm_map_entry_t prev,
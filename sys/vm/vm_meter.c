@@ -420,6 +420,50 @@ VM_STATS_UINT(v_free_severe, "Severe page depletion point");
 SYSCTL_ULONG(_vm_stats_vm, OID_AUTO, v_user_wire_count, CTLFLAG_RD,
     &vm_user_wire_count, 0, "User-wired virtual memory");
 
+/*
+ * Export all of the above statistics in a single copy, for monitoring
+ * tools that would otherwise issue one sysctl per statistic on every
+ * refresh.  The snapshot is not atomic with respect to the individual
+ * counters, no more so than a sequence of single fetches would be.
+ */
+static int
+sysctl_vmstat_snapshot(SYSCTL_HANDLER_ARGS)
+{
+	struct vmstats_snap s;
+	counter_u64_t *cnt;
+	uint64_t *out;
+	u_int i;
+
+	bzero(&s, sizeof(s));
+
+	/* The leading snapshot fields mirror the vmmeter counters. */
+	cnt = (counter_u64_t *)&vm_cnt;
+	out = (uint64_t *)&s;
+	for (i = 0; i < VM_METER_NCOUNTERS; i++)
+		out[i] = counter_u64_fetch(cnt[i]);
+
+	s.v_page_size = vm_cnt.v_page_size;
+	s.v_page_count = vm_cnt.v_page_count;
+	s.v_free_reserved = vm_cnt.v_free_reserved;
+	s.v_free_target = vm_cnt.v_free_target;
+	s.v_free_min = vm_cnt.v_free_min;
+	s.v_free_count = vm_free_count();
+	s.v_inactive_target = vm_cnt.v_inactive_target;
+	s.v_active_count = vm_active_count();
+	s.v_inactive_count = vm_inactive_count();
+	s.v_laundry_count = vm_laundry_count();
+	s.v_pageout_free_min = vm_cnt.v_pageout_free_min;
+	s.v_interrupt_free_min = vm_cnt.v_interrupt_free_min;
+	s.v_free_severe = vm_cnt.v_free_severe;
+	s.v_user_wire_count = vm_user_wire_count;
+
+	return (SYSCTL_OUT(req, &s, sizeof(s)));
+}
+
+SYSCTL_PROC(_vm_stats, OID_AUTO, snapshot, CTLTYPE_OPAQUE | CTLFLAG_RD |
+    CTLFLAG_MPSAFE, NULL, 0, sysctl_vmstat_snapshot, "S,vmstats_snap",
+    "Snapshot of all vm.stats statistics in one copy");
+
 #ifdef COMPAT_FREEBSD11
 /*
  * Provide compatibility sysctls for the benefit of old utilities which exit
@@ -286,7 +286,7 @@ kern_mmap_req(struct thread *td, const struct mmap_req *mrp)
 	}
 	if ((flags & ~(MAP_SHARED | MAP_PRIVATE | MAP_FIXED | MAP_HASSEMAPHORE |
 	    MAP_STACK | MAP_NOSYNC | MAP_ANON | MAP_EXCL | MAP_NOCORE |
-	    MAP_PREFAULT_READ | MAP_GUARD |
+	    MAP_PREFAULT_READ | MAP_POPULATE | MAP_GUARD |
 #ifdef MAP_32BIT
 	    MAP_32BIT |
 #endif
@@ -1542,6 +1542,59 @@ kern_mmap_racct_check(struct thread *td, vm_map_t map, vm_size_t size)
 	return (0);
 }
 
+/*
+ * Populate the pages backing the specified range of a new mapping and
+ * preload them into the pmap, so that the region can be used without
+ * taking a minor fault on every page.  Population is best effort: the
+ * range that could not be populated is simply left to fault on demand.
+ *
+ * The range's backing object is allocated here if the mapping does not
+ * have one yet, and the pages are allocated and zeroed, or paged in,
+ * in batches by the backing object's pager.
+ */
+static void
+vm_mmap_populate(vm_map_t map, vm_offset_t addr, vm_size_t size,
+    vm_prot_t prot)
+{
+	vm_map_entry_t entry;
+	vm_object_t object;
+	vm_pindex_t pindex;
+	vm_prot_t fault_prot;
+	boolean_t wired;
+
+	if ((prot & (VM_PROT_READ | VM_PROT_EXECUTE)) == 0)
+		return;
+
+	/*
+	 * A fault-type lookup creates the backing anonymous object on
+	 * demand and returns with the map read locked, which keeps the
+	 * new mapping in place while its pmap entries are created.
+	 */
+	if (vm_map_lookup(&map, addr, prot & (VM_PROT_READ |
+	    VM_PROT_EXECUTE), &entry, &object, &pindex, &fault_prot,
+	    &wired) != KERN_SUCCESS)
+		return;
+	if (object != NULL) {
+		/*
+		 * Fictitious pages are inserted by the device pagers
+		 * themselves; only pager-backed objects are populated
+		 * here.  vm_map_pmap_enter() preloads device objects
+		 * through pmap_object_init_pt() instead.
+		 */
+		if (object->type == OBJT_DEFAULT ||
+		    object->type == OBJT_SWAP ||
+		    object->type == OBJT_VNODE) {
+			VM_OBJECT_WLOCK(object);
+			(void)vm_object_populate(object, pindex,
+			    pindex + atop(size));
+			VM_OBJECT_WUNLOCK(object);
+		}
+		vm_map_pmap_enter(map, addr, fault_prot, object, pindex,
+		    size, MAP_PREFAULT);
+	}
+	vm_map_lookup_done(map, entry);
+}
+
 /*
  * Internal version of mmap that maps a specific VM object into an
  * map.  Called by mmap for MAP_ANON, vm_mmap, shm_mmap, and vn_mmap.
@@ -1640,6 +1693,10 @@ vm_mmap_object(vm_map_t map, vm_offset_t *addr, vm_size_t size, vm_prot_t prot,
 	}
 
 	if (rv == KERN_SUCCESS) {
+		if ((flags & (MAP_POPULATE | MAP_GUARD | MAP_STACK)) ==
+		    MAP_POPULATE)
+			vm_mmap_populate(map, *addr, size, prot);
+
 		/*
 		 * If the process has requested that all future mappings
 		 * be wired, then heed this.
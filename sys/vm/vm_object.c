@@ -86,6 +86,7 @@ __FBSDID("$FreeBSD$");
 #include <sys/resourcevar.h>
 #include <sys/refcount.h>
 #include <sys/rwlock.h>
+#include <sys/seqc.h>
 #include <sys/user.h>
 #include <sys/vnode.h>
 #include <sys/vmmeter.h>
@@ -223,6 +224,7 @@ vm_object_zinit(void *mem, int size, int flags)
 	object->resident_page_count = 0;
 	object->shadow_count = 0;
 	object->flags = OBJ_DEAD;
+	object->backing_seqc = 0;
 
 	mtx_lock(&vm_object_list_mtx);
 	TAILQ_INSERT_TAIL(&vm_object_list, object, object_list);
@@ -713,6 +715,20 @@ vm_object_destroy(vm_object_t object)
 	uma_zfree(obj_zone, object);
 }
 
+/*
+ * Publish an update of the backing object link.  The seqc write section
+ * lets the lockless shadow chain walk detect a concurrent update and
+ * read the link and the backing object offset as a consistent pair.
+ */
+static void
+vm_object_backing_store(vm_object_t object, vm_object_t backing_object)
+{
+
+	seqc_write_begin(&object->backing_seqc);
+	object->backing_object = backing_object;
+	seqc_write_end(&object->backing_seqc);
+}
+
 static void
 vm_object_backing_remove_locked(vm_object_t object)
 {
@@ -730,7 +746,7 @@ vm_object_backing_remove_locked(vm_object_t object)
 		backing_object->shadow_count--;
 		object->flags &= ~OBJ_SHADOWLIST;
 	}
-	object->backing_object = NULL;
+	vm_object_backing_store(object, NULL);
 }
 
 static void
@@ -746,7 +762,7 @@ vm_object_backing_remove(vm_object_t object)
 		vm_object_backing_remove_locked(object);
 		VM_OBJECT_WUNLOCK(backing_object);
 	} else
-		object->backing_object = NULL;
+		vm_object_backing_store(object, NULL);
 }
 
 static void
@@ -762,7 +778,7 @@ vm_object_backing_insert_locked(vm_object_t object, vm_object_t backing_object)
 		backing_object->shadow_count++;
 		object->flags |= OBJ_SHADOWLIST;
 	}
-	object->backing_object = backing_object;
+	vm_object_backing_store(object, backing_object);
 }
 
 static void
@@ -776,7 +792,7 @@ vm_object_backing_insert(vm_object_t object, vm_object_t backing_object)
 		vm_object_backing_insert_locked(object, backing_object);
 		VM_OBJECT_WUNLOCK(backing_object);
 	} else
-		object->backing_object = backing_object;
+		vm_object_backing_store(object, backing_object);
 }
 
 /*
@@ -799,7 +815,7 @@ vm_object_backing_insert_ref(vm_object_t object, vm_object_t backing_object)
 		VM_OBJECT_WUNLOCK(backing_object);
 	} else {
 		vm_object_reference(backing_object);
-		object->backing_object = backing_object;
+		vm_object_backing_store(object, backing_object);
 	}
 }
 
@@ -825,8 +841,8 @@ vm_object_backing_transfer(vm_object_t object, vm_object_t backing_object)
 		vm_object_backing_insert_locked(object, new_backing_object);
 		VM_OBJECT_WUNLOCK(new_backing_object);
 	} else {
-		object->backing_object = new_backing_object;
-		backing_object->backing_object = NULL;
+		vm_object_backing_store(object, new_backing_object);
+		vm_object_backing_store(backing_object, NULL);
 	}
 }
 
@@ -872,6 +888,131 @@ vm_object_backing_collapse_wait(vm_object_t object)
 	return (backing_object);
 }
 
+/*
+ * Shadow chain depth limit for the lockless walk.  The walk tolerates
+ * stale links, so a cycle assembled out of recycled objects, while
+ * practically impossible, must not hang the fault path.
+ */
+#define	VM_SHADOW_WALK_MAX	64
+
+/*
+ * Walk the shadow chain from (object, pindex) towards the backing
+ * objects without acquiring any object locks, stopping at the first
+ * level with a resident page.  Resident page lookup is safe against
+ * concurrent radix trie modification, and the link to the backing
+ * object is read as a consistent pair under backing_seqc.  A level may
+ * only be skipped when the resident page lookup was authoritative:
+ * a default object, which has no pager, that is neither dead nor in
+ * the middle of a collapse.  The type and flag reads are ordered after
+ * the radix miss and the seqc check, so a stale OBJT_DEFAULT or a
+ * stale clear flag cannot be paired with the page's absence or with a
+ * new link.  Returns false if the walk cannot be performed safely.
+ */
+static bool
+vm_object_shadow_walk_unlocked(vm_object_t object, vm_pindex_t pindex,
+    vm_object_t *robject, vm_pindex_t *rpindex, vm_page_t *rm)
+{
+	vm_object_t bobject;
+	vm_ooffset_t boffset;
+	vm_page_t m;
+	seqc_t seqc;
+	int depth;
+
+	for (depth = 0; depth < VM_SHADOW_WALK_MAX; depth++) {
+		m = vm_radix_lookup_unlocked(&object->rtree, pindex);
+		if (m != NULL) {
+			*robject = object;
+			*rpindex = pindex;
+			*rm = m;
+			return (true);
+		}
+
+		/*
+		 * Bail out instead of spinning if a link update is in
+		 * progress.
+		 */
+		seqc = seqc_read_any(&object->backing_seqc);
+		if (seqc_in_modify(seqc))
+			return (false);
+		bobject = atomic_load_ptr(&object->backing_object);
+		boffset = object->backing_object_offset;
+		if (!seqc_consistent(&object->backing_seqc, seqc))
+			return (false);
+		if (object->type != OBJT_DEFAULT ||
+		    (object->flags & (OBJ_DEAD | OBJ_COLLAPSING)) != 0 ||
+		    bobject == NULL)
+			return (false);
+		pindex += OFF_TO_IDX(boffset);
+		object = bobject;
+	}
+	return (false);
+}
+
+/*
+ *	vm_object_shadow_page_unlocked:
+ *
+ *	Look up the page backing (object, pindex) through object's shadow
+ *	chain without acquiring object locks.  The walk relies on objects
+ *	being type-stable and revalidates its result, so it may chase
+ *	stale links; the caller must prevent the top-level object from
+ *	being recycled, normally by holding the vm_map read-locked.
+ *
+ *	A candidate page found below the top-level object is shared
+ *	busied and its identity is rechecked by a second walk.  With the
+ *	busy lock held the translation can no longer change: a collapse
+ *	moving the page into a shadowing object or a copy-on-write fault
+ *	superseding it must first exclusive busy the page itself.
+ *
+ *	On success the returned page is shared busied, fully valid and
+ *	managed; the caller is responsible for releasing the busy lock.
+ *	A NULL return means the lookup could not be completed safely and
+ *	the caller must fall back to the locked shadow chain walk.
+ */
+vm_page_t
+vm_object_shadow_page_unlocked(vm_object_t object, vm_pindex_t pindex)
+{
+	vm_object_t mobject, vobject;
+	vm_page_t m, m2;
+	vm_pindex_t mpindex, vpindex;
+
+	if (!vm_object_shadow_walk_unlocked(object, pindex, &mobject,
+	    &mpindex, &m))
+		return (NULL);
+
+	/*
+	 * A page resident in the top-level object is the soft fast
+	 * path's business, not ours.
+	 */
+	if (mobject == object)
+		return (NULL);
+
+	if (vm_page_trysbusy(m) == 0)
+		return (NULL);
+
+	/*
+	 * Recheck the page's identity now that it can no longer be
+	 * moved or freed, and reject pages that cannot simply be
+	 * mapped.
+	 */
+	if (m->object != mobject || m->pindex != mpindex ||
+	    (m->oflags & VPO_UNMANAGED) != 0 || !vm_page_all_valid(m)) {
+		vm_page_sunbusy(m);
+		return (NULL);
+	}
+
+	/*
+	 * Walk the chain again to verify that the page was not
+	 * superseded before the busy lock was acquired.
+	 */
+	if (!vm_object_shadow_walk_unlocked(object, pindex, &vobject,
+	    &vpindex, &m2) || vobject != mobject || vpindex != mpindex ||
+	    m2 != m) {
+		vm_page_sunbusy(m);
+		return (NULL);
+	}
+	return (m);
+}
+
 /*
  *	vm_object_terminate_pages removes any remaining pageable pages
  *	from the object and resets the object to an empty state.
@@ -1976,11 +2117,19 @@ vm_object_collapse(vm_object_t object)
 
 			/*
 			 * Object now shadows whatever backing_object did.
+			 * The offset is published before the new backing
+			 * object link so that the lockless shadow chain
+			 * walk never pairs the new link with the stale
+			 * offset; the intermediate state still points at
+			 * the emptied, dead backing object and is rejected
+			 * by the walk.
 			 */
 			vm_object_clear_flag(object, OBJ_COLLAPSING);
-			vm_object_backing_transfer(object, backing_object);
+			seqc_write_begin(&object->backing_seqc);
 			object->backing_object_offset +=
 			    backing_object->backing_object_offset;
+			seqc_write_end(&object->backing_seqc);
+			vm_object_backing_transfer(object, backing_object);
 			VM_OBJECT_WUNLOCK(object);
 			vm_object_pip_wakeup(object);
 
@@ -2020,10 +2169,19 @@ vm_object_collapse(vm_object_t object)
 			vm_object_backing_remove_locked(object);
 			new_backing_object = backing_object->backing_object;
 			if (new_backing_object != NULL) {
-				vm_object_backing_insert_ref(object,
-				    new_backing_object);
+				/*
+				 * Publish the new offset before the new
+				 * backing object link; the lockless shadow
+				 * chain walk treats the intermediate NULL
+				 * link as the end of the chain and falls
+				 * back to the locked walk.
+				 */
+				seqc_write_begin(&object->backing_seqc);
 				object->backing_object_offset +=
 				    backing_object->backing_object_offset;
+				seqc_write_end(&object->backing_seqc);
+				vm_object_backing_insert_ref(object,
+				    new_backing_object);
 			}
 
 			/*
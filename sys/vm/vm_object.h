@@ -75,6 +75,7 @@
 #include <sys/_mutex.h>
 #include <sys/_pctrie.h>
 #include <sys/_rwlock.h>
+#include <sys/_seqc.h>
 #include <sys/_domainset.h>
 
 #include <vm/_vm_radix.h>
@@ -119,6 +120,7 @@ struct vm_object {
 	int resident_page_count;	/* number of resident pages */
 	struct vm_object *backing_object; /* object that I'm a shadow of */
 	vm_ooffset_t backing_object_offset;/* Offset in backing object */
+	seqc_t backing_seqc;		/* backing link modification counter */
 	TAILQ_ENTRY(vm_object) pager_object_list; /* list of all objects of this pager type */
 	LIST_HEAD(, vm_reserv) rvq;	/* list of reservations */
 	void *handle;
@@ -394,6 +396,7 @@ void vm_object_reference_locked(vm_object_t);
 int  vm_object_set_memattr(vm_object_t object, vm_memattr_t memattr);
 void vm_object_shadow(vm_object_t *, vm_ooffset_t *, vm_size_t, struct ucred *,
     bool);
+vm_page_t vm_object_shadow_page_unlocked(vm_object_t, vm_pindex_t);
 void vm_object_split(vm_map_entry_t);
 boolean_t vm_object_sync(vm_object_t, vm_ooffset_t, vm_size_t, boolean_t,
     boolean_t);
@@ -2069,7 +2069,15 @@ vm_page_alloc_domain_after(vm_object_t object, vm_pindex_t pindex, int domain,
 
 	flags = 0;
 	m = NULL;
-	pool = object != NULL ? VM_FREEPOOL_DEFAULT : VM_FREEPOOL_DIRECT;
+
+	/*
+	 * Pages that are wired from birth are typically unevictable kernel
+	 * allocations that stay resident for a long time.  Draw them from
+	 * the same pool as the unmanaged direct allocations so that they do
+	 * not fragment the pool backing movable pages and reservations.
+	 */
+	pool = object != NULL && (req & VM_ALLOC_WIRED) == 0 ?
+	    VM_FREEPOOL_DEFAULT : VM_FREEPOOL_DIRECT;
 again:
 #if VM_NRESERVLEVEL > 0
 	/*
@@ -2172,6 +2180,180 @@ found:
 	return (m);
 }
 
+static int
+vm_page_alloc_pages_domain_after(vm_object_t object, vm_pindex_t pindex,
+    int domain, int req, vm_page_t *ma, int npages, vm_page_t mpred)
+{
+	struct vm_domain *vmd;
+	vm_page_t m;
+	int avail, flags, i, pool;
+
+	KASSERT((object != NULL) == ((req & VM_ALLOC_NOOBJ) == 0) &&
+	    (object != NULL || (req & VM_ALLOC_SBUSY) == 0) &&
+	    ((req & (VM_ALLOC_NOBUSY | VM_ALLOC_SBUSY)) !=
+	    (VM_ALLOC_NOBUSY | VM_ALLOC_SBUSY)),
+	    ("inconsistent object(%p)/req(%x)", object, req));
+	KASSERT((req & (VM_ALLOC_WAITOK | VM_ALLOC_WAITFAIL)) == 0,
+	    ("vm_page_alloc_pages_domain_after: batch allocation can't sleep"));
+	KASSERT(mpred == NULL || mpred->pindex < pindex,
+	    ("mpred %p doesn't precede pindex 0x%jx", mpred,
+	    (uintmax_t)pindex));
+	KASSERT(npages > 0,
+	    ("vm_page_alloc_pages_domain_after: npages %d", npages));
+	if (object != NULL)
+		VM_OBJECT_ASSERT_WLOCKED(object);
+
+	pool = object != NULL && (req & VM_ALLOC_WIRED) == 0 ?
+	    VM_FREEPOOL_DEFAULT : VM_FREEPOOL_DIRECT;
+	vmd = VM_DOMAIN(domain);
+
+	/*
+	 * Charge the free page count for as much of the run as the
+	 * allocation class allows, then carve all of the pages out of
+	 * the physical allocator in one free queue transaction.
+	 */
+	while (!vm_domain_allocate(vmd, req, npages)) {
+		npages >>= 1;
+		if (npages == 0)
+			return (0);
+	}
+	vm_domain_free_lock(vmd);
+	avail = vm_phys_alloc_npages(domain, pool, npages, ma);
+	vm_domain_free_unlock(vmd);
+	if (avail < npages)
+		vm_domain_freecnt_inc(vmd, npages - avail);
+	if (avail == 0)
+		return (0);
+
+	/*
+	 * Initialize the pages.  Only the PG_ZERO flag is inherited.
+	 */
+	for (i = 0; i < avail; i++) {
+		m = ma[i];
+		vm_page_dequeue(m);
+		vm_page_alloc_check(m);
+
+		flags = 0;
+		if ((req & VM_ALLOC_ZERO) != 0)
+			flags |= (m->flags & PG_ZERO);
+		if ((req & VM_ALLOC_NODUMP) != 0)
+			flags |= PG_NODUMP;
+		m->flags = flags;
+		m->a.flags = 0;
+		m->oflags = object == NULL ||
+		    (object->flags & OBJ_UNMANAGED) != 0 ? VPO_UNMANAGED : 0;
+		if ((req & (VM_ALLOC_NOBUSY | VM_ALLOC_NOOBJ |
+		    VM_ALLOC_SBUSY)) == 0)
+			m->busy_lock = VPB_CURTHREAD_EXCLUSIVE;
+		else if ((req & VM_ALLOC_SBUSY) != 0)
+			m->busy_lock = VPB_SHARERS_WORD(1);
+		else
+			m->busy_lock = VPB_UNBUSIED;
+		if (req & VM_ALLOC_WIRED) {
+			vm_wire_add(1);
+			m->ref_count = 1;
+		}
+		m->a.act_count = 0;
+	}
+
+	for (i = 0; i < avail; i++) {
+		m = ma[i];
+		if (object != NULL) {
+			if (vm_page_insert_after(m, object, pindex + i,
+			    mpred) != 0)
+				break;
+			mpred = m;
+
+			/*
+			 * Ignore device objects; the pager sets "memattr"
+			 * for them.
+			 */
+			if (object->memattr != VM_MEMATTR_DEFAULT &&
+			    (object->flags & OBJ_FICTITIOUS) == 0)
+				pmap_page_set_memattr(m, object->memattr);
+		} else
+			m->pindex = pindex + i;
+	}
+	if (i < avail) {
+		/*
+		 * An index in the run was already populated.  Return the
+		 * prefix that was inserted and release the remainder.
+		 */
+		for (int j = i; j < avail; j++) {
+			m = ma[j];
+			if (req & VM_ALLOC_WIRED) {
+				vm_wire_sub(1);
+				m->ref_count = 0;
+			}
+			KASSERT(m->object == NULL,
+			    ("page %p has object", m));
+			m->oflags = VPO_UNMANAGED;
+			m->busy_lock = VPB_UNBUSIED;
+			/* Don't change PG_ZERO. */
+			vm_page_free_toq(m);
+		}
+	}
+	return (i);
+}
+
+/*
+ *	vm_page_alloc_pages_after:
+ *
+ *	Allocate a run of "npages" pages at the consecutive page indices
+ *	starting at "pindex".  The free page count is charged and the
+ *	physical allocator is visited once for the entire batch rather
+ *	than once per page.  The pages need not be physically contiguous
+ *	and are returned in "ma" in index order.
+ *
+ *	The pages are initialized exactly as vm_page_alloc() would
+ *	initialize them.  Sleeping allocation classes are not supported;
+ *	the caller must be prepared for a short count.
+ *
+ *	Returns the number of pages allocated, which may be less than
+ *	"npages" if memory is short or one of the indices is already
+ *	populated in the object.  The allocated run is always the prefix
+ *	of the requested range; nothing is unwound on partial success.
+ */
+int
+vm_page_alloc_pages_after(vm_object_t object, vm_pindex_t pindex, int req,
+    vm_page_t *ma, int npages, vm_page_t mpred)
+{
+	struct vm_domainset_iter di;
+	int count, domain, n;
+
+	count = 0;
+	vm_domainset_iter_page_init(&di, object, pindex, &domain, &req);
+	do {
+		n = vm_page_alloc_pages_domain_after(object, pindex + count,
+		    domain, req, ma + count, npages - count, mpred);
+		count += n;
+		if (count == npages)
+			break;
+		if (n > 0)
+			mpred = ma[count - 1];
+
+		/*
+		 * If the run was cut short because the next index is
+		 * already populated, trying other domains cannot help.
+		 */
+		if (object != NULL &&
+		    vm_radix_lookup(&object->rtree, pindex + count) != NULL)
+			break;
+	} while (vm_domainset_iter_page(&di, object, &domain) == 0);
+
+	return (count);
+}
+
+int
+vm_page_alloc_pages(vm_object_t object, vm_pindex_t pindex, int req,
+    vm_page_t *ma, int npages)
+{
+
+	return (vm_page_alloc_pages_after(object, pindex, req, ma, npages,
+	    object != NULL ? vm_radix_lookup_le(&object->rtree, pindex) :
+	    NULL));
+}
+
 /*
  *	vm_page_alloc_contig:
  *
@@ -169,6 +169,11 @@ static int pageout_cpus_per_thread = 16;
 SYSCTL_INT(_vm, OID_AUTO, pageout_cpus_per_thread, CTLFLAG_RDTUN,
     &pageout_cpus_per_thread, 0,
     "Number of CPUs per pagedaemon worker thread");
+
+static int laundry_threads_per_domain = 1;
+SYSCTL_INT(_vm, OID_AUTO, laundry_threads_per_domain, CTLFLAG_RDTUN,
+    &laundry_threads_per_domain, 0,
+    "Number of laundry worker threads per memory domain");
   
 SYSCTL_INT(_vm, OID_AUTO, lowmem_period, CTLFLAG_RWTUN, &lowmem_period, 0,
 	"Low memory callback period");
@@ -723,6 +728,7 @@ vm_pageout_launder(struct vm_domain *vmd, int launder, bool in_shortfall)
 {
 	struct scan_state ss;
 	struct vm_pagequeue *pq;
+	struct vm_page marker_page;
 	vm_object_t object;
 	vm_page_t m, marker;
 	vm_page_astate_t new, old;
@@ -749,7 +755,12 @@ vm_pageout_launder(struct vm_domain *vmd, int launder, bool in_shortfall)
 		queue = PQ_LAUNDRY;
 
 scan:
-	marker = &vmd->vmd_markers[queue];
+	/*
+	 * Use a private marker so that concurrent laundry threads can scan
+	 * the same queue.
+	 */
+	marker = &marker_page;
+	vm_page_init_marker(marker, queue, 0);
 	pq = &vmd->vmd_pagequeues[queue];
 	vm_pagequeue_lock(pq);
 	vm_pageout_init_scan(&ss, pq, marker, NULL, pq->pq_cnt);
@@ -959,6 +970,45 @@ skip_page:
 	return (starting_target - launder);
 }
 
+/*
+ * Split the launder target among the configured number of laundry threads
+ * and collect their results.  Partitioning of the laundry queue itself
+ * happens naturally, batch by batch, through the page queue scan machinery.
+ * Helpers are only dispatched when each thread has at least a cluster's
+ * worth of work to do.
+ */
+static int
+vm_pageout_launder_dispatch(struct vm_domain *vmd, int launder,
+    bool in_shortfall)
+{
+	u_int threads;
+	int laundered;
+
+	threads = vmd->vmd_laundry_threads;
+	if (threads > 1 && launder / (int)threads >= vm_pageout_page_count) {
+		vm_domain_pageout_lock(vmd);
+		vmd->vmd_laundry_pt_target = launder / threads;
+		vmd->vmd_laundry_shortfall = in_shortfall;
+		blockcount_acquire(&vmd->vmd_laundry_starting, threads - 1);
+		blockcount_acquire(&vmd->vmd_laundry_running, threads - 1);
+		wakeup(&vmd->vmd_laundry_pt_target);
+		vm_domain_pageout_unlock(vmd);
+		launder = vmd->vmd_laundry_pt_target;
+	}
+
+	/* Run the local thread scan. */
+	laundered = vm_pageout_launder(vmd, launder, in_shortfall);
+
+	/*
+	 * Block until helper threads report results and then accumulate
+	 * totals.
+	 */
+	blockcount_wait(&vmd->vmd_laundry_running, NULL, "lndwait", PVM);
+	laundered += atomic_readandclear_int(&vmd->vmd_laundry_laundered);
+
+	return (laundered);
+}
+
 /*
  * Compute the integer square root.
  */
@@ -1104,7 +1154,7 @@ dolaundry:
 			 * pages could exceed "target" by the maximum size of
 			 * a cluster minus one. 
 			 */
-			target -= min(vm_pageout_launder(vmd, launder,
+			target -= min(vm_pageout_launder_dispatch(vmd, launder,
 			    in_shortfall), target);
 			pause("laundp", hz / VM_LAUNDER_RATE);
 		}
@@ -2200,6 +2250,38 @@ vm_pageout_helper(void *arg)
 	}
 }
 
+/*
+ * vm_pageout_laundry_helper runs additional laundry threads when the launder
+ * target is large enough to be split among several workers.
+ */
+static void
+vm_pageout_laundry_helper(void *arg)
+{
+	struct vm_domain *vmd;
+	int laundered;
+
+	vmd = VM_DOMAIN((uintptr_t)arg);
+
+	vm_domain_pageout_lock(vmd);
+	for (;;) {
+		msleep(&vmd->vmd_laundry_pt_target,
+		    vm_domain_pageout_lockptr(vmd), PVM, "lndslp", 0);
+		blockcount_release(&vmd->vmd_laundry_starting, 1);
+
+		vm_domain_pageout_unlock(vmd);
+		laundered = vm_pageout_launder(vmd, vmd->vmd_laundry_pt_target,
+		    vmd->vmd_laundry_shortfall);
+		atomic_add_int(&vmd->vmd_laundry_laundered, laundered);
+		vm_domain_pageout_lock(vmd);
+
+		/*
+		 * Release the running count while the pageout lock is held to
+		 * prevent wakeup races.
+		 */
+		blockcount_release(&vmd->vmd_laundry_running, 1);
+	}
+}
+
 static int
 get_pageout_threads_per_domain(const struct vm_domain *vmd)
 {
@@ -2290,6 +2372,12 @@ vm_pageout_init_domain(int domain)
 	pidctrl_init_sysctl(&vmd->vmd_pid, SYSCTL_CHILDREN(oid));
 
 	vmd->vmd_inactive_threads = get_pageout_threads_per_domain(vmd);
+
+	if (laundry_threads_per_domain < 1)
+		laundry_threads_per_domain = 1;
+	else if (laundry_threads_per_domain > mp_ncpus)
+		laundry_threads_per_domain = mp_ncpus;
+	vmd->vmd_laundry_threads = laundry_threads_per_domain;
 }
 
 static void
@@ -2376,6 +2464,15 @@ vm_pageout(void)
 		    (void *)(uintptr_t)i, p, NULL, 0, 0, "laundry: dom%d", i);
 		if (error != 0)
 			panic("starting laundry for domain %d: %d", i, error);
+		pageout_threads = VM_DOMAIN(i)->vmd_laundry_threads;
+		for (j = 0; j < pageout_threads - 1; j++) {
+			error = kthread_add(vm_pageout_laundry_helper,
+			    (void *)(uintptr_t)i, p, NULL, 0, 0,
+			    "laundry: dom%d helper%d", i, j);
+			if (error != 0)
+				panic("starting laundry helper %d for domain "
+				    "%d: %d\n", j, i, error);
+		}
 	}
 	error = kthread_add(uma_reclaim_worker, NULL, p, NULL, 0, 0, "uma");
 	if (error != 0)
@@ -263,6 +263,12 @@ struct vm_domain {
 	volatile u_int vmd_inactive_freed;	/* Successful inactive frees. */
 	volatile u_int vmd_inactive_us;		/* Microseconds for above. */
 	u_int vmd_inactive_pps;		/* Exponential decay frees/second. */
+	u_int vmd_laundry_threads;	/* Number of laundry threads. */
+	u_int vmd_laundry_pt_target;	/* Per-thread launder target. */
+	bool vmd_laundry_shortfall;	/* Helpers launder for a shortfall. */
+	blockcount_t vmd_laundry_running;	/* Number of laundry threads. */
+	blockcount_t vmd_laundry_starting;	/* Number of threads started. */
+	volatile u_int vmd_laundry_laundered;	/* Pages laundered by helpers. */
 	int vmd_oom_seq;
 	int vmd_last_active_scan;
 	struct vm_page vmd_markers[PQ_COUNT]; /* (q) markers for queue scans */
@@ -115,6 +115,7 @@ struct xswdev {
 #define	KERN_NO_ACCESS		8
 #define	KERN_OUT_OF_BOUNDS	9
 #define	KERN_RESTART		10
+#define	KERN_INPROGRESS		11
 
 #ifndef PA_LOCK_COUNT
 #ifdef SMP
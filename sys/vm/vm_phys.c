@@ -1239,6 +1239,35 @@ vm_phys_free_contig(vm_page_t m, u_long npages)
 		vm_phys_free_pages(m_end, order_end);
 }
 
+/*
+ * Count the number of aligned, order-sized blocks that are available within
+ * the free page queues of the specified domain.  A free block of a larger
+ * order is counted as the corresponding number of order-sized blocks.
+ *
+ * The free page queues must be locked.
+ */
+u_long
+vm_phys_count_free_blocks(int domain, int order)
+{
+	struct vm_freelist *fl;
+	u_long count;
+	int flind, oind, pind;
+
+	vm_domain_free_assert_locked(VM_DOMAIN(domain));
+	KASSERT(order < VM_NFREEORDER,
+	    ("vm_phys_count_free_blocks: order %d is out of range", order));
+	count = 0;
+	for (flind = 0; flind < vm_nfreelists; flind++) {
+		for (pind = 0; pind < VM_NFREEPOOL; pind++) {
+			fl = vm_phys_free_queues[domain][flind][pind];
+			for (oind = order; oind < VM_NFREEORDER; oind++)
+				count += (u_long)fl[oind].lcnt <<
+				    (oind - order);
+		}
+	}
+	return (count);
+}
+
 /*
  * Scan physical memory between the specified addresses "low" and "high" for a
  * run of contiguous physical pages that satisfy the specified conditions, and
@@ -107,10 +107,13 @@ typedef SMR_POINTER(struct vm_radix_node *) smrnode_t;
 struct vm_radix_node {
 	vm_pindex_t	rn_owner;			/* Owner of record. */
 	uint16_t	rn_count;			/* Valid children. */
+	uint16_t	rn_popmap;			/* Valid children mask. */
 	uint8_t		rn_clev;			/* Current level. */
 	int8_t		rn_last;			/* zero last ptr. */
 	smrnode_t	rn_child[VM_RADIX_COUNT];	/* Child nodes. */
 };
+_Static_assert(sizeof(((struct vm_radix_node *)NULL)->rn_popmap) * NBBY >=
+    VM_RADIX_COUNT, "rn_popmap cannot cover all children");
 
 static uma_zone_t vm_radix_node_zone;
 static smr_t vm_radix_smr;
@@ -142,6 +145,7 @@ vm_radix_node_get(vm_pindex_t owner, uint16_t count, uint16_t clevel)
 	}
 	rnode->rn_owner = owner;
 	rnode->rn_count = count;
+	rnode->rn_popmap = 0;
 	rnode->rn_clev = clevel;
 	return (rnode);
 }
@@ -270,6 +274,27 @@ vm_radix_topage(struct vm_radix_node *rnode)
 	return ((vm_page_t)((uintptr_t)rnode & ~VM_RADIX_FLAGS));
 }
 
+/*
+ * Mark a slot as populated or empty in a node's bitmap.  The bitmap mirrors
+ * the non-NULL child pointers and lets the ordered lookups find the next
+ * populated slot with a single ffs()/fls() instead of probing every slot.
+ * It is only read under the tree lock, so no ordering with respect to the
+ * child pointer stores is required.
+ */
+static __inline void
+vm_radix_popmap_set(struct vm_radix_node *rnode, int slot)
+{
+
+	rnode->rn_popmap |= 1 << slot;
+}
+
+static __inline void
+vm_radix_popmap_clr(struct vm_radix_node *rnode, int slot)
+{
+
+	rnode->rn_popmap &= ~(1 << slot);
+}
+
 /*
  * Adds the page as a child of the provided node.
  */
@@ -280,6 +305,7 @@ vm_radix_addpage(struct vm_radix_node *rnode, vm_pindex_t index, uint16_t clev,
 	int slot;
 
 	slot = vm_radix_slot(index, clev);
+	vm_radix_popmap_set(rnode, slot);
 	vm_radix_node_store(&rnode->rn_child[slot],
 	    (struct vm_radix_node *)((uintptr_t)page | VM_RADIX_ISLEAF), access);
 }
@@ -448,6 +474,7 @@ vm_radix_insert(struct vm_radix *rtree, vm_page_t page)
 	slot = vm_radix_slot(newind, clev);
 	/* These writes are not yet visible due to ordering. */
 	vm_radix_addpage(tmp, index, clev, page, UNSERIALIZED);
+	vm_radix_popmap_set(tmp, slot);
 	vm_radix_node_store(&tmp->rn_child[slot], rnode, UNSERIALIZED);
 	/* Serializing write to make the above visible. */
 	vm_radix_node_store(parentp, tmp, LOCKED);
@@ -540,7 +567,7 @@ vm_radix_lookup_ge(struct vm_radix *rtree, vm_pindex_t index)
 #ifdef INVARIANTS
 	int loops = 0;
 #endif
-	int slot, tos;
+	int nslot, pops, slot, tos;
 
 	rnode = vm_radix_root_load(rtree, LOCKED);
 	if (rnode == NULL)
@@ -603,26 +630,28 @@ ascend:
 
 		/*
 		 * Look for an available edge or page within the current
-		 * bisection node.
+		 * bisection node.  The population bitmap identifies the next
+		 * non-empty slot without probing the intermediate ones.
 		 */
-                if (slot < (VM_RADIX_COUNT - 1)) {
+		pops = rnode->rn_popmap & ~((2 << slot) - 1);
+		if (pops != 0) {
 			inc = VM_RADIX_UNITLEVEL(rnode->rn_clev);
-			index = vm_radix_trimkey(index, rnode->rn_clev);
-			do {
-				index += inc;
-				slot++;
-				child = vm_radix_node_load(&rnode->rn_child[slot],
-				    LOCKED);
-				if (vm_radix_isleaf(child)) {
-					m = vm_radix_topage(child);
-					if (m->pindex >= index)
-						return (m);
-				} else if (child != NULL)
-					goto descend;
-			} while (slot < (VM_RADIX_COUNT - 1));
+			nslot = ffs(pops) - 1;
+			index = vm_radix_trimkey(index, rnode->rn_clev) +
+			    (vm_pindex_t)(nslot - slot) * inc;
+			slot = nslot;
+			child = vm_radix_node_load(&rnode->rn_child[slot],
+			    LOCKED);
+			KASSERT(child != NULL,
+			    ("vm_radix_lookup_ge: stale popmap entry"));
+			if (vm_radix_isleaf(child)) {
+				m = vm_radix_topage(child);
+				KASSERT(m->pindex >= index,
+				    ("vm_radix_lookup_ge: leaf < index"));
+				return (m);
+			}
+			goto descend;
 		}
-		KASSERT(child == NULL || vm_radix_isleaf(child),
-		    ("vm_radix_lookup_ge: child is radix node"));
 
 		/*
 		 * If a page or edge greater than the search slot is not found
@@ -652,7 +681,7 @@ vm_radix_lookup_le(struct vm_radix *rtree, vm_pindex_t index)
 #ifdef INVARIANTS
 	int loops = 0;
 #endif
-	int slot, tos;
+	int nslot, pops, slot, tos;
 
 	rnode = vm_radix_root_load(rtree, LOCKED);
 	if (rnode == NULL)
@@ -717,26 +746,29 @@ ascend:
 
 		/*
 		 * Look for an available edge or page within the current
-		 * bisection node.
+		 * bisection node.  The population bitmap identifies the
+		 * previous non-empty slot without probing the intermediate
+		 * ones.
 		 */
-		if (slot > 0) {
+		pops = rnode->rn_popmap & ((1 << slot) - 1);
+		if (pops != 0) {
 			inc = VM_RADIX_UNITLEVEL(rnode->rn_clev);
-			index |= inc - 1;
-			do {
-				index -= inc;
-				slot--;
-				child = vm_radix_node_load(&rnode->rn_child[slot],
-				    LOCKED);
-				if (vm_radix_isleaf(child)) {
-					m = vm_radix_topage(child);
-					if (m->pindex <= index)
-						return (m);
-				} else if (child != NULL)
-					goto descend;
-			} while (slot > 0);
+			nslot = fls(pops) - 1;
+			index = (index | (inc - 1)) -
+			    (vm_pindex_t)(slot - nslot) * inc;
+			slot = nslot;
+			child = vm_radix_node_load(&rnode->rn_child[slot],
+			    LOCKED);
+			KASSERT(child != NULL,
+			    ("vm_radix_lookup_le: stale popmap entry"));
+			if (vm_radix_isleaf(child)) {
+				m = vm_radix_topage(child);
+				KASSERT(m->pindex <= index,
+				    ("vm_radix_lookup_le: leaf > index"));
+				return (m);
+			}
+			goto descend;
 		}
-		KASSERT(child == NULL || vm_radix_isleaf(child),
-		    ("vm_radix_lookup_le: child is radix node"));
 
 		/*
 		 * If a page or edge smaller than the search slot is not found
@@ -783,15 +815,13 @@ vm_radix_remove(struct vm_radix *rtree, vm_pindex_t index)
 			if (m->pindex != index)
 				return (NULL);
 			vm_radix_node_store(&rnode->rn_child[slot], NULL, LOCKED);
+			vm_radix_popmap_clr(rnode, slot);
 			rnode->rn_count--;
 			if (rnode->rn_count > 1)
 				return (m);
-			for (i = 0; i < VM_RADIX_COUNT; i++)
-				if (vm_radix_node_load(&rnode->rn_child[i],
-				    LOCKED) != NULL)
-					break;
-			KASSERT(i != VM_RADIX_COUNT,
+			KASSERT(rnode->rn_popmap != 0,
 			    ("%s: invalid node configuration", __func__));
+			i = ffs(rnode->rn_popmap) - 1;
 			tmp = vm_radix_node_load(&rnode->rn_child[i], LOCKED);
 			if (parent == NULL)
 				vm_radix_root_store(rtree, tmp, LOCKED);
@@ -45,6 +45,7 @@ __FBSDID("$FreeBSD$");
 
 #include <sys/param.h>
 #include <sys/kernel.h>
+#include <sys/kthread.h>
 #include <sys/lock.h>
 #include <sys/malloc.h>
 #include <sys/mutex.h>
@@ -288,6 +289,21 @@ static COUNTER_U64_DEFINE_EARLY(vm_reserv_reclaimed);
 SYSCTL_COUNTER_U64(_vm_reserv, OID_AUTO, reclaimed, CTLFLAG_RD,
     &vm_reserv_reclaimed, "Cumulative number of reclaimed reservations");
 
+static int vm_reserv_defrag_period = 60;
+SYSCTL_INT(_vm_reserv, OID_AUTO, defrag_period, CTLFLAG_RWTUN,
+    &vm_reserv_defrag_period, 0,
+    "Seconds between defragmentation passes, or 0 to disable");
+
+static int vm_reserv_defrag_free_target = 32;
+SYSCTL_INT(_vm_reserv, OID_AUTO, defrag_free_target, CTLFLAG_RWTUN,
+    &vm_reserv_defrag_free_target, 0,
+    "Number of free superpage-sized blocks to maintain per domain");
+
+static COUNTER_U64_DEFINE_EARLY(vm_reserv_defragged);
+SYSCTL_COUNTER_U64(_vm_reserv, OID_AUTO, defragged, CTLFLAG_RD,
+    &vm_reserv_defragged,
+    "Cumulative number of free superpage-sized blocks rebuilt");
+
 /*
  * The object lock pool is used to synchronize the rvq.  We can not use a
  * pool mutex because it is required before malloc works.
@@ -1133,6 +1149,26 @@ vm_reserv_level_iffullpop(vm_page_t m)
 	return (rv->popcnt == VM_LEVEL_0_NPAGES ? 0 : -1);
 }
 
+/*
+ * Returns the number of fully populated reservations belonging to the
+ * given object, i.e., the number of level 0 superpages backing it.
+ */
+int
+vm_reserv_object_fullpop(vm_object_t object)
+{
+	vm_reserv_t rv;
+	int fullpop;
+
+	fullpop = 0;
+	vm_reserv_object_lock(object);
+	LIST_FOREACH(rv, &object->rvq, objq) {
+		if (rv->popcnt == VM_LEVEL_0_NPAGES)
+			fullpop++;
+	}
+	vm_reserv_object_unlock(object);
+	return (fullpop);
+}
+
 /*
  * Remove a partially populated reservation from the queue.
  */
@@ -1458,4 +1494,59 @@ vm_reserv_to_superpage(vm_page_t m)
 	return (m);
 }
 
+/*
+ * The defragmentation daemon.  After days of uptime the free page queues
+ * decay into small, scattered blocks and reservation allocations start
+ * failing, which in turn suppresses superpage promotion.  Periodically
+ * rebuild free superpage-sized blocks by relocating the pages within a
+ * lightly used run, using the same relocation machinery that serves
+ * contiguous allocation failures, until each domain again holds a minimum
+ * stock of such blocks.
+ */
+static void
+vm_reserv_defrag(void)
+{
+	u_long count;
+	int domain, period, tries;
+
+	for (;;) {
+		period = vm_reserv_defrag_period;
+		tsleep(&vm_reserv_defrag_period, PVM, "defrag",
+		    (period > 0 ? period : 60) * hz);
+		if (vm_reserv_defrag_period <= 0)
+			continue;
+		for (domain = 0; domain < vm_ndomains; domain++) {
+			/*
+			 * Bound the number of relocation passes so that a
+			 * workload that immediately consumes the rebuilt
+			 * blocks cannot keep the daemon spinning.
+			 */
+			tries = 0;
+			for (;;) {
+				vm_domain_free_lock(VM_DOMAIN(domain));
+				count = vm_phys_count_free_blocks(domain,
+				    VM_LEVEL_0_ORDER);
+				vm_domain_free_unlock(VM_DOMAIN(domain));
+				if (count >= vm_reserv_defrag_free_target ||
+				    tries >= vm_reserv_defrag_free_target)
+					break;
+				if (!vm_page_reclaim_contig_domain(domain,
+				    VM_ALLOC_NORMAL, VM_LEVEL_0_NPAGES, 0,
+				    ~(vm_paddr_t)0, VM_LEVEL_0_SIZE, 0))
+					break;
+				counter_u64_add(vm_reserv_defragged, 1);
+				tries++;
+			}
+		}
+	}
+}
+
+static struct proc *defragproc;
+static struct kproc_desc defrag_kp = {
+	"defrag",
+	vm_reserv_defrag,
+	&defragproc
+};
+SYSINIT(defrag, SI_SUB_KTHREAD_VM, SI_ORDER_ANY, kproc_start, &defrag_kp);
+
 #endif	/* VM_NRESERVLEVEL > 0 */
@@ -982,7 +982,7 @@ vnode_pager_generic_getpages(struct vnode *vp, vm_page_t *m, int count,
 	bp->b_npages += count;
 
 	if (rahead) {
-		vm_pindex_t endpindex, tpindex;
+		vm_pindex_t endpindex, startpindex;
 		vm_page_t p;
 
 		if (!VM_OBJECT_WOWNED(object))
@@ -994,13 +994,16 @@ vnode_pager_generic_getpages(struct vnode *vp, vm_page_t *m, int count,
 		if (endpindex > object->size)
 			endpindex = object->size;
 
-		for (tpindex = m[count - 1]->pindex + 1;
-		    tpindex < endpindex; i++, tpindex++) {
-			p = vm_page_alloc(object, tpindex, VM_ALLOC_NORMAL);
-			if (p == NULL)
-				break;
-			bp->b_pages[i] = p;
-		}
+		/*
+		 * Allocate the entire read ahead run in one batch so
+		 * that the free queues are visited once rather than
+		 * once per page.
+		 */
+		startpindex = m[count - 1]->pindex + 1;
+		if (endpindex > startpindex)
+			i += vm_page_alloc_pages_after(object, startpindex,
+			    VM_ALLOC_NORMAL, &bp->b_pages[i],
+			    endpindex - startpindex, m[count - 1]);
 
 		bp->b_pgafter = i - bp->b_npages;
 		bp->b_npages = i;
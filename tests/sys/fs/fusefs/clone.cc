@@ -0,0 +1,163 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2021 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $FreeBSD$
+ */
+
+extern "C" {
+#include <sys/ioctl.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+}
+
+#include "mockfs.hh"
+#include "utils.hh"
+
+using namespace testing;
+
+/* Tests for FUSE_DEV_IOC_CLONE message channels */
+class Clone: public FuseTest {};
+
+/* A fresh /dev/fuse fd can be attached to a session as a second channel */
+TEST_F(Clone, ok)
+{
+	int fd;
+
+	fd = m_mock->clone_fd();
+	ASSERT_LE(0, fd) << strerror(errno);
+	ASSERT_EQ(0, close(fd)) << strerror(errno);
+}
+
+/* A session can have more than one cloned channel */
+TEST_F(Clone, multiple)
+{
+	int fd0, fd1;
+
+	fd0 = m_mock->clone_fd();
+	ASSERT_LE(0, fd0) << strerror(errno);
+	fd1 = m_mock->clone_fd();
+	ASSERT_LE(0, fd1) << strerror(errno);
+	ASSERT_EQ(0, close(fd1)) << strerror(errno);
+	ASSERT_EQ(0, close(fd0)) << strerror(errno);
+}
+
+/* A cloned channel cannot itself serve as the session fd of a clone */
+TEST_F(Clone, of_clone)
+{
+	uint32_t arg;
+	int fd0, fd1;
+
+	fd0 = m_mock->clone_fd();
+	ASSERT_LE(0, fd0) << strerror(errno);
+	fd1 = open("/dev/fuse", O_CLOEXEC | O_RDWR);
+	ASSERT_LE(0, fd1) << strerror(errno);
+	arg = fd0;
+	ASSERT_EQ(-1, ioctl(fd1, FUSE_DEV_IOC_CLONE, &arg));
+	ASSERT_EQ(EINVAL, errno);
+	ASSERT_EQ(0, close(fd1)) << strerror(errno);
+	ASSERT_EQ(0, close(fd0)) << strerror(errno);
+}
+
+static void*
+access_loop(void* arg)
+{
+	const char *fullpath = (const char*)arg;
+	int i;
+
+	for (i = 0; i < 10; i++) {
+		if (access(fullpath, F_OK) != 0)
+			return ((void*)(intptr_t)errno);
+	}
+	return (NULL);
+}
+
+/*
+ * Secondary servicing threads reading from cloned channels can respond to
+ * concurrent operations, even with artificial latency injected.
+ */
+TEST_F(Clone, concurrent)
+{
+	const char FULLPATH[] = "mountpoint/some_file.txt";
+	const char RELPATH[] = "some_file.txt";
+	uint64_t ino = 42;
+	const int nthreads = 4;
+	pthread_t thr[nthreads];
+	void *thr_error;
+	int i;
+
+	m_mock->start_workers(2);
+	m_mock->set_op_latency(FUSE_ACCESS, 1000, 500);
+
+	/*
+	 * The servicing threads race to pick up each thread's lookups and
+	 * accesses, so no exact call counts can be expected.
+	 */
+	EXPECT_LOOKUP(FUSE_ROOT_ID, RELPATH)
+	.Times(AnyNumber())
+	.WillRepeatedly(Invoke(
+		ReturnImmediate([=](auto in __unused, auto& out) {
+		SET_OUT_HEADER_LEN(out, entry);
+		out.body.entry.attr.mode = S_IFREG | 0644;
+		out.body.entry.nodeid = ino;
+		out.body.entry.attr.nlink = 1;
+	})));
+	EXPECT_CALL(*m_mock, process(
+		ResultOf([=](auto in) {
+			return (in.header.opcode == FUSE_ACCESS &&
+				in.header.nodeid == ino);
+		}, Eq(true)),
+		_)
+	).Times(AnyNumber())
+	.WillRepeatedly(Invoke(ReturnErrno(0)));
+
+	for (i = 0; i < nthreads; i++)
+		ASSERT_EQ(0, pthread_create(&thr[i], NULL, access_loop,
+		    __DECONST(void*, FULLPATH))) << strerror(errno);
+	for (i = 0; i < nthreads; i++) {
+		ASSERT_EQ(0, pthread_join(thr[i], &thr_error));
+		ASSERT_EQ(0, (intptr_t)thr_error)
+			<< strerror((int)(intptr_t)thr_error);
+	}
+}
+
+/* An fd that already belongs to a session cannot be attached again */
+TEST_F(Clone, ebusy)
+{
+	uint32_t arg;
+	int fd0, fd1;
+
+	fd0 = m_mock->clone_fd();
+	ASSERT_LE(0, fd0) << strerror(errno);
+	fd1 = open("/dev/fuse", O_CLOEXEC | O_RDWR);
+	ASSERT_LE(0, fd1) << strerror(errno);
+	arg = fd1;
+	ASSERT_EQ(-1, ioctl(fd0, FUSE_DEV_IOC_CLONE, &arg));
+	ASSERT_EQ(EBUSY, errno);
+	ASSERT_EQ(0, close(fd1)) << strerror(errno);
+	ASSERT_EQ(0, close(fd0)) << strerror(errno);
+}
@@ -32,6 +32,7 @@
 
 extern "C" {
 #include <sys/param.h>
+#include <sys/ioctl.h>
 
 #include <sys/mount.h>
 #include <sys/select.h>
@@ -465,6 +466,11 @@ MockFS::~MockFS() {
 		pthread_join(m_daemon_id, NULL);
 		m_daemon_id = NULL;
 	}
+	for (auto w : m_workers) {
+		pthread_join(w->thr, NULL);
+		delete w;
+	}
+	m_workers.clear();
 	::unmount("mountpoint", MNT_FORCE);
 	rmdir("mountpoint");
 	if (m_kq >= 0)
@@ -654,7 +660,7 @@ void MockFS::init(uint32_t flags) {
 	std::unique_ptr<mockfs_buf_in> in(new mockfs_buf_in);
 	std::unique_ptr<mockfs_buf_out> out(new mockfs_buf_out);
 
-	read_request(*in, buflen);
+	read_request(*in, buflen, m_fuse_fd);
 	audit_request(*in, buflen);
 	ASSERT_EQ(FUSE_INIT, in->header.opcode);
 
@@ -676,10 +682,32 @@ void MockFS::init(uint32_t flags) {
 	write(m_fuse_fd, out.get(), out->header.len);
 }
 
+int MockFS::clone_fd() {
+	uint32_t master_fd;
+	int fd;
+
+	fd = open("/dev/fuse", O_CLOEXEC | O_RDWR);
+	if (fd < 0)
+		return (-1);
+	master_fd = m_fuse_fd;
+	if (ioctl(fd, FUSE_DEV_IOC_CLONE, &master_fd) < 0) {
+		close(fd);
+		return (-1);
+	}
+	return (fd);
+}
+
 void MockFS::kill_daemon() {
 	m_quit = true;
 	if (m_daemon_id != NULL)
 		pthread_kill(m_daemon_id, SIGUSR1);
+	for (auto w : m_workers) {
+		pthread_kill(w->thr, SIGUSR1);
+		if (w->fd >= 0) {
+			close(w->fd);
+			w->fd = -1;
+		}
+	}
 	// Closing the /dev/fuse file descriptor first allows unmount to
 	// succeed even if the daemon doesn't correctly respond to commands
 	// during the unmount sequence.
@@ -687,7 +715,7 @@ void MockFS::kill_daemon() {
 	m_fuse_fd = -1;
 }
 
-void MockFS::loop() {
+void MockFS::loop(int fd) {
 	std::vector<std::unique_ptr<mockfs_buf_out>> out;
 
 	std::unique_ptr<mockfs_buf_in> in(new mockfs_buf_in);
@@ -696,7 +724,7 @@ void MockFS::loop() {
 		ssize_t buflen;
 
 		bzero(in.get(), sizeof(*in));
-		read_request(*in, buflen);
+		read_request(*in, buflen, fd);
 		if (m_quit)
 			break;
 		if (verbosity > 0)
@@ -705,7 +733,7 @@ void MockFS::loop() {
 		if (pid_ok((pid_t)in->header.pid)) {
 			process(*in, out);
 		} else {
-			/* 
+			/*
 			 * Reject any requests from unknown processes.  Because
 			 * we actually do mount a filesystem, plenty of
 			 * unrelated system daemons may try to access it.
@@ -715,12 +743,75 @@ void MockFS::loop() {
 					in->header.pid);
 			process_default(*in, out);
 		}
+		if (!out.empty())
+			inject_latency(in->header.opcode);
 		for (auto &it: out)
-			write_response(*it);
+			write_response(*it, fd);
 		out.clear();
 	}
 }
 
+void MockFS::inject_latency(uint32_t opcode) {
+	useconds_t us;
+
+	auto it = m_latencies.find(opcode);
+	if (it == m_latencies.end())
+		return;
+	us = it->second.mean_us;
+	if (it->second.jitter_us > 0) {
+		/*
+		 * Uniform in [mean - jitter, mean + jitter], clamped at 0.
+		 * arc4random is used because it's safe to call from multiple
+		 * servicing threads.
+		 */
+		us += arc4random_uniform(2 * it->second.jitter_us + 1);
+		if (us >= it->second.jitter_us)
+			us -= it->second.jitter_us;
+		else
+			us = 0;
+	}
+	if (us > 0)
+		usleep(us);
+}
+
+void MockFS::set_op_latency(uint32_t opcode, unsigned mean_us,
+	unsigned jitter_us)
+{
+	op_latency lat;
+
+	lat.mean_us = mean_us;
+	lat.jitter_us = jitter_us;
+	m_latencies[opcode] = lat;
+}
+
+void MockFS::start_workers(int nworkers) {
+	int i, r;
+
+	/*
+	 * Workers service their channels with blocking reads.  The kq method
+	 * would share m_kq with the main servicing thread, misdelivering
+	 * events between threads.
+	 */
+	ASSERT_EQ(BLOCKING, m_pm);
+	for (i = 0; i < nworkers; i++) {
+		worker *w = new worker();
+
+		w->mock = this;
+		w->fd = clone_fd();
+		if (w->fd < 0) {
+			delete w;
+			FAIL() << strerror(errno);
+		}
+		r = pthread_create(&w->thr, NULL, worker_service, (void*)w);
+		if (r != 0) {
+			close(w->fd);
+			delete w;
+			FAIL() << strerror(r);
+		}
+		m_workers.push_back(w);
+	}
+}
+
 int MockFS::notify_inval_entry(ino_t parent, const char *name, size_t namelen)
 {
 	std::unique_ptr<mockfs_buf_out> out(new mockfs_buf_out);
@@ -734,7 +825,7 @@ int MockFS::notify_inval_entry(ino_t parent, const char *name, size_t namelen)
 	out->header.len = sizeof(out->header) + sizeof(out->body.inval_entry) +
 		namelen;
 	debug_response(*out);
-	write_response(*out);
+	write_response(*out, m_fuse_fd);
 	return 0;
 }
 
@@ -749,7 +840,7 @@ int MockFS::notify_inval_inode(ino_t ino, off_t off, ssize_t len)
 	out->body.inval_inode.len = len;
 	out->header.len = sizeof(out->header) + sizeof(out->body.inval_inode);
 	debug_response(*out);
-	write_response(*out);
+	write_response(*out, m_fuse_fd);
 	return 0;
 }
 
@@ -765,7 +856,7 @@ int MockFS::notify_store(ino_t ino, off_t off, const void* data, ssize_t size)
 	bcopy(data, (char*)&out->body.bytes + sizeof(out->body.store), size);
 	out->header.len = sizeof(out->header) + sizeof(out->body.store) + size;
 	debug_response(*out);
-	write_response(*out);
+	write_response(*out, m_fuse_fd);
 	return 0;
 }
 
@@ -802,7 +893,7 @@ void MockFS::process_default(const mockfs_buf_in& in,
 	out.push_back(std::move(out0));
 }
 
-void MockFS::read_request(mockfs_buf_in &in, ssize_t &res) {
+void MockFS::read_request(mockfs_buf_in &in, ssize_t &res, int fd) {
 	int nready = 0;
 	fd_set readfds;
 	pollfd fds[1];
@@ -820,7 +911,7 @@ void MockFS::read_request(mockfs_buf_in &in, ssize_t &res) {
 		timeout_ts.tv_sec = 0;
 		timeout_ts.tv_nsec = timeout_ms * 1'000'000;
 		while (nready == 0) {
-			EV_SET(&changes[0], m_fuse_fd, EVFILT_READ, EV_ADD, 0,
+			EV_SET(&changes[0], fd, EVFILT_READ, EV_ADD, 0,
 				0, 0);
 			nready = kevent(m_kq, &changes[0], 1, &events[0], 1,
 				&timeout_ts);
@@ -828,7 +919,7 @@ void MockFS::read_request(mockfs_buf_in &in, ssize_t &res) {
 				return;
 		}
 		ASSERT_LE(0, nready) << strerror(errno);
-		ASSERT_EQ(events[0].ident, (uintptr_t)m_fuse_fd);
+		ASSERT_EQ(events[0].ident, (uintptr_t)fd);
 		if (events[0].flags & EV_ERROR)
 			FAIL() << strerror(events[0].data);
 		else if (events[0].flags & EV_EOF)
@@ -837,7 +928,7 @@ void MockFS::read_request(mockfs_buf_in &in, ssize_t &res) {
 		break;
 	case POLL:
 		timeout_int = timeout_ms;
-		fds[0].fd = m_fuse_fd;
+		fds[0].fd = fd;
 		fds[0].events = POLLIN;
 		while (nready == 0) {
 			nready = poll(fds, 1, timeout_int);
@@ -850,22 +941,22 @@ void MockFS::read_request(mockfs_buf_in &in, ssize_t &res) {
 	case SELECT:
 		timeout_tv.tv_sec = 0;
 		timeout_tv.tv_usec = timeout_ms * 1'000;
-		nfds = m_fuse_fd + 1;
+		nfds = fd + 1;
 		while (nready == 0) {
 			FD_ZERO(&readfds);
-			FD_SET(m_fuse_fd, &readfds);
+			FD_SET(fd, &readfds);
 			nready = select(nfds, &readfds, NULL, NULL,
 				&timeout_tv);
 			if (m_quit)
 				return;
 		}
 		ASSERT_LE(0, nready) << strerror(errno);
-		ASSERT_TRUE(FD_ISSET(m_fuse_fd, &readfds));
+		ASSERT_TRUE(FD_ISSET(fd, &readfds));
 		break;
 	default:
 		FAIL() << "not yet implemented";
 	}
-	res = read(m_fuse_fd, &in, sizeof(in));
+	res = read(fd, &in, sizeof(in));
 
 	if (res < 0 && !m_quit) {
 		m_quit = true;
@@ -880,7 +971,7 @@ void MockFS::read_request(mockfs_buf_in &in, ssize_t &res) {
 	ASSERT_TRUE(res == static_cast<ssize_t>(in.header.len) || m_quit);
 }
 
-void MockFS::write_response(const mockfs_buf_out &out) {
+void MockFS::write_response(const mockfs_buf_out &out, int fd) {
 	fd_set writefds;
 	pollfd fds[1];
 	int nready, nfds;
@@ -891,7 +982,7 @@ void MockFS::write_response(const mockfs_buf_out &out) {
 	case KQ:	/* EVFILT_WRITE is not supported */
 		break;
 	case POLL:
-		fds[0].fd = m_fuse_fd;
+		fds[0].fd = fd;
 		fds[0].events = POLLOUT;
 		nready = poll(fds, 1, INFTIM);
 		ASSERT_LE(0, nready) << strerror(errno);
@@ -900,24 +991,32 @@ void MockFS::write_response(const mockfs_buf_out &out) {
 		break;
 	case SELECT:
 		FD_ZERO(&writefds);
-		FD_SET(m_fuse_fd, &writefds);
-		nfds = m_fuse_fd + 1;
+		FD_SET(fd, &writefds);
+		nfds = fd + 1;
 		nready = select(nfds, NULL, &writefds, NULL, NULL);
 		ASSERT_LE(0, nready) << strerror(errno);
 		ASSERT_EQ(1, nready) << "NULL timeout expired?";
-		ASSERT_TRUE(FD_ISSET(m_fuse_fd, &writefds));
+		ASSERT_TRUE(FD_ISSET(fd, &writefds));
 		break;
 	default:
 		FAIL() << "not yet implemented";
 	}
-	r = write(m_fuse_fd, &out, out.header.len);
+	r = write(fd, &out, out.header.len);
 	ASSERT_TRUE(r > 0 || errno == EAGAIN) << strerror(errno);
 }
 
 void* MockFS::service(void *pthr_data) {
 	MockFS *mock_fs = (MockFS*)pthr_data;
 
-	mock_fs->loop();
+	mock_fs->loop(mock_fs->m_fuse_fd);
+
+	return (NULL);
+}
+
+void* MockFS::worker_service(void *pthr_data) {
+	worker *w = (worker*)pthr_data;
+
+	w->mock->loop(w->fd);
 
 	return (NULL);
 }
@@ -38,6 +38,9 @@ extern "C" {
 #include "fuse_kernel.h"
 }
 
+#include <map>
+#include <vector>
+
 #include <gmock/gmock.h>
 
 #define TIME_T_MAX (std::numeric_limits<time_t>::max())
@@ -283,6 +286,25 @@ class MockFS {
 	/* Timestamp granularity in nanoseconds */
 	unsigned m_time_gran;
 
+	/* A secondary request-servicing thread and its cloned channel */
+	struct worker {
+		pthread_t	thr;
+		int		fd;
+		MockFS		*mock;
+	};
+
+	/* Additional servicing threads created by start_workers() */
+	std::vector<worker*> m_workers;
+
+	/* Artificial response latency for one opcode */
+	struct op_latency {
+		unsigned	mean_us;
+		unsigned	jitter_us;
+	};
+
+	/* Artificial response latencies, indexed by opcode */
+	std::map<uint32_t, op_latency> m_latencies;
+
 	void audit_request(const mockfs_buf_in &in, ssize_t buflen);
 	void debug_request(const mockfs_buf_in&, ssize_t buflen);
 	void debug_response(const mockfs_buf_out&);
@@ -290,6 +312,9 @@ class MockFS {
 	/* Initialize a session after mounting */
 	void init(uint32_t flags);
 
+	/* Sleep for the latency programmed for opcode, if any */
+	void inject_latency(uint32_t opcode);
+
 	/* Is pid from a process that might be involved in the test? */
 	bool pid_ok(pid_t pid);
 
@@ -300,17 +325,21 @@ class MockFS {
 	/* Entry point for the daemon thread */
 	static void* service(void*);
 
+	/* Entry point for the secondary servicing threads */
+	static void* worker_service(void*);
+
 	/*
 	 * Read, but do not process, a single request from the kernel
 	 *
 	 * @param in	Return storage for the FUSE request
 	 * @param res	Return value of read(2).  If positive, the amount of
 	 *		data read from the fuse device.
+	 * @param fd	The /dev/fuse fd to read from
 	 */
-	void read_request(mockfs_buf_in& in, ssize_t& res);
+	void read_request(mockfs_buf_in& in, ssize_t& res, int fd);
 
 	/* Write a single response back to the kernel */
-	void write_response(const mockfs_buf_out &out);
+	void write_response(const mockfs_buf_out &out, int fd);
 
 	public:
 	/* pid of child process, for two-process test cases */
@@ -337,11 +366,48 @@ class MockFS {
 
 	virtual ~MockFS();
 
+	/*
+	 * Open an additional /dev/fuse fd and attach it to this daemon's
+	 * session with FUSE_DEV_IOC_CLONE, creating a second message
+	 * channel.
+	 *
+	 * @return the new fd, or -1 on failure with errno set.
+	 */
+	int clone_fd();
+
 	/* Kill the filesystem daemon without unmounting the filesystem */
 	void kill_daemon();
 
-	/* Process FUSE requests endlessly */
-	void loop();
+	/*
+	 * Process FUSE requests endlessly, reading them from the given
+	 * /dev/fuse fd
+	 */
+	void loop(int fd);
+
+	/*
+	 * Start additional request-servicing threads, each reading from its
+	 * own cloned /dev/fuse fd as created by clone_fd().  Together with
+	 * the main daemon thread this services requests from nworkers + 1
+	 * threads concurrently, which is required to exercise the kernel's
+	 * multichannel dispatch and to keep the harness from becoming the
+	 * bottleneck in throughput tests.
+	 *
+	 * Must be called before issuing any I/O on the mount.
+	 */
+	void start_workers(int nworkers);
+
+	/*
+	 * Inject artificial latency before every response to the given
+	 * opcode.  Each affected response is delayed by a duration drawn
+	 * uniformly from [mean_us - jitter_us, mean_us + jitter_us]
+	 * microseconds, which lets throughput tests model a slow server with
+	 * a controlled service time distribution.
+	 *
+	 * Not synchronized with the servicing threads; set up before issuing
+	 * any I/O on the mount.
+	 */
+	void set_op_latency(uint32_t opcode, unsigned mean_us,
+		unsigned jitter_us);
 
 	/*
 	 * Send an asynchronous notification to invalidate a directory entry.
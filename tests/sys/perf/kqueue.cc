@@ -0,0 +1,102 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/* Benchmarks for the kevent(2) paths in kern_event.c. */
+
+extern "C" {
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+
+#include <unistd.h>
+}
+
+#include "perftest.hh"
+
+class Kqueue : public PerfTest {
+	protected:
+	int m_kq;
+	int m_pipe[2];
+
+	public:
+	void SetUp() override {
+		PerfTest::SetUp();
+		m_kq = kqueue();
+		ASSERT_LE(0, m_kq);
+		ASSERT_EQ(0, pipe(m_pipe));
+	}
+
+	void TearDown() override {
+		close(m_pipe[1]);
+		close(m_pipe[0]);
+		close(m_kq);
+		PerfTest::TearDown();
+	}
+};
+
+/* Knote attach and detach: EV_ADD followed by EV_DELETE. */
+TEST_F(Kqueue, register_deregister)
+{
+	RunBenchmark([&] {
+		struct kevent kev;
+
+		EV_SET(&kev, m_pipe[0], EVFILT_READ, EV_ADD, 0, 0, NULL);
+		ASSERT_EQ(0, kevent(m_kq, &kev, 1, NULL, 0, NULL));
+		EV_SET(&kev, m_pipe[0], EVFILT_READ, EV_DELETE, 0, 0, NULL);
+		ASSERT_EQ(0, kevent(m_kq, &kev, 1, NULL, 0, NULL));
+	});
+}
+
+/* Scan of an empty kqueue with a zero timeout. */
+TEST_F(Kqueue, poll_empty)
+{
+	const struct timespec zero = { 0, 0 };
+
+	RunBenchmark([&] {
+		struct kevent kev;
+
+		ASSERT_EQ(0, kevent(m_kq, NULL, 0, &kev, 1, &zero));
+	});
+}
+
+/* Harvest of a permanently ready event. */
+TEST_F(Kqueue, poll_ready)
+{
+	const struct timespec zero = { 0, 0 };
+	struct kevent kev;
+	char c = 'x';
+
+	EV_SET(&kev, m_pipe[0], EVFILT_READ, EV_ADD, 0, 0, NULL);
+	ASSERT_EQ(0, kevent(m_kq, &kev, 1, NULL, 0, NULL));
+	ASSERT_EQ(1, write(m_pipe[1], &c, 1));
+	RunBenchmark([&] {
+		struct kevent ev;
+
+		ASSERT_EQ(1, kevent(m_kq, NULL, 0, &ev, 1, &zero));
+		ASSERT_EQ((uintptr_t)m_pipe[0], ev.ident);
+	});
+}
@@ -0,0 +1,145 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+extern "C" {
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+}
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "perftest.hh"
+
+/* Batches considered by the steady-state detector. */
+#define	PT_WINDOW	8
+
+static unsigned
+env_unsigned(const char *name, unsigned dflt)
+{
+	const char *val;
+
+	val = getenv(name);
+	if (val == NULL || *val == '\0')
+		return (dflt);
+	return (strtoul(val, NULL, 10));
+}
+
+void
+PerfTest::SetUp()
+{
+	const char *path;
+
+	m_batchsize = env_unsigned("PERFTEST_BATCH", 1024);
+	m_samples = env_unsigned("PERFTEST_SAMPLES", 30);
+	m_warmup_max = env_unsigned("PERFTEST_WARMUP_MAX", 200);
+	m_tolerance = env_unsigned("PERFTEST_TOLERANCE", 5);
+	m_cycles = getenv("PERFTEST_CYCLES") != NULL;
+	path = getenv("PERFTEST_OUTPUT");
+	if (path == NULL || strcmp(path, "-") == 0)
+		m_out = stdout;
+	else
+		m_out = fopen(path, "a");
+	ASSERT_NE(nullptr, m_out) << strerror(errno);
+}
+
+void
+PerfTest::TearDown()
+{
+	if (m_out != NULL && m_out != stdout)
+		fclose(m_out);
+}
+
+uint64_t
+PerfTest::RunBatch(const std::function<void(void)> &body)
+{
+	uint64_t start, end;
+	unsigned i;
+
+	start = m_cycles ? cycles() : nanotime();
+	for (i = 0; i < m_batchsize; i++)
+		body();
+	end = m_cycles ? cycles() : nanotime();
+	return (end - start);
+}
+
+void
+PerfTest::RunBenchmark(const std::function<void(void)> &body)
+{
+	const testing::TestInfo *ti;
+	uint64_t window[PT_WINDOW], lo, hi;
+	std::vector<double> results;
+	unsigned i;
+
+	/*
+	 * Warmup: run until the spread of the last PT_WINDOW batch
+	 * times is within tolerance, so caches, branch predictors and
+	 * lazily allocated kernel state settle before we measure.
+	 */
+	for (i = 0; i < m_warmup_max; i++) {
+		window[i % PT_WINDOW] = RunBatch(body);
+		if (HasFatalFailure())
+			return;
+		if (i + 1 < PT_WINDOW)
+			continue;
+		lo = *std::min_element(window, window + PT_WINDOW);
+		hi = *std::max_element(window, window + PT_WINDOW);
+		if (lo > 0 && (hi - lo) * 100.0 / lo <= m_tolerance)
+			break;
+	}
+
+	ti = testing::UnitTest::GetInstance()->current_test_info();
+	fprintf(m_out, "# %s.%s (%s per call, batch %u, %u warmup batches)\n",
+	    ti->test_case_name(), ti->name(),
+	    m_cycles ? "cycles" : "nanoseconds", m_batchsize, i);
+	for (i = 0; i < m_samples; i++) {
+		results.push_back((double)RunBatch(body) / m_batchsize);
+		if (HasFatalFailure())
+			return;
+		fprintf(m_out, "%.4f\n", results.back());
+		fflush(m_out);
+	}
+
+	std::sort(results.begin(), results.end());
+	RecordProperty("median",
+	    std::to_string(results[results.size() / 2]));
+	if (m_out != stdout)
+		printf("%s.%s: median %.1f %s per call\n",
+		    ti->test_case_name(), ti->name(),
+		    results[results.size() / 2],
+		    m_cycles ? "cycles" : "ns");
+}
+
+int
+main(int argc, char **argv)
+{
+
+	testing::InitGoogleTest(&argc, argv);
+	return (RUN_ALL_TESTS());
+}
@@ -0,0 +1,118 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $FreeBSD$
+ */
+
+extern "C" {
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+}
+
+#include <functional>
+
+#include <gtest/gtest.h>
+
+/* Monotonic time in nanoseconds. */
+static inline uint64_t
+nanotime(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+
+/*
+ * Raw cycle counter, for benchmarks too short for the clock_gettime
+ * resolution.  Falls back to nanoseconds on architectures without a
+ * cheap userland counter.
+ */
+static inline uint64_t
+cycles(void)
+{
+#if defined(__amd64__) || defined(__i386__)
+	uint32_t lo, hi;
+
+	__asm __volatile("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64_t)hi << 32 | lo);
+#elif defined(__aarch64__)
+	uint64_t cnt;
+
+	__asm __volatile("mrs %0, cntvct_el0" : "=r" (cnt));
+	return (cnt);
+#else
+	return (nanotime());
+#endif
+}
+
+/*
+ * Common fixture for syscall-path performance tests.
+ *
+ * A benchmark body is run in timed batches.  Warmup batches are run
+ * until the spread over a sliding window of batch times drops below a
+ * tolerance (steady state) or an iteration limit is reached; the
+ * per-call cost of each subsequent batch is then emitted one value per
+ * line, the format ministat(1) reads, so its stream mode can gate
+ * regressions and stop the producer early.
+ *
+ * Knobs, from the environment:
+ *	PERFTEST_OUTPUT		file the samples are appended to
+ *				("-" or unset: standard output)
+ *	PERFTEST_BATCH		calls per timed batch (1024)
+ *	PERFTEST_SAMPLES	batches emitted in steady state (30)
+ *	PERFTEST_WARMUP_MAX	upper bound on warmup batches (200)
+ *	PERFTEST_TOLERANCE	window spread, in percent, accepted as
+ *				steady state (5)
+ *	PERFTEST_CYCLES		if set, report cycles instead of
+ *				nanoseconds
+ */
+class PerfTest : public ::testing::Test {
+	protected:
+	unsigned m_batchsize;
+	unsigned m_samples;
+	unsigned m_warmup_max;
+	double m_tolerance;
+	bool m_cycles;
+	FILE *m_out;
+
+	public:
+	void SetUp() override;
+	void TearDown() override;
+
+	/*
+	 * Time one batch of the benchmark body, returning the elapsed
+	 * nanoseconds (or cycles, with PERFTEST_CYCLES).
+	 */
+	uint64_t RunBatch(const std::function<void(void)> &body);
+
+	/*
+	 * Warm the benchmark body up to steady state, then emit the
+	 * per-call cost of the configured number of batches.
+	 */
+	void RunBenchmark(const std::function<void(void)> &body);
+};
@@ -0,0 +1,80 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/* Benchmarks for the pipe read and write paths in sys_pipe.c. */
+
+extern "C" {
+#include <sys/types.h>
+
+#include <unistd.h>
+}
+
+#include "perftest.hh"
+
+class Pipe : public PerfTest {
+	protected:
+	int m_pipe[2];
+
+	public:
+	void SetUp() override {
+		PerfTest::SetUp();
+		ASSERT_EQ(0, pipe(m_pipe));
+	}
+
+	void TearDown() override {
+		close(m_pipe[1]);
+		close(m_pipe[0]);
+		PerfTest::TearDown();
+	}
+};
+
+/* Single-byte write followed by the matching read. */
+TEST_F(Pipe, ping_pong_1)
+{
+	RunBenchmark([&] {
+		char c = 'x';
+
+		ASSERT_EQ(1, write(m_pipe[1], &c, 1));
+		ASSERT_EQ(1, read(m_pipe[0], &c, 1));
+	});
+}
+
+/*
+ * 8k transfer; large enough to exercise the buffer copy but well
+ * within the pipe buffer, so neither side ever blocks.
+ */
+TEST_F(Pipe, ping_pong_8k)
+{
+	static char buf[8192];
+
+	RunBenchmark([&] {
+		ASSERT_EQ((ssize_t)sizeof(buf),
+		    write(m_pipe[1], buf, sizeof(buf)));
+		ASSERT_EQ((ssize_t)sizeof(buf),
+		    read(m_pipe[0], buf, sizeof(buf)));
+	});
+}
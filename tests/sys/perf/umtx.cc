@@ -0,0 +1,108 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/* Benchmarks for the umtx wake paths in kern_umtx.c. */
+
+extern "C" {
+#include <sys/types.h>
+#include <sys/umtx.h>
+}
+
+#include <atomic>
+#include <thread>
+
+#include "perftest.hh"
+
+class Umtx : public PerfTest {
+	protected:
+	std::atomic<uint32_t> m_word;
+
+	/* Sleep while *f == expected, as pthreads and libc do. */
+	static void futex_wait(std::atomic<uint32_t> *f, uint32_t expected) {
+		while (f->load() == expected)
+			_umtx_op(f, UMTX_OP_WAIT_UINT_PRIVATE, expected,
+			    NULL, NULL);
+	}
+
+	public:
+	void SetUp() override {
+		PerfTest::SetUp();
+		m_word.store(0);
+	}
+};
+
+/* Wakeup of an uncontested word: the queue lookup finds no waiters. */
+TEST_F(Umtx, wake_no_waiters)
+{
+	RunBenchmark([&] {
+		ASSERT_EQ(0, _umtx_op(&m_word, UMTX_OP_WAKE_PRIVATE, 1,
+		    NULL, NULL));
+	});
+}
+
+/* Wait on a word whose value already changed: no sleep, early return. */
+TEST_F(Umtx, wait_stale_value)
+{
+	m_word.store(1);
+	RunBenchmark([&] {
+		ASSERT_EQ(0, _umtx_op(&m_word, UMTX_OP_WAIT_UINT_PRIVATE, 0,
+		    NULL, NULL));
+	});
+}
+
+/*
+ * Round trip through a sleeping waiter: each iteration wakes the
+ * partner thread and sleeps until woken back, covering the full
+ * enqueue, wakeup and context switch path in both directions.
+ */
+TEST_F(Umtx, wake_waiter_round_trip)
+{
+	std::atomic<uint32_t> ping(0), pong(0);
+	std::atomic<bool> stop(false);
+
+	std::thread partner([&] {
+		for (;;) {
+			futex_wait(&ping, 0);
+			ping.store(0);
+			if (stop.load())
+				break;
+			pong.store(1);
+			_umtx_op(&pong, UMTX_OP_WAKE_PRIVATE, 1, NULL, NULL);
+		}
+	});
+	RunBenchmark([&] {
+		ping.store(1);
+		ASSERT_EQ(0, _umtx_op(&ping, UMTX_OP_WAKE_PRIVATE, 1,
+		    NULL, NULL));
+		futex_wait(&pong, 0);
+		pong.store(0);
+	});
+	stop.store(true);
+	ping.store(1);
+	_umtx_op(&ping, UMTX_OP_WAKE_PRIVATE, 1, NULL, NULL);
+	partner.join();
+}
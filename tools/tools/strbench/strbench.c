@@ -0,0 +1,210 @@
+/*-
+ * SPDX-License-Identifier: BSD-2-Clause-FreeBSD
+ *
+ * Copyright (c) 2020 The FreeBSD Foundation
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Microbenchmark for libc string and memory routines.  Each routine is
+ * run over a sweep of buffer sizes for a fixed wall-clock interval and
+ * the achieved throughput is reported, so that changes to the libc
+ * implementations (e.g. the ifunc-dispatched amd64 variants) can be
+ * compared run over run.
+ */
+
+#include <sys/cdefs.h>
+__FBSDID("$FreeBSD$");
+
+#include <sys/param.h>
+
+#include <err.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define	BUFSIZE		(16 * 1024 * 1024)
+#define	DURATION_NS	200000000ULL	/* per size and function */
+
+static char *src, *dst;
+
+static const size_t sizes[] = {
+	8, 16, 32, 64, 128, 256, 512,
+	1024, 4096, 16384, 65536, 262144, 1048576,
+};
+
+static uint64_t
+nanotime(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+		err(1, "clock_gettime");
+	return ((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+typedef void bench_fn(size_t);
+
+static void
+bench_memcpy(size_t size)
+{
+
+	memcpy(dst, src, size);
+}
+
+static void
+bench_memmove(size_t size)
+{
+
+	memmove(dst, dst + size / 2, size);
+}
+
+static void
+bench_memset(size_t size)
+{
+
+	memset(dst, 0xa5, size);
+}
+
+static void
+bench_strlen(size_t size __unused)
+{
+	static volatile size_t sink;
+
+	sink = strlen(src);
+	(void)sink;
+}
+
+static void
+bench_strcmp(size_t size __unused)
+{
+	static volatile int sink;
+
+	sink = strcmp(src, dst);
+	(void)sink;
+}
+
+static const struct {
+	const char *name;
+	bench_fn *fn;
+	int is_str;	/* operates on a nul-terminated buffer */
+} benchmarks[] = {
+	{ "memcpy", bench_memcpy, 0 },
+	{ "memmove", bench_memmove, 0 },
+	{ "memset", bench_memset, 0 },
+	{ "strlen", bench_strlen, 1 },
+	{ "strcmp", bench_strcmp, 1 },
+};
+
+static void
+bench_one(const char *name, bench_fn *fn, int is_str, size_t size)
+{
+	uint64_t deadline, elapsed, iters, start;
+
+	if (is_str) {
+		memset(src, 'x', size - 1);
+		src[size - 1] = '\0';
+		memset(dst, 'x', size - 1);
+		dst[size - 1] = '\0';
+	}
+
+	/* Warm up caches and the ifunc-resolved entry. */
+	fn(size);
+
+	iters = 0;
+	start = nanotime();
+	deadline = start + DURATION_NS;
+	do {
+		fn(size);
+		fn(size);
+		fn(size);
+		fn(size);
+		iters += 4;
+		elapsed = nanotime();
+	} while (elapsed < deadline);
+	elapsed -= start;
+
+	printf("%-10s %9zu %12ju %10.1f %10.2f\n", name, size,
+	    (uintmax_t)iters, (double)elapsed / iters,
+	    (double)size * iters * 1000.0 / elapsed);
+}
+
+static void
+usage(void)
+{
+
+	fprintf(stderr, "usage: strbench [-f function]\n");
+	exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *only;
+	u_int i, j;
+	int ch, matched;
+
+	only = NULL;
+	while ((ch = getopt(argc, argv, "f:")) != -1) {
+		switch (ch) {
+		case 'f':
+			only = optarg;
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+	argv += optind;
+	if (argc != 0)
+		usage();
+
+	src = malloc(BUFSIZE);
+	dst = malloc(BUFSIZE);
+	if (src == NULL || dst == NULL)
+		err(1, "malloc");
+	for (i = 0; i < BUFSIZE; i++)
+		src[i] = 'a' + i % 26;
+	memset(dst, 0, BUFSIZE);
+
+	printf("%-10s %9s %12s %10s %10s\n", "function", "size", "iters",
+	    "ns/op", "MB/s");
+	matched = 0;
+	for (i = 0; i < nitems(benchmarks); i++) {
+		if (only != NULL && strcmp(only, benchmarks[i].name) != 0)
+			continue;
+		matched = 1;
+		for (j = 0; j < nitems(sizes); j++)
+			bench_one(benchmarks[i].name, benchmarks[i].fn,
+			    benchmarks[i].is_str, sizes[j]);
+	}
+	if (!matched)
+		errx(1, "unknown function: %s", only);
+
+	free(src);
+	free(dst);
+	return (0);
+}
@@ -33,6 +33,10 @@
  */
 
 #include "checking.hh"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <stdio.h>
 
 using std::string;
@@ -46,6 +50,12 @@ namespace checking
 
 namespace
 {
+	/**
+	 * Lock serialising error reports.  Checkers may run concurrently, and
+	 * each report is built from several writes to stderr, so reports from
+	 * different checkers must not interleave.
+	 */
+	std::mutex error_lock;
 	struct deleted_node_checker : public checker
 	{
 		deleted_node_checker(const char *name) : checker(name) {}
@@ -148,6 +158,7 @@ checker::visit_node(device_tree *tree, const node_ptr &n)
 void
 checker::report_error(const char *errmsg)
 {
+	std::lock_guard<std::mutex> lock(error_lock);
 	fprintf(stderr, "Error: %s, while checking node: ", errmsg);
 	for (auto &p : path)
 	{
@@ -240,14 +251,67 @@ check_manager::check_manager()
 bool
 check_manager::run_checks(device_tree *tree, bool keep_going)
 {
-	bool success = true;
+	std::vector<checker*> enabled;
+	enabled.reserve(checkers.size());
 	for (auto &i : checkers)
 	{
-		success &= i.second->check_tree(tree);
-		if (!(success || keep_going))
+		enabled.push_back(i.second);
+	}
+	unsigned int thread_count = std::thread::hardware_concurrency();
+	if (thread_count > enabled.size())
+	{
+		thread_count = enabled.size();
+	}
+	// Each checker carries its own traversal state and the tree is
+	// immutable during checking, so distinct checkers can walk the tree
+	// concurrently.  Fall back to the serial loop when there is nothing
+	// to be gained from spawning threads.
+	if (thread_count < 2)
+	{
+		bool success = true;
+		for (auto *c : enabled)
+		{
+			success &= c->check_tree(tree);
+			if (!(success || keep_going))
+			{
+				break;
+			}
+		}
+		return success;
+	}
+	std::atomic<bool> success(true);
+	std::atomic<size_t> next(0);
+	auto worker = [&]()
+	{
+		for (;;)
 		{
-			break;
+			// Stop claiming new checkers once one has failed,
+			// unless we were asked to keep going.  Checkers that
+			// are already running are allowed to finish.
+			if (!(success || keep_going))
+			{
+				return;
+			}
+			size_t i = next++;
+			if (i >= enabled.size())
+			{
+				return;
+			}
+			if (!enabled[i]->check_tree(tree))
+			{
+				success = false;
+			}
 		}
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count);
+	for (unsigned int i=0 ; i<thread_count ; ++i)
+	{
+		threads.emplace_back(worker);
+	}
+	for (auto &t : threads)
+	{
+		t.join();
 	}
 	return success;
 }
@@ -112,6 +112,12 @@ binary_writer::write_data(uint64_t v)
 	push_big_endian(buffer, v);
 }
 
+void
+binary_writer::write_data(byte_buffer b)
+{
+	buffer.insert(buffer.end(), b.begin(), b.end());
+}
+
 void
 binary_writer::write_to_file(int fd)
 {
@@ -124,6 +130,12 @@ binary_writer::size()
 	return buffer.size();
 }
 
+void
+binary_writer::reserve(size_t s)
+{
+	buffer.reserve(buffer.size() + s);
+}
+
 void
 asm_writer::write_line(const char *c)
 {
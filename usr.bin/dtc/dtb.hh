@@ -34,8 +34,8 @@
 
 #ifndef _DTB_HH_
 #define _DTB_HH_
-#include <map>
 #include <string>
+#include <unordered_map>
 
 #include <assert.h>
 
@@ -160,6 +160,12 @@ struct output_writer
 	 * Returns the number of bytes.
 	 */
 	virtual uint32_t size()                 = 0;
+	/**
+	 * Hint that at least size more bytes of binary output will be
+	 * written, allowing the writer to allocate its buffer up front.
+	 * Writers for which the hint is not useful may ignore it.
+	 */
+	virtual void reserve(size_t) {}
 	/**
 	 * Helper for writing tokens to the output stream.  This writes a
 	 * comment above the token describing its value, for easier debugging
@@ -171,10 +177,11 @@ struct output_writer
 		write_data((uint32_t)t);
 	}
 	/**
-	 * Helper function that writes a byte buffer to the output, one byte at
-	 * a time.
+	 * Writes a byte buffer to the output.  The default implementation
+	 * writes one byte at a time; writers with a binary internal buffer
+	 * override this to copy the whole buffer in one operation.
 	 */
-	void write_data(byte_buffer b);
+	virtual void write_data(byte_buffer b);
 };
 
 /**
@@ -202,8 +209,10 @@ class binary_writer : public output_writer
 	void write_data(uint8_t v) override;
 	void write_data(uint32_t v) override;
 	void write_data(uint64_t v) override;
+	void write_data(byte_buffer b) override;
 	void write_to_file(int fd) override;
 	uint32_t size() override;
+	void reserve(size_t s) override;
 };
 /**
  * Assembly writer.  This class is responsible for writing the output in an
@@ -336,9 +345,10 @@ struct header
  */
 class string_table {
 	/**
-	 * Map from strings to their offset. 
+	 * Map from strings to their offset.  Hashed so that deduplicating
+	 * each property name is a constant-time operation.
 	 */
-	std::map<std::string, uint32_t> string_offsets;
+	std::unordered_map<std::string, uint32_t> string_offsets;
 	/**
 	 * The strings, in the order in which they should be written to the
 	 * output.  The order must be stable - adding another string must not
@@ -362,6 +372,14 @@ class string_table {
 	 * offset.
 	 */
 	uint32_t add_string(const std::string &str);
+	/**
+	 * Returns the current size of the table in bytes, including the
+	 * trailing nul of every string added so far.
+	 */
+	uint32_t byte_size() const
+	{
+		return size;
+	}
 	/**
 	 * Writes the strings table to the specified output.
 	 */
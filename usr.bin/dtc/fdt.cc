@@ -60,6 +60,47 @@ namespace dtc
 namespace fdt
 {
 
+namespace
+{
+
+/**
+ * The arena backing all node and property allocations.  Constructed on
+ * first use and torn down, along with every tree allocated from it, at
+ * process exit.
+ */
+arena &
+tree_arena()
+{
+	static arena tree_arena;
+	return tree_arena;
+}
+
+} // anonymous namespace
+
+void *
+property::operator new(std::size_t size)
+{
+	return tree_arena().allocate(size);
+}
+
+void
+property::operator delete(void *)
+{
+	// Reclaimed in bulk when the arena is destroyed.
+}
+
+void *
+node::operator new(std::size_t size)
+{
+	return tree_arena().allocate(size);
+}
+
+void
+node::operator delete(void *)
+{
+	// Reclaimed in bulk when the arena is destroyed.
+}
+
 uint32_t
 property_value::get_as_uint32()
 {
@@ -612,6 +653,19 @@ property::write(dtb::output_writer &writer, dtb::string_table &strings)
 	writer.write_data(value_buffer);
 }
 
+size_t
+property::size_in_blob()
+{
+	size_t value_size = 0;
+	for (value_iterator i=begin(), e=end() ; i!=e ; ++i)
+	{
+		value_size += i->size_in_blob();
+	}
+	// FDT_PROP token, value length, and name offset, then the value
+	// padded to a 4-byte boundary.
+	return 12 + ((value_size + 3) & ~(size_t)3);
+}
+
 bool
 property_value::try_to_merge(property_value &other)
 {
@@ -1152,6 +1206,29 @@ node::write(dtb::output_writer &writer, dtb::string_table &strings)
 	writer.write_token(dtb::FDT_END_NODE);
 }
 
+size_t
+node::size_in_blob()
+{
+	// Name, optional @unit-address, and the trailing nul, padded to a
+	// 4-byte boundary.
+	size_t name_size = name.size() + 1;
+	if (unit_address != string())
+	{
+		name_size += unit_address.size() + 1;
+	}
+	// FDT_BEGIN_NODE and FDT_END_NODE tokens.
+	size_t total = 8 + ((name_size + 3) & ~(size_t)3);
+	for (auto p : properties())
+	{
+		total += p->size_in_blob();
+	}
+	for (auto &c : child_nodes())
+	{
+		total += c->size_in_blob();
+	}
+	return total;
+}
+
 void
 node::write_dts(FILE *file, int indent)
 {
@@ -1657,6 +1734,8 @@ device_tree::write(int fd)
 	writer strings_writer;
 
 	// Build the reservation table
+	reservation_writer.reserve(
+		(reservations.size() + spare_reserve_map_entries + 1) * 16);
 	reservation_writer.write_comment(string("Memory reservations"));
 	reservation_writer.write_label(string("dt_reserve_map"));
 	for (auto &i : reservations)
@@ -1674,12 +1753,18 @@ device_tree::write(int fd)
 	}
 
 
+	// Presize the structure table buffer so that serialisation is a
+	// single linear pass with no reallocation.  The size pass gives an
+	// upper bound, so the reservation may overshoot slightly for
+	// string values containing escape sequences.
+	struct_writer.reserve(root->size_in_blob() + 4);
 	struct_writer.write_comment(string("Device tree"));
 	struct_writer.write_label(string("dt_struct_start"));
 	root->write(struct_writer, st);
 	struct_writer.write_token(dtb::FDT_END);
 	struct_writer.write_label(string("dt_struct_end"));
 
+	strings_writer.reserve(st.byte_size() + blob_padding);
 	st.write(strings_writer);
 	// Find the strings size before we stick padding on the end.
 	// Note: We should possibly use a new writer for the padding.
@@ -1876,7 +1961,7 @@ device_tree::create_fragment_wrapper(node_ptr &node, int &fragnum)
 		propname = "target-path";
 		v.type = property_value::STRING;
 	}
-	auto prop = std::make_shared<property>(std::string(propname));
+	property_ptr prop(new property(std::string(propname)));
 	prop->add_value(v);
 	symbols.push_back(prop);
 
@@ -2049,7 +2134,7 @@ device_tree::parse_dts(const string &fn, FILE *depfile)
 			v.string_data = s.second.to_string();
 			v.type = property_value::STRING;
 			string name = s.first;
-			auto prop = std::make_shared<property>(std::move(name));
+			property_ptr prop(new property(std::move(name)));
 			prop->add_value(v);
 			symbols.push_back(prop);
 		}
@@ -2074,7 +2159,7 @@ device_tree::parse_dts(const string &fn, FILE *depfile)
 				property_value v;
 				v.string_data = value;
 				v.type = property_value::STRING;
-				auto prop = std::make_shared<property>(std::move(target));
+				property_ptr prop(new property(std::move(target)));
 				prop->add_value(v);
 				return prop;
 			};
@@ -2153,7 +2238,7 @@ device_tree::parse_dts(const string &fn, FILE *depfile)
 			// use this property value
 			if (!prop)
 			{
-				prop = std::make_shared<property>(std::move(key));
+				prop = property_ptr(new property(std::move(key)));
 				n->add_property(prop);
 				prop->add_value(pv);
 			}
@@ -207,6 +207,21 @@ struct property_value
 	 * Writes the data for this value into an output buffer.
 	 */
 	void push_to_buffer(byte_buffer &buffer);
+	/**
+	 * Returns an upper bound on the number of bytes that
+	 * push_to_buffer() will emit for this value.  The bound is exact
+	 * except for strings containing escape sequences, which shrink
+	 * when decoded.
+	 */
+	size_t size_in_blob()
+	{
+		if (!byte_data.empty())
+		{
+			return byte_data.size();
+		}
+		// String plus trailing nul.
+		return string_data.size() + 1;
+	}
 
 	/**
 	 * Writes the property value to the standard output.  This uses the
@@ -325,6 +340,13 @@ class property
 	         bool terminated,
 	         define_map *defines);
 	public:
+	/**
+	 * Properties are allocated from a tree-lifetime arena rather than
+	 * the general-purpose heap; deallocation is a no-op and the memory
+	 * is reclaimed in bulk when the program exits.
+	 */
+	void *operator new(std::size_t size);
+	void operator delete(void *ptr);
 	/**
 	 * Creates an empty property.
 	 */
@@ -389,6 +411,12 @@ class property
 	 * reference into the strings table.
 	 */
 	void write(dtb::output_writer &writer, dtb::string_table &strings);
+	/**
+	 * Returns an upper bound on the size of this property in the blob's
+	 * structure table, including the FDT_PROP token, the length and
+	 * name-offset words, and the padded value.
+	 */
+	size_t size_in_blob();
 	/**
 	 * Writes in DTS format to the specified file, at the given indent
 	 * level.  This will begin the line with the number of tabs specified
@@ -409,6 +437,13 @@ class property
 class node
 {
 	public:
+	/**
+	 * Nodes, like properties, are allocated from a tree-lifetime
+	 * arena; deallocation is a no-op and the memory is reclaimed in
+	 * bulk when the program exits.
+	 */
+	void *operator new(std::size_t size);
+	void operator delete(void *ptr);
 	/**
 	 * The labels for this node, if any.  Node labels are used as the
 	 * targets for cross references.
@@ -681,6 +716,12 @@ class node
 	 * properties within this node and its children.
 	 */
 	void write(dtb::output_writer &writer, dtb::string_table &strings);
+	/**
+	 * Returns an upper bound on the size of this node and all of its
+	 * children in the blob's structure table.  Used to presize output
+	 * buffers before serialisation.
+	 */
+	size_t size_in_blob();
 	/**
 	 * Writes the current node as DTS to the specified file.  The second
 	 * parameter is the indent level.  This function will start every line
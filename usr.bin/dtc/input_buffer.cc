@@ -84,8 +84,7 @@ struct mmap_input_buffer : public dtc::input_buffer
 /**
  * Input buffer read from standard input.  This is used for reading device tree
  * blobs and source from standard input.  It reads the entire input into
- * malloc'd memory, so will be very slow for large inputs.  DTS and DTB files
- * are very rarely more than 10KB though, so this is probably not a problem.
+ * malloc'd memory in page-sized chunks.
  */
 struct stream_input_buffer : public dtc::input_buffer
 {
@@ -120,6 +119,9 @@ mmap_input_buffer::mmap_input_buffer(int fd, string &&filename)
 		perror("Failed to mmap file");
 		exit(EXIT_FAILURE);
 	}
+	// The parser makes a single forward pass over the input, so let
+	// the VM system read ahead aggressively and discard behind us.
+	posix_madvise(const_cast<char*>(buffer), size, POSIX_MADV_SEQUENTIAL);
 }
 
 mmap_input_buffer::~mmap_input_buffer()
@@ -132,10 +134,11 @@ mmap_input_buffer::~mmap_input_buffer()
 
 stream_input_buffer::stream_input_buffer() : input_buffer(0, 0)
 {
-	int c;
-	while ((c = fgetc(stdin)) != EOF)
+	char chunk[8192];
+	size_t bytes;
+	while ((bytes = fread(chunk, 1, sizeof(chunk), stdin)) > 0)
 	{
-		b.push_back(c);
+		b.insert(b.end(), chunk, chunk + bytes);
 	}
 	buffer = b.data();
 	size = b.size();
@@ -1158,12 +1161,12 @@ struct is_property_name_character
 template<class T>
 string parse(text_input_buffer &s)
 {
-	std::vector<char> bytes;
+	string bytes;
 	for (char c=*s ; T::check(c) ; c=*(++s))
 	{
 		bytes.push_back(c);
 	}
-	return string(bytes.begin(), bytes.end());
+	return bytes;
 }
 
 }
@@ -1187,7 +1190,7 @@ text_input_buffer::parse_node_or_property_name(bool &is_property)
 	{
 		return parse_property_name();
 	}
-	std::vector<char> bytes;
+	string bytes;
 	for (char c=*(*this) ; is_node_name_character::check(c) ; c=*(++(*this)))
 	{
 		bytes.push_back(c);
@@ -1197,24 +1200,26 @@ text_input_buffer::parse_node_or_property_name(bool &is_property)
 		bytes.push_back(c);
 		is_property = true;
 	}
-	return string(bytes.begin(), bytes.end());
+	return bytes;
 }
 
 string
 input_buffer::parse_to(char stop)
 {
-	std::vector<char> bytes;
-	for (char c=*(*this) ; c != stop ; c=*(++(*this)))
+	int start = cursor;
+	while ((cursor < size) && (buffer[cursor] != stop))
 	{
-		bytes.push_back(c);
+		cursor++;
 	}
-	return string(bytes.begin(), bytes.end());
+	// The backing buffer is contiguous (and usually mmap'd), so the
+	// result can be built with a single copy out of it.
+	return string(buffer + start, cursor - start);
 }
 
 string
 text_input_buffer::parse_to(char stop)
 {
-	std::vector<char> bytes;
+	string bytes;
 	for (char c=*(*this) ; c != stop ; c=*(++(*this)))
 	{
 		if (finished())
@@ -1223,7 +1228,7 @@ text_input_buffer::parse_to(char stop)
 		}
 		bytes.push_back(c);
 	}
-	return string(bytes.begin(), bytes.end());
+	return bytes;
 }
 
 char
@@ -35,6 +35,7 @@
 #ifndef _UTIL_HH_
 #define _UTIL_HH_
 
+#include <cstddef>
 #include <memory>
 #include <stdint.h>
 #include <string>
@@ -89,6 +90,51 @@ namespace dtc {
  */
 typedef std::vector<uint8_t> byte_buffer;
 
+/**
+ * Simple monotonic arena allocator.  Objects are carved out of large
+ * chunks with a bump of a pointer and are never individually freed; all
+ * memory is returned when the arena is destroyed.  This suits the node
+ * and property trees, which are built incrementally while parsing and
+ * then live until the program exits.
+ */
+class arena
+{
+	/** Size of each chunk carved up by the allocator. */
+	static const std::size_t chunk_size = 1 << 20;
+	/** The chunks owned by this arena. */
+	std::vector<std::unique_ptr<char[]>> chunks;
+	/** The chunk currently being carved up, or null. */
+	char *current = nullptr;
+	/** Offset of the first free byte in the current chunk. */
+	std::size_t offset = 0;
+	public:
+	/**
+	 * Allocate size bytes from the arena, with the alignment of
+	 * max_align_t.
+	 */
+	void *allocate(std::size_t size)
+	{
+		size = (size + alignof(std::max_align_t) - 1) &
+			~(alignof(std::max_align_t) - 1);
+		if (size > chunk_size)
+		{
+			// Give oversized requests a dedicated chunk and
+			// keep carving up the current one.
+			chunks.emplace_back(new char[size]);
+			return chunks.back().get();
+		}
+		if (current == nullptr || offset + size > chunk_size)
+		{
+			chunks.emplace_back(new char[chunk_size]);
+			current = chunks.back().get();
+			offset = 0;
+		}
+		void *allocation = current + offset;
+		offset += size;
+		return allocation;
+	}
+};
+
 /**
  * Helper function to push a big endian value into a byte buffer.  We use
  * native-endian values for all of the in-memory data structures and only
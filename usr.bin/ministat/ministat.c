@@ -157,14 +157,13 @@ NewSet(void)
 	ds->lpoints = 100000;
 	ds->points = calloc(sizeof *ds->points, ds->lpoints);
 	assert(ds->points != NULL);
-	ds->syy = NAN;
 	return(ds);
 }
 
 static void
 AddPoint(struct dataset *ds, double a)
 {
-	double *dp;
+	double *dp, d;
 
 	if (ds->n >= ds->lpoints) {
 		dp = ds->points;
@@ -174,8 +173,18 @@ AddPoint(struct dataset *ds, double a)
 		memcpy(ds->points, dp, sizeof *dp * ds->n);
 		free(dp);
 	}
+	/*
+	 * Maintain the sum of squared deviations incrementally
+	 * (Welford's method), so the variance is available after
+	 * every point in stream mode without a pass over the data.
+	 */
+	if (ds->n > 0)
+		d = a - ds->sy / ds->n;
+	else
+		d = 0.0;
 	ds->points[ds->n++] = a;
 	ds->sy += a;
+	ds->syy += d * (a - ds->sy / ds->n);
 }
 
 static double
@@ -212,14 +221,6 @@ Median(const struct dataset *ds)
 static double
 Var(struct dataset *ds)
 {
-	size_t z;
-	const double a = Avg(ds);
-
-	if (isnan(ds->syy)) {
-		ds->syy = 0.0;
-		for (z = 0; z < ds->n; z++)
-			ds->syy += (ds->points[z] - a) * (ds->points[z] - a);
-	}
 
 	return (ds->syy / (ds->n - 1.0));
 }
@@ -247,6 +248,32 @@ Vitals(struct dataset *ds, int flag)
 	printf("\n");
 }
 
+/*
+ * Student's t test on two datasets: set *dp to the difference of the
+ * averages and *ep to the half-width of its confidence interval, and
+ * return non-zero if the difference is statistically significant.
+ */
+static int
+Significant(struct dataset *ds, struct dataset *rs, int confidx, double *dp,
+    double *ep)
+{
+	double spool, s, t;
+	size_t z;
+
+	z = ds->n + rs->n - 2;
+	if (z > NSTUDENT)
+		t = student[0][confidx];
+	else
+		t = student[z][confidx];
+	spool = (ds->n - 1) * Var(ds) + (rs->n - 1) * Var(rs);
+	spool /= ds->n + rs->n - 2;
+	spool = sqrt(spool);
+	s = spool * sqrt(1.0 / ds->n + 1.0 / rs->n);
+	*dp = Avg(ds) - Avg(rs);
+	*ep = t * s;
+	return (fabs(*dp) > *ep);
+}
+
 static void
 Relative(struct dataset *ds, struct dataset *rs, int confidx)
 {
@@ -483,21 +510,19 @@ dbl_cmp(const void *a, const void *b)
 		return (0);
 }
 
-static struct dataset *
-ReadSet(FILE *f, const char *n, int column, const char *delim)
+/*
+ * Read the next data point from a stream, skipping comments and lines
+ * without data.  Returns zero at end of file.
+ */
+static int
+ReadPoint(FILE *f, const char *n, int *line, int column, const char *delim,
+    double *dp)
 {
 	char buf[BUFSIZ], *p, *t;
-	struct dataset *s;
-	double d;
-	int line;
 	int i;
 
-	s = NewSet();
-	s->name = strdup(n);
-	assert(s->name != NULL);
-	line = 0;
 	while (fgets(buf, sizeof buf, f) != NULL) {
-		line++;
+		(*line)++;
 
 		i = strlen(buf);
 		while (i > 0 && isspace(buf[i - 1]))
@@ -511,12 +536,28 @@ ReadSet(FILE *f, const char *n, int column, const char *delim)
 		if (t == NULL || *t == '#')
 			continue;
 
-		d = strtod(t, &p);
+		*dp = strtod(t, &p);
 		if (p != NULL && *p != '\0')
-			errx(2, "Invalid data on line %d in %s", line, n);
+			errx(2, "Invalid data on line %d in %s", *line, n);
 		if (*buf != '\0')
-			AddPoint(s, d);
+			return (1);
 	}
+	return (0);
+}
+
+static struct dataset *
+ReadSet(FILE *f, const char *n, int column, const char *delim)
+{
+	struct dataset *s;
+	double d;
+	int line;
+
+	s = NewSet();
+	s->name = strdup(n);
+	assert(s->name != NULL);
+	line = 0;
+	while (ReadPoint(f, n, &line, column, delim, &d))
+		AddPoint(s, d);
 	if (s->n < 3) {
 		fprintf(stderr,
 		    "Dataset %s must contain at least 3 data points\n", n);
@@ -533,7 +574,7 @@ usage(char const *whine)
 
 	fprintf(stderr, "%s\n", whine);
 	fprintf(stderr,
-	    "Usage: ministat [-C column] [-c confidence] [-d delimiter(s)] [-Ans] [-w width] [file [file ...]]\n");
+	    "Usage: ministat [-C column] [-c confidence] [-d delimiter(s)] [-AnSs] [-t threshold] [-w width] [file [file ...]]\n");
 	fprintf(stderr, "\tconfidence = {");
 	for (i = 0; i < NCONF; i++) {
 		fprintf(stderr, "%s%g%%",
@@ -545,7 +586,9 @@ usage(char const *whine)
 	fprintf(stderr, "\t-C : column number to extract (starts and defaults to 1)\n");
 	fprintf(stderr, "\t-d : delimiter(s) string, default to \" \\t\"\n");
 	fprintf(stderr, "\t-n : print summary statistics only, no graph/test\n");
+	fprintf(stderr, "\t-S : stream mode, read two datasets incrementally and stop at significance\n");
 	fprintf(stderr, "\t-s : print avg/median/stddev bars on separate lines\n");
+	fprintf(stderr, "\t-t : exit 1 if the last dataset regresses by more than this percentage\n");
 	fprintf(stderr, "\t-w : width of graph/test output (default 74 or terminal width)\n");
 	exit (2);
 }
@@ -557,15 +600,18 @@ main(int argc, char **argv)
 	struct dataset *ds[MAX_DS - 1];
 	FILE *setfiles[MAX_DS - 1];
 	int nds;
-	double a;
+	double a, d, e;
+	double threshold = NAN;
 	const char *delim = " \t";
 	char *p;
 	int c, i, ci;
 	int column = 1;
 	int flag_s = 0;
 	int flag_n = 0;
+	int flag_stream = 0;
 	int termwidth = 74;
 	int suppress_plot = 0;
+	int regression = 0;
 
 	if (isatty(STDOUT_FILENO)) {
 		struct winsize wsz;
@@ -578,7 +624,7 @@ main(int argc, char **argv)
 	}
 
 	ci = -1;
-	while ((c = getopt(argc, argv, "AC:c:d:snw:")) != -1)
+	while ((c = getopt(argc, argv, "AC:c:d:Snst:w:")) != -1)
 		switch (c) {
 		case 'A':
 			suppress_plot = 1;
@@ -608,9 +654,17 @@ main(int argc, char **argv)
 		case 'n':
 			flag_n = 1;
 			break;
+		case 'S':
+			flag_stream = 1;
+			break;
 		case 's':
 			flag_s = 1;
 			break;
+		case 't':
+			threshold = strtod(optarg, &p);
+			if (p != NULL && *p != '\0')
+				usage("Invalid threshold, not a number.");
+			break;
 		case 'w':
 			termwidth = strtol(optarg, &p, 10);
 			if (p != NULL && *p != '\0')
@@ -646,6 +700,11 @@ main(int argc, char **argv)
 		}
 	}
 
+	if (flag_stream && nds != 2)
+		usage("Stream mode needs exactly two datasets.");
+	if (!isnan(threshold) && nds != 2)
+		usage("A regression threshold needs exactly two datasets.");
+
 	if (caph_limit_stdio() < 0)
 		err(2, "capsicum");
 
@@ -658,10 +717,54 @@ main(int argc, char **argv)
 	if (caph_enter() < 0)
 		err(2, "unable to enter capability mode");
 
-	for (i = 0; i < nds; i++) {
-		ds[i] = ReadSet(setfiles[i], setfilenames[i], column, delim);
-		if (setfiles[i] != stdin)
-			fclose(setfiles[i]);
+	if (flag_stream) {
+		int line[2] = { 0, 0 };
+		int eofs[2] = { 0, 0 };
+
+		/*
+		 * Read the two streams a point at a time, re-testing for
+		 * significance as data arrives, so producers feeding us
+		 * through pipes can be stopped as soon as the verdict is
+		 * statistically safe.
+		 */
+		for (i = 0; i < nds; i++) {
+			ds[i] = NewSet();
+			ds[i]->name = strdup(setfilenames[i]);
+			assert(ds[i]->name != NULL);
+		}
+		while (!eofs[0] || !eofs[1]) {
+			for (i = 0; i < nds; i++) {
+				if (eofs[i])
+					continue;
+				if (ReadPoint(setfiles[i], setfilenames[i],
+				    &line[i], column, delim, &a))
+					AddPoint(ds[i], a);
+				else
+					eofs[i] = 1;
+			}
+			if (ds[0]->n >= 3 && ds[1]->n >= 3 &&
+			    Significant(ds[1], ds[0], ci, &d, &e))
+				break;
+		}
+		for (i = 0; i < nds; i++) {
+			if (ds[i]->n < 3) {
+				fprintf(stderr,
+				    "Dataset %s must contain at least 3 data points\n",
+				    setfilenames[i]);
+				exit (2);
+			}
+			qsort(ds[i]->points, ds[i]->n, sizeof *ds[i]->points,
+			    dbl_cmp);
+			if (setfiles[i] != stdin)
+				fclose(setfiles[i]);
+		}
+	} else {
+		for (i = 0; i < nds; i++) {
+			ds[i] = ReadSet(setfiles[i], setfilenames[i], column,
+			    delim);
+			if (setfiles[i] != stdin)
+				fclose(setfiles[i]);
+		}
 	}
 
 	for (i = 0; i < nds; i++)
@@ -682,5 +785,21 @@ main(int argc, char **argv)
 		if (!flag_n)
 			Relative(ds[i], ds[0], ci);
 	}
-	exit(0);
+	/*
+	 * With a threshold, fail if the second dataset differs from the
+	 * first by more than the given percentage of the first dataset's
+	 * average, in the direction selected by the threshold's sign,
+	 * and the difference is statistically significant.
+	 */
+	if (!isnan(threshold) && Significant(ds[1], ds[0], ci, &d, &e)) {
+		d = d * 100 / Avg(ds[0]);
+		if (threshold >= 0.0)
+			regression = (d < -threshold);
+		else
+			regression = (d > -threshold);
+		if (regression)
+			printf("Regression beyond %g%% threshold (%+g%%)\n",
+			    fabs(threshold), d);
+	}
+	exit(regression);
 }
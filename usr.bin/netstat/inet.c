@@ -994,6 +994,10 @@ ip_stats(u_long off, const char *name, int af1 __unused, int proto __unused)
 	    "{N:/packet%s fast forwarded})");
 	if (ipstat.ips_forward || sflag <= 1)
 		xo_emit("\n");
+	p1a(ips_nhcache_hit, "\t{:fastforward-nhcache-hits/%ju} "
+	    "{N:/fast forward next-hop cache hits}\n");
+	p1a(ips_nhcache_miss, "\t{:fastforward-nhcache-misses/%ju} "
+	    "{N:/fast forward next-hop cache misses}\n");
 	p(ips_cantforward, "\t{:packets-cannot-forward/%ju} "
 	    "{N:/packet%s not forwardable}\n");
 	p(ips_notmember, "\t{:received-unknown-multicast-group/%ju} "
@@ -62,6 +62,7 @@ __FBSDID("$FreeBSD$");
 #include <netdb.h>
 #include <pwd.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -570,6 +571,115 @@ gather_sctp(void)
 	free(buf);
 }
 
+/*
+ * Fetch a whole PCB list through the monolithic snapshot sysctl, retrying
+ * until the generation counts in its header and trailer match.  Returns
+ * NULL if the kernel does not provide the list at all.
+ */
+static void *
+fetch_inet_pcblist_fallback(const char *varname, size_t *lenp)
+{
+	struct xinpgen *xig, *exig;
+	size_t len, bufsize;
+	void *buf;
+	int retry;
+
+	buf = NULL;
+	bufsize = 8192;
+	retry = 5;
+	do {
+		for (;;) {
+			if ((buf = realloc(buf, bufsize)) == NULL)
+				err(1, "realloc()");
+			len = bufsize;
+			if (sysctlbyname(varname, buf, &len, NULL, 0) == 0)
+				break;
+			if (errno == ENOENT) {
+				free(buf);
+				return (NULL);
+			}
+			if (errno != ENOMEM || len != bufsize)
+				err(1, "sysctlbyname()");
+			bufsize *= 2;
+		}
+		xig = (struct xinpgen *)buf;
+		exig = (struct xinpgen *)(void *)
+		    ((char *)buf + len - sizeof *exig);
+		if (xig->xig_len != sizeof *xig ||
+		    exig->xig_len != sizeof *exig)
+			errx(1, "struct xinpgen size mismatch");
+	} while (xig->xig_gen != exig->xig_gen && retry--);
+
+	if (xig->xig_gen != exig->xig_gen && opt_v)
+		warnx("warning: data may be inconsistent");
+
+	*lenp = len;
+	return (buf);
+}
+
+/*
+ * Fetch a PCB list in bounded batches through the <varname>_batch cursor
+ * sysctl, so that the kernel never snapshots the whole PCB table in one
+ * go.  Falls back to the monolithic sysctl on kernels without the batch
+ * interface.  The result is laid out like the monolithic snapshot:
+ * struct xinpgen header and trailer bracketing fixed-size entries.
+ */
+static void *
+fetch_inet_pcblist(const char *varname, size_t xsize, size_t gencnt_off,
+    size_t *lenp)
+{
+	struct xinpgen xig;
+	char batchvar[64];
+	uint64_t cursor;
+	char *buf;
+	size_t batchsize, bufsize, len, off;
+	u_int count;
+
+	snprintf(batchvar, sizeof(batchvar), "%s_batch", varname);
+	cursor = 0;
+	if (sysctlbyname(batchvar, NULL, &batchsize, &cursor,
+	    sizeof(cursor)) != 0) {
+		if (errno == ENOENT)
+			return (fetch_inet_pcblist_fallback(varname, lenp));
+		err(1, "sysctlbyname()");
+	}
+
+	count = 0;
+	off = sizeof(xig);
+	bufsize = 0;
+	buf = NULL;
+	for (;;) {
+		if (bufsize < off + batchsize + sizeof(xig)) {
+			bufsize = (off + batchsize + sizeof(xig)) * 2;
+			if ((buf = realloc(buf, bufsize)) == NULL)
+				err(1, "realloc()");
+		}
+		len = batchsize;
+		if (sysctlbyname(batchvar, buf + off, &len, &cursor,
+		    sizeof(cursor)) != 0)
+			err(1, "sysctlbyname()");
+		if (len == 0)
+			break;
+		/* Resume after the last entry of this batch. */
+		memcpy(&cursor, buf + off + len - xsize + gencnt_off,
+		    sizeof(cursor));
+		count += len / xsize;
+		off += len;
+	}
+
+	/*
+	 * Bracket the entries with the header and trailer the snapshot
+	 * parser expects.
+	 */
+	memset(&xig, 0, sizeof(xig));
+	xig.xig_len = sizeof(xig);
+	xig.xig_count = count;
+	memcpy(buf, &xig, sizeof(xig));
+	memcpy(buf + off, &xig, sizeof(xig));
+	*lenp = off + sizeof(xig);
+	return (buf);
+}
+
 static void
 gather_inet(int proto)
 {
@@ -580,9 +690,9 @@ gather_inet(int proto)
 	struct sock *sock;
 	struct addr *laddr, *faddr;
 	const char *varname, *protoname;
-	size_t len, bufsize;
+	size_t gencnt_off, len, xsize;
 	void *buf;
-	int hash, retry, vflag;
+	int hash, vflag;
 
 	vflag = 0;
 	if (opt_4)
@@ -594,45 +704,31 @@ gather_inet(int proto)
 	case IPPROTO_TCP:
 		varname = "net.inet.tcp.pcblist";
 		protoname = "tcp";
+		xsize = sizeof(struct xtcpcb);
+		gencnt_off = offsetof(struct xtcpcb, xt_inp) +
+		    offsetof(struct xinpcb, inp_gencnt);
 		break;
 	case IPPROTO_UDP:
 		varname = "net.inet.udp.pcblist";
 		protoname = "udp";
+		xsize = sizeof(struct xinpcb);
+		gencnt_off = offsetof(struct xinpcb, inp_gencnt);
 		break;
 	case IPPROTO_DIVERT:
 		varname = "net.inet.divert.pcblist";
 		protoname = "div";
+		xsize = sizeof(struct xinpcb);
+		gencnt_off = offsetof(struct xinpcb, inp_gencnt);
 		break;
 	default:
 		errx(1, "protocol %d not supported", proto);
 	}
 
-	buf = NULL;
-	bufsize = 8192;
-	retry = 5;
-	do {
-		for (;;) {
-			if ((buf = realloc(buf, bufsize)) == NULL)
-				err(1, "realloc()");
-			len = bufsize;
-			if (sysctlbyname(varname, buf, &len, NULL, 0) == 0)
-				break;
-			if (errno == ENOENT)
-				goto out;
-			if (errno != ENOMEM || len != bufsize)
-				err(1, "sysctlbyname()");
-			bufsize *= 2;
-		}
-		xig = (struct xinpgen *)buf;
-		exig = (struct xinpgen *)(void *)
-		    ((char *)buf + len - sizeof *exig);
-		if (xig->xig_len != sizeof *xig ||
-		    exig->xig_len != sizeof *exig)
-			errx(1, "struct xinpgen size mismatch");
-	} while (xig->xig_gen != exig->xig_gen && retry--);
-
-	if (xig->xig_gen != exig->xig_gen && opt_v)
-		warnx("warning: data may be inconsistent");
+	buf = fetch_inet_pcblist(varname, xsize, gencnt_off, &len);
+	if (buf == NULL)
+		goto out;
+	xig = (struct xinpgen *)buf;
+	exig = (struct xinpgen *)(void *)((char *)buf + len - sizeof *exig);
 
 	for (;;) {
 		xig = (struct xinpgen *)(void *)((char *)xig + xig->xig_len);
@@ -655,6 +655,9 @@ file_reader_init(const char *fsrc)
 				break;
 			}
 
+			/* The mapping is only ever read front to back. */
+			(void) madvise(addr, sz, MADV_SEQUENTIAL);
+
 			ret->fd = fd;
 			ret->mmapaddr = addr;
 			ret->mmapsize = sz;
@@ -669,6 +672,15 @@ file_reader_init(const char *fsrc)
 			err(2, NULL);
 
 		if (strcmp(fsrc, "-")) {
+			/*
+			 * Merge passes consume each file strictly
+			 * sequentially; hint the kernel to read ahead so
+			 * that I/O overlaps with merging.  Harmless if the
+			 * descriptor is a compression program's pipe.
+			 */
+			(void) posix_fadvise(fileno(ret->file), 0, 0,
+			    POSIX_FADV_SEQUENTIAL);
+
 			ret->cbsz = READ_CHUNK;
 			ret->buffer = sort_malloc(ret->cbsz);
 			ret->bsz = 0;
@@ -1144,20 +1156,146 @@ merge_files_array(size_t argc, const char **argv, const char *fn_out)
 	}
 }
 
+#if defined(SORT_THREADS)
+
+/* semaphore to count batch merge threads */
+static sem_t mergesem;
+
+/*
+ * A batch of temporary runs to be merged into one file by a worker thread.
+ */
+struct merge_batch
+{
+	struct file_list	*fl;
+	size_t			 indx;
+	size_t			 num;
+	const char		*fn_out;
+};
+
+/*
+ * Merge one batch of files and unlink the merged inputs.
+ */
+static void*
+merge_batch_thread(void* arg)
+{
+	struct merge_batch *mb = arg;
+
+	merge_files_array(mb->num, mb->fl->fns + mb->indx, mb->fn_out);
+	if (mb->fl->tmp) {
+		size_t i;
+
+		for (i = 0; i < mb->num; i++)
+			unlink(mb->fl->fns[mb->indx + i]);
+	}
+	sem_post(&mergesem);
+
+	return (NULL);
+}
+
+/*
+ * Merge batches of files in parallel, up to njobs batches at once.  The
+ * batches are independent of each other, so the only coordination needed
+ * is bounding the number of threads in flight.
+ */
+static void
+merge_batches(struct merge_batch *batches, size_t nb, size_t njobs)
+{
+	size_t i, inflight = 0;
+
+	sem_init(&mergesem, 0, 0);
+
+	for (i = 0; i < nb; i++) {
+		pthread_t pth;
+		pthread_attr_t attr;
+
+		if (inflight >= njobs) {
+			sem_wait(&mergesem);
+			--inflight;
+		}
+
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_DETACHED);
+
+		for (;;) {
+			int res = pthread_create(&pth, &attr,
+			    merge_batch_thread, batches + i);
+
+			if (res >= 0)
+				break;
+			if (errno == EAGAIN) {
+				pthread_yield();
+				continue;
+			}
+			err(2, NULL);
+		}
+
+		pthread_attr_destroy(&attr);
+		++inflight;
+	}
+
+	while (inflight > 0) {
+		sem_wait(&mergesem);
+		--inflight;
+	}
+	sem_destroy(&mergesem);
+}
+
+#endif /* defined(SORT_THREADS) */
+
 /*
  * Shrinks the file list until its size smaller than max number of opened files
  */
 static int
 shrink_file_list(struct file_list *fl)
 {
+	struct file_list new_fl;
+	size_t indx = 0;
+#if defined(SORT_THREADS)
+	size_t njobs;
+#endif
 
 	if ((fl == NULL) || (size_t) (fl->count) < max_open_files)
 		return (0);
-	else {
-		struct file_list new_fl;
-		size_t indx = 0;
 
-		file_list_init(&new_fl, true);
+	file_list_init(&new_fl, true);
+
+#if defined(SORT_THREADS)
+	/*
+	 * Split the file descriptor budget between concurrent batch
+	 * merges; each batch needs its inputs plus one output, and a
+	 * batch of fewer than two inputs is pointless.
+	 */
+	njobs = max_open_files / 3;
+	if (njobs > nthreads)
+		njobs = nthreads;
+	if (njobs > 1) {
+		struct merge_batch *batches;
+		size_t bnum, nb;
+
+		bnum = max_open_files / njobs - 1;
+		nb = (fl->count + bnum - 1) / bnum;
+		batches = sort_malloc(nb * sizeof(struct merge_batch));
+		nb = 0;
+		while (indx < fl->count) {
+			size_t num;
+
+			num = fl->count - indx;
+			if (num > bnum)
+				num = bnum;
+			batches[nb].fl = fl;
+			batches[nb].indx = indx;
+			batches[nb].num = num;
+			batches[nb].fn_out = new_tmp_file_name();
+			file_list_add(&new_fl, batches[nb].fn_out, false);
+			++nb;
+			indx += num;
+		}
+
+		merge_batches(batches, nb, njobs);
+		sort_free(batches);
+	} else
+#endif /* defined(SORT_THREADS) */
+	{
 		while (indx < fl->count) {
 			char *fnew;
 			size_t num;
@@ -1177,16 +1315,17 @@ shrink_file_list(struct file_list *fl)
 			file_list_add(&new_fl, fnew, false);
 			indx += num;
 		}
-		fl->tmp = false; /* already taken care of */
-		file_list_clean(fl);
+	}
 
-		fl->count = new_fl.count;
-		fl->fns = new_fl.fns;
-		fl->sz = new_fl.sz;
-		fl->tmp = new_fl.tmp;
+	fl->tmp = false; /* already taken care of */
+	file_list_clean(fl);
 
-		return (1);
-	}
+	fl->count = new_fl.count;
+	fl->fns = new_fl.fns;
+	fl->sz = new_fl.sz;
+	fl->tmp = new_fl.tmp;
+
+	return (1);
 }
 
 /*
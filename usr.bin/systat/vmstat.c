@@ -741,41 +741,46 @@ static void
 getinfo(struct Info *ls)
 {
 	struct devinfo *tmp_dinfo;
+	struct vmstats_snap vms;
 	size_t size;
 	int mib[2];
 
 	GETSYSCTL("kern.cp_time", ls->time);
 	GETSYSCTL("kern.cp_time", cur_dev.cp_time);
-	GETSYSCTL("vm.stats.sys.v_swtch", ls->v_swtch);
-	GETSYSCTL("vm.stats.sys.v_trap", ls->v_trap);
-	GETSYSCTL("vm.stats.sys.v_syscall", ls->v_syscall);
-	GETSYSCTL("vm.stats.sys.v_intr", ls->v_intr);
-	GETSYSCTL("vm.stats.sys.v_soft", ls->v_soft);
-	GETSYSCTL("vm.stats.vm.v_vm_faults", ls->v_vm_faults);
-	GETSYSCTL("vm.stats.vm.v_io_faults", ls->v_io_faults);
-	GETSYSCTL("vm.stats.vm.v_cow_faults", ls->v_cow_faults);
-	GETSYSCTL("vm.stats.vm.v_zfod", ls->v_zfod);
-	GETSYSCTL("vm.stats.vm.v_ozfod", ls->v_ozfod);
-	GETSYSCTL("vm.stats.vm.v_swapin", ls->v_swapin);
-	GETSYSCTL("vm.stats.vm.v_swapout", ls->v_swapout);
-	GETSYSCTL("vm.stats.vm.v_swappgsin", ls->v_swappgsin);
-	GETSYSCTL("vm.stats.vm.v_swappgsout", ls->v_swappgsout);
-	GETSYSCTL("vm.stats.vm.v_vnodein", ls->v_vnodein);
-	GETSYSCTL("vm.stats.vm.v_vnodeout", ls->v_vnodeout);
-	GETSYSCTL("vm.stats.vm.v_vnodepgsin", ls->v_vnodepgsin);
-	GETSYSCTL("vm.stats.vm.v_vnodepgsout", ls->v_vnodepgsout);
-	GETSYSCTL("vm.stats.vm.v_intrans", ls->v_intrans);
-	GETSYSCTL("vm.stats.vm.v_reactivated", ls->v_reactivated);
-	GETSYSCTL("vm.stats.vm.v_pdwakeups", ls->v_pdwakeups);
-	GETSYSCTL("vm.stats.vm.v_pdpages", ls->v_pdpages);
-	GETSYSCTL("vm.stats.vm.v_dfree", ls->v_dfree);
-	GETSYSCTL("vm.stats.vm.v_pfree", ls->v_pfree);
-	GETSYSCTL("vm.stats.vm.v_tfree", ls->v_tfree);
-	GETSYSCTL("vm.stats.vm.v_free_count", ls->v_free_count);
-	GETSYSCTL("vm.stats.vm.v_wire_count", ls->v_wire_count);
-	GETSYSCTL("vm.stats.vm.v_active_count", ls->v_active_count);
-	GETSYSCTL("vm.stats.vm.v_inactive_count", ls->v_inactive_count);
-	GETSYSCTL("vm.stats.vm.v_laundry_count", ls->v_laundry_count);
+
+	/* All of the vm.stats statistics come in a single copy. */
+	GETSYSCTL("vm.stats.snapshot", vms);
+	ls->v_swtch = vms.v_swtch;
+	ls->v_trap = vms.v_trap;
+	ls->v_syscall = vms.v_syscall;
+	ls->v_intr = vms.v_intr;
+	ls->v_soft = vms.v_soft;
+	ls->v_vm_faults = vms.v_vm_faults;
+	ls->v_io_faults = vms.v_io_faults;
+	ls->v_cow_faults = vms.v_cow_faults;
+	ls->v_zfod = vms.v_zfod;
+	ls->v_ozfod = vms.v_ozfod;
+	ls->v_swapin = vms.v_swapin;
+	ls->v_swapout = vms.v_swapout;
+	ls->v_swappgsin = vms.v_swappgsin;
+	ls->v_swappgsout = vms.v_swappgsout;
+	ls->v_vnodein = vms.v_vnodein;
+	ls->v_vnodeout = vms.v_vnodeout;
+	ls->v_vnodepgsin = vms.v_vnodepgsin;
+	ls->v_vnodepgsout = vms.v_vnodepgsout;
+	ls->v_intrans = vms.v_intrans;
+	ls->v_reactivated = vms.v_reactivated;
+	ls->v_pdwakeups = vms.v_pdwakeups;
+	ls->v_pdpages = vms.v_pdpages;
+	ls->v_dfree = vms.v_dfree;
+	ls->v_pfree = vms.v_pfree;
+	ls->v_tfree = vms.v_tfree;
+	ls->v_free_count = vms.v_free_count;
+	ls->v_wire_count = vms.v_wire_count;
+	ls->v_active_count = vms.v_active_count;
+	ls->v_inactive_count = vms.v_inactive_count;
+	ls->v_laundry_count = vms.v_laundry_count;
+
 	GETSYSCTL("vfs.bufspace", ls->bufspace);
 	GETSYSCTL("kern.maxvnodes", ls->maxvnodes);
 	GETSYSCTL("vfs.numvnodes", ls->numvnodes);
@@ -35,6 +35,7 @@ __FBSDID("$FreeBSD$");
 #ifndef WITHOUT_CAPSICUM
 #include <sys/capsicum.h>
 #endif
+#include <sys/domainset.h>
 #include <sys/mman.h>
 #ifdef BHYVE_SNAPSHOT
 #include <sys/socket.h>
@@ -237,9 +238,9 @@ usage(int code)
 {
 
         fprintf(stderr,
-		"Usage: %s [-abehuwxACDHPSWY]\n"
+		"Usage: %s [-abehuwxACDFHPSWY]\n"
 		"       %*s [-c [[cpus=]numcpus][,sockets=n][,cores=n][,threads=n]]\n"
-		"       %*s [-g <gdb port>] [-l <lpc>]\n"
+		"       %*s [-g <gdb port>] [-l <lpc>] [-n <domains>]\n"
 		"       %*s [-m mem] [-p vcpu:hostcpu] [-s <pci>] [-U uuid] <vm>\n"
 		"       -a: local apic is in xAPIC mode (deprecated)\n"
 		"       -A: create ACPI tables\n"
@@ -247,11 +248,13 @@ usage(int code)
 		"       -C: include guest memory in core file\n"
 		"       -D: destroy on power-off\n"
 		"       -e: exit on unhandled I/O access\n"
+		"       -F: pre-fault all guest memory at startup\n"
 		"       -g: gdb port\n"
 		"       -h: help\n"
 		"       -H: vmexit from the guest on hlt\n"
 		"       -l: LPC device configuration\n"
 		"       -m: memory size in MB\n"
+		"       -n: place guest memory on the given host domains\n"
 #ifdef BHYVE_SNAPSHOT
 		"       -r: path to checkpoint file\n"
 #endif
@@ -359,6 +362,79 @@ out:
 	return (-1);
 }
 
+static int memprefault;
+static int memdomain_policy = DOMAINSET_POLICY_INVALID;
+static domainset_t memdomain_mask;
+
+/*
+ * Parse a list of host memory domains, e.g. "0,2" or "0-1", into
+ * memdomain_mask.  A single domain is preferred; guest pages are
+ * interleaved across multiple domains.
+ */
+static int
+memdomain_parse(const char *opt)
+{
+	const char *cp;
+	char *endp;
+	long domain, end;
+
+	DOMAINSET_ZERO(&memdomain_mask);
+	cp = opt;
+	for (;;) {
+		domain = strtol(cp, &endp, 10);
+		if (endp == cp || domain < 0 || domain >= DOMAINSET_SETSIZE)
+			return (-1);
+		end = domain;
+		if (*endp == '-') {
+			cp = endp + 1;
+			end = strtol(cp, &endp, 10);
+			if (endp == cp || end < domain ||
+			    end >= DOMAINSET_SETSIZE)
+				return (-1);
+		}
+		while (domain <= end)
+			DOMAINSET_SET(domain++, &memdomain_mask);
+		if (*endp == '\0')
+			break;
+		if (*endp != ',')
+			return (-1);
+		cp = endp + 1;
+	}
+
+	if (DOMAINSET_COUNT(&memdomain_mask) == 1)
+		memdomain_policy = DOMAINSET_POLICY_PREFER;
+	else
+		memdomain_policy = DOMAINSET_POLICY_ROUNDROBIN;
+	return (0);
+}
+
+/*
+ * Touch every guest page so that the cost of allocating (and placing)
+ * the guest's memory is paid here rather than by the first guest
+ * access after boot.  A read fault is sufficient to allocate a page of
+ * the shared guest memory object.
+ */
+static void
+fbsdrun_prefault_memory(struct vmctx *ctx)
+{
+	volatile const char *p;
+	size_t len, pgsz, i;
+
+	pgsz = getpagesize();
+	len = vm_get_lowmem_size(ctx);
+	if (len != 0) {
+		p = paddr_guest2host(ctx, 0, len);
+		for (i = 0; i < len; i += pgsz)
+			(void)p[i];
+	}
+	len = vm_get_highmem_size(ctx);
+	if (len != 0) {
+		p = paddr_guest2host(ctx, 4 * GB, len);
+		for (i = 0; i < len; i += pgsz)
+			(void)p[i];
+	}
+}
+
 static int
 pincpu_parse(const char *opt)
 {
@@ -392,6 +468,20 @@ pincpu_parse(const char *opt)
 	return (0);
 }
 
+/*
+ * Return the host CPU set a vCPU is pinned to, or NULL if the vCPU is
+ * not pinned.  Device models use this to place their worker threads
+ * near the vCPUs they serve.
+ */
+cpuset_t *
+fbsdrun_vcpumap(int vcpu)
+{
+
+	if (vcpu < 0 || vcpu >= VM_MAXCPU)
+		return (NULL);
+	return (vcpumap[vcpu]);
+}
+
 void
 vm_inject_fault(void *arg, int vcpu, int vector, int errcode_valid,
     int errcode)
@@ -1105,9 +1195,9 @@ main(int argc, char *argv[])
 	memflags = 0;
 
 #ifdef BHYVE_SNAPSHOT
-	optstr = "abehuwxACDHIPSWYp:g:G:c:s:m:l:U:r:";
+	optstr = "abehuwxACDFHIPSWYn:p:g:G:c:s:m:l:U:r:";
 #else
-	optstr = "abehuwxACDHIPSWYp:g:G:c:s:m:l:U:";
+	optstr = "abehuwxACDFHIPSWYn:p:g:G:c:s:m:l:U:";
 #endif
 	while ((c = getopt(argc, argv, optstr)) != -1) {
 		switch (c) {
@@ -1123,6 +1213,15 @@ main(int argc, char *argv[])
 		case 'D':
 			destroy_on_poweroff = 1;
 			break;
+		case 'F':
+			memprefault = 1;
+			break;
+		case 'n':
+			if (memdomain_parse(optarg) != 0) {
+				errx(EX_USAGE, "invalid memory domain "
+				    "list '%s'", optarg);
+			}
+			break;
 		case 'p':
                         if (pincpu_parse(optarg) != 0) {
                             errx(EX_USAGE, "invalid vcpu pinning "
@@ -1276,6 +1375,17 @@ main(int argc, char *argv[])
 
 	fbsdrun_set_capabilities(ctx, BSP);
 
+	/*
+	 * Apply the memory domain policy before the guest memory
+	 * object is created so that both wired allocation and later
+	 * faults place pages on the requested domains.
+	 */
+	if (memdomain_policy != DOMAINSET_POLICY_INVALID &&
+	    cpuset_setdomain(CPU_LEVEL_WHICH, CPU_WHICH_PID, -1,
+	    sizeof(memdomain_mask), &memdomain_mask, memdomain_policy) != 0)
+		errx(EX_OSERR, "could not set memory domain policy: %s",
+		    strerror(errno));
+
 	vm_set_memflags(ctx, memflags);
 	err = vm_setup_memory(ctx, memsize, VM_MMAP_ALL);
 	if (err) {
@@ -1283,6 +1393,9 @@ main(int argc, char *argv[])
 		exit(4);
 	}
 
+	if (memprefault)
+		fbsdrun_prefault_memory(ctx);
+
 	error = init_msr();
 	if (error) {
 		fprintf(stderr, "init_msr error %d", error);
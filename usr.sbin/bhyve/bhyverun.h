@@ -31,6 +31,8 @@
 #ifndef	_FBSDRUN_H_
 #define	_FBSDRUN_H_
 
+#include <sys/cpuset.h>
+
 #define	VMEXIT_CONTINUE		(0)
 #define	VMEXIT_ABORT		(-1)
 
@@ -52,4 +54,5 @@ int  fbsdrun_vmexit_on_hlt(void);
 int  fbsdrun_vmexit_on_pause(void);
 int  fbsdrun_disable_x2apic(void);
 int  fbsdrun_virtio_msix(void);
+cpuset_t *fbsdrun_vcpumap(int vcpu);
 #endif
@@ -38,10 +38,12 @@ __FBSDID("$FreeBSD$");
 #endif
 #include <sys/queue.h>
 #include <sys/errno.h>
+#include <sys/event.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
 #include <sys/disk.h>
 
+#include <aio.h>
 #include <assert.h>
 #ifndef WITHOUT_CAPSICUM
 #include <capsicum_helpers.h>
@@ -70,6 +72,9 @@ __FBSDID("$FreeBSD$");
 #define BLOCKIF_NUMTHR	8
 #define BLOCKIF_MAXREQ	(BLOCKIF_RING_MAX + BLOCKIF_NUMTHR)
 
+/* Max completions reaped from the kqueue in one kevent() call */
+#define BLOCKIF_AIO_BATCH	32
+
 enum blockop {
 	BOP_READ,
 	BOP_WRITE,
@@ -92,6 +97,7 @@ struct blockif_elem {
 	enum blockstat	     be_status;
 	pthread_t            be_tid;
 	off_t		     be_block;
+	struct aiocb	     be_aio;
 };
 
 struct blockif_ctxt {
@@ -108,6 +114,9 @@ struct blockif_ctxt {
 	int			bc_closing;
 	int			bc_paused;
 	int			bc_work_count;
+	int			bc_asyncio;
+	int			bc_kq;
+	pthread_t		bc_aiotid;
 	pthread_t		bc_btid[BLOCKIF_NUMTHR];
 	pthread_mutex_t		bc_mtx;
 	pthread_cond_t		bc_cond;
@@ -395,6 +404,128 @@ blockif_thr(void *arg)
 	return (NULL);
 }
 
+/*
+ * Submit a request through the kernel asynchronous I/O ring instead of
+ * handing it to the worker threads.  The kernel reads from and writes
+ * to the guest pages directly, and single-segment requests on an
+ * unbuffered device take the kernel's physio fast path, so no bounce
+ * buffering occurs anywhere.  Completions are reaped in batches off
+ * bc_kq by blockif_aio_thr().
+ *
+ * Only single-segment reads and writes are submitted this way - the
+ * dominant shape for small random I/O, which is where the per-request
+ * worker thread handoff hurts the most.  Everything else falls back to
+ * the worker threads.  Note that overlapping requests in flight in the
+ * kernel are not ordered against each other the way the worker queue
+ * orders them.
+ *
+ * Called with the blockif mutex held.
+ */
+static int
+blockif_aio_submit(struct blockif_ctxt *bc, struct blockif_req *breq,
+		   enum blockop op)
+{
+	struct blockif_elem *be;
+	struct aiocb *aio;
+	int err;
+
+	be = TAILQ_FIRST(&bc->bc_freeq);
+	assert(be != NULL);
+	assert(be->be_status == BST_FREE);
+	TAILQ_REMOVE(&bc->bc_freeq, be, be_link);
+	be->be_req = breq;
+	be->be_op = op;
+	be->be_block = breq->br_offset + breq->br_iov[0].iov_len;
+	be->be_tid = 0;
+	be->be_status = BST_BUSY;
+	TAILQ_INSERT_TAIL(&bc->bc_busyq, be, be_link);
+
+	aio = &be->be_aio;
+	memset(aio, 0, sizeof(*aio));
+	aio->aio_fildes = bc->bc_fd;
+	aio->aio_offset = breq->br_offset;
+	aio->aio_buf = breq->br_iov[0].iov_base;
+	aio->aio_nbytes = breq->br_iov[0].iov_len;
+	aio->aio_sigevent.sigev_notify = SIGEV_KEVENT;
+	aio->aio_sigevent.sigev_notify_kqueue = bc->bc_kq;
+	aio->aio_sigevent.sigev_value.sival_ptr = be;
+
+	if (op == BOP_WRITE)
+		err = aio_write(aio);
+	else
+		err = aio_read(aio);
+	if (err) {
+		/*
+		 * Most likely the kernel AIO queue is full; undo the
+		 * bookkeeping so the caller can fall back to the
+		 * worker threads.
+		 */
+		TAILQ_REMOVE(&bc->bc_busyq, be, be_link);
+		be->be_tid = 0;
+		be->be_status = BST_FREE;
+		be->be_req = NULL;
+		TAILQ_INSERT_TAIL(&bc->bc_freeq, be, be_link);
+		return (errno);
+	}
+
+	return (0);
+}
+
+static void *
+blockif_aio_thr(void *arg)
+{
+	struct kevent kev[BLOCKIF_AIO_BATCH];
+	struct blockif_ctxt *bc;
+	struct blockif_elem *be;
+	struct blockif_req *br;
+	ssize_t len;
+	int i, n, err;
+
+	bc = arg;
+
+	for (;;) {
+		n = kevent(bc->bc_kq, NULL, 0, kev, nitems(kev), NULL);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		for (i = 0; i < n; i++) {
+			if (kev[i].filter == EVFILT_USER)
+				goto out;
+
+			be = kev[i].udata;
+			br = be->be_req;
+			err = 0;
+			len = aio_return(&be->be_aio);
+			if (len < 0)
+				err = errno;
+			else
+				br->br_resid -= len;
+
+			be->be_status = BST_DONE;
+
+			(*br->br_callback)(br, err);
+
+			pthread_mutex_lock(&bc->bc_mtx);
+			blockif_complete(bc, be);
+			/*
+			 * Completing this request may have unblocked
+			 * queued requests with overlapping offsets.
+			 */
+			pthread_cond_signal(&bc->bc_cond);
+			if (bc->bc_paused && TAILQ_EMPTY(&bc->bc_busyq))
+				pthread_cond_broadcast(
+				    &bc->bc_work_done_cond);
+			pthread_mutex_unlock(&bc->bc_mtx);
+		}
+	}
+out:
+	pthread_exit(NULL);
+	return (NULL);
+}
+
 static void
 blockif_sigcont_handler(int signal, enum ev_type type, void *arg)
 {
@@ -437,9 +568,9 @@ blockif_open(const char *optstr, const char *ident)
 	struct stat sbuf;
 	struct diocgattr_arg arg;
 	off_t size, psectsz, psectoff;
-	int extra, fd, i, sectsz;
+	int extra, fd, i, kq, sectsz;
 	int nocache, sync, ro, candelete, geom, ssopt, pssopt;
-	int nodelete;
+	int nodelete, asyncio;
 
 #ifndef WITHOUT_CAPSICUM
 	cap_rights_t rights;
@@ -449,11 +580,13 @@ blockif_open(const char *optstr, const char *ident)
 	pthread_once(&blockif_once, blockif_init);
 
 	fd = -1;
+	kq = -1;
 	ssopt = 0;
 	nocache = 0;
 	sync = 0;
 	ro = 0;
 	nodelete = 0;
+	asyncio = 0;
 
 	/*
 	 * The first element in the optstring is always a pathname.
@@ -468,6 +601,8 @@ blockif_open(const char *optstr, const char *ident)
 			nocache = 1;
 		else if (!strcmp(cp, "nodelete"))
 			nodelete = 1;
+		else if (!strcmp(cp, "aio"))
+			asyncio = 1;
 		else if (!strcmp(cp, "sync") || !strcmp(cp, "direct"))
 			sync = 1;
 		else if (!strcmp(cp, "ro"))
@@ -575,6 +710,20 @@ blockif_open(const char *optstr, const char *ident)
 		psectoff = 0;
 	}
 
+	if (asyncio) {
+		struct kevent kev;
+
+		kq = kqueue();
+		if (kq < 0) {
+			perror("Could not create AIO completion kqueue");
+			goto err;
+		}
+
+		/* User event used to wake the completion thread on close */
+		EV_SET(&kev, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, NULL);
+		(void) kevent(kq, &kev, 1, NULL, 0, NULL);
+	}
+
 	bc = calloc(1, sizeof(struct blockif_ctxt));
 	if (bc == NULL) {
 		perror("calloc");
@@ -582,6 +731,7 @@ blockif_open(const char *optstr, const char *ident)
 	}
 
 	bc->bc_magic = BLOCKIF_SIG;
+	bc->bc_kq = kq;
 	bc->bc_fd = fd;
 	bc->bc_ischr = S_ISCHR(sbuf.st_mode);
 	bc->bc_isgeom = geom;
@@ -611,8 +761,17 @@ blockif_open(const char *optstr, const char *ident)
 		pthread_set_name_np(bc->bc_btid[i], tname);
 	}
 
+	if (asyncio) {
+		bc->bc_asyncio = 1;
+		pthread_create(&bc->bc_aiotid, NULL, blockif_aio_thr, bc);
+		snprintf(tname, sizeof(tname), "blk-%s-aio", ident);
+		pthread_set_name_np(bc->bc_aiotid, tname);
+	}
+
 	return (bc);
 err:
+	if (kq >= 0)
+		close(kq);
 	if (fd >= 0)
 		close(fd);
 	free(nopt);
@@ -629,6 +788,20 @@ blockif_request(struct blockif_ctxt *bc, struct blockif_req *breq,
 
 	pthread_mutex_lock(&bc->bc_mtx);
 	if (!TAILQ_EMPTY(&bc->bc_freeq)) {
+		/*
+		 * Single-segment reads and writes go straight to the
+		 * kernel AIO ring when it is enabled; anything else,
+		 * and any request the kernel will not queue, takes
+		 * the worker thread path below.
+		 */
+		if (bc->bc_asyncio && !bc->bc_paused &&
+		    (op == BOP_READ || (op == BOP_WRITE && !bc->bc_rdonly)) &&
+		    breq->br_iovcnt == 1 &&
+		    blockif_aio_submit(bc, breq, op) == 0) {
+			pthread_mutex_unlock(&bc->bc_mtx);
+			return (0);
+		}
+
 		/*
 		 * Enqueue and inform the block i/o thread
 		 * that there is work available
@@ -723,6 +896,18 @@ blockif_cancel(struct blockif_ctxt *bc, struct blockif_req *breq)
 		return (EINVAL);
 	}
 
+	/*
+	 * Requests submitted to the kernel AIO ring have no worker
+	 * thread to interrupt; ask the kernel to cancel the job.  The
+	 * completion (cancelled or not) is still delivered to the
+	 * kqueue and runs the callback, so report EBUSY either way.
+	 */
+	if (bc->bc_asyncio && be->be_tid == 0) {
+		(void) aio_cancel(bc->bc_fd, &be->be_aio);
+		pthread_mutex_unlock(&bc->bc_mtx);
+		return (EBUSY);
+	}
+
 	/*
 	 * Interrupt the processing thread to force it return
 	 * prematurely via it's normal callback path.
@@ -777,6 +962,16 @@ blockif_close(struct blockif_ctxt *bc)
 	for (i = 0; i < BLOCKIF_NUMTHR; i++)
 		pthread_join(bc->bc_btid[i], &jval);
 
+	if (bc->bc_asyncio) {
+		struct kevent kev;
+
+		/* Wake the completion thread so it can exit */
+		EV_SET(&kev, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, NULL);
+		(void) kevent(bc->bc_kq, &kev, 1, NULL, 0, NULL);
+		pthread_join(bc->bc_aiotid, &jval);
+		close(bc->bc_kq);
+	}
+
 	/* XXX Cancel queued i/o's ??? */
 
 	/*
@@ -900,8 +1095,12 @@ blockif_pause(struct blockif_ctxt *bc)
 	pthread_mutex_lock(&bc->bc_mtx);
 	bc->bc_paused = 1;
 
-	/* The interface is paused. Wait for workers to finish their work */
-	while (bc->bc_work_count)
+	/*
+	 * The interface is paused. Wait for the workers to finish
+	 * their work and for outstanding kernel AIO to complete.
+	 */
+	while (bc->bc_work_count ||
+	    (bc->bc_asyncio && !TAILQ_EMPTY(&bc->bc_busyq)))
 		pthread_cond_wait(&bc->bc_work_done_cond, &bc->bc_mtx);
 	pthread_mutex_unlock(&bc->bc_mtx);
 
@@ -59,12 +59,14 @@
 #include <sys/cdefs.h>
 __FBSDID("$FreeBSD$");
 
+#include <sys/param.h>
 #include <sys/errno.h>
 #include <sys/types.h>
 #include <net/ieee_oui.h>
 
 #include <assert.h>
 #include <pthread.h>
+#include <pthread_np.h>
 #include <semaphore.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -72,6 +74,7 @@ __FBSDID("$FreeBSD$");
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <machine/atomic.h>
 #include <machine/vmm.h>
@@ -128,6 +131,17 @@ static int nvme_debug = 0;
 
 #define	NVME_DOORBELL_OFFSET	offsetof(struct nvme_registers, doorbell)
 
+/*
+ * The shadow doorbell and EventIdx buffers established by the Doorbell
+ * Buffer Config command mirror the register doorbell layout: one pair
+ * of 32-bit values per queue, submission queue tail first.
+ */
+#define	NVME_DBBUF_SQ_IDX(qid)	((qid) * 2)
+
+/* Iterations of the submission queue poller before it backs off */
+#define	NVME_POLLER_SPIN	256	/* ... yielding the cpu */
+#define	NVME_POLLER_IDLE	2048	/* ... sleeping on the doorbell */
+
 enum nvme_controller_register_offsets {
 	NVME_CR_CAP_LOW = 0x00,
 	NVME_CR_CAP_HI  = 0x04,
@@ -304,6 +318,15 @@ struct pci_nvme_softc {
 
 	STAILQ_HEAD(, pci_nvme_aer) aer_list;
 	uint32_t	aer_count;
+
+	/* Shadow doorbells and the submission queue poller thread */
+	bool		iopoll;		/* "iopoll" option given */
+	uint32_t	*dbbuf_dbs;	/* shadow doorbell values */
+	uint32_t	*dbbuf_eis;	/* doorbell EventIdx values */
+	pthread_t	poller_tid;
+	pthread_mutex_t	poller_mtx;
+	pthread_cond_t	poller_cond;
+	bool		poller_asleep;
 };
 
 
@@ -469,6 +492,8 @@ pci_nvme_init_ctrldata(struct pci_nvme_softc *sc)
 	cd->ver = 0x00010300;
 
 	cd->oacs = 1 << NVME_CTRLR_DATA_OACS_FORMAT_SHIFT;
+	if (sc->iopoll)
+		cd->oacs |= 1 << NVME_CTRLR_DATA_OACS_DBBUFFER_SHIFT;
 	cd->acl = 2;
 	cd->aerl = 4;
 
@@ -755,6 +780,9 @@ pci_nvme_reset_locked(struct pci_nvme_softc *sc)
 
 	sc->num_q_is_set = false;
 
+	sc->dbbuf_dbs = NULL;
+	sc->dbbuf_eis = NULL;
+
 	pci_nvme_aer_destroy(sc);
 }
 
@@ -1550,6 +1578,47 @@ nvme_opc_async_event_req(struct pci_nvme_softc* sc,
 	return (0);
 }
 
+/* Wake up the submission queue poller if it has gone to sleep */
+static void
+pci_nvme_poller_kick(struct pci_nvme_softc *sc)
+{
+
+	pthread_mutex_lock(&sc->poller_mtx);
+	if (sc->poller_asleep)
+		pthread_cond_signal(&sc->poller_cond);
+	pthread_mutex_unlock(&sc->poller_mtx);
+}
+
+static int
+nvme_opc_doorbell_buffer_config(struct pci_nvme_softc *sc,
+	struct nvme_command *command, struct nvme_completion *compl)
+{
+	uint64_t prp1 = command->prp1;
+	uint64_t prp2 = command->prp2;
+
+	DPRINTF("%s shadow 0x%lx EventIdx 0x%lx", __func__, prp1, prp2);
+
+	if ((prp1 == 0) || (prp1 & PAGE_MASK) ||
+	    (prp2 == 0) || (prp2 & PAGE_MASK)) {
+		pci_nvme_status_genc(&compl->status, NVME_SC_INVALID_FIELD);
+		return (1);
+	}
+
+	sc->dbbuf_eis = vm_map_gpa(sc->nsc_pi->pi_vmctx, prp2, PAGE_SIZE);
+
+	/*
+	 * The poller keys off dbbuf_dbs, so the EventIdx buffer must
+	 * be visible before the shadow doorbells are.
+	 */
+	atomic_store_rel_ptr((volatile uintptr_t *)&sc->dbbuf_dbs,
+	    (uintptr_t)vm_map_gpa(sc->nsc_pi->pi_vmctx, prp1, PAGE_SIZE));
+
+	pci_nvme_poller_kick(sc);
+
+	pci_nvme_status_genc(&compl->status, NVME_SC_SUCCESS);
+	return (1);
+}
+
 static void
 pci_nvme_handle_admin_cmd(struct pci_nvme_softc* sc, uint64_t value)
 {
@@ -1621,6 +1690,16 @@ pci_nvme_handle_admin_cmd(struct pci_nvme_softc* sc, uint64_t value)
 			DPRINTF("%s command ASYNC_EVENT_REQ", __func__);
 			nvme_opc_async_event_req(sc, cmd, &compl);
 			break;
+		case NVME_OPC_DOORBELL_BUFFER_CONFIG:
+			DPRINTF("%s command DOORBELL_BUFFER_CONFIG", __func__);
+			if ((sc->ctrldata.oacs &
+			    (1 << NVME_CTRLR_DATA_OACS_DBBUFFER_SHIFT)) == 0) {
+				pci_nvme_status_genc(&compl.status,
+				    NVME_SC_INVALID_OPCODE);
+				break;
+			}
+			nvme_opc_doorbell_buffer_config(sc, cmd, &compl);
+			break;
 		case NVME_OPC_FORMAT_NVM:
 			DPRINTF("%s command FORMAT_NVM", __func__);
 			if ((sc->ctrldata.oacs &
@@ -2308,6 +2387,116 @@ complete:
 	pthread_mutex_unlock(&sq->mtx);
 }
 
+/*
+ * Submission queue poller thread.
+ *
+ * Once the guest has established shadow doorbells with the Doorbell
+ * Buffer Config command, this thread picks up new submissions by
+ * polling the shadow tail values instead of requiring a doorbell
+ * register write (and thus a VM exit) per submission.  While the
+ * poller is running it keeps each queue's EventIdx behind the consumed
+ * tail, which tells the guest that ringing the doorbell is
+ * unnecessary.  When the queues stay empty the poller backs off, first
+ * yielding the processor and then napping, and finally re-arms the
+ * EventIdx values so that the next submission rings the doorbell and
+ * goes to sleep until that happens.
+ */
+static void *
+pci_nvme_sq_poller(void *arg)
+{
+	struct pci_nvme_softc *sc = arg;
+	struct nvme_submission_queue *sq;
+	uint32_t *dbs, *eis;
+	uint32_t idle;
+	uint16_t qid, tail;
+	bool busy;
+
+	idle = 0;
+	for (;;) {
+		dbs = (uint32_t *)atomic_load_acq_ptr(
+		    (volatile uintptr_t *)&sc->dbbuf_dbs);
+		if (dbs == NULL) {
+			/* Wait for a Doorbell Buffer Config command. */
+			pthread_mutex_lock(&sc->poller_mtx);
+			sc->poller_asleep = true;
+			pthread_cond_wait(&sc->poller_cond, &sc->poller_mtx);
+			sc->poller_asleep = false;
+			pthread_mutex_unlock(&sc->poller_mtx);
+			continue;
+		}
+		eis = sc->dbbuf_eis;
+
+		busy = false;
+		for (qid = 1; qid <= sc->num_squeues; qid++) {
+			sq = &sc->submit_queues[qid];
+			if (sq->qbase == NULL)
+				continue;
+			tail = (uint16_t)atomic_load_acq_32(
+			    &dbs[NVME_DBBUF_SQ_IDX(qid)]);
+			if (tail == sq->tail)
+				continue;
+			/*
+			 * Park the EventIdx behind the tail we are
+			 * about to consume so the guest keeps
+			 * submitting without ringing the doorbell.
+			 */
+			atomic_store_rel_32(&eis[NVME_DBBUF_SQ_IDX(qid)],
+			    (uint32_t)(uint16_t)(tail - 1));
+			atomic_store_short(&sq->tail, tail);
+			pci_nvme_handle_io_cmd(sc, qid);
+			busy = true;
+		}
+
+		if (busy) {
+			idle = 0;
+			continue;
+		}
+
+		idle++;
+		if (idle < NVME_POLLER_SPIN) {
+			pthread_yield();
+		} else if (idle < NVME_POLLER_IDLE) {
+			usleep(100);
+		} else {
+			pthread_mutex_lock(&sc->poller_mtx);
+
+			/*
+			 * Arm the EventIdx values so the next
+			 * submission rings the doorbell, then re-check
+			 * the shadow tails to close the race with a
+			 * guest which submitted before seeing the new
+			 * EventIdx.
+			 */
+			for (qid = 1; qid <= sc->num_squeues; qid++) {
+				sq = &sc->submit_queues[qid];
+				if (sq->qbase == NULL)
+					continue;
+				atomic_store_rel_32(
+				    &eis[NVME_DBBUF_SQ_IDX(qid)],
+				    (uint32_t)sq->tail);
+			}
+			for (qid = 1; qid <= sc->num_squeues; qid++) {
+				sq = &sc->submit_queues[qid];
+				if (sq->qbase == NULL)
+					continue;
+				if ((uint16_t)atomic_load_acq_32(
+				    &dbs[NVME_DBBUF_SQ_IDX(qid)]) != sq->tail)
+					busy = true;
+			}
+			if (!busy) {
+				sc->poller_asleep = true;
+				pthread_cond_wait(&sc->poller_cond,
+				    &sc->poller_mtx);
+				sc->poller_asleep = false;
+			}
+			pthread_mutex_unlock(&sc->poller_mtx);
+			idle = 0;
+		}
+	}
+
+	return (NULL);
+}
+
 static void
 pci_nvme_handle_doorbell(struct vmctx *ctx, struct pci_nvme_softc* sc,
 	uint64_t idx, int is_sq, uint64_t value)
@@ -2337,6 +2526,14 @@ pci_nvme_handle_doorbell(struct vmctx *ctx, struct pci_nvme_softc* sc,
 				return;
 			}
 			pci_nvme_handle_io_cmd(sc, (uint16_t)idx);
+
+			/*
+			 * A doorbell ring with shadow doorbells
+			 * configured means the guest passed an armed
+			 * EventIdx; resume polling.
+			 */
+			if (sc->iopoll && sc->dbbuf_dbs != NULL)
+				pci_nvme_poller_kick(sc);
 		}
 	} else {
 		if (idx > sc->num_cqueues) {
@@ -2666,6 +2863,8 @@ pci_nvme_parse_opts(struct pci_nvme_softc *sc, char *opts)
 				free(uopt);
 				return (-1);
 			}
+		} else if (!strcmp("iopoll", xopts)) {
+			sc->iopoll = true;
 		} else if (!strcmp("eui64", xopts)) {
 			sc->nvstore.eui64 = htobe64(strtoull(config, NULL, 0));
 		} else if (!strcmp("dsm", xopts)) {
@@ -2801,6 +3000,17 @@ pci_nvme_init(struct vmctx *ctx, struct pci_devinst *pi, char *opts)
 
 	pci_nvme_aer_init(sc);
 
+	pthread_mutex_init(&sc->poller_mtx, NULL);
+	pthread_cond_init(&sc->poller_cond, NULL);
+	if (sc->iopoll) {
+		char tname[MAXCOMLEN + 1];
+
+		pthread_create(&sc->poller_tid, NULL, pci_nvme_sq_poller, sc);
+		snprintf(tname, sizeof(tname), "nvme-%d:%d poll", pi->pi_slot,
+		         pi->pi_func);
+		pthread_set_name_np(sc->poller_tid, tname);
+	}
+
 	pci_nvme_reset(sc);
 
 	pci_lintr_request(pi);
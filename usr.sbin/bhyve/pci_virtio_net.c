@@ -32,6 +32,7 @@
 __FBSDID("$FreeBSD$");
 
 #include <sys/param.h>
+#include <sys/cpuset.h>
 #include <sys/linker_set.h>
 #include <sys/select.h>
 #include <sys/uio.h>
@@ -66,6 +67,9 @@ __FBSDID("$FreeBSD$");
 
 #define VTNET_MAXSEGS	256
 
+/* Avail ring polling window after a TX queue runs dry. */
+#define VTNET_TX_POLL_SPINS	4096
+
 #define VTNET_MAX_PKT_LEN	(65536 + 64)
 
 #define VTNET_MIN_MTU	ETHERMIN
@@ -87,12 +91,33 @@ struct virtio_net_config {
 
 /*
  * Queue definitions.
+ *
+ * With VIRTIO_NET_F_MQ, virtqueues come in pairs: the receive queue of
+ * pair 'i' has index 2*i and the matching transmit queue index 2*i+1.
+ * The control queue, when offered, always sits after the last pair,
+ * i.e. at index 2*max_virtqueue_pairs.
+ */
+#define VTNET_MAXQPAIRS	8
+
+#define VTNET_RXQ(i)	(2 * (i))
+#define VTNET_TXQ(i)	(2 * (i) + 1)
+
+#define VTNET_MAXQ	(2 * VTNET_MAXQPAIRS + 1)
+
+/*
+ * Control virtqueue data structures.  Only the multiqueue command
+ * class is implemented.
  */
-#define VTNET_RXQ	0
-#define VTNET_TXQ	1
-#define VTNET_CTLQ	2	/* NB: not yet supported */
+struct virtio_net_ctrl_hdr {
+	uint8_t class;
+	uint8_t cmd;
+} __packed;
 
-#define VTNET_MAXQ	3
+#define VIRTIO_NET_CTRL_MQ			4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET		0
+
+#define VIRTIO_NET_OK				0
+#define VIRTIO_NET_ERR				1
 
 /*
  * Debug printf
@@ -101,27 +126,51 @@ static int pci_vtnet_debug;
 #define DPRINTF(params) if (pci_vtnet_debug) PRINTLN params
 #define WPRINTF(params) PRINTLN params
 
+struct pci_vtnet_softc;
+
+/*
+ * One receive/transmit virtqueue pair, with a dedicated transmit
+ * thread, so that the pairs can be driven by different guest vCPUs in
+ * parallel.
+ */
+struct pci_vtnet_queue {
+	struct pci_vtnet_softc *vnq_sc;	/* backpointer to softc */
+	struct vqueue_info *vnq_rxq;
+	struct vqueue_info *vnq_txq;
+	int		vnq_idx;	/* pair index */
+
+	pthread_t 	vnq_tx_tid;
+	pthread_mutex_t	vnq_tx_mtx;
+	pthread_cond_t	vnq_tx_cond;
+	int		vnq_tx_in_progress;
+
+	/* Per-queue statistics, updated by the owning thread. */
+	uint64_t	vnq_rx_pkts;
+	uint64_t	vnq_rx_bytes;
+	uint64_t	vnq_tx_pkts;
+	uint64_t	vnq_tx_bytes;
+};
+
 /*
  * Per-device softc
  */
 struct pci_vtnet_softc {
 	struct virtio_softc vsc_vs;
-	struct vqueue_info vsc_queues[VTNET_MAXQ - 1];
+	struct vqueue_info vsc_queues[VTNET_MAXQ];
 	pthread_mutex_t vsc_mtx;
 
 	net_backend_t	*vsc_be;
 
-	int		resetting;	/* protected by tx_mtx */
+	int		resetting;	/* protected by the tx mutexes */
 
 	uint64_t	vsc_features;	/* negotiated features */
-	
+
 	pthread_mutex_t	rx_mtx;
 	int		rx_merge;	/* merged rx bufs in use */
 
-	pthread_t 	tx_tid;
-	pthread_mutex_t	tx_mtx;
-	pthread_cond_t	tx_cond;
-	int		tx_in_progress;
+	struct pci_vtnet_queue vsc_q[VTNET_MAXQPAIRS];
+	int		vsc_max_qpairs;	/* queue pairs offered */
+	int		vsc_num_qpairs;	/* queue pairs enabled by guest */
 
 	size_t		vhdrlen;
 	size_t		be_vhdrlen;
@@ -143,7 +192,7 @@ static int pci_vtnet_snapshot(void *, struct vm_snapshot_meta *);
 
 static struct virtio_consts vtnet_vi_consts = {
 	"vtnet",		/* our name */
-	VTNET_MAXQ - 1,		/* we currently support 2 virtqueues */
+	2,			/* virtqueues; updated in pci_vtnet_init() */
 	sizeof(struct virtio_net_config), /* config reg size */
 	pci_vtnet_reset,	/* reset */
 	NULL,			/* device-wide qnotify -- not used */
@@ -162,6 +211,8 @@ static void
 pci_vtnet_reset(void *vsc)
 {
 	struct pci_vtnet_softc *sc = vsc;
+	struct pci_vtnet_queue *q;
+	int i;
 
 	DPRINTF(("vtnet: device reset requested !"));
 
@@ -178,24 +229,40 @@ pci_vtnet_reset(void *vsc)
 	 */
 	netbe_rx_disable(sc->vsc_be);
 
-	/* Set sc->resetting and give a chance to the TX thread to stop. */
-	pthread_mutex_lock(&sc->tx_mtx);
+	/*
+	 * Set sc->resetting and give a chance to the TX threads to
+	 * stop.  All the TX mutexes are held while resetting, so the
+	 * threads see a consistent value.
+	 */
+	for (i = 0; i < sc->vsc_max_qpairs; i++)
+		pthread_mutex_lock(&sc->vsc_q[i].vnq_tx_mtx);
 	sc->resetting = 1;
-	while (sc->tx_in_progress) {
-		pthread_mutex_unlock(&sc->tx_mtx);
-		usleep(10000);
-		pthread_mutex_lock(&sc->tx_mtx);
+	for (i = 0; i < sc->vsc_max_qpairs; i++) {
+		q = &sc->vsc_q[i];
+		while (q->vnq_tx_in_progress) {
+			pthread_mutex_unlock(&q->vnq_tx_mtx);
+			usleep(10000);
+			pthread_mutex_lock(&q->vnq_tx_mtx);
+		}
+		DPRINTF(("vtnet: queue %d: %ju/%ju rx pkts/bytes, "
+		    "%ju/%ju tx pkts/bytes", i,
+		    (uintmax_t)q->vnq_rx_pkts, (uintmax_t)q->vnq_rx_bytes,
+		    (uintmax_t)q->vnq_tx_pkts, (uintmax_t)q->vnq_tx_bytes));
 	}
 
 	/*
 	 * Now reset rings, MSI-X vectors, and negotiated capabilities.
-	 * Do that with the TX lock held, since we need to reset
+	 * Do that with the TX locks held, since we need to reset
 	 * sc->resetting.
 	 */
 	vi_reset_dev(&sc->vsc_vs);
 
+	/* The guest re-enables extra queue pairs after reset. */
+	sc->vsc_num_qpairs = 1;
+
 	sc->resetting = 0;
-	pthread_mutex_unlock(&sc->tx_mtx);
+	for (i = sc->vsc_max_qpairs - 1; i >= 0; i--)
+		pthread_mutex_unlock(&sc->vsc_q[i].vnq_tx_mtx);
 	pthread_mutex_unlock(&sc->rx_mtx);
 }
 
@@ -243,9 +310,19 @@ pci_vtnet_rx(struct pci_vtnet_softc *sc)
 	int prepend_hdr_len = sc->vhdrlen - sc->be_vhdrlen;
 	struct virtio_mrg_rxbuf_info info[VTNET_MAXSEGS];
 	struct iovec iov[VTNET_MAXSEGS + 1];
+	struct pci_vtnet_queue *q;
 	struct vqueue_info *vq;
 
-	vq = &sc->vsc_queues[VTNET_RXQ];
+	/*
+	 * The backend gives us a single stream of packets, so we
+	 * steer everything to the first receive queue.  The virtio
+	 * specification leaves the automatic steering algorithm to
+	 * the device, and delivering on one queue is a valid choice;
+	 * the multiqueue win is on the transmit side and in the
+	 * per-pair interrupt vectors.
+	 */
+	q = &sc->vsc_q[0];
+	vq = q->vnq_rxq;
 	for (;;) {
 		struct virtio_net_rxhdr *hdr;
 		uint32_t riov_bytes;
@@ -353,6 +430,8 @@ pci_vtnet_rx(struct pci_vtnet_softc *sc)
 		}
 
 		ulen = (uint32_t)plen;
+		q->vnq_rx_pkts++;
+		q->vnq_rx_bytes += ulen;
 
 		/*
 		 * Publish the used buffers to the guest, reporting the
@@ -413,10 +492,11 @@ pci_vtnet_ping_rxq(void *vsc, struct vqueue_info *vq)
 	pthread_mutex_unlock(&sc->rx_mtx);
 }
 
-/* TX virtqueue processing, called by the TX thread. */
+/* TX virtqueue processing, called by the queue's TX thread. */
 static void
-pci_vtnet_proctx(struct pci_vtnet_softc *sc, struct vqueue_info *vq)
+pci_vtnet_proctx(struct pci_vtnet_queue *q, struct vqueue_info *vq)
 {
+	struct pci_vtnet_softc *sc = q->vnq_sc;
 	struct iovec iov[VTNET_MAXSEGS + 1];
 	struct iovec *siov = iov;
 	uint16_t idx;
@@ -450,6 +530,9 @@ pci_vtnet_proctx(struct pci_vtnet_softc *sc, struct vqueue_info *vq)
 			 * were read.
 			 */
 			len = 0;
+		} else {
+			q->vnq_tx_pkts++;
+			q->vnq_tx_bytes += len;
 		}
 	}
 
@@ -465,6 +548,7 @@ static void
 pci_vtnet_ping_txq(void *vsc, struct vqueue_info *vq)
 {
 	struct pci_vtnet_softc *sc = vsc;
+	struct pci_vtnet_queue *q;
 
 	/*
 	 * Any ring entries to process?
@@ -472,32 +556,34 @@ pci_vtnet_ping_txq(void *vsc, struct vqueue_info *vq)
 	if (!vq_has_descs(vq))
 		return;
 
-	/* Signal the tx thread for processing */
-	pthread_mutex_lock(&sc->tx_mtx);
+	/* Signal the tx thread of the kicked queue for processing. */
+	q = &sc->vsc_q[vq->vq_num / 2];
+	pthread_mutex_lock(&q->vnq_tx_mtx);
 	vq_kick_disable(vq);
-	if (sc->tx_in_progress == 0)
-		pthread_cond_signal(&sc->tx_cond);
-	pthread_mutex_unlock(&sc->tx_mtx);
+	if (q->vnq_tx_in_progress == 0)
+		pthread_cond_signal(&q->vnq_tx_cond);
+	pthread_mutex_unlock(&q->vnq_tx_mtx);
 }
 
 /*
- * Thread which will handle processing of TX desc
+ * Thread which will handle processing of TX desc for one queue pair
  */
 static void *
 pci_vtnet_tx_thread(void *param)
 {
-	struct pci_vtnet_softc *sc = param;
+	struct pci_vtnet_queue *q = param;
+	struct pci_vtnet_softc *sc = q->vnq_sc;
 	struct vqueue_info *vq;
 	int error;
 
-	vq = &sc->vsc_queues[VTNET_TXQ];
+	vq = q->vnq_txq;
 
 	/*
 	 * Let us wait till the tx queue pointers get initialised &
 	 * first tx signaled
 	 */
-	pthread_mutex_lock(&sc->tx_mtx);
-	error = pthread_cond_wait(&sc->tx_cond, &sc->tx_mtx);
+	pthread_mutex_lock(&q->vnq_tx_mtx);
+	error = pthread_cond_wait(&q->vnq_tx_cond, &q->vnq_tx_mtx);
 	assert(error == 0);
 
 	for (;;) {
@@ -507,49 +593,107 @@ pci_vtnet_tx_thread(void *param)
 			if (!sc->resetting && vq_has_descs(vq))
 				break;
 
-			sc->tx_in_progress = 0;
-			error = pthread_cond_wait(&sc->tx_cond, &sc->tx_mtx);
+			q->vnq_tx_in_progress = 0;
+			error = pthread_cond_wait(&q->vnq_tx_cond,
+			    &q->vnq_tx_mtx);
 			assert(error == 0);
 		}
 		vq_kick_disable(vq);
-		sc->tx_in_progress = 1;
-		pthread_mutex_unlock(&sc->tx_mtx);
+		q->vnq_tx_in_progress = 1;
+		pthread_mutex_unlock(&q->vnq_tx_mtx);
 
 		do {
+			do {
+				/*
+				 * Run through entries, placing them into
+				 * iovecs and sending when an end-of-packet
+				 * is found
+				 */
+				pci_vtnet_proctx(q, vq);
+			} while (vq_has_descs(vq));
+
 			/*
-			 * Run through entries, placing them into
-			 * iovecs and sending when an end-of-packet
-			 * is found
+			 * Generate an interrupt if needed.
 			 */
-			pci_vtnet_proctx(sc, vq);
-		} while (vq_has_descs(vq));
+			vq_endchains(vq, /*used_all_avail=*/1);
 
-		/*
-		 * Generate an interrupt if needed.
-		 */
-		vq_endchains(vq, /*used_all_avail=*/1);
+			/*
+			 * Keep kicks suppressed and poll the avail ring
+			 * for a while before going back to sleep; at load
+			 * the next packets are picked up exit-free.
+			 */
+		} while (vq_poll_avail(vq, VTNET_TX_POLL_SPINS));
 
-		pthread_mutex_lock(&sc->tx_mtx);
+		pthread_mutex_lock(&q->vnq_tx_mtx);
 	}
 }
 
-#ifdef notyet
+/*
+ * Control virtqueue processing.  Commands are laid out as a read-only
+ * header, read-only command data and a final device-writable
+ * acknowledgement byte.  The only command class we implement is
+ * VIRTIO_NET_CTRL_MQ, which the guest driver uses to set the number
+ * of active queue pairs.
+ */
 static void
 pci_vtnet_ping_ctlq(void *vsc, struct vqueue_info *vq)
 {
+	struct pci_vtnet_softc *sc = vsc;
+	struct virtio_net_ctrl_hdr *hdr;
+	struct iovec iov[VTNET_MAXSEGS];
+	uint16_t idx, pairs;
+	uint8_t *ack;
+	int n;
+
+	while (vq_has_descs(vq)) {
+		n = vq_getchain(vq, &idx, iov, VTNET_MAXSEGS, NULL);
+		assert(n >= 1 && n <= VTNET_MAXSEGS);
+
+		if (n < 2 || iov[0].iov_len < sizeof(*hdr) ||
+		    iov[n - 1].iov_len < sizeof(*ack)) {
+			/* Nonsensical chain; nothing we can report. */
+			vq_relchain(vq, idx, 0);
+			continue;
+		}
+		hdr = iov[0].iov_base;
+		ack = iov[n - 1].iov_base;
+		*ack = VIRTIO_NET_ERR;
+
+		if (hdr->class == VIRTIO_NET_CTRL_MQ &&
+		    hdr->cmd == VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET &&
+		    n >= 3 && iov[1].iov_len >= sizeof(pairs)) {
+			memcpy(&pairs, iov[1].iov_base, sizeof(pairs));
+			if (pairs >= 1 && pairs <= sc->vsc_max_qpairs) {
+				/*
+				 * Take the RX lock so that the
+				 * receive path observes a stable
+				 * value.
+				 */
+				pthread_mutex_lock(&sc->rx_mtx);
+				sc->vsc_num_qpairs = pairs;
+				pthread_mutex_unlock(&sc->rx_mtx);
+				DPRINTF(("vtnet: guest enabled %u queue "
+				    "pairs", pairs));
+				*ack = VIRTIO_NET_OK;
+			}
+		}
 
-	DPRINTF(("vtnet: control qnotify!"));
+		vq_relchain(vq, idx, sizeof(*ack));
+	}
+	vq_endchains(vq, /*used_all_avail=*/1);
 }
-#endif
 
 static int
 pci_vtnet_init(struct vmctx *ctx, struct pci_devinst *pi, char *opts)
 {
 	struct pci_vtnet_softc *sc;
+	struct pci_vtnet_queue *q;
 	char tname[MAXCOMLEN + 1];
+	int i;
 	int mac_provided;
 	int mtu_provided;
 	unsigned long mtu = ETHERMTU;
+	unsigned long mq = 1;
 
 	/*
 	 * Allocate data structures for further virtio initializations.
@@ -561,15 +705,6 @@ pci_vtnet_init(struct vmctx *ctx, struct pci_devinst *pi, char *opts)
 	sc->vsc_consts = vtnet_vi_consts;
 	pthread_mutex_init(&sc->vsc_mtx, NULL);
 
-	sc->vsc_queues[VTNET_RXQ].vq_qsize = VTNET_RINGSZ;
-	sc->vsc_queues[VTNET_RXQ].vq_notify = pci_vtnet_ping_rxq;
-	sc->vsc_queues[VTNET_TXQ].vq_qsize = VTNET_RINGSZ;
-	sc->vsc_queues[VTNET_TXQ].vq_notify = pci_vtnet_ping_txq;
-#ifdef notyet
-	sc->vsc_queues[VTNET_CTLQ].vq_qsize = VTNET_RINGSZ;
-        sc->vsc_queues[VTNET_CTLQ].vq_notify = pci_vtnet_ping_ctlq;
-#endif
- 
 	/*
 	 * Attempt to open the backend device and read the MAC address
 	 * if specified.
@@ -615,6 +750,16 @@ pci_vtnet_init(struct vmctx *ctx, struct pci_devinst *pi, char *opts)
 					break;
 				}
 				mtu_provided = 1;
+			} else if (strcmp(key, "mq") == 0) {
+				char *cp;
+
+				mq = strtoul(value, &cp, 0);
+				if (cp == value || *cp != '\0' ||
+				    mq < 1 || mq > VTNET_MAXQPAIRS) {
+					err = EINVAL;
+					errno = EINVAL;
+					break;
+				}
 			}
 		}
 
@@ -645,11 +790,39 @@ pci_vtnet_init(struct vmctx *ctx, struct pci_devinst *pi, char *opts)
 		sc->vsc_consts.vc_hv_caps |= VIRTIO_NET_F_MTU;
 	}
 
-	/* 
-	 * Since we do not actually support multiqueue,
-	 * set the maximum virtqueue pairs to 1. 
+	/*
+	 * Set up one rx/tx virtqueue per queue pair, following the
+	 * layout mandated by the specification: the receive queue of
+	 * pair i at index 2*i, the transmit queue at 2*i + 1 and the
+	 * control queue, if any, after all of the data queues.
 	 */
-	sc->vsc_config.max_virtqueue_pairs = 1;
+	sc->vsc_max_qpairs = mq;
+	sc->vsc_num_qpairs = 1;
+	for (i = 0; i < sc->vsc_max_qpairs; i++) {
+		q = &sc->vsc_q[i];
+		q->vnq_sc = sc;
+		q->vnq_idx = i;
+		q->vnq_rxq = &sc->vsc_queues[VTNET_RXQ(i)];
+		q->vnq_txq = &sc->vsc_queues[VTNET_TXQ(i)];
+		q->vnq_rxq->vq_qsize = VTNET_RINGSZ;
+		q->vnq_rxq->vq_notify = pci_vtnet_ping_rxq;
+		q->vnq_txq->vq_qsize = VTNET_RINGSZ;
+		q->vnq_txq->vq_notify = pci_vtnet_ping_txq;
+	}
+	if (sc->vsc_max_qpairs > 1) {
+		struct vqueue_info *ctlq;
+
+		ctlq = &sc->vsc_queues[2 * sc->vsc_max_qpairs];
+		ctlq->vq_qsize = VTNET_RINGSZ;
+		ctlq->vq_notify = pci_vtnet_ping_ctlq;
+		sc->vsc_consts.vc_nvq = 2 * sc->vsc_max_qpairs + 1;
+		sc->vsc_consts.vc_hv_caps |= VIRTIO_NET_F_MQ |
+		    VIRTIO_NET_F_CTRL_VQ;
+	} else {
+		sc->vsc_consts.vc_nvq = 2;
+	}
+
+	sc->vsc_config.max_virtqueue_pairs = sc->vsc_max_qpairs;
 
 	/* initialize config space */
 	pci_set_cfgdata16(pi, PCIR_DEVICE, VIRTIO_DEV_NET);
@@ -679,18 +852,29 @@ pci_vtnet_init(struct vmctx *ctx, struct pci_devinst *pi, char *opts)
 	sc->vhdrlen = sizeof(struct virtio_net_rxhdr) - 2;
 	pthread_mutex_init(&sc->rx_mtx, NULL); 
 
-	/* 
-	 * Initialize tx semaphore & spawn TX processing thread.
-	 * As of now, only one thread for TX desc processing is
-	 * spawned. 
+	/*
+	 * Initialize the tx semaphores & spawn one TX processing
+	 * thread per queue pair.  If the matching vCPU was pinned
+	 * with the -p option, pin its tx thread to the same host
+	 * cpus so that queue memory stays local to the vCPU driving
+	 * the queue.
 	 */
-	sc->tx_in_progress = 0;
-	pthread_mutex_init(&sc->tx_mtx, NULL);
-	pthread_cond_init(&sc->tx_cond, NULL);
-	pthread_create(&sc->tx_tid, NULL, pci_vtnet_tx_thread, (void *)sc);
-	snprintf(tname, sizeof(tname), "vtnet-%d:%d tx", pi->pi_slot,
-	    pi->pi_func);
-	pthread_set_name_np(sc->tx_tid, tname);
+	for (i = 0; i < sc->vsc_max_qpairs; i++) {
+		cpuset_t *cpuset;
+
+		q = &sc->vsc_q[i];
+		q->vnq_tx_in_progress = 0;
+		pthread_mutex_init(&q->vnq_tx_mtx, NULL);
+		pthread_cond_init(&q->vnq_tx_cond, NULL);
+		pthread_create(&q->vnq_tx_tid, NULL, pci_vtnet_tx_thread, q);
+		snprintf(tname, sizeof(tname), "vtnet-%d:%d tx%d", pi->pi_slot,
+		    pi->pi_func, i);
+		pthread_set_name_np(q->vnq_tx_tid, tname);
+		cpuset = fbsdrun_vcpumap(i);
+		if (cpuset != NULL)
+			pthread_setaffinity_np(q->vnq_tx_tid,
+			    sizeof(cpuset_t), cpuset);
+	}
 
 	return (0);
 }
@@ -746,6 +930,13 @@ pci_vtnet_neg_features(void *vsc, uint64_t negotiated_features)
 		sc->rx_merge = 0;
 	}
 
+	/*
+	 * If the driver did not negotiate multiqueue, only the first
+	 * queue pair may be used.
+	 */
+	if ((negotiated_features & VIRTIO_NET_F_MQ) == 0)
+		sc->vsc_num_qpairs = 1;
+
 	/* Tell the backend to enable some capabilities it has advertised. */
 	netbe_set_cap(sc->vsc_be, negotiated_features, sc->vhdrlen);
 	sc->be_vhdrlen = netbe_get_vnet_hdr_len(sc->vsc_be);
@@ -757,18 +948,23 @@ static void
 pci_vtnet_pause(void *vsc)
 {
 	struct pci_vtnet_softc *sc = vsc;
+	struct pci_vtnet_queue *q;
+	int i;
 
 	DPRINTF(("vtnet: device pause requested !\n"));
 
 	/* Acquire the RX lock to block RX processing. */
 	pthread_mutex_lock(&sc->rx_mtx);
 
-	/* Wait for the transmit thread to finish its processing. */
-	pthread_mutex_lock(&sc->tx_mtx);
-	while (sc->tx_in_progress) {
-		pthread_mutex_unlock(&sc->tx_mtx);
-		usleep(10000);
-		pthread_mutex_lock(&sc->tx_mtx);
+	/* Wait for the transmit threads to finish their processing. */
+	for (i = 0; i < sc->vsc_max_qpairs; i++) {
+		q = &sc->vsc_q[i];
+		pthread_mutex_lock(&q->vnq_tx_mtx);
+		while (q->vnq_tx_in_progress) {
+			pthread_mutex_unlock(&q->vnq_tx_mtx);
+			usleep(10000);
+			pthread_mutex_lock(&q->vnq_tx_mtx);
+		}
 	}
 }
 
@@ -776,10 +972,12 @@ static void
 pci_vtnet_resume(void *vsc)
 {
 	struct pci_vtnet_softc *sc = vsc;
+	int i;
 
 	DPRINTF(("vtnet: device resume requested !\n"));
 
-	pthread_mutex_unlock(&sc->tx_mtx);
+	for (i = sc->vsc_max_qpairs - 1; i >= 0; i--)
+		pthread_mutex_unlock(&sc->vsc_q[i].vnq_tx_mtx);
 	/* The RX lock should have been acquired in vtnet_pause. */
 	pthread_mutex_unlock(&sc->rx_mtx);
 }
@@ -807,6 +1005,7 @@ pci_vtnet_snapshot(void *vsc, struct vm_snapshot_meta *meta)
 	}
 
 	SNAPSHOT_VAR_OR_LEAVE(sc->vsc_config, meta, ret, done);
+	SNAPSHOT_VAR_OR_LEAVE(sc->vsc_num_qpairs, meta, ret, done);
 	SNAPSHOT_VAR_OR_LEAVE(sc->rx_merge, meta, ret, done);
 
 	SNAPSHOT_VAR_OR_LEAVE(sc->vhdrlen, meta, ret, done);
@@ -475,6 +475,26 @@ vq_kick_disable(struct vqueue_info *vq)
 	vq->vq_used->vu_flags |= VRING_USED_F_NO_NOTIFY;
 }
 
+/*
+ * Briefly poll the avail ring after it has been emptied, with guest
+ * notifications still disabled.  Under sustained load the next
+ * descriptors show up within the polling window and can be processed
+ * without the guest taking a VM exit for the kick; once this returns
+ * zero the caller re-enables notifications, so the exit path remains
+ * as the fallback while the device is idle.  Returns non-zero if
+ * descriptors became available.
+ */
+static inline int
+vq_poll_avail(struct vqueue_info *vq, u_int spins)
+{
+
+	while (spins-- > 0) {
+		if (vq_has_descs(vq))
+			return (1);
+	}
+	return (0);
+}
+
 struct iovec;
 void	vi_softc_linkup(struct virtio_softc *vs, struct virtio_consts *vc,
 			void *dev_softc, struct pci_devinst *pi,
@@ -1544,11 +1544,11 @@ pfl_scan_ruleset(const char *path)
 				strlcat(e->name, "/", sizeof(e->name));
 			strlcat(e->name, pr.rule.label, sizeof(e->name));
 
-			e->evals = pr.rule.evaluations;
-			e->bytes[IN] = pr.rule.bytes[IN];
-			e->bytes[OUT] = pr.rule.bytes[OUT];
-			e->pkts[IN] = pr.rule.packets[IN];
-			e->pkts[OUT] = pr.rule.packets[OUT];
+			e->evals = pr.rule.u_evaluations;
+			e->bytes[IN] = pr.rule.u_bytes[IN];
+			e->bytes[OUT] = pr.rule.u_bytes[OUT];
+			e->pkts[IN] = pr.rule.u_packets[IN];
+			e->pkts[OUT] = pr.rule.u_packets[OUT];
 			e->index = ++pfl_table_count;
 
 			TAILQ_INSERT_TAIL(&pfl_table, e, link);
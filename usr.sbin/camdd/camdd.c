@@ -119,6 +119,7 @@ struct camdd_io_opts {
 	uint64_t	offset;
 	int		min_cmd_size;
 	int		write_dev;
+	int		adaptive;
 	uint64_t	debug;
 };
 
@@ -230,6 +231,12 @@ struct camdd_buf {
 	uint64_t		 lba;
 	size_t			 len;
 
+	/*
+	 * Time this buffer was queued to the kernel, used for latency
+	 * tracking on pass(4) devices.
+	 */
+	struct timespec		 start_time;
+
 	/*
 	 * A reference count of how many indirect buffers point to this
 	 * buffer.
@@ -335,6 +342,18 @@ struct camdd_dev {
 	uint64_t		 bytes_transferred;
 	uint32_t		 target_queue_depth;
 	uint32_t		 cur_active_io;
+
+	/*
+	 * Adaptive queue depth state.  When the user enables adaptive
+	 * queueing, target_queue_depth floats between min_queue_depth and
+	 * max_queue_depth based on the smoothed per-I/O latency.
+	 */
+	int			 adaptive_depth;
+	uint32_t		 min_queue_depth;
+	uint32_t		 max_queue_depth;
+	int64_t			 latency_ewma;
+	int64_t			 latency_floor;
+	uint32_t		 depth_settle;
 	uint8_t			*extra_buf;
 	uint32_t		 extra_buf_len;
 	struct camdd_dev	*peer_dev;
@@ -442,6 +461,8 @@ static sig_atomic_t need_status = 0;
 #define	CAMDD_FILE_DEFAULT_DEPTH	1
 #define	CAMDD_PASS_MAX_BLOCK		1048576
 #define	CAMDD_PASS_DEFAULT_DEPTH	6
+#define	CAMDD_PASS_MIN_DEPTH		2
+#define	CAMDD_DEPTH_SETTLE_IOS		32
 #define	CAMDD_PASS_RW_TIMEOUT		60 * 1000
 
 static int parse_btl(char *tstr, int *bus, int *target, int *lun,
@@ -488,6 +509,7 @@ void camdd_peer_done(struct camdd_buf *buf);
 void camdd_complete_buf(struct camdd_dev *dev, struct camdd_buf *buf,
 			int *error_count);
 int camdd_pass_fetch(struct camdd_dev *dev);
+void camdd_latency_update(struct camdd_dev *dev, struct camdd_buf *buf);
 int camdd_file_run(struct camdd_dev *dev);
 int camdd_pass_run(struct camdd_dev *dev);
 int camdd_get_next_lba_len(struct camdd_dev *dev, uint64_t *lba, ssize_t *len);
@@ -1623,6 +1645,14 @@ camdd_probe_pass(struct cam_device *cam_dev, struct camdd_io_opts *io_opts,
 	if (io_opts->queue_depth != 0)
 		dev->target_queue_depth = io_opts->queue_depth;
 
+	if (io_opts->adaptive != 0) {
+		dev->adaptive_depth = 1;
+		dev->max_queue_depth = dev->target_queue_depth;
+		dev->min_queue_depth = min(CAMDD_PASS_MIN_DEPTH,
+		    dev->target_queue_depth);
+		dev->depth_settle = CAMDD_DEPTH_SETTLE_IOS;
+	}
+
 	if (io_opts->offset != 0) {
 		if (io_opts->offset > (dev->max_sector * dev->sector_size)) {
 			warnx("Offset %ju is past the end of device %s",
@@ -2342,6 +2372,9 @@ camdd_pass_fetch(struct camdd_dev *dev)
 		STAILQ_REMOVE(&dev->active_queue, buf, camdd_buf, links);
 		dev->cur_active_io--;
 
+		if (dev->adaptive_depth != 0)
+			camdd_latency_update(dev, buf);
+
 		ccb_status = ccb.ccb_h.status & CAM_STATUS_MASK;
 		if (ccb_status != CAM_REQ_CMP) {
 			cam_error_print(pass_dev->dev, &ccb, CAM_ESF_ALL,
@@ -2390,6 +2423,59 @@ camdd_pass_fetch(struct camdd_dev *dev)
 		return (num_fetched);
 }
 
+/*
+ * Update the latency EWMA for the given device and, once enough I/Os have
+ * completed at the current depth, adjust the target queue depth.  The goal
+ * is to notice when additional outstanding I/O has stopped buying any
+ * bandwidth and is only inflating per-I/O latency (i.e. requests are just
+ * piling up in the kernel ahead of a saturated device).  We remember the
+ * smallest smoothed latency seen so far and back the depth off when the
+ * current smoothed latency climbs to twice that floor.  The floor is aged
+ * slowly so a device that legitimately slows down (a tape drive shoe-
+ * shining, an SMR disk destaging) doesn't pin us at the minimum forever.
+ */
+void
+camdd_latency_update(struct camdd_dev *dev, struct camdd_buf *buf)
+{
+	struct timespec done_time;
+	int64_t delta;
+
+	if (clock_gettime(CLOCK_MONOTONIC_PRECISE, &done_time) != 0)
+		return;
+
+	timespecsub(&done_time, &buf->start_time, &done_time);
+	delta = (done_time.tv_sec * 1000000000) + done_time.tv_nsec;
+
+	if (dev->latency_ewma == 0)
+		dev->latency_ewma = delta;
+	else
+		dev->latency_ewma += (delta - dev->latency_ewma) / 8;
+
+	/*
+	 * Let the EWMA settle between adjustments so we measure the
+	 * effect of the last depth change rather than chasing noise.
+	 */
+	if (dev->depth_settle > 0) {
+		dev->depth_settle--;
+		return;
+	}
+	dev->depth_settle = CAMDD_DEPTH_SETTLE_IOS;
+
+	if ((dev->latency_floor == 0)
+	 || (dev->latency_ewma < dev->latency_floor))
+		dev->latency_floor = dev->latency_ewma;
+	else
+		dev->latency_floor += dev->latency_floor / 64;
+
+	if ((dev->latency_ewma > (dev->latency_floor * 2))
+	 && (dev->target_queue_depth > dev->min_queue_depth))
+		dev->target_queue_depth--;
+	else if ((dev->latency_ewma < (dev->latency_floor +
+		 (dev->latency_floor / 4)))
+	      && (dev->target_queue_depth < dev->max_queue_depth))
+		dev->target_queue_depth++;
+}
+
 /*
  * Returns -1 for error, 0 for success/continue, and 1 for resource
  * shortage/stop processing.
@@ -2718,6 +2804,9 @@ camdd_pass_run(struct camdd_dev *dev)
 	 */
 	ccb->ccb_h.ccb_buf = buf;
 
+	if (dev->adaptive_depth != 0)
+		clock_gettime(CLOCK_MONOTONIC_PRECISE, &buf->start_time);
+
 	/*
 	 * Unlock our mutex in preparation for issuing the ioctl.
 	 */
@@ -3212,6 +3301,17 @@ camdd_print_status(struct camdd_dev *camdd_dev, struct camdd_dev *other_dev,
 	mb_sec *= 1000000000;
 	mb_sec /= total_ns;
 	fprintf(stderr, "%.2Lf MB/sec\n", mb_sec);
+
+	if (camdd_dev->latency_ewma != 0)
+		fprintf(stderr, "%s: %.3Lf ms avg latency, queue depth %u\n",
+			camdd_dev->device_name,
+			(long double)camdd_dev->latency_ewma / 1000000,
+			camdd_dev->target_queue_depth);
+	if (other_dev->latency_ewma != 0)
+		fprintf(stderr, "%s: %.3Lf ms avg latency, queue depth %u\n",
+			other_dev->device_name,
+			(long double)other_dev->latency_ewma / 1000000,
+			other_dev->target_queue_depth);
 }
 
 int
@@ -3433,6 +3533,8 @@ usage(void)
 "offset=len    Specify starting offset in bytes or using K, M, G suffix\n"
 "              NOTE: offset cannot be specified on tapes, pipes, stdin/out\n"
 "depth=N       Specify a numeric queue depth.  This only applies to pass(4)\n"
+"adaptive=1    Adapt the queue depth to the observed I/O latency, using the\n"
+"              depth=N value as the upper bound.  Only applies to pass(4)\n"
 "mcs=N         Specify a minimum cmd size for pass(4) read/write commands\n"
 "Optional arguments\n"
 "-C retry_cnt  Specify a retry count for pass(4) devices\n"
@@ -3518,6 +3620,15 @@ camdd_parse_io_opts(char *args, int is_write, struct camdd_io_opts *io_opts)
 				retval = 1;
 				goto bailout;
 			}
+		} else if (strncasecmp(name, "adaptive", 8) == 0) {
+			char *endptr;
+
+			io_opts->adaptive = strtol(value, &endptr, 0);
+			if (*endptr != '\0') {
+				warnx("invalid adaptive setting %s", value);
+				retval = 1;
+				goto bailout;
+			}
 		} else if (strncasecmp(name, "mcs", 3) == 0) {
 			char *endptr;
 
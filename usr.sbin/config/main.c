@@ -89,6 +89,7 @@ char 	srcdir[MAXPATHLEN];
 
 int	debugging;
 int	profiling;
+int	objgroups;
 int	found_defaults;
 int	incignore;
 
@@ -144,7 +145,7 @@ main(int argc, char **argv)
 	STAILQ_INIT(&ftab);
 	STAILQ_INIT(&hints);
 	STAILQ_INIT(&envvars);
-	while ((ch = getopt(argc, argv, "Cd:gI:mps:Vx:")) != -1)
+	while ((ch = getopt(argc, argv, "Cd:giI:mps:Vx:")) != -1)
 		switch (ch) {
 		case 'C':
 			filebased = 1;
@@ -159,6 +160,9 @@ main(int argc, char **argv)
 		case 'g':
 			debugging++;
 			break;
+		case 'i':
+			objgroups++;
+			break;
 		case 'I':
 			ipath = (struct includepath *) \
 			    	calloc(1, sizeof (struct includepath));
@@ -310,7 +314,7 @@ usage(void)
 {
 
 	fprintf(stderr,
-	    "usage: config [-CgmpV] [-d destdir] [-s srcdir] sysname\n");
+	    "usage: config [-CgimpV] [-d destdir] [-s srcdir] sysname\n");
 	fprintf(stderr, "       config -x kernel\n");
 	exit(EX_USAGE);
 }
@@ -61,6 +61,7 @@ static void do_clean(FILE *);
 static void do_rules(FILE *);
 static void do_xxfiles(char *, FILE *);
 static void do_objs(FILE *);
+static void do_objgrp_lists(FILE *);
 static void do_before_depend(FILE *);
 static void read_files(void);
 static void sanitize_envline(char *result, const char *src);
@@ -79,6 +80,64 @@ static void errout(const char *fmt, ...)
 	exit(1);
 }
 
+/*
+ * With -i, ordinary objects are grouped by source directory and each
+ * group is partially linked (ld -r) into a single relocatable object,
+ * so the final kernel link only consumes the group objects and an
+ * edit-compile cycle relinks just the group the changed file lives in.
+ */
+struct objgrp {
+	STAILQ_ENTRY(objgrp) g_next;
+	char	*g_dir;			/* source directory */
+	char	*g_name;		/* directory with '/' mapped to '_' */
+	char	*g_upper;		/* ditto, upper-cased, for ${OBJS_GRP_*} */
+	int	g_nobjs;		/* number of member objects */
+};
+static STAILQ_HEAD(, objgrp) grptab = STAILQ_HEAD_INITIALIZER(grptab);
+
+/*
+ * Find, or create, the partial-link group for a file.  Objects with
+ * special rules, object prefixes or pre-built objects are never
+ * grouped and stay in ${OBJS} directly.
+ */
+static struct objgrp *
+grp_for(struct file_list *tp)
+{
+	struct objgrp *gp;
+	char dir[MAXPATHLEN];
+	char *cp;
+
+	if (!objgroups)
+		return (NULL);
+	if (tp->f_type != NORMAL)
+		return (NULL);
+	if (tp->f_flags & (NO_OBJ | NO_IMPLCT_RULE))
+		return (NULL);
+	if (*tp->f_objprefix != '\0')
+		return (NULL);
+	if (tp->f_fn[strlen(tp->f_fn) - 1] == 'o')
+		return (NULL);
+	cp = strrchr(tp->f_fn, '/');
+	if (cp == NULL || cp - tp->f_fn >= (int)sizeof(dir))
+		return (NULL);
+	memcpy(dir, tp->f_fn, cp - tp->f_fn);
+	dir[cp - tp->f_fn] = '\0';
+	STAILQ_FOREACH(gp, &grptab, g_next)
+		if (eq(gp->g_dir, dir))
+			return (gp);
+	gp = (struct objgrp *)calloc(1, sizeof *gp);
+	if (gp == NULL)
+		err(EXIT_FAILURE, "calloc");
+	gp->g_dir = ns(dir);
+	gp->g_name = ns(dir);
+	for (cp = gp->g_name; *cp != '\0'; cp++)
+		if (!isalnum(*cp))
+			*cp = '_';
+	gp->g_upper = raisestr(ns(gp->g_name));
+	STAILQ_INSERT_TAIL(&grptab, gp, g_next);
+	return (gp);
+}
+
 /*
  * Lookup a file, by name.
  */
@@ -665,14 +724,31 @@ static void
 do_objs(FILE *fp)
 {
 	struct file_list *tp;
+	struct objgrp *gp;
 	int lpos, len;
 	char *cp, och, *sp;
 
+	/*
+	 * Count prospective group members first; directories which would
+	 * contribute a single object are not worth a partial link and
+	 * their object stays in ${OBJS}.
+	 */
+	if (objgroups)
+		STAILQ_FOREACH(tp, &ftab, f_next) {
+			if (tp->f_flags & NO_OBJ)
+				continue;
+			gp = grp_for(tp);
+			if (gp != NULL)
+				gp->g_nobjs++;
+		}
 	fprintf(fp, "OBJS=");
 	lpos = 6;
 	STAILQ_FOREACH(tp, &ftab, f_next) {
 		if (tp->f_flags & NO_OBJ)
 			continue;
+		gp = grp_for(tp);
+		if (gp != NULL && gp->g_nobjs > 1)
+			continue;
 		sp = tail(tp->f_fn);
 		cp = sp + (len = strlen(sp)) - 1;
 		och = *cp;
@@ -686,8 +762,58 @@ do_objs(FILE *fp)
 		lpos += len + 1;
 		*cp = och;
 	}
+	STAILQ_FOREACH(gp, &grptab, g_next) {
+		if (gp->g_nobjs < 2)
+			continue;
+		len = strlen(gp->g_name) + 6;
+		if (len + lpos > 72) {
+			lpos = 8;
+			fprintf(fp, "\\\n\t");
+		}
+		fprintf(fp, "grp_%s.o ", gp->g_name);
+		lpos += len + 1;
+	}
 	if (lpos != 8)
 		putc('\n', fp);
+	if (objgroups)
+		do_objgrp_lists(fp);
+}
+
+/*
+ * Emit the member object list for each partial-link group.
+ */
+static void
+do_objgrp_lists(FILE *fp)
+{
+	struct file_list *tp;
+	struct objgrp *gp;
+	int lpos, len;
+	char *cp, och, *sp;
+
+	STAILQ_FOREACH(gp, &grptab, g_next) {
+		if (gp->g_nobjs < 2)
+			continue;
+		lpos = fprintf(fp, "OBJS_GRP_%s=", gp->g_upper);
+		STAILQ_FOREACH(tp, &ftab, f_next) {
+			if (tp->f_flags & NO_OBJ)
+				continue;
+			if (grp_for(tp) != gp)
+				continue;
+			sp = tail(tp->f_fn);
+			cp = sp + (len = strlen(sp)) - 1;
+			och = *cp;
+			*cp = 'o';
+			if (len + lpos > 72) {
+				lpos = 8;
+				fprintf(fp, "\\\n\t");
+			}
+			fprintf(fp, "%s ", sp);
+			lpos += len + 1;
+			*cp = och;
+		}
+		if (lpos != 8)
+			putc('\n', fp);
+	}
 }
 
 static void
@@ -746,6 +872,7 @@ do_rules(FILE *f)
 {
 	char *cp, *np, och;
 	struct file_list *ftp;
+	struct objgrp *gp;
 	char *compilewith;
 	char cmd[128];
 
@@ -817,6 +944,15 @@ do_rules(FILE *f)
 		else
 			fprintf(f, "\n");
 	}
+	STAILQ_FOREACH(gp, &grptab, g_next) {
+		if (gp->g_nobjs < 2)
+			continue;
+		fprintf(f, "grp_%s.o: ${OBJS_GRP_%s}\n", gp->g_name,
+		    gp->g_upper);
+		fprintf(f, "\t@rm -f ${.TARGET}\n");
+		fprintf(f, "\t${LD} -r -o ${.TARGET} ${OBJS_GRP_%s}\n\n",
+		    gp->g_upper);
+	}
 }
 
 static void
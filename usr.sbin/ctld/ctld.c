@@ -43,6 +43,7 @@ __FBSDID("$FreeBSD$");
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <signal.h>
 #include <stdbool.h>
@@ -2200,6 +2201,21 @@ conf_apply(struct conf *oldconf, struct conf *newconf)
 				cumulated_error++;
 				continue;
 			}
+			/*
+			 * The main loop drains all the pending connections
+			 * from each listening socket in one go; that needs
+			 * accept(2) to fail with EWOULDBLOCK instead of
+			 * blocking once the backlog is empty.
+			 */
+			error = fcntl(newp->p_socket, F_SETFL, O_NONBLOCK);
+			if (error != 0) {
+				log_warn("fcntl(2) failed for %s",
+				    newp->p_listen);
+				close(newp->p_socket);
+				newp->p_socket = 0;
+				cumulated_error++;
+				continue;
+			}
 		}
 	}
 
@@ -2481,21 +2497,33 @@ found:
 				TAILQ_FOREACH(portal, &pg->pg_portals, p_next) {
 					if (!FD_ISSET(portal->p_socket, &fdset))
 						continue;
-					client_salen = sizeof(client_sa);
-					client_fd = accept(portal->p_socket,
-					    (struct sockaddr *)&client_sa,
-					    &client_salen);
-					if (client_fd < 0) {
-						if (errno == ECONNABORTED)
-							continue;
-						log_err(1, "accept");
+					/*
+					 * Drain the whole backlog before
+					 * going back to select(2); initiator
+					 * failover tends to open all of its
+					 * connections at once.
+					 */
+					for (;;) {
+						client_salen = sizeof(client_sa);
+						client_fd = accept(
+						    portal->p_socket,
+						    (struct sockaddr *)&client_sa,
+						    &client_salen);
+						if (client_fd < 0) {
+							if (errno == EAGAIN ||
+							    errno == EINTR ||
+							    errno == ECONNABORTED)
+								break;
+							log_err(1, "accept");
+						}
+						assert(client_salen >=
+						    client_sa.ss_len);
+
+						handle_connection(portal,
+						    client_fd,
+						    (struct sockaddr *)&client_sa,
+						    dont_fork);
 					}
-					assert(client_salen >= client_sa.ss_len);
-
-					handle_connection(portal, client_fd,
-					    (struct sockaddr *)&client_sa,
-					    dont_fork);
-					break;
 				}
 			}
 #ifdef ICL_KERNEL_PROXY
@@ -366,6 +366,7 @@ pmcstat_show_usage(void)
 		" to \"file\"\n"
 	    "\t -G file\t write a system-wide callgraph to \"file\"\n"
 	    "\t -I\t\t don't resolve leaf function name, show address instead\n"
+	    "\t -K\t\t (toggle) aggregate samples in the kernel\n"
 	    "\t -L\t\t list all counters available on this host\n"
 	    "\t -M file\t print executable/gmon file map to \"file\"\n"
 	    "\t -N\t\t (toggle) capture callchains\n"
@@ -431,7 +432,8 @@ main(int argc, char **argv)
 	double duration;
 	int option, npmc;
 	int c, check_driver_stats; 
-	int do_callchain, do_descendants, do_logproccsw, do_logprocexit;
+	int do_aggregate, do_callchain, do_descendants;
+	int do_logproccsw, do_logprocexit;
 	int do_print, do_read, do_listcounters, do_descr;
 	int do_userspace;
 	size_t len;
@@ -453,6 +455,7 @@ main(int argc, char **argv)
 
 	check_driver_stats      = 0;
 	current_sampling_count  = 0;
+	do_aggregate		= 0;
 	do_callchain		= 1;
 	do_descr                = 0;
 	do_descendants          = 0;
@@ -511,7 +514,7 @@ main(int argc, char **argv)
 	CPU_COPY(&rootmask, &cpumask);
 
 	while ((option = getopt(argc, argv,
-	    "ACD:EF:G:ILM:NO:P:R:S:TUWZa:c:def:gi:k:l:m:n:o:p:qr:s:t:u:vw:z:")) != -1)
+	    "ACD:EF:G:IKLM:NO:P:R:S:TUWZa:c:def:gi:k:l:m:n:o:p:qr:s:t:u:vw:z:")) != -1)
 		switch (option) {
 		case 'A':
 			args.pa_flags |= FLAG_SKIP_TOP_FN_RES;
@@ -599,6 +602,11 @@ main(int argc, char **argv)
 			args.pa_flags |= FLAG_SHOW_OFFSET;
 			break;
 
+		case 'K':	/* toggle in-kernel sample aggregation */
+			do_aggregate = !do_aggregate;
+			args.pa_required |= FLAG_HAS_SAMPLING_PMCS;
+			break;
+
 		case 'k':	/* pathname to the kernel */
 			free(args.pa_kernel);
 			args.pa_kernel = strdup(optarg);
@@ -688,6 +696,8 @@ main(int argc, char **argv)
 				if (do_userspace)
 					ev->ev_flags |= PMC_F_USERCALLCHAIN;
 			}
+			if (do_aggregate)
+				ev->ev_flags |= PMC_F_AGGREGATE;
 			if (do_descendants)
 				ev->ev_flags |= PMC_F_DESCENDANTS;
 			if (do_logprocexit)
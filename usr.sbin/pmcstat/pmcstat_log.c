@@ -395,6 +395,19 @@ pmcstat_print_log(void)
 				PMCSTAT_PRINT_ENTRY("...", "%p",
 				    (void *) ev.pl_u.pl_cc.pl_pc[npc]);
 			break;
+		case PMCLOG_TYPE_CALLCHAIN_AGG:
+			PMCSTAT_PRINT_ENTRY("callchain-agg",
+			    "%d 0x%x %d %d %c %ju", ev.pl_u.pl_cc.pl_pid,
+			    ev.pl_u.pl_cc.pl_pmcid,
+			    PMC_CALLCHAIN_CPUFLAGS_TO_CPU(ev.pl_u.pl_cc. \
+				pl_cpuflags), ev.pl_u.pl_cc.pl_npc,
+			    PMC_CALLCHAIN_CPUFLAGS_TO_USERMODE(ev.pl_u.pl_cc.\
+			        pl_cpuflags) ? 'u' : 's',
+			    (uintmax_t) ev.pl_u.pl_cc.pl_count);
+			for (npc = 0; npc < ev.pl_u.pl_cc.pl_npc; npc++)
+				PMCSTAT_PRINT_ENTRY("...", "%p",
+				    (void *) ev.pl_u.pl_cc.pl_pc[npc]);
+			break;
 		case PMCLOG_TYPE_CLOSELOG:
 			PMCSTAT_PRINT_ENTRY("closelog",);
 			break;